@@ -32,9 +32,35 @@ void MidiAudio::_initialize(HWND windowHandle) noexcept
     }
 }
 
+MidiAudio::~MidiAudio()
+{
+    {
+        const std::lock_guard guard{ _queueLock };
+        _exit = true;
+        _queue.clear();
+    }
+
+    // This interrupts the note that's currently playing.
+    _skip.SetEvent();
+    _queueChanged.notify_all();
+
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+}
+
 void MidiAudio::BeginSkip() noexcept
 {
     _skip.SetEvent();
+
+    {
+        const std::lock_guard guard{ _queueLock };
+        _queue.clear();
+    }
+
+    // Wakes up any PlayNote() call that's waiting for room in the queue.
+    _queueChanged.notify_all();
 }
 
 void MidiAudio::EndSkip() noexcept
@@ -42,6 +68,7 @@ void MidiAudio::EndSkip() noexcept
     _skip.ResetEvent();
 }
 
+// Queues up a note to be played after all previously queued ones. This only blocks if the queue is full.
 void MidiAudio::PlayNote(HWND windowHandle, const int noteNumber, const int velocity, const std::chrono::milliseconds duration) noexcept
 try
 {
@@ -50,26 +77,81 @@ try
         return;
     }
 
-    if (_hwnd != windowHandle)
     {
-        _initialize(windowHandle);
+        std::unique_lock guard{ _queueLock };
+
+        if (!_thread.joinable())
+        {
+            _thread = std::thread{ [this]() { _audioThread(); } };
+        }
+
+        _queueChanged.wait(guard, [&]() { return _queue.size() < QueueCapacity || _skip.is_signaled(); });
+        if (_skip.is_signaled())
+        {
+            return;
+        }
+
+        _queue.emplace_back(Note{ windowHandle, noteNumber, velocity, duration });
+    }
+
+    _queueChanged.notify_all();
+}
+CATCH_LOG()
+
+void MidiAudio::_audioThread() noexcept
+{
+    SetThreadDescription(GetCurrentThread(), L"MidiAudio");
+
+    for (;;)
+    {
+        Note note;
+
+        {
+            std::unique_lock guard{ _queueLock };
+            _queueChanged.wait(guard, [&]() { return _exit || !_queue.empty(); });
+            if (_exit)
+            {
+                return;
+            }
+
+            note = _queue.front();
+            _queue.pop_front();
+        }
+
+        // Wakes up PlayNote() if it's waiting for room in the queue.
+        _queueChanged.notify_all();
+        _playNote(note);
+    }
+}
+
+void MidiAudio::_playNote(const Note& note) noexcept
+try
+{
+    if (_skip.is_signaled())
+    {
+        return;
+    }
+
+    if (_hwnd != note.windowHandle)
+    {
+        _initialize(note.windowHandle);
     }
 
     const auto& buffer = _buffers.at(_activeBufferIndex);
-    if (velocity && buffer)
+    if (note.velocity && buffer)
     {
         // The formula for frequency is 2^(n/12) * 440Hz, where n is zero for
         // the A above middle C (A4). In MIDI terms, A4 is note number 69,
         // which is why we subtract 69. We also need to multiply by the size
         // of the wave form to determine the frequency that the sound buffer
         // has to be played to achieve the equivalent note frequency.
-        const auto frequency = std::pow(2.0, (noteNumber - 69.0) / 12.0) * 440.0 * WAVE_SIZE;
+        const auto frequency = std::pow(2.0, (note.noteNumber - 69.0) / 12.0) * 440.0 * WAVE_SIZE;
         buffer->SetFrequency(gsl::narrow_cast<DWORD>(frequency));
         // For the volume, we're using the formula defined in the General
         // MIDI Level 2 specification: Gain in dB = 40 * log10(v/127). We need
         // to multiply by 4000, though, because the SetVolume method expects
         // the volume to be in hundredths of a decibel.
-        const auto volume = 4000.0 * std::log10(velocity / 127.0);
+        const auto volume = 4000.0 * std::log10(note.velocity / 127.0);
         buffer->SetVolume(gsl::narrow_cast<LONG>(volume));
         // Resetting the buffer to a position that is slightly off from the
         // last position will help to produce a clearer separation between
@@ -80,9 +162,9 @@ try
     // By waiting on the skip event with a maximum duration of the note, we'll
     // either be paused for the appropriate amount of time, or we'll break out early
     // because BeginSkip() was called. This happens for Ctrl+C or during shutdown.
-    _skip.wait(::base::saturated_cast<DWORD>(duration.count()));
+    _skip.wait(::base::saturated_cast<DWORD>(note.duration.count()));
 
-    if (velocity && buffer)
+    if (note.velocity && buffer)
     {
         // When the note ends, we just turn the volume down instead of stopping
         // the sound buffer. This helps reduce unwanted static between notes.
@@ -6,12 +6,17 @@ Module Name:
 - MidiAudio.hpp
 
 Abstract:
-  This modules provide basic MIDI support with blocking sound output.
+  This modules provide basic MIDI support. The notes are played on a
+  thread of their own, so that they don't block the VT output.
   */
 
 #pragma once
 
 #include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 struct IDirectSound8;
 struct IDirectSoundBuffer;
@@ -19,16 +24,44 @@ struct IDirectSoundBuffer;
 class MidiAudio
 {
 public:
+    MidiAudio() = default;
+    ~MidiAudio();
+
+    MidiAudio(const MidiAudio&) = delete;
+    MidiAudio& operator=(const MidiAudio&) = delete;
+
     void BeginSkip() noexcept;
     void EndSkip() noexcept;
     void PlayNote(HWND windowHandle, const int noteNumber, const int velocity, const std::chrono::milliseconds duration) noexcept;
 
 private:
+    struct Note
+    {
+        HWND windowHandle = nullptr;
+        int noteNumber = 0;
+        int velocity = 0;
+        std::chrono::milliseconds duration{};
+    };
+
+    // PlayNote() returns immediately until this many notes are waiting to be played.
+    // After that it blocks until the oldest one started playing, which keeps the
+    // VT output from running arbitrarily far ahead of the tune.
+    static constexpr size_t QueueCapacity = 64;
+
+    void _audioThread() noexcept;
+    void _playNote(const Note& note) noexcept;
     void _initialize(HWND windowHandle) noexcept;
     void _createBuffers() noexcept;
 
     wil::slim_event_manual_reset _skip;
 
+    std::mutex _queueLock;
+    std::condition_variable _queueChanged;
+    std::deque<Note> _queue;
+    bool _exit = false;
+    std::thread _thread;
+
+    // Everything below is only accessed by the audio thread.
     HWND _hwnd = nullptr;
     wil::unique_hmodule _directSoundModule;
     wil::com_ptr<IDirectSound8> _directSound;
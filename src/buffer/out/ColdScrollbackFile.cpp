@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "ColdScrollbackFile.hpp"
+
+ColdScrollbackFile::ColdScrollbackFile()
+{
+    std::array<wchar_t, MAX_PATH + 1> directory;
+    const auto directoryLength = GetTempPathW(gsl::narrow_cast<DWORD>(directory.size()), directory.data());
+    THROW_LAST_ERROR_IF(directoryLength == 0 || directoryLength >= directory.size());
+
+    std::array<wchar_t, MAX_PATH> path;
+    THROW_LAST_ERROR_IF(GetTempFileNameW(directory.data(), L"wtc", 0, path.data()) == 0);
+
+    // GetTempFileNameW() already created the file. We reopen it with FILE_FLAG_DELETE_ON_CLOSE, so that
+    // it gets removed once we're gone, even if we crash. FILE_ATTRIBUTE_TEMPORARY hints the cache manager
+    // to keep its contents in memory for as long as possible and only write them to disk when needed.
+    _file.reset(CreateFileW(path.data(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr));
+    if (!_file)
+    {
+        const auto hr = HRESULT_FROM_WIN32(GetLastError());
+        DeleteFileW(path.data());
+        THROW_HR(hr);
+    }
+}
+
+// Returns `size` bytes of writable memory backed by the file. The memory stays valid until it's
+// passed to Free() or Clear() is called. `size` must be greater than 0.
+ColdScrollbackFile::Allocation ColdScrollbackFile::Allocate(const size_t size)
+{
+    assert(size > 0);
+
+    // Segments are filled in order and rows are usually evicted and rehydrated in order as well.
+    // ...so the most recently added segments are the most likely to have some space left.
+    for (auto i = _segments.size(); i-- > 0;)
+    {
+        const auto& s = til::at(_segments, i);
+        if (s.capacity - s.used >= size)
+        {
+            return _allocateFrom(i, size);
+        }
+    }
+
+    const auto capacity = (size + SegmentSize - 1) / SegmentSize * SegmentSize;
+    const auto fileSize = _fileSize + capacity;
+
+    Segment segment;
+    // Creating a mapping larger than the file extends the file.
+    segment.mapping.reset(CreateFileMappingW(_file.get(), nullptr, PAGE_READWRITE, static_cast<DWORD>(fileSize >> 32), static_cast<DWORD>(fileSize), nullptr));
+    THROW_LAST_ERROR_IF(!segment.mapping);
+    segment.view.reset(static_cast<std::byte*>(MapViewOfFile(segment.mapping.get(), FILE_MAP_WRITE, static_cast<DWORD>(_fileSize >> 32), static_cast<DWORD>(_fileSize), capacity)));
+    THROW_LAST_ERROR_IF(!segment.view);
+    segment.capacity = capacity;
+
+    _segments.emplace_back(std::move(segment));
+    _fileSize = fileSize;
+    return _allocateFrom(_segments.size() - 1, size);
+}
+
+ColdScrollbackFile::Allocation ColdScrollbackFile::_allocateFrom(const size_t segment, const size_t size) noexcept
+{
+    auto& s = til::at(_segments, segment);
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    const auto data = s.view.get() + s.used;
+    s.used += size;
+    s.live += size;
+    return { data, segment, size };
+}
+
+void ColdScrollbackFile::Free(const Allocation& allocation) noexcept
+{
+    if (allocation.segment >= _segments.size())
+    {
+        return;
+    }
+
+    auto& s = til::at(_segments, allocation.segment);
+    assert(s.live >= allocation.size);
+    s.live -= allocation.size;
+    if (s.live == 0)
+    {
+        s.used = 0;
+    }
+}
+
+// Invalidates all allocations, unmaps the file and truncates it.
+void ColdScrollbackFile::Clear() noexcept
+{
+    if (_segments.empty())
+    {
+        return;
+    }
+
+    _segments.clear();
+    _fileSize = 0;
+
+    FILE_END_OF_FILE_INFO info{};
+    LOG_IF_WIN32_BOOL_FALSE(SetFileInformationByHandle(_file.get(), FileEndOfFileInfo, &info, sizeof(info)));
+}
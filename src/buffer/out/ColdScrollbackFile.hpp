@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+// A memory-mapped temporary file that holds the text of the ROWs in the cold scrollback tier.
+// Pages of a file mapping don't count towards the commit charge, unlike the heap memory PackedRow uses
+// otherwise. Under memory pressure Windows can write them out and drop them, and it pages them back in
+// when a chunk gets rehydrated. This way large histories don't have to stay in private memory.
+//
+// The file is split into segments of (at least) SegmentSize bytes which are mapped individually and used
+// as bump allocators. Once all allocations of a segment have been freed, the segment gets reused.
+class ColdScrollbackFile
+{
+public:
+    struct Allocation
+    {
+        std::byte* data = nullptr;
+        size_t segment = 0;
+        size_t size = 0;
+    };
+
+    // This must be a multiple of the allocation granularity (64KiB), since
+    // it determines the offsets at which the segments are mapped.
+    static constexpr size_t SegmentSize = 4 * 1024 * 1024;
+
+    ColdScrollbackFile();
+
+    Allocation Allocate(size_t size);
+    void Free(const Allocation& allocation) noexcept;
+    void Clear() noexcept;
+
+private:
+    struct Segment
+    {
+        wil::unique_handle mapping;
+        wil::unique_mapview_ptr<std::byte> view;
+        size_t capacity = 0;
+        size_t used = 0;
+        size_t live = 0;
+    };
+
+    Allocation _allocateFrom(size_t segment, size_t size) noexcept;
+
+    wil::unique_hfile _file;
+    std::vector<Segment> _segments;
+    uint64_t _fileSize = 0;
+};
@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "HyperlinkTable.hpp"
+
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator (bounds.4).
+
+HyperlinkTable::HyperlinkTable(const HyperlinkTable& other) :
+    _entries{ other._entries },
+    _arena{ other._arena },
+    _nextId{ other._nextId },
+    _lastId{ other._lastId },
+    _live{ other._live },
+    _addedSinceSweep{ other._addedSinceSweep },
+    _liveAfterSweep{ other._liveAfterSweep }
+{
+    _rebuildCustomIds();
+}
+
+HyperlinkTable& HyperlinkTable::operator=(const HyperlinkTable& other)
+{
+    if (this != &other)
+    {
+        _entries = other._entries;
+        _arena = other._arena;
+        _nextId = other._nextId;
+        _lastId = other._lastId;
+        _live = other._live;
+        _addedSinceSweep = other._addedSinceSweep;
+        _liveAfterSweep = other._liveAfterSweep;
+        _rebuildCustomIds();
+    }
+    return *this;
+}
+
+HyperlinkTable::Id HyperlinkTable::Acquire(const std::wstring_view uri, const std::wstring_view customId)
+{
+    Id id;
+
+    if (customId.empty())
+    {
+        id = _allocate();
+        _entries[id] = { .uri = _append(uri), .occupied = true };
+    }
+    else
+    {
+        // The URI's hash is part of the key, so that the same custom id can be used for different URIs - GH#7698
+        std::wstring key{ customId };
+        key += L"%" + std::to_wstring(til::hash(uri));
+
+        CustomIdKey lookup{ *this, key, til::hash(key), 0 };
+        if (const auto slot = _customIds.lookup(lookup))
+        {
+            _lastId = slot->id;
+            return slot->id;
+        }
+
+        id = _allocate();
+        _entries[id] = { .uri = _append(uri), .customId = _append(key), .occupied = true };
+
+        // The entry must be filled in before inserting, because CustomIdTraits::equals() reads its custom id.
+        lookup.customId = GetCustomId(id);
+        lookup.id = id;
+        _customIds.insert(lookup);
+    }
+
+    _live++;
+    _addedSinceSweep++;
+    _lastId = id;
+    return id;
+}
+
+// Changes the URI of an existing link. The old string stays in the arena until the next Sweep().
+void HyperlinkTable::SetUri(const Id id, const std::wstring_view uri)
+{
+    if (Contains(id) && GetUri(id) != uri)
+    {
+        _entries[id].uri = _append(uri);
+    }
+}
+
+bool HyperlinkTable::Contains(const Id id) const noexcept
+{
+    return id != 0 && id < _entries.size() && _entries[id].occupied;
+}
+
+std::wstring_view HyperlinkTable::GetUri(const Id id) const noexcept
+{
+    return Contains(id) ? _view(_entries[id].uri) : std::wstring_view{};
+}
+
+std::wstring_view HyperlinkTable::GetCustomId(const Id id) const noexcept
+{
+    return Contains(id) ? _view(_entries[id].customId) : std::wstring_view{};
+}
+
+// Returns true if enough links were added since the last Sweep() that another one is worthwhile.
+// The threshold grows with the number of live entries, so that the cost of sweeping is amortized.
+bool HyperlinkTable::WantsSweep() const noexcept
+{
+    return _addedSinceSweep > std::max<size_t>(256, _liveAfterSweep);
+}
+
+void HyperlinkTable::Sweep(const std::vector<bool>& used)
+{
+    assert(used.size() == IdCount);
+
+    // Releasing the unused entries and compacting the arena happens in one go,
+    // since we need to copy the surviving strings over to a new arena anyway.
+    std::wstring arena;
+    arena.reserve(_arena.size());
+
+    const auto keep = [&](Span& span) {
+        const auto offset = gsl::narrow_cast<uint32_t>(arena.size());
+        arena.append(_view(span));
+        span.offset = offset;
+    };
+
+    _live = 0;
+    for (size_t id = 1; id < _entries.size(); ++id)
+    {
+        auto& entry = _entries[id];
+        if (!entry.occupied)
+        {
+            continue;
+        }
+        if (!used[id] && id != _lastId)
+        {
+            entry = {};
+            continue;
+        }
+
+        keep(entry.uri);
+        keep(entry.customId);
+        _live++;
+    }
+
+    _arena = std::move(arena);
+    _rebuildCustomIds();
+    _addedSinceSweep = 0;
+    _liveAfterSweep = _live;
+}
+
+std::wstring_view HyperlinkTable::_view(const Span& span) const noexcept
+{
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    return { _arena.data() + span.offset, span.length };
+}
+
+HyperlinkTable::Span HyperlinkTable::_append(const std::wstring_view str)
+{
+    const Span span{ gsl::narrow<uint32_t>(_arena.size()), gsl::narrow<uint32_t>(str.size()) };
+    _arena.append(str);
+    return span;
+}
+
+// Returns the next unoccupied id, growing _entries if needed.
+// If all ids are taken, the oldest one is evicted, just like the id counter used to wrap around.
+HyperlinkTable::Id HyperlinkTable::_allocate()
+{
+    auto id = _nextId;
+
+    for (size_t i = 1; i < IdCount && Contains(id); ++i)
+    {
+        id = id == IdCount - 1 ? Id{ 1 } : gsl::narrow_cast<Id>(id + 1);
+    }
+
+    if (id >= _entries.size())
+    {
+        _entries.resize(size_t{ id } + 1);
+    }
+
+    if (_entries[id].occupied)
+    {
+        const auto hadCustomId = _entries[id].customId.length != 0;
+        _entries[id] = {};
+        _live--;
+        if (hadCustomId)
+        {
+            _rebuildCustomIds();
+        }
+    }
+
+    _nextId = id == IdCount - 1 ? Id{ 1 } : gsl::narrow_cast<Id>(id + 1);
+    return id;
+}
+
+void HyperlinkTable::_rebuildCustomIds()
+{
+    // linear_flat_set doesn't support erasure, but Sweep() and friends are rare enough to just start over.
+    _customIds = decltype(_customIds){};
+
+    for (size_t id = 1; id < _entries.size(); ++id)
+    {
+        if (const auto customId = GetCustomId(gsl::narrow_cast<Id>(id)); !customId.empty())
+        {
+            _customIds.insert(CustomIdKey{ *this, customId, til::hash(customId), gsl::narrow_cast<Id>(id) });
+        }
+    }
+}
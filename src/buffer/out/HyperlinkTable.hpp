@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <til/flat_set.h>
+#include <til/hash.h>
+
+// Stores the URIs and custom ids of the OSC 8 hyperlinks of a TextBuffer, which refers to them by the 16-bit ids
+// kept in its TextAttributes. All strings live in a single arena and the custom ids are indexed by a linear probing
+// hash set, so that output with a link on every line (ripgrep, ls, ...) doesn't result in 2-3 heap allocations per link.
+//
+// Like TextAttributeTable, entries aren't refcounted. TextBuffer periodically marks the ids that are still in use
+// and sweeps the rest, once enough links were added since the last time. Id 0 always means "no hyperlink".
+class HyperlinkTable
+{
+public:
+    using Id = uint16_t;
+
+    // The size of the `used` vector that Sweep() expects.
+    static constexpr size_t IdCount = size_t{ 1 } << 16;
+
+    HyperlinkTable() = default;
+    HyperlinkTable(const HyperlinkTable& other);
+    HyperlinkTable& operator=(const HyperlinkTable& other);
+
+    // Returns the id for the given link. Links with the same custom id and URI share the same id.
+    Id Acquire(std::wstring_view uri, std::wstring_view customId);
+    void SetUri(Id id, std::wstring_view uri);
+
+    bool Contains(Id id) const noexcept;
+    // These return an empty string if the id is unknown.
+    std::wstring_view GetUri(Id id) const noexcept;
+    std::wstring_view GetCustomId(Id id) const noexcept;
+
+    bool WantsSweep() const noexcept;
+    // Releases all ids for which `used` is false, except for the most recently acquired one,
+    // which may still be in use by the current attributes of the cursor.
+    void Sweep(const std::vector<bool>& used);
+
+private:
+    struct Span
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    struct Entry
+    {
+        Span uri;
+        Span customId;
+        bool occupied = false;
+    };
+
+    struct CustomIdSlot
+    {
+        Id id = 0;
+        size_t hash = 0;
+    };
+
+    struct CustomIdKey
+    {
+        const HyperlinkTable& table;
+        std::wstring_view customId;
+        size_t hash;
+        Id id;
+    };
+
+    struct CustomIdTraits
+    {
+        static size_t hash(const CustomIdSlot& slot) noexcept
+        {
+            return slot.hash;
+        }
+
+        static size_t hash(const CustomIdKey& key) noexcept
+        {
+            return key.hash;
+        }
+
+        static bool occupied(const CustomIdSlot& slot) noexcept
+        {
+            return slot.id != 0;
+        }
+
+        static bool equals(const CustomIdSlot& slot, const CustomIdKey& key) noexcept
+        {
+            return slot.hash == key.hash && key.table.GetCustomId(slot.id) == key.customId;
+        }
+
+        static void assign(CustomIdSlot& slot, const CustomIdKey& key) noexcept
+        {
+            slot.id = key.id;
+            slot.hash = key.hash;
+        }
+    };
+
+    std::wstring_view _view(const Span& span) const noexcept;
+    Span _append(std::wstring_view str);
+    Id _allocate();
+    void _rebuildCustomIds();
+
+    std::vector<Entry> _entries;
+    std::wstring _arena;
+    til::linear_flat_set<CustomIdSlot, CustomIdTraits> _customIds;
+    // Ids are handed out round-robin, which avoids reusing swept ids for as long as possible.
+    Id _nextId = 1;
+    Id _lastId = 0;
+    size_t _live = 0;
+    // The number of entries that were added since the last Sweep() and the number of entries that survived it.
+    size_t _addedSinceSweep = 0;
+    size_t _liveAfterSweep = 0;
+};
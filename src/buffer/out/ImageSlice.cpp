@@ -23,6 +23,14 @@ void ImageSlice::BumpRevision() noexcept
     } while (_revision == 0);
 }
 
+// Routine Description:
+// - Reverts a preceding BumpRevision(), for writers that found out that they didn't actually
+//   change any pixels. This allows the renderer to skip uploading the slice again.
+void ImageSlice::RestoreRevision(const uint64_t revision) noexcept
+{
+    _revision = revision;
+}
+
 uint64_t ImageSlice::Revision() const noexcept
 {
     return _revision;
@@ -45,23 +53,28 @@ til::CoordType ImageSlice::PixelWidth() const noexcept
 
 std::span<const RGBQUAD> ImageSlice::Pixels() const noexcept
 {
-    return _pixelBuffer;
+    if (!_pixelBuffer)
+    {
+        return {};
+    }
+    return *_pixelBuffer;
 }
 
 const RGBQUAD* ImageSlice::Pixels(const til::CoordType columnBegin) const noexcept
 {
     const auto pixelOffset = (columnBegin - _columnBegin) * _cellSize.width;
-    return &til::at(_pixelBuffer, pixelOffset);
+    return &til::at(*_pixelBuffer, pixelOffset);
 }
 
 RGBQUAD* ImageSlice::MutablePixels(const til::CoordType columnBegin, const til::CoordType columnEnd)
 {
     // IF the buffer is empty or isn't large enough for the requested range, we'll need to resize it.
-    if (_pixelBuffer.empty() || columnBegin < _columnBegin || columnEnd > _columnEnd)
+    // Either way this allocates a new buffer, so it doesn't need to be made unique afterwards.
+    if (!_hasPixels() || columnBegin < _columnBegin || columnEnd > _columnEnd)
     {
         const auto oldColumnBegin = _columnBegin;
         const auto oldPixelWidth = _pixelWidth;
-        const auto existingData = !_pixelBuffer.empty();
+        const auto existingData = _hasPixels();
         _columnBegin = existingData ? std::min(_columnBegin, columnBegin) : columnBegin;
         _columnEnd = existingData ? std::max(_columnEnd, columnEnd) : columnEnd;
         _pixelWidth = (_columnEnd - _columnBegin) * _cellSize.width;
@@ -70,10 +83,10 @@ RGBQUAD* ImageSlice::MutablePixels(const til::CoordType columnBegin, const til::
         {
             // If there is existing data in the buffer, we need to copy it
             // across to the appropriate position in the new buffer.
-            auto newPixelBuffer = std::vector<RGBQUAD>(bufferSize);
+            auto newPixelBuffer = std::make_shared<std::vector<RGBQUAD>>(bufferSize);
             const auto newPixelOffset = (oldColumnBegin - _columnBegin) * _cellSize.width;
-            auto newIterator = std::next(newPixelBuffer.data(), newPixelOffset);
-            auto oldIterator = _pixelBuffer.data();
+            auto newIterator = std::next(newPixelBuffer->data(), newPixelOffset);
+            auto oldIterator = _pixelBuffer->data();
             // Because widths are rounded up to multiples of 4, it's possible
             // that the old width will extend past the right border of the new
             // buffer, so the range that we copy must be clamped to fit.
@@ -89,11 +102,15 @@ RGBQUAD* ImageSlice::MutablePixels(const til::CoordType columnBegin, const til::
         else
         {
             // Otherwise we just initialize the buffer to the correct size.
-            _pixelBuffer.resize(bufferSize);
+            _pixelBuffer = std::make_shared<std::vector<RGBQUAD>>(bufferSize);
         }
     }
+    else
+    {
+        _makeUnique();
+    }
     const auto pixelOffset = (columnBegin - _columnBegin) * _cellSize.width;
-    return &til::at(_pixelBuffer, pixelOffset);
+    return &til::at(*_pixelBuffer, pixelOffset);
 }
 
 void ImageSlice::CopyBlock(const TextBuffer& srcBuffer, const til::rect srcRect, TextBuffer& dstBuffer, const til::rect dstRect)
@@ -248,7 +265,8 @@ bool ImageSlice::_eraseCells(const til::CoordType columnBegin, const til::CoordT
         {
             const auto eraseOffset = (eraseBegin - _columnBegin) * _cellSize.width;
             const auto eraseLength = (eraseEnd - eraseBegin) * _cellSize.width;
-            auto eraseIterator = std::next(_pixelBuffer.data(), eraseOffset);
+            _makeUnique();
+            auto eraseIterator = std::next(_pixelBuffer->data(), eraseOffset);
             for (auto y = 0; y < _cellSize.height; y++)
             {
                 std::memset(eraseIterator, 0, eraseLength * sizeof(RGBQUAD));
@@ -258,3 +276,19 @@ bool ImageSlice::_eraseCells(const til::CoordType columnBegin, const til::CoordT
         return false;
     }
 }
+
+bool ImageSlice::_hasPixels() const noexcept
+{
+    return _pixelBuffer && !_pixelBuffer->empty();
+}
+
+// Routine Description:
+// - Copying a slice only copies the reference to its pixels. Before modifying
+//   them we need to make sure that we're not changing them for other slices too.
+void ImageSlice::_makeUnique()
+{
+    if (_pixelBuffer && _pixelBuffer.use_count() > 1)
+    {
+        _pixelBuffer = std::make_shared<std::vector<RGBQUAD>>(*_pixelBuffer);
+    }
+}
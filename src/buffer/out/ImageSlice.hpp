@@ -7,11 +7,14 @@ Module Name:
 
 Abstract:
 - This serves as a structure to represent a slice of an image covering one textbuffer row.
+- The pixels are shared between copies of a slice (e.g. during reflow or when
+  rows are copied between buffers) and only duplicated once one of them is modified.
 --*/
 
 #pragma once
 
 #include "til.h"
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -27,6 +30,7 @@ public:
     ImageSlice(const til::size cellSize) noexcept;
 
     void BumpRevision() noexcept;
+    void RestoreRevision(uint64_t revision) noexcept;
     uint64_t Revision() const noexcept;
 
     til::size CellSize() const noexcept;
@@ -47,10 +51,12 @@ public:
 private:
     bool _copyCells(const ImageSlice& srcSlice, const til::CoordType srcColumn, const til::CoordType dstColumnBegin, const til::CoordType dstColumnEnd);
     bool _eraseCells(const til::CoordType columnBegin, const til::CoordType columnEnd);
+    bool _hasPixels() const noexcept;
+    void _makeUnique();
 
     uint64_t _revision = 0;
     til::size _cellSize;
-    std::vector<RGBQUAD> _pixelBuffer;
+    std::shared_ptr<std::vector<RGBQUAD>> _pixelBuffer;
     til::CoordType _columnBegin = 0;
     til::CoordType _columnEnd = 0;
     til::CoordType _pixelWidth = 0;
@@ -44,6 +44,50 @@ constexpr OutIt iota_n_mut(OutIt dest, Diff count, T& val)
     return dest;
 }
 
+// Same as iota_n, but for the _charOffsets of long runs of ASCII text, which is the most common case
+// in ROW::WriteHelper::ReplaceText. It writes 8 offsets per vector store and finishes the rest one by one.
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+static void iota_n_u16(uint16_t* dest, size_t count, uint16_t val) noexcept
+{
+#if defined(TIL_SSE_INTRINSICS)
+    if (count >= 8)
+    {
+        const auto increment = _mm_set1_epi16(8);
+        auto offsets = _mm_add_epi16(_mm_set1_epi16(static_cast<short>(val)), _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7));
+
+        for (const auto end = dest + (count & ~size_t{ 7 }); dest < end; dest += 8)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), offsets);
+            offsets = _mm_add_epi16(offsets, increment);
+        }
+
+        val = gsl::narrow_cast<uint16_t>(val + (count & ~size_t{ 7 }));
+        count &= 7;
+    }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+    if (count >= 8)
+    {
+        alignas(uint16x8_t) static constexpr uint16_t offsetsData[]{ 0, 1, 2, 3, 4, 5, 6, 7 };
+        const auto increment = vdupq_n_u16(8);
+        auto offsets = vaddq_u16(vdupq_n_u16(val), vld1q_u16(&offsetsData[0]));
+
+        for (const auto end = dest + (count & ~size_t{ 7 }); dest < end; dest += 8)
+        {
+            vst1q_u16(dest, offsets);
+            offsets = vaddq_u16(offsets, increment);
+        }
+
+        val = gsl::narrow_cast<uint16_t>(val + (count & ~size_t{ 7 }));
+        count &= 7;
+    }
+#endif
+
+    iota_n(dest, count, val);
+}
+#pragma warning(pop)
+
 // Same as std::fill, but purpose-built for very small `last - first`
 // where a trivial loop outperforms vectorization.
 template<typename FwdIt, typename T>
@@ -156,14 +200,16 @@ til::CoordType CharToColumnMapper::GetTrailingColumnAt(const wchar_t* str) noexc
 // - constructor
 // Arguments:
 // - rowWidth - the width of the row, cell elements
+// - attrTable - the table that interns the attributes of this row
 // - fillAttribute - the default text attribute
 // Return Value:
 // - constructed object
-ROW::ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute) :
+ROW::ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, TextAttributeTable& attrTable, const TextAttribute& fillAttribute) :
     _charsBuffer{ charsBuffer },
     _chars{ charsBuffer, rowWidth },
     _charOffsets{ charOffsetsBuffer, ::base::strict_cast<size_t>(rowWidth) + 1u },
-    _attr{ rowWidth, fillAttribute },
+    _attrTable{ &attrTable },
+    _attr{ rowWidth, attrTable.Intern(fillAttribute) },
     _columnCount{ rowWidth }
 {
     _init();
@@ -224,7 +270,7 @@ void ROW::Reset(const TextAttribute& attr) noexcept
     _chars = { _charsBuffer, _columnCount };
     // Constructing and then moving objects into place isn't free.
     // Modifying the existing object is _much_ faster.
-    *_attr.runs().unsafe_shrink_to_size(1) = til::rle_pair{ attr, _columnCount };
+    *_attr.runs().unsafe_shrink_to_size(1) = til::rle_pair{ _attrTable->Intern(attr), _columnCount };
     _imageSlice = nullptr;
     _lineRendition = LineRendition::SingleWidth;
     _wrapForced = false;
@@ -353,16 +399,190 @@ void ROW::CopyFrom(const ROW& source)
     _lineRendition = source._lineRendition;
     _wrapForced = source._wrapForced;
 
+    // Rows of the same TextBuffer have the same width and share the attribute table, so we can copy their
+    // contents verbatim, instead of rewriting the text glyph by glyph and re-interning the attributes.
+    // That's what TextBuffer::ScrollRows() does for every row when scrolling within DECSTBM margins.
+    // Double-width rows take the slow path, because only their readable columns are meant to be copied.
+    if (this != &source &&
+        _columnCount == source._columnCount &&
+        _attrTable == source._attrTable &&
+        source._lineRendition == LineRendition::SingleWidth &&
+        source._charSize() <= _columnCount)
+    {
+        _charsHeap.reset();
+        _chars = { _charsBuffer, _columnCount };
+        std::copy_n(source._chars.begin(), source._charSize(), _chars.begin());
+        std::copy_n(source._charOffsets.begin(), _charOffsets.size(), _charOffsets.begin());
+        _attr = source._attr;
+        return;
+    }
+
     RowCopyTextFromState state{
         .source = source,
         .sourceColumnLimit = source.GetReadableColumnCount(),
     };
     CopyTextFrom(state);
 
-    _attr = source.Attributes();
+    _attr = source.SliceAttributes(0, source.size(), *_attrTable);
     _attr.resize_trailing_extent(_columnCount);
 }
 
+// Moves the contents of this ROW into a compact PackedRow. See PackedRow.
+// The ROW shouldn't be used afterwards, other than for destroying it.
+PackedRow ROW::Pack()
+{
+    auto packed = PackText();
+    packed.attr = std::move(_attr);
+    packed.promptData = std::move(_promptData);
+    packed.imageSlice = std::move(_imageSlice);
+    return packed;
+}
+
+// Like Pack(), but leaves this ROW untouched and only packs the text and the row flags.
+// The attributes, scrollbar data and image slice aren't part of the result.
+PackedRow ROW::PackText() const
+{
+    PackedRow packed;
+
+    // Whitespace is always exactly 1 column and 1 char wide, which
+    // allows us to trim it here and have Unpack() restore it for free.
+    auto colEnd = _columnCount;
+    for (; colEnd > 0; --colEnd)
+    {
+        const auto off = _charOffsets[colEnd - 1];
+        if (WI_IsFlagSet(off, CharOffsetsTrailer) || (_charOffsets[colEnd] & CharOffsetsMask) != off + 1u || _chars[off] != L' ')
+        {
+            break;
+        }
+    }
+
+    const auto chEnd = _uncheckedCharOffset(colEnd);
+    const auto chars = _chars.first(chEnd);
+
+    bool explicitOffsets = false;
+    for (uint16_t col = 0; col <= colEnd; ++col)
+    {
+        if (_charOffsets[col] != col)
+        {
+            explicitOffsets = true;
+            break;
+        }
+    }
+
+    const auto narrowChars = std::all_of(chars.begin(), chars.end(), [](wchar_t ch) { return ch < 0x100; });
+    const size_t offsetsSize = explicitOffsets ? colEnd * sizeof(uint16_t) : 0;
+    const size_t charsSize = chEnd * (narrowChars ? sizeof(uint8_t) : sizeof(wchar_t));
+
+    if (const auto size = offsetsSize + charsSize)
+    {
+        packed.data = std::make_unique_for_overwrite<std::byte[]>(size);
+        const auto data = packed.data.get();
+
+        memcpy(data, _charOffsets.data(), offsetsSize);
+
+        if (narrowChars)
+        {
+            std::transform(chars.begin(), chars.end(), data + offsetsSize, [](wchar_t ch) { return static_cast<std::byte>(ch); });
+        }
+        else
+        {
+            memcpy(data + offsetsSize, chars.data(), charsSize);
+        }
+    }
+
+    packed.columnEnd = colEnd;
+    packed.charsEnd = chEnd;
+    packed.narrowChars = narrowChars;
+    packed.explicitOffsets = explicitOffsets;
+    packed.lineRendition = _lineRendition;
+    packed.wrapForced = _wrapForced;
+    packed.doubleBytePadded = _doubleBytePadded;
+    return packed;
+}
+
+// Restores the contents of a PackedRow produced by Pack(). This ROW must
+// be in its initial state and have the same width as the packed one.
+void ROW::Unpack(PackedRow&& packed)
+{
+    assert(packed.columnEnd <= _columnCount);
+    assert(packed.attr.size() == _columnCount);
+
+    const size_t colEnd = packed.columnEnd;
+    const size_t chEnd = packed.charsEnd;
+    const auto charsLength = chEnd + (_columnCount - colEnd);
+
+    // The ROW is in its initial state and so _chars is filled with whitespace. The only
+    // thing we need to do is to allocate a larger buffer if the text doesn't fit into it.
+    if (charsLength > _chars.size())
+    {
+        _charsHeap = std::make_unique_for_overwrite<wchar_t[]>(charsLength);
+        _chars = { _charsHeap.get(), charsLength };
+        std::fill(_chars.begin() + chEnd, _chars.end(), L' ');
+    }
+
+    if (const auto data = packed.Data())
+    {
+        const size_t offsetsSize = packed.explicitOffsets ? colEnd * sizeof(uint16_t) : 0;
+        memcpy(_charOffsets.data(), data, offsetsSize);
+
+        if (packed.narrowChars)
+        {
+            std::transform(data + offsetsSize, data + offsetsSize + chEnd, _chars.begin(), [](std::byte ch) { return static_cast<wchar_t>(ch); });
+        }
+        else
+        {
+            memcpy(_chars.data(), data + offsetsSize, chEnd * sizeof(wchar_t));
+        }
+    }
+
+    if (packed.explicitOffsets)
+    {
+        iota_n(_charOffsets.begin() + colEnd, _charOffsets.size() - colEnd, gsl::narrow_cast<uint16_t>(chEnd));
+    }
+
+    _attr = std::move(packed.attr);
+    _promptData = std::move(packed.promptData);
+    _imageSlice = std::move(packed.imageSlice);
+    _lineRendition = packed.lineRendition;
+    _wrapForced = packed.wrapForced;
+    _doubleBytePadded = packed.doubleBytePadded;
+}
+
+// Unpack() trusts the PackedRow to come from Pack(). This checks the same for a PackedRow
+// that was read from elsewhere, so that it doesn't leave a ROW with corrupted text behind.
+bool ROW::IsUnpackable(const PackedRow& packed, const uint16_t columnCount) noexcept
+{
+    if (packed.columnEnd > columnCount || packed.attr.size() != columnCount)
+    {
+        return false;
+    }
+    if (packed.columnEnd == 0 || !packed.explicitOffsets)
+    {
+        return packed.charsEnd == packed.columnEnd;
+    }
+    if (!packed.Data())
+    {
+        return false;
+    }
+
+    uint16_t previous = 0;
+    for (uint16_t col = 0; col < packed.columnEnd; ++col)
+    {
+        uint16_t off;
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+        memcpy(&off, packed.Data() + col * sizeof(uint16_t), sizeof(off));
+        const auto trailer = WI_IsFlagSet(off, CharOffsetsTrailer);
+        off &= CharOffsetsMask;
+        // The first column must be a leading half and trailing halves have the same offset as their leading half.
+        if (off >= packed.charsEnd || off < previous || (col == 0 && (off != 0 || trailer)) || (trailer && off != previous))
+        {
+            return false;
+        }
+        previous = off;
+    }
+    return true;
+}
+
 // Returns the previous possible cursor position, preceding the given column.
 // Returns 0 if column is less than or equal to 0.
 til::CoordType ROW::NavigateToPrevious(til::CoordType column) const noexcept
@@ -428,7 +648,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
     // If we're given a right-side column limit, use it. Otherwise, the write limit is the final column index available in the char row.
     const auto finalColumnInRow = limitRight.value_or(size() - 1);
 
-    auto currentColor = it->TextAttr();
+    auto currentColor = _attrTable->Intern(it->TextAttr());
     uint16_t colorUses = 0;
     auto colorStarts = gsl::narrow_cast<uint16_t>(columnBegin);
     auto currentIndex = colorStarts;
@@ -439,8 +659,9 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
         if (it->TextAttrBehavior() != TextAttributeBehavior::Current)
         {
             // If the color of this cell is the same as the run we're currently on,
-            // just increment the counter.
-            if (currentColor == it->TextAttr())
+            // just increment the counter. Intern() caches the last attribute, so this is cheap.
+            const auto color = _attrTable->Intern(it->TextAttr());
+            if (currentColor == color)
             {
                 ++colorUses;
             }
@@ -449,7 +670,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
                 // Otherwise, commit this color into the run and save off the new one.
                 // Now commit the new color runs into the attr row.
                 _attr.replace(colorStarts, currentIndex, currentColor);
-                currentColor = it->TextAttr();
+                currentColor = color;
                 colorUses = 1;
                 colorStarts = currentIndex;
             }
@@ -536,12 +757,12 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const til::CoordType c
 
 void ROW::SetAttrToEnd(const til::CoordType columnBegin, const TextAttribute attr)
 {
-    _attr.replace(_clampedColumnInclusive(columnBegin), _attr.size(), attr);
+    _attr.replace(_clampedColumnInclusive(columnBegin), _attr.size(), _attrTable->Intern(attr));
 }
 
 void ROW::ReplaceAttributes(const til::CoordType beginIndex, const til::CoordType endIndex, const TextAttribute& newAttr)
 {
-    _attr.replace(_clampedColumnInclusive(beginIndex), _clampedColumnInclusive(endIndex), newAttr);
+    _attr.replace(_clampedColumnInclusive(beginIndex), _clampedColumnInclusive(endIndex), _attrTable->Intern(newAttr));
 }
 
 [[msvc::forceinline]] ROW::WriteHelper::WriteHelper(ROW& row, til::CoordType columnBegin, til::CoordType columnLimit, const std::wstring_view& chars) noexcept :
@@ -644,20 +865,20 @@ catch (...)
     // because ASCII is always 1 column wide per character.
     auto it = chars.begin();
     const auto end = it + std::min<size_t>(chars.size(), colLimit - colBeg);
+    const auto asciiLength = CodepointWidthDetector::AsciiPrefixLength({ it, end });
     size_t ch = chBeg;
 
-    while (it != end)
-    {
-        if (*it >= 0x80) [[unlikely]]
-        {
-            _replaceTextUnicode(ch, it);
-            return;
-        }
+    // ASCII maps 1:1 from columns to characters, so the offsets are just a sequence. The characters
+    // themselves get memcpy'd by Finish(). colEnd + asciiLength <= colLimit, which is in bounds.
+    iota_n_u16(row._charOffsets.data() + colEnd, asciiLength, gsl::narrow_cast<uint16_t>(ch));
+    colEnd = gsl::narrow_cast<uint16_t>(colEnd + asciiLength);
+    ch += asciiLength;
+    it += asciiLength;
 
-        til::at(row._charOffsets, colEnd) = gsl::narrow_cast<uint16_t>(ch);
-        ++colEnd;
-        ++ch;
-        ++it;
+    if (it != end) [[unlikely]]
+    {
+        _replaceTextUnicode(ch, it);
+        return;
     }
 
     colEndDirty = colEnd;
@@ -757,6 +978,43 @@ catch (...)
     charsConsumed = ch - chBeg;
 }
 
+// Same as ReplaceText(), but each character is stored in a column of its own, without grapheme segmentation
+// or width measurement. That's how WriteCells() stores CHAR_INFOs, which makes this usable as a faster
+// alternative for writing CHAR_INFOs that don't have COMMON_LVB_LEADING_BYTE/TRAILING_BYTE set.
+void ROW::ReplaceNarrowText(RowWriteState& state)
+try
+{
+    WriteHelper h{ *this, state.columnBegin, state.columnLimit, state.text };
+    if (!h.IsValid())
+    {
+        state.columnEnd = h.colBeg;
+        state.columnBeginDirty = h.colBeg;
+        state.columnEndDirty = h.colBeg;
+        return;
+    }
+    h.ReplaceNarrowText();
+    h.Finish();
+
+    state.text = state.text.substr(h.charsConsumed);
+    state.columnEnd = h.colEnd;
+    state.columnBeginDirty = h.colBegDirty;
+    state.columnEndDirty = h.colEndDirty;
+}
+catch (...)
+{
+    Reset(TextAttribute{});
+    throw;
+}
+
+[[msvc::forceinline]] void ROW::WriteHelper::ReplaceNarrowText() noexcept
+{
+    const auto count = gsl::narrow_cast<uint16_t>(std::min<size_t>(chars.size(), colLimit - colBeg));
+    iota_n(row._charOffsets.begin() + colEnd, count, chBeg);
+    colEnd += count;
+    colEndDirty = colEnd;
+    charsConsumed = count;
+}
+
 void ROW::CopyTextFrom(RowCopyTextFromState& state)
 try
 {
@@ -912,7 +1170,15 @@ void ROW::_resizeChars(uint16_t colEndDirty, uint16_t chBegDirty, size_t chEndDi
 
     if (newLength <= _chars.size())
     {
-        std::copy_n(_chars.begin() + chEndDirtyOld, currentLength - chEndDirtyOld, _chars.begin() + chEndDirty);
+        // The source and destination ranges overlap whenever the tail is longer than `diff`, and when a glyph
+        // got wider (e.g. an emoji replacing a narrow character) the destination lies ahead of the source.
+        // std::copy_n doesn't permit that, so we need memmove semantics here. Since the tail is everything
+        // after the written glyphs, there's nothing to move at all if we wrote up to the end of the row.
+        if (const auto tailLength = currentLength - chEndDirtyOld)
+        {
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+            memmove(_chars.data() + chEndDirty, _chars.data() + chEndDirtyOld, tailLength * sizeof(wchar_t));
+        }
     }
     else
     {
@@ -929,27 +1195,63 @@ void ROW::_resizeChars(uint16_t colEndDirty, uint16_t chBegDirty, size_t chEndDi
         _chars = chars;
     }
 
+    // Adding `diff` keeps the CharOffsetsTrailer bit intact, because offsets never exceed CharOffsetsMask.
+    // Written this way, the loop gets vectorized, which makes it cheap even for very wide rows.
+    const auto off = gsl::narrow_cast<uint16_t>(diff);
     auto it = _charOffsets.begin() + colEndDirty;
     const auto end = _charOffsets.end();
     for (; it != end; ++it)
     {
-        *it = gsl::narrow_cast<uint16_t>(*it + diff);
+        *it = gsl::narrow_cast<uint16_t>(*it + off);
     }
 }
 
-til::small_rle<TextAttribute, uint16_t, 1>& ROW::Attributes() noexcept
+TextAttributeTable& ROW::GetAttributeTable() const noexcept
+{
+    return *_attrTable;
+}
+
+// The returned runs store ids which need to be resolved via GetAttributeTable().
+til::small_rle<TextAttributeTable::Id, uint16_t, 1>& ROW::Attributes() noexcept
 {
     return _attr;
 }
 
-const til::small_rle<TextAttribute, uint16_t, 1>& ROW::Attributes() const noexcept
+const til::small_rle<TextAttributeTable::Id, uint16_t, 1>& ROW::Attributes() const noexcept
 {
     return _attr;
 }
 
+// Returns the attributes in the range [columnBegin, columnEnd) with their ids translated into
+// the given target table. This is a plain slice() if target is the table of this ROW.
+TextAttributeTable::Runs ROW::SliceAttributes(const uint16_t columnBegin, const uint16_t columnEnd, TextAttributeTable& target) const
+{
+    auto slice = _attr.slice(columnBegin, columnEnd);
+    if (&target != _attrTable)
+    {
+        for (auto& run : slice.runs())
+        {
+            run.value = target.Intern(_attrTable->Get(run.value));
+        }
+    }
+    return slice;
+}
+
+// Same as above, but the ids are translated with a lookup table that maps the ids of this ROW's table to the ones
+// of the target table. Unlike Intern() this doesn't modify the target table, which allows multiple threads to do it.
+TextAttributeTable::Runs ROW::SliceAttributes(const uint16_t columnBegin, const uint16_t columnEnd, const std::span<const TextAttributeTable::Id> translation) const
+{
+    auto slice = _attr.slice(columnBegin, columnEnd);
+    for (auto& run : slice.runs())
+    {
+        run.value = til::at(translation, run.value);
+    }
+    return slice;
+}
+
 TextAttribute ROW::GetAttrByColumn(const til::CoordType column) const
 {
-    return _attr.at(_clampedColumn(column));
+    return _attrTable->Get(_attr.at(_clampedColumn(column)));
 }
 
 std::vector<uint16_t> ROW::GetHyperlinks() const
@@ -957,9 +1259,10 @@ std::vector<uint16_t> ROW::GetHyperlinks() const
     std::vector<uint16_t> ids;
     for (const auto& run : _attr.runs())
     {
-        if (run.value.IsHyperlink())
+        const auto& attr = _attrTable->Get(run.value);
+        if (attr.IsHyperlink())
         {
-            ids.emplace_back(run.value.GetHyperlinkId());
+            ids.emplace_back(attr.GetHyperlinkId());
         }
     }
     return ids;
@@ -1114,6 +1417,26 @@ std::wstring_view ROW::GetText() const noexcept
     return { _chars.data(), width };
 }
 
+// Returns a hash of the visible contents of this ROW: Its text, attributes and line rendition.
+// The attributes are hashed by value and not by their TextAttributeTable id, so ROWs with the same contents
+// have the same hash, even across TextBuffers and attribute sweeps. Image content and WasWrapForced() aren't included.
+size_t ROW::ContentHash() const noexcept
+{
+    const auto text = GetText();
+
+    til::hasher h;
+    h.write(_lineRendition);
+    // The text alone doesn't say which glyphs are wide, but the offsets (and their CharOffsetsTrailer bit) do.
+    h.write(_charOffsets.data(), gsl::narrow_cast<size_t>(GetReadableColumnCount()));
+    h.write(text);
+    for (const auto& run : _attr.runs())
+    {
+        h.write(_attrTable->Get(run.value));
+        h.write(run.length);
+    }
+    return h.finalize();
+}
+
 std::wstring_view ROW::GetText(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept
 {
     const auto columns = GetReadableColumnCount();
@@ -1125,6 +1448,38 @@ std::wstring_view ROW::GetText(til::CoordType columnBegin, til::CoordType column
     return { _chars.data() + chBeg, chEnd - chBeg };
 }
 
+// Returns the text in [columnBegin, columnEnd) if each of these columns holds exactly one UTF-16 code unit,
+// so that the i-th character belongs to the i-th column. That's the common case for ASCII and Latin-1 text
+// and allows callers to process it as a plain array. Returns an empty string if the range contains
+// wide glyphs, surrogate pairs or combining marks, or if it extends past the readable columns.
+std::wstring_view ROW::GetNarrowText(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept
+{
+    const auto columns = GetReadableColumnCount();
+    if (columnBegin < 0 || columnEnd > columns || columnBegin >= columnEnd)
+    {
+        return {};
+    }
+
+    const auto colBeg = gsl::narrow_cast<size_t>(columnBegin);
+    const auto colEnd = gsl::narrow_cast<size_t>(columnEnd);
+    // The trailer flag is part of the raw offsets, so this also rejects wide glyphs.
+    const auto chBeg = til::at(_charOffsets, colBeg);
+    for (auto col = colBeg + 1; col <= colEnd; ++col)
+    {
+        if (til::at(_charOffsets, col) != chBeg + (col - colBeg))
+        {
+            return {};
+        }
+    }
+    if (WI_IsFlagSet(chBeg, CharOffsetsTrailer))
+    {
+        return {};
+    }
+
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    return { _chars.data() + chBeg, colEnd - colBeg };
+}
+
 til::CoordType ROW::GetLeadingColumnAtCharOffset(const ptrdiff_t offset) const noexcept
 {
     return _createCharToColumnMapper(offset).GetLeadingColumnAt(offset);
@@ -1135,7 +1490,24 @@ til::CoordType ROW::GetTrailingColumnAtCharOffset(const ptrdiff_t offset) const
     return _createCharToColumnMapper(offset).GetTrailingColumnAt(offset);
 }
 
-DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept
+DelimiterSet::DelimiterSet(const std::wstring_view& delimiters)
+{
+    for (const auto ch : delimiters)
+    {
+        if (ch < 128)
+        {
+            til::at(_ascii, ch / 64) |= uint64_t{ 1 } << (ch % 64);
+        }
+        else
+        {
+            _other.push_back(ch);
+        }
+    }
+
+    std::sort(_other.begin(), _other.end());
+}
+
+DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const DelimiterSet& wordDelimiters) const noexcept
 {
     const auto col = _clampedColumn(column);
     // Safety: col is [0, _columnCount).
@@ -1145,7 +1517,7 @@ DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const std::wstring_v
     {
         return DelimiterClass::ControlChar;
     }
-    else if (wordDelimiters.find(glyph) != std::wstring_view::npos)
+    else if (wordDelimiters.contains(glyph))
     {
         return DelimiterClass::DelimiterChar;
     }
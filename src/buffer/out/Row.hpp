@@ -10,6 +10,7 @@
 #include "OutputCell.hpp"
 #include "OutputCellIterator.hpp"
 #include "Marks.hpp"
+#include "TextAttributeTable.hpp"
 
 class ROW;
 class TextBuffer;
@@ -21,6 +22,28 @@ enum class DelimiterClass
     RegularChar
 };
 
+// The word delimiters (for instance the "wordDelimiters" setting) in a form that's cheap to query for each cell.
+// ASCII characters are looked up in a bitmap and all others (which are rare) in a sorted list.
+class DelimiterSet
+{
+public:
+    DelimiterSet() = default;
+    explicit DelimiterSet(const std::wstring_view& delimiters);
+
+    bool contains(const wchar_t ch) const noexcept
+    {
+        if (ch < 128)
+        {
+            return ((til::at(_ascii, ch / 64) >> (ch % 64)) & 1) != 0;
+        }
+        return std::binary_search(_other.begin(), _other.end(), ch);
+    }
+
+private:
+    uint64_t _ascii[2]{};
+    std::wstring _other;
+};
+
 struct RowWriteState
 {
     // The text you want to write into the given ROW. When ReplaceText() returns,
@@ -67,6 +90,43 @@ struct RowCopyTextFromState
     til::CoordType sourceColumnEnd = 0; // OUT
 };
 
+// A compact copy of a ROW's contents, produced by ROW::Pack() and consumed by ROW::Unpack().
+// TextBuffer uses it to store rows that are far away from the cursor and are unlikely to be accessed again.
+// Trailing whitespace is trimmed, text consisting only of U+0000-U+00FF is stored with 1 byte per character
+// and ROW::_charOffsets is omitted entirely if it's the identity mapping (= 1 char per column).
+struct PackedRow
+{
+    // Contains ROW::_charOffsets[0, columnEnd) (if explicitOffsets is true), followed by the text.
+    std::unique_ptr<std::byte[]> data;
+    // If TextBuffer moved `data` into its ColdScrollbackFile, this points to it instead.
+    const std::byte* mappedData = nullptr;
+    // Refers to the TextAttributeTable of the ROW that was packed.
+    TextAttributeTable::Runs attr;
+    std::optional<ScrollbarData> promptData;
+    ImageSlice::Pointer imageSlice;
+    // The columns [columnEnd, ROW::size()) only contain whitespace and aren't stored in `data`.
+    uint16_t columnEnd = 0;
+    // The length of the text in `data`, in characters.
+    uint16_t charsEnd = 0;
+    bool narrowChars = false;
+    bool explicitOffsets = false;
+    LineRendition lineRendition = LineRendition::SingleWidth;
+    bool wrapForced = false;
+    bool doubleBytePadded = false;
+
+    const std::byte* Data() const noexcept
+    {
+        return data ? data.get() : mappedData;
+    }
+
+    size_t DataSize() const noexcept
+    {
+        const size_t offsetsSize = explicitOffsets ? columnEnd * sizeof(uint16_t) : 0;
+        const size_t charsSize = charsEnd * (narrowChars ? sizeof(uint8_t) : sizeof(wchar_t));
+        return offsetsSize + charsSize;
+    }
+};
+
 // This structure is basically an inverse of ROW::_charOffsets. If you have a pointer
 // into a ROW's text this class can tell you what cell that pointer belongs to.
 struct CharToColumnMapper
@@ -89,6 +149,73 @@ private:
     til::CoordType _currentColumn;
 };
 
+// Iterates over the TextAttribute of each column in a ROW, resolving the ids that are stored in it.
+class RowAttributeIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TextAttribute;
+    using difference_type = ptrdiff_t;
+    using pointer = const TextAttribute*;
+    using reference = const TextAttribute&;
+
+    RowAttributeIterator(TextAttributeTable::Runs::const_iterator it, const TextAttributeTable* table) noexcept :
+        _it{ it },
+        _table{ table }
+    {
+    }
+
+    reference operator*() const noexcept
+    {
+        return _table->Get(*_it);
+    }
+
+    pointer operator->() const noexcept
+    {
+        return &operator*();
+    }
+
+    RowAttributeIterator& operator++() noexcept
+    {
+        ++_it;
+        return *this;
+    }
+
+    RowAttributeIterator operator++(int) noexcept
+    {
+        auto tmp = *this;
+        ++_it;
+        return tmp;
+    }
+
+    RowAttributeIterator& operator+=(difference_type move) noexcept
+    {
+        _it += move;
+        return *this;
+    }
+
+    RowAttributeIterator operator+(difference_type move) const noexcept
+    {
+        auto tmp = *this;
+        tmp += move;
+        return tmp;
+    }
+
+    bool operator==(const RowAttributeIterator& other) const noexcept
+    {
+        return _it == other._it;
+    }
+
+    bool operator!=(const RowAttributeIterator& other) const noexcept
+    {
+        return _it != other._it;
+    }
+
+private:
+    TextAttributeTable::Runs::const_iterator _it;
+    const TextAttributeTable* _table;
+};
+
 class ROW final
 {
 public:
@@ -116,7 +243,7 @@ public:
     }
 
     ROW() = default;
-    ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, const TextAttribute& fillAttribute);
+    ROW(wchar_t* charsBuffer, uint16_t* charOffsetsBuffer, uint16_t rowWidth, TextAttributeTable& attrTable, const TextAttribute& fillAttribute);
 
     ROW(const ROW& other) = delete;
     ROW& operator=(const ROW& other) = delete;
@@ -134,6 +261,10 @@ public:
 
     void Reset(const TextAttribute& attr) noexcept;
     void CopyFrom(const ROW& source);
+    PackedRow Pack();
+    PackedRow PackText() const;
+    void Unpack(PackedRow&& packed);
+    static bool IsUnpackable(const PackedRow& packed, uint16_t columnCount) noexcept;
 
     til::CoordType NavigateToPrevious(til::CoordType column) const noexcept;
     til::CoordType NavigateToNext(til::CoordType column) const noexcept;
@@ -144,13 +275,21 @@ public:
     OutputCellIterator WriteCells(OutputCellIterator it, til::CoordType columnBegin, std::optional<bool> wrap = std::nullopt, std::optional<til::CoordType> limitRight = std::nullopt);
     void SetAttrToEnd(til::CoordType columnBegin, TextAttribute attr);
     void ReplaceAttributes(til::CoordType beginIndex, til::CoordType endIndex, const TextAttribute& newAttr);
+    template<typename Func>
+    void TransformAttributes(til::CoordType columnBegin, til::CoordType columnEnd, Func&& func);
     void ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, const std::wstring_view& chars);
     void ReplaceText(RowWriteState& state);
+    void ReplaceNarrowText(RowWriteState& state);
     void CopyTextFrom(RowCopyTextFromState& state);
 
-    til::small_rle<TextAttribute, uint16_t, 1>& Attributes() noexcept;
-    const til::small_rle<TextAttribute, uint16_t, 1>& Attributes() const noexcept;
+    TextAttributeTable& GetAttributeTable() const noexcept;
+    TextAttributeTable::Runs& Attributes() noexcept;
+    const TextAttributeTable::Runs& Attributes() const noexcept;
+    TextAttributeTable::Runs SliceAttributes(uint16_t columnBegin, uint16_t columnEnd, TextAttributeTable& target) const;
+    TextAttributeTable::Runs SliceAttributes(uint16_t columnBegin, uint16_t columnEnd, std::span<const TextAttributeTable::Id> translation) const;
     TextAttribute GetAttrByColumn(til::CoordType column) const;
+    template<typename Func>
+    bool ForEachAttributeRun(til::CoordType columnBegin, til::CoordType columnEnd, Func&& func) const;
     std::vector<uint16_t> GetHyperlinks() const;
     ImageSlice* SetImageSlice(ImageSlice::Pointer imageSlice) noexcept;
     const ImageSlice* GetImageSlice() const noexcept;
@@ -163,13 +302,15 @@ public:
     std::wstring_view GlyphAt(til::CoordType column) const noexcept;
     DbcsAttribute DbcsAttrAt(til::CoordType column) const noexcept;
     std::wstring_view GetText() const noexcept;
+    size_t ContentHash() const noexcept;
     std::wstring_view GetText(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept;
+    std::wstring_view GetNarrowText(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept;
     til::CoordType GetLeadingColumnAtCharOffset(ptrdiff_t offset) const noexcept;
     til::CoordType GetTrailingColumnAtCharOffset(ptrdiff_t offset) const noexcept;
-    DelimiterClass DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept;
+    DelimiterClass DelimiterClassAt(til::CoordType column, const DelimiterSet& wordDelimiters) const noexcept;
 
-    auto AttrBegin() const noexcept { return _attr.begin(); }
-    auto AttrEnd() const noexcept { return _attr.end(); }
+    RowAttributeIterator AttrBegin() const noexcept { return { _attr.begin(), _attrTable }; }
+    RowAttributeIterator AttrEnd() const noexcept { return { _attr.end(), _attrTable }; }
 
     const std::optional<ScrollbarData>& GetScrollbarData() const noexcept;
     void SetScrollbarData(std::optional<ScrollbarData> data) noexcept;
@@ -190,6 +331,7 @@ private:
         bool IsValid() const noexcept;
         void ReplaceCharacters(til::CoordType width) noexcept;
         void ReplaceText() noexcept;
+        void ReplaceNarrowText() noexcept;
         void _replaceTextUnicode(size_t ch, std::wstring_view::const_iterator it) noexcept;
         void CopyTextFrom(const std::span<const uint16_t>& charOffsets) noexcept;
         static void _copyOffsets(uint16_t* dst, const uint16_t* src, uint16_t size, uint16_t offset) noexcept;
@@ -295,9 +437,11 @@ private:
     // In other words, _charOffsets tells us both the width in chars and width in columns.
     // See CharOffsetsTrailer for more information.
     std::span<uint16_t> _charOffsets;
-    // _attr is a run-length-encoded vector of TextAttribute with a decompressed
+    // The table which the ids in _attr refer to. It's owned by the TextBuffer.
+    TextAttributeTable* _attrTable = nullptr;
+    // _attr is a run-length-encoded vector of TextAttributeTable ids with a decompressed
     // length equal to _columnCount (= 1 TextAttribute per column).
-    til::small_rle<TextAttribute, uint16_t, 1> _attr;
+    TextAttributeTable::Runs _attr;
     // The width of the row in visual columns.
     uint16_t _columnCount = 0;
     // Stores double-width/height (DECSWL/DECDWL/DECDHL) attributes.
@@ -313,6 +457,43 @@ private:
     ImageSlice::Pointer _imageSlice;
 };
 
+// Calls func(attr, columnBegin, columnEnd) for every run of identical attributes within [columnBegin, columnEnd).
+// This is a lot cheaper than looking up the attribute of each cell individually (e.g. via TextBufferCellIterator).
+// The iteration stops early if func returns false, in which case this returns false as well.
+template<typename Func>
+bool ROW::ForEachAttributeRun(til::CoordType columnBegin, til::CoordType columnEnd, Func&& func) const
+{
+    const auto beg = gsl::narrow_cast<uint16_t>(std::clamp<til::CoordType>(columnBegin, 0, _columnCount));
+    const auto end = gsl::narrow_cast<uint16_t>(std::clamp<til::CoordType>(columnEnd, beg, _columnCount));
+    auto x = beg;
+    for (const auto& [id, length] : _attr.slice(beg, end).runs())
+    {
+        const auto next = gsl::narrow_cast<uint16_t>(x + length);
+        if (!func(_attrTable->Get(id), til::CoordType{ x }, til::CoordType{ next }))
+        {
+            return false;
+        }
+        x = next;
+    }
+    return true;
+}
+
+// Calls func(TextAttribute&) for every run of identical attributes within [columnBegin, columnEnd)
+// and replaces the run with the modified attribute. This is what DECCARA and DECRARA use, as it
+// only interns one attribute per run, instead of replacing each cell individually.
+template<typename Func>
+void ROW::TransformAttributes(til::CoordType columnBegin, til::CoordType columnEnd, Func&& func)
+{
+    const auto beg = gsl::narrow_cast<uint16_t>(std::clamp<til::CoordType>(columnBegin, 0, _columnCount));
+    const auto end = gsl::narrow_cast<uint16_t>(std::clamp<til::CoordType>(columnEnd, beg, _columnCount));
+    _attr.transform(beg, end, [&](const TextAttributeTable::Id id) {
+        // Intern() invalidates the reference returned by Get(), which is why we need a copy.
+        auto attr = _attrTable->Get(id);
+        func(attr);
+        return _attrTable->Intern(attr);
+    });
+}
+
 #ifdef UNIT_TESTING
 constexpr bool operator==(const ROW& a, const ROW& b) noexcept
 {
@@ -11,8 +11,10 @@ static_assert(sizeof(TextAttribute) == 18);
 static_assert(alignof(TextAttribute) == 2);
 // Ensure that we can memcpy() and memmove() the struct for performance.
 static_assert(std::is_trivially_copyable_v<TextAttribute>);
-// Assert that the use of memcmp() for comparisons is safe.
+// Assert that comparing the bytes like operator==() does is safe.
 static_assert(std::has_unique_object_representations_v<TextAttribute>);
+// operator==() compares two 64-bit words and the remaining 16 bits.
+static_assert(sizeof(TextAttribute) == 2 * sizeof(uint64_t) + sizeof(uint16_t));
 
 namespace
 {
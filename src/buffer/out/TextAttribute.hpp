@@ -105,14 +105,23 @@ public:
 
     void Invert() noexcept;
 
+    // These are used a lot, for instance by til::small_rle for every run it visits.
+    // Instead of relying on the compiler to inline memcmp() (which it doesn't in debug builds
+    // and only sometimes for an odd size like ours), we compare the struct as three words.
     inline bool operator==(const TextAttribute& other) const noexcept
     {
-        return memcmp(this, &other, sizeof(TextAttribute)) == 0;
+        uint64_t a[2], b[2];
+        uint16_t c, d;
+        memcpy(&a[0], this, sizeof(a));
+        memcpy(&b[0], &other, sizeof(b));
+        memcpy(&c, reinterpret_cast<const char*>(this) + sizeof(a), sizeof(c));
+        memcpy(&d, reinterpret_cast<const char*>(&other) + sizeof(b), sizeof(d));
+        return ((a[0] ^ b[0]) | (a[1] ^ b[1]) | (c ^ d)) == 0;
     }
 
     inline bool operator!=(const TextAttribute& other) const noexcept
     {
-        return memcmp(this, &other, sizeof(TextAttribute)) != 0;
+        return !(*this == other);
     }
 
     bool IsLegacy() const noexcept;
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "TextAttributeTable.hpp"
+
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator (bounds.4).
+
+TextAttributeTable::TextAttributeTable()
+{
+    _attributes.emplace_back();
+    _ids.emplace(TextAttribute{}, Id{ 0 });
+}
+
+TextAttributeTable::Id TextAttributeTable::Intern(const TextAttribute& attr) noexcept
+try
+{
+    if (attr == _lastAttribute)
+    {
+        return _lastId;
+    }
+
+    Id id;
+
+    if (const auto it = _ids.find(attr); it != _ids.end())
+    {
+        id = it->second;
+    }
+    else
+    {
+        if (!_free.empty())
+        {
+            id = _free.back();
+            _ids.emplace(attr, id);
+            _free.pop_back();
+            _attributes[id] = attr;
+        }
+        else
+        {
+            id = gsl::narrow<Id>(_attributes.size());
+            _attributes.emplace_back(attr);
+            try
+            {
+                _ids.emplace(attr, id);
+            }
+            catch (...)
+            {
+                _attributes.pop_back();
+                throw;
+            }
+        }
+        _addedSinceSweep++;
+    }
+
+    _lastAttribute = attr;
+    _lastId = id;
+    return id;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 0;
+}
+
+// Returns 1 past the largest id that was handed out so far. Use this to size the vector for Sweep().
+size_t TextAttributeTable::Capacity() const noexcept
+{
+    return _attributes.size();
+}
+
+// Returns true if the table has grown enough since the last Sweep() that another one is worthwhile.
+// The threshold grows with the number of live entries, so that the cost of sweeping is amortized.
+bool TextAttributeTable::WantsSweep() const noexcept
+{
+    return _addedSinceSweep > std::max<size_t>(1024, _liveAfterSweep);
+}
+
+// Releases all ids for which `used` is false, except for id 0.
+void TextAttributeTable::Sweep(const std::vector<bool>& used) noexcept
+{
+    assert(used.size() == _attributes.size());
+
+    // _free may already contain some of the ids. They're marked as unused here as well,
+    // so we need to rebuild it from scratch to avoid adding them twice.
+    _free.clear();
+    _ids.clear();
+    _ids.emplace(TextAttribute{}, Id{ 0 });
+
+    size_t live = 1;
+    for (Id id = 1; id < _attributes.size(); ++id)
+    {
+        if (used[id])
+        {
+            _ids.emplace(_attributes[id], id);
+            live++;
+        }
+        else
+        {
+            _free.emplace_back(id);
+        }
+    }
+
+    // Free the ids in ascending order, which keeps the table compact.
+    std::reverse(_free.begin(), _free.end());
+
+    _lastAttribute = {};
+    _lastId = 0;
+    _addedSinceSweep = 0;
+    _liveAfterSweep = live;
+}
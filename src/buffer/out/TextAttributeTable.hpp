@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <til/hash.h>
+#include <til/rle.h>
+
+#include "TextAttribute.hpp"
+
+// Interns the TextAttributes of a TextBuffer. Instead of storing the 18 byte large TextAttribute in each of their
+// runs, ROWs store the 4 byte large ids handed out by this table. This shrinks a run from 20 to 8 bytes, which matters
+// for heavily colored output, where a large fraction of all runs are 1-2 columns wide.
+//
+// Ids stay valid until they're released by Sweep(). TextBuffer periodically marks all ids that are still in use
+// and sweeps the rest. Until then, unused entries simply occupy memory. Id 0 always refers to TextAttribute{}.
+class TextAttributeTable
+{
+public:
+    using Id = uint32_t;
+    using Runs = til::small_rle<Id, uint16_t, 1>;
+
+    TextAttributeTable();
+
+    // If the table can't grow due to an OOM situation, this returns id 0 (= TextAttribute{}).
+    // This allows us to keep functions like ROW::Reset() noexcept.
+    Id Intern(const TextAttribute& attr) noexcept;
+    // The returned reference is invalidated by the next call to Intern().
+    const TextAttribute& Get(const Id id) const noexcept
+    {
+        assert(id < _attributes.size());
+        return _attributes[id];
+    }
+
+    size_t Capacity() const noexcept;
+    bool WantsSweep() const noexcept;
+    void Sweep(const std::vector<bool>& used) noexcept;
+
+private:
+    struct Hasher
+    {
+        size_t operator()(const TextAttribute& attr) const noexcept
+        {
+            return til::hash(attr);
+        }
+    };
+
+    std::vector<TextAttribute> _attributes;
+    std::unordered_map<TextAttribute, Id, Hasher> _ids;
+    std::vector<Id> _free;
+    // The most recently interned attribute. Consecutive Intern() calls are usually for the same attribute.
+    TextAttribute _lastAttribute;
+    Id _lastId = 0;
+    // The number of entries that were added since the last Sweep() and the number of entries that survived it.
+    size_t _addedSinceSweep = 0;
+    size_t _liveAfterSweep = 1;
+};
@@ -6,6 +6,8 @@
 
 #include "textBuffer.hpp"
 
+#include <til/hash.h>
+
 // All of these are somewhat annoying when trying to implement RefcountBuffer.
 // You can't stuff a unique_ptr into ut->q (= void*) after all.
 #pragma warning(disable : 26402) // Return a scoped object instead of a heap-allocated if it has a move constructor (r.3).
@@ -18,37 +20,35 @@ struct RowRange
     til::CoordType end;
 };
 
+// A chunk spans as many rows as it takes to reach the target size. The target starts out small and is doubled
+// whenever ICU walks into the adjacent chunk, so that a regex scanning the entire buffer needs few, large chunks,
+// while the random accesses of BufferRangeFromMatch() only copy a couple rows.
+static constexpr size_t minChunkSize = 512;
+static constexpr size_t maxChunkSize = 64 * 1024;
+
+// The stitched text of multi-row chunks. It's reused for the next chunk unless a clone still refers to it.
 struct RefcountBuffer
 {
-    size_t references;
-    size_t capacity;
-    wchar_t data[1];
+    size_t references = 1;
+    std::wstring text;
+    // The offset of each row's first character in `text`. See accessRowAndOffset().
+    std::vector<int32_t> rowOffsets;
 
-    static RefcountBuffer* EnsureCapacityForOverwrite(RefcountBuffer* buffer, size_t capacity)
+    static RefcountBuffer* EnsureExclusive(RefcountBuffer* buffer)
     {
-        // We must not just ensure that `buffer` has at least `capacity`, but also that its reference count is <= 1, because otherwise we would resize a shared buffer.
-        if (buffer != nullptr && buffer->references <= 1 && buffer->capacity >= capacity)
+        // We must ensure that the reference count is <= 1, because otherwise we would overwrite a shared buffer.
+        if (buffer != nullptr && buffer->references <= 1)
         {
             return buffer;
         }
 
-        const auto oldCapacity = buffer ? buffer->capacity << 1 : 0;
-        const auto newCapacity = std::max(capacity + 128, oldCapacity);
-        const auto newBuffer = static_cast<RefcountBuffer*>(::operator new(sizeof(RefcountBuffer) - sizeof(data) + newCapacity * sizeof(wchar_t)));
-
-        if (!newBuffer)
-        {
-            return nullptr;
-        }
+        const auto newBuffer = new RefcountBuffer;
 
         if (buffer)
         {
             buffer->Release();
         }
 
-        // Copying the old buffer's data is not necessary because utextAccess() will scribble right over it.
-        newBuffer->references = 1;
-        newBuffer->capacity = newCapacity;
         return newBuffer;
     }
 
@@ -67,7 +67,7 @@ struct RefcountBuffer
         assert(references > 0 && references < 1000);
         if (--references == 0)
         {
-            ::operator delete(this);
+            delete this;
         }
     }
 };
@@ -90,11 +90,47 @@ constexpr RowRange& accessRowRange(UText* ut) noexcept
     return *std::bit_cast<RowRange*>(&ut->a);
 }
 
+// The first row of the current chunk.
 constexpr til::CoordType& accessCurrentRow(UText* ut) noexcept
 {
     return ut->b;
 }
 
+// The number of rows in the current chunk.
+constexpr int32_t& accessChunkRows(UText* ut) noexcept
+{
+    return ut->c;
+}
+
+constexpr size_t& accessChunkSizeTarget(UText* ut) noexcept
+{
+    static_assert(sizeof(ut->r) == sizeof(size_t));
+    return *std::bit_cast<size_t*>(&ut->r);
+}
+
+// Later down below we'll add a newline to the text if !wasWrapForced, so we need to account for that here.
+static int64_t rowLength(const ROW& row)
+{
+    return gsl::narrow_cast<int64_t>(row.GetText().size() + !row.WasWrapForced());
+}
+
+// Maps the current chunkOffset to the row it's in and the offset within that row's text.
+static std::pair<til::CoordType, int32_t> accessRowAndOffset(UText* ut) noexcept
+{
+    const auto y = accessCurrentRow(ut);
+    const auto buffer = accessBuffer(ut);
+
+    if (accessChunkRows(ut) <= 1 || !buffer)
+    {
+        return { y, ut->chunkOffset };
+    }
+
+    const auto beg = buffer->rowOffsets.begin();
+    const auto end = beg + accessChunkRows(ut);
+    const auto it = std::upper_bound(beg + 1, end, ut->chunkOffset) - 1;
+    return { y + gsl::narrow_cast<til::CoordType>(it - beg), ut->chunkOffset - *it };
+}
+
 // An excerpt from the ICU documentation:
 //
 // Clone a UText. Much like opening a UText where the source text is itself another UText.
@@ -203,69 +239,105 @@ try
 
     if (neededIndex < startOld || neededIndex >= limitOld)
     {
-        auto y = accessCurrentRow(ut);
-        std::wstring_view text;
-        bool wasWrapForced = false;
-
-        if (neededIndex < start)
+        // First find the row that contains the neededIndex, by walking away from the current chunk.
+        // If we went out-of-bounds, this will be the first/last row, because we still need to update
+        // the chunkContents to contain the first/last chunk (unless we're already there).
+        const auto backward = neededIndex < startOld;
+        auto y = backward ? accessCurrentRow(ut) : accessCurrentRow(ut) + accessChunkRows(ut) - 1;
+        auto rowStart = backward ? startOld : limitOld;
+        auto rowLimit = rowStart;
+        auto moved = false;
+
+        if (backward)
         {
-            do
+            while (y > range.begin && neededIndex < rowStart)
             {
                 --y;
-                if (y < range.begin)
-                {
-                    break;
-                }
-
-                const auto& row = textBuffer.GetRowByOffset(y);
-                text = row.GetText();
-                wasWrapForced = row.WasWrapForced();
-
-                limit = start;
-                // Later down below we'll add a newline to the text if !wasWrapForced, so we need to account for that here.
-                start -= text.size() + !wasWrapForced;
-            } while (neededIndex < start);
+                rowLimit = rowStart;
+                rowStart -= rowLength(textBuffer.GetRowByOffset(y));
+                moved = true;
+            }
         }
         else
         {
-            do
+            while (y + 1 < range.end && neededIndex >= rowLimit)
             {
                 ++y;
-                if (y >= range.end)
+                rowStart = rowLimit;
+                rowLimit += rowLength(textBuffer.GetRowByOffset(y));
+                moved = true;
+            }
+        }
+
+        if (moved)
+        {
+            // Walking into the adjacent chunk means ICU is iterating sequentially and will most likely continue doing so.
+            const auto sequential = backward ? rowLimit == startOld : rowStart == limitOld;
+            auto& target = accessChunkSizeTarget(ut);
+            target = sequential ? std::min(target * 2, maxChunkSize) : minChunkSize;
+            const auto targetLength = gsl::narrow_cast<int64_t>(target);
+
+            // Then extend the chunk in the direction of travel up to the target size.
+            auto first = y;
+            auto last = y;
+            start = rowStart;
+            limit = rowLimit;
+
+            if (backward)
+            {
+                while (first > range.begin && limit - start < targetLength)
                 {
-                    break;
+                    --first;
+                    start -= rowLength(textBuffer.GetRowByOffset(first));
                 }
+            }
+            else
+            {
+                while (last + 1 < range.end && limit - start < targetLength)
+                {
+                    ++last;
+                    limit += rowLength(textBuffer.GetRowByOffset(last));
+                }
+            }
 
-                const auto& row = textBuffer.GetRowByOffset(y);
-                text = row.GetText();
-                wasWrapForced = row.WasWrapForced();
-
-                start = limit;
-                // Later down below we'll add a newline to the text if !wasWrapForced, so we need to account for that here.
-                limit += text.size() + !wasWrapForced;
-            } while (neededIndex >= limit);
-        }
+            assert(start >= 0);
+            // If we have already calculated the total length we can also assert that the limit is in range.
+            assert(ut->p == nullptr || static_cast<size_t>(limit) <= accessLength(ut));
 
-        assert(start >= 0);
-        // If we have already calculated the total length we can also assert that the limit is in range.
-        assert(ut->p == nullptr || static_cast<size_t>(limit) <= accessLength(ut));
+            std::wstring_view text;
+            const auto& firstRow = textBuffer.GetRowByOffset(first);
 
-        // Even if we went out-of-bounds, we still need to update the chunkContents to contain the first/last chunk.
-        if (limit != limitOld)
-        {
-            if (!wasWrapForced)
+            if (first == last && firstRow.WasWrapForced())
             {
-                const auto newSize = text.size() + 1;
-                const auto buffer = RefcountBuffer::EnsureCapacityForOverwrite(accessBuffer(ut), newSize);
+                // A single row without a trailing newline can be used as is.
+                text = firstRow.GetText();
+            }
+            else
+            {
+                const auto buffer = RefcountBuffer::EnsureExclusive(accessBuffer(ut));
+                accessBuffer(ut) = buffer;
 
-                memcpy(&buffer->data[0], text.data(), text.size() * sizeof(wchar_t));
-                til::at(buffer->data, text.size()) = L'\n';
+                buffer->text.clear();
+                buffer->rowOffsets.clear();
 
-                text = { &buffer->data[0], newSize };
-                accessBuffer(ut) = buffer;
+                for (auto i = first; i <= last; ++i)
+                {
+                    const auto& row = textBuffer.GetRowByOffset(i);
+                    buffer->rowOffsets.emplace_back(gsl::narrow_cast<int32_t>(buffer->text.size()));
+                    buffer->text.append(row.GetText());
+                    if (!row.WasWrapForced())
+                    {
+                        buffer->text.push_back(L'\n');
+                    }
+                }
+
+                text = buffer->text;
             }
 
-            accessCurrentRow(ut) = y;
+            assert(gsl::narrow_cast<int64_t>(text.size()) == limit - start);
+
+            accessCurrentRow(ut) = first;
+            accessChunkRows(ut) = last - first + 1;
             ut->chunkNativeStart = start;
             ut->chunkNativeLimit = limit;
             ut->chunkLength = gsl::narrow_cast<int32_t>(text.size());
@@ -340,10 +412,9 @@ try
         return gsl::narrow_cast<int32_t>(nativeLimit - nativeStart);
     }
 
-    const auto& textBuffer = *static_cast<const TextBuffer*>(ut->context);
-    const auto y = accessCurrentRow(ut);
-    const auto offset = ut->chunkNativeStart - nativeStart;
-    const auto text = textBuffer.GetRowByOffset(y).GetText().substr(gsl::narrow_cast<size_t>(std::max<int64_t>(0, offset)));
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+    const std::wstring_view chunk{ reinterpret_cast<const wchar_t*>(ut->chunkContents), gsl::narrow_cast<size_t>(ut->chunkLength) };
+    const auto text = chunk.substr(gsl::narrow_cast<size_t>(ut->chunkOffset), gsl::narrow_cast<size_t>(nativeLimit - nativeStart));
     const auto destCapacitySizeT = gsl::narrow_cast<size_t>(destCapacity);
     const auto length = std::min(destCapacitySizeT, text.size());
 
@@ -393,24 +464,159 @@ Microsoft::Console::ICU::unique_utext Microsoft::Console::ICU::UTextFromTextBuff
     ut.providerProperties = (1 << UTEXT_PROVIDER_LENGTH_IS_EXPENSIVE) | (1 << UTEXT_PROVIDER_STABLE_CHUNKS);
     ut.pFuncs = &utextFuncs;
     ut.context = &textBuffer;
-    accessCurrentRow(&ut) = rowBeg - 1; // the utextAccess() below will advance this by 1.
+    accessCurrentRow(&ut) = rowBeg; // the utextAccess() below will walk into this row, because the current chunk is empty.
+    accessChunkRows(&ut) = 0;
+    accessChunkSizeTarget(&ut) = minChunkSize / 2; // the initial access counts as sequential and doubles this.
     accessRowRange(&ut) = { rowBeg, rowEnd };
 
     utextAccess(&ut, 0, true);
     return ut;
 }
 
-Microsoft::Console::ICU::unique_uregex Microsoft::Console::ICU::CreateRegex(const std::wstring_view& pattern, uint32_t flags, UErrorCode* status) noexcept
+static void applyRegexLimits(URegularExpression* re, UErrorCode* status) noexcept
 {
-#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
-    const auto re = uregex_open(reinterpret_cast<const char16_t*>(pattern.data()), gsl::narrow_cast<int32_t>(pattern.size()), flags, nullptr, status);
     // ICU describes the time unit as being dependent on CPU performance and "typically [in] the order of milliseconds",
     // but this claim seems highly outdated already. On my CPU from 2021, a limit of 4096 equals roughly 600ms.
     uregex_setTimeLimit(re, 4096, status);
     uregex_setStackLimit(re, 4 * 1024 * 1024, status);
+}
+
+Microsoft::Console::ICU::unique_uregex Microsoft::Console::ICU::CreateRegex(const std::wstring_view& pattern, uint32_t flags, UErrorCode* status) noexcept
+{
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+    const auto re = uregex_open(reinterpret_cast<const char16_t*>(pattern.data()), gsl::narrow_cast<int32_t>(pattern.size()), flags, nullptr, status);
+    applyRegexLimits(re, status);
     return unique_uregex{ re };
 }
 
+namespace
+{
+    struct URegularExpressionInterner
+    {
+        // Interns (caches) URegularExpression instances so that they can be reused. This method is thread-safe.
+        // uregex_open is not terribly expensive at ~10us/op, but it's also much more expensive than uregex_clone
+        // at ~400ns/op and would effectively double the time it takes to scan the viewport for patterns.
+        // It also means that typing into the search box of several panes doesn't recompile the same pattern for each.
+        Microsoft::Console::ICU::unique_uregex Intern(const std::wstring_view& pattern, uint32_t flags, UErrorCode* status)
+        {
+            const KeyView view{ pattern, flags };
+
+            {
+                const auto guard = _lock.lock_shared();
+                if (const auto it = _cache.find(view); it != _cache.end())
+                {
+                    return _clone(it->second, status);
+                }
+            }
+
+            // Even if the URegularExpression creation failed, we'll insert it into the cache, because there's no point in retrying.
+            // (Apart from OOM but in that case this application will crash anyways in 3.. 2.. 1..)
+            CacheValue value;
+            value.re = Microsoft::Console::ICU::CreateRegex(pattern, flags, &value.status);
+            auto clone = _clone(value, status);
+            Key key{ std::wstring{ pattern }, flags };
+
+            const auto guard = _lock.lock_exclusive();
+
+            value.generation = _totalInsertions++;
+            _cache.insert_or_assign(std::move(key), std::move(value));
+
+            // If the cache is full remove the oldest element (oldest = lowest generation, just like with humans).
+            if (_cache.size() > cacheSizeLimit)
+            {
+                _cache.erase(std::min_element(_cache.begin(), _cache.end(), [](const auto& it, const auto& smallest) {
+                    return it.second.generation < smallest.second.generation;
+                }));
+            }
+
+            return clone;
+        }
+
+    private:
+        struct Key
+        {
+            std::wstring pattern;
+            uint32_t flags = 0;
+        };
+
+        struct KeyView
+        {
+            std::wstring_view pattern;
+            uint32_t flags = 0;
+
+            KeyView(const std::wstring_view& pattern, uint32_t flags) noexcept :
+                pattern{ pattern }, flags{ flags }
+            {
+            }
+
+            KeyView(const Key& key) noexcept :
+                pattern{ key.pattern }, flags{ key.flags }
+            {
+            }
+
+            bool operator==(const KeyView& other) const noexcept
+            {
+                return flags == other.flags && pattern == other.pattern;
+            }
+        };
+
+        struct CacheValue
+        {
+            Microsoft::Console::ICU::unique_uregex re;
+            UErrorCode status = U_ZERO_ERROR;
+            size_t generation = 0;
+        };
+
+        struct CacheKeyHasher
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(const KeyView& key) const noexcept
+            {
+                return til::hash(key.pattern) ^ key.flags;
+            }
+        };
+
+        struct CacheKeyEqual
+        {
+            using is_transparent = void;
+
+            bool operator()(const KeyView& lhs, const KeyView& rhs) const noexcept
+            {
+                return lhs == rhs;
+            }
+        };
+
+        static Microsoft::Console::ICU::unique_uregex _clone(const CacheValue& value, UErrorCode* status) noexcept
+        {
+            if (value.status > U_ZERO_ERROR)
+            {
+                *status = value.status;
+                return {};
+            }
+
+            // The time and stack limits belong to the matcher and aren't cloned along with the pattern.
+            Microsoft::Console::ICU::unique_uregex clone{ uregex_clone(value.re.get(), status) };
+            applyRegexLimits(clone.get(), status);
+            return clone;
+        }
+
+        static constexpr size_t cacheSizeLimit = 128;
+        wil::srwlock _lock;
+        std::unordered_map<Key, CacheValue, CacheKeyHasher, CacheKeyEqual> _cache;
+        size_t _totalInsertions = 0;
+    };
+
+    URegularExpressionInterner uregexInterner;
+}
+
+// Like CreateRegex(), but the compiled pattern is cached and only cloned for the caller.
+// It's safe to call this from any thread.
+Microsoft::Console::ICU::unique_uregex Microsoft::Console::ICU::InternRegex(const std::wstring_view& pattern, uint32_t flags, UErrorCode* status)
+{
+    return uregexInterner.Intern(pattern, flags, status);
+}
+
 // Returns an inclusive point range given a text start and end position.
 // This function is designed to be used with uregex_start64/uregex_end64.
 til::point_span Microsoft::Console::ICU::BufferRangeFromMatch(UText* ut, URegularExpression* re)
@@ -427,8 +633,8 @@ til::point_span Microsoft::Console::ICU::BufferRangeFromMatch(UText* ut, URegula
 
     if (utextAccess(ut, nativeIndexBeg, true))
     {
-        const auto y = accessCurrentRow(ut);
-        ret.start.x = textBuffer.GetRowByOffset(y).GetLeadingColumnAtCharOffset(ut->chunkOffset);
+        const auto [y, offset] = accessRowAndOffset(ut);
+        ret.start.x = textBuffer.GetRowByOffset(y).GetLeadingColumnAtCharOffset(offset);
         ret.start.y = y;
     }
     else
@@ -438,8 +644,8 @@ til::point_span Microsoft::Console::ICU::BufferRangeFromMatch(UText* ut, URegula
 
     if (utextAccess(ut, nativeIndexEnd, true))
     {
-        const auto y = accessCurrentRow(ut);
-        ret.end.x = textBuffer.GetRowByOffset(y).GetTrailingColumnAtCharOffset(ut->chunkOffset);
+        const auto [y, offset] = accessRowAndOffset(ut);
+        ret.end.x = textBuffer.GetRowByOffset(y).GetTrailingColumnAtCharOffset(offset);
         ret.end.y = y;
     }
     else
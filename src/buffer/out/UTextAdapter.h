@@ -14,5 +14,6 @@ namespace Microsoft::Console::ICU
 
     unique_utext UTextFromTextBuffer(const TextBuffer& textBuffer, til::CoordType rowBeg, til::CoordType rowEnd) noexcept;
     unique_uregex CreateRegex(const std::wstring_view& pattern, uint32_t flags, UErrorCode* status) noexcept;
+    unique_uregex InternRegex(const std::wstring_view& pattern, uint32_t flags, UErrorCode* status);
     til::point_span BufferRangeFromMatch(UText* ut, URegularExpression* re);
 }
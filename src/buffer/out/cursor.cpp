@@ -178,60 +178,58 @@ void Cursor::_RedrawCursorAlways() noexcept
     _parentBuffer.NotifyPaintFrame();
 }
 
-void Cursor::SetPosition(const til::point cPosition) noexcept
+// Routine Description:
+// - Moves the cursor and requests a frame if it actually moved.
+// - The renderer remembers where it drew the cursor and invalidates just that cell and the
+//   cursor's new position once per frame (see Renderer::_PaintFrame()). So, no matter how often
+//   a TUI moves the cursor around in between two frames, a single notification is enough.
+// Arguments:
+// - position - The new position in screen buffer coordinates.
+// Return Value:
+// - <none>
+void Cursor::_SetPosition(const til::point position) noexcept
 {
-    _RedrawCursor();
-    _cPosition = cPosition;
-    _RedrawCursor();
+    if (_cPosition != position)
+    {
+        _cPosition = position;
+        _RedrawCursor();
+    }
     ResetDelayEOLWrap();
 }
 
+void Cursor::SetPosition(const til::point cPosition) noexcept
+{
+    _SetPosition(cPosition);
+}
+
 void Cursor::SetXPosition(const til::CoordType NewX) noexcept
 {
-    _RedrawCursor();
-    _cPosition.x = NewX;
-    _RedrawCursor();
-    ResetDelayEOLWrap();
+    _SetPosition({ NewX, _cPosition.y });
 }
 
 void Cursor::SetYPosition(const til::CoordType NewY) noexcept
 {
-    _RedrawCursor();
-    _cPosition.y = NewY;
-    _RedrawCursor();
-    ResetDelayEOLWrap();
+    _SetPosition({ _cPosition.x, NewY });
 }
 
 void Cursor::IncrementXPosition(const til::CoordType DeltaX) noexcept
 {
-    _RedrawCursor();
-    _cPosition.x += DeltaX;
-    _RedrawCursor();
-    ResetDelayEOLWrap();
+    _SetPosition({ _cPosition.x + DeltaX, _cPosition.y });
 }
 
 void Cursor::IncrementYPosition(const til::CoordType DeltaY) noexcept
 {
-    _RedrawCursor();
-    _cPosition.y += DeltaY;
-    _RedrawCursor();
-    ResetDelayEOLWrap();
+    _SetPosition({ _cPosition.x, _cPosition.y + DeltaY });
 }
 
 void Cursor::DecrementXPosition(const til::CoordType DeltaX) noexcept
 {
-    _RedrawCursor();
-    _cPosition.x -= DeltaX;
-    _RedrawCursor();
-    ResetDelayEOLWrap();
+    _SetPosition({ _cPosition.x - DeltaX, _cPosition.y });
 }
 
 void Cursor::DecrementYPosition(const til::CoordType DeltaY) noexcept
 {
-    _RedrawCursor();
-    _cPosition.y -= DeltaY;
-    _RedrawCursor();
-    ResetDelayEOLWrap();
+    _SetPosition({ _cPosition.x, _cPosition.y - DeltaY });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -107,6 +107,7 @@ private:
     ULONG _ulSize;
 
     void _RedrawCursor() noexcept;
+    void _SetPosition(til::point position) noexcept;
     void _RedrawCursorAlways() noexcept;
 
     CursorType _cursorType;
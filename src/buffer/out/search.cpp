@@ -13,21 +13,40 @@ bool Search::IsStale(const Microsoft::Console::Render::IRenderData& renderData,
     return _renderData != &renderData ||
            _needle != needle ||
            _flags != flags ||
-           _lastMutationId != renderData.GetTextBuffer().GetLastMutationId();
+           _lastMutationId != renderData.GetTextBuffer().GetLastMutationId() ||
+           !_resultsComplete;
 }
 
 void Search::Reset(Microsoft::Console::Render::IRenderData& renderData, const std::wstring_view& needle, SearchFlag flags, bool reverse)
 {
     const auto& textBuffer = renderData.GetTextBuffer();
+    const auto refine = _canRefine(renderData, needle, flags);
 
     _renderData = &renderData;
     _needle = needle;
     _flags = flags;
-    _lastMutationId = textBuffer.GetLastMutationId();
 
-    auto result = textBuffer.SearchText(needle, _flags);
-    _ok = result.has_value();
-    _results = std::move(result).value_or(std::vector<til::point_span>{});
+    auto result = refine ? _refine(textBuffer) : textBuffer.SearchText(needle, _flags);
+    _setResults(std::move(result), textBuffer.GetLastMutationId(), true, reverse);
+}
+
+// Like Reset(), but with results that were computed elsewhere, usually by calling TextBuffer::SearchText()
+// on a background thread. `mutationId` is the buffer's GetLastMutationId() at the time of that search.
+// If the results only cover part of the buffer, `complete` must be false, which keeps IsStale() true.
+void Search::Adopt(Microsoft::Console::Render::IRenderData& renderData, const std::wstring_view& needle, SearchFlag flags, bool reverse, uint64_t mutationId, std::optional<std::vector<til::point_span>> results, bool complete)
+{
+    _renderData = &renderData;
+    _needle = needle;
+    _flags = flags;
+    _setResults(std::move(results), mutationId, complete, reverse);
+}
+
+void Search::_setResults(std::optional<std::vector<til::point_span>>&& results, uint64_t mutationId, bool complete, bool reverse)
+{
+    _lastMutationId = mutationId;
+    _ok = results.has_value();
+    _results = std::move(results).value_or(std::vector<til::point_span>{});
+    _resultsComplete = complete;
     _index = reverse ? gsl::narrow_cast<ptrdiff_t>(_results.size()) - 1 : 0;
     _step = reverse ? -1 : 1;
 
@@ -139,6 +158,7 @@ const std::vector<til::point_span>& Search::Results() const noexcept
 
 std::vector<til::point_span>&& Search::ExtractResults() noexcept
 {
+    _resultsComplete = false;
     return std::move(_results);
 }
 
@@ -151,3 +171,64 @@ bool Search::IsOk() const noexcept
 {
     return _ok;
 }
+
+// Find-as-you-type usually extends the needle while the buffer remains unchanged. In that case, every match of the
+// new needle starts where a match of the previous one did, which allows us to only search the rows around them.
+// This doesn't hold for regular expressions, nor for case-insensitive searches where full case folding may
+// map a single character to multiple ones: "\u00DF" (sharp s) matches "ss", but not "s".
+bool Search::_canRefine(const Microsoft::Console::Render::IRenderData& renderData, const std::wstring_view& needle, SearchFlag flags) const noexcept
+{
+    return _renderData == &renderData &&
+           _resultsComplete &&
+           _ok &&
+           _flags == SearchFlag::None &&
+           flags == SearchFlag::None &&
+           _lastMutationId == renderData.GetTextBuffer().GetLastMutationId() &&
+           // SearchText() doesn't return any results for all-whitespace needles, which we can't refine.
+           _needle.find_first_not_of(L' ') != std::wstring::npos &&
+           needle.size() > _needle.size() &&
+           needle.starts_with(_needle);
+}
+
+// Searches for _needle in the rows around the current _results. See _canRefine().
+std::optional<std::vector<til::point_span>> Search::_refine(const TextBuffer& textBuffer) const
+{
+    // Searching each of the ranges below has a fixed overhead. If
+    // there are too many of them, searching everything is faster.
+    static constexpr size_t maxRanges = 64;
+
+    // A match may span multiple rows. Every UTF-16 code unit of the needle occupies at most 2 columns,
+    // plus the occasional column of padding where a wide glyph didn't fit at the end of a row.
+    const auto width = std::max(1, textBuffer.GetSize().Width());
+    const auto needleColumns = gsl::narrow_cast<til::CoordType>(std::min<size_t>(_needle.size() * 2, til::CoordTypeMax / 2));
+
+    std::vector<std::pair<til::CoordType, til::CoordType>> ranges;
+    for (const auto& result : _results)
+    {
+        const auto beg = result.start.y;
+        const auto end = beg + (result.start.x + needleColumns) / width + 2;
+
+        if (!ranges.empty() && beg <= ranges.back().second)
+        {
+            ranges.back().second = std::max(ranges.back().second, end);
+            continue;
+        }
+        if (ranges.size() == maxRanges)
+        {
+            return textBuffer.SearchText(_needle, _flags);
+        }
+        ranges.emplace_back(beg, end);
+    }
+
+    std::vector<til::point_span> results;
+    for (const auto& [beg, end] : ranges)
+    {
+        auto partial = textBuffer.SearchText(_needle, _flags, beg, end);
+        if (!partial)
+        {
+            return partial;
+        }
+        results.insert(results.end(), partial->begin(), partial->end());
+    }
+    return results;
+}
@@ -37,6 +37,7 @@ public:
 
     bool IsStale(const Microsoft::Console::Render::IRenderData& renderData, const std::wstring_view& needle, SearchFlag flags) const noexcept;
     void Reset(Microsoft::Console::Render::IRenderData& renderData, const std::wstring_view& needle, SearchFlag flags, bool reverse);
+    void Adopt(Microsoft::Console::Render::IRenderData& renderData, const std::wstring_view& needle, SearchFlag flags, bool reverse, uint64_t mutationId, std::optional<std::vector<til::point_span>> results, bool complete);
 
     void MoveToPoint(til::point anchor) noexcept;
     void MovePastPoint(til::point anchor) noexcept;
@@ -51,6 +52,10 @@ public:
     bool IsOk() const noexcept;
 
 private:
+    bool _canRefine(const Microsoft::Console::Render::IRenderData& renderData, const std::wstring_view& needle, SearchFlag flags) const noexcept;
+    std::optional<std::vector<til::point_span>> _refine(const TextBuffer& textBuffer) const;
+    void _setResults(std::optional<std::vector<til::point_span>>&& results, uint64_t mutationId, bool complete, bool reverse);
+
     // _renderData is a pointer so that Search() is constexpr default constructable.
     Microsoft::Console::Render::IRenderData* _renderData = nullptr;
     std::wstring _needle;
@@ -58,6 +63,9 @@ private:
     uint64_t _lastMutationId = 0;
 
     bool _ok{ false };
+    // False if _results was moved out via ExtractResults() or only covers part of the buffer (see Adopt()).
+    // Such results can't be refined and are always stale.
+    bool _resultsComplete{ false };
     std::vector<til::point_span> _results;
     ptrdiff_t _index = 0;
     ptrdiff_t _step = 0;
@@ -52,6 +52,7 @@ TextBuffer::TextBuffer(til::size screenBufferSize,
                        const bool isActiveBuffer,
                        Microsoft::Console::Render::Renderer* renderer) :
     _renderer{ renderer },
+    _attrTable{ std::make_unique<TextAttributeTable>() },
     _currentAttributes{ defaultAttributes },
     // This way every TextBuffer will start with a ""unique"" _lastMutationId
     // and so it'll compare unequal with the counter of other TextBuffers.
@@ -105,6 +106,13 @@ void TextBuffer::_reserve(til::size screenBufferSize, const TextAttribute& defau
     const auto rowCount = ::base::strict_cast<uint64_t>(h) + 1;
     const auto allocSize = gsl::narrow<size_t>(rowCount * rowStride);
 
+    // The cold scrollback tier MEM_DECOMMITs memory in chunks of rows, which requires them to span whole pages.
+    // rowStride is a multiple of 16 and so this results in at most 256 rows per chunk. We round it up to a
+    // multiple of the commit read-ahead so that we don't compact a handful of rows at a time for wide buffers.
+    constexpr size_t pageSize = 4096;
+    auto chunkRowCount = pageSize / std::gcd(rowStride, pageSize);
+    chunkRowCount *= (_commitReadAheadRowCount + chunkRowCount - 1) / chunkRowCount;
+
     // NOTE: Modifications to this block of code might have to be mirrored over to ResizeTraditional().
     // It constructs a temporary TextBuffer and then extracts the members below, overwriting itself.
     _buffer = wil::unique_virtualalloc_ptr<std::byte>{
@@ -116,8 +124,12 @@ void TextBuffer::_reserve(til::size screenBufferSize, const TextAttribute& defau
     _bufferRowStride = rowStride;
     _bufferOffsetChars = rowSize;
     _bufferOffsetCharOffsets = rowSize + charsBufferSize;
+    _chunkRowCount = chunkRowCount;
     _width = w;
     _height = h;
+
+    _rowRevisions.assign(gsl::narrow_cast<size_t>(rowCount), _lastMutationId);
+    _blockRevisions.assign(gsl::narrow_cast<size_t>((rowCount + _revisionBlockSize - 1) / _revisionBlockSize), _lastMutationId);
 }
 
 // MEM_COMMITs the memory and constructs all ROWs up to and including the given row pointer.
@@ -139,6 +151,7 @@ __declspec(noinline) void TextBuffer::_commit(const std::byte* row)
     THROW_LAST_ERROR_IF_NULL(VirtualAlloc(_commitWatermark, size, MEM_COMMIT, PAGE_READWRITE));
 
     _construct(_commitWatermark + size);
+    _compactColdRows(row, size / _bufferRowStride);
 }
 
 // Destructs and MEM_DECOMMITs all previously constructed ROWs.
@@ -148,6 +161,83 @@ void TextBuffer::_decommit() noexcept
     _destroy();
     VirtualFree(_buffer.get(), 0, MEM_DECOMMIT);
     _commitWatermark = _buffer.get();
+    _coldChunks.clear();
+    _coldAllocations.clear();
+    if (_coldFile)
+    {
+        _coldFile->Clear();
+    }
+    _coldChunkCount = 0;
+    _lastRehydratedChunk = SIZE_MAX;
+    _markOffsets.clear();
+    _markExtentsCache.clear();
+    _markAllRowsChanged();
+}
+
+// Destructs all ROWs starting at the given offset into the memory arena and MEM_DECOMMITs their memory.
+// This is the partial counterpart to _decommit(): Just like all other uncommitted ROWs, they'll be
+// reconstructed in their initial state once they're accessed again, which makes this O(1) for
+// the common case of ROWs that don't own any heap memory, no matter how many there are.
+void TextBuffer::_decommitFrom(const size_t offset)
+{
+    const auto beg = _buffer.get() + offset * _bufferRowStride;
+    if (beg >= _commitWatermark)
+    {
+        return;
+    }
+
+    // A cold chunk which straddles `offset` still contains ROWs we need to keep.
+    if (const auto chunk = offset / _chunkRowCount; _coldChunkCount != 0 && offset % _chunkRowCount != 0 && _coldChunks[chunk])
+    {
+        _rehydrateChunk(chunk);
+    }
+
+    auto o = offset;
+    for (auto it = beg; it < _commitWatermark; it += _bufferRowStride, ++o)
+    {
+        if (_coldChunkCount != 0)
+        {
+            // Cold chunks lie entirely past `offset` and their ROWs were already destroyed when they got evicted.
+            // We can simply drop them without ever unpacking them.
+            if (const auto chunk = o / _chunkRowCount; _coldChunks[chunk])
+            {
+                _coldChunks[chunk].reset();
+                _coldChunkCount--;
+                if (const auto allocation = std::exchange(_coldAllocations[chunk], {}); allocation.data)
+                {
+                    _coldFile->Free(allocation);
+                }
+                it += (_chunkRows(chunk) - 1) * _bufferRowStride;
+                o += _chunkRows(chunk) - 1;
+                continue;
+            }
+        }
+        std::destroy_at(reinterpret_cast<ROW*>(it));
+    }
+
+    // The page containing `beg` may still contain ROWs we keep. _commit() doesn't mind MEM_COMMIT'ing it again.
+    static constexpr uintptr_t pageSize = 4096;
+    const auto pageBeg = reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(beg) + pageSize - 1) & ~(pageSize - 1));
+    if (pageBeg < _commitWatermark)
+    {
+        VirtualFree(pageBeg, gsl::narrow_cast<size_t>(_commitWatermark - pageBeg), MEM_DECOMMIT);
+    }
+    _commitWatermark = beg;
+
+    _lastMutationId++;
+    std::fill(_rowRevisions.begin() + offset, _rowRevisions.end(), _lastMutationId);
+    for (auto block = offset / _revisionBlockSize; block < _blockRevisions.size(); ++block)
+    {
+        _blockRevisions[block] = _lastMutationId;
+    }
+}
+
+// Assigns a new revision to all ROWs, for when the whole buffer got reset or replaced.
+void TextBuffer::_markAllRowsChanged() noexcept
+{
+    _lastMutationId++;
+    std::fill(_rowRevisions.begin(), _rowRevisions.end(), _lastMutationId);
+    std::fill(_blockRevisions.begin(), _blockRevisions.end(), _lastMutationId);
 }
 
 // Constructs ROWs between [_commitWatermark,until).
@@ -158,15 +248,20 @@ void TextBuffer::_construct(const std::byte* until) noexcept
         const auto row = reinterpret_cast<ROW*>(_commitWatermark);
         const auto chars = reinterpret_cast<wchar_t*>(_commitWatermark + _bufferOffsetChars);
         const auto indices = reinterpret_cast<uint16_t*>(_commitWatermark + _bufferOffsetCharOffsets);
-        std::construct_at(row, chars, indices, _width, _initialAttributes);
+        std::construct_at(row, chars, indices, _width, *_attrTable, _initialAttributes);
     }
 }
 
-// Destructs ROWs between [_buffer,_commitWatermark).
+// Destructs ROWs between [_buffer,_commitWatermark), skipping evicted chunks.
 void TextBuffer::_destroy() const noexcept
 {
-    for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride)
+    size_t offset = 0;
+    for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride, ++offset)
     {
+        if (_coldChunkCount != 0 && _coldChunks[offset / _chunkRowCount])
+        {
+            continue;
+        }
         std::destroy_at(reinterpret_cast<ROW*>(it));
     }
 }
@@ -182,12 +277,26 @@ ROW& TextBuffer::_getRowByOffsetDirect(size_t offset)
     {
         _commit(row);
     }
+    else if (_coldChunkCount != 0) [[unlikely]]
+    {
+        if (const auto chunk = offset / _chunkRowCount; _coldChunks[chunk])
+        {
+            _rehydrateChunk(chunk);
+        }
+    }
 
     return *reinterpret_cast<ROW*>(row);
 }
 
 // See GetRowByOffset().
 ROW& TextBuffer::_getRow(til::CoordType y) const
+{
+#pragma warning(suppress : 26492) // Don't use const_cast to cast away const or volatile (type.3).
+    return const_cast<TextBuffer*>(this)->_getRowByOffsetDirect(_getOffset(y));
+}
+
+// Maps a row index relative to _firstRow to the offset of the ROW in the underlying memory arena.
+size_t TextBuffer::_getOffset(til::CoordType y) const noexcept
 {
     // Rows are stored circularly, so the index you ask for is offset by the start position and mod the total of rows.
     auto offset = (_firstRow + y) % _height;
@@ -201,10 +310,281 @@ ROW& TextBuffer::_getRow(til::CoordType y) const
 
     // We add 1 to the row offset, because row "0" is the one returned by GetScratchpadRow().
     // See GetScratchpadRow() for more explanation.
-#pragma warning(suppress : 26492) // Don't use const_cast to cast away const or volatile (type.3).
-    return const_cast<TextBuffer*>(this)->_getRowByOffsetDirect(gsl::narrow_cast<size_t>(offset) + 1);
+    return gsl::narrow_cast<size_t>(offset) + 1;
+}
+
+// Returns the number of ROWs in the given chunk. The last one may be shorter than _chunkRowCount.
+size_t TextBuffer::_chunkRows(size_t chunk) const noexcept
+{
+    const auto rowCount = gsl::narrow_cast<size_t>(_height) + 1;
+    return std::min(_chunkRowCount, rowCount - chunk * _chunkRowCount);
+}
+
+// Returns the PackedRow for the given row if it's part of an evicted chunk and nullptr otherwise.
+// This allows functions that scan the entire buffer for metadata, like marks or hyperlinks, to do so
+// without rehydrating the cold scrollback.
+const PackedRow* TextBuffer::_getPackedRow(til::CoordType y) const noexcept
+{
+    if (_coldChunkCount == 0)
+    {
+        return nullptr;
+    }
+
+    const auto offset = _getOffset(y);
+    const auto& chunk = _coldChunks[offset / _chunkRowCount];
+    return chunk ? &chunk[offset % _chunkRowCount] : nullptr;
+}
+
+// Packs and MEM_DECOMMITs all chunks whose ROWs are more than _coldRowThreshold rows above the cursor.
+// `keep` is a ROW that's about to be returned to a caller and whose chunk must thus be kept alive.
+// `rowsAdvanced` is the number of rows that have come into use since the last call. It's used to limit
+// this to once every _chunkRowCount rows, because a chunk can't turn cold any faster than that.
+void TextBuffer::_compactColdRows(const std::byte* keep, size_t rowsAdvanced) noexcept
+try
+{
+    if (_coldRowThreshold <= 0)
+    {
+        return;
+    }
+    if (_rowsUntilCompaction > rowsAdvanced)
+    {
+        _rowsUntilCompaction -= rowsAdvanced;
+        return;
+    }
+    _rowsUntilCompaction = _chunkRowCount;
+
+    const auto coldLimit = _cursor.GetPosition().y - _coldRowThreshold;
+    const auto keepChunk = keep ? gsl::narrow_cast<size_t>(keep - _buffer.get()) / _bufferRowStride / _chunkRowCount : SIZE_MAX;
+    _evictChunksAbove(coldLimit, keepChunk);
+}
+CATCH_LOG()
+
+// Packs all rows above the given one into the cold scrollback tier, independent of the cold scrollback threshold.
+// This is used to shrink buffers that nobody has looked at in a while. Like any other cold row, they get rehydrated
+// once they're accessed again. Unlike _compactColdRows() this also evicts the last rehydrated chunk,
+// and so it must not be called while anyone holds on to a reference to a ROW.
+void TextBuffer::CompactRowsAbove(const til::CoordType y) noexcept
+try
+{
+    _lastRehydratedChunk = SIZE_MAX;
+    _evictChunksAbove(y, SIZE_MAX);
+}
+CATCH_LOG()
+
+// Evicts all chunks whose ROWs are all above coldLimit, except for keepChunk and _lastRehydratedChunk.
+void TextBuffer::_evictChunksAbove(const til::CoordType coldLimit, const size_t keepChunk)
+{
+    if (coldLimit <= 0)
+    {
+        return;
+    }
+
+    const auto rowCount = gsl::narrow_cast<size_t>(_height) + 1;
+    const auto chunkCount = (rowCount + _chunkRowCount - 1) / _chunkRowCount;
+    const auto committedRows = gsl::narrow_cast<size_t>(_commitWatermark - _buffer.get()) / _bufferRowStride;
+
+    if (_coldChunks.empty())
+    {
+        _coldChunks.resize(chunkCount);
+        _coldAllocations.resize(chunkCount);
+    }
+
+    // Chunk 0 contains the scratchpad row and is never evicted.
+    for (size_t chunk = 1; chunk < chunkCount; ++chunk)
+    {
+        const auto offsetBeg = chunk * _chunkRowCount;
+        const auto offsetEnd = offsetBeg + _chunkRows(chunk);
+
+        if (offsetEnd > committedRows)
+        {
+            break;
+        }
+        if (chunk == keepChunk || chunk == _lastRehydratedChunk || _coldChunks[chunk])
+        {
+            continue;
+        }
+
+        // This is the inverse of _getOffset(). If the chunk contains the wrap-around point of the circular buffer,
+        // yEnd will be less than yBeg, and since one of its rows is then the bottom-most one, it isn't cold.
+        const auto yBeg = (gsl::narrow_cast<til::CoordType>(offsetBeg) - 1 - _firstRow + _height) % _height;
+        const auto yLast = (gsl::narrow_cast<til::CoordType>(offsetEnd) - 2 - _firstRow + _height) % _height;
+        if (yBeg <= yLast && yLast < coldLimit)
+        {
+            _evictChunk(chunk);
+        }
+    }
 }
 
+void TextBuffer::_evictChunk(size_t chunk)
+{
+    const auto rows = _chunkRows(chunk);
+    const auto beg = _buffer.get() + chunk * _chunkRowCount * _bufferRowStride;
+    const auto getRow = [&](size_t i) { return reinterpret_cast<ROW*>(beg + i * _bufferRowStride); };
+
+    auto packed = std::make_unique<PackedRow[]>(_chunkRowCount);
+    size_t i = 0;
+
+    try
+    {
+        for (; i < rows; ++i)
+        {
+            packed[i] = getRow(i)->Pack();
+        }
+    }
+    catch (...)
+    {
+        // ROW::Pack() only modifies the ROW once it can't fail anymore, which allows us to undo this.
+        for (size_t j = 0; j < i; ++j)
+        {
+            getRow(j)->Unpack(std::move(packed[j]));
+        }
+        throw;
+    }
+
+    if (_coldFileBacked)
+    {
+        try
+        {
+            _spillChunk(chunk, packed.get(), rows);
+        }
+        CATCH_LOG();
+    }
+
+    for (i = 0; i < rows; ++i)
+    {
+        std::destroy_at(getRow(i));
+    }
+
+    VirtualFree(beg, rows * _bufferRowStride, MEM_DECOMMIT);
+    _coldChunks[chunk] = std::move(packed);
+    _coldChunkCount++;
+}
+
+// Moves the text of the given packed rows from the heap into a single allocation in _coldFile.
+// If this fails, the rows simply keep their heap allocations.
+void TextBuffer::_spillChunk(const size_t chunk, PackedRow* packed, const size_t rows)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < rows; ++i)
+    {
+        size += packed[i].DataSize();
+    }
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (!_coldFile)
+    {
+        _coldFile = std::make_unique<ColdScrollbackFile>();
+    }
+
+    const auto allocation = _coldFile->Allocate(size);
+    auto dst = allocation.data;
+
+    for (size_t i = 0; i < rows; ++i)
+    {
+        auto& row = packed[i];
+        if (const auto rowSize = row.DataSize())
+        {
+            memcpy(dst, row.data.get(), rowSize);
+            row.mappedData = dst;
+            row.data.reset();
+            dst += rowSize;
+        }
+    }
+
+    _coldAllocations[chunk] = allocation;
+}
+
+// The counterpart to _evictChunk(). Just like _commit() it's marked as noinline
+// to allow _getRowByOffsetDirect() to be inlined.
+__declspec(noinline) void TextBuffer::_rehydrateChunk(size_t chunk)
+{
+    const auto rows = _chunkRows(chunk);
+    const auto beg = _buffer.get() + chunk * _chunkRowCount * _bufferRowStride;
+
+    THROW_LAST_ERROR_IF_NULL(VirtualAlloc(beg, rows * _bufferRowStride, MEM_COMMIT, PAGE_READWRITE));
+
+    // Even if unpacking fails, the chunk will consist of valid (but blank) ROWs from here on.
+    auto packed = std::move(_coldChunks[chunk]);
+    _coldChunkCount--;
+    _lastRehydratedChunk = chunk;
+
+    // The mapped text is only needed until it's been unpacked.
+    const auto freeAllocation = wil::scope_exit([&]() noexcept {
+        if (const auto allocation = std::exchange(_coldAllocations[chunk], {}); allocation.data)
+        {
+            _coldFile->Free(allocation);
+        }
+    });
+
+    for (size_t i = 0; i < rows; ++i)
+    {
+        const auto it = beg + i * _bufferRowStride;
+        const auto row = reinterpret_cast<ROW*>(it);
+        const auto chars = reinterpret_cast<wchar_t*>(it + _bufferOffsetChars);
+        const auto indices = reinterpret_cast<uint16_t*>(it + _bufferOffsetCharOffsets);
+        std::construct_at(row, chars, indices, _width, *_attrTable, _initialAttributes);
+    }
+
+    for (size_t i = 0; i < rows; ++i)
+    {
+        reinterpret_cast<ROW*>(beg + i * _bufferRowStride)->Unpack(std::move(packed[i]));
+    }
+}
+
+// Releases the TextAttributeTable entries that aren't referenced by any ROW anymore, once the table has grown
+// sufficiently since the last time. This must only be called while no one holds on to ids outside of a ROW.
+// The same goes for hyperlinks, whose ids are only ever stored in the TextAttributes found in the table.
+void TextBuffer::_sweepAttributes() noexcept
+try
+{
+    if (!_attrTable->WantsSweep() && !_hyperlinks.WantsSweep())
+    {
+        return;
+    }
+
+    std::vector<bool> used(_attrTable->Capacity());
+    const auto mark = [&](const TextAttributeTable::Runs& attr) {
+        for (const auto& run : attr.runs())
+        {
+            used[run.value] = true;
+        }
+    };
+
+    // This includes the scratchpad row at offset 0.
+    const auto committedRows = gsl::narrow_cast<size_t>(_commitWatermark - _buffer.get()) / _bufferRowStride;
+    for (size_t offset = 0; offset < committedRows; ++offset)
+    {
+        if (_coldChunkCount != 0)
+        {
+            if (const auto& chunk = _coldChunks[offset / _chunkRowCount])
+            {
+                mark(chunk[offset % _chunkRowCount].attr);
+                continue;
+            }
+        }
+        mark(reinterpret_cast<const ROW*>(_buffer.get() + offset * _bufferRowStride)->Attributes());
+    }
+
+    std::vector<bool> usedHyperlinks(HyperlinkTable::IdCount);
+    for (TextAttributeTable::Id id = 0; id < used.size(); ++id)
+    {
+        if (used[id])
+        {
+            if (const auto& attr = _attrTable->Get(id); attr.IsHyperlink())
+            {
+                usedHyperlinks[attr.GetHyperlinkId()] = true;
+            }
+        }
+    }
+
+    _attrTable->Sweep(used);
+    _hyperlinks.Sweep(usedHyperlinks);
+}
+CATCH_LOG()
+
 // Returns the "user-visible" index of the last committed row, which can be used
 // to short-circuit some algorithms that try to scan the entire buffer.
 // Returns 0 if no rows are committed in.
@@ -229,8 +609,12 @@ const ROW& TextBuffer::GetRowByOffset(const til::CoordType index) const
 // (what corresponds to the top row of the screen buffer).
 ROW& TextBuffer::GetMutableRowByOffset(const til::CoordType index)
 {
-    _lastMutationId++;
-    return _getRow(index);
+    const auto offset = _getOffset(index);
+    auto& row = _getRowByOffsetDirect(offset);
+    const auto revision = ++_lastMutationId;
+    til::at(_rowRevisions, offset) = revision;
+    til::at(_blockRevisions, offset / _revisionBlockSize) = revision;
+    return row;
 }
 
 // Returns a row filled with whitespace and the current attributes, for you to freely use.
@@ -263,6 +647,9 @@ ROW& TextBuffer::GetScratchpadRow(const TextAttribute& attributes)
 void TextBuffer::CopyProperties(const TextBuffer& OtherBuffer) noexcept
 {
     GetCursor().CopyProperties(OtherBuffer.GetCursor());
+    _coldRowThreshold = OtherBuffer._coldRowThreshold;
+    _coldFileBacked = OtherBuffer._coldFileBacked;
+    _retainedRowsBudget = OtherBuffer._retainedRowsBudget;
 }
 
 // Routine Description:
@@ -276,6 +663,146 @@ til::CoordType TextBuffer::TotalRowCount() const noexcept
     return _height;
 }
 
+// Returns how much of the ROW arena is currently committed. See _commitWatermark.
+// This doesn't include the cold scrollback tier or any other heap allocations.
+size_t TextBuffer::GetCommittedBytes() const noexcept
+{
+    return gsl::narrow_cast<size_t>(_commitWatermark - _buffer.get());
+}
+
+// Enables the cold scrollback tier: Rows that are more than `rows` rows above the cursor will be stored
+// in a compressed form until they're accessed again. A value of 0 or less disables it. See _coldChunks.
+void TextBuffer::SetColdScrollbackThreshold(const til::CoordType rows) noexcept
+{
+    _coldRowThreshold = std::max(0, rows);
+}
+
+til::CoordType TextBuffer::GetColdScrollbackThreshold() const noexcept
+{
+    return _coldRowThreshold;
+}
+
+// If enabled, the cold scrollback tier stores its text in a memory-mapped temporary file instead of the heap,
+// so that it doesn't consume private memory. This only affects chunks that are evicted from here on.
+void TextBuffer::SetColdScrollbackFileBacked(const bool enabled) noexcept
+{
+    _coldFileBacked = enabled;
+}
+
+bool TextBuffer::IsColdScrollbackFileBacked() const noexcept
+{
+    return _coldFileBacked;
+}
+
+// Enables retaining the text of failed commands and bookmarked output that scrolled out of the buffer,
+// up to the given number of bytes. See _retainedRows. 0 disables it and releases what was retained so far.
+void TextBuffer::SetRetainedScrollbackSize(const size_t bytes) noexcept
+{
+    _retainedRowsBudget = bytes;
+
+    while (_retainedRowsSize > _retainedRowsBudget)
+    {
+        _retainedRowsSize -= _retainedRows.front().Size();
+        _retainedRows.pop_front();
+    }
+    if (!_retainedRowsBudget)
+    {
+        _retainingRows = false;
+    }
+}
+
+size_t TextBuffer::GetRetainedScrollbackSize() const noexcept
+{
+    return _retainedRowsBudget;
+}
+
+// Returns the retained rows (see _retainedRows) as text, oldest first, with rows separated by CRLF unless they wrapped.
+// A run of identical rows is returned once, followed by a line that says how often it was repeated.
+std::wstring TextBuffer::GetRetainedScrollbackText() const
+{
+    std::wstring text;
+
+    for (const auto& row : _retainedRows)
+    {
+        const auto& packed = row.text;
+        const auto data = packed.Data();
+        const size_t offsetsSize = packed.explicitOffsets ? packed.columnEnd * sizeof(uint16_t) : 0;
+
+        if (packed.narrowChars)
+        {
+            const auto beg = data + offsetsSize;
+            std::transform(beg, beg + packed.charsEnd, std::back_inserter(text), [](std::byte ch) { return static_cast<wchar_t>(ch); });
+        }
+        else if (packed.charsEnd)
+        {
+            const auto beg = text.size();
+            text.resize(beg + packed.charsEnd);
+            memcpy(text.data() + beg, data + offsetsSize, packed.charsEnd * sizeof(wchar_t));
+        }
+
+        if (row.repeats)
+        {
+            fmt::format_to(std::back_inserter(text), FMT_COMPILE(L"\r\n[repeated {} more times]\r\n"), row.repeats);
+        }
+        else if (!packed.wrapForced)
+        {
+            text.append(L"\r\n");
+        }
+    }
+
+    return text;
+}
+
+// Called by IncrementCircularBuffer() before `row` gets recycled. See _retainedRows.
+void TextBuffer::_retainRow(const ROW& row)
+{
+    // A prompt decides whether the command after it gets retained. Its category only changes to Error once the command
+    // finished, so a command whose prompt scrolls out while it's still running isn't retained. A bookmark always is.
+    if (const auto& data = row.GetScrollbarData())
+    {
+        // Any mark other than a Default one came from shell integration. See GetMarkExtents().
+        _retainingRows = data->category == MarkCategory::Default || data->category == MarkCategory::Error || data->exitCode.value_or(0) != 0;
+    }
+
+    if (!_retainingRows)
+    {
+        return;
+    }
+
+    auto packed = row.PackText();
+    const auto size = packed.DataSize();
+
+    // Blank rows aren't collapsed, because "[repeated 3 more times]" is longer than just 3 blank lines.
+    if (size && !_retainedRows.empty())
+    {
+        auto& last = _retainedRows.back();
+        if (last.text.charsEnd == packed.charsEnd && last.text.columnEnd == packed.columnEnd &&
+            last.text.narrowChars == packed.narrowChars && last.text.explicitOffsets == packed.explicitOffsets &&
+            last.text.wrapForced == packed.wrapForced && memcmp(last.text.Data(), packed.Data(), size) == 0)
+        {
+            last.repeats++;
+            return;
+        }
+    }
+
+    // A single row doesn't fit into the budget. Retaining it would only evict everything else.
+    RetainedRow retained{ std::move(packed) };
+    const auto cost = retained.Size();
+    if (cost > _retainedRowsBudget)
+    {
+        return;
+    }
+
+    while (_retainedRowsSize + cost > _retainedRowsBudget)
+    {
+        _retainedRowsSize -= _retainedRows.front().Size();
+        _retainedRows.pop_front();
+    }
+
+    _retainedRows.push_back(std::move(retained));
+    _retainedRowsSize += cost;
+}
+
 // Method Description:
 // - Gets the number of glyphs in the buffer between two points.
 // - IMPORTANT: Make sure that start is before end, or this will never return!
@@ -417,9 +944,7 @@ size_t TextBuffer::FitTextIntoColumns(const std::wstring_view& chars, til::Coord
     const auto asciiEnd = beg + std::min(chars.size(), gsl::narrow_cast<size_t>(columnLimit));
 
     // ASCII fast-path: 1 char always corresponds to 1 column.
-    for (; it != asciiEnd && *it < 0x80; ++it)
-    {
-    }
+    it += CodepointWidthDetector::AsciiPrefixLength({ beg, asciiEnd });
 
     auto dist = gsl::narrow_cast<size_t>(it - beg);
     auto col = gsl::narrow_cast<til::CoordType>(dist);
@@ -526,6 +1051,8 @@ til::point TextBuffer::NavigateCursor(til::point position, til::CoordType distan
 // You can continue calling the function on the same row as long as state.columnEnd < state.columnLimit.
 void TextBuffer::Replace(til::CoordType row, const TextAttribute& attributes, RowWriteState& state)
 {
+    _sweepAttributes();
+
     auto& r = GetMutableRowByOffset(row);
     r.ReplaceText(state);
     r.ReplaceAttributes(state.columnBegin, state.columnEnd, attributes);
@@ -535,6 +1062,8 @@ void TextBuffer::Replace(til::CoordType row, const TextAttribute& attributes, Ro
 
 void TextBuffer::Insert(til::CoordType row, const TextAttribute& attributes, RowWriteState& state)
 {
+    _sweepAttributes();
+
     auto& r = GetMutableRowByOffset(row);
     auto& scratch = GetScratchpadRow();
 
@@ -567,6 +1096,120 @@ void TextBuffer::Insert(til::CoordType row, const TextAttribute& attributes, Row
     TriggerRedraw(Viewport::FromExclusive({ state.columnBeginDirty, row, restoreState.columnEndDirty, row + 1 }));
 }
 
+// Writes a single row of CHAR_INFOs, like WriteLine(OutputCellIterator{ infos }, target) does, but without
+// going through OutputCellIterator cell by cell. The text is written in one go and the attributes are
+// replaced once per run of identical attributes. This is what makes repainting the entire screen with
+// WriteConsoleOutputW cheap. It doesn't support wide glyphs: If any of the infos has
+// COMMON_LVB_LEADING_BYTE or COMMON_LVB_TRAILING_BYTE set, it returns false without writing anything.
+bool TextBuffer::TryWriteCharInfos(const til::point target, const std::span<const CHAR_INFO> infos)
+{
+    if (infos.empty() || !GetSize().IsInBounds(target))
+    {
+        return false;
+    }
+
+    auto& r = GetMutableRowByOffset(target.y);
+    const auto count = std::min<size_t>(infos.size(), gsl::narrow_cast<size_t>(r.size() - target.x));
+    const auto cells = infos.first(count);
+
+    _narrowText.resize(count);
+    auto text = _narrowText.begin();
+    for (const auto& ci : cells)
+    {
+        if (WI_IsAnyFlagSet(ci.Attributes, COMMON_LVB_LEADING_BYTE | COMMON_LVB_TRAILING_BYTE))
+        {
+            return false;
+        }
+        *text++ = ci.Char.UnicodeChar;
+    }
+
+    RowWriteState state{
+        .text = _narrowText,
+        .columnBegin = target.x,
+        .columnLimit = target.x + gsl::narrow_cast<til::CoordType>(count),
+    };
+    r.ReplaceNarrowText(state);
+
+    for (size_t beg = 0; beg < count;)
+    {
+        const auto attributes = til::at(cells, beg).Attributes;
+        auto end = beg + 1;
+        while (end < count && til::at(cells, end).Attributes == attributes)
+        {
+            ++end;
+        }
+        r.ReplaceAttributes(target.x + gsl::narrow_cast<til::CoordType>(beg), target.x + gsl::narrow_cast<til::CoordType>(end), TextAttribute{ attributes });
+        beg = end;
+    }
+
+    TriggerRedraw(Viewport::FromExclusive({ state.columnBeginDirty, target.y, state.columnEndDirty, target.y + 1 }));
+    return true;
+}
+
+// Calls func(row, y, columnBegin, columnEnd) for each row segment covered by `count` cells, starting at
+// `target` and continuing at the start of the following rows, the same way Write() walks the buffer.
+// Returns the number of cells covered, which is less than `count` if the end of the buffer was reached.
+template<typename Func>
+til::CoordType TextBuffer::_forEachSpanFrom(const til::point target, const size_t count, Func&& func)
+{
+    const auto size = GetSize();
+    if (!size.IsInBounds(target))
+    {
+        return 0;
+    }
+
+    const auto width = size.Width();
+    auto remaining = count;
+    auto x = target.x;
+
+    for (auto y = target.y; y < size.Height() && remaining != 0; ++y)
+    {
+        const auto end = x + gsl::narrow_cast<til::CoordType>(std::min<size_t>(remaining, gsl::narrow_cast<size_t>(width - x)));
+        func(GetMutableRowByOffset(y), y, x, end);
+        remaining -= gsl::narrow_cast<size_t>(end - x);
+        x = 0;
+    }
+
+    return gsl::narrow_cast<til::CoordType>(count - remaining);
+}
+
+// Same as Write(OutputCellIterator{ fill, count }, target, false), but it writes entire row segments at once,
+// instead of going through OutputCellIterator cell by cell. This is what FillConsoleOutputCharacter uses,
+// which applications like to call for the entire buffer to clear it. The attributes are left untouched.
+// `fill` must be a narrow character (see IsGlyphFullWidth()), as it's stored in a column of its own.
+til::CoordType TextBuffer::FillNarrowText(const til::point target, const wchar_t fill, const size_t count)
+{
+    // All rows get the same text, so we only need to create it once.
+    _narrowText.assign(gsl::narrow_cast<size_t>(_width), fill);
+
+    return _forEachSpanFrom(target, count, [&](ROW& r, til::CoordType y, til::CoordType beg, til::CoordType end) {
+        RowWriteState state{
+            .text = _narrowText,
+            .columnBegin = beg,
+            .columnLimit = end,
+        };
+        r.ReplaceNarrowText(state);
+        // Just like WriteCells(), because the wrap parameter is false.
+        if (end == _width)
+        {
+            r.SetWrapForced(false);
+        }
+        TriggerRedraw(Viewport::FromExclusive({ state.columnBeginDirty, y, state.columnEndDirty, y + 1 }));
+    });
+}
+
+// Same as Write(OutputCellIterator{ attributes, count }, target, false), but it replaces the attributes of each row
+// segment as a single run, instead of going through OutputCellIterator cell by cell. The text is left untouched.
+til::CoordType TextBuffer::FillAttributes(const til::point target, const TextAttribute& attributes, const size_t count)
+{
+    _sweepAttributes();
+
+    return _forEachSpanFrom(target, count, [&](ROW& r, til::CoordType y, til::CoordType beg, til::CoordType end) {
+        r.ReplaceAttributes(beg, end, attributes);
+        TriggerRedraw(Viewport::FromExclusive({ beg, y, end, y + 1 }));
+    });
+}
+
 // Fills an area of the buffer with a given fill character(s) and attributes.
 void TextBuffer::FillRect(const til::rect& rect, const std::wstring_view& fill, const TextAttribute& attributes)
 {
@@ -575,6 +1218,8 @@ void TextBuffer::FillRect(const til::rect& rect, const std::wstring_view& fill,
         return;
     }
 
+    _sweepAttributes();
+
     auto& scratchpad = GetScratchpadRow(attributes);
 
     // The scratchpad row gets reset to whitespace by default, so there's no need to
@@ -715,11 +1360,20 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
 // - true if we successfully incremented the buffer.
 void TextBuffer::IncrementCircularBuffer(const TextAttribute& fillAttributes)
 {
-    // Prune hyperlinks to delete obsolete references
-    _PruneHyperlinks();
+    auto& firstRow = GetMutableRowByOffset(0);
+    if (_retainedRowsBudget)
+    {
+        try
+        {
+            _retainRow(firstRow);
+        }
+        CATCH_LOG();
+    }
 
-    // Second, clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
-    GetMutableRowByOffset(0).Reset(fillAttributes);
+    // Clean out the old "first row" as it will become the "last row" of the buffer after the circle is performed.
+    firstRow.Reset(fillAttributes);
+    // Sweeping after the reset allows the attributes and hyperlinks that were only used by that row to be released.
+    _sweepAttributes();
     {
         // Now proceed to increment.
         // Incrementing it will cause the next line down to become the new "top" of the window (the new "0" in logical coordinates)
@@ -731,6 +1385,8 @@ void TextBuffer::IncrementCircularBuffer(const TextAttribute& fillAttributes)
             _firstRow = 0;
         }
     }
+
+    _compactColdRows(nullptr, 1);
 }
 
 //Routine Description:
@@ -869,6 +1525,80 @@ void TextBuffer::CopyRow(const til::CoordType srcRowIndex, const til::CoordType
     ImageSlice::CopyRow(srcRow, dstRow);
 }
 
+// Copies the text and attributes in srcRect to the area of the same size at dstOrigin in dstBuffer,
+// which may be this buffer, one row segment at a time. Both areas must lie within their buffers.
+// Image content is not copied. Use ImageSlice::CopyBlock() for that.
+//
+// Returns false without modifying anything if any of the rows isn't single-width or if the area cuts through
+// a wide glyph in the source. The caller then needs to fall back to copying the cells one by one, because
+// those cases need the per-cell clipping and DBCS fixups that WriteLine() does.
+bool TextBuffer::CopyRect(const til::rect& srcRect, const til::point dstOrigin, TextBuffer& dstBuffer) const
+{
+    const auto width = srcRect.width();
+    const auto height = srcRect.height();
+    if (width <= 0 || height <= 0)
+    {
+        return true;
+    }
+
+    const auto dstRect = til::rect{ dstOrigin, til::size{ width, height } };
+
+    for (auto i = 0; i < height; ++i)
+    {
+        const auto& srcRow = GetRowByOffset(srcRect.top + i);
+        if (srcRow.GetLineRendition() != LineRendition::SingleWidth ||
+            dstBuffer.GetLineRendition(dstRect.top + i) != LineRendition::SingleWidth ||
+            srcRow.DbcsAttrAt(srcRect.left) == DbcsAttribute::Trailing ||
+            srcRow.DbcsAttrAt(srcRect.right - 1) == DbcsAttribute::Leading)
+        {
+            return false;
+        }
+    }
+
+    dstBuffer._sweepAttributes();
+
+    const auto sameBuffer = &dstBuffer == this;
+    // If the destination overlaps the source further down, we need to go bottom-up,
+    // so that we don't overwrite source rows before we had a chance to copy them.
+    const auto bottomUp = sameBuffer && dstRect.top > srcRect.top;
+    const auto left = gsl::narrow_cast<uint16_t>(srcRect.left);
+    const auto right = gsl::narrow_cast<uint16_t>(srcRect.right);
+
+    for (auto n = 0; n < height; ++n)
+    {
+        const auto i = bottomUp ? height - 1 - n : n;
+        const auto dstY = dstRect.top + i;
+        const auto* srcRow = &GetRowByOffset(srcRect.top + i);
+
+        // ROW::CopyTextFrom() can't copy a row onto itself,
+        // so horizontal moves within a row go through the scratchpad.
+        if (sameBuffer && srcRect.top == dstRect.top)
+        {
+            auto& scratchpad = dstBuffer.GetScratchpadRow();
+            scratchpad.CopyFrom(*srcRow);
+            srcRow = &scratchpad;
+        }
+
+        auto& dstRow = dstBuffer.GetMutableRowByOffset(dstY);
+
+        RowCopyTextFromState state{
+            .source = *srcRow,
+            .columnBegin = dstRect.left,
+            .columnLimit = dstRect.right,
+            .sourceColumnBegin = srcRect.left,
+            .sourceColumnLimit = srcRect.right,
+        };
+        dstRow.CopyTextFrom(state);
+
+        const auto attributes = srcRow->SliceAttributes(left, right, dstRow.GetAttributeTable());
+        dstRow.Attributes().replace(gsl::narrow_cast<uint16_t>(dstRect.left), gsl::narrow_cast<uint16_t>(dstRect.right), attributes);
+
+        dstBuffer.TriggerRedraw(Viewport::FromExclusive({ state.columnBeginDirty, dstY, state.columnEndDirty, dstY + 1 }));
+    }
+
+    return true;
+}
+
 Cursor& TextBuffer::GetCursor() noexcept
 {
     return _cursor;
@@ -884,6 +1614,75 @@ uint64_t TextBuffer::GetLastMutationId() const noexcept
     return _lastMutationId;
 }
 
+// Returns the value GetLastMutationId() had when the given row was last modified.
+// (Or rather, when it was last retrieved via GetMutableRowByOffset().)
+uint64_t TextBuffer::GetRowRevision(const til::CoordType y) const noexcept
+{
+    return til::at(_rowRevisions, _getOffset(y));
+}
+
+// Returns ROW::ContentHash() of the given row. Unlike GetRowRevision(), which changes whenever a row *may* have
+// been modified, this only changes if its visible contents did. Callers that need to know whether a row changed
+// since they last looked at it can check its revision first and only fall back to hashing it if that differs.
+size_t TextBuffer::GetRowContentHash(const til::CoordType y) const
+{
+    return GetRowByOffset(y).ContentHash();
+}
+
+// Routine Description:
+// - Returns all rows that were modified after the given revision, which is usually a
+//   value previously returned by GetLastMutationId(). Adjacent rows are merged into a single range.
+// - Rows are identified the same way as in GetRowByOffset(). IncrementCircularBuffer() shifts all rows up by one
+//   while only marking the recycled row as changed, so callers that cache per-row data by index need to check
+//   GetFirstRowIndex() as well. Resizing or resetting the buffer marks all rows as changed.
+// Arguments:
+// - revision - Rows with a revision greater than this one are returned.
+// Return Value:
+// - The changed rows in ascending order.
+std::vector<TextBuffer::RowRange> TextBuffer::GetRowsChangedSince(const uint64_t revision) const
+{
+    std::vector<RowRange> ranges;
+
+    if (revision >= _lastMutationId)
+    {
+        return ranges;
+    }
+
+    const auto height = gsl::narrow_cast<til::CoordType>(_height);
+    const auto offsetEnd = _rowRevisions.size();
+
+    for (til::CoordType y = 0; y < height;)
+    {
+        const auto offset = _getOffset(y);
+        const auto block = offset / _revisionBlockSize;
+
+        // The offsets within a block map to consecutive y coordinates, because the circular buffer
+        // only wraps around after the last offset. This lets us skip the rest of unchanged blocks.
+        if (til::at(_blockRevisions, block) <= revision)
+        {
+            const auto blockEnd = std::min((block + 1) * _revisionBlockSize, offsetEnd);
+            y += gsl::narrow_cast<til::CoordType>(blockEnd - offset);
+            continue;
+        }
+
+        if (til::at(_rowRevisions, offset) > revision)
+        {
+            if (!ranges.empty() && ranges.back().end == y)
+            {
+                ranges.back().end = y + 1;
+            }
+            else
+            {
+                ranges.push_back({ y, y + 1 });
+            }
+        }
+
+        ++y;
+    }
+
+    return ranges;
+}
+
 const TextAttribute& TextBuffer::GetCurrentAttributes() const noexcept
 {
     return _currentAttributes;
@@ -977,6 +1776,44 @@ void TextBuffer::Reset() noexcept
     _initialAttributes = _currentAttributes;
 }
 
+// Routine Description:
+// - Puts the buffer into the same state as a newly constructed one with the given attributes and
+//   cursor size. Unlike Reset(), this clears the ROWs that are already committed in place, so
+//   that a recycled alternate screen buffer doesn't have to commit (and zero) its memory again.
+void TextBuffer::Recycle(const TextAttribute& defaultAttributes, const UINT cursorSize) noexcept
+{
+    _currentAttributes = defaultAttributes;
+    _initialAttributes = defaultAttributes;
+
+    if (_coldChunkCount != 0)
+    {
+        // Evicted ROWs aren't constructed. It's not worth rehydrating them just to clear them.
+        _decommit();
+    }
+    else
+    {
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+        for (auto it = _buffer.get(); it < _commitWatermark; it += _bufferRowStride)
+        {
+            reinterpret_cast<ROW*>(it)->Reset(defaultAttributes);
+        }
+#pragma warning(pop)
+        _markOffsets.clear();
+        _markExtentsCache.clear();
+        _markAllRowsChanged();
+    }
+
+    _firstRow = 0;
+
+    const Cursor initialCursor{ cursorSize, *this };
+    _cursor.CopyProperties(initialCursor);
+    _cursor.SetSize(cursorSize);
+    _cursor.ResetDelayEOLWrap();
+    _cursor.SetPosition({});
+}
+
 // Arguments:
 // - newFirstRow: The current y-position of the viewport. We'll clear up until here.
 // - rowsToKeep: the number of rows to keep in the buffer.
@@ -1006,10 +1843,11 @@ void TextBuffer::ClearScrollback(const til::CoordType newFirstRow, const til::Co
     _firstRow = 0;
     ScrollRows(startAbsolute, rowsToKeep, -startAbsolute);
 
-    const auto end = _estimateOffsetOfLastCommittedRow();
-    for (auto y = rowsToKeep; y <= end; ++y)
+    // Instead of resetting the remaining rows one by one (and rehydrating the cold ones just to do so),
+    // we throw them away. Since _firstRow is 0, the arena offset of row y is simply y + 1.
+    if (rowsToKeep < _height)
     {
-        GetMutableRowByOffset(y).Reset(_initialAttributes);
+        _decommitFrom(gsl::narrow_cast<size_t>(rowsToKeep) + 1);
     }
 }
 
@@ -1049,8 +1887,25 @@ void TextBuffer::ResizeTraditional(til::size newSize)
     _bufferRowStride = newBuffer._bufferRowStride;
     _bufferOffsetChars = newBuffer._bufferOffsetChars;
     _bufferOffsetCharOffsets = newBuffer._bufferOffsetCharOffsets;
+    _attrTable = std::move(newBuffer._attrTable);
+    _coldChunks = std::move(newBuffer._coldChunks);
+    _coldAllocations = std::move(newBuffer._coldAllocations);
+    if (_coldFile)
+    {
+        _coldFile->Clear();
+    }
+    _coldChunkCount = std::exchange(newBuffer._coldChunkCount, 0);
+    _chunkRowCount = newBuffer._chunkRowCount;
+    _rowsUntilCompaction = 0;
+    _lastRehydratedChunk = SIZE_MAX;
     _width = newBuffer._width;
     _height = newBuffer._height;
+    _rowRevisions = std::move(newBuffer._rowRevisions);
+    _blockRevisions = std::move(newBuffer._blockRevisions);
+    // CopyRow() doesn't carry over the ScrollbarData, so all of the marks are gone now.
+    _markOffsets.clear();
+    _markExtentsCache.clear();
+    _markAllRowsChanged();
 
     _SetFirstRowIndex(0);
 }
@@ -1080,6 +1935,12 @@ void TextBuffer::NotifyPaintFrame() noexcept
 
 void TextBuffer::TriggerRedraw(const Viewport& viewport)
 {
+    if (_redrawBatchDepth)
+    {
+        _batchedRedraw |= viewport.ToExclusive();
+        return;
+    }
+
     if (_isActiveBuffer && _renderer)
     {
         _renderer->TriggerRedraw(viewport);
@@ -1088,6 +1949,11 @@ void TextBuffer::TriggerRedraw(const Viewport& viewport)
 
 void TextBuffer::TriggerRedrawAll()
 {
+    if (_redrawBatchDepth)
+    {
+        _FlushRedrawBatch();
+    }
+
     if (_isActiveBuffer && _renderer)
     {
         _renderer->TriggerRedrawAll();
@@ -1096,6 +1962,11 @@ void TextBuffer::TriggerRedrawAll()
 
 void TextBuffer::TriggerScroll()
 {
+    if (_redrawBatchDepth)
+    {
+        _FlushRedrawBatch();
+    }
+
     if (_isActiveBuffer && _renderer)
     {
         _renderer->TriggerScroll();
@@ -1104,12 +1975,61 @@ void TextBuffer::TriggerScroll()
 
 void TextBuffer::TriggerScroll(const til::point delta)
 {
+    if (_redrawBatchDepth)
+    {
+        // The pending redraw region is in buffer coordinates and must move along with the contents.
+        // Whatever gets scrolled out of the buffer doesn't need to be redrawn anymore.
+        _batchedScroll += delta;
+        _batchedRedraw = (_batchedRedraw + delta) & GetSize().ToExclusive();
+        return;
+    }
+
     if (_isActiveBuffer && _renderer)
     {
         _renderer->TriggerScroll(&delta);
     }
 }
 
+// Starts deferring calls to TriggerRedraw() and TriggerScroll(delta) until the matching
+// EndRedrawBatch() call. They'll then be sent to the renderer as a single scroll followed by a single
+// redraw of the union of all dirty regions. This is meant for callers that modify a lot of consecutive
+// rows, like when a long string gets written and wraps across many (scrolling) lines.
+// Calls may be nested.
+void TextBuffer::StartRedrawBatch() noexcept
+{
+    _redrawBatchDepth++;
+}
+
+void TextBuffer::EndRedrawBatch() noexcept
+try
+{
+    assert(_redrawBatchDepth != 0);
+    if (--_redrawBatchDepth == 0)
+    {
+        _FlushRedrawBatch();
+    }
+}
+CATCH_LOG()
+
+void TextBuffer::_FlushRedrawBatch()
+{
+    const auto scroll = std::exchange(_batchedScroll, til::point{});
+    const auto redraw = std::exchange(_batchedRedraw, til::rect{});
+
+    if (_isActiveBuffer && _renderer)
+    {
+        // The scroll must come first, as it moves the regions that were invalidated before the batch started.
+        if (scroll != til::point{})
+        {
+            _renderer->TriggerScroll(&scroll);
+        }
+        if (redraw)
+        {
+            _renderer->TriggerRedraw(Viewport::FromExclusive(redraw));
+        }
+    }
+}
+
 void TextBuffer::TriggerNewTextNotification(const std::wstring_view newText)
 {
     if (_isActiveBuffer && _renderer)
@@ -1126,7 +2046,7 @@ void TextBuffer::TriggerNewTextNotification(const std::wstring_view newText)
 // - wordDelimiters: the delimiters defined as a part of the DelimiterClass::DelimiterChar
 // Return Value:
 // - the delimiter class for the given char
-DelimiterClass TextBuffer::_GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const
+DelimiterClass TextBuffer::_GetDelimiterClassAt(const til::point pos, const DelimiterSet& wordDelimiters) const
 {
     const auto realPos = ScreenToBufferPosition(pos);
     return GetRowByOffset(realPos.y).DelimiterClassAt(realPos.x, wordDelimiters);
@@ -1176,13 +2096,14 @@ til::point TextBuffer::GetWordStart(const til::point target, const std::wstring_
         copy = limitOptional.value_or(bufferSize.BottomRightInclusive());
     }
 
+    const DelimiterSet delimiters{ wordDelimiters };
     if (accessibilityMode)
     {
-        return _GetWordStartForAccessibility(copy, wordDelimiters);
+        return _GetWordStartForAccessibility(copy, delimiters);
     }
     else
     {
-        return _GetWordStartForSelection(copy, wordDelimiters);
+        return _GetWordStartForSelection(copy, delimiters);
     }
 }
 
@@ -1193,7 +2114,7 @@ til::point TextBuffer::GetWordStart(const til::point target, const std::wstring_
 // - wordDelimiters - what characters are we considering for the separation of words
 // Return Value:
 // - The til::point for the first character on the current/previous READABLE "word" (inclusive)
-til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, const std::wstring_view wordDelimiters) const
+til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, const DelimiterSet& wordDelimiters) const
 {
     auto result = target;
     const auto bufferSize = GetSize();
@@ -1234,7 +2155,7 @@ til::point TextBuffer::_GetWordStartForAccessibility(const til::point target, co
 // - wordDelimiters - what characters are we considering for the separation of words
 // Return Value:
 // - The til::point for the first character on the current word or delimiter run (stopped by the left margin)
-til::point TextBuffer::_GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const
+til::point TextBuffer::_GetWordStartForSelection(const til::point target, const DelimiterSet& wordDelimiters) const
 {
     auto result = target;
     const auto bufferSize = GetSize();
@@ -1306,13 +2227,14 @@ til::point TextBuffer::GetWordEnd(const til::point target, const std::wstring_vi
         return target;
     }
 
+    const DelimiterSet delimiters{ wordDelimiters };
     if (accessibilityMode)
     {
-        return _GetWordEndForAccessibility(target, wordDelimiters, limit);
+        return _GetWordEndForAccessibility(target, delimiters, limit);
     }
     else
     {
-        return _GetWordEndForSelection(target, wordDelimiters);
+        return _GetWordEndForSelection(target, delimiters);
     }
 }
 
@@ -1324,7 +2246,7 @@ til::point TextBuffer::GetWordEnd(const til::point target, const std::wstring_vi
 // - limit - the last "valid" position in the text buffer (to improve performance)
 // Return Value:
 // - The til::point for the first character of the next readable "word". If no next word, return one past the end of the buffer
-til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const
+til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, const DelimiterSet& wordDelimiters, const til::point limit) const
 {
     const auto bufferSize{ GetSize() };
     auto result{ target };
@@ -1370,7 +2292,7 @@ til::point TextBuffer::_GetWordEndForAccessibility(const til::point target, cons
 // - wordDelimiters - what characters are we considering for the separation of words
 // Return Value:
 // - The til::point for the last character of the current word or delimiter run (stopped by right margin)
-til::point TextBuffer::_GetWordEndForSelection(const til::point target, const std::wstring_view wordDelimiters) const
+til::point TextBuffer::_GetWordEndForSelection(const til::point target, const DelimiterSet& wordDelimiters) const
 {
     const auto bufferSize = GetSize();
 
@@ -1386,73 +2308,27 @@ til::point TextBuffer::_GetWordEndForSelection(const til::point target, const st
             // Prevent wrapping to the next line if the selection begins on whitespace
             if (isControlChar)
             {
-                break;
-            }
-
-            // Prevent wrapping to the next line if this one was hard-wrapped (e.g. not forced by us to wrap)
-            const auto& row = GetRowByOffset(result.y);
-            if (!row.WasWrapForced())
-            {
-                break;
-            }
-        }
-
-        bufferSize.IncrementInBounds(result);
-    }
-
-    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
-    {
-        // move off of delimiter
-        bufferSize.DecrementInBounds(result);
-    }
-
-    return result;
-}
-
-void TextBuffer::_PruneHyperlinks()
-{
-    // Check the old first row for hyperlink references
-    // If there are any, search the entire buffer for the same reference
-    // If the buffer does not contain the same reference, we can remove that hyperlink from our map
-    // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
-    // Get all the hyperlink references in the row we're erasing
-    const auto hyperlinks = GetRowByOffset(0).GetHyperlinks();
-
-    if (!hyperlinks.empty())
-    {
-        // Move to unordered set so we can use hashed lookup of IDs instead of linear search.
-        // Only make it an unordered set now because set always heap allocates but vector
-        // doesn't when the set is empty (saving an allocation in the common case of no links.)
-        std::unordered_set<uint16_t> firstRowRefs{ hyperlinks.cbegin(), hyperlinks.cend() };
-
-        const auto total = TotalRowCount();
-        // Loop through all the rows in the buffer except the first row -
-        // we have found all hyperlink references in the first row and put them in refs,
-        // now we need to search the rest of the buffer (i.e. all the rows except the first)
-        // to see if those references are anywhere else
-        for (til::CoordType i = 1; i < total; ++i)
-        {
-            const auto nextRowRefs = GetRowByOffset(i).GetHyperlinks();
-            for (auto id : nextRowRefs)
-            {
-                if (firstRowRefs.find(id) != firstRowRefs.end())
-                {
-                    firstRowRefs.erase(id);
-                }
+                break;
             }
-            if (firstRowRefs.empty())
+
+            // Prevent wrapping to the next line if this one was hard-wrapped (e.g. not forced by us to wrap)
+            const auto& row = GetRowByOffset(result.y);
+            if (!row.WasWrapForced())
             {
-                // No more hyperlink references left to search for, terminate early
                 break;
             }
         }
 
-        // Now delete obsolete references from our map
-        for (auto hyperlinkReference : firstRowRefs)
-        {
-            RemoveHyperlinkFromMap(hyperlinkReference);
-        }
+        bufferSize.IncrementInBounds(result);
     }
+
+    if (_GetDelimiterClassAt(result, wordDelimiters) != initialDelimiter)
+    {
+        // move off of delimiter
+        bufferSize.DecrementInBounds(result);
+    }
+
+    return result;
 }
 
 // Method Description:
@@ -1471,7 +2347,7 @@ bool TextBuffer::MoveToNextWord(til::point& pos, const std::wstring_view wordDel
     //       This is also the inclusive start of the next word.
     const auto bufferSize{ GetSize() };
     const auto limit{ limitOptional.value_or(bufferSize.EndExclusive()) };
-    const auto copy{ _GetWordEndForAccessibility(pos, wordDelimiters, limit) };
+    const auto copy{ _GetWordEndForAccessibility(pos, DelimiterSet{ wordDelimiters }, limit) };
 
     if (bufferSize.CompareInBounds(copy, limit, true) >= 0)
     {
@@ -1526,7 +2402,7 @@ til::point TextBuffer::GetGlyphStart(const til::point pos, std::optional<til::po
     }
 
     // limit is exclusive, so we need to move back to be within valid bounds
-    if (resultPos != limit && GetCellDataAt(resultPos)->DbcsAttr() == DbcsAttribute::Trailing)
+    if (resultPos != limit && GetRowByOffset(resultPos.y).DbcsAttrAt(resultPos.x) == DbcsAttribute::Trailing)
     {
         bufferSize.DecrementInBounds(resultPos, true);
     }
@@ -1553,7 +2429,7 @@ til::point TextBuffer::GetGlyphEnd(const til::point pos, bool accessibilityMode,
         resultPos = limit;
     }
 
-    if (resultPos != limit && GetCellDataAt(resultPos)->DbcsAttr() == DbcsAttribute::Leading)
+    if (resultPos != limit && GetRowByOffset(resultPos.y).DbcsAttrAt(resultPos.x) == DbcsAttribute::Leading)
     {
         bufferSize.IncrementInBounds(resultPos, true);
     }
@@ -1633,7 +2509,7 @@ bool TextBuffer::MoveToPreviousGlyph(til::point& pos, std::optional<til::point>
 
     // try to move. If we can't, we're done.
     const auto success = bufferSize.DecrementInBounds(resultPos, true);
-    if (resultPos != bufferSize.EndExclusive() && GetCellDataAt(resultPos)->DbcsAttr() == DbcsAttribute::Leading)
+    if (resultPos != bufferSize.EndExclusive() && GetRowByOffset(resultPos.y).DbcsAttrAt(resultPos.x) == DbcsAttribute::Leading)
     {
         bufferSize.DecrementInBounds(resultPos, true);
     }
@@ -1719,18 +2595,41 @@ const std::vector<til::inclusive_rect> TextBuffer::GetTextRects(til::point start
 std::vector<til::point_span> TextBuffer::GetTextSpans(til::point start, til::point end, bool blockSelection, bool bufferCoordinates) const
 {
     std::vector<til::point_span> textSpans;
+    GetTextSpans(start, end, blockSelection, bufferCoordinates, textSpans);
+    return textSpans;
+}
+
+// Method Description:
+// - Same as above, but the spans are written into `textSpans`, reusing its memory.
+//   Block selections produce one span per row, which may be thousands of them, and
+//   callers like the selection code recompute them every time the selection changes.
+void TextBuffer::GetTextSpans(til::point start, til::point end, bool blockSelection, bool bufferCoordinates, std::vector<til::point_span>& textSpans) const
+{
+    textSpans.clear();
+
     if (blockSelection)
     {
         // If blockSelection, this is effectively the same operation as GetTextRects, but
-        // expressed in til::point coordinates.
-        const auto rects = GetTextRects(start, end, /*blockSelection*/ true, bufferCoordinates);
-        textSpans.reserve(rects.size());
-
-        for (auto rect : rects)
+        // expressed in til::point coordinates and without the intermediate vector of rects.
+        const auto bufferSize = GetSize();
+        const auto [higherCoord, lowerCoord] = bufferSize.CompareInBounds(start, end) <= 0 ?
+                                                   std::make_tuple(start, end) :
+                                                   std::make_tuple(end, start);
+        const auto left = std::min(higherCoord.x, lowerCoord.x);
+        const auto right = std::max(higherCoord.x, lowerCoord.x);
+
+        textSpans.reserve(gsl::narrow_cast<size_t>(1 + lowerCoord.y - higherCoord.y));
+        for (auto row = higherCoord.y; row <= lowerCoord.y; row++)
         {
-            const til::point first = { rect.left, rect.top };
-            const til::point second = { rect.right, rect.bottom };
-            textSpans.emplace_back(first, second);
+            til::inclusive_rect textRow{ left, row, right, row };
+
+            if (!bufferCoordinates)
+            {
+                textRow = ScreenToBufferLine(textRow, GetLineRendition(row));
+            }
+
+            _ExpandTextRow(textRow);
+            textSpans.emplace_back(til::point{ textRow.left, row }, til::point{ textRow.right, row });
         }
     }
     else
@@ -1744,8 +2643,6 @@ std::vector<til::point_span> TextBuffer::GetTextSpans(til::point start, til::poi
                                              std::make_tuple(start, end) :
                                              std::make_tuple(end, start);
 
-        textSpans.reserve(1);
-
         // If we were passed screen coordinates, convert the given range into
         // equivalent buffer offsets, taking line rendition into account.
         if (!bufferCoordinates)
@@ -1763,8 +2660,6 @@ std::vector<til::point_span> TextBuffer::GetTextSpans(til::point start, til::poi
 
         textSpans.emplace_back(higherCoord, lowerCoord);
     }
-
-    return textSpans;
 }
 
 // Method Description:
@@ -1780,7 +2675,7 @@ void TextBuffer::_ExpandTextRow(til::inclusive_rect& textRow) const
 
     // expand left side of rect
     til::point targetPoint{ textRow.left, textRow.top };
-    if (GetCellDataAt(targetPoint)->DbcsAttr() == DbcsAttribute::Trailing)
+    if (GetRowByOffset(targetPoint.y).DbcsAttrAt(targetPoint.x) == DbcsAttribute::Trailing)
     {
         if (targetPoint.x == bufferSize.Left())
         {
@@ -1795,7 +2690,7 @@ void TextBuffer::_ExpandTextRow(til::inclusive_rect& textRow) const
 
     // expand right side of rect
     targetPoint = { textRow.right, textRow.bottom };
-    if (GetCellDataAt(targetPoint)->DbcsAttr() == DbcsAttribute::Leading)
+    if (GetRowByOffset(targetPoint.y).DbcsAttrAt(targetPoint.x) == DbcsAttribute::Leading)
     {
         if (targetPoint.x == bufferSize.RightInclusive())
         {
@@ -1889,9 +2784,10 @@ std::tuple<til::CoordType, til::CoordType, bool> TextBuffer::_RowCopyHelper(cons
 // - Retrieves the text data from the buffer and presents it in a clipboard-ready format.
 // Arguments:
 // - req - the copy request having the bounds of the selected region and other related configuration flags.
+// - maxLength - stop once this many characters have been retrieved. The result may be slightly longer.
 // Return Value:
 // - The text data from the selected region of the text buffer. Empty if the copy request is invalid.
-std::wstring TextBuffer::GetPlainText(const CopyRequest& req) const
+std::wstring TextBuffer::GetPlainText(const CopyRequest& req, const size_t maxLength) const
 {
     if (req.beg > req.end)
     {
@@ -1900,7 +2796,13 @@ std::wstring TextBuffer::GetPlainText(const CopyRequest& req) const
 
     std::wstring selectedText;
 
-    for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
+    // Huge selections would otherwise grow (and copy) the string dozens of times.
+    // Most rows are mostly filled, so one row width plus CRLF per row is a good estimate.
+    const auto rowCount = static_cast<size_t>(req.end.y) - static_cast<size_t>(req.beg.y) + 1;
+    const auto rowWidth = req.blockSelection ? req.maxX - req.minX + 1 : GetSize().Width();
+    selectedText.reserve(std::min(maxLength, rowCount * (static_cast<size_t>(std::max(0, rowWidth)) + 2)));
+
+    for (auto iRow = req.beg.y; iRow <= req.end.y && selectedText.size() < maxLength; ++iRow)
     {
         const auto& row = GetRowByOffset(iRow);
         const auto& [rowBeg, rowEnd, addLineBreak] = _RowCopyHelper(req, iRow, row);
@@ -1981,7 +2883,12 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
 
     try
     {
-        std::string htmlBuilder;
+        // once filled with values, there will be exactly 157 bytes in the clipboard header
+        constexpr size_t ClipboardHeaderSize = 157;
+
+        // The header contains the byte offsets of the content, so it can only be written at the end.
+        // We reserve its space up front instead of prepending it, which would copy the entire document.
+        std::string htmlBuilder(ClipboardHeaderSize, ' ');
 
         // First we have to add some standard HTML boiler plate required for
         // CF_HTML as part of the HTML Clipboard format
@@ -2009,6 +2916,12 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
             htmlBuilder += "\">";
         }
 
+        // Consecutive runs (especially across rows) usually share their attributes,
+        // so we only compute the colors when they actually change.
+        std::optional<TextAttribute> previousAttr;
+        std::string fgHex, bgHex, ulHex;
+        std::string unescapedText;
+
         for (auto iRow = req.beg.y; iRow <= req.end.y; ++iRow)
         {
             const auto& row = GetRowByOffset(iRow);
@@ -2018,13 +2931,18 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
             const auto runs = row.Attributes().slice(rowBegU16, rowEndU16).runs();
 
             auto x = rowBegU16;
-            for (const auto& [attr, length] : runs)
+            for (const auto& [attrId, length] : runs)
             {
                 const auto nextX = gsl::narrow_cast<uint16_t>(x + length);
-                const auto [fg, bg, ul] = GetAttributeColors(attr);
-                const auto fgHex = Utils::ColorToHexString(fg);
-                const auto bgHex = Utils::ColorToHexString(bg);
-                const auto ulHex = Utils::ColorToHexString(ul);
+                const auto& attr = _attrTable->Get(attrId);
+                if (previousAttr != attr)
+                {
+                    const auto [fg, bg, ul] = GetAttributeColors(attr);
+                    fgHex = Utils::ColorToHexString(fg);
+                    bgHex = Utils::ColorToHexString(bg);
+                    ulHex = Utils::ColorToHexString(ul);
+                    previousAttr = attr;
+                }
                 const auto ulStyle = attr.GetUnderlineStyle();
                 const auto isUnderlined = ulStyle != UnderlineStyle::NoUnderline;
                 const auto isCrossedOut = attr.IsCrossedOut();
@@ -2087,7 +3005,6 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
                 htmlBuilder += "\">";
 
                 // text
-                std::string unescapedText;
                 THROW_IF_FAILED(til::u16u8(row.GetText(x, nextX), unescapedText));
                 for (const auto c : unescapedText)
                 {
@@ -2133,12 +3050,9 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
         constexpr std::string_view HtmlFooter = "</BODY></HTML>";
         htmlBuilder += HtmlFooter;
 
-        // once filled with values, there will be exactly 157 bytes in the clipboard header
-        constexpr size_t ClipboardHeaderSize = 157;
-
         // these values are byte offsets from start of clipboard
         const auto htmlStartPos = ClipboardHeaderSize;
-        const auto htmlEndPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlBuilder.length());
+        const auto htmlEndPos = gsl::narrow<size_t>(htmlBuilder.length());
         const auto fragStartPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlHeader.length());
         const auto fragEndPos = htmlEndPos - HtmlFooter.length();
 
@@ -2152,7 +3066,9 @@ std::string TextBuffer::GenHTML(const CopyRequest& req,
         fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("StartSelection:{:0>10}\r\n"), fragStartPos);
         fmt::format_to(std::back_inserter(clipHeaderBuilder), FMT_COMPILE("EndSelection:{:0>10}\r\n"), fragEndPos);
 
-        return clipHeaderBuilder + htmlBuilder;
+        THROW_HR_IF(E_UNEXPECTED, clipHeaderBuilder.size() != ClipboardHeaderSize);
+        htmlBuilder.replace(0, ClipboardHeaderSize, clipHeaderBuilder);
+        return htmlBuilder;
     }
     catch (...)
     {
@@ -2268,9 +3184,10 @@ std::string TextBuffer::GenRTF(const CopyRequest& req,
             const auto runs = row.Attributes().slice(rowBegU16, rowEndU16).runs();
 
             auto x = rowBegU16;
-            for (auto& [attr, length] : runs)
+            for (auto& [attrId, length] : runs)
             {
                 const auto nextX = gsl::narrow_cast<uint16_t>(x + length);
+                const auto& attr = _attrTable->Get(attrId);
                 const auto [fg, bg, ul] = GetAttributeColors(attr);
                 const auto fgIdx = getColorTableIndex(fg);
                 const auto bgIdx = getColorTableIndex(bg);
@@ -2343,10 +3260,13 @@ std::string TextBuffer::GenRTF(const CopyRequest& req,
         }
 
         // add color table to the final RTF
-        rtfBuilder += colorTableBuilder + "}";
+        rtfBuilder.reserve(rtfBuilder.size() + colorTableBuilder.size() + contentBuilder.size() + 2);
+        rtfBuilder += colorTableBuilder;
+        rtfBuilder += "}";
 
         // add the text content to the final RTF
-        rtfBuilder += contentBuilder + "}";
+        rtfBuilder += contentBuilder;
+        rtfBuilder += "}";
 
         return rtfBuilder;
     }
@@ -2428,6 +3348,340 @@ void TextBuffer::SerializeToPath(const wchar_t* destination) const
     }
 }
 
+// The binary format produced by SerializeImage(). Unlike SerializeToPath() it can be restored without going through
+// the VT parser, because the ROWs are stored the way ROW::PackText() packs them. Values are stored in native byte
+// order and TextAttributes as-is, since an image is only ever read back by the build that wrote it. Any change
+// to the layout or to TextAttribute must bump ImageVersion, which makes GetImageSize() reject older images.
+//
+// An image consists of:
+// * ImageHeader
+// * attributeCount * TextAttribute - ImageRun::attribute is an index into this table
+// * hyperlinkCount * ImageHyperlink - each followed by uriLength + customIdLength wchar_t
+// * rowCount * ImageRow - each followed by runCount * ImageRun and the PackedRow::Data() of the row
+//
+// None of it is aligned, so everything must be read with memcpy.
+namespace
+{
+    constexpr char ImageMagic[8]{ 'W', 'T', 'B', 'U', 'F', 'I', 'M', 'G' };
+    constexpr uint32_t ImageVersion = 1;
+
+    static_assert(std::is_trivially_copyable_v<TextAttribute>);
+
+    struct ImageHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint16_t attributeSize;
+        uint16_t width;
+        uint32_t rowCount;
+        uint32_t attributeCount;
+        uint32_t hyperlinkCount;
+        uint32_t reserved;
+    };
+
+    struct ImageHyperlink
+    {
+        uint16_t id;
+        uint16_t reserved;
+        uint32_t uriLength;
+        uint32_t customIdLength;
+    };
+
+    namespace ImageRowFlags
+    {
+        constexpr uint8_t NarrowChars = 0x01;
+        constexpr uint8_t ExplicitOffsets = 0x02;
+        constexpr uint8_t WrapForced = 0x04;
+        constexpr uint8_t DoubleBytePadded = 0x08;
+        constexpr uint8_t HasMark = 0x10;
+        constexpr uint8_t HasMarkColor = 0x20;
+        constexpr uint8_t HasMarkExitCode = 0x40;
+    }
+
+    struct ImageRow
+    {
+        uint16_t columnEnd;
+        uint16_t charsEnd;
+        uint16_t runCount;
+        uint8_t flags;
+        LineRendition lineRendition;
+        uint32_t markColor;
+        uint32_t markExitCode;
+        MarkCategory markCategory;
+        uint8_t reserved[3];
+    };
+
+    struct ImageRun
+    {
+        uint32_t attribute;
+        uint16_t length;
+        uint16_t reserved;
+    };
+
+    template<typename T>
+    void appendImage(std::vector<std::byte>& image, const T& value)
+    {
+        const auto bytes = std::as_bytes(std::span{ &value, 1 });
+        image.insert(image.end(), bytes.begin(), bytes.end());
+    }
+
+    void appendImageBytes(std::vector<std::byte>& image, const std::span<const std::byte> bytes)
+    {
+        image.insert(image.end(), bytes.begin(), bytes.end());
+    }
+
+    // Consumes an image from the front and throws if it's truncated.
+    struct ImageReader
+    {
+        std::span<const std::byte> remaining;
+
+        std::span<const std::byte> Take(const size_t size)
+        {
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), size > remaining.size());
+            const auto bytes = remaining.first(size);
+            remaining = remaining.subspan(size);
+            return bytes;
+        }
+
+        template<typename T>
+        T Read()
+        {
+            T value;
+            memcpy(&value, Take(sizeof(T)).data(), sizeof(T));
+            return value;
+        }
+
+        std::wstring ReadString(const size_t length)
+        {
+            const auto bytes = Take(length * sizeof(wchar_t));
+            std::wstring str(length, L'\0');
+            memcpy(str.data(), bytes.data(), bytes.size());
+            return str;
+        }
+    };
+}
+
+// Returns the rows [0, GetLastNonSpaceCharacter().y] in the binary format described above ImageHeader.
+// Compared to SerializeToPath(), this is cheaper to write and a lot cheaper to restore with LoadImage().
+std::vector<std::byte> TextBuffer::SerializeImage() const
+{
+    const auto rowCount = GetLastNonSpaceCharacter(nullptr).y + 1;
+
+    // The image gets its own attribute table, so that entries that aren't used by any of the rows
+    // (anymore) don't end up in it. The same goes for the hyperlinks the attributes refer to.
+    std::vector<TextAttribute> attributes;
+    std::unordered_map<TextAttributeTable::Id, uint32_t> attributeIndices;
+    std::vector<uint16_t> hyperlinkIds;
+    std::vector<std::byte> rows;
+
+    for (til::CoordType y = 0; y < rowCount; ++y)
+    {
+        const auto& row = GetRowByOffset(y);
+        const auto packed = row.PackText();
+        const auto& runs = row.Attributes().runs();
+        const auto& mark = row.GetScrollbarData();
+
+        uint8_t flags = 0;
+        WI_SetFlagIf(flags, ImageRowFlags::NarrowChars, packed.narrowChars);
+        WI_SetFlagIf(flags, ImageRowFlags::ExplicitOffsets, packed.explicitOffsets);
+        WI_SetFlagIf(flags, ImageRowFlags::WrapForced, packed.wrapForced);
+        WI_SetFlagIf(flags, ImageRowFlags::DoubleBytePadded, packed.doubleBytePadded);
+        WI_SetFlagIf(flags, ImageRowFlags::HasMark, mark.has_value());
+        WI_SetFlagIf(flags, ImageRowFlags::HasMarkColor, mark && mark->color.has_value());
+        WI_SetFlagIf(flags, ImageRowFlags::HasMarkExitCode, mark && mark->exitCode.has_value());
+
+        appendImage(rows,
+                    ImageRow{
+                        .columnEnd = packed.columnEnd,
+                        .charsEnd = packed.charsEnd,
+                        .runCount = gsl::narrow<uint16_t>(runs.size()),
+                        .flags = flags,
+                        .lineRendition = packed.lineRendition,
+                        .markColor = mark && mark->color ? mark->color->abgr : 0,
+                        .markExitCode = mark ? mark->exitCode.value_or(0) : 0,
+                        .markCategory = mark ? mark->category : MarkCategory::Default,
+                    });
+
+        for (const auto& run : runs)
+        {
+            const auto [it, inserted] = attributeIndices.emplace(run.value, gsl::narrow_cast<uint32_t>(attributes.size()));
+            if (inserted)
+            {
+                const auto& attr = attributes.emplace_back(_attrTable->Get(run.value));
+                if (attr.IsHyperlink())
+                {
+                    hyperlinkIds.emplace_back(attr.GetHyperlinkId());
+                }
+            }
+            appendImage(rows, ImageRun{ .attribute = it->second, .length = run.length });
+        }
+
+        appendImageBytes(rows, { packed.Data(), packed.DataSize() });
+    }
+
+    // Different attributes may refer to the same hyperlink.
+    std::sort(hyperlinkIds.begin(), hyperlinkIds.end());
+    hyperlinkIds.erase(std::unique(hyperlinkIds.begin(), hyperlinkIds.end()), hyperlinkIds.end());
+    std::erase_if(hyperlinkIds, [&](const auto id) { return !_hyperlinks.Contains(id); });
+
+    std::vector<std::byte> image;
+    image.reserve(sizeof(ImageHeader) + attributes.size() * sizeof(TextAttribute) + rows.size());
+
+    ImageHeader header{
+        .version = ImageVersion,
+        .attributeSize = sizeof(TextAttribute),
+        .width = gsl::narrow<uint16_t>(_width),
+        .rowCount = gsl::narrow<uint32_t>(rowCount),
+        .attributeCount = gsl::narrow<uint32_t>(attributes.size()),
+        .hyperlinkCount = gsl::narrow<uint32_t>(hyperlinkIds.size()),
+    };
+    memcpy(&header.magic[0], &ImageMagic[0], sizeof(ImageMagic));
+    appendImage(image, header);
+    appendImageBytes(image, std::as_bytes(std::span{ attributes }));
+
+    for (const auto id : hyperlinkIds)
+    {
+        const auto uri = _hyperlinks.GetUri(id);
+        const auto customId = _hyperlinks.GetCustomId(id);
+        appendImage(image, ImageHyperlink{ .id = id, .uriLength = gsl::narrow<uint32_t>(uri.size()), .customIdLength = gsl::narrow<uint32_t>(customId.size()) });
+        appendImageBytes(image, std::as_bytes(std::span{ uri }));
+        appendImageBytes(image, std::as_bytes(std::span{ customId }));
+    }
+
+    appendImageBytes(image, rows);
+    return image;
+}
+
+// Writes SerializeImage() to the given file. See SerializeToPath() for the text based alternative.
+void TextBuffer::SerializeImageToPath(const wchar_t* destination) const
+{
+    const auto image = SerializeImage();
+
+    const wil::unique_handle file{ CreateFileW(destination, GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    THROW_LAST_ERROR_IF(!file);
+
+    const auto fileSize = gsl::narrow<DWORD>(image.size());
+    DWORD bytesWritten = 0;
+    THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), image.data(), fileSize, &bytesWritten, nullptr));
+    THROW_WIN32_IF_MSG(ERROR_WRITE_FAULT, bytesWritten != fileSize, "failed to write");
+}
+
+// Returns the size of the TextBuffer that LoadImage() expects for the given image,
+// or nullopt if it isn't an image that was written by this version of SerializeImage().
+std::optional<til::size> TextBuffer::GetImageSize(const std::span<const std::byte> image) noexcept
+{
+    ImageHeader header;
+    if (image.size() < sizeof(header))
+    {
+        return std::nullopt;
+    }
+
+    memcpy(&header, image.data(), sizeof(header));
+    if (memcmp(&header.magic[0], &ImageMagic[0], sizeof(ImageMagic)) != 0 ||
+        header.version != ImageVersion ||
+        header.attributeSize != sizeof(TextAttribute) ||
+        header.width == 0 ||
+        header.rowCount == 0 ||
+        header.rowCount >= SHRT_MAX)
+    {
+        return std::nullopt;
+    }
+
+    // One more row than the image contains, so that the cursor can be placed below the last one.
+    // Just like the buffers that images are made of, that stays within SHRT_MAX.
+    return til::size{ header.width, gsl::narrow_cast<til::CoordType>(header.rowCount + 1) };
+}
+
+// Restores an image produced by SerializeImage(). This buffer must be freshly constructed, with the size returned by
+// GetImageSize(). The text is copied straight from the image into the ROWs, which is why `image` can (and should)
+// be a view of a memory mapped file. Afterwards the cursor is placed at the start of the row after the last one.
+// Throws if the image is malformed, in which case the buffer contents are unspecified.
+void TextBuffer::LoadImage(const std::span<const std::byte> image)
+{
+    const auto invalid = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    const auto size = GetImageSize(image);
+    THROW_HR_IF(invalid, !size);
+    THROW_HR_IF(E_INVALIDARG, *size != GetSize().Dimensions());
+
+    ImageReader reader{ image };
+    const auto header = reader.Read<ImageHeader>();
+
+    const auto attributeBytes = reader.Take(size_t{ header.attributeCount } * sizeof(TextAttribute));
+    std::vector<TextAttribute> attributes(header.attributeCount);
+    memcpy(attributes.data(), attributeBytes.data(), attributeBytes.size());
+
+    // Hyperlink ids are allocated by our _hyperlinks and so they'll likely differ from the ones in the image.
+    std::unordered_map<uint16_t, uint16_t> hyperlinkIds;
+    for (uint32_t i = 0; i < header.hyperlinkCount; ++i)
+    {
+        const auto link = reader.Read<ImageHyperlink>();
+        const auto uri = reader.ReadString(link.uriLength);
+        const auto customId = reader.ReadString(link.customIdLength);
+        hyperlinkIds.emplace(link.id, _hyperlinks.Acquire(uri, customId));
+    }
+
+    std::vector<TextAttributeTable::Id> attributeIds;
+    attributeIds.reserve(attributes.size());
+    for (auto& attr : attributes)
+    {
+        if (attr.IsHyperlink())
+        {
+            const auto it = hyperlinkIds.find(attr.GetHyperlinkId());
+            attr.SetHyperlinkId(it != hyperlinkIds.end() ? it->second : 0);
+        }
+        attributeIds.emplace_back(_attrTable->Intern(attr));
+    }
+
+    for (til::CoordType y = 0; y < gsl::narrow_cast<til::CoordType>(header.rowCount); ++y)
+    {
+        const auto imageRow = reader.Read<ImageRow>();
+
+        PackedRow packed;
+        packed.columnEnd = imageRow.columnEnd;
+        packed.charsEnd = imageRow.charsEnd;
+        packed.narrowChars = WI_IsFlagSet(imageRow.flags, ImageRowFlags::NarrowChars);
+        packed.explicitOffsets = WI_IsFlagSet(imageRow.flags, ImageRowFlags::ExplicitOffsets);
+        packed.lineRendition = imageRow.lineRendition;
+        packed.wrapForced = WI_IsFlagSet(imageRow.flags, ImageRowFlags::WrapForced);
+        packed.doubleBytePadded = WI_IsFlagSet(imageRow.flags, ImageRowFlags::DoubleBytePadded);
+
+        if (WI_IsFlagSet(imageRow.flags, ImageRowFlags::HasMark))
+        {
+            auto& mark = packed.promptData.emplace(ScrollbarData{ .category = imageRow.markCategory });
+            if (WI_IsFlagSet(imageRow.flags, ImageRowFlags::HasMarkColor))
+            {
+                til::color color;
+                color.abgr = imageRow.markColor;
+                mark.color = color;
+            }
+            if (WI_IsFlagSet(imageRow.flags, ImageRowFlags::HasMarkExitCode))
+            {
+                mark.exitCode = imageRow.markExitCode;
+            }
+        }
+
+        TextAttributeTable::Runs::container runs;
+        size_t runsLength = 0;
+        for (uint16_t i = 0; i < imageRow.runCount; ++i)
+        {
+            const auto run = reader.Read<ImageRun>();
+            THROW_HR_IF(invalid, run.attribute >= attributeIds.size() || run.length == 0);
+            runs.emplace_back(attributeIds[run.attribute], run.length);
+            runsLength += run.length;
+        }
+        // The run lengths are only 16 bits wide and could overflow otherwise.
+        THROW_HR_IF(invalid, runsLength != gsl::narrow_cast<size_t>(_width));
+        packed.attr = TextAttributeTable::Runs{ std::move(runs) };
+
+        packed.mappedData = reader.Take(packed.DataSize()).data();
+        THROW_HR_IF(invalid, !ROW::IsUnpackable(packed, gsl::narrow_cast<uint16_t>(_width)));
+
+        GetMutableRowByOffset(y).Unpack(std::move(packed));
+    }
+
+    _cursor.SetPosition({ 0, gsl::narrow_cast<til::CoordType>(header.rowCount) });
+}
+
 // Serializes one row of the text buffer including ANSI escape code control sequences.
 // Arguments:
 // - row - A reference to the row being serialized.
@@ -2477,11 +3731,12 @@ void TextBuffer::_SerializeRow(const ROW& row, const til::CoordType startX, cons
         const auto previousBg = effectivePreviousTextAttr.GetBackground();
         const auto previousUl = effectivePreviousTextAttr.GetUnderlineColor();
 
-        const auto attr = it->value.GetCharacterAttributes();
-        const auto hyperlinkId = it->value.GetHyperlinkId();
-        const auto fg = it->value.GetForeground();
-        const auto bg = it->value.GetBackground();
-        const auto ul = it->value.GetUnderlineColor();
+        const auto& value = _attrTable->Get(it->value);
+        const auto attr = value.GetCharacterAttributes();
+        const auto hyperlinkId = value.GetHyperlinkId();
+        const auto fg = value.GetForeground();
+        const auto bg = value.GetBackground();
+        const auto ul = value.GetUnderlineColor();
 
         if (previousAttr != attr)
         {
@@ -2549,7 +3804,7 @@ void TextBuffer::_SerializeRow(const ROW& row, const til::CoordType startX, cons
                     L"\x1b[4:5m", // UnderlineStyle::DashedUnderlined
                 };
 
-                auto idx = WI_EnumValue(it->value.GetUnderlineStyle());
+                auto idx = WI_EnumValue(value.GetUnderlineStyle());
                 if (idx >= std::size(mappings))
                 {
                     idx = 1; // UnderlineStyle::SinglyUnderlined
@@ -2673,40 +3928,358 @@ void TextBuffer::_SerializeRow(const ROW& row, const til::CoordType startX, cons
 
         if (trimTrailingWhitespaces)
         {
-            newX = lastCharX;
+            newX = lastCharX;
+        }
+
+        buffer.append(row.GetText(oldX, newX));
+
+        if (clearToEndOfLine)
+        {
+            buffer.append(L"\x1b[K");
+        }
+
+        oldX = newX;
+    }
+
+    // Handle empty rows (with no runs). See above for more details about `delayedLineBreak`.
+    if (delayedLineBreak)
+    {
+        buffer.append(L"\r\n");
+        delayedLineBreak = false;
+    }
+
+    delayedLineBreak = !row.WasWrapForced() && addLineBreak;
+
+    if (isLastRow)
+    {
+        if (previousTextAttr.has_value() && previousTextAttr->GetHyperlinkId())
+        {
+            buffer.append(L"\x1b]8;;\x1b\\");
+        }
+        buffer.append(L"\x1b[0m");
+        if (addLineBreak)
+        {
+            buffer.append(L"\r\n");
+        }
+    }
+}
+
+// Advances the write position (newY, newX) of Reflow() across the given row, exactly like Reflow() would, without
+// actually copying any of its contents. Returns the last row in the new buffer that Reflow() would write to.
+// This doesn't handle the cursor row, since Reflow() treats it differently (see REFLOW_JANK_CURSOR_WRAP).
+static til::CoordType reflowMeasureRow(const ROW& row, const til::CoordType newWidth, til::CoordType& newY, til::CoordType& newX) noexcept
+{
+    if (row.GetLineRendition() != LineRendition::SingleWidth)
+    {
+        if (newX)
+        {
+            newX = 0;
+            newY++;
+        }
+        return newY++;
+    }
+
+    const auto oldRowLimit = row.MeasureRight();
+    til::CoordType oldX = 0;
+
+    do
+    {
+        if (newX >= newWidth)
+        {
+            newX = 0;
+            newY++;
+        }
+
+        const auto remaining = oldRowLimit - oldX;
+        if (remaining <= 0)
+        {
+            break;
+        }
+
+        // This mirrors ROW::CopyTextFrom(): It copies as many columns as fit and
+        // doesn't split wide glyphs, leaving their column in the new row blank.
+        auto copied = std::min(newWidth - newX, remaining);
+        if (copied < remaining)
+        {
+            copied = row.AdjustToGlyphStart(oldX + copied) - oldX;
+        }
+
+        newX = copied == remaining ? newX + copied : newWidth;
+        oldX += copied;
+    } while (oldX < oldRowLimit);
+
+    const auto lastRow = newY;
+    if (!row.WasWrapForced())
+    {
+        newX = 0;
+        newY++;
+    }
+    return lastRow;
+}
+
+// Reflows the rows [oldY, oldEnd) of oldBuffer into newBuffer on multiple threads and advances (oldY, newY, newX)
+// past them, exactly like the copy loop in Reflow() would. Reflow() uses it for the rows above the cursor and the
+// viewports, which are most of a full scrollback and don't need any of the copy loop's special handling.
+//
+// Logical lines (a run of rows that ends with one that isn't WasWrapForced()) reflow independently of each other.
+// The rows are split into one partition per thread at the start of a logical line, each partition measures the
+// number of rows it turns into, a prefix sum over those yields where each partition starts, and then they're copied.
+// Everything the partitions would otherwise share gets prepared upfront: The old ROWs are looked up (which may
+// rehydrate cold chunks), their attributes are interned into the new table and the new ROWs are committed.
+// If the rows don't fit into newBuffer without wrapping around onto each other, only a part of them is reflowed.
+void TextBuffer::_reflowParallel(const TextBuffer& oldBuffer, TextBuffer& newBuffer, til::CoordType& oldY, const til::CoordType oldEnd, til::CoordType& newY, til::CoordType& newX)
+{
+    // With fewer rows than this per thread, starting the threads costs more than it saves.
+    static constexpr til::CoordType minRowsPerThread = 2048;
+    static constexpr auto noTranslation = std::numeric_limits<TextAttributeTable::Id>::max();
+
+    const auto threadCount = std::min(gsl::narrow_cast<til::CoordType>(std::thread::hardware_concurrency()), (oldEnd - oldY) / minRowsPerThread);
+    if (threadCount < 2)
+    {
+        return;
+    }
+
+    const auto newWidth = newBuffer._width;
+    const auto newHeight = newBuffer._height;
+    const auto newWidthU16 = gsl::narrow_cast<uint16_t>(newWidth);
+
+    std::vector<const ROW*> oldRows;
+    std::vector<TextAttributeTable::Id> translation(oldBuffer._attrTable->Capacity(), noTranslation);
+    oldRows.reserve(gsl::narrow_cast<size_t>(oldEnd - oldY));
+
+    for (auto y = oldY; y < oldEnd; ++y)
+    {
+        const auto& row = oldBuffer.GetRowByOffset(y);
+        oldRows.emplace_back(&row);
+
+        for (const auto& run : row.Attributes().runs())
+        {
+            auto& id = til::at(translation, run.value);
+            if (id == noTranslation)
+            {
+                id = newBuffer._attrTable->Intern(oldBuffer._attrTable->Get(run.value));
+            }
+        }
+    }
+
+    struct Partition
+    {
+        // The range of oldRows.
+        size_t beg = 0;
+        size_t end = 0;
+        // The position in newBuffer at which to start writing.
+        til::CoordType newY = 0;
+        til::CoordType newX = 0;
+        // The position in newBuffer after writing all rows.
+        til::CoordType newYEnd = 0;
+        til::CoordType newXEnd = 0;
+    };
+
+    // Double-width rows are always followed by a newline, just like in the copy loop in Reflow().
+    const auto startsLogicalLine = [&](size_t i) {
+        const auto& prev = *til::at(oldRows, i - 1);
+        return !prev.WasWrapForced() || prev.GetLineRendition() != LineRendition::SingleWidth;
+    };
+
+    std::vector<Partition> partitions;
+    partitions.reserve(gsl::narrow_cast<size_t>(threadCount));
+
+    for (size_t beg = 0, i = 1; i <= gsl::narrow_cast<size_t>(threadCount); ++i)
+    {
+        auto end = oldRows.size() * i / gsl::narrow_cast<size_t>(threadCount);
+        while (end < oldRows.size() && !startsLogicalLine(end))
+        {
+            ++end;
+        }
+        if (end > beg)
+        {
+            partitions.emplace_back(Partition{ .beg = beg, .end = end });
+            beg = end;
+        }
+    }
+
+    if (partitions.size() < 2)
+    {
+        return;
+    }
+
+    const auto runPartitions = [&](auto&& func) {
+        std::vector<std::exception_ptr> exceptions(partitions.size());
+        const auto run = [&](size_t i) noexcept {
+            try
+            {
+                func(til::at(partitions, i));
+            }
+            catch (...)
+            {
+                til::at(exceptions, i) = std::current_exception();
+            }
+        };
+
+        {
+            std::vector<std::thread> threads;
+            const auto join = wil::scope_exit([&]() noexcept {
+                for (auto& t : threads)
+                {
+                    t.join();
+                }
+            });
+
+            threads.reserve(partitions.size() - 1);
+            for (size_t i = 1; i < partitions.size(); ++i)
+            {
+                threads.emplace_back(run, i);
+            }
+            run(0);
         }
 
-        buffer.append(row.GetText(oldX, newX));
+        for (const auto& e : exceptions)
+        {
+            if (e)
+            {
+                std::rethrow_exception(e);
+            }
+        }
+    };
 
-        if (clearToEndOfLine)
+    // Measure each partition as if it started at the top left...
+    partitions.front().newX = newX;
+    runPartitions([&](Partition& p) {
+        til::CoordType y = 0;
+        til::CoordType x = p.newX;
+        for (auto i = p.beg; i < p.end; ++i)
         {
-            buffer.append(L"\x1b[K");
+            reflowMeasureRow(*til::at(oldRows, i), newWidth, y, x);
         }
+        p.newYEnd = y;
+        p.newXEnd = x;
+    });
 
-        oldX = newX;
+    // ...and then lay them out one after another.
+    for (auto y = newY; auto& p : partitions)
+    {
+        p.newY = y;
+        p.newYEnd += y;
+        y = p.newYEnd;
     }
 
-    // Handle empty rows (with no runs). See above for more details about `delayedLineBreak`.
-    if (delayedLineBreak)
+    // Partitions that would wrap around and write into the same rows as the first one are left to Reflow().
+    // This is also what allows us to skip the REFLOW_RESET, since none of the rows have been written to before.
+    const auto rowsWritten = [&]() {
+        const auto& last = partitions.back();
+        return last.newYEnd + (last.newXEnd != 0 ? 1 : 0) - newY;
+    };
+    while (partitions.size() >= 2 && rowsWritten() > newHeight)
     {
-        buffer.append(L"\r\n");
-        delayedLineBreak = false;
+        partitions.pop_back();
+    }
+    if (partitions.size() < 2)
+    {
+        return;
     }
 
-    delayedLineBreak = !row.WasWrapForced() && addLineBreak;
+    // Commit all the ROWs we're about to write to. _firstRow is still 0, so the last one written is also the last one in memory.
+    newBuffer._getRow(std::min(newY + rowsWritten(), newHeight) - 1);
 
-    if (isLastRow)
-    {
-        if (previousTextAttr.has_value() && previousTextAttr->GetHyperlinkId())
+    // The y position of each old row in newBuffer, for setting the ScrollbarData afterwards.
+    std::vector<til::CoordType> rowStarts(partitions.back().end);
+
+    runPartitions([&](const Partition& p) {
+        auto y = p.newY;
+        auto x = p.newX;
+
+        for (auto i = p.beg; i < p.end; ++i)
         {
-            buffer.append(L"\x1b]8;;\x1b\\");
+            const auto& oldRow = *til::at(oldRows, i);
+
+            if (oldRow.GetLineRendition() != LineRendition::SingleWidth)
+            {
+                if (x)
+                {
+                    x = 0;
+                    y++;
+                }
+
+                // This is ROW::CopyFrom() but with translated attributes.
+                auto& newRow = newBuffer._getRow(y);
+                RowCopyTextFromState state{
+                    .source = oldRow,
+                    .sourceColumnLimit = oldRow.GetReadableColumnCount(),
+                };
+                newRow.SetLineRendition(oldRow.GetLineRendition());
+                newRow.SetWrapForced(false);
+                newRow.CopyTextFrom(state);
+
+                auto& newAttr = newRow.Attributes();
+                newAttr = oldRow.SliceAttributes(0, oldRow.size(), translation);
+                newAttr.resize_trailing_extent(newWidthU16);
+
+                til::at(rowStarts, i) = y;
+                y++;
+                continue;
+            }
+
+            const auto oldRowLimit = oldRow.MeasureRight();
+            til::CoordType oldX = 0;
+            til::at(rowStarts, i) = y;
+
+            do
+            {
+                if (x >= newWidth)
+                {
+                    newBuffer._getRow(y).SetWrapForced(true);
+                    x = 0;
+                    y++;
+                }
+
+                auto& newRow = newBuffer._getRow(y);
+
+                RowCopyTextFromState state{
+                    .source = oldRow,
+                    .columnBegin = x,
+                    .columnLimit = til::CoordTypeMax,
+                    .sourceColumnBegin = oldX,
+                    .sourceColumnLimit = oldRowLimit,
+                };
+                newRow.CopyTextFrom(state);
+
+                if (oldX == 0)
+                {
+                    ImageSlice::CopyRow(oldRow, newRow);
+                }
+
+                auto& newAttr = newRow.Attributes();
+                const auto attributes = oldRow.SliceAttributes(gsl::narrow_cast<uint16_t>(oldX), oldRow.size(), translation);
+                newAttr.replace(gsl::narrow_cast<uint16_t>(x), newAttr.size(), attributes);
+                newAttr.resize_trailing_extent(newWidthU16);
+
+                oldX = state.sourceColumnEnd;
+                x = state.columnEnd;
+            } while (oldX < oldRowLimit);
+
+            if (!oldRow.WasWrapForced())
+            {
+                x = 0;
+                y++;
+            }
         }
-        buffer.append(L"\x1b[0m");
-        if (addLineBreak)
+    });
+
+    for (size_t i = 0; i < rowStarts.size(); ++i)
+    {
+        if (const auto& data = til::at(oldRows, i)->GetScrollbarData())
         {
-            buffer.append(L"\r\n");
+            newBuffer.SetScrollbarData(*data, til::at(rowStarts, i));
         }
     }
+
+    // The ROWs were written without GetMutableRowByOffset(), which would've recorded their revision.
+    newBuffer._markAllRowsChanged();
+
+    const auto& last = partitions.back();
+    oldY += gsl::narrow_cast<til::CoordType>(last.end);
+    newY = last.newYEnd;
+    newX = last.newXEnd;
 }
 
 // Function Description:
@@ -2757,6 +4330,47 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
     const auto newHeight = newBuffer.GetSize().Height();
     const auto newWidthU16 = gsl::narrow_cast<uint16_t>(newWidth);
 
+    // When the new buffer is narrower than the old one, a full scrollback may wrap into more rows than newBuffer can
+    // hold, and the copy loop below would write the oldest rows, just for them to be overwritten by the newer ones.
+    // Since the loop below always writes the cursor row, only the newHeight rows ending at the cursor row are sure
+    // to survive. We first measure where the cursor row will end up, which is cheap compared to copying the rows,
+    // and then skip all rows above the cursor that get written entirely above those newHeight rows.
+    // (A width of 1 is skipped, because the copy loop cannot make progress with wide glyphs in that case.)
+    if (newWidth > 1 && oldCursorPos.y > 0)
+    {
+        til::CoordType cursorNewY = 0;
+        til::CoordType cursorNewX = 0;
+        for (til::CoordType y = 0; y < oldCursorPos.y; ++y)
+        {
+            reflowMeasureRow(oldBuffer.GetRowByOffset(y), newWidth, cursorNewY, cursorNewX);
+        }
+
+        // Rows below discardLimit are overwritten by the time the cursor row has been written.
+        // The rows that mark the viewports are never skipped, since we need to know where they end up.
+        const auto discardLimit = cursorNewY + 1 - newHeight;
+        const auto skipLimit = std::min({ oldCursorPos.y, mutableViewportTop, visibleViewportTop });
+        if (discardLimit > 0)
+        {
+            for (til::CoordType skipNewY = 0, skipNewX = 0; oldY < skipLimit;)
+            {
+                if (reflowMeasureRow(oldBuffer.GetRowByOffset(oldY), newWidth, skipNewY, skipNewX) >= discardLimit)
+                {
+                    break;
+                }
+                oldY++;
+                newY = skipNewY;
+                newX = skipNewX;
+            }
+        }
+    }
+
+    // The rows above the cursor and the viewports don't need any of the special handling in the copy loop below,
+    // which allows us to reflow them on multiple threads. Like above, a width of 1 is skipped.
+    if (newWidth > 1)
+    {
+        _reflowParallel(oldBuffer, newBuffer, oldY, std::min({ oldCursorPos.y, mutableViewportTop, visibleViewportTop }), newY, newX);
+    }
+
     // Copy oldBuffer into newBuffer until oldBuffer has been fully consumed.
     for (; oldY < oldHeight && newY < newYLimit; ++oldY)
     {
@@ -2827,7 +4441,7 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
         //   single row, that's fine! The mark was on that logical row.
         if (oldRow.GetScrollbarData().has_value())
         {
-            newBuffer.GetMutableRowByOffset(newY).SetScrollbarData(oldRow.GetScrollbarData());
+            newBuffer.SetScrollbarData(*oldRow.GetScrollbarData(), newY);
         }
 
         til::CoordType oldX = 0;
@@ -2879,9 +4493,8 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
                 ImageSlice::CopyRow(oldRow, newRow);
             }
 
-            const auto& oldAttr = oldRow.Attributes();
             auto& newAttr = newRow.Attributes();
-            const auto attributes = oldAttr.slice(gsl::narrow_cast<uint16_t>(oldX), oldAttr.size());
+            const auto attributes = oldRow.SliceAttributes(gsl::narrow_cast<uint16_t>(oldX), oldRow.size(), *newBuffer._attrTable);
             newAttr.replace(gsl::narrow_cast<uint16_t>(newX), newAttr.size(), attributes);
             newAttr.resize_trailing_extent(newWidthU16);
 
@@ -2940,7 +4553,7 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
         auto& oldRow = oldBuffer.GetRowByOffset(oldY);
         auto& newRow = newBuffer.GetMutableRowByOffset(newY);
         auto& newAttr = newRow.Attributes();
-        newAttr = oldRow.Attributes();
+        newAttr = oldRow.SliceAttributes(0, oldRow.size(), *newBuffer._attrTable);
         newAttr.resize_trailing_extent(newWidthU16);
     }
 
@@ -2959,6 +4572,10 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
 
     newBuffer.CopyProperties(oldBuffer);
     newBuffer.CopyHyperlinkMaps(oldBuffer);
+    // The retained rows are unaffected by the new width, since they're only plain text.
+    newBuffer._retainedRows = std::move(oldBuffer._retainedRows);
+    newBuffer._retainedRowsSize = std::exchange(oldBuffer._retainedRowsSize, 0);
+    newBuffer._retainingRows = oldBuffer._retainingRows;
 
     assert(newCursorPos.x >= 0 && newCursorPos.x < newWidth);
     assert(newCursorPos.y >= 0 && newCursorPos.y < newHeight);
@@ -2972,7 +4589,7 @@ void TextBuffer::Reflow(TextBuffer& oldBuffer, TextBuffer& newBuffer, const View
 // - The hyperlink URI, the hyperlink id (could be new or old)
 void TextBuffer::AddHyperlinkToMap(std::wstring_view uri, uint16_t id)
 {
-    _hyperlinkMap[id] = uri;
+    _hyperlinks.SetUri(id, uri);
 }
 
 // Method Description:
@@ -2983,7 +4600,11 @@ void TextBuffer::AddHyperlinkToMap(std::wstring_view uri, uint16_t id)
 // - The URI
 std::wstring TextBuffer::GetHyperlinkUriFromId(uint16_t id) const
 {
-    return _hyperlinkMap.at(id);
+    if (!_hyperlinks.Contains(id))
+    {
+        throw std::out_of_range{ "unknown hyperlink id" };
+    }
+    return std::wstring{ _hyperlinks.GetUri(id) };
 }
 
 // Method description:
@@ -2994,51 +4615,7 @@ std::wstring TextBuffer::GetHyperlinkUriFromId(uint16_t id) const
 // - The internal hyperlink ID
 uint16_t TextBuffer::GetHyperlinkId(std::wstring_view uri, std::wstring_view id)
 {
-    uint16_t numericId = 0;
-    if (id.empty())
-    {
-        // no custom id specified, return our internal count
-        numericId = _currentHyperlinkId;
-        ++_currentHyperlinkId;
-    }
-    else
-    {
-        // assign _currentHyperlinkId if the custom id does not already exist
-        std::wstring newId{ id };
-        // hash the URL and add it to the custom ID - GH#7698
-        newId += L"%" + std::to_wstring(til::hash(uri));
-        const auto result = _hyperlinkCustomIdMap.emplace(newId, _currentHyperlinkId);
-        if (result.second)
-        {
-            // the custom id did not already exist
-            ++_currentHyperlinkId;
-        }
-        numericId = (*(result.first)).second;
-    }
-    // _currentHyperlinkId could overflow, make sure its not 0
-    if (_currentHyperlinkId == 0)
-    {
-        ++_currentHyperlinkId;
-    }
-    return numericId;
-}
-
-// Method Description:
-// - Removes a hyperlink from the hyperlink map and the associated
-//   user defined id from the custom id map (if there is one)
-// Arguments:
-// - The ID of the hyperlink to be removed
-void TextBuffer::RemoveHyperlinkFromMap(uint16_t id) noexcept
-{
-    _hyperlinkMap.erase(id);
-    for (const auto& customIdPair : _hyperlinkCustomIdMap)
-    {
-        if (customIdPair.second == id)
-        {
-            _hyperlinkCustomIdMap.erase(customIdPair.first);
-            break;
-        }
-    }
+    return _hyperlinks.Acquire(uri, id);
 }
 
 // Method Description:
@@ -3050,26 +4627,16 @@ void TextBuffer::RemoveHyperlinkFromMap(uint16_t id) noexcept
 // - The custom ID if there was one, empty string otherwise
 std::wstring TextBuffer::GetCustomIdFromId(uint16_t id) const
 {
-    for (auto customIdPair : _hyperlinkCustomIdMap)
-    {
-        if (customIdPair.second == id)
-        {
-            return customIdPair.first;
-        }
-    }
-    return {};
+    return std::wstring{ _hyperlinks.GetCustomId(id) };
 }
 
 // Method Description:
-// - Copies the hyperlink/customID maps of the old buffer into this one,
-//   also copies currentHyperlinkId
+// - Copies the hyperlink table of the old buffer into this one
 // Arguments:
 // - The other buffer
 void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
 {
-    _hyperlinkMap = other._hyperlinkMap;
-    _hyperlinkCustomIdMap = other._hyperlinkCustomIdMap;
-    _currentHyperlinkId = other._currentHyperlinkId;
+    _hyperlinks = other._hyperlinks;
 }
 
 // Searches through the entire (committed) text buffer for `needle` and returns the coordinates in absolute coordinates.
@@ -3079,6 +4646,66 @@ std::optional<std::vector<til::point_span>> TextBuffer::SearchText(const std::ws
     return SearchText(needle, flags, 0, til::CoordTypeMax);
 }
 
+// SearchText() for case-sensitive, literal needles, without ICU. ICU would find the same matches, but this avoids
+// compiling a pattern and it lets std::wstring_view::find() compare the text in bulk instead of one code point at a
+// time. Just like in the UText that ICU searches, rows that were wrapped by us are joined with the next one.
+// The needle must not contain line breaks, which the UText would insert between the other rows.
+static void searchLiteral(const TextBuffer& buffer, const std::wstring_view& needle, til::CoordType rowBeg, til::CoordType rowEnd, std::vector<til::point_span>& results)
+{
+    // The rows of the current line, each with the offset of its text in the line.
+    std::vector<std::pair<til::CoordType, size_t>> rows;
+    std::wstring joined;
+
+    const auto toPoint = [&](size_t offset, bool trailing) {
+        // The last row that starts at or before `offset` contains it. Rows without text start where the next one does.
+        auto it = std::upper_bound(rows.begin(), rows.end(), offset, [](size_t off, const auto& r) { return off < r.second; });
+        --it;
+        const auto& row = buffer.GetRowByOffset(it->first);
+        const auto charOffset = gsl::narrow_cast<ptrdiff_t>(offset - it->second);
+        const auto x = trailing ? row.GetTrailingColumnAtCharOffset(charOffset) : row.GetLeadingColumnAtCharOffset(charOffset);
+        return til::point{ x, it->first };
+    };
+
+    for (auto y = rowBeg; y < rowEnd;)
+    {
+        rows.clear();
+        size_t length = 0;
+
+        for (; y < rowEnd;)
+        {
+            const auto& row = buffer.GetRowByOffset(y);
+            rows.emplace_back(y, length);
+            length += row.GetText().size();
+            ++y;
+            if (!row.WasWrapForced())
+            {
+                break;
+            }
+        }
+
+        // Most lines fit into a single row, which we can search without copying it.
+        std::wstring_view line;
+        if (rows.size() == 1)
+        {
+            line = buffer.GetRowByOffset(rows.front().first).GetText();
+        }
+        else
+        {
+            joined.clear();
+            for (const auto& r : rows)
+            {
+                joined.append(buffer.GetRowByOffset(r.first).GetText());
+            }
+            line = joined;
+        }
+
+        for (auto pos = line.find(needle); pos != std::wstring_view::npos; pos = line.find(needle, pos + needle.size()))
+        {
+            results.emplace_back(til::point_span{ toPoint(pos, false), toPoint(pos + needle.size() - 1, true) });
+        }
+    }
+}
+
 // Searches through the given rows [rowBeg,rowEnd) for `needle` and returns the coordinates in absolute coordinates.
 // While the end coordinates of the returned ranges are considered inclusive, the [rowBeg,rowEnd) range is half-open.
 // Returns nullopt if the parameters were invalid (e.g. regex search was requested with an invalid regex)
@@ -3094,6 +4721,16 @@ std::optional<std::vector<til::point_span>> TextBuffer::SearchText(const std::ws
         return results;
     }
 
+    // ICU matches code points, so a needle that starts or ends in the middle of a surrogate pair is left to it.
+    if (WI_AreAllFlagsClear(flags, SearchFlag::CaseInsensitive | SearchFlag::RegularExpression) &&
+        needle.find(L'\n') == std::wstring_view::npos &&
+        !til::is_trailing_surrogate(needle.front()) &&
+        !til::is_leading_surrogate(needle.back()))
+    {
+        searchLiteral(*this, needle, rowBeg, rowEnd, results);
+        return results;
+    }
+
     auto text = ICU::UTextFromTextBuffer(*this, rowBeg, rowEnd);
 
     uint32_t icuFlags{ 0 };
@@ -3109,7 +4746,7 @@ std::optional<std::vector<til::point_span>> TextBuffer::SearchText(const std::ws
     }
 
     UErrorCode status = U_ZERO_ERROR;
-    const auto re = ICU::CreateRegex(needle, icuFlags, &status);
+    const auto re = ICU::InternRegex(needle, icuFlags, &status);
     if (status > U_ZERO_ERROR)
     {
         return std::nullopt;
@@ -3133,15 +4770,9 @@ std::optional<std::vector<til::point_span>> TextBuffer::SearchText(const std::ws
 std::vector<ScrollMark> TextBuffer::GetMarkRows() const
 {
     std::vector<ScrollMark> marks;
-    const auto bottom = _estimateOffsetOfLastCommittedRow();
-    for (auto y = 0; y <= bottom; y++)
+    for (const auto y : _getMarkedRows())
     {
-        const auto& row = GetRowByOffset(y);
-        const auto& data{ row.GetScrollbarData() };
-        if (data.has_value())
-        {
-            marks.emplace_back(y, *data);
-        }
+        marks.emplace_back(y, *_getScrollbarData(y));
     }
     return marks;
 }
@@ -3162,17 +4793,11 @@ std::vector<MarkExtents> TextBuffer::GetMarkExtents(size_t limit) const
     }
 
     std::vector<MarkExtents> marks{};
-    const auto bottom = _estimateOffsetOfLastCommittedRow();
-    auto lastPromptY = bottom;
-    for (auto promptY = bottom; promptY >= 0; promptY--)
+    const auto rows = _getMarkedRows();
+    auto lastPromptY = _estimateOffsetOfLastCommittedRow();
+    for (auto it = rows.rbegin(); it != rows.rend(); ++it)
     {
-        const auto& currRow = GetRowByOffset(promptY);
-        auto& rowPromptData = currRow.GetScrollbarData();
-        if (!rowPromptData.has_value())
-        {
-            // This row didn't start a prompt, don't even look here.
-            continue;
-        }
+        const auto promptY = *it;
 
         // Future thought! In #11000 & #14792, we considered the possibility of
         // scrolling to only an error mark, or something like that. Perhaps in
@@ -3182,7 +4807,7 @@ std::vector<MarkExtents> TextBuffer::GetMarkExtents(size_t limit) const
         // For now, skip any "Default" marks, since those came from the UI. We
         // just want the ones that correspond to shell integration.
 
-        if (rowPromptData->category == MarkCategory::Default)
+        if (_getScrollbarData(promptY)->category == MarkCategory::Default)
         {
             continue;
         }
@@ -3190,7 +4815,7 @@ std::vector<MarkExtents> TextBuffer::GetMarkExtents(size_t limit) const
         // This row did start a prompt! Find the prompt that starts here.
         // Presumably, no rows below us will have prompts, so pass in the last
         // row with text as the bottom
-        marks.push_back(_scrollMarkExtentForRow(promptY, lastPromptY));
+        marks.push_back(_cachedScrollMarkExtentForRow(promptY, lastPromptY));
 
         // operator>=(T, optional<U>) will return true if the optional is
         // nullopt, unfortunately.
@@ -3203,9 +4828,65 @@ std::vector<MarkExtents> TextBuffer::GetMarkExtents(size_t limit) const
     }
 
     std::reverse(marks.begin(), marks.end());
+
+    // Drop the entries of prompts that are gone, the same way _addMarkRow() prunes _markOffsets.
+    if (_markExtentsCache.size() > _markOffsets.size())
+    {
+        std::erase_if(_markExtentsCache, [&](const auto& entry) { return !_isMarkOffsetLive(entry.promptOffset); });
+    }
+
     return marks;
 }
 
+// Returns the plain text of the given command's output, without the prompt and the command line.
+std::wstring TextBuffer::GetCommandOutput(const MarkExtents& mark) const
+{
+    if (!mark.HasOutput())
+    {
+        return {};
+    }
+
+    // outputEnd is exclusive, but GetPlainText() wants an inclusive end.
+    auto end = *mark.outputEnd;
+    GetSize().DecrementInBounds(end);
+    return GetPlainText(*mark.commandEnd, end);
+}
+
+// Searches the output of the last `limit` prompts (see GetMarkExtents()). Unlike SearchText(), this only
+// iterates over the rows of their output, which is what you want to navigate long build logs, for instance.
+// Returns nullopt if the needle is an invalid regular expression.
+std::optional<std::vector<til::point_span>> TextBuffer::SearchCommandOutputs(const std::wstring_view& needle, SearchFlag flags, size_t limit) const
+{
+    std::vector<til::point_span> results;
+
+    for (const auto& mark : GetMarkExtents(limit))
+    {
+        if (!mark.HasOutput())
+        {
+            continue;
+        }
+
+        const auto beg = *mark.commandEnd;
+        const auto end = *mark.outputEnd;
+        const auto found = SearchText(needle, flags, beg.y, end.y + 1);
+        if (!found)
+        {
+            return std::nullopt;
+        }
+
+        // The first and last row may be shared with the command line and the next prompt.
+        for (const auto& span : *found)
+        {
+            if (span.start >= beg && span.end < end)
+            {
+                results.emplace_back(span);
+            }
+        }
+    }
+
+    return results;
+}
+
 // Remove all marks between `start` & `end`, inclusive.
 void TextBuffer::ClearMarksInRange(
     const til::point start,
@@ -3219,15 +4900,19 @@ void TextBuffer::ClearMarksInRange(
         auto& row = GetMutableRowByOffset(y);
         auto& runs = row.Attributes().runs();
         row.SetScrollbarData(std::nullopt);
-        for (auto& [attr, length] : runs)
+        for (auto& [attrId, length] : runs)
         {
+            auto attr = _attrTable->Get(attrId);
             attr.SetMarkAttributes(MarkKind::None);
+            attrId = _attrTable->Intern(attr);
         }
     }
 }
 void TextBuffer::ClearAllMarks()
 {
     ClearMarksInRange({ 0, 0 }, { _width - 1, _height - 1 });
+    _markOffsets.clear();
+    _markExtentsCache.clear();
 }
 
 // Collect up the extent of the prompt and possibly command and output for the
@@ -3275,10 +4960,10 @@ MarkExtents TextBuffer::_scrollMarkExtentForRow(const til::CoordType rowOffset,
         const auto& row = GetRowByOffset(y);
         const auto runs = row.Attributes().runs();
         x = 0;
-        for (const auto& [attr, length] : runs)
+        for (const auto& [attrId, length] : runs)
         {
             const auto nextX = gsl::narrow_cast<uint16_t>(x + length);
-            const auto markKind{ attr.GetMarkAttributes() };
+            const auto markKind{ _attrTable->Get(attrId).GetMarkAttributes() };
 
             if (markKind != MarkKind::None)
             {
@@ -3335,6 +5020,74 @@ MarkExtents TextBuffer::_scrollMarkExtentForRow(const til::CoordType rowOffset,
     return mark;
 }
 
+// Same as _scrollMarkExtentForRow(), but cached in _markExtentsCache.
+MarkExtents TextBuffer::_cachedScrollMarkExtentForRow(const til::CoordType rowOffset, const til::CoordType bottomInclusive) const
+{
+    const auto promptOffset = gsl::narrow_cast<uint32_t>(_getOffset(rowOffset));
+    const auto rowCount = bottomInclusive - rowOffset + 1;
+
+    const auto offsetRows = [](MarkExtents mark, til::CoordType dy) {
+        mark.start.y += dy;
+        mark.end.y += dy;
+        if (mark.commandEnd)
+        {
+            mark.commandEnd->y += dy;
+        }
+        if (mark.outputEnd)
+        {
+            mark.outputEnd->y += dy;
+        }
+        return mark;
+    };
+
+    auto it = std::lower_bound(_markExtentsCache.begin(), _markExtentsCache.end(), promptOffset, [](const auto& entry, uint32_t offset) {
+        return entry.promptOffset < offset;
+    });
+    if (it != _markExtentsCache.end() && it->promptOffset == promptOffset &&
+        it->rowCount == rowCount && _rowsUnchangedSince(rowOffset, bottomInclusive + 1, it->revision))
+    {
+        return offsetRows(it->extents, rowOffset);
+    }
+
+    const auto mark = _scrollMarkExtentForRow(rowOffset, bottomInclusive);
+
+    if (it == _markExtentsCache.end() || it->promptOffset != promptOffset)
+    {
+        it = _markExtentsCache.emplace(it);
+    }
+    *it = { promptOffset, rowCount, _lastMutationId, offsetRows(mark, -rowOffset) };
+    return mark;
+}
+
+// Returns true if none of the rows in [beg, end) were modified after the given revision.
+bool TextBuffer::_rowsUnchangedSince(const til::CoordType beg, const til::CoordType end, const uint64_t revision) const noexcept
+{
+    const auto offsetEnd = _rowRevisions.size();
+
+    for (auto y = beg; y < end;)
+    {
+        const auto offset = _getOffset(y);
+        const auto block = offset / _revisionBlockSize;
+
+        // Same as in GetRowsChangedSince(): Skip over the rest of unchanged blocks.
+        if (til::at(_blockRevisions, block) <= revision)
+        {
+            const auto blockEnd = std::min((block + 1) * _revisionBlockSize, offsetEnd);
+            y += gsl::narrow_cast<til::CoordType>(blockEnd - offset);
+            continue;
+        }
+
+        if (til::at(_rowRevisions, offset) > revision)
+        {
+            return false;
+        }
+
+        ++y;
+    }
+
+    return true;
+}
+
 std::wstring TextBuffer::_commandForRow(const til::CoordType rowOffset,
                                         const til::CoordType bottomInclusive,
                                         const bool clipAtCursor) const
@@ -3352,14 +5105,14 @@ std::wstring TextBuffer::_commandForRow(const til::CoordType rowOffset,
         const auto& row = GetRowByOffset(y);
         const auto runs = row.Attributes().runs();
         auto x = 0;
-        for (const auto& [attr, length] : runs)
+        for (const auto& [attrId, length] : runs)
         {
             auto nextX = gsl::narrow_cast<uint16_t>(x + length);
             if (onCursorRow)
             {
                 nextX = std::min(nextX, gsl::narrow_cast<uint16_t>(cursorPosition.x));
             }
-            const auto markKind{ attr.GetMarkAttributes() };
+            const auto markKind{ _attrTable->Get(attrId).GetMarkAttributes() };
             if (markKind != lastMarkKind)
             {
                 if (lastMarkKind == MarkKind::Command)
@@ -3391,51 +5144,35 @@ std::wstring TextBuffer::_commandForRow(const til::CoordType rowOffset,
 
 std::wstring TextBuffer::CurrentCommand() const
 {
-    auto promptY = GetCursor().GetPosition().y;
-    for (; promptY >= 0; promptY--)
+    // Find the closest prompt at or above the cursor.
+    const auto rows = _getMarkedRows();
+    const auto it = std::upper_bound(rows.begin(), rows.end(), GetCursor().GetPosition().y);
+    if (it == rows.begin())
     {
-        const auto& currRow = GetRowByOffset(promptY);
-        auto& rowPromptData = currRow.GetScrollbarData();
-        if (!rowPromptData.has_value())
-        {
-            // This row didn't start a prompt, don't even look here.
-            continue;
-        }
-
-        // This row did start a prompt! Find the prompt that starts here.
-        // Presumably, no rows below us will have prompts, so pass in the last
-        // row with text as the bottom
-        return _commandForRow(promptY, _estimateOffsetOfLastCommittedRow(), true);
+        return L"";
     }
-    return L"";
+
+    // Presumably, no rows below us will have prompts, so pass in the last
+    // row with text as the bottom
+    return _commandForRow(*std::prev(it), _estimateOffsetOfLastCommittedRow(), true);
 }
 
 std::vector<std::wstring> TextBuffer::Commands() const
 {
     std::vector<std::wstring> commands{};
+    const auto rows = _getMarkedRows();
     const auto bottom = _estimateOffsetOfLastCommittedRow();
-    auto lastPromptY = bottom;
-    for (auto promptY = bottom; promptY >= 0; promptY--)
+    for (size_t i = 0; i < rows.size(); ++i)
     {
-        const auto& currRow = GetRowByOffset(promptY);
-        auto& rowPromptData = currRow.GetScrollbarData();
-        if (!rowPromptData.has_value())
-        {
-            // This row didn't start a prompt, don't even look here.
-            continue;
-        }
-
-        // This row did start a prompt! Find the prompt that starts here.
-        // Presumably, no rows below us will have prompts, so pass in the last
-        // row with text as the bottom
-        auto foundCommand = _commandForRow(promptY, lastPromptY);
+        // Each command ends at the latest where the next prompt starts.
+        const auto promptY = til::at(rows, i);
+        const auto nextPromptY = i + 1 < rows.size() ? til::at(rows, i + 1) : bottom;
+        auto foundCommand = _commandForRow(promptY, nextPromptY);
         if (!foundCommand.empty())
         {
             commands.emplace_back(std::move(foundCommand));
         }
-        lastPromptY = promptY;
     }
-    std::reverse(commands.begin(), commands.end());
     return commands;
 }
 
@@ -3444,6 +5181,7 @@ void TextBuffer::StartPrompt()
     const auto currentRowOffset = GetCursor().GetPosition().y;
     auto& currentRow = GetMutableRowByOffset(currentRowOffset);
     currentRow.StartPrompt();
+    _addMarkRow(currentRowOffset);
 
     _currentAttributes.SetMarkAttributes(MarkKind::Prompt);
 }
@@ -3488,8 +5226,10 @@ bool TextBuffer::_createPromptMarkIfNeeded()
     //   --> add a new mark to this row, set all the attrs in this row
     //   to be Prompt, and set the current attrs to Output.
 
-    auto& row = GetMutableRowByOffset(GetCursor().GetPosition().y);
+    const auto y = GetCursor().GetPosition().y;
+    auto& row = GetMutableRowByOffset(y);
     row.StartPrompt();
+    _addMarkRow(y);
     return true;
 }
 
@@ -3512,15 +5252,11 @@ void TextBuffer::EndCurrentCommand(std::optional<unsigned int> error)
 {
     _currentAttributes.SetMarkAttributes(MarkKind::None);
 
-    for (auto y = GetCursor().GetPosition().y; y >= 0; y--)
+    const auto rows = _getMarkedRows();
+    const auto it = std::upper_bound(rows.begin(), rows.end(), GetCursor().GetPosition().y);
+    if (it != rows.begin())
     {
-        auto& currRow = GetMutableRowByOffset(y);
-        auto& rowPromptData = currRow.GetScrollbarData();
-        if (rowPromptData.has_value())
-        {
-            currRow.EndOutput(error);
-            return;
-        }
+        GetMutableRowByOffset(*std::prev(it)).EndOutput(error);
     }
 }
 
@@ -3528,12 +5264,78 @@ void TextBuffer::SetScrollbarData(ScrollbarData mark, til::CoordType y)
 {
     auto& row = GetMutableRowByOffset(y);
     row.SetScrollbarData(mark);
+    _addMarkRow(y);
+}
+
+// Records that the given row has ScrollbarData in _markOffsets.
+// This needs to be called after the ScrollbarData has been set on the ROW.
+void TextBuffer::_addMarkRow(const til::CoordType y)
+{
+    const auto offset = gsl::narrow_cast<uint32_t>(_getOffset(y));
+    const auto it = std::lower_bound(_markOffsets.begin(), _markOffsets.end(), offset);
+    if (it != _markOffsets.end() && *it == offset)
+    {
+        return;
+    }
+
+    _markOffsets.insert(it, offset);
+
+    // Drop the stale entries once in a while, so that they don't slow down _getMarkedRows().
+    if (_markOffsets.size() >= _markOffsetsPruneSize)
+    {
+        std::erase_if(_markOffsets, [&](const uint32_t o) { return !_isMarkOffsetLive(o); });
+        _markOffsetsPruneSize = std::max<size_t>(64, _markOffsets.size() * 2);
+    }
+}
+
+// Returns true if the ROW at the given arena offset is committed and still has ScrollbarData.
+bool TextBuffer::_isMarkOffsetLive(const uint32_t offset) const
+{
+    // Checking uncommitted ROWs would commit them, and they can't have any marks anyway.
+    const auto committed = gsl::narrow_cast<size_t>((_commitWatermark - _buffer.get()) / _bufferRowStride);
+    if (offset == 0 || offset >= committed)
+    {
+        return false;
+    }
+
+    // This is the inverse of _getOffset().
+    const auto y = (gsl::narrow_cast<til::CoordType>(offset) - 1 - _firstRow + _height) % _height;
+    return _getScrollbarData(y).has_value();
+}
+
+// Returns the rows that have ScrollbarData in top-down order.
+std::vector<til::CoordType> TextBuffer::_getMarkedRows() const
+{
+    std::vector<til::CoordType> rows;
+    rows.reserve(_markOffsets.size());
+
+    for (const auto offset : _markOffsets)
+    {
+        if (_isMarkOffsetLive(offset))
+        {
+            rows.emplace_back((gsl::narrow_cast<til::CoordType>(offset) - 1 - _firstRow + _height) % _height);
+        }
+    }
+
+    // _markOffsets is sorted by the position in the memory arena, but the rows start at _firstRow.
+    const auto wrap = std::is_sorted_until(rows.begin(), rows.end());
+    std::rotate(rows.begin(), wrap, rows.end());
+    return rows;
+}
+
+// Returns the ScrollbarData of the given row without rehydrating it if it's part of the cold scrollback.
+const std::optional<ScrollbarData>& TextBuffer::_getScrollbarData(const til::CoordType y) const
+{
+    const auto packed = _getPackedRow(y);
+    return packed ? packed->promptData : GetRowByOffset(y).GetScrollbarData();
 }
 void TextBuffer::ManuallyMarkRowAsPrompt(til::CoordType y)
 {
     auto& row = GetMutableRowByOffset(y);
-    for (auto& [attr, len] : row.Attributes().runs())
+    for (auto& [attrId, len] : row.Attributes().runs())
     {
+        auto attr = _attrTable->Get(attrId);
         attr.SetMarkAttributes(MarkKind::Prompt);
+        attrId = _attrTable->Intern(attr);
     }
 }
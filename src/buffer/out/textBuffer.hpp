@@ -49,7 +49,9 @@ filling in the last row, and updating the screen.
 
 #pragma once
 
+#include "ColdScrollbackFile.hpp"
 #include "cursor.h"
+#include "HyperlinkTable.hpp"
 #include "Row.hpp"
 #include "TextAttribute.hpp"
 #include "../types/inc/Viewport.hpp"
@@ -108,6 +110,9 @@ public:
     // Text insertion functions
     void Replace(til::CoordType row, const TextAttribute& attributes, RowWriteState& state);
     void Insert(til::CoordType row, const TextAttribute& attributes, RowWriteState& state);
+    bool TryWriteCharInfos(til::point target, std::span<const CHAR_INFO> infos);
+    til::CoordType FillNarrowText(til::point target, wchar_t fill, size_t count);
+    til::CoordType FillAttributes(til::point target, const TextAttribute& attributes, size_t count);
     void FillRect(const til::rect& rect, const std::wstring_view& fill, const TextAttribute& attributes);
 
     OutputCellIterator Write(const OutputCellIterator givenIt);
@@ -129,15 +134,37 @@ public:
     Cursor& GetCursor() noexcept;
     const Cursor& GetCursor() const noexcept;
 
+    // A half-open range of rows [begin, end) in the same coordinates as GetRowByOffset().
+    struct RowRange
+    {
+        til::CoordType begin = 0;
+        til::CoordType end = 0;
+    };
+
     uint64_t GetLastMutationId() const noexcept;
+    uint64_t GetRowRevision(til::CoordType y) const noexcept;
+    size_t GetRowContentHash(til::CoordType y) const;
+    std::vector<RowRange> GetRowsChangedSince(uint64_t revision) const;
     const til::CoordType GetFirstRowIndex() const noexcept;
 
     const Microsoft::Console::Types::Viewport GetSize() const noexcept;
 
     void ScrollRows(const til::CoordType firstRow, const til::CoordType size, const til::CoordType delta);
     void CopyRow(const til::CoordType srcRow, const til::CoordType dstRow, TextBuffer& dstBuffer) const;
+    bool CopyRect(const til::rect& srcRect, const til::point dstOrigin, TextBuffer& dstBuffer) const;
 
     til::CoordType TotalRowCount() const noexcept;
+    size_t GetCommittedBytes() const noexcept;
+
+    void SetColdScrollbackThreshold(til::CoordType rows) noexcept;
+    til::CoordType GetColdScrollbackThreshold() const noexcept;
+    void SetColdScrollbackFileBacked(bool enabled) noexcept;
+    bool IsColdScrollbackFileBacked() const noexcept;
+    void CompactRowsAbove(til::CoordType y) noexcept;
+
+    void SetRetainedScrollbackSize(size_t bytes) noexcept;
+    size_t GetRetainedScrollbackSize() const noexcept;
+    std::wstring GetRetainedScrollbackText() const;
 
     const TextAttribute& GetCurrentAttributes() const noexcept;
 
@@ -155,6 +182,7 @@ public:
     til::point BufferToScreenPosition(const til::point position) const;
 
     void Reset() noexcept;
+    void Recycle(const TextAttribute& defaultAttributes, const UINT cursorSize) noexcept;
     void ClearScrollback(const til::CoordType start, const til::CoordType height);
 
     void ResizeTraditional(const til::size newSize);
@@ -170,6 +198,8 @@ public:
     void TriggerScroll();
     void TriggerScroll(const til::point delta);
     void TriggerNewTextNotification(const std::wstring_view newText);
+    void StartRedrawBatch() noexcept;
+    void EndRedrawBatch() noexcept;
 
     til::point GetWordStart(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode = false, std::optional<til::point> limitOptional = std::nullopt) const;
     til::point GetWordEnd(const til::point target, const std::wstring_view wordDelimiters, bool accessibilityMode = false, std::optional<til::point> limitOptional = std::nullopt) const;
@@ -183,11 +213,11 @@ public:
 
     const std::vector<til::inclusive_rect> GetTextRects(til::point start, til::point end, bool blockSelection, bool bufferCoordinates) const;
     std::vector<til::point_span> GetTextSpans(til::point start, til::point end, bool blockSelection, bool bufferCoordinates) const;
+    void GetTextSpans(til::point start, til::point end, bool blockSelection, bool bufferCoordinates, std::vector<til::point_span>& textSpans) const;
 
     void AddHyperlinkToMap(std::wstring_view uri, uint16_t id);
     std::wstring GetHyperlinkUriFromId(uint16_t id) const;
     uint16_t GetHyperlinkId(std::wstring_view uri, std::wstring_view id);
-    void RemoveHyperlinkFromMap(uint16_t id) noexcept;
     std::wstring GetCustomIdFromId(uint16_t id) const;
     void CopyHyperlinkMaps(const TextBuffer& OtherBuffer);
 
@@ -264,7 +294,7 @@ public:
         }
     };
 
-    std::wstring GetPlainText(const CopyRequest& req) const;
+    std::wstring GetPlainText(const CopyRequest& req, size_t maxLength = SIZE_MAX) const;
 
     std::wstring GetWithControlSequences(const CopyRequest& req) const;
 
@@ -283,6 +313,10 @@ public:
                        std::function<std::tuple<COLORREF, COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors) const noexcept;
 
     void SerializeToPath(const wchar_t* destination) const;
+    std::vector<std::byte> SerializeImage() const;
+    void SerializeImageToPath(const wchar_t* destination) const;
+    static std::optional<til::size> GetImageSize(std::span<const std::byte> image) noexcept;
+    void LoadImage(std::span<const std::byte> image);
 
     struct PositionInformation
     {
@@ -298,6 +332,8 @@ public:
     // Mark handling
     std::vector<ScrollMark> GetMarkRows() const;
     std::vector<MarkExtents> GetMarkExtents(size_t limit = SIZE_T_MAX) const;
+    std::wstring GetCommandOutput(const MarkExtents& mark) const;
+    std::optional<std::vector<til::point_span>> SearchCommandOutputs(const std::wstring_view& needle, SearchFlag flags, size_t limit) const;
     void ClearMarksInRange(const til::point start, const til::point end);
     void ClearAllMarks();
     std::wstring CurrentCommand() const;
@@ -313,24 +349,44 @@ private:
     void _reserve(til::size screenBufferSize, const TextAttribute& defaultAttributes);
     void _commit(const std::byte* row);
     void _decommit() noexcept;
+    void _decommitFrom(size_t offset);
+    void _markAllRowsChanged() noexcept;
     void _construct(const std::byte* until) noexcept;
     void _destroy() const noexcept;
     ROW& _getRowByOffsetDirect(size_t offset);
     ROW& _getRow(til::CoordType y) const;
     til::CoordType _estimateOffsetOfLastCommittedRow() const noexcept;
+    size_t _getOffset(til::CoordType y) const noexcept;
+    size_t _chunkRows(size_t chunk) const noexcept;
+    const PackedRow* _getPackedRow(til::CoordType y) const noexcept;
+    void _compactColdRows(const std::byte* keep, size_t rowsAdvanced) noexcept;
+    void _evictChunksAbove(til::CoordType coldLimit, size_t keepChunk);
+    void _evictChunk(size_t chunk);
+    void _spillChunk(size_t chunk, PackedRow* packed, size_t rows);
+    void _rehydrateChunk(size_t chunk);
+    void _sweepAttributes() noexcept;
+    static void _reflowParallel(const TextBuffer& oldBuffer, TextBuffer& newBuffer, til::CoordType& oldY, til::CoordType oldEnd, til::CoordType& newY, til::CoordType& newX);
+    template<typename Func>
+    til::CoordType _forEachSpanFrom(til::point target, size_t count, Func&& func);
 
     void _SetFirstRowIndex(const til::CoordType FirstRowIndex) noexcept;
     void _ExpandTextRow(til::inclusive_rect& selectionRow) const;
-    DelimiterClass _GetDelimiterClassAt(const til::point pos, const std::wstring_view wordDelimiters) const;
-    til::point _GetWordStartForAccessibility(const til::point target, const std::wstring_view wordDelimiters) const;
-    til::point _GetWordStartForSelection(const til::point target, const std::wstring_view wordDelimiters) const;
-    til::point _GetWordEndForAccessibility(const til::point target, const std::wstring_view wordDelimiters, const til::point limit) const;
-    til::point _GetWordEndForSelection(const til::point target, const std::wstring_view wordDelimiters) const;
-    void _PruneHyperlinks();
+    DelimiterClass _GetDelimiterClassAt(const til::point pos, const DelimiterSet& wordDelimiters) const;
+    til::point _GetWordStartForAccessibility(const til::point target, const DelimiterSet& wordDelimiters) const;
+    til::point _GetWordStartForSelection(const til::point target, const DelimiterSet& wordDelimiters) const;
+    til::point _GetWordEndForAccessibility(const til::point target, const DelimiterSet& wordDelimiters, const til::point limit) const;
+    til::point _GetWordEndForSelection(const til::point target, const DelimiterSet& wordDelimiters) const;
+    void _FlushRedrawBatch();
 
     std::wstring _commandForRow(const til::CoordType rowOffset, const til::CoordType bottomInclusive, const bool clipAtCursor = false) const;
     MarkExtents _scrollMarkExtentForRow(const til::CoordType rowOffset, const til::CoordType bottomInclusive) const;
+    MarkExtents _cachedScrollMarkExtentForRow(til::CoordType rowOffset, til::CoordType bottomInclusive) const;
+    bool _rowsUnchangedSince(til::CoordType beg, til::CoordType end, uint64_t revision) const noexcept;
     bool _createPromptMarkIfNeeded();
+    void _addMarkRow(til::CoordType y);
+    bool _isMarkOffsetLive(uint32_t offset) const;
+    std::vector<til::CoordType> _getMarkedRows() const;
+    const std::optional<ScrollbarData>& _getScrollbarData(til::CoordType y) const;
 
     std::tuple<til::CoordType, til::CoordType, bool> _RowCopyHelper(const CopyRequest& req, const til::CoordType iRow, const ROW& row) const;
 
@@ -340,9 +396,12 @@ private:
 
     Microsoft::Console::Render::Renderer* _renderer = nullptr;
 
-    std::unordered_map<uint16_t, std::wstring> _hyperlinkMap;
-    std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
-    uint16_t _currentHyperlinkId = 1;
+    // The URIs of the OSC 8 hyperlinks referenced by the TextAttributes. Swept along with _attrTable.
+    HyperlinkTable _hyperlinks;
+
+    // Interns the TextAttributes of all ROWs. It's heap allocated, because ROWs hold a pointer to it
+    // and ResizeTraditional() moves it over from a temporary TextBuffer.
+    std::unique_ptr<TextAttributeTable> _attrTable;
 
     // This block describes the state of the underlying virtual memory buffer that holds all ROWs, text and attributes.
     // Initially memory is only allocated with MEM_RESERVE to reduce the private working set of conhost.
@@ -396,18 +455,94 @@ private:
     size_t _bufferRowStride = 0;
     size_t _bufferOffsetChars = 0;
     size_t _bufferOffsetCharOffsets = 0;
+    // The cold scrollback tier: If _coldRowThreshold is greater than 0, ROWs that are more than that many rows
+    // above the cursor get packed into PackedRows and their memory is MEM_DECOMMIT'd. This happens in chunks of
+    // _chunkRowCount rows, which is chosen so that each chunk spans a whole number of pages. _coldChunks has
+    // one slot per chunk, which is non-null if the chunk has been evicted, and _getRowByOffsetDirect()
+    // transparently rehydrates such chunks whenever one of their rows is accessed again.
+    //
+    // Evicting happens at most once every _chunkRowCount new rows, whenever we MEM_COMMIT more memory or rotate
+    // the circular buffer. In other words, a reference to a cold ROW may get invalidated whenever a not yet
+    // committed ROW is accessed or IncrementCircularBuffer() is called. The chunk containing the ROW that
+    // caused the commit is never evicted, nor is the first one, which contains the scratchpad row.
+    std::vector<std::unique_ptr<PackedRow[]>> _coldChunks;
+    // If _coldFileBacked is true, the text of evicted chunks is moved into the memory-mapped _coldFile,
+    // which is created once the first chunk gets evicted. _coldAllocations holds one slot per chunk.
+    std::unique_ptr<ColdScrollbackFile> _coldFile;
+    std::vector<ColdScrollbackFile::Allocation> _coldAllocations;
+    bool _coldFileBacked = false;
+    size_t _coldChunkCount = 0;
+    size_t _chunkRowCount = 0;
+    size_t _rowsUntilCompaction = 0;
+    // Whoever rehydrated a chunk most likely still holds a reference to one of its ROWs. It's exempt from eviction.
+    size_t _lastRehydratedChunk = SIZE_MAX;
+    til::CoordType _coldRowThreshold = 0;
+
+    // Once the scrollback is full, IncrementCircularBuffer() recycles the oldest row. If _retainedRowsBudget
+    // is non-zero, the text of recycled rows that belong to a failed command or follow a bookmark is moved into
+    // _retainedRows instead of being lost, up to _retainedRowsBudget bytes, after which the oldest ones go.
+    // Consecutive identical rows (like the same warning printed a thousand times) are stored once.
+    struct RetainedRow
+    {
+        PackedRow text;
+        // How many more times this row was repeated, immediately after itself.
+        size_t repeats = 0;
+
+        // What a row counts against _retainedRowsBudget. Blank rows aren't free either.
+        size_t Size() const noexcept
+        {
+            return sizeof(RetainedRow) + text.DataSize();
+        }
+    };
+    void _retainRow(const ROW& row);
+    std::deque<RetainedRow> _retainedRows;
+    size_t _retainedRowsSize = 0;
+    size_t _retainedRowsBudget = 0;
+    // Whether the rows that get recycled currently belong to a failed command or a bookmark.
+    bool _retainingRows = false;
     // The width of the buffer in columns.
     uint16_t _width = 0;
     // The height of the buffer in rows, excluding the scratchpad row.
     uint16_t _height = 0;
 
     TextAttribute _currentAttributes;
+    // The text written by TryWriteCharInfos() and FillNarrowText(). It's a member so that its capacity is reused.
+    std::wstring _narrowText;
     til::CoordType _firstRow = 0; // indexes top row (not necessarily 0)
     uint64_t _lastMutationId = 0;
+    // The value of _lastMutationId when a ROW was last handed out by GetMutableRowByOffset(), indexed by its offset
+    // in the memory arena (see _getOffset()). _blockRevisions holds the maximum revision of every _revisionBlockSize
+    // consecutive ROWs, which allows GetRowsChangedSince() to skip over unchanged parts of the scrollback quickly.
+    static constexpr size_t _revisionBlockSize = 64;
+    std::vector<uint64_t> _rowRevisions;
+    std::vector<uint64_t> _blockRevisions;
+    // The arena offsets (see _getOffset()) of all ROWs that may have ScrollbarData, sorted and unique.
+    // Marks are only ever added through TextBuffer, but ROWs lose them in many ways (Reset(), scrolling out of
+    // the circular buffer, ...), so entries may be stale and are checked whenever they're used. This keeps
+    // the scrollbar marks and the command history at O(marks) instead of scanning the entire scrollback.
+    std::vector<uint32_t> _markOffsets;
+    size_t _markOffsetsPruneSize = 64;
+    // The results of _scrollMarkExtentForRow(), which has to iterate over the attributes of every row of a command
+    // and its output (and rehydrate them if they're in the cold scrollback), sorted by the arena offset of the prompt.
+    // An entry is valid as long as none of its rows changed since (see _rowRevisions) and the next prompt didn't move.
+    // Its coordinates are relative to the prompt's row, so that they survive the rotation of the circular buffer.
+    struct CachedMarkExtents
+    {
+        uint32_t promptOffset = 0;
+        til::CoordType rowCount = 0;
+        uint64_t revision = 0;
+        MarkExtents extents;
+    };
+    mutable std::vector<CachedMarkExtents> _markExtentsCache;
 
     Cursor _cursor;
     bool _isActiveBuffer = false;
 
+    // See StartRedrawBatch(). _batchedRedraw is in buffer coordinates after applying _batchedScroll.
+    til::rect _batchedRedraw;
+    til::point _batchedScroll;
+    uint32_t _redrawBatchDepth = 0;
+
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     friend class UiaTextRangeTests;
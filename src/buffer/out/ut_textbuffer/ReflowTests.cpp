@@ -599,6 +599,37 @@ namespace
                 },
             },
         },
+        TestCase{
+            // The rows above the cursor wrap into more rows than fit into the buffer.
+            // Reflow skips the ones that end up being overwritten, which must not change the result.
+            L"DBCS, cursor at end of buffer, with circling, with original wrap",
+            {
+                TestBuffer{
+                    { 6, 5 },
+                    {
+                        //--0123456--
+                        { L"ABCDEF", false },
+                        { L"カタカ", true }, // KA TA KA
+                        { L"ナGH  ", false }, // NA
+                        { L"IJKLMN", false },
+                        { L"$     ", false },
+                    },
+                    { 0, 4 }, // cursor on $
+                },
+                TestBuffer{
+                    { 5, 5 }, // reduce width by 1
+                    {
+                        //--012345--
+                        { L"カナG", true }, // KA NA
+                        { L"H    ", false },
+                        { L"IJKLM", true },
+                        { L"N    ", false },
+                        { L"$    ", false },
+                    },
+                    { 0, 4 }, // cursor on $
+                },
+            },
+        },
     };
 
 #pragma region TAEF hookup for the test case array above
@@ -805,6 +836,62 @@ class ReflowTests
             _compareTextBufferAgainstTestBuffer(*textBuffer, testBuffer);
         }
     }
+
+    TEST_METHOD(TestReflowLargeBuffer)
+    {
+        // Enough rows for Reflow() to split them up across multiple threads.
+        static constexpr til::CoordType height = 9001;
+        static constexpr til::CoordType lineCount = 5000;
+
+        WEX::TestExecution::DisableVerifyExceptions disableVerifyExceptions{};
+        WEX::TestExecution::SetVerifyOutput verifyOutputScope{ WEX::TestExecution::VerifyOutputSettings::LogOnlyFailures };
+
+        const auto lineText = [](til::CoordType i) {
+            std::wstring text;
+            for (til::CoordType j = 0, length = (i * 7) % 45 + 1; j < length; ++j)
+            {
+                text.push_back(static_cast<wchar_t>(L'a' + (i + j) % 26));
+            }
+            return text;
+        };
+
+        TextBuffer oldBuffer{ { 20, height }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        til::CoordType y = 0;
+        for (til::CoordType i = 0; i < lineCount; ++i)
+        {
+            const auto text = lineText(i);
+            for (size_t x = 0; x < text.size(); x += 20)
+            {
+                auto& row = oldBuffer.GetMutableRowByOffset(y++);
+                RowWriteState state{
+                    .text = std::wstring_view{ text }.substr(x, 20),
+                    .columnLimit = 20,
+                };
+                row.ReplaceText(state);
+                row.SetWrapForced(x + 20 < text.size());
+            }
+        }
+        oldBuffer.GetCursor().SetPosition({ 0, y });
+
+        TextBuffer newBuffer{ { 30, height }, TextAttribute{ 0x7 }, 0, false, &renderer };
+        TextBuffer::Reflow(oldBuffer, newBuffer);
+
+        y = 0;
+        for (til::CoordType i = 0; i < lineCount; ++i)
+        {
+            std::wstring actual;
+            for (auto wrapped = true; wrapped;)
+            {
+                const auto& row = newBuffer.GetRowByOffset(y++);
+                actual.append(row.GetText());
+                wrapped = row.WasWrapForced();
+            }
+            actual.erase(actual.find_last_not_of(L' ') + 1);
+
+            VERIFY_ARE_EQUAL(lineText(i), actual, NoThrowString().Format(L"[Line %d]", i));
+        }
+        VERIFY_ARE_EQUAL(til::point(0, y), newBuffer.GetCursor().GetPosition());
+    }
 };
 
 DummyRenderer ReflowTests::renderer{};
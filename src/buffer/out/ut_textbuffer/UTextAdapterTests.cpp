@@ -61,4 +61,57 @@ class UTextAdapterTests
         actual = buffer.SearchText(L"ネコ", SearchFlag::None);
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(WrappedRows)
+    {
+        DummyRenderer renderer;
+        TextBuffer buffer{ til::size{ 8, 4 }, TextAttribute{}, 0, false, &renderer };
+
+        static constexpr std::wstring_view rows[]{ L"xxxxx12-", L"34 12-34", L"12-34" };
+        for (til::CoordType y = 0; y < 3; ++y)
+        {
+            RowWriteState state{
+                .text = til::at(rows, y),
+            };
+            buffer.Replace(y, TextAttribute{}, state);
+        }
+        buffer.GetMutableRowByOffset(0).SetWrapForced(true);
+
+        const auto expected = std::vector<til::point_span>{
+            { { 5, 0 }, { 1, 1 } },
+            { { 3, 1 }, { 7, 1 } },
+            { { 0, 2 }, { 4, 2 } },
+        };
+
+        // A case-sensitive literal search doesn't use ICU, but it must find the same matches.
+        // The needle has no letters, so the case-insensitive search (which does use ICU) is equivalent.
+        auto actual = buffer.SearchText(L"12-34", SearchFlag::None);
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        actual = buffer.SearchText(L"12-34", SearchFlag::CaseInsensitive);
+        VERIFY_ARE_EQUAL(expected, actual);
+    }
+
+    TEST_METHOD(ManyRows)
+    {
+        // Enough rows for the UText to span many chunks, which grow as ICU scans the buffer.
+        static constexpr til::CoordType height = 2000;
+
+        DummyRenderer renderer;
+        TextBuffer buffer{ til::size{ 12, height }, TextAttribute{}, 0, false, &renderer };
+
+        std::vector<til::point_span> expected;
+        for (til::CoordType y = 0; y < height; ++y)
+        {
+            const auto x = y % 7;
+            RowWriteState state{
+                .text = std::wstring(gsl::narrow_cast<size_t>(x), L'.') + L"abc",
+            };
+            buffer.Replace(y, TextAttribute{}, state);
+            expected.push_back({ { x, y }, { x + 2, y } });
+        }
+
+        const auto actual = buffer.SearchText(L"abc", SearchFlag::CaseInsensitive);
+        VERIFY_ARE_EQUAL(expected, actual);
+    }
 };
@@ -48,6 +48,16 @@ namespace
         }
         return Monarch_clsid;
     }
+
+    // The names of the kernel objects the monarch publishes itself with. Like
+    // the CLSID they're unique per branding and unpackaged install.
+    std::wstring MonarchObjectName(const std::wstring_view suffix)
+    {
+        std::wstring name{ L"WindowsTerminalMonarch-" };
+        name.append(Utils::GuidToPlainString(MonarchCLSID()));
+        name.append(suffix);
+        return name;
+    }
 }
 
 namespace winrt::Microsoft::Terminal::Remoting::implementation
@@ -103,6 +113,74 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
                                                    CLSCTX_LOCAL_SERVER,
                                                    REGCLS_MULTIPLEUSE,
                                                    &_registrationHostClass));
+        _publishRegistration();
+    }
+
+    // Method Description:
+    // - Publishes our PID in a named shared memory section and creates a named
+    //   event that's set while we accept commandlines from other processes.
+    // - This allows a new process to find out whether it can hand its
+    //   commandline to us before it loaded the settings (see IsMonarchReady)
+    //   and to allow us to take the foreground without a round-trip to us.
+    // - Both objects are destroyed by the kernel once this process exits,
+    //   so there's no way for them to outlive us.
+    void WindowManager::_publishRegistration() noexcept
+    try
+    {
+        const auto sectionName = MonarchObjectName(L"-Registration");
+        _registrationSection.reset(CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(MonarchRegistration), sectionName.c_str()));
+        THROW_LAST_ERROR_IF(!_registrationSection);
+
+        _registration.reset(static_cast<MonarchRegistration*>(MapViewOfFile(_registrationSection.get(), FILE_MAP_WRITE, 0, 0, sizeof(MonarchRegistration))));
+        THROW_LAST_ERROR_IF(!_registration);
+        _registration->pid = GetCurrentProcessId();
+
+        const auto eventName = MonarchObjectName(L"-Ready");
+        THROW_IF_FAILED(_monarchReady.create(wil::EventOptions::ManualReset, eventName.c_str()));
+        _monarchReady.SetEvent();
+    }
+    CATCH_LOG()
+
+    // Method Description:
+    // - Returns the PID the currently registered monarch published, or 0 if
+    //   there's none.
+    DWORD WindowManager::_findMonarchPid() noexcept
+    {
+        const auto sectionName = MonarchObjectName(L"-Registration");
+        const wil::unique_handle section{ OpenFileMappingW(FILE_MAP_READ, FALSE, sectionName.c_str()) };
+        if (!section)
+        {
+            return 0;
+        }
+
+        const wil::unique_mapview_ptr<MonarchRegistration> registration{ static_cast<MonarchRegistration*>(MapViewOfFile(section.get(), FILE_MAP_READ, 0, 0, sizeof(MonarchRegistration))) };
+        return registration ? registration->pid : 0;
+    }
+
+    // Method Description:
+    // - Checks whether there's a registered monarch that's accepting
+    //   commandlines, without making any COM calls. If there is one, it isn't
+    //   running in isolated mode, so the caller can propose its commandline
+    //   without having to load the settings first.
+    // Return Value:
+    // - true if the monarch's event exists and is set.
+    bool WindowManager::IsMonarchReady()
+    {
+        wil::unique_event_nothrow ready;
+        return ready.try_open(MonarchObjectName(L"-Ready").c_str(), SYNCHRONIZE) && ready.is_signaled();
+    }
+
+    // Method Description:
+    // - Called by the monarch when the settings changed, to stop (or resume)
+    //   advertising itself to processes that would otherwise skip checking
+    //   whether they should run in isolated mode.
+    // - Does nothing if we aren't the registered monarch.
+    void WindowManager::SetMonarchReady(const bool ready)
+    {
+        if (_monarchReady)
+        {
+            ready ? _monarchReady.SetEvent() : _monarchReady.ResetEvent();
+        }
     }
 
     void WindowManager::_raiseFindTargetWindowRequested(const winrt::Windows::Foundation::IInspectable& sender,
@@ -130,7 +208,16 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
             // We connected to a monarch instance, not us though. This won't hit
             // in isolated mode.
 
-            LOG_IF_FAILED(CoAllowSetForegroundWindow(winrt::get_unknown(_monarch), nullptr));
+            if (const auto pid = _findMonarchPid())
+            {
+                // Unlike CoAllowSetForegroundWindow this doesn't need a
+                // round-trip to the monarch to ask it for its PID.
+                LOG_IF_WIN32_BOOL_FALSE(AllowSetForegroundWindow(pid));
+            }
+            else
+            {
+                LOG_IF_FAILED(CoAllowSetForegroundWindow(winrt::get_unknown(_monarch), nullptr));
+            }
 
             // Send the commandline over to the monarch process
             if (_proposeToMonarch(args))
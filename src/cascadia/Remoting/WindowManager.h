@@ -43,6 +43,9 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
 
         bool DoesQuakeWindowExist();
 
+        bool IsMonarchReady();
+        void SetMonarchReady(const bool ready);
+
         safe_void_coroutine RequestMoveContent(winrt::hstring window, winrt::hstring content, uint32_t tabIndex, Windows::Foundation::IReference<Windows::Foundation::Rect> windowBounds);
         safe_void_coroutine RequestSendContent(Remoting::RequestReceiveContentArgs args);
 
@@ -53,11 +56,24 @@ namespace winrt::Microsoft::Terminal::Remoting::implementation
         til::typed_event<winrt::Windows::Foundation::IInspectable, winrt::Microsoft::Terminal::Remoting::WindowRequestedArgs> RequestNewWindow;
 
     private:
+        // The monarch publishes this in a named shared memory section, so that
+        // other processes can learn about it without any COM calls.
+        struct MonarchRegistration
+        {
+            DWORD pid;
+        };
+
         DWORD _registrationHostClass{ 0 };
         winrt::Microsoft::Terminal::Remoting::IMonarch _monarch{ nullptr };
 
+        wil::unique_handle _registrationSection;
+        wil::unique_mapview_ptr<MonarchRegistration> _registration;
+        wil::unique_event_nothrow _monarchReady;
+
         void _createMonarch();
         void _registerAsMonarch();
+        void _publishRegistration() noexcept;
+        static DWORD _findMonarchPid() noexcept;
 
         bool _proposeToMonarch(const Remoting::CommandlineArgs& args);
 
@@ -6,6 +6,7 @@
 
 #include "TerminalPage.h"
 #include "ScratchpadContent.h"
+#include "PerformanceDashboardContent.h"
 #include "../WinRTUtils/inc/WtExeUtils.h"
 #include "../../types/inc/utils.hpp"
 #include "Utils.h"
@@ -594,6 +595,15 @@ namespace winrt::TerminalApp::implementation
         args.Handled(res);
     }
 
+    void TerminalPage::_HandleToggleRenderStatistics(const IInspectable& /*sender*/,
+                                                     const ActionEventArgs& args)
+    {
+        const auto res = _ApplyToActiveControls([](auto& control) {
+            control.ToggleRenderStatistics();
+        });
+        args.Handled(res);
+    }
+
     void TerminalPage::_HandleToggleFocusMode(const IInspectable& /*sender*/,
                                               const ActionEventArgs& args)
     {
@@ -1595,6 +1605,17 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    void TerminalPage::_HandleOpenPerformanceDashboard(const IInspectable& sender,
+                                                       const ActionEventArgs& args)
+    {
+        if (Feature_PerformanceDashboardPane::IsEnabled())
+        {
+            const auto resultPane = std::make_shared<Pane>(_makePerformanceDashboardContent());
+            _SplitPane(_senderOrFocusedTab(sender), SplitDirection::Automatic, 0.5f, resultPane);
+            args.Handled(true);
+        }
+    }
+
     void TerminalPage::_HandleOpenAbout(const IInspectable& /*sender*/,
                                         const ActionEventArgs& args)
     {
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "AppLogic.h"
+#include "../inc/StartupTracing.h"
 #include "../inc/WindowingBehavior.h"
 #include "AppLogic.g.cpp"
 #include "FindTargetWindowResult.g.cpp"
@@ -126,6 +127,8 @@ namespace winrt::TerminalApp::implementation
 
     AppLogic::AppLogic()
     {
+        const ::Microsoft::Terminal::StartupStageScope startupStage{ g_hTerminalAppProvider, "AppLogic" };
+
         // For your own sanity, it's better to do setup outside the ctor.
         // If you do any setup in the ctor that ends up throwing an exception,
         // then it might look like App just failed to activate, which will
@@ -249,6 +252,8 @@ namespace winrt::TerminalApp::implementation
 
             _settings = std::move(newSettings);
 
+            winrt::Microsoft::Terminal::TerminalConnection::ConptyConnection::SetPrewarmingEnabled(_settings.GlobalSettings().PrewarmConnections());
+
             hr = _warnings.empty() ? S_OK : S_FALSE;
         }
         catch (const winrt::hresult_error& e)
@@ -334,6 +339,25 @@ namespace winrt::TerminalApp::implementation
             });
     }
 
+    // LoadAll() uses the list of fragment extensions it found during a previous launch,
+    // because querying the app extension catalog can take a long time. This revalidates
+    // that list in the background and reloads the settings if any extension changed.
+    safe_void_coroutine AppLogic::_RefreshFragmentExtensions()
+    try
+    {
+        const auto weakSelf = get_weak();
+        co_await winrt::resume_background();
+
+        if (CascadiaSettings::RefreshFragmentExtensions())
+        {
+            if (const auto self = weakSelf.get())
+            {
+                self->_reloadSettings->Run();
+            }
+        }
+    }
+    CATCH_LOG();
+
     void AppLogic::_ApplyLanguageSettingChange() noexcept
     try
     {
@@ -441,6 +465,7 @@ namespace winrt::TerminalApp::implementation
         {
             // Register for directory change notification.
             _RegisterSettingsChange();
+            _RefreshFragmentExtensions();
             return;
         }
 
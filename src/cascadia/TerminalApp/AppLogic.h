@@ -108,6 +108,7 @@ namespace winrt::TerminalApp::implementation
         [[nodiscard]] HRESULT _TryLoadSettings() noexcept;
         void _ProcessLazySettingsChanges();
         void _RegisterSettingsChange();
+        safe_void_coroutine _RefreshFragmentExtensions();
         safe_void_coroutine _DispatchReloadSettings();
 
         void _setupFolderPathEnvVar();
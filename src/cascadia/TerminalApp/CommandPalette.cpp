@@ -955,6 +955,7 @@ namespace winrt::TerminalApp::implementation
 
     void CommandPalette::_populateCommands()
     {
+        _actionFilterCache.reset();
         _allCommands.Clear();
         if (_actionMap)
         {
@@ -1101,8 +1102,7 @@ namespace winrt::TerminalApp::implementation
         }
         else if (_currentMode == CommandPaletteMode::TabSearchMode || _currentMode == CommandPaletteMode::ActionMode || _currentMode == CommandPaletteMode::CommandlineMode)
         {
-            for (const auto& action : commandsToFilter)
-            {
+            const auto filter = [&](const winrt::TerminalApp::FilteredCommand& action) {
                 // Update filter for all commands
                 // This will modify the highlighting but will also lead to re-computation of weight (and consequently sorting).
                 // Pay attention that it already updates the highlighting in the UI
@@ -1113,6 +1113,30 @@ namespace winrt::TerminalApp::implementation
                 {
                     actions.push_back(action);
                 }
+            };
+
+            // A command matches if the search text is a subsequence of its name. A command that
+            // doesn't match "ab" can't match "abc" either, so while the user keeps typing we only
+            // need to look at the commands that matched the previous search text. With a large
+            // action map this is most of them on the first keystroke and very few after that.
+            // The names of actions don't change while the palette is open, unlike those of tabs,
+            // which is why this is limited to the action mode.
+            if (_currentMode == CommandPaletteMode::ActionMode &&
+                _actionFilterCache &&
+                _actionFilterCache->source == commandsToFilter &&
+                til::starts_with(searchText, _actionFilterCache->searchText))
+            {
+                for (const auto& action : _actionFilterCache->results)
+                {
+                    filter(action);
+                }
+            }
+            else
+            {
+                for (const auto& action : commandsToFilter)
+                {
+                    filter(action);
+                }
             }
         }
 
@@ -1120,6 +1144,7 @@ namespace winrt::TerminalApp::implementation
         if (_currentMode == CommandPaletteMode::ActionMode)
         {
             std::sort(actions.begin(), actions.end(), FilteredCommand::Compare);
+            _actionFilterCache = ActionFilterCache{ searchText, commandsToFilter, actions };
         }
 
         return actions;
@@ -1180,6 +1205,7 @@ namespace winrt::TerminalApp::implementation
     // - <none>
     void CommandPalette::_updateCurrentNestedCommands(const winrt::Microsoft::Terminal::Settings::Model::Command& parentCommand)
     {
+        _actionFilterCache.reset();
         _currentNestedCommands.Clear();
         for (const auto& nameAndCommand : parentCommand.NestedCommands())
         {
@@ -78,6 +78,16 @@ namespace winrt::TerminalApp::implementation
 
         Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand> _commandsToFilter();
 
+        // The commands that matched the last search text in action mode, and
+        // the list they were picked from. See _collectFilteredActions.
+        struct ActionFilterCache
+        {
+            winrt::hstring searchText;
+            Windows::Foundation::Collections::IVector<winrt::TerminalApp::FilteredCommand> source{ nullptr };
+            std::vector<winrt::TerminalApp::FilteredCommand> results;
+        };
+        std::optional<ActionFilterCache> _actionFilterCache;
+
         bool _lastFilterTextWasEmpty{ true };
 
         void _populateCommands();
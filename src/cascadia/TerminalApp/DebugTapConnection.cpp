@@ -4,6 +4,10 @@
 #include "pch.h"
 #include "DebugTapConnection.h"
 
+#include <til/throttled_func.h>
+
+#include "DebugTapTrace.h"
+
 using namespace ::winrt::Microsoft::Terminal::TerminalConnection;
 using namespace ::winrt::Windows::Foundation;
 namespace winrt::Microsoft::TerminalApp::implementation
@@ -58,6 +62,90 @@ namespace winrt::Microsoft::TerminalApp::implementation
         ITerminalConnection _wrappedConnection;
     };
 
+    // DebugTapRecordingConnection is the low-overhead sibling of DebugTapConnection. Instead of printing the
+    // traffic into a second pane, it records it to a binary trace file (see DebugTapTrace.h), which
+    // tools/benchcat can replay. Recording only appends to a buffer; the file is written in the background.
+    class DebugTapRecordingConnection : public winrt::implements<DebugTapRecordingConnection, ITerminalConnection>
+    {
+    public:
+        DebugTapRecordingConnection(ITerminalConnection wrappedConnection, wil::unique_hfile file) :
+            _wrappedConnection{ std::move(wrappedConnection) },
+            _file{ std::move(file) }
+        {
+            _outputRevoker = _wrappedConnection.TerminalOutput(winrt::auto_revoke, [this](const winrt::hstring& str) {
+                _record(DebugTapTrace::RecordType::Output, str.data(), str.size() * sizeof(wchar_t));
+            });
+        }
+        ~DebugTapRecordingConnection()
+        {
+            _outputRevoker.revoke();
+            // Writes whatever is still pending.
+            _flush.flush();
+        }
+        void Initialize(const Windows::Foundation::Collections::ValueSet& /*settings*/) {}
+        void Start() { _wrappedConnection.Start(); }
+        void WriteInput(const winrt::array_view<const char16_t> buffer)
+        {
+            _record(DebugTapTrace::RecordType::Input, buffer.data(), buffer.size() * sizeof(char16_t));
+            _wrappedConnection.WriteInput(buffer);
+        }
+        void Resize(uint32_t rows, uint32_t columns)
+        {
+            const uint32_t size[]{ rows, columns };
+            _record(DebugTapTrace::RecordType::Resize, &size[0], sizeof(size));
+            _wrappedConnection.Resize(rows, columns);
+        }
+        void Close() { _wrappedConnection.Close(); }
+        winrt::event_token TerminalOutput(const TerminalOutputHandler& args) { return _wrappedConnection.TerminalOutput(args); };
+        void TerminalOutput(const winrt::event_token& token) noexcept { _wrappedConnection.TerminalOutput(token); };
+        winrt::event_token StateChanged(const TypedEventHandler<ITerminalConnection, IInspectable>& handler) { return _wrappedConnection.StateChanged(handler); };
+        void StateChanged(const winrt::event_token& token) noexcept { _wrappedConnection.StateChanged(token); };
+        winrt::guid SessionId() const noexcept { return _wrappedConnection.SessionId(); }
+        ConnectionState State() const noexcept { return _wrappedConnection.State(); }
+
+    private:
+        void _record(const DebugTapTrace::RecordType type, const void* data, const size_t size)
+        {
+            const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _startTime).count();
+            const DebugTapTrace::RecordHeader header{
+                .timestamp = gsl::narrow_cast<uint64_t>(timestamp),
+                .type = type,
+                .size = gsl::narrow<uint32_t>(size),
+            };
+
+            {
+                const std::lock_guard guard{ _recordsMutex };
+                _records.append(reinterpret_cast<const char*>(&header), sizeof(header));
+                _records.append(static_cast<const char*>(data), size);
+            }
+
+            _flush();
+        }
+
+        // Runs on the thread pool, one call at a time.
+        void _writeRecords()
+        {
+            {
+                const std::lock_guard guard{ _recordsMutex };
+                _writing.swap(_records);
+            }
+
+            LOG_IF_WIN32_BOOL_FALSE(WriteFile(_file.get(), _writing.data(), gsl::narrow<DWORD>(_writing.size()), nullptr, nullptr));
+            _writing.clear();
+        }
+
+        ITerminalConnection _wrappedConnection;
+        ITerminalConnection::TerminalOutput_revoker _outputRevoker;
+        wil::unique_hfile _file;
+        const std::chrono::steady_clock::time_point _startTime = std::chrono::steady_clock::now();
+
+        std::mutex _recordsMutex;
+        std::string _records;
+        // Only accessed by _writeRecords(). Swapped with _records, so that both keep their capacity.
+        std::string _writing;
+        til::throttled_func_trailing<> _flush{ std::chrono::milliseconds{ 100 }, [this]() { _writeRecords(); } };
+    };
+
     DebugTapConnection::DebugTapConnection(ITerminalConnection wrappedConnection)
     {
         _outputRevoker = wrappedConnection.TerminalOutput(winrt::auto_revoke, { this, &DebugTapConnection::_OutputHandler });
@@ -158,3 +246,15 @@ std::tuple<ITerminalConnection, ITerminalConnection> OpenDebugTapConnection(ITer
     std::tuple<ITerminalConnection, ITerminalConnection> p{ *inputSide, *debugSide };
     return p;
 }
+
+// Function Description
+// - Wraps the given connection, so that everything sent into and received from it is
+//   recorded to a new trace file at the given path. See DebugTapTrace.h for the format.
+ITerminalConnection OpenDebugTapRecording(ITerminalConnection baseConnection, const std::wstring_view path)
+{
+    using namespace winrt::Microsoft::TerminalApp::implementation;
+    wil::unique_hfile file{ CreateFileW(std::wstring{ path }.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    THROW_LAST_ERROR_IF(!file);
+    THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), &DebugTapTrace::Magic[0], sizeof(DebugTapTrace::Magic), nullptr, nullptr));
+    return winrt::make<DebugTapRecordingConnection>(std::move(baseConnection), std::move(file));
+}
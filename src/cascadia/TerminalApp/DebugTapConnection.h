@@ -45,3 +45,4 @@ namespace winrt::Microsoft::TerminalApp::implementation
 }
 
 std::tuple<winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection, winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection> OpenDebugTapConnection(winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection baseConnection);
+winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection OpenDebugTapRecording(winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection baseConnection, const std::wstring_view path);
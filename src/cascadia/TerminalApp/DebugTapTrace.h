@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+
+// The file format of the recordings made by OpenDebugTapRecording(). tools/benchcat can replay them (-t).
+//
+// A file starts with DebugTapTrace::Magic, followed by any number of records. Each record consists of a
+// RecordHeader followed by `size` bytes of payload. For RecordType::Output and RecordType::Input the payload
+// is the UTF-16 text as it passed through the connection. For RecordType::Resize it's two uint32_t:
+// the number of rows followed by the number of columns.
+namespace DebugTapTrace
+{
+    inline constexpr char Magic[8]{ 'W', 'T', 'T', 'R', 'A', 'C', 'E', '1' };
+
+    enum class RecordType : uint32_t
+    {
+        Output = 0,
+        Input = 1,
+        Resize = 2,
+    };
+
+    struct RecordHeader
+    {
+        // Microseconds since the recording started.
+        uint64_t timestamp;
+        RecordType type;
+        uint32_t size;
+    };
+}
@@ -2979,6 +2979,9 @@ void Pane::EnableBroadcast(bool enabled)
             termControl.CursorVisibility(enabled ?
                                              CursorDisplayState::Shown :
                                              CursorDisplayState::Default);
+            // Broadcasting writes the input to every pane one after another on the UI thread.
+            // Queue it instead, so that one slow connection doesn't make typing lag in all of them.
+            termControl.SetInputQueueingEnabled(enabled);
         }
         UpdateVisuals();
     }
@@ -0,0 +1,229 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "PerformanceDashboardContent.h"
+
+using namespace winrt::Windows::Foundation;
+using namespace winrt::Windows::UI::Xaml;
+using namespace winrt::Microsoft::Terminal::Settings::Model;
+using namespace winrt::Microsoft::Terminal::Control;
+
+// How often the counters are sampled. The graphs show the last HistorySize samples.
+static constexpr auto RefreshInterval = std::chrono::milliseconds{ 500 };
+static constexpr float GraphWidth = 240.0f;
+static constexpr float GraphHeight = 40.0f;
+
+namespace winrt::TerminalApp::implementation
+{
+    static Media::Brush lookupBrush(const wchar_t* key)
+    {
+        const auto res = Application::Current().Resources();
+        return res.TryLookup(winrt::box_value(key)).try_as<Media::Brush>();
+    }
+
+    PerformanceDashboardContent::PerformanceDashboardContent(ControlsProvider controls) :
+        _controls{ std::move(controls) }
+    {
+        _root = Controls::Grid{};
+        // Vertical and HorizontalAlignment are Stretch by default
+
+        _root.Background(lookupBrush(L"UnfocusedBorderBrush"));
+
+        _panel = Controls::StackPanel{};
+        _panel.Margin({ 10, 10, 10, 10 });
+        _panel.Spacing(16);
+
+        // The scroll viewer is what receives the focus, so that the pane can handle key bindings.
+        _scroller = Controls::ScrollViewer{};
+        _scroller.IsTabStop(true);
+        _scroller.Content(_panel);
+        _root.Children().Append(_scroller);
+
+        _refresh();
+
+        _timer.Interval(RefreshInterval);
+        _timer.Tick({ this, &PerformanceDashboardContent::_timerTick });
+        _timer.Start();
+    }
+
+    void PerformanceDashboardContent::UpdateSettings(const CascadiaSettings& /*settings*/)
+    {
+        // Nothing to do.
+    }
+
+    winrt::Windows::UI::Xaml::FrameworkElement PerformanceDashboardContent::GetRoot()
+    {
+        return _root;
+    }
+    winrt::Windows::Foundation::Size PerformanceDashboardContent::MinimumSize()
+    {
+        return { 1, 1 };
+    }
+    void PerformanceDashboardContent::Focus(winrt::Windows::UI::Xaml::FocusState reason)
+    {
+        _scroller.Focus(reason);
+    }
+    void PerformanceDashboardContent::Close()
+    {
+        _timer.Destroy();
+        // Don't keep the closed pane's terminals alive.
+        _entries.clear();
+        _panel.Children().Clear();
+    }
+
+    INewContentArgs PerformanceDashboardContent::GetNewTerminalArgs(const BuildStartupKind /* kind */) const
+    {
+        return BaseContentArgs(L"performanceDashboard");
+    }
+
+    winrt::hstring PerformanceDashboardContent::Icon() const
+    {
+        static constexpr std::wstring_view glyph{ L"\xe9d9" }; // Diagnostic
+        return winrt::hstring{ glyph };
+    }
+
+    winrt::Windows::UI::Xaml::Media::Brush PerformanceDashboardContent::BackgroundBrush()
+    {
+        return _root.Background();
+    }
+
+    void PerformanceDashboardContent::_timerTick(const IInspectable& /*sender*/, const IInspectable& /*e*/)
+    {
+        _refresh();
+    }
+
+    // Method Description:
+    // - Synchronizes the list of entries with the terminals that currently
+    //   exist and takes a new sample of each of their counters.
+    void PerformanceDashboardContent::_refresh()
+    {
+        const auto controls = _controls ? _controls() : std::vector<TermControl>{};
+        const auto children = _panel.Children();
+        const auto now = std::chrono::steady_clock::now();
+
+        // Drop the entries of terminals that were closed in the meantime.
+        std::erase_if(_entries, [&](const Entry& entry) {
+            if (std::find(controls.begin(), controls.end(), entry.control) != controls.end())
+            {
+                return false;
+            }
+
+            uint32_t index = 0;
+            if (children.IndexOf(entry.root, index))
+            {
+                children.RemoveAt(index);
+            }
+            return true;
+        });
+
+        for (const auto& control : controls)
+        {
+            auto it = std::find_if(_entries.begin(), _entries.end(), [&](const Entry& entry) { return entry.control == control; });
+            if (it == _entries.end())
+            {
+                it = _entries.emplace(_entries.end(), _makeEntry(control, now));
+                children.Append(it->root);
+            }
+
+            _updateEntry(*it, now);
+        }
+    }
+
+    PerformanceDashboardContent::Entry PerformanceDashboardContent::_makeEntry(const TermControl& control, const std::chrono::steady_clock::time_point now)
+    {
+        Entry entry;
+        entry.control = control;
+        entry.previous = control.GetPerformanceCounters();
+        entry.previousTime = now;
+
+        entry.root = Controls::StackPanel{};
+        entry.root.Spacing(4);
+
+        entry.title = Controls::TextBlock{};
+        entry.title.FontWeight(Text::FontWeights::SemiBold());
+        entry.title.TextTrimming(TextTrimming::CharacterEllipsis);
+
+        entry.details = Controls::TextBlock{};
+        entry.details.FontFamily(Media::FontFamily{ L"Cascadia Mono, Consolas" });
+        entry.details.FontSize(12);
+
+        // Both graphs share the same area, but each one is scaled to its own peak.
+        Controls::Grid graphs;
+        graphs.Width(GraphWidth);
+        graphs.Height(GraphHeight);
+        graphs.HorizontalAlignment(HorizontalAlignment::Left);
+
+        entry.parsedGraph = Shapes::Polyline{};
+        entry.parsedGraph.Stroke(lookupBrush(L"SystemControlForegroundAccentBrush"));
+        entry.parsedGraph.StrokeThickness(1.5);
+
+        entry.framesGraph = Shapes::Polyline{};
+        entry.framesGraph.Stroke(lookupBrush(L"SystemControlForegroundBaseMediumBrush"));
+        entry.framesGraph.StrokeThickness(1);
+
+        graphs.Children().Append(entry.framesGraph);
+        graphs.Children().Append(entry.parsedGraph);
+
+        entry.root.Children().Append(entry.title);
+        entry.root.Children().Append(graphs);
+        entry.root.Children().Append(entry.details);
+        return entry;
+    }
+
+    void PerformanceDashboardContent::_updateEntry(Entry& entry, const std::chrono::steady_clock::time_point now)
+    {
+        const auto counters = entry.control.GetPerformanceCounters();
+        const auto seconds = std::chrono::duration<float>(now - entry.previousTime).count();
+
+        if (seconds > 0)
+        {
+            const auto push = [](History& history, float value) {
+                std::shift_left(history.begin(), history.end(), 1);
+                history.back() = value;
+            };
+            push(entry.parsedPerSecond, static_cast<float>(counters.ParsedCharacters - entry.previous.ParsedCharacters) / seconds);
+            push(entry.framesPerSecond, static_cast<float>(counters.FramesRendered - entry.previous.FramesRendered) / seconds);
+
+            entry.previous = counters;
+            entry.previousTime = now;
+        }
+
+        entry.title.Text(entry.control.Title());
+        entry.details.Text(winrt::hstring{ fmt::format(
+            FMT_COMPILE(L"Parsed          {:>10.0f} chars/s\n"
+                        L"Rendered        {:>10.0f} frames/s\n"
+                        L"Slow frames     {:>10}\n"
+                        L"Glyph atlas     {:>10} KiB\n"
+                        L"Text buffer     {:>10} KiB\n"
+                        L"Pattern search  {:>10} us\n"
+                        L"Input queue     {:>10} chars\n"
+                        L"Output queue    {:>10} chars"),
+            entry.parsedPerSecond.back(),
+            entry.framesPerSecond.back(),
+            counters.SlowFrames,
+            counters.GlyphAtlasBytes / 1024,
+            counters.TextBufferCommittedBytes / 1024,
+            counters.PatternDetectionMicroseconds,
+            counters.InputQueueDepth,
+            counters.OutputQueueDepth) });
+
+        _updateGraph(entry.parsedGraph, entry.parsedPerSecond);
+        _updateGraph(entry.framesGraph, entry.framesPerSecond);
+    }
+
+    void PerformanceDashboardContent::_updateGraph(const Shapes::Polyline& line, const History& history)
+    {
+        const auto peak = std::max(1.0f, *std::max_element(history.begin(), history.end()));
+        Media::PointCollection points;
+
+        for (size_t i = 0; i < history.size(); ++i)
+        {
+            const auto x = GraphWidth * static_cast<float>(i) / static_cast<float>(history.size() - 1);
+            const auto y = GraphHeight - GraphHeight * til::at(history, i) / peak;
+            points.Append({ x, y });
+        }
+
+        line.Points(points);
+    }
+}
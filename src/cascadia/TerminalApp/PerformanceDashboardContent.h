@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+#include "winrt/TerminalApp.h"
+#include "BasicPaneEvents.h"
+
+namespace winrt::TerminalApp::implementation
+{
+    // A debug pane that periodically samples the PerformanceCounters of every
+    // terminal in the window and graphs them, so that we can tell which pane
+    // is the one that's burning CPU or memory.
+    class PerformanceDashboardContent : public winrt::implements<PerformanceDashboardContent, IPaneContent>, public BasicPaneEvents
+    {
+    public:
+        // Returns the terminals that the dashboard should show.
+        using ControlsProvider = std::function<std::vector<winrt::Microsoft::Terminal::Control::TermControl>()>;
+
+        PerformanceDashboardContent(ControlsProvider controls);
+
+        winrt::Windows::UI::Xaml::FrameworkElement GetRoot();
+
+        void UpdateSettings(const winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings& settings);
+
+        winrt::Windows::Foundation::Size MinimumSize();
+
+        void Focus(winrt::Windows::UI::Xaml::FocusState reason = winrt::Windows::UI::Xaml::FocusState::Programmatic);
+        void Close();
+        winrt::Microsoft::Terminal::Settings::Model::INewContentArgs GetNewTerminalArgs(BuildStartupKind kind) const;
+
+        winrt::hstring Title() { return L"Performance"; }
+        uint64_t TaskbarState() { return 0; }
+        uint64_t TaskbarProgress() { return 0; }
+        bool ReadOnly() { return false; }
+        winrt::hstring Icon() const;
+        Windows::Foundation::IReference<winrt::Windows::UI::Color> TabColor() const noexcept { return nullptr; }
+        winrt::Windows::UI::Xaml::Media::Brush BackgroundBrush();
+
+        // See BasicPaneEvents for most generic event definitions
+
+    private:
+        // The number of samples each graph shows.
+        static constexpr size_t HistorySize = 120;
+
+        using History = std::array<float, HistorySize>;
+
+        struct Entry
+        {
+            winrt::Microsoft::Terminal::Control::TermControl control{ nullptr };
+            winrt::Microsoft::Terminal::Control::PerformanceCounters previous{};
+            std::chrono::steady_clock::time_point previousTime;
+
+            // Samples per second, oldest first.
+            History parsedPerSecond{};
+            History framesPerSecond{};
+
+            winrt::Windows::UI::Xaml::Controls::StackPanel root{ nullptr };
+            winrt::Windows::UI::Xaml::Controls::TextBlock title{ nullptr };
+            winrt::Windows::UI::Xaml::Controls::TextBlock details{ nullptr };
+            winrt::Windows::UI::Xaml::Shapes::Polyline parsedGraph{ nullptr };
+            winrt::Windows::UI::Xaml::Shapes::Polyline framesGraph{ nullptr };
+        };
+
+        Entry _makeEntry(const winrt::Microsoft::Terminal::Control::TermControl& control, std::chrono::steady_clock::time_point now);
+        static void _updateEntry(Entry& entry, std::chrono::steady_clock::time_point now);
+        static void _updateGraph(const winrt::Windows::UI::Xaml::Shapes::Polyline& line, const History& history);
+        void _refresh();
+        void _timerTick(const winrt::Windows::Foundation::IInspectable& sender, const winrt::Windows::Foundation::IInspectable& e);
+
+        ControlsProvider _controls;
+        std::vector<Entry> _entries;
+        SafeDispatcherTimer _timer;
+
+        winrt::Windows::UI::Xaml::Controls::Grid _root{ nullptr };
+        winrt::Windows::UI::Xaml::Controls::ScrollViewer _scroller{ nullptr };
+        winrt::Windows::UI::Xaml::Controls::StackPanel _panel{ nullptr };
+    };
+}
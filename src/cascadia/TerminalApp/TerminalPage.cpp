@@ -11,11 +11,13 @@
 #include <Utils.h>
 
 #include "../../types/inc/utils.hpp"
+#include "../inc/StartupTracing.h"
 #include "App.h"
 #include "ColorHelper.h"
 #include "DebugTapConnection.h"
 #include "SettingsPaneContent.h"
 #include "ScratchpadContent.h"
+#include "PerformanceDashboardContent.h"
 #include "SnippetsPaneContent.h"
 #include "MarkdownPaneContent.h"
 #include "TabRowControl.h"
@@ -267,6 +269,7 @@ namespace winrt::TerminalApp::implementation
         // window will be, so they can subdivide that space.
         //
         // _OnFirstLayout will remove this handler so it doesn't get called more than once.
+        ::Microsoft::Terminal::TraceStartupStageStart(g_hTerminalAppProvider, "TerminalPageFirstLayout");
         _layoutUpdatedRevoker = _tabContent.LayoutUpdated(winrt::auto_revoke, { this, &TerminalPage::_OnFirstLayout });
 
         _isAlwaysOnTop = _settings.GlobalSettings().AlwaysOnTop();
@@ -490,6 +493,7 @@ namespace winrt::TerminalApp::implementation
     {
         // Only let this succeed once.
         _layoutUpdatedRevoker.revoke();
+        ::Microsoft::Terminal::TraceStartupStageStop(g_hTerminalAppProvider, "TerminalPageFirstLayout");
 
         // This event fires every time the layout changes, but it is always the
         // last one to fire in any layout change chain. That gives us great
@@ -502,6 +506,10 @@ namespace winrt::TerminalApp::implementation
 
             ProcessStartupActions(_startupActions, true);
 
+            _bufferCheckpointTimer.Interval(std::chrono::minutes(5));
+            _bufferCheckpointTimer.Tick({ get_weak(), &TerminalPage::_CheckpointBuffers });
+            _bufferCheckpointTimer.Start();
+
             // If we were told that the COM server needs to be started to listen for incoming
             // default application connections, start it now.
             // This MUST be done after we've registered the event listener for the new connections
@@ -511,6 +519,32 @@ namespace winrt::TerminalApp::implementation
         }
     }
 
+    // Method Description:
+    // - If the user wants their layout to be persisted, we periodically write the
+    //   buffers of all panes to disk. That way, a crash or a forced shutdown doesn't
+    //   lose everything that happened since the last exit, and PersistState() on exit
+    //   only needs to write the buffers that changed since the last checkpoint.
+    void TerminalPage::_CheckpointBuffers(const IInspectable& /*sender*/, const IInspectable& /*eventArgs*/)
+    {
+        if (!_settings.GlobalSettings().ShouldUsePersistedLayout())
+        {
+            return;
+        }
+
+        for (const auto& tab : _tabs)
+        {
+            if (auto terminalTab{ _GetTerminalTabImpl(tab) })
+            {
+                terminalTab->GetRootPane()->WalkTree([](auto&& pane) {
+                    if (const auto content{ pane->GetContent().try_as<TerminalApp::TerminalPaneContent>() })
+                    {
+                        winrt::get_self<TerminalPaneContent>(content)->CheckpointBuffer();
+                    }
+                });
+            }
+        }
+    }
+
     // Routine Description:
     // - Will start the listener for inbound console handoffs if we have already determined
     //   that we should do so.
@@ -1347,6 +1381,14 @@ namespace winrt::TerminalApp::implementation
             {
                 valueSet.Insert(L"inheritCursor", Windows::Foundation::PropertyValue::CreateBoolean(true));
             }
+
+            if (const auto directory = profile.SessionLogDirectory(); !directory.empty())
+            {
+                const auto maxSize = static_cast<uint64_t>(std::max(0, profile.SessionLogMaxSize())) * 1024 * 1024;
+                valueSet.Insert(L"sessionLogDirectory", Windows::Foundation::PropertyValue::CreateString(directory));
+                valueSet.Insert(L"sessionLogMaxSize", Windows::Foundation::PropertyValue::CreateUInt64(maxSize));
+                valueSet.Insert(L"sessionLogBlockOnFull", Windows::Foundation::PropertyValue::CreateBoolean(profile.SessionLogBlockOnFull()));
+            }
         }
 
         if (!textMeasurement.empty())
@@ -1754,16 +1796,11 @@ namespace winrt::TerminalApp::implementation
             term.CompletionsChanged({ get_weak(), &TerminalPage::_ControlCompletionsChangedHandler });
         }
         winrt::weak_ref<TermControl> weakTerm{ term };
-        term.ContextMenu().Opening([weak = get_weak(), weakTerm](auto&& sender, auto&& /*args*/) {
-            if (const auto& page{ weak.get() })
-            {
-                page->_PopulateContextMenu(weakTerm.get(), sender.try_as<MUX::Controls::CommandBarFlyout>(), false);
-            }
-        });
-        term.SelectionContextMenu().Opening([weak = get_weak(), weakTerm](auto&& sender, auto&& /*args*/) {
+        // The control only creates its context menus once they're shown, so we must not touch them here.
+        term.ContextMenuOpening([weak = get_weak(), weakTerm](auto&& /*sender*/, const Microsoft::Terminal::Control::ContextMenuOpeningEventArgs& args) {
             if (const auto& page{ weak.get() })
             {
-                page->_PopulateContextMenu(weakTerm.get(), sender.try_as<MUX::Controls::CommandBarFlyout>(), true);
+                page->_PopulateContextMenu(weakTerm.get(), args.Menu(), args.WithSelection());
             }
         });
         if constexpr (Feature_QuickFix::IsEnabled())
@@ -3273,15 +3310,23 @@ namespace winrt::TerminalApp::implementation
                                                           TerminalConnection::ITerminalConnection existingConnection)
     {
         // First things first - Check for making a pane from content ID.
+        // All windows live in this process, so this hands over the existing ControlCore
+        // with its buffer and connection as-is. Nothing gets serialized or re-parsed.
         if (newTerminalArgs &&
             newTerminalArgs.ContentId() != 0)
         {
             // Don't need to worry about duplicating or anything - we'll
             // serialize the actual profile's GUID along with the content guid.
             const auto& profile = _settings.GetProfileForArgs(newTerminalArgs);
-            const auto control = _AttachControlToContent(newTerminalArgs.ContentId());
-            auto paneContent{ winrt::make<TerminalPaneContent>(profile, _terminalSettingsCache, control) };
-            return std::make_shared<Pane>(paneContent);
+            if (const auto control = _AttachControlToContent(newTerminalArgs.ContentId()))
+            {
+                auto paneContent{ winrt::make<TerminalPaneContent>(profile, _terminalSettingsCache, control) };
+                return std::make_shared<Pane>(paneContent);
+            }
+
+            // The content got closed while it was being moved, for instance because
+            // its shell exited mid-drag. Instead of creating a pane without a control,
+            // fall through and start a new terminal for the same profile.
         }
 
         TerminalSettingsCreateResult controlSettings{ nullptr };
@@ -3334,7 +3379,17 @@ namespace winrt::TerminalApp::implementation
                                          WI_IsFlagSet(rAltState, CoreVirtualKeyStates::Down);
             if (bothAltsPressed)
             {
-                std::tie(connection, debugConnection) = OpenDebugTapConnection(connection);
+                const auto shiftState = window.GetKeyState(VirtualKey::Shift);
+                if (WI_IsFlagSet(shiftState, CoreVirtualKeyStates::Down))
+                {
+                    // Holding shift as well records the session to a trace file instead of showing it in a second pane.
+                    const auto path = fmt::format(FMT_COMPILE(L"{}\\debugtap_{}.wttrace"), CascadiaSettings::SettingsDirectory(), Utils::GuidToPlainString(Utils::CreateGuid()));
+                    connection = OpenDebugTapRecording(connection, path);
+                }
+                else
+                {
+                    std::tie(connection, debugConnection) = OpenDebugTapConnection(connection);
+                }
             }
         }
 
@@ -3402,6 +3457,10 @@ namespace winrt::TerminalApp::implementation
 
             content = *scratchPane;
         }
+        else if (paneType == L"performanceDashboard")
+        {
+            content = _makePerformanceDashboardContent();
+        }
         else if (paneType == L"settings")
         {
             content = _makeSettingsContent();
@@ -4122,6 +4181,35 @@ namespace winrt::TerminalApp::implementation
         CATCH_RETURN()
     }
 
+    // Method Description:
+    // - Creates a performance dashboard, which shows the counters of all terminals in this window.
+    TerminalApp::IPaneContent TerminalPage::_makePerformanceDashboardContent()
+    {
+        const auto dashboard{ winrt::make_self<PerformanceDashboardContent>([weakThis = get_weak()]() {
+            std::vector<TermControl> controls;
+            if (const auto page{ weakThis.get() })
+            {
+                for (const auto& tab : page->_tabs)
+                {
+                    if (const auto terminalTab{ page->_GetTerminalTabImpl(tab) })
+                    {
+                        terminalTab->GetRootPane()->WalkTree([&](auto&& pane) {
+                            if (const auto& control{ pane->GetTerminalControl() })
+                            {
+                                controls.emplace_back(control);
+                            }
+                        });
+                    }
+                }
+            }
+            return controls;
+        }) };
+
+        // Hook up our key event handler, so that we get actions for keys that the content didn't handle.
+        dashboard->GetRoot().KeyDown({ get_weak(), &TerminalPage::_KeyDownHandler });
+        return *dashboard;
+    }
+
     TerminalApp::IPaneContent TerminalPage::_makeSettingsContent()
     {
         if (auto app{ winrt::Windows::UI::Xaml::Application::Current().try_as<winrt::TerminalApp::App>() })
@@ -11,6 +11,14 @@
 #include "BellEventArgs.g.cpp"
 #include "TerminalPaneContent.g.cpp"
 
+// The file the buffer of the given session is persisted to. TerminalPage restores it from there.
+static std::wstring bufferPathForSession(const winrt::guid& id)
+{
+    const auto settingsDir = winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings::SettingsDirectory();
+    const auto idStr = ::Microsoft::Console::Utils::GuidToPlainString(id);
+    return fmt::format(FMT_COMPILE(L"{}\\buffer_{}.txt"), settingsDir, idStr);
+}
+
 using namespace winrt::Windows::Foundation;
 using namespace winrt::Windows::UI::Xaml;
 using namespace winrt::Microsoft::Terminal::Settings::Model;
@@ -148,10 +156,7 @@ namespace winrt::TerminalApp::implementation
 
             if (id != winrt::guid{})
             {
-                const auto settingsDir = CascadiaSettings::SettingsDirectory();
-                const auto idStr = ::Microsoft::Console::Utils::GuidToPlainString(id);
-                const auto path = fmt::format(FMT_COMPILE(L"{}\\buffer_{}.txt"), settingsDir, idStr);
-                _control.PersistToPath(path);
+                _control.PersistToPath(bufferPathForSession(id));
                 args.SessionId(id);
             }
             break;
@@ -163,6 +168,19 @@ namespace winrt::TerminalApp::implementation
         return args;
     }
 
+    // Method Description:
+    // - Saves the buffer to the same file GetNewTerminalArgs(BuildStartupKind::Persist)
+    //   does, but in the background. Called periodically by the TerminalPage.
+    void TerminalPaneContent::CheckpointBuffer() const
+    {
+        const auto connection = _control.Connection();
+        const auto id = connection ? connection.SessionId() : winrt::guid{};
+        if (id != winrt::guid{})
+        {
+            _control.CheckpointToPath(bufferPathForSession(id));
+        }
+    }
+
     void TerminalPaneContent::_controlTitleChanged(const IInspectable&, const IInspectable&)
     {
         TitleChanged.raise(*this, nullptr);
@@ -341,8 +359,11 @@ namespace winrt::TerminalApp::implementation
 
     void TerminalPaneContent::UpdateSettings(const CascadiaSettings& /*settings*/)
     {
-        if (const auto& settings{ _cache.TryLookup(_profile) })
+        // The cache returns the same instance as during the last reload if this profile's
+        // settings didn't change. In that case we can skip the (expensive) control update.
+        if (const auto& settings{ _cache.TryLookup(_profile) }; settings && settings != _appliedSettings)
         {
+            _appliedSettings = settings;
             _control.UpdateControlSettings(settings.DefaultSettings(), settings.UnfocusedSettings());
         }
     }
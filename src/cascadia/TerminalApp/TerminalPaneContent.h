@@ -30,6 +30,7 @@ namespace winrt::TerminalApp::implementation
         void Close();
 
         winrt::Microsoft::Terminal::Settings::Model::INewContentArgs GetNewTerminalArgs(BuildStartupKind kind) const;
+        void CheckpointBuffer() const;
 
         void UpdateSettings(const winrt::Microsoft::Terminal::Settings::Model::CascadiaSettings& settings);
 
@@ -60,6 +61,7 @@ namespace winrt::TerminalApp::implementation
         winrt::Microsoft::Terminal::TerminalConnection::ConnectionState _connectionState{ winrt::Microsoft::Terminal::TerminalConnection::ConnectionState::NotConnected };
         winrt::Microsoft::Terminal::Settings::Model::Profile _profile{ nullptr };
         TerminalApp::TerminalSettingsCache _cache{ nullptr };
+        winrt::Microsoft::Terminal::Settings::Model::TerminalSettingsCreateResult _appliedSettings{ nullptr };
         bool _isDefTermSession{ false };
 
         winrt::Windows::Media::Playback::MediaPlayer _bellPlayer{ nullptr };
@@ -19,6 +19,15 @@ namespace winrt::TerminalApp::implementation
         Reset(settings, bindings);
     }
 
+    static bool isEquivalent(const MTSM::TerminalSettings& lhs, const MTSM::TerminalSettings& rhs)
+    {
+        if (!lhs || !rhs)
+        {
+            return lhs == rhs;
+        }
+        return lhs.IsEquivalentTo(rhs);
+    }
+
     MTSM::TerminalSettingsCreateResult TerminalSettingsCache::TryLookup(const MTSM::Profile& profile)
     {
         const auto found{ profileGuidSettingsMap.find(profile.Guid()) };
@@ -32,6 +41,16 @@ namespace winrt::TerminalApp::implementation
             if (!pair.second)
             {
                 pair.second = MTSM::TerminalSettings::CreateWithProfile(_settings, pair.first, _bindings);
+
+                if (const auto previous{ previousProfileGuidSettingsMap.find(found->first) }; previous != previousProfileGuidSettingsMap.cend())
+                {
+                    const auto& prev{ previous->second };
+                    if (isEquivalent(prev.DefaultSettings(), pair.second.DefaultSettings()) &&
+                        isEquivalent(prev.UnfocusedSettings(), pair.second.UnfocusedSettings()))
+                    {
+                        pair.second = prev;
+                    }
+                }
             }
             return pair.second;
         }
@@ -48,6 +67,18 @@ namespace winrt::TerminalApp::implementation
         // when we stabilize its guid this will become fully safe.
         const auto profileDefaults{ _settings.ProfileDefaults() };
         const auto allProfiles{ _settings.AllProfiles() };
+
+        // Remember the settings we handed out so far, so that TryLookup() can return them again if nothing changed.
+        // Profiles that weren't looked up since the last reload are dropped, as no pane can be using them.
+        previousProfileGuidSettingsMap.clear();
+        for (auto&& [guid, pair] : profileGuidSettingsMap)
+        {
+            if (pair.second)
+            {
+                previousProfileGuidSettingsMap.emplace(guid, std::move(pair.second));
+            }
+        }
+
         profileGuidSettingsMap.clear();
         profileGuidSettingsMap.reserve(allProfiles.Size() + 1);
 
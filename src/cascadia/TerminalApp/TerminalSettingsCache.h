@@ -10,6 +10,9 @@ Abstract:
   contains a single map of guid -> TerminalSettings, so that as we update all
   the panes during a settings reload, we only need to create a TerminalSettings
   once per profile.
+- If a profile's TerminalSettings are equivalent to the ones created during the
+  previous reload, the previous instance is returned instead. This allows panes
+  to skip updating their control if their settings didn't actually change.
 --*/
 #pragma once
 
@@ -29,6 +32,7 @@ namespace winrt::TerminalApp::implementation
         Microsoft::Terminal::Settings::Model::CascadiaSettings _settings{ nullptr };
         TerminalApp::AppKeyBindings _bindings{ nullptr };
         std::unordered_map<winrt::guid, std::pair<Microsoft::Terminal::Settings::Model::Profile, Microsoft::Terminal::Settings::Model::TerminalSettingsCreateResult>> profileGuidSettingsMap;
+        std::unordered_map<winrt::guid, Microsoft::Terminal::Settings::Model::TerminalSettingsCreateResult> previousProfileGuidSettingsMap;
     };
 }
 
@@ -91,6 +91,17 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         }
     }
 
+    // Method description:
+    // - ITerminalConnectionNative: Registers a callback that receives the websocket output as
+    //   UTF-8 instead of TerminalOutput. Our own messages and prompts still use TerminalOutput.
+    HRESULT __stdcall AzureConnection::SetOutputCallback(ITerminalConnectionNative::OutputCallback callback, void* context) noexcept
+    {
+        const std::lock_guard guard{ _outputCallbackMutex };
+        _outputCallback = callback;
+        _outputCallbackContext = context;
+        return S_OK;
+    }
+
     // Method description:
     // - helper that will write an unterminated string (generally, from a resource) to the output stream.
     // Arguments:
@@ -416,6 +427,19 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                         case WINHTTP_WEB_SOCKET_UTF8_FRAGMENT_BUFFER_TYPE:
                         case WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE:
                         {
+                            // The native output callback decodes the UTF-8 itself, without an intermediate hstring.
+                            {
+                                const std::lock_guard guard{ _outputCallbackMutex };
+                                if (_outputCallback)
+                                {
+                                    if (read)
+                                    {
+                                        _outputCallback(_outputCallbackContext, _buffer.data(), read);
+                                    }
+                                    break;
+                                }
+                            }
+
                             const auto result{ til::u8u16(std::string_view{ _buffer.data(), read }, _u16Str, _u8State) };
                             if (FAILED(result))
                             {
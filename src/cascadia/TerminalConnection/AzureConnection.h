@@ -10,10 +10,11 @@
 
 #include "BaseTerminalConnection.h"
 #include "AzureClient.h"
+#include <NativeTerminalConnection.h>
 
 namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 {
-    struct AzureConnection : AzureConnectionT<AzureConnection>, BaseTerminalConnection<AzureConnection>
+    struct AzureConnection : AzureConnectionT<AzureConnection, ITerminalConnectionNative>, BaseTerminalConnection<AzureConnection>
     {
         static winrt::guid ConnectionType() noexcept;
         static bool IsAzureConnectionAvailable() noexcept;
@@ -26,6 +27,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         void Resize(uint32_t rows, uint32_t columns);
         void Close();
 
+        HRESULT __stdcall SetOutputCallback(ITerminalConnectionNative::OutputCallback callback, void* context) noexcept override;
+
         til::event<TerminalOutputHandler> TerminalOutput;
 
     private:
@@ -100,7 +103,15 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         til::u8state _u8State{};
         std::wstring _u16Str;
-        std::array<char, 4096> _buffer{};
+        // Large enough to receive a burst of output in one go. Smaller reads
+        // mean more calls to WinHttpWebSocketReceive() and the output handler.
+        std::array<char, 64 * 1024> _buffer{};
+
+        // Set via ITerminalConnectionNative. The websocket output then goes there instead
+        // of TerminalOutput. The mutex is held while the callback runs on the output thread.
+        std::mutex _outputCallbackMutex;
+        ITerminalConnectionNative::OutputCallback _outputCallback = nullptr;
+        void* _outputCallbackContext = nullptr;
 
         static winrt::hstring _ParsePreferredShellType(const winrt::Windows::Data::Json::JsonObject& settingsResponse);
     };
@@ -9,6 +9,7 @@
 
 #include "CTerminalHandoff.h"
 #include "LibraryResources.h"
+#include "../inc/StartupTracing.h"
 #include "../../types/inc/utils.hpp"
 
 #include "ConptyConnection.g.cpp"
@@ -28,6 +29,40 @@ using namespace ::Microsoft::Console;
 
 namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 {
+    // A pseudoconsole without a client application attached to it (yet).
+    struct ConptyConnection::PseudoConsole
+    {
+        wil::unique_hfile pipe;
+        ::Microsoft::Console::Utils::SharedRingBuffer outputRing;
+        wil::unique_any<HPCON, decltype(closePseudoConsoleAsync), closePseudoConsoleAsync> hPC;
+        DWORD flags = 0;
+    };
+
+    // Spawning a new OpenConsole instance makes up a considerable part of the time it takes to
+    // open a new tab. If enabled, we spawn the pseudoconsoles for the next connections ahead of
+    // time, right after a connection was started. The client application is only ever launched
+    // once a connection actually needs it, so this doesn't run any of the user's shells early.
+    //
+    // More than one is kept around, because layouts (startup actions, `wt` command lines)
+    // open several tabs and panes in quick succession, faster than a single one can be refilled.
+    struct ConptyConnection::PrewarmPool
+    {
+        static constexpr size_t Capacity = 2;
+
+        std::mutex lock;
+        std::vector<PseudoConsole> ptys;
+        til::size dimensions;
+        DWORD flags = 0;
+        bool enabled = false;
+        bool pending = false;
+    };
+
+    struct ConptyConnection::EnvironmentCache
+    {
+        std::mutex lock;
+        std::shared_ptr<const til::env> env;
+    };
+
     // Function Description:
     // - launches the client application attached to the new pseudoconsole
     HRESULT ConptyConnection::_LaunchAttachedClient() noexcept
@@ -54,7 +89,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                                                              nullptr));
 
         auto cmdline{ wil::ExpandEnvironmentStringsW<std::wstring>(_commandline.c_str()) }; // mutable copy -- required for CreateProcessW
-        auto environment = _initialEnv;
+        auto environment = _initialEnv ? *_initialEnv : til::env{};
 
         {
             // Ensure every connection has the unique identifier in the environment.
@@ -149,8 +184,10 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     // Who decided that?
 #pragma warning(suppress : 26455) // Default constructor should not throw. Declare it 'noexcept' (f.6).
     ConptyConnection::ConptyConnection() :
+        _inputAvailableEvent{ CreateEventExW(nullptr, nullptr, 0, EVENT_ALL_ACCESS) },
         _writeOverlappedEvent{ CreateEventExW(nullptr, nullptr, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS) }
     {
+        THROW_LAST_ERROR_IF(!_inputAvailableEvent);
         THROW_LAST_ERROR_IF(!_writeOverlappedEvent);
         _writeOverlapped.hEvent = _writeOverlappedEvent.get();
     }
@@ -213,6 +250,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
             _environment = settings.TryLookup(L"environment").try_as<Windows::Foundation::Collections::ValueSet>();
             _profileGuid = unbox_prop_or<winrt::guid>(settings, L"profileGuid", _profileGuid);
 
+            _sessionLogOptions.directory = unbox_prop_or<winrt::hstring>(settings, L"sessionLogDirectory", winrt::hstring{});
+            _sessionLogOptions.maxFileSize = unbox_prop_or<uint64_t>(settings, L"sessionLogMaxSize", 0);
+            using FullPolicy = ::Microsoft::Terminal::TerminalConnection::SessionLog::FullPolicy;
+            _sessionLogOptions.policy = unbox_prop_or<bool>(settings, L"sessionLogBlockOnFull", false) ? FullPolicy::Block : FullPolicy::Drop;
+
             _flags = 0;
 
             // If we're using an existing buffer, we want the new connection
@@ -248,20 +290,20 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
             if (reloadEnvironmentVariables)
             {
-                _initialEnv.regenerate();
+                _initialEnv = _regeneratedEnvironment();
             }
             else
             {
                 if (!initialEnvironment.empty())
                 {
-                    _initialEnv = til::env{ initialEnvironment.c_str() };
+                    _initialEnv = std::make_shared<const til::env>(initialEnvironment.c_str());
                 }
                 else
                 {
                     // If we were not explicitly provided an "initial" env block to
                     // treat as our original one, then just use our actual current
                     // env block.
-                    _initialEnv = til::env::from_current_environment();
+                    _initialEnv = std::make_shared<const til::env>(til::env::from_current_environment());
                 }
             }
         }
@@ -336,6 +378,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     void ConptyConnection::Start()
     try
     {
+        const ::Microsoft::Terminal::StartupStageScope startupStage{ g_hTerminalConnectionProvider, "ConnectionStart" };
+
         _transitionToState(ConnectionState::Connecting);
 
         const til::size dimensions{ gsl::narrow<til::CoordType>(_cols), gsl::narrow<til::CoordType>(_rows) };
@@ -344,9 +388,22 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // handoff from an already-started PTY process.
         if (!_pipe)
         {
-            auto pipe = Utils::CreateOverlappedPipe(PIPE_ACCESS_DUPLEX, 128 * 1024);
-            THROW_IF_FAILED(ConptyCreatePseudoConsole(til::unwrap_coord_size(dimensions), pipe.client.get(), pipe.client.get(), _flags, &_hPC));
-            _pipe = std::move(pipe.server);
+            PseudoConsole pty;
+            if (_takePrewarmedPseudoConsole(_flags, pty))
+            {
+                THROW_IF_FAILED(ConptyResizePseudoConsole(pty.hPC.get(), til::unwrap_coord_size(dimensions)));
+            }
+            else
+            {
+                pty = _createPseudoConsole(dimensions, _flags);
+            }
+
+            _pipe = std::move(pty.pipe);
+            _outputRing = std::move(pty.outputRing);
+            _hPC = std::move(pty.hPC);
+
+            // The next connection is most likely going to be just like this one.
+            _prewarmPseudoConsole(dimensions, _flags);
 
             if (_initialParentHwnd != 0)
             {
@@ -388,6 +445,16 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         _startTime = std::chrono::high_resolution_clock::now();
 
+        if (!_sessionLogOptions.directory.empty())
+        {
+            // The session is more important than its log.
+            try
+            {
+                _sessionLog.Open(_sessionLogOptions, _sessionId);
+            }
+            CATCH_LOG();
+        }
+
         // Create our own output handling thread
         // This must be done after the pipes are populated.
         // Each connection needs to make sure to drain the output from its backing host.
@@ -410,6 +477,26 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ConptyConnection Output Thread"));
 
+        // The input thread exits together with the output thread, so it must be created after it.
+        _hInputThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                const auto pInstance = static_cast<ConptyConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    return pInstance->_InputThread();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        THROW_LAST_ERROR_IF_NULL(_hInputThread);
+
+        LOG_IF_FAILED(SetThreadDescription(_hInputThread.get(), L"ConptyConnection Input Thread"));
+
         _transitionToState(ConnectionState::Connected);
     }
     catch (...)
@@ -477,49 +564,122 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     {
         const auto data = winrt_array_to_wstring_view(buffer);
 
-        if (!_isConnected())
+        if (!_isConnected() || !_hInputThread || _inputThreadExit.load(std::memory_order_relaxed))
         {
             return;
         }
 
-        // Ensure a linear and predictable write order, even across multiple threads.
-        // A ticket lock is the perfect fit for this as it acts as first-come-first-serve.
-        std::lock_guard guard{ _writeLock };
-
-        if (_writePending)
         {
-            _writePending = false;
+            // The queue is in the order the callers acquired the mutex in, which gives us a
+            // linear and predictable write order, even across multiple threads.
+            const std::lock_guard guard{ _inputQueueMutex };
 
-            DWORD read;
-            if (!GetOverlappedResult(_pipe.get(), &_writeOverlapped, &read, TRUE))
+            // If the client doesn't read its input (for instance because it's suspended), the queue would grow
+            // indefinitely. Past the capacity we drop the input instead. The client is unlikely to want it anyway.
+            if (_inputQueue.size() + data.size() > InputQueueCapacity)
             {
-                // Not much we can do when the wait fails. This will kill the connection.
-                LOG_LAST_ERROR();
-                _hPC.reset();
+                if (!std::exchange(_inputQueueOverflowed, true))
+                {
+#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
+                    TraceLoggingWrite(
+                        g_hTerminalConnectionProvider,
+                        "ConPtyInputQueueOverflow",
+                        TraceLoggingDescription("Event emitted when input was dropped because the client doesn't read it"),
+                        TraceLoggingGuid(_sessionId, "session"),
+                        TraceLoggingLevel(WINEVENT_LEVEL_WARNING),
+                        TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+                }
                 return;
             }
-        }
 
-        if (FAILED_LOG(til::u16u8(data, _writeBuffer)))
-        {
-            return;
+            const auto wasEmpty = _inputQueue.empty();
+            _inputQueue.append(data);
+            if (!wasEmpty)
+            {
+                // The input thread was signaled already and will pick this up as well.
+                return;
+            }
         }
 
-        if (!WriteFile(_pipe.get(), _writeBuffer.data(), gsl::narrow_cast<DWORD>(_writeBuffer.length()), nullptr, &_writeOverlapped))
+        _inputAvailableEvent.SetEvent();
+    }
+
+    // Writes the contents of _inputQueue to the pipe. It runs until Close() is called or the output thread exits,
+    // which happens when the pipe broke. The latter is simpler than trying to replicate its shutdown logic here.
+    DWORD ConptyConnection::_InputThread()
+    {
+        // Keep us alive until the input thread terminates, just like the output thread.
+        auto strongThis{ get_strong() };
+
+        const std::array<HANDLE, 2> handles{ _inputAvailableEvent.get(), _hOutputThread.get() };
+        std::wstring input;
+
+        for (;;)
         {
-            switch (const auto gle = GetLastError())
+            const auto wait = WaitForMultipleObjects(gsl::narrow_cast<DWORD>(handles.size()), handles.data(), FALSE, INFINITE);
+            if (wait != WAIT_OBJECT_0 || _inputThreadExit.load(std::memory_order_relaxed))
             {
-            case ERROR_BROKEN_PIPE:
-                _hPC.reset();
-                break;
-            case ERROR_IO_PENDING:
-                _writePending = true;
-                break;
-            default:
-                LOG_WIN32(gle);
                 break;
             }
+
+            {
+                const std::lock_guard guard{ _inputQueueMutex };
+                input.clear();
+                input.swap(_inputQueue);
+                _inputQueueOverflowed = false;
+            }
+
+            if (input.empty() || FAILED_LOG(til::u16u8(input, _writeBuffer)))
+            {
+                continue;
+            }
+
+            if (!WriteFile(_pipe.get(), _writeBuffer.data(), gsl::narrow_cast<DWORD>(_writeBuffer.length()), nullptr, &_writeOverlapped))
+            {
+                auto gle = GetLastError();
+                if (gle == ERROR_IO_PENDING)
+                {
+                    DWORD written;
+                    gle = GetOverlappedResult(_pipe.get(), &_writeOverlapped, &written, TRUE) ? ERROR_SUCCESS : GetLastError();
+                }
+
+                switch (gle)
+                {
+                case ERROR_SUCCESS:
+                    break;
+                case ERROR_BROKEN_PIPE:
+                case ERROR_OPERATION_ABORTED:
+                    // The client went away or Close() canceled the write. Either way we're done.
+                    _inputThreadExit.store(true, std::memory_order_relaxed);
+                    return 0;
+                default:
+                    LOG_WIN32(gle);
+                    break;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    void ConptyConnection::_stopInputThread() noexcept
+    {
+        if (!_hInputThread)
+        {
+            return;
         }
+
+        _inputThreadExit.store(true, std::memory_order_relaxed);
+        _inputAvailableEvent.SetEvent();
+
+        // Loop around `CancelIoEx()` just in case the write was issued right after we canceled it.
+        do
+        {
+            // The input thread may be stuck waiting for the client to read its input.
+            CancelIoEx(_pipe.get(), &_writeOverlapped);
+        } while (WaitForSingleObject(_hInputThread.get(), 1000) != WAIT_OBJECT_0);
+
+        _hInputThread.reset();
     }
 
     void ConptyConnection::Resize(uint32_t rows, uint32_t columns)
@@ -590,6 +750,9 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // Once they're all disconnected it'll close its half of the pipes.
         _hPC.reset();
 
+        // The input thread waits on _hOutputThread, so it needs to exit first.
+        _stopInputThread();
+
         if (_hOutputThread)
         {
             // Loop around `CancelIoEx()` just in case the signal to shut down was missed.
@@ -658,9 +821,16 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         auto strongThis{ get_strong() };
 
         const auto cleanup = wil::scope_exit([this]() noexcept {
+            _sessionLog.Close();
             _LastConPtyClientDisconnected();
         });
 
+        if (_outputRing)
+        {
+            _OutputRingLoop();
+            return 0;
+        }
+
         const wil::unique_event overlappedEvent{ CreateEventExW(nullptr, nullptr, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS) };
         OVERLAPPED overlapped{ .hEvent = overlappedEvent.get() };
         bool overlappedPending = false;
@@ -693,21 +863,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
             // * We're using overlapped IO, and it's the first iteration.
             if (!wstr.empty())
             {
-                if (!_receivedFirstByte)
-                {
-                    const auto now = std::chrono::high_resolution_clock::now();
-                    const std::chrono::duration<double> delta = now - _startTime;
-
-#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
-                    TraceLoggingWrite(g_hTerminalConnectionProvider,
-                                      "ReceivedFirstByte",
-                                      TraceLoggingDescription("An event emitted when the connection receives the first byte"),
-                                      TraceLoggingGuid(_sessionId, "SessionGuid", "The WT_SESSION's GUID"),
-                                      TraceLoggingFloat64(delta.count(), "Duration"),
-                                      TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
-                                      TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
-                    _receivedFirstByte = true;
-                }
+                _traceFirstByte();
 
                 try
                 {
@@ -751,6 +907,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
                 TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 
+            _sessionLog.Append({ &buffer[0], gsl::narrow_cast<size_t>(read) });
+
             // If we hit a parsing error, eat it. It's bad utf-8, we can't do anything with it.
             FAILED_LOG(til::u8u16({ &buffer[0], gsl::narrow_cast<size_t>(read) }, wstr, u8State));
         }
@@ -758,6 +916,146 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         return 0;
     }
 
+    // This replaces the pipe loop in _OutputThread() if conhost writes its output into _outputRing.
+    // We still keep a read pending on the pipe: conhost only writes into it if it failed to open
+    // the ring, but more importantly the pipe breaks once conhost exits, which the ring can't tell us.
+    void ConptyConnection::_OutputRingLoop()
+    {
+        const auto closeRing = wil::scope_exit([this]() noexcept {
+            // conhost may be waiting for us to make space in the ring.
+            _outputRing.Close();
+        });
+
+        const wil::unique_event overlappedEvent{ CreateEventExW(nullptr, nullptr, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS) };
+        OVERLAPPED overlapped{ .hEvent = overlappedEvent.get() };
+        bool overlappedPending = false;
+        char buffer[4096];
+        DWORD read = 0;
+
+        til::u8state u8State;
+        std::wstring wstr;
+
+        // Unlike ReadFile() we can convert the ring's contents in place, without copying them first.
+        const auto drainRing = [&]() {
+            for (auto view = _outputRing.Peek(); !view.empty(); view = _outputRing.Peek())
+            {
+                _raiseOutput(view, u8State, wstr);
+                _outputRing.Consume(view.size());
+            }
+        };
+
+        for (;;)
+        {
+            drainRing();
+
+            if (_isStateAtOrBeyond(ConnectionState::Closing))
+            {
+                break;
+            }
+
+            if (!overlappedPending)
+            {
+                if (ReadFile(_pipe.get(), &buffer[0], sizeof(buffer), &read, &overlapped))
+                {
+                    if (read == 0)
+                    {
+                        break;
+                    }
+                    _raiseOutput({ &buffer[0], read }, u8State, wstr);
+                    continue;
+                }
+                if (GetLastError() != ERROR_IO_PENDING)
+                {
+                    break;
+                }
+                overlappedPending = true;
+            }
+
+            if (!_outputRing.PrepareWait())
+            {
+                continue;
+            }
+
+            const HANDLE handles[]{ _outputRing.GetHandles().dataEvent, overlappedEvent.get() };
+            const auto result = WaitForMultipleObjects(2, &handles[0], FALSE, INFINITE);
+
+            if (result == WAIT_OBJECT_0 + 1)
+            {
+                overlappedPending = false;
+                if (FAILED(Utils::GetOverlappedResultSameThread(&overlapped, &read)) || read == 0)
+                {
+                    break;
+                }
+                _raiseOutput({ &buffer[0], read }, u8State, wstr);
+            }
+            else if (result != WAIT_OBJECT_0)
+            {
+                break;
+            }
+        }
+
+        // The ReadFile() must not outlive the buffer and OVERLAPPED on our stack.
+        if (overlappedPending)
+        {
+            CancelIoEx(_pipe.get(), &overlapped);
+            std::ignore = Utils::GetOverlappedResultSameThread(&overlapped, &read);
+        }
+
+        // Whatever conhost wrote before it exited is still in the ring.
+        if (!_isStateAtOrBeyond(ConnectionState::Closing))
+        {
+            drainRing();
+        }
+    }
+
+    void ConptyConnection::_raiseOutput(std::string_view str, til::u8state& u8State, std::wstring& wstr)
+    {
+        TraceLoggingWrite(
+            g_hTerminalConnectionProvider,
+            "ReadOutput",
+            TraceLoggingCountedUtf8String(str.data(), gsl::narrow_cast<ULONG>(str.size()), "buffer"),
+            TraceLoggingGuid(_sessionId, "session"),
+            TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+            TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
+        _sessionLog.Append(str);
+
+        // If we hit a parsing error, eat it. It's bad utf-8, we can't do anything with it.
+        if (FAILED_LOG(til::u8u16(str, wstr, u8State)) || wstr.empty())
+        {
+            return;
+        }
+
+        _traceFirstByte();
+
+        try
+        {
+            TerminalOutput.raise(wstr);
+        }
+        CATCH_LOG();
+    }
+
+    void ConptyConnection::_traceFirstByte() noexcept
+    {
+        if (_receivedFirstByte)
+        {
+            return;
+        }
+
+        const auto now = std::chrono::high_resolution_clock::now();
+        const std::chrono::duration<double> delta = now - _startTime;
+
+#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
+        TraceLoggingWrite(g_hTerminalConnectionProvider,
+                          "ReceivedFirstByte",
+                          TraceLoggingDescription("An event emitted when the connection receives the first byte"),
+                          TraceLoggingGuid(_sessionId, "SessionGuid", "The WT_SESSION's GUID"),
+                          TraceLoggingFloat64(delta.count(), "Duration"),
+                          TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
+                          TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
+        _receivedFirstByte = true;
+    }
+
     static winrt::event<NewConnectionHandler> _newConnectionHandlers;
 
     winrt::event_token ConptyConnection::NewConnection(const NewConnectionHandler& handler) { return _newConnectionHandlers.add(handler); };
@@ -768,6 +1066,186 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         ::ConptyClosePseudoConsole(hPC);
     }
 
+    // Creates a new pseudoconsole (and its pipes), but doesn't launch any client application yet.
+    ConptyConnection::PseudoConsole ConptyConnection::_createPseudoConsole(const til::size dimensions, const DWORD flags)
+    {
+        PseudoConsole pty;
+        pty.flags = flags;
+
+        auto pipe = Utils::CreateOverlappedPipe(PIPE_ACCESS_DUPLEX, 128 * 1024);
+
+        if constexpr (Feature_ConPtyOutputRing::IsEnabled())
+        {
+            try
+            {
+                pty.outputRing = Utils::SharedRingBuffer::Create();
+            }
+            CATCH_LOG();
+        }
+
+        if (pty.outputRing)
+        {
+            const auto handles = pty.outputRing.GetHandles();
+            const CONPTY_OUTPUT_RING ring{ handles.section, handles.dataEvent, handles.spaceEvent };
+            THROW_IF_FAILED(ConptyCreatePseudoConsoleWithOutputRing(INVALID_HANDLE_VALUE, til::unwrap_coord_size(dimensions), pipe.client.get(), pipe.client.get(), &ring, flags, &pty.hPC));
+        }
+        else
+        {
+            THROW_IF_FAILED(ConptyCreatePseudoConsole(til::unwrap_coord_size(dimensions), pipe.client.get(), pipe.client.get(), flags, &pty.hPC));
+        }
+
+        pty.pipe = std::move(pipe.server);
+        return pty;
+    }
+
+    ConptyConnection::PrewarmPool& ConptyConnection::_prewarmPool() noexcept
+    {
+        static PrewarmPool pool;
+        return pool;
+    }
+
+    ConptyConnection::EnvironmentCache& ConptyConnection::_environmentCache() noexcept
+    {
+        static EnvironmentCache cache;
+        return cache;
+    }
+
+    // Regenerating the environment enumerates several registry keys and expands all of their values,
+    // which opening many tabs at once would do for each of them. The result is thus cached process-wide,
+    // until InvalidateEnvironmentCache() is called, because Windows broadcast that the environment changed.
+    std::shared_ptr<const til::env> ConptyConnection::_regeneratedEnvironment()
+    {
+        auto& cache = _environmentCache();
+        const std::lock_guard guard{ cache.lock };
+
+        if (!cache.env)
+        {
+            auto env = std::make_shared<til::env>();
+            env->regenerate();
+            cache.env = std::move(env);
+        }
+
+        return cache.env;
+    }
+
+    // Method Description:
+    // - Discards the environment cached by _regeneratedEnvironment(). Call this when the
+    //   system broadcasts a WM_SETTINGCHANGE for "Environment". Existing connections keep theirs.
+    void ConptyConnection::InvalidateEnvironmentCache()
+    {
+        std::shared_ptr<const til::env> previous;
+
+        {
+            auto& cache = _environmentCache();
+            const std::lock_guard guard{ cache.lock };
+            previous = std::move(cache.env);
+        }
+    }
+
+    // Hands out a pseudoconsole that was created ahead of time, if there is one and it was created with the given flags.
+    bool ConptyConnection::_takePrewarmedPseudoConsole(const DWORD flags, PseudoConsole& pty) noexcept
+    {
+        // We release the unusable pseudoconsoles (if any) outside of the lock, because closing them isn't free.
+        std::vector<PseudoConsole> mismatched;
+        auto found = false;
+
+        {
+            auto& pool = _prewarmPool();
+            const std::lock_guard guard{ pool.lock };
+
+            auto& ptys = pool.ptys;
+            const auto matches = [=](const PseudoConsole& p) noexcept { return p.flags == flags; };
+
+            if (const auto it = std::find_if(ptys.begin(), ptys.end(), matches); it != ptys.end())
+            {
+                pty = std::move(*it);
+                ptys.erase(it);
+                found = true;
+            }
+
+            // A pseudoconsole with the wrong flags is of no use to anyone, as the next
+            // connections will most likely ask for the same flags as this one did.
+            const auto mid = std::stable_partition(ptys.begin(), ptys.end(), matches);
+            mismatched.insert(mismatched.end(), std::make_move_iterator(mid), std::make_move_iterator(ptys.end()));
+            ptys.erase(mid, ptys.end());
+        }
+
+        return found;
+    }
+
+    // Creates pseudoconsoles on a background thread until the pool is full, for the next calls to Start().
+    // Only one of these runs at a time. If it's already running, it picks up the new dimensions and flags.
+    safe_void_coroutine ConptyConnection::_prewarmPseudoConsole(const til::size dimensions, const DWORD flags)
+    {
+        auto& pool = _prewarmPool();
+
+        {
+            const std::lock_guard guard{ pool.lock };
+            pool.dimensions = dimensions;
+            pool.flags = flags;
+            if (!pool.enabled || pool.pending || pool.ptys.size() >= PrewarmPool::Capacity)
+            {
+                co_return;
+            }
+            pool.pending = true;
+        }
+
+        const auto cleanup = wil::scope_exit([&]() noexcept {
+            const std::lock_guard guard{ pool.lock };
+            pool.pending = false;
+        });
+
+        co_await winrt::resume_background();
+
+        for (;;)
+        {
+            til::size size;
+            DWORD ptyFlags;
+            {
+                const std::lock_guard guard{ pool.lock };
+                if (!pool.enabled || pool.ptys.size() >= PrewarmPool::Capacity)
+                {
+                    break;
+                }
+                size = pool.dimensions;
+                ptyFlags = pool.flags;
+            }
+
+            auto pty = _createPseudoConsole(size, ptyFlags);
+
+            // If prewarming got disabled in the meantime, the pseudoconsole is released outside of the lock.
+            std::optional<PseudoConsole> unused;
+            {
+                const std::lock_guard guard{ pool.lock };
+                if (pool.enabled && pool.ptys.size() < PrewarmPool::Capacity)
+                {
+                    pool.ptys.emplace_back(std::move(pty));
+                    continue;
+                }
+            }
+            unused.emplace(std::move(pty));
+            break;
+        }
+    }
+
+    // Method Description:
+    // - Enables or disables creating the pseudoconsoles of the next connections ahead of time.
+    //   Disabling it closes any pseudoconsoles that were already created.
+    void ConptyConnection::SetPrewarmingEnabled(bool enabled)
+    {
+        std::vector<PseudoConsole> previous;
+
+        {
+            auto& pool = _prewarmPool();
+            const std::lock_guard guard{ pool.lock };
+            pool.enabled = enabled;
+            if (!enabled)
+            {
+                previous = std::exchange(pool.ptys, {});
+            }
+        }
+    }
+
     HRESULT ConptyConnection::NewHandoff(HANDLE* in, HANDLE* out, HANDLE signal, HANDLE reference, HANDLE server, HANDLE client, const TERMINAL_STARTUP_INFO* startupInfo) noexcept
     try
     {
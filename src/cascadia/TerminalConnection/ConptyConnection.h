@@ -6,6 +6,8 @@
 #include "ConptyConnection.g.h"
 #include "BaseTerminalConnection.h"
 #include "ITerminalHandoff.h"
+#include "SessionLog.h"
+#include "../../types/inc/SharedRingBuffer.hpp"
 
 #include <til/env.h>
 #include <til/ticket_lock.h>
@@ -37,6 +39,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         static void StartInboundListener();
         static void StopInboundListener();
+        static void SetPrewarmingEnabled(bool enabled);
+        static void InvalidateEnvironmentCache();
 
         static winrt::event_token NewConnection(const NewConnectionHandler& handler);
         static void NewConnection(const winrt::event_token& token);
@@ -55,7 +59,17 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         til::event<TerminalOutputHandler> TerminalOutput;
 
     private:
+        struct PseudoConsole;
+        struct PrewarmPool;
+        struct EnvironmentCache;
+
         static void closePseudoConsoleAsync(HPCON hPC) noexcept;
+        static PseudoConsole _createPseudoConsole(const til::size dimensions, const DWORD flags);
+        static PrewarmPool& _prewarmPool() noexcept;
+        static bool _takePrewarmedPseudoConsole(const DWORD flags, PseudoConsole& pty) noexcept;
+        static safe_void_coroutine _prewarmPseudoConsole(const til::size dimensions, const DWORD flags);
+        static EnvironmentCache& _environmentCache() noexcept;
+        static std::shared_ptr<const til::env> _regeneratedEnvironment();
         static HRESULT NewHandoff(HANDLE* in, HANDLE* out, HANDLE signal, HANDLE reference, HANDLE server, HANDLE client, const TERMINAL_STARTUP_INFO* startupInfo) noexcept;
         static winrt::hstring _commandlineFromProcess(HANDLE process);
 
@@ -78,19 +92,33 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         std::chrono::high_resolution_clock::time_point _startTime{};
 
         wil::unique_hfile _pipe;
+        ::Microsoft::Console::Utils::SharedRingBuffer _outputRing;
+        // Receives a copy of everything read from _pipe or _outputRing if the "sessionLogDirectory" setting is set.
+        ::Microsoft::Terminal::TerminalConnection::SessionLog::Options _sessionLogOptions;
+        ::Microsoft::Terminal::TerminalConnection::SessionLog _sessionLog;
         wil::unique_handle _hOutputThread;
         wil::unique_process_information _piClient;
         wil::unique_any<HPCON, decltype(closePseudoConsoleAsync), closePseudoConsoleAsync> _hPC;
 
-        til::ticket_lock _writeLock;
+        // WriteInput() only appends to _inputQueue. The input thread writes it to the pipe,
+        // coalescing everything that was queued while the previous write was in flight.
+        // That way the caller (usually the UI thread) never waits for the client to read its input.
+        static constexpr size_t InputQueueCapacity = 4 * 1024 * 1024;
+        wil::unique_handle _hInputThread;
+        std::mutex _inputQueueMutex;
+        std::wstring _inputQueue;
+        bool _inputQueueOverflowed = false;
+        std::atomic<bool> _inputThreadExit{ false };
+        wil::unique_event _inputAvailableEvent;
         wil::unique_event _writeOverlappedEvent;
         OVERLAPPED _writeOverlapped{};
         std::string _writeBuffer;
-        bool _writePending = false;
 
         DWORD _flags{ 0 };
 
-        til::env _initialEnv{};
+        // Shared with other connections if it's the cached result of _regeneratedEnvironment().
+        // _LaunchAttachedClient() copies it before adding anything to it.
+        std::shared_ptr<const til::env> _initialEnv;
         guid _profileGuid{};
 
         struct StartupInfoFromDefTerm
@@ -103,6 +131,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         } _startupInfo{};
 
         DWORD _OutputThread();
+        DWORD _InputThread();
+        void _stopInputThread() noexcept;
+        void _OutputRingLoop();
+        void _raiseOutput(std::string_view str, til::u8state& u8State, std::wstring& wstr);
+        void _traceFirstByte() noexcept;
     };
 }
 
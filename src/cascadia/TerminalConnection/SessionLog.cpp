@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "SessionLog.h"
+
+#include <til/atomic.h>
+
+using namespace ::Microsoft::Terminal::TerminalConnection;
+
+// Close() sets this bit in _head, in order to wake up and stop the writer thread.
+// Since _head counts bytes, it'll never get anywhere near this value otherwise.
+static constexpr size_t ExitBit = size_t{ 1 } << (sizeof(size_t) * 8 - 1);
+
+SessionLog::~SessionLog()
+{
+    Close();
+}
+
+// Method Description:
+// - Opens (or appends to) the log file of the given session and starts the writer thread.
+// - Throws if the file can't be opened.
+void SessionLog::Open(const Options& options, const winrt::guid& sessionId)
+{
+    Close();
+
+    const auto directory = wil::ExpandEnvironmentStringsW<std::wstring>(options.directory.c_str());
+    const auto id = ::Microsoft::Console::Utils::GuidToPlainString(sessionId);
+
+    _path = std::filesystem::path{ directory } / fmt::format(FMT_COMPILE(L"{}.log"), id);
+    _rotatedPath = std::filesystem::path{ directory } / fmt::format(FMT_COMPILE(L"{}.1.log"), id);
+    _maxFileSize = options.maxFileSize;
+    _policy = options.policy;
+
+    std::filesystem::create_directories(directory);
+    _openFile();
+
+    _ring = std::make_unique<char[]>(RingCapacity);
+    _head.store(0, std::memory_order_relaxed);
+    _tail.store(0, std::memory_order_relaxed);
+    _dropped.store(0, std::memory_order_relaxed);
+    _thread = std::thread{ [this]() { _writerThread(); } };
+}
+
+// Method Description:
+// - Copies the given data into the ring buffer for the writer thread.
+// - If the ring is full, this either drops the data or waits, depending on the FullPolicy.
+// - This must only ever be called by a single thread at a time, and not concurrently with Open() or Close().
+void SessionLog::Append(std::string_view data) noexcept
+{
+    if (!_ring)
+    {
+        return;
+    }
+
+    auto head = _head.load(std::memory_order_relaxed);
+
+    while (!data.empty())
+    {
+        const auto tail = _tail.load(std::memory_order_acquire);
+        const auto free = RingCapacity - (head - tail);
+
+        // If we're supposed to drop data, we only ever drop entire chunks.
+        // That way a gap in the log is at least aligned to a read from the connection.
+        if (_policy == FullPolicy::Drop && free < data.size())
+        {
+            _dropped.fetch_add(data.size(), std::memory_order_relaxed);
+            return;
+        }
+
+        if (free == 0)
+        {
+            til::atomic_wait(_tail, tail);
+            continue;
+        }
+
+        const auto count = std::min(free, data.size());
+        const auto offset = head & (RingCapacity - 1);
+        const auto first = std::min(count, RingCapacity - offset);
+        memcpy(&_ring[offset], data.data(), first);
+        memcpy(&_ring[0], data.data() + first, count - first);
+
+        head += count;
+        data = data.substr(count);
+
+        _head.store(head, std::memory_order_release);
+        til::atomic_notify_one(_head);
+    }
+}
+
+// Method Description:
+// - Waits for the writer thread to write everything that was appended so far, and closes the file.
+void SessionLog::Close() noexcept
+{
+    if (!_thread.joinable())
+    {
+        return;
+    }
+
+    _head.fetch_or(ExitBit, std::memory_order_release);
+    til::atomic_notify_one(_head);
+    _thread.join();
+
+    _ring.reset();
+    _file.reset();
+}
+
+bool SessionLog::IsOpen() const noexcept
+{
+    return _ring != nullptr;
+}
+
+// Returns the number of bytes that were skipped, because the disk couldn't keep up or writing failed.
+uint64_t SessionLog::DroppedBytes() const noexcept
+{
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+void SessionLog::_writerThread() noexcept
+{
+    SetThreadDescription(GetCurrentThread(), L"SessionLog Writer");
+
+    auto tail = _tail.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        const auto state = _head.load(std::memory_order_acquire);
+        const auto head = state & ~ExitBit;
+
+        if (head == tail)
+        {
+            // We only exit once everything up to the Close() call was written.
+            if (state & ExitBit)
+            {
+                break;
+            }
+            til::atomic_wait(_head, state);
+            continue;
+        }
+
+        // If the data wraps around the end of the ring we'll write it in two parts.
+        const auto offset = tail & (RingCapacity - 1);
+        const auto count = std::min(head - tail, RingCapacity - offset);
+        _write(&_ring[offset], count);
+
+        tail += count;
+        _tail.store(tail, std::memory_order_release);
+        til::atomic_notify_one(_tail);
+    }
+
+    if (_file)
+    {
+        LOG_IF_WIN32_BOOL_FALSE(FlushFileBuffers(_file.get()));
+    }
+}
+
+void SessionLog::_write(const char* data, size_t length) noexcept
+{
+    while (length != 0)
+    {
+        // If writing failed before, we keep draining the ring, so that Append() never blocks forever.
+        if (!_file)
+        {
+            _dropped.fetch_add(length, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto chunk = gsl::narrow_cast<DWORD>(std::min<size_t>(length, 1024 * 1024));
+        DWORD written = 0;
+        if (!WriteFile(_file.get(), data, chunk, &written, nullptr))
+        {
+            LOG_LAST_ERROR();
+            _file.reset();
+            continue;
+        }
+
+        data += written;
+        length -= written;
+        _fileSize += written;
+
+        if (_maxFileSize != 0 && _fileSize >= _maxFileSize)
+        {
+            _rotate();
+        }
+    }
+}
+
+void SessionLog::_openFile()
+{
+    _file.reset(CreateFileW(_path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+    THROW_LAST_ERROR_IF(!_file);
+
+    LARGE_INTEGER size{};
+    THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(_file.get(), &size));
+    _fileSize = gsl::narrow_cast<uint64_t>(size.QuadPart);
+}
+
+// Renames the current log to _rotatedPath, replacing the previous one, and starts a new log.
+void SessionLog::_rotate() noexcept
+try
+{
+    _file.reset();
+
+    // If someone holds the previous log open, we'll continue appending to the current one forever.
+    if (!MoveFileExW(_path.c_str(), _rotatedPath.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        LOG_LAST_ERROR();
+        _maxFileSize = 0;
+    }
+
+    _openFile();
+}
+CATCH_LOG()
@@ -0,0 +1,81 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SessionLog.h
+
+Abstract:
+- This module writes a copy of a connection's raw output (before it's decoded)
+  into a log file. Append() only copies the data into a lock-free ring buffer,
+  which a background thread drains into the file, so that a slow disk
+  doesn't delay the output of the connection.
+
+--*/
+
+#pragma once
+
+namespace Microsoft::Terminal::TerminalConnection
+{
+    class SessionLog
+    {
+    public:
+        // What Append() does if the writer thread can't keep up and the ring is full.
+        enum class FullPolicy
+        {
+            // Skip the chunk, leaving a gap in the log. The connection is never slowed down.
+            Drop,
+            // Wait until the writer thread made enough space. The log is complete, unless writing failed.
+            Block,
+        };
+
+        struct Options
+        {
+            // The log is written to "<directory>\<session ID>.log". Environment variables are expanded.
+            std::wstring directory;
+            // Once the log grows beyond this many bytes, it's renamed to "<session ID>.1.log",
+            // replacing any previous one, and a new log is started. 0 means unlimited.
+            uint64_t maxFileSize = 0;
+            FullPolicy policy = FullPolicy::Drop;
+        };
+
+        SessionLog() = default;
+        ~SessionLog();
+
+        SessionLog(const SessionLog&) = delete;
+        SessionLog& operator=(const SessionLog&) = delete;
+
+        void Open(const Options& options, const winrt::guid& sessionId);
+        void Append(std::string_view data) noexcept;
+        void Close() noexcept;
+
+        bool IsOpen() const noexcept;
+        uint64_t DroppedBytes() const noexcept;
+
+    private:
+        // Must be a power of 2.
+        static constexpr size_t RingCapacity = 4 * 1024 * 1024;
+
+        void _writerThread() noexcept;
+        void _write(const char* data, size_t length) noexcept;
+        void _openFile();
+        void _rotate() noexcept;
+
+        std::unique_ptr<char[]> _ring;
+        // _head is only written by Append() and _tail only by the writer thread. Both only ever increase,
+        // and data is available in [_tail, _head). Their positions in _ring are their values modulo RingCapacity.
+        alignas(64) std::atomic<size_t> _head{ 0 };
+        alignas(64) std::atomic<size_t> _tail{ 0 };
+        std::atomic<bool> _exit{ false };
+        std::atomic<uint64_t> _dropped{ 0 };
+        FullPolicy _policy = FullPolicy::Drop;
+        std::thread _thread;
+
+        // Only accessed by the writer thread once it runs.
+        std::filesystem::path _path;
+        std::filesystem::path _rotatedPath;
+        wil::unique_hfile _file;
+        uint64_t _maxFileSize = 0;
+        uint64_t _fileSize = 0;
+    };
+}
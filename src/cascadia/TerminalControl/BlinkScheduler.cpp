@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "BlinkScheduler.h"
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    BlinkScheduler::Timer::~Timer()
+    {
+        Destroy();
+    }
+
+    BlinkScheduler::Timer::operator bool() const noexcept
+    {
+        return static_cast<bool>(_callback);
+    }
+
+    void BlinkScheduler::Timer::Initialize(std::chrono::milliseconds interval, Callback callback)
+    {
+        Destroy();
+        _interval = interval;
+        _callback = std::move(callback);
+    }
+
+    void BlinkScheduler::Timer::Start()
+    {
+        if (!_callback)
+        {
+            return;
+        }
+
+        _restarted = std::chrono::steady_clock::now();
+
+        if (!_running)
+        {
+            _get()._add(this);
+            _running = true;
+        }
+    }
+
+    void BlinkScheduler::Timer::Stop() noexcept
+    {
+        if (_running)
+        {
+            _get()._remove(this);
+            _running = false;
+        }
+    }
+
+    void BlinkScheduler::Timer::Destroy() noexcept
+    {
+        Stop();
+        _callback = nullptr;
+    }
+
+    BlinkScheduler& BlinkScheduler::_get() noexcept
+    {
+        // DispatcherTimers are bound to the thread they were created on,
+        // so each window thread gets its own scheduler.
+        static thread_local BlinkScheduler scheduler;
+        return scheduler;
+    }
+
+    void BlinkScheduler::_add(Timer* timer)
+    {
+        const auto it = std::find_if(_groups.begin(), _groups.end(), [&](const auto& g) { return g->interval == timer->_interval; });
+        if (it != _groups.end())
+        {
+            (*it)->timers.emplace_back(timer);
+            return;
+        }
+
+        auto& group = _groups.emplace_back(std::make_unique<Group>());
+        group->interval = timer->_interval;
+        group->timers.emplace_back(timer);
+        group->timer.Interval(timer->_interval);
+        group->timer.Tick([this, g = group.get()](auto&&, auto&&) {
+            _tick(*g);
+        });
+        group->timer.Start();
+    }
+
+    void BlinkScheduler::_remove(Timer* timer) noexcept
+    {
+        for (auto it = _groups.begin(); it != _groups.end(); ++it)
+        {
+            auto& timers = (*it)->timers;
+            if (const auto t = std::find(timers.begin(), timers.end(), timer); t != timers.end())
+            {
+                timers.erase(t);
+                if (timers.empty())
+                {
+                    // Destroys the DispatcherTimer, which stops waking up this thread.
+                    _groups.erase(it);
+                }
+                return;
+            }
+        }
+    }
+
+    void BlinkScheduler::_tick(Group& group)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const auto interval = group.interval;
+
+        // The callbacks may start or stop timers, which modifies the list we're iterating.
+        // They may even stop the last one and destroy the group, so we can't touch `group` afterwards.
+        const auto timers = group.timers;
+        for (const auto timer : timers)
+        {
+            const auto& current = _groups;
+            const auto alive = std::any_of(current.begin(), current.end(), [&](const auto& g) {
+                return std::find(g->timers.begin(), g->timers.end(), timer) != g->timers.end();
+            });
+
+            // A timer that was restarted recently (for instance because a key was pressed and the cursor
+            // was turned on) skips this tick, so that the cursor doesn't flicker off right away.
+            if (alive && now - timer->_restarted >= interval / 2)
+            {
+                timer->_callback();
+            }
+        }
+    }
+}
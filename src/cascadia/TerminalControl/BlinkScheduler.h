@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    // The cursor and the blinking text of all TermControls on a thread are driven by this class.
+    // Instead of every control running one DispatcherTimer for each, which wakes the thread 2N times per
+    // blink interval, all controls that blink with the same interval share one timer, and they blink in phase.
+    // Controls only subscribe while they need to blink (usually while they're focused)
+    // and the shared timer is destroyed once the last one unsubscribed.
+    class BlinkScheduler
+    {
+    public:
+        using Callback = std::function<void()>;
+
+        // A subscription to the scheduler of the current thread, with the same Start/Stop/Destroy semantics as a
+        // SafeDispatcherTimer. It must be started, stopped and destroyed on the thread that initialized it.
+        class Timer
+        {
+        public:
+            Timer() = default;
+            Timer(const Timer&) = delete;
+            Timer& operator=(const Timer&) = delete;
+            Timer(Timer&&) = delete;
+            Timer& operator=(Timer&&) = delete;
+            ~Timer();
+
+            explicit operator bool() const noexcept;
+
+            void Initialize(std::chrono::milliseconds interval, Callback callback);
+            // Subscribes to the shared timer. If the timer is already running, the next tick is skipped
+            // if it would come too early, the same way restarting a DispatcherTimer would delay it.
+            void Start();
+            void Stop() noexcept;
+            void Destroy() noexcept;
+
+        private:
+            friend class BlinkScheduler;
+
+            std::chrono::milliseconds _interval{};
+            Callback _callback;
+            std::chrono::steady_clock::time_point _restarted{};
+            bool _running = false;
+        };
+
+    private:
+        struct Group
+        {
+            std::chrono::milliseconds interval{};
+            SafeDispatcherTimer timer;
+            std::vector<Timer*> timers;
+        };
+
+        static BlinkScheduler& _get() noexcept;
+
+        void _add(Timer* timer);
+        void _remove(Timer* timer) noexcept;
+        void _tick(Group& group);
+
+        std::vector<std::unique_ptr<Group>> _groups;
+    };
+}
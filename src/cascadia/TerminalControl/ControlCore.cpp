@@ -13,6 +13,7 @@
 #include <unicode.hpp>
 #include <utils.hpp>
 #include <WinUser.h>
+#include <til/unicode.h>
 
 #include "EventArgs.h"
 #include "../../renderer/atlas/AtlasEngine.h"
@@ -30,6 +31,28 @@ using namespace winrt::Windows::Graphics::Display;
 using namespace winrt::Windows::System;
 using namespace winrt::Windows::ApplicationModel::DataTransfer;
 
+// If the user sent input within this time frame, we assume they're waiting for its echo. See _connectionOutputHandler().
+static constexpr std::chrono::milliseconds InteractiveOutputWindow{ 100 };
+// While they're waiting, this is the longest the renderer has to wait for the lock while we process output...
+static constexpr std::chrono::milliseconds InteractiveOutputYieldInterval{ 1 };
+// ...and otherwise it's this long, so that it never has to wait for an entire chunk of bulk output.
+static constexpr std::chrono::milliseconds BulkOutputYieldInterval{ 8 };
+// While the control is unfocused or hidden, output is processed at most this often...
+static constexpr std::chrono::milliseconds BatchedOutputDelay{ 50 };
+// ...unless at least this many characters piled up in the meantime.
+// The connection's reader thread is blocked in _connectionOutputHandler() whenever we process the
+// output right away, so this is also the most output that can ever queue up in front of the parser.
+static constexpr size_t BatchedOutputSize = 256 * 1024;
+// Title and taskbar progress changes are coalesced to at most one event per frame (at 60Hz).
+// Progress bars like those of pip or cargo may otherwise update them hundreds of times per second.
+static constexpr std::chrono::milliseconds TerminalNotificationInterval{ 16 };
+// BELs that arrive within this long after the last raised WarningBell event are dropped.
+// TermControl only plays one bell per second anyway, so there's no point in raising more than that.
+static constexpr std::chrono::milliseconds WarningBellInterval{ 1000 };
+// Pastes at least this long are written by a background thread in chunks of AsyncPasteChunkSize. See PasteText().
+static constexpr size_t AsyncPasteThreshold = 64 * 1024;
+static constexpr size_t AsyncPasteChunkSize = 16 * 1024;
+
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
     static winrt::Microsoft::Terminal::Core::OptionalColor OptionalFromColor(const til::color& c) noexcept
@@ -95,6 +118,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _setupDispatcherAndCallbacks();
 
+        // This runs on a threadpool thread. It's destroyed in our destructor, which waits for it to finish.
+        _batchedOutputFlush = std::make_unique<til::throttled_func_trailing<>>(BatchedOutputDelay, [this]() {
+            _flushBatchedOutput();
+        });
+
         Connection(connection);
 
         _terminal->SetWriteInputCallback([this](std::wstring_view wstr) {
@@ -222,12 +250,62 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                     core->ScrollPositionChanged.raise(*core, update);
                 }
             });
+
+        // Pointer moves during a drag selection arrive far more often than we can render.
+        // Each selection update takes the lock and invalidates the selection, so we coalesce them.
+        shared->updateSelectionEnd = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            std::chrono::milliseconds{ 8 },
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; core && !core->_IsClosing())
+                {
+                    core->FlushPendingSelectionEnd();
+                }
+            });
+
+        // Each title change relayouts the tab header and each progress change calls into the taskbar.
+        // Listeners re-query Title() and TaskbarState() anyway, so we only need to raise the latest one.
+        shared->titleChanged = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            TerminalNotificationInterval,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; core && !core->_IsClosing())
+                {
+                    core->TitleChanged.raise(*core, winrt::make<TitleChangedEventArgs>(core->Title()));
+                }
+            });
+
+        shared->taskbarProgressChanged = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            TerminalNotificationInterval,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; core && !core->_IsClosing())
+                {
+                    core->TaskbarProgressChanged.raise(*core, nullptr);
+                }
+            });
+
+        // Dragging a pane splitter or the window border produces a size change for every pointer move.
+        // Each of them would reflow the entire buffer and resize the connection, which makes the shell
+        // redraw its prompt, so those only happen once the size hasn't changed for a while.
+        shared->resizeSettled = std::make_unique<til::debounced_func_trailing<>>(
+            std::chrono::milliseconds{ 100 },
+            [weakThis = get_weak(), dispatcher = _dispatcher]() {
+                dispatcher.TryEnqueue(DispatcherQueuePriority::Normal, [weakThis]() {
+                    if (const auto core = weakThis.get(); core && !core->_IsClosing())
+                    {
+                        core->FlushPendingResize();
+                    }
+                });
+            });
     }
 
     ControlCore::~ControlCore()
     {
         Close();
 
+        // Waits for any pending _flushBatchedOutput() call, which uses _terminal and _renderer.
+        _batchedOutputFlush.reset();
         _renderer.reset();
         _renderEngine.reset();
     }
@@ -244,6 +322,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const auto shared = _shared.lock();
         shared->outputIdle.reset();
         shared->updateScrollBar.reset();
+        shared->updateSelectionEnd.reset();
+        shared->titleChanged.reset();
+        shared->taskbarProgressChanged.reset();
+        shared->resizeSettled.reset();
     }
 
     void ControlCore::AttachToNewControl(const Microsoft::Terminal::Control::IKeyBindings& keyBindings)
@@ -277,6 +359,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // revoke ALL old handlers immediately
 
         _connectionOutputEventRevoker.revoke();
+        _revokeNativeConnectionOutput();
         _connectionStateChangedRevoker.revoke();
 
         _connection = newConnection;
@@ -305,6 +388,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
             // This event is explicitly revoked in the destructor: does not need weak_ref
             _connectionOutputEventRevoker = _connection.TerminalOutput(winrt::auto_revoke, { this, &ControlCore::_connectionOutputHandler });
+
+            // Connections that implement the native interface can hand us their bulk output without going through WinRT.
+            if (auto native = newConnection.try_as<ITerminalConnectionNative>())
+            {
+                _nativeConnectionState.reset();
+                THROW_IF_FAILED(native->SetOutputCallback(&ControlCore::_nativeConnectionOutputHandler, this));
+                _nativeConnection = std::move(native);
+            }
         }
 
         // Fire off a connection state changed notification, to let our hosting
@@ -394,7 +485,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _renderEngine->SetPixelShaderImagePath(_settings->PixelShaderImagePath());
             _renderEngine->SetGraphicsAPI(parseGraphicsAPI(_settings->GraphicsAPI()));
             _renderEngine->SetDisablePartialInvalidation(_settings->DisablePartialInvalidation());
+            _renderEngine->SetPersistGlyphAtlas(_settings->PersistGlyphAtlas());
             _renderEngine->SetSoftwareRendering(_settings->SoftwareRendering());
+            _renderer->SetAnimationFrameRate(_settings->AnimationFrameRate());
 
             _updateAntiAliasingMode();
 
@@ -433,8 +526,119 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // Return Value:
     // - <none>
     void ControlCore::_sendInputToConnection(std::wstring_view wstr)
+    {
+        // A queued mouse motion report must be written before anything that follows it. See _queueMouseMotion().
+        std::wstring merged;
+
+        {
+            const std::lock_guard guard{ _inputQueueMutex };
+
+            if (!_pendingMouseMotion.empty())
+            {
+                merged = std::move(_pendingMouseMotion);
+                _pendingMouseMotion.clear();
+                merged.append(wstr);
+                wstr = merged;
+            }
+            if (wstr.empty())
+            {
+                return;
+            }
+
+            // Once something is queued, everything else has to be queued as well, or it would overtake it.
+            // During a large paste the queue is drained once the paste is done. See _pasteAsync().
+            if (_inputQueueingEnabled || _inputQueueDraining || _pasteInProgress)
+            {
+                _inputQueue.append(wstr);
+                if (!_pasteInProgress && !std::exchange(_inputQueueDraining, true))
+                {
+                    _drainInputQueue();
+                }
+                return;
+            }
+        }
+
+        _writeInputToConnection(wstr);
+    }
+
+    // Method Description:
+    // - Any-event mouse tracking reports every change of the hovered cell, and a mouse with a high polling rate easily
+    //   produces several of them per frame. Only the latest one is kept until the dispatcher gets around to
+    //   low priority work, which is after it processed the pending input. If other input is sent in the meantime,
+    //   the report is written together with it. Either way there's at most one write per frame for the motion.
+    // - This must be called on the UI thread.
+    // Arguments:
+    // - wstr: the encoded mouse motion report.
+    void ControlCore::_queueMouseMotion(std::wstring_view wstr)
+    {
+        {
+            const std::lock_guard guard{ _inputQueueMutex };
+            _pendingMouseMotion.assign(wstr);
+        }
+
+        if (!std::exchange(_mouseMotionFlushScheduled, true))
+        {
+            _dispatcher.TryEnqueue(DispatcherQueuePriority::Low, [weakThis = get_weak()]() {
+                if (const auto core = weakThis.get())
+                {
+                    core->_mouseMotionFlushScheduled = false;
+                    // An empty string only sends the pending motion, if it wasn't already sent with other input.
+                    core->_sendInputToConnection({});
+                }
+            });
+        }
+    }
+
+    void ControlCore::_writeInputToConnection(std::wstring_view wstr)
     {
         _connection.WriteInput(winrt_wstring_to_array_view(wstr));
+        _renderer->GetFrameTimings().MarkInputWritten();
+    }
+
+    // Method Description:
+    // - Writes the queued input to the connection on a background thread until the queue is empty.
+    //   Only one of these runs at a time (guarded by _inputQueueDraining), which preserves the order of the input.
+    //   Everything that was queued in the meantime is written at once.
+    safe_void_coroutine ControlCore::_drainInputQueue()
+    {
+        const auto weakThis{ get_weak() };
+
+        co_await winrt::resume_background();
+
+        std::wstring input;
+        for (;;)
+        {
+            const auto core = weakThis.get();
+            if (!core)
+            {
+                break;
+            }
+
+            {
+                const std::lock_guard guard{ core->_inputQueueMutex };
+                input.clear();
+                input.swap(core->_inputQueue);
+                if (input.empty())
+                {
+                    core->_inputQueueDraining = false;
+                    break;
+                }
+            }
+
+            core->_writeInputToConnection(input);
+        }
+    }
+
+    // Method Description:
+    // - Enables or disables writing input to the connection on a background thread.
+    //   This is used for panes that input is broadcast to, so that a connection that's slow to accept
+    //   input can't stall the UI thread, which writes the input to all of them one after another.
+    // Arguments:
+    // - enabled: whether input should be queued.
+    void ControlCore::SetInputQueueingEnabled(bool enabled)
+    {
+        const std::lock_guard guard{ _inputQueueMutex };
+        _inputQueueingEnabled = enabled;
     }
 
     // Method Description:
@@ -461,6 +665,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         else
         {
             _sendInputToConnection(wstr);
+            _lastInputTime.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
         }
     }
 
@@ -471,6 +676,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const wchar_t CtrlD = 0x4;
         const wchar_t Enter = '\r';
 
+        _renderer->GetFrameTimings().MarkKeyReceived();
+
         if (_connection.State() >= winrt::Microsoft::Terminal::TerminalConnection::ConnectionState::Closed)
         {
             if (ch == CtrlD)
@@ -522,6 +729,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _midiAudio.BeginSkip();
         _midiAudioSkipTimer.Start();
+
+        // The ^C itself is queued behind the paste and thus written right after we stopped it.
+        _pasteCancelled.store(true, std::memory_order_relaxed);
     }
 
     bool ControlCore::_shouldTryUpdateSelection(const WORD vkey)
@@ -616,6 +826,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return true;
         }
 
+        if (keyDown)
+        {
+            _renderer->GetFrameTimings().MarkKeyReceived();
+        }
+
         TerminalInput::OutputType out;
         {
             const auto lock = _terminal->LockForWriting();
@@ -669,6 +884,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                      const short wheelDelta,
                                      const TerminalInput::MouseButtonState state)
     {
+        const auto isMotion = uiButton == WM_MOUSEMOVE;
+
+        // TerminalInput only reports motion if the cell changed. Checking that here
+        // avoids acquiring the terminal lock for every pixel the pointer moves.
+        if (isMotion && _lastMouseMotionPos == viewportPos)
+        {
+            return false;
+        }
+        _lastMouseMotionPos = isMotion ? std::optional{ viewportPos } : std::nullopt;
+
         TerminalInput::OutputType out;
         {
             const auto lock = _terminal->LockForReading();
@@ -676,7 +901,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         if (out)
         {
-            SendInput(*out);
+            if (isMotion && !_isReadOnly && _dispatcher && _dispatcher.HasThreadAccess())
+            {
+                _queueMouseMotion(*out);
+                _lastInputTime.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+            }
+            else
+            {
+                SendInput(*out);
+            }
             return true;
         }
         return false;
@@ -698,6 +931,33 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Renders the viewport shifted by a fraction of a row, for smooth scrolling.
+    //   This only changes the presentation: The viewport itself stays where it is
+    //   and the renderer redraws the rows it already has at the new offset.
+    // Arguments:
+    // - rows: the offset in rows within [-0.5, 0.5]. Negative values move the contents up.
+    void ControlCore::SetSmoothScrollOffset(const float rows)
+    {
+        if (!_renderEngine || _smoothScrollOffset.load(std::memory_order_relaxed) == rows)
+        {
+            return;
+        }
+
+        {
+            const auto lock = _terminal->LockForWriting();
+            _smoothScrollOffset.store(rows, std::memory_order_relaxed);
+            _renderEngine->SetSmoothScrollOffset(rows * _actualFont.GetSize().height);
+        }
+
+        _renderer->NotifyPaintFrame();
+    }
+
+    float ControlCore::SmoothScrollOffset() const noexcept
+    {
+        return _smoothScrollOffset.load(std::memory_order_relaxed);
+    }
+
     void ControlCore::AdjustOpacity(const float adjustment)
     {
         if (adjustment == 0)
@@ -769,6 +1029,84 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _renderer->TriggerRedrawAll();
     }
 
+    // Method Description:
+    // - Turns the collection of per-phase frame timings on or off.
+    //   This is used by the rendering statistics overlay of the TermControl.
+    void ControlCore::SetRenderStatisticsEnabled(bool enabled)
+    {
+        if (_renderer)
+        {
+            _renderer->GetFrameTimings().SetCaptureEnabled(enabled);
+        }
+    }
+
+    // Method Description:
+    // - Formats the percentiles of the recently rendered frames as a small table, one phase per line.
+    // Return Value:
+    // - The table, or an empty string if there's no renderer.
+    hstring ControlCore::RenderStatistics()
+    {
+        if (!_renderer)
+        {
+            return {};
+        }
+
+        using Microsoft::Console::Render::FramePhase;
+        using Microsoft::Console::Render::FrameTimings;
+
+        const auto stats = _renderer->GetFrameTimings().GetStatistics();
+        std::wstring str;
+
+        fmt::format_to(std::back_inserter(str), FMT_COMPILE(L"Last {} frames, {} atlas resets\n"), stats.frames, stats.atlasResets);
+        fmt::format_to(std::back_inserter(str), FMT_COMPILE(L"{:<14}{:>7}{:>7}{:>7}{:>7}"), L"time in us", L"p50", L"p90", L"p99", L"max");
+
+        for (size_t i = 0; i < FrameTimings::PhaseCount; ++i)
+        {
+            const auto& p = til::at(stats.phases, i);
+            fmt::format_to(std::back_inserter(str), FMT_COMPILE(L"\n{:<14}{:>7}{:>7}{:>7}{:>7}"), FrameTimings::PhaseName(static_cast<FramePhase>(i)), p.p50, p.p90, p.p99, p.max);
+        }
+
+        if (stats.inputSamples)
+        {
+            const auto& p = stats.inputLatency;
+            fmt::format_to(std::back_inserter(str), FMT_COMPILE(L"\n{:<14}{:>7}{:>7}{:>7}{:>7}"), L"Input latency", p.p50, p.p90, p.p99, p.max);
+        }
+
+        return hstring{ str };
+    }
+
+    // Method Description:
+    // - Collects the resource usage of this terminal for the performance dashboard.
+    //   This is cheap enough to be polled a few times per second.
+    Control::PerformanceCounters ControlCore::GetPerformanceCounters()
+    {
+        Control::PerformanceCounters counters{};
+        counters.ParsedCharacters = _parsedCharacters.load(std::memory_order_relaxed);
+
+        if (_renderer)
+        {
+            const auto frames = _renderer->GetFrameTimings().GetCounters();
+            counters.FramesRendered = frames.frames;
+            counters.SlowFrames = frames.slowFrames;
+            counters.GlyphAtlasBytes = frames.glyphAtlasBytes;
+        }
+
+        {
+            const auto lock = _terminal->LockForReading();
+            counters.TextBufferCommittedBytes = _terminal->GetTextBuffer().GetCommittedBytes();
+            counters.PatternDetectionMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(_terminal->GetLastPatternUpdateDuration()).count();
+        }
+
+        {
+            const std::lock_guard guard{ _inputQueueMutex };
+            counters.InputQueueDepth = _inputQueue.size();
+        }
+
+        counters.OutputQueueDepth = _outputQueueDepth.load(std::memory_order_relaxed);
+
+        return counters;
+    }
+
     // Method description:
     // - Updates last hovered cell, renders / removes rendering of hyper-link if required
     // Arguments:
@@ -882,7 +1220,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _renderEngine->SetGraphicsAPI(parseGraphicsAPI(_settings->GraphicsAPI()));
         _renderEngine->SetDisablePartialInvalidation(_settings->DisablePartialInvalidation());
+        _renderEngine->SetPersistGlyphAtlas(_settings->PersistGlyphAtlas());
         _renderEngine->SetSoftwareRendering(_settings->SoftwareRendering());
+        _renderer->SetAnimationFrameRate(_settings->AnimationFrameRate());
         // Inform the renderer of our opacity
         _renderEngine->EnableTransparentBackground(_isBackgroundTransparent());
 
@@ -1094,13 +1434,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
-        auto cx = gsl::narrow_cast<til::CoordType>(lrint(_panelWidth * _compositionScale));
-        auto cy = gsl::narrow_cast<til::CoordType>(lrint(_panelHeight * _compositionScale));
+        // This applies the latest size, which includes any that SizeOrScaleChanged() deferred.
+        _resizePending = false;
 
-        // Don't actually resize so small that a single character wouldn't fit
-        // in either dimension. The buffer really doesn't like being size 0.
-        cx = std::max(cx, _actualFont.GetSize().width);
-        cy = std::max(cy, _actualFont.GetSize().height);
+        const auto [cx, cy] = _panelSizeInPixels();
 
         // Convert our new dimensions to characters
         const auto viewInPixels = Viewport::FromDimensions({ 0, 0 }, { cx, cy });
@@ -1134,6 +1471,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Returns the size of the swap chain panel in pixels. Don't actually resize
+    //   so small that a single character wouldn't fit in either dimension.
+    //   The buffer really doesn't like being size 0.
+    til::size ControlCore::_panelSizeInPixels() const noexcept
+    {
+        const auto cx = gsl::narrow_cast<til::CoordType>(lrint(_panelWidth * _compositionScale));
+        const auto cy = gsl::narrow_cast<til::CoordType>(lrint(_panelHeight * _compositionScale));
+        const auto fontSize = _actualFont.GetSize();
+        return { std::max(cx, fontSize.width), std::max(cy, fontSize.height) };
+    }
+
     void ControlCore::SizeChanged(const float width,
                                   const float height)
     {
@@ -1165,6 +1514,25 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _panelHeight = height;
         _compositionScale = scale;
 
+        // A plain size change during a resize drag only resizes the swap chain for now. The renderer
+        // keeps drawing the old grid into it, clipped or padded, until FlushPendingResize() reflows
+        // the buffer once. A scale change needs a new font, so it can't look right until then anyway.
+        if (!scaleChanged && !_inUnitTests && _initializedTerminal.load(std::memory_order_relaxed))
+        {
+            const auto shared = _shared.lock_shared();
+            if (shared->resizeSettled)
+            {
+                {
+                    const auto lock = _terminal->LockForWriting();
+                    THROW_IF_FAILED(_renderEngine->SetWindowSize(_panelSizeInPixels()));
+                    _renderer->TriggerRedrawAll();
+                }
+                _resizePending = true;
+                (*shared->resizeSettled)();
+                return;
+            }
+        }
+
         const auto lock = _terminal->LockForWriting();
         if (scaleChanged)
         {
@@ -1174,8 +1542,23 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _refreshSizeUnderLock();
     }
 
+    // Method Description:
+    // - Applies the size that SizeOrScaleChanged() deferred during a resize, if any:
+    //   Reflows the buffer and resizes the connection a single time.
+    void ControlCore::FlushPendingResize()
+    {
+        if (_resizePending)
+        {
+            const auto lock = _terminal->LockForWriting();
+            _refreshSizeUnderLock();
+        }
+    }
+
     void ControlCore::SetSelectionAnchor(const til::point position)
     {
+        // Any pending end point belongs to the previous selection.
+        _pendingSelectionEnd.reset();
+
         const auto lock = _terminal->LockForWriting();
         _terminal->SetSelectionAnchor(position);
     }
@@ -1209,6 +1592,45 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // Arguments:
     // - position: the point in terminal coordinates (in cells, not pixels)
     void ControlCore::SetEndSelectionPoint(const til::point position)
+    {
+        // This supersedes whatever QueueEndSelectionPoint() may have left behind.
+        _pendingSelectionEnd.reset();
+        _setEndSelectionPoint(position);
+    }
+
+    // Method Description:
+    // - Same as SetEndSelectionPoint(), but coalesces calls that occur in rapid
+    //   succession, so that the selection is updated at most once per frame.
+    //   Call FlushPendingSelectionEnd() before relying on the selection to be up to date.
+    // Arguments:
+    // - position: the point in terminal coordinates (in cells, not pixels)
+    void ControlCore::QueueEndSelectionPoint(const til::point position)
+    {
+        if (!_inUnitTests)
+        {
+            const auto shared = _shared.lock_shared();
+            if (shared->updateSelectionEnd)
+            {
+                _pendingSelectionEnd = position;
+                shared->updateSelectionEnd->Run();
+                return;
+            }
+        }
+
+        SetEndSelectionPoint(position);
+    }
+
+    // Method Description:
+    // - Applies the selection end point queued by QueueEndSelectionPoint(), if any.
+    void ControlCore::FlushPendingSelectionEnd()
+    {
+        if (const auto position = std::exchange(_pendingSelectionEnd, std::nullopt))
+        {
+            _setEndSelectionPoint(*position);
+        }
+    }
+
+    void ControlCore::_setEndSelectionPoint(const til::point position)
     {
         const auto lock = _terminal->LockForWriting();
 
@@ -1303,11 +1725,32 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Opening the clipboard may take seconds if another application holds it open (see _openClipboard()), which
+    // would freeze the UI thread of the window (or the VT thread for OSC 52). So, it's written in the background.
+    // The writes may then run out of order, which is why those that got overtaken by a newer one are skipped.
+    static safe_void_coroutine copyToClipboardAsync(::Microsoft::Terminal::Core::Terminal::TextCopyData payload)
+    {
+        static std::atomic<uint64_t> enqueued{ 0 };
+        static std::mutex mutex;
+        static uint64_t written = 0;
+
+        const auto sequence = enqueued.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        co_await winrt::resume_background();
+
+        const std::lock_guard guard{ mutex };
+        if (sequence > written)
+        {
+            written = sequence;
+            copyToClipboard(payload.plainText, payload.html, payload.rtf);
+        }
+    }
+
     // Called when the Terminal wants to set something to the clipboard, i.e.
     // when an OSC 52 is emitted.
     void ControlCore::_terminalCopyToClipboard(wil::zwstring_view wstr)
     {
-        copyToClipboard(wstr, {}, {});
+        copyToClipboardAsync({ .plainText = std::wstring{ wstr } });
     }
 
     // Method Description:
@@ -1344,7 +1787,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             payload = _terminal->RetrieveSelectedTextFromBuffer(singleLine, withControlSequences, copyHtml, copyRtf);
         }
 
-        copyToClipboard(payload.plainText, payload.html, payload.rtf);
+        copyToClipboardAsync(std::move(payload));
         return true;
     }
 
@@ -1420,15 +1863,33 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         using namespace ::Microsoft::Console::Utils;
 
-        auto filtered = FilterStringForPaste(hstr, CarriageReturnNewline | ControlCodes);
-        if (BracketedPasteEnabled())
+        // A large paste may take a long time to be consumed by the shell on the other end. It's written by a background
+        // thread instead, so that it doesn't block the UI thread. Only one of them runs at a time and only if no input is
+        // queued, which would otherwise be overtaken. Anything else (including other pastes) gets queued behind it.
+        auto async = false;
+        if (hstr.size() >= AsyncPasteThreshold && !_isReadOnly)
         {
-            filtered.insert(0, L"\x1b[200~");
-            filtered.append(L"\x1b[201~");
+            const std::lock_guard guard{ _inputQueueMutex };
+            async = !_inputQueueingEnabled && !_inputQueueDraining && !_pasteInProgress;
+            _pasteInProgress = async;
         }
 
-        // It's important to not hold the terminal lock while calling this function as sending the data may take a long time.
-        SendInput(filtered);
+        if (async)
+        {
+            _pasteAsync(hstr, BracketedPasteEnabled());
+        }
+        else
+        {
+            auto filtered = FilterStringForPaste(hstr, CarriageReturnNewline | ControlCodes);
+            if (BracketedPasteEnabled())
+            {
+                filtered.insert(0, L"\x1b[200~");
+                filtered.append(L"\x1b[201~");
+            }
+
+            // It's important to not hold the terminal lock while calling this function as sending the data may take a long time.
+            SendInput(filtered);
+        }
 
         const auto lock = _terminal->LockForWriting();
         _terminal->ClearSelection();
@@ -1436,38 +1897,128 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _terminal->TrySnapOnInput();
     }
 
-    FontInfo ControlCore::GetFont() const
+    // Method Description:
+    // - Writes a large paste to the connection on a background thread. It's filtered in chunks, each of which is
+    //   written before the next one is prepared. A connection that writes synchronously (like ConPTY's pipe)
+    //   thus limits how far ahead of the shell we get. The progress is shown via TaskbarState()/TaskbarProgress()
+    //   and pressing Ctrl+C cancels the rest of the paste. Input sent in the meantime is queued until it's done.
+    // Arguments:
+    // - text: the text to paste, as given to PasteText().
+    // - bracketed: whether to wrap the paste in bracketed paste sequences.
+    safe_void_coroutine ControlCore::_pasteAsync(const winrt::hstring text, const bool bracketed)
     {
-        return _actualFont;
-    }
+        using namespace ::Microsoft::Console::Utils;
 
-    winrt::Windows::Foundation::Size ControlCore::FontSize() const noexcept
-    {
-        const auto fontSize = _actualFont.GetSize();
-        return {
-            static_cast<float>(fontSize.width),
-            static_cast<float>(fontSize.height)
-        };
-    }
+        const auto weakThis{ get_weak() };
+        _pasteCancelled.store(false, std::memory_order_relaxed);
+        _setPasteProgress(0);
 
-    uint16_t ControlCore::FontWeight() const noexcept
-    {
-        return static_cast<uint16_t>(_actualFont.GetWeight());
-    }
+        co_await winrt::resume_background();
 
-    winrt::Windows::Foundation::Size ControlCore::FontSizeInDips() const
-    {
-        const auto fontSize = _actualFont.GetSize();
-        const auto scale = 1.0f / _compositionScale;
-        return {
-            fontSize.width * scale,
-            fontSize.height * scale,
-        };
-    }
+        const std::wstring_view view{ text };
+        size_t offset = 0;
 
-    TerminalConnection::ConnectionState ControlCore::ConnectionState() const
-    {
-        return _connection ? _connection.State() : TerminalConnection::ConnectionState::Closed;
+        while (offset < view.size())
+        {
+            const auto core = weakThis.get();
+            if (!core)
+            {
+                co_return;
+            }
+            if (core->_pasteCancelled.load(std::memory_order_relaxed) || core->_IsClosing())
+            {
+                break;
+            }
+
+            // FilterStringForPaste() turns a lone \n into \r, so a \r\n must not be split across two chunks.
+            // The connection converts each write to UTF-8 separately, so the same applies to surrogate pairs.
+            auto end = std::min(offset + AsyncPasteChunkSize, view.size());
+            if (end < view.size() && (til::at(view, end - 1) == L'\r' || til::is_leading_surrogate(til::at(view, end - 1))))
+            {
+                end++;
+            }
+
+            auto chunk = FilterStringForPaste(view.substr(offset, end - offset), CarriageReturnNewline | ControlCodes);
+            if (bracketed && offset == 0)
+            {
+                chunk.insert(0, L"\x1b[200~");
+            }
+            offset = end;
+
+            if (!chunk.empty())
+            {
+                core->_writeInputToConnection(chunk);
+            }
+            core->_setPasteProgress(gsl::narrow_cast<int>(offset * 100 / view.size()));
+        }
+
+        const auto core = weakThis.get();
+        if (!core)
+        {
+            co_return;
+        }
+
+        // Even a cancelled paste needs to be terminated, or the shell would wait for the rest of it.
+        if (bracketed && !core->_IsClosing())
+        {
+            core->_writeInputToConnection(L"\x1b[201~");
+        }
+
+        auto drain = false;
+        {
+            const std::lock_guard guard{ core->_inputQueueMutex };
+            core->_pasteInProgress = false;
+            drain = !core->_inputQueue.empty() && !std::exchange(core->_inputQueueDraining, true);
+        }
+        if (drain)
+        {
+            core->_drainInputQueue();
+        }
+
+        core->_setPasteProgress(-1);
+    }
+
+    // Sets the progress of the large paste that's in progress, or -1 if there's none. See _pasteAsync().
+    void ControlCore::_setPasteProgress(int progress)
+    {
+        if (_pasteProgress.exchange(progress, std::memory_order_relaxed) != progress)
+        {
+            TaskbarProgressChanged.raise(*this, nullptr);
+        }
+    }
+
+    FontInfo ControlCore::GetFont() const
+    {
+        return _actualFont;
+    }
+
+    winrt::Windows::Foundation::Size ControlCore::FontSize() const noexcept
+    {
+        const auto fontSize = _actualFont.GetSize();
+        return {
+            static_cast<float>(fontSize.width),
+            static_cast<float>(fontSize.height)
+        };
+    }
+
+    uint16_t ControlCore::FontWeight() const noexcept
+    {
+        return static_cast<uint16_t>(_actualFont.GetWeight());
+    }
+
+    winrt::Windows::Foundation::Size ControlCore::FontSizeInDips() const
+    {
+        const auto fontSize = _actualFont.GetSize();
+        const auto scale = 1.0f / _compositionScale;
+        return {
+            fontSize.width * scale,
+            fontSize.height * scale,
+        };
+    }
+
+    TerminalConnection::ConnectionState ControlCore::ConnectionState() const
+    {
+        return _connection ? _connection.State() : TerminalConnection::ConnectionState::Closed;
     }
 
     hstring ControlCore::Title()
@@ -1514,6 +2065,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - The taskbar state of this control
     const size_t ControlCore::TaskbarState() const noexcept
     {
+        // A large paste shows its progress in place of the one set by the application.
+        if (_pasteProgress.load(std::memory_order_relaxed) >= 0)
+        {
+            return 1;
+        }
+
         const auto lock = _terminal->LockForReading();
         return _terminal->GetTaskbarState();
     }
@@ -1524,6 +2081,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - The taskbar progress of this control
     const size_t ControlCore::TaskbarProgress() const noexcept
     {
+        if (const auto progress = _pasteProgress.load(std::memory_order_relaxed); progress >= 0)
+        {
+            return gsl::narrow_cast<size_t>(progress);
+        }
+
         const auto lock = _terminal->LockForReading();
         return _terminal->GetTaskbarProgress();
     }
@@ -1560,7 +2122,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         // Since this can only ever be triggered by output from the connection,
         // then the Terminal already has the write lock when calling this
-        // callback.
+        // callback. That lock also guards _lastWarningBell.
+        const auto now = std::chrono::steady_clock::now();
+        if (!_inUnitTests && now - _lastWarningBell < WarningBellInterval)
+        {
+            return;
+        }
+
+        _lastWarningBell = now;
         WarningBell.raise(*this, nullptr);
     }
 
@@ -1569,6 +2138,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     //   a new winrt TypedEvent that can be listened to.
     // - The listeners to this event will re-query the control for the current
     //   value of Title().
+    // - Outside of unit tests the event is throttled, and carries the title
+    //   as of the time it's raised, not necessarily `wstr`.
     // Arguments:
     // - wstr: the new title of this terminal.
     // Return Value:
@@ -1578,7 +2149,17 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // Since this can only ever be triggered by output from the connection,
         // then the Terminal already has the write lock when calling this
         // callback.
-        TitleChanged.raise(*this, winrt::make<TitleChangedEventArgs>(winrt::hstring{ wstr }));
+        if (_inUnitTests) [[unlikely]]
+        {
+            TitleChanged.raise(*this, winrt::make<TitleChangedEventArgs>(winrt::hstring{ wstr }));
+            return;
+        }
+
+        const auto shared = _shared.lock_shared();
+        if (shared->titleChanged)
+        {
+            shared->titleChanged->Run();
+        }
     }
 
     // Method Description:
@@ -1600,6 +2181,21 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
+        // Any sub-row offset belongs to the previous viewport position. If the viewport
+        // moved because of the user scrolling, ControlInteractivity will set a new one.
+        // We're being called under the terminal lock, which is why we can call the engine directly.
+        if (_renderEngine && _smoothScrollOffset.exchange(0.0f, std::memory_order_relaxed) != 0.0f)
+        {
+            _renderEngine->SetSmoothScrollOffset(0.0f);
+        }
+
+        // There's no point in updating the scrollbar of a hidden control. See _flushDeferredUpdates().
+        if (!_inUnitTests && _outputHidden.load(std::memory_order_relaxed))
+        {
+            _scrollBarUpdateDeferred.store(true, std::memory_order_relaxed);
+            return;
+        }
+
         // Start the throttled update of our scrollbar.
         auto update{ winrt::make<ScrollPositionChangedArgs>(viewTop,
                                                             viewHeight,
@@ -1621,7 +2217,17 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void ControlCore::_terminalTaskbarProgressChanged()
     {
-        TaskbarProgressChanged.raise(*this, nullptr);
+        if (_inUnitTests) [[unlikely]]
+        {
+            TaskbarProgressChanged.raise(*this, nullptr);
+            return;
+        }
+
+        const auto shared = _shared.lock_shared();
+        if (shared->taskbarProgressChanged)
+        {
+            shared->taskbarProgressChanged->Run();
+        }
     }
 
     void ControlCore::_terminalShowWindowChanged(bool showOrHide)
@@ -1631,7 +2237,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     }
 
     // Method Description:
-    // - Plays a single MIDI note, blocking for the duration.
+    // - Queues up a single MIDI note to be played. This only blocks if too many notes are queued up already.
     // Arguments:
     // - noteNumber - The MIDI note number to be played (0 - 127).
     // - velocity - The force with which the note should be played (0 - 127).
@@ -1641,7 +2247,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // The UI thread might try to acquire the console lock from time to time.
         // --> Unlock it, so the UI doesn't hang while we're busy.
         const auto suspension = _terminal->SuspendLock();
-        // This call will block for the duration, unless shutdown early.
+        // This call may block until the previous notes have been played, unless shutdown early.
         _midiAudio.PlayNote(reinterpret_cast<HWND>(_owningHwnd), noteNumber, velocity, std::chrono::duration_cast<std::chrono::milliseconds>(duration));
     }
 
@@ -1728,7 +2334,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
             if (searchInvalidated)
             {
-                oldResults = _searcher.ExtractResults();
+                // Copy instead of ExtractResults(), so that Reset() can refine the previous results.
+                oldResults = _searcher.Results();
                 _searcher.Reset(*_terminal.get(), request.Text, flags, !request.GoForward);
                 _terminal->SetSearchHighlights(_searcher.Results());
             }
@@ -1738,15 +2345,32 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 _searcher.FindNext(!request.GoForward);
             }
 
-            _terminal->SetSearchHighlightFocused(gsl::narrow<size_t>(std::max<ptrdiff_t>(0, _searcher.CurrentMatch())));
-            _renderer->TriggerSearchHighlight(oldResults);
+            _finishSearchUpdate(request.ScrollOffset, oldResults, oldFocused);
+        }
 
-            if (const auto focused = _terminal->GetSearchHighlightFocused(); focused && *focused != oldFocused)
-            {
-                _terminal->ScrollToSearchHighlight(request.ScrollOffset);
-            }
+        return _searchResults(searchInvalidated);
+    }
+
+    // Method Description:
+    // - Updates the focused search highlight after _searcher changed and redraws the highlights.
+    //   The terminal must be locked for writing.
+    // Arguments:
+    // - scrollOffset: passed to ScrollToSearchHighlight() if the focused match changed
+    // - oldResults: the previous results, whose highlights need to be invalidated
+    // - oldFocused: the previously focused match
+    void ControlCore::_finishSearchUpdate(til::CoordType scrollOffset, const std::vector<til::point_span>& oldResults, til::point_span oldFocused)
+    {
+        _terminal->SetSearchHighlightFocused(gsl::narrow<size_t>(std::max<ptrdiff_t>(0, _searcher.CurrentMatch())));
+        _renderer->TriggerSearchHighlight(oldResults);
+
+        if (const auto focused = _terminal->GetSearchHighlightFocused(); focused && *focused != oldFocused)
+        {
+            _terminal->ScrollToSearchHighlight(scrollOffset);
         }
+    }
 
+    SearchResults ControlCore::_searchResults(bool searchInvalidated) const
+    {
         int32_t totalMatches = 0;
         int32_t currentMatch = 0;
         if (const auto idx = _searcher.CurrentMatch(); idx >= 0)
@@ -1763,6 +2387,174 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         };
     }
 
+    // Searches the rows [rowBeg,rowEnd) of the buffer. Matches may span multiple rows, so the search extends some rows past
+    // rowEnd, but only matches starting inside the range are returned. This lets callers search the buffer in adjacent
+    // slices without missing literal matches, as every UTF-16 code unit occupies at most 2 columns.
+    // Regex matches longer than that might be missed. Returns nullopt if the regex is invalid.
+    static std::optional<std::vector<til::point_span>> _searchBufferRows(const TextBuffer& textBuffer, const std::wstring_view& text, SearchFlag flags, til::CoordType rowBeg, til::CoordType rowEnd)
+    {
+        const auto width = std::max(1, textBuffer.GetSize().Width());
+        const auto overlapRows = gsl::narrow_cast<til::CoordType>(std::min<size_t>(text.size() * 2 / width + 2, gsl::narrow_cast<size_t>(textBuffer.GetSize().Height())));
+
+        auto results = textBuffer.SearchText(text, flags, rowBeg, rowEnd + overlapRows);
+        if (results)
+        {
+            std::erase_if(*results, [&](const til::point_span& s) { return s.start.y >= rowEnd; });
+        }
+        return results;
+    }
+
+    // Method Description:
+    // - Like Search() with ResetOnly set, but the buffer is searched on a background thread, so that typing
+    //   into the search box never blocks the UI thread. The matches in the viewport are published first via
+    //   the progress handler, followed by the matches in the entire buffer as the result.
+    // - The results are always applied on the UI thread, which is also where the handlers are called.
+    //   Cancelling the operation (for instance because the search text changed) prevents any further results
+    //   from being applied. If the buffer changes during the search, the operation ends early and returns
+    //   the current state: The OutputIdle event will then trigger another search.
+    // Arguments:
+    // - request: The search request. ResetOnly is ignored.
+    // Return Value:
+    // - The search results, like Search().
+    Windows::Foundation::IAsyncOperationWithProgress<SearchResults, SearchResults> ControlCore::SearchAsync(SearchRequest request)
+    {
+        static constexpr til::CoordType sliceRows = 1024;
+
+        const auto weakThis{ get_weak() };
+        const auto weakTerminal{ std::weak_ptr{ _terminal } };
+        const auto dispatcher = _dispatcher;
+        const auto text{ request.Text };
+
+        SearchFlag flags{};
+        WI_SetFlagIf(flags, SearchFlag::CaseInsensitive, !request.CaseSensitive);
+        WI_SetFlagIf(flags, SearchFlag::RegularExpression, request.RegularExpression);
+
+        auto cancellation = co_await winrt::get_cancellation_token();
+        auto progress = co_await winrt::get_progress_token();
+
+        {
+            const auto lock = _terminal->LockForReading();
+            if (!_searcher.IsStale(*_terminal.get(), text, flags))
+            {
+                co_return _searchResults(false);
+            }
+        }
+
+        co_await winrt::resume_background();
+
+        uint64_t mutationId = 0;
+        std::optional<std::vector<til::point_span>> results;
+
+        if (const auto terminal = weakTerminal.lock())
+        {
+            const auto lock = terminal->LockForReading();
+            const auto& textBuffer = terminal->GetTextBuffer();
+            const auto viewTop = terminal->GetScrollOffset();
+            mutationId = textBuffer.GetLastMutationId();
+            results = _searchBufferRows(textBuffer, text, flags, viewTop, viewTop + terminal->GetViewport().Height());
+        }
+
+        co_await wil::resume_foreground(dispatcher);
+
+        {
+            const auto core = weakThis.get();
+            if (!core || cancellation())
+            {
+                co_return SearchResults{};
+            }
+
+            // An invalid regex is invalid everywhere, so there's no need to search the rest of the buffer.
+            const auto complete = !results.has_value();
+            const auto partial = core->_adoptSearchResults(request, flags, mutationId, std::move(results), complete);
+            if (!partial || complete)
+            {
+                co_return partial ? *partial : core->_searchResults(false);
+            }
+
+            progress(*partial);
+        }
+
+        co_await winrt::resume_background();
+
+        std::vector<til::point_span> matches;
+        auto consistent = true;
+
+        for (til::CoordType rowBeg = 0; consistent && !cancellation();)
+        {
+            const auto terminal = weakTerminal.lock();
+            if (!terminal)
+            {
+                break;
+            }
+
+            const auto lock = terminal->LockForReading();
+            const auto& textBuffer = terminal->GetTextBuffer();
+            if (rowBeg >= textBuffer.GetSize().Height())
+            {
+                break;
+            }
+
+            // The lock is released between slices, so output may change the buffer in the meantime. Matches from
+            // different versions of the buffer don't fit together, which is why we stop in that case.
+            consistent = textBuffer.GetLastMutationId() == mutationId;
+            if (consistent)
+            {
+                const auto rowEnd = rowBeg + sliceRows;
+                if (auto slice = _searchBufferRows(textBuffer, text, flags, rowBeg, rowEnd))
+                {
+                    matches.insert(matches.end(), slice->begin(), slice->end());
+                }
+                rowBeg = rowEnd;
+            }
+        }
+
+        co_await wil::resume_foreground(dispatcher);
+
+        const auto core = weakThis.get();
+        if (!core || cancellation())
+        {
+            co_return SearchResults{};
+        }
+
+        if (consistent)
+        {
+            if (const auto complete = core->_adoptSearchResults(request, flags, mutationId, std::move(matches), true))
+            {
+                co_return *complete;
+            }
+        }
+
+        co_return core->_searchResults(false);
+    }
+
+    // Method Description:
+    // - Replaces the search results with the given ones, which were computed on a background thread,
+    //   unless the buffer changed since then. This must be called on the UI thread.
+    // Return Value:
+    // - The new search results or nullopt if they were stale.
+    std::optional<SearchResults> ControlCore::_adoptSearchResults(const SearchRequest& request, SearchFlag flags, uint64_t mutationId, std::optional<std::vector<til::point_span>>&& results, bool complete)
+    {
+        const auto lock = _terminal->LockForWriting();
+
+        if (_terminal->GetTextBuffer().GetLastMutationId() != mutationId)
+        {
+            return std::nullopt;
+        }
+
+        til::point_span oldFocused;
+        if (const auto focused = _terminal->GetSearchHighlightFocused())
+        {
+            oldFocused = *focused;
+        }
+
+        // Adopt() doesn't refine the previous results, so we don't need to copy them.
+        const auto oldResults = _searcher.ExtractResults();
+        _searcher.Adopt(*_terminal.get(), request.Text, flags, !request.GoForward, mutationId, std::move(results), complete);
+        _terminal->SetSearchHighlights(_searcher.Results());
+        _finishSearchUpdate(request.ScrollOffset, oldResults, oldFocused);
+        return _searchResults(true);
+    }
+
     const std::vector<til::point_span>& ControlCore::SearchResultRows() const noexcept
     {
         return _searcher.Results();
@@ -1777,6 +2569,80 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _searcher = {};
     }
 
+    // Method Description:
+    // - Searches the entire buffer for the given text on a background thread. Unlike Search(), this only holds
+    //   the terminal lock for slices of `sliceRows` rows at a time, so that many panes can be searched in
+    //   parallel without stalling their output or rendering. Matches are streamed to the progress handler
+    //   after each slice.
+    // - If the buffer scrolls while the search is in progress, matches in rows that got
+    //   scrolled past may be reported twice or not at all. This is a best effort search.
+    // Arguments:
+    // - request: Only Text, CaseSensitive and RegularExpression are used.
+    // Return Value:
+    // - The total number of matches or -1 if the regular expression is invalid.
+    Windows::Foundation::IAsyncOperationWithProgress<int32_t, Windows::Foundation::Collections::IVectorView<Control::SearchResultSpan>> ControlCore::SearchAllAsync(SearchRequest request)
+    {
+        static constexpr til::CoordType sliceRows = 1024;
+
+        const auto weakThis{ get_weak() };
+        const auto weakTerminal{ std::weak_ptr{ _terminal } };
+        const auto text{ request.Text };
+
+        SearchFlag flags{};
+        WI_SetFlagIf(flags, SearchFlag::CaseInsensitive, !request.CaseSensitive);
+        WI_SetFlagIf(flags, SearchFlag::RegularExpression, request.RegularExpression);
+
+        auto cancellation = co_await winrt::get_cancellation_token();
+        auto progress = co_await winrt::get_progress_token();
+
+        co_await winrt::resume_background();
+
+        int32_t total = 0;
+
+        for (til::CoordType rowBeg = 0; !cancellation();)
+        {
+            std::vector<Control::SearchResultSpan> matches;
+
+            {
+                const auto core = weakThis.get();
+                const auto terminal = weakTerminal.lock();
+                if (!core || !terminal || core->_IsClosing())
+                {
+                    break;
+                }
+
+                const auto lock = terminal->LockForReading();
+                const auto& textBuffer = terminal->GetTextBuffer();
+                if (rowBeg >= textBuffer.GetSize().Height())
+                {
+                    break;
+                }
+
+                const auto rowEnd = rowBeg + sliceRows;
+                const auto results = _searchBufferRows(textBuffer, text, flags, rowBeg, rowEnd);
+                if (!results)
+                {
+                    co_return -1;
+                }
+
+                for (const auto& s : *results)
+                {
+                    matches.push_back({ s.start.to_core_point(), s.end.to_core_point() });
+                }
+
+                rowBeg = rowEnd;
+            }
+
+            if (!matches.empty())
+            {
+                total += gsl::narrow_cast<int32_t>(matches.size());
+                progress(winrt::single_threaded_vector(std::move(matches)).GetView());
+            }
+        }
+
+        co_return total;
+    }
+
     void ControlCore::Close()
     {
         if (!_IsClosing())
@@ -1785,18 +2651,36 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
             // Ensure Close() doesn't hang, waiting for MidiAudio to finish playing an hour long song.
             _midiAudio.BeginSkip();
+            _pasteCancelled.store(true, std::memory_order_relaxed);
 
             // Stop accepting new output and state changes before we disconnect everything.
             _connectionOutputEventRevoker.revoke();
+            _revokeNativeConnectionOutput();
             _connectionStateChangedRevoker.revoke();
             _connection.Close();
         }
     }
 
-    void ControlCore::PersistToPath(const wchar_t* path) const
-    {
+    // Method Description:
+    // - Writes the main buffer to the given file, unless it didn't change since
+    //   we last wrote it to that same file. With the periodic checkpoints most
+    //   buffers are thus already up to date by the time we persist them on exit.
+    // - This may be called from any thread.
+    void ControlCore::PersistToPath(const wchar_t* path)
+    {
+        const std::lock_guard guard{ _persistMutex };
+        _flushBatchedOutput();
         const auto lock = _terminal->LockForReading();
+
+        const auto mutationId = _terminal->GetMainBufferMutationId();
+        if (mutationId == _persistedMutationId && _persistedPath == path)
+        {
+            return;
+        }
+
         _terminal->SerializeMainBuffer(path);
+        _persistedPath = path;
+        _persistedMutationId = mutationId;
     }
 
     void ControlCore::RestoreFromPath(const wchar_t* path) const
@@ -1834,33 +2718,55 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             message = fmt::format(FMT_COMPILE(L"\x1b[100;37m  [{} {} {}]\x1b[K\x1b[m\r\n"), msg, date, time);
         }
 
-        wchar_t buffer[32 * 1024];
-        DWORD read = 0;
-
-        // Ensure the text file starts with a UTF-16 BOM.
-        if (!ReadFile(file.get(), &buffer[0], 2, &read, nullptr) || read < 2 || buffer[0] != L'\uFEFF')
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file.get(), &fileSize) || fileSize.QuadPart < 2)
         {
             return;
         }
 
-        for (;;)
+        // Both formats are read straight from a view of the file. That way, loading
+        // an image doesn't need to copy anything but the row contents into the buffer.
+        const wil::unique_handle mapping{ CreateFileMappingW(file.get(), nullptr, PAGE_READONLY, 0, 0, nullptr) };
+        THROW_LAST_ERROR_IF(!mapping);
+        const wil::unique_mapview_ptr<std::byte> view{ static_cast<std::byte*>(MapViewOfFile(mapping.get(), FILE_MAP_READ, 0, 0, 0)) };
+        THROW_LAST_ERROR_IF(!view);
+        const std::span<const std::byte> data{ view.get(), gsl::narrow<size_t>(fileSize.QuadPart) };
+
+        const auto writeMessage = [&]() {
+            // Normally the cursor should already be at the start of the line, but let's be absolutely sure it is.
+            if (_terminal->GetCursorPosition().x != 0)
+            {
+                _terminal->Write(L"\r\n");
+            }
+            _terminal->Write(message);
+        };
+
         {
-            if (!ReadFile(file.get(), &buffer[0], sizeof(buffer), &read, nullptr))
+            const auto lock = _terminal->LockForWriting();
+            if (_terminal->RestoreMainBuffer(data))
             {
-                break;
+                writeMessage();
+                return;
             }
+        }
+
+        // Otherwise it's a buffer that an older version serialized as VT. Ensure the text file starts with a UTF-16 BOM.
+        const std::wstring_view text{ reinterpret_cast<const wchar_t*>(data.data()), data.size() / sizeof(wchar_t) };
+        if (text.front() != L'\uFEFF')
+        {
+            return;
+        }
 
+        // We release the lock between chunks, so that the renderer can keep up with large buffers.
+        static constexpr size_t chunkSize = 32 * 1024;
+        for (size_t offset = 1;; offset += chunkSize)
+        {
             const auto lock = _terminal->LockForWriting();
-            _terminal->Write({ &buffer[0], read / 2 });
+            _terminal->Write(text.substr(offset, chunkSize));
 
-            if (read < sizeof(buffer))
+            if (offset + chunkSize >= text.size())
             {
-                // Normally the cursor should already be at the start of the line, but let's be absolutely sure it is.
-                if (_terminal->GetCursorPosition().x != 0)
-                {
-                    _terminal->Write(L"\r\n");
-                }
-                _terminal->Write(message);
+                writeMessage();
                 break;
             }
         }
@@ -2164,27 +3070,86 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         auto noticeArgs = winrt::make<NoticeEventArgs>(NoticeLevel::Info, RS_(L"TermControlReadOnly"));
         RaiseNotice.raise(*this, std::move(noticeArgs));
     }
-    void ControlCore::_connectionOutputHandler(const hstring& hstr)
+    // Method Description:
+    // - The ITerminalConnectionNative counterpart to the TerminalOutput event: Decodes the UTF-8
+    //   output of the connection and processes it like _connectionOutputHandler() does.
+    //   It's called on the connection's reader thread.
+    void __stdcall ControlCore::_nativeConnectionOutputHandler(void* context, const char* data, size_t length) noexcept
+    {
+        const auto self = static_cast<ControlCore*>(context);
+        if (SUCCEEDED_LOG(til::u8u16({ data, length }, self->_nativeConnectionBuffer, self->_nativeConnectionState)) &&
+            !self->_nativeConnectionBuffer.empty())
+        {
+            self->_connectionOutputHandler(self->_nativeConnectionBuffer);
+        }
+    }
+
+    // Method Description:
+    // - Unregisters our output callback from the native connection, if any. Once this
+    //   returns, the connection won't call _nativeConnectionOutputHandler() anymore.
+    void ControlCore::_revokeNativeConnectionOutput() noexcept
+    {
+        if (const auto native = std::exchange(_nativeConnection, nullptr))
+        {
+            LOG_IF_FAILED(native->SetOutputCallback(nullptr, nullptr));
+        }
+    }
+
+    void ControlCore::_connectionOutputHandler(std::wstring_view wstr)
     {
         try
         {
+            _renderer->GetFrameTimings().MarkOutputReceived();
+            _parsedCharacters.fetch_add(wstr.size(), std::memory_order_relaxed);
+            _outputQueueDepth.fetch_add(wstr.size(), std::memory_order_relaxed);
+
+            // Unfocused or hidden controls don't need to process each chunk of output the moment it arrives.
+            // Batching it up is a lot cheaper and leaves the CPU to the control the user is actually looking at.
+            if (!_inUnitTests && (_outputUnfocused.load(std::memory_order_relaxed) || _outputHidden.load(std::memory_order_relaxed)))
             {
-                const auto lock = _terminal->LockForWriting();
-                _terminal->Write(hstr);
+                {
+                    const std::lock_guard guard{ _batchedOutputMutex };
+                    _batchedOutput.append(wstr);
+                    if (_batchedOutput.size() < BatchedOutputSize)
+                    {
+                        (*_batchedOutputFlush)();
+                        return;
+                    }
+                }
+
+                _flushBatchedOutput();
+                return;
             }
 
-            if (!_pendingResponses.empty())
+            // If we just returned to the foreground, the batched output must be processed first.
+            _flushBatchedOutput();
+
+            // Processing an entire chunk of output at once holds the lock the entire time and keeps the renderer
+            // (and the UI thread, for selection, scrolling and so on) from getting anything done. So we let
+            // Terminal::WriteYielding() hand the lock to anyone waiting for it every BulkOutputYieldInterval.
+            // If the user typed something recently, the echo they're waiting for may be buried somewhere within
+            // this chunk, so we yield every InteractiveOutputYieldInterval instead.
+            auto yieldInterval = BulkOutputYieldInterval;
             {
-                _sendInputToConnection(_pendingResponses);
-                _pendingResponses.clear();
+                const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+                const std::chrono::steady_clock::duration sinceInput{ now - _lastInputTime.load(std::memory_order_relaxed) };
+                if (sinceInput < InteractiveOutputWindow)
+                {
+                    yieldInterval = InteractiveOutputYieldInterval;
+                }
             }
 
-            // Start the throttled update of where our hyperlinks are.
-            const auto shared = _shared.lock_shared();
-            if (shared->outputIdle)
+            std::wstring responses;
             {
-                (*shared->outputIdle)();
+                const auto lock = _terminal->LockForWriting();
+                _terminal->WriteYielding(wstr, yieldInterval);
+                _outputQueueDepth.fetch_sub(wstr.size(), std::memory_order_relaxed);
+
+                // _flushBatchedOutput() may run concurrently, so we must grab the responses under the lock.
+                responses.swap(_pendingResponses);
             }
+
+            _outputProcessed(responses);
         }
         catch (...)
         {
@@ -2193,6 +3158,67 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Processes the output that _connectionOutputHandler() collected while we were unfocused or hidden.
+    //   This may be called from any thread.
+    void ControlCore::_flushBatchedOutput()
+    {
+        // Checking this without holding the terminal lock is fine: If another thread swapped the output out
+        // in the meantime, it holds the terminal lock while writing it, so any output that we write after
+        // returning from here still ends up in the right order.
+        {
+            const std::lock_guard guard{ _batchedOutputMutex };
+            if (_batchedOutput.empty())
+            {
+                return;
+            }
+        }
+
+        std::wstring responses;
+        {
+            const auto lock = _terminal->LockForWriting();
+
+            std::wstring output;
+            {
+                const std::lock_guard guard{ _batchedOutputMutex };
+                output.swap(_batchedOutput);
+            }
+            if (output.empty())
+            {
+                return;
+            }
+
+            _terminal->Write(output);
+            _outputQueueDepth.fetch_sub(output.size(), std::memory_order_relaxed);
+            responses.swap(_pendingResponses);
+        }
+
+        _outputProcessed(responses);
+    }
+
+    void ControlCore::_outputProcessed(const std::wstring_view responses)
+    {
+        if (!responses.empty())
+        {
+            _sendInputToConnection(responses);
+        }
+
+        // Nobody can hover the hyperlinks or see the search highlights of a hidden control.
+        // The update will run once we're visible again. See _flushDeferredUpdates().
+        if (_outputHidden.load(std::memory_order_relaxed))
+        {
+            _outputIdleDeferred.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        // Start the throttled update of where our hyperlinks are.
+        const auto shared = _shared.lock_shared();
+        if (shared->outputIdle)
+        {
+            (*shared->outputIdle)();
+        }
+    }
+
     ::Microsoft::Console::Render::Renderer* ControlCore::GetRenderer() const noexcept
     {
         return _renderer.get();
@@ -2258,7 +3284,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         const auto& textBuffer = _terminal->GetTextBuffer();
 
-        std::wstring str;
+        // The output of failed commands and bookmarks that already scrolled out of the buffer, if any.
+        auto str = textBuffer.GetRetainedScrollbackText();
         const auto lastRow = textBuffer.GetLastNonSpaceCharacter().y;
         for (auto rowIndex = 0; rowIndex <= lastRow; rowIndex++)
         {
@@ -2478,9 +3505,98 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             {
                 conpty.ShowHide(showOrHide);
             }
+
+            _windowVisible = showOrHide;
+            _updateBackgroundPainting();
+        }
+    }
+
+    // Method Description:
+    // - Called when the control gets added to or removed from the UI tree,
+    //   for instance because the tab it's in got selected or deselected.
+    // Arguments:
+    // - visible: True if the control is part of the UI tree.
+    // Return Value:
+    // - <none>
+    void ControlCore::PaneVisibilityChanged(const bool visible)
+    {
+        _paneVisible = visible;
+        _updateBackgroundPainting();
+    }
+
+    // There's no point in painting a hidden window or tab at full speed. If it stays hidden for a
+    // while, the render thread will also suspend painting and release our GPU resources entirely.
+    void ControlCore::_updateBackgroundPainting()
+    {
+        const auto hidden = !_windowVisible || !_paneVisible;
+        _renderer->SetBackgroundPainting(hidden);
+        _updateHibernation(hidden);
+
+        _outputHidden.store(hidden, std::memory_order_relaxed);
+        if (!hidden)
+        {
+            _flushBatchedOutput();
+            _flushDeferredUpdates();
+        }
+    }
+
+    // Method Description:
+    // - Catches up on the updates that were skipped while the control was hidden:
+    //   The pattern detection and search highlights (via outputIdle) and the scrollbar.
+    void ControlCore::_flushDeferredUpdates()
+    {
+        const auto shared = _shared.lock_shared();
+
+        if (_outputIdleDeferred.exchange(false, std::memory_order_relaxed) && shared->outputIdle)
+        {
+            (*shared->outputIdle)();
+        }
+
+        if (_scrollBarUpdateDeferred.exchange(false, std::memory_order_relaxed) && shared->updateScrollBar)
+        {
+            int viewTop, viewHeight, bufferSize;
+            {
+                const auto lock = _terminal->LockForReading();
+                viewTop = _terminal->GetScrollOffset();
+                viewHeight = _terminal->GetViewport().Height();
+                bufferSize = _terminal->GetBufferHeight();
+            }
+            shared->updateScrollBar->Run(winrt::make<ScrollPositionChangedArgs>(viewTop, viewHeight, bufferSize));
         }
     }
 
+    // If the control stays hidden for much longer than that, we also pack its scrollback
+    // into the cold scrollback tier, which shrinks the buffer to a fraction of its size.
+    // The rows get rehydrated as soon as they're rendered or otherwise accessed again,
+    // so there's nothing to do once the control is shown again, other than to stop waiting.
+    void ControlCore::_updateHibernation(const bool hidden)
+    {
+        if (!hidden)
+        {
+            if (_hibernationTimer)
+            {
+                _hibernationTimer.Stop();
+            }
+            return;
+        }
+
+        if (!_hibernationTimer)
+        {
+            _hibernationTimer = _dispatcher.CreateTimer();
+            _hibernationTimer.Interval(std::chrono::minutes(10));
+            _hibernationTimer.IsRepeating(false);
+            _hibernationTimer.Tick([weakSelf = get_weak()](auto&&, auto&&) {
+                if (const auto self = weakSelf.get())
+                {
+                    const auto lock = self->_terminal->LockForWriting();
+                    self->_terminal->CompactScrollback();
+                }
+            });
+        }
+
+        _hibernationTimer.Start();
+    }
+
     // Method Description:
     // - When the control gains focus, it needs to tell ConPTY about this.
     //   Usually, these sequences are reserved for applications that
@@ -2512,6 +3628,13 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void ControlCore::_focusChanged(bool focused)
     {
+        // Unfocused controls process their output in batches. See _connectionOutputHandler().
+        // We don't need to flush the batched output when regaining focus, because that's
+        // done with the next chunk of output, or by the timer, whichever comes first.
+        _outputUnfocused.store(!focused, std::memory_order_relaxed);
+        // Animated pixel shaders only keep ticking in the focused pane. Output still gets painted.
+        _renderer->SetAnimationsPaused(!focused);
+
         TerminalInput::OutputType out;
         {
             const auto lock = _terminal->LockForReading();
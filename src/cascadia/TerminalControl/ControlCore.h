@@ -24,6 +24,7 @@
 #include "../../buffer/out/search.h"
 #include "../../cascadia/TerminalCore/Terminal.hpp"
 #include "../../renderer/inc/FontInfoDesired.hpp"
+#include "../inc/NativeTerminalConnection.h"
 
 namespace Microsoft::Console::Render::Atlas
 {
@@ -109,6 +110,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void SizeChanged(const float width, const float height);
         void ScaleChanged(const float scale);
         void SizeOrScaleChanged(const float width, const float height, const float scale);
+        void FlushPendingResize();
 
         void AdjustFontSize(float fontSizeDelta);
         void ResetFontSize();
@@ -138,6 +140,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void LostFocus();
 
         void ToggleShaderEffects();
+        void SetRenderStatisticsEnabled(bool enabled);
+        hstring RenderStatistics();
+        void SetInputQueueingEnabled(bool enabled);
         void AdjustOpacity(const float adjustment);
         void ResumeRendering();
 
@@ -152,7 +157,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void ColorSelection(const Control::SelectionColor& fg, const Control::SelectionColor& bg, Core::MatchMode matchMode);
 
         void Close();
-        void PersistToPath(const wchar_t* path) const;
+        void PersistToPath(const wchar_t* path);
         void RestoreFromPath(const wchar_t* path) const;
 
         void ClearQuickFix();
@@ -190,6 +195,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void ContextMenuSelectOutput();
 
         winrt::hstring CurrentWorkingDirectory() const;
+
+        Control::PerformanceCounters GetPerformanceCounters();
 #pragma endregion
 
 #pragma region ITerminalInput
@@ -206,6 +213,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                             const short wheelDelta,
                             const ::Microsoft::Console::VirtualTerminal::TerminalInput::MouseButtonState state);
         void UserScrollViewport(const int viewTop);
+        void SetSmoothScrollOffset(const float rows);
+        float SmoothScrollOffset() const noexcept;
 
         void ClearBuffer(Control::ClearBufferType clearType);
 
@@ -224,10 +233,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         Control::SelectionData SelectionInfo() const;
         void SetSelectionAnchor(const til::point position);
         void SetEndSelectionPoint(const til::point position);
+        void QueueEndSelectionPoint(const til::point position);
+        void FlushPendingSelectionEnd();
 
         SearchResults Search(SearchRequest request);
+        Windows::Foundation::IAsyncOperationWithProgress<SearchResults, SearchResults> SearchAsync(SearchRequest request);
         const std::vector<til::point_span>& SearchResultRows() const noexcept;
         void ClearSearch();
+        Windows::Foundation::IAsyncOperationWithProgress<int32_t, Windows::Foundation::Collections::IVectorView<Control::SearchResultSpan>> SearchAllAsync(SearchRequest request);
 
         void LeftClickOnTerminal(const til::point terminalPosition,
                                  const int numberOfClicks,
@@ -251,6 +264,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void AdjustOpacity(const float opacity, const bool relative);
 
         void WindowVisibilityChanged(const bool showOrHide);
+        void PaneVisibilityChanged(const bool visible);
 
         uint64_t OwningHwnd();
         void OwningHwnd(uint64_t owner);
@@ -307,19 +321,67 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             std::unique_ptr<til::debounced_func_trailing<>> outputIdle;
             std::unique_ptr<til::debounced_func_trailing<bool>> focusChanged;
             std::shared_ptr<ThrottledFuncTrailing<Control::ScrollPositionChangedArgs>> updateScrollBar;
+            std::shared_ptr<ThrottledFuncTrailing<>> updateSelectionEnd;
+            std::shared_ptr<ThrottledFuncTrailing<>> titleChanged;
+            std::shared_ptr<ThrottledFuncTrailing<>> taskbarProgressChanged;
+            std::unique_ptr<til::debounced_func_trailing<>> resizeSettled;
         };
 
         std::atomic<bool> _initializedTerminal{ false };
         bool _closing{ false };
 
+        // Guards PersistToPath(), which may be called from a background thread
+        // for checkpoints, and the file and buffer state it last persisted.
+        std::mutex _persistMutex;
+        std::wstring _persistedPath;
+        uint64_t _persistedMutationId{ 0 };
+
         TerminalConnection::ITerminalConnection _connection{ nullptr };
         TerminalConnection::ITerminalConnection::TerminalOutput_revoker _connectionOutputEventRevoker;
         TerminalConnection::ITerminalConnection::StateChanged_revoker _connectionStateChangedRevoker;
+        // Set in addition to _connectionOutputEventRevoker if the connection implements ITerminalConnectionNative.
+        // The UTF-8 decoder state and buffer are only accessed on the connection's reader thread.
+        wil::com_ptr<ITerminalConnectionNative> _nativeConnection;
+        til::u8state _nativeConnectionState;
+        std::wstring _nativeConnectionBuffer;
 
         winrt::com_ptr<ControlSettings> _settings{ nullptr };
 
         std::shared_ptr<::Microsoft::Terminal::Core::Terminal> _terminal{ nullptr };
         std::wstring _pendingResponses;
+        // The steady_clock time at which the user last sent input. See _connectionOutputHandler().
+        std::atomic<std::chrono::steady_clock::rep> _lastInputTime{ 0 };
+        // When the last WarningBell event was raised. Guarded by the terminal's write lock. See _terminalWarningBell().
+        std::chrono::steady_clock::time_point _lastWarningBell{};
+        // The number of characters of output processed so far. See GetPerformanceCounters().
+        std::atomic<uint64_t> _parsedCharacters{ 0 };
+        // If enabled, input is handed to a background thread which writes it to the connection,
+        // so that the caller doesn't block on it. See _sendInputToConnection().
+        std::mutex _inputQueueMutex;
+        std::wstring _inputQueue;
+        bool _inputQueueingEnabled{ false };
+        bool _inputQueueDraining{ false };
+        // Whether _pasteAsync() is writing a large paste. Guarded by _inputQueueMutex.
+        bool _pasteInProgress{ false };
+        std::atomic<bool> _pasteCancelled{ false };
+        // The percentage of the large paste that was written, or -1 if there's none.
+        std::atomic<int> _pasteProgress{ -1 };
+        // The latest mouse motion report that hasn't been written yet. Guarded by _inputQueueMutex. See _queueMouseMotion().
+        std::wstring _pendingMouseMotion;
+        bool _mouseMotionFlushScheduled{ false };
+        // The viewport position of the last mouse motion, if the last mouse event was one. See SendMouseEvent().
+        std::optional<til::point> _lastMouseMotionPos;
+
+        // The fraction of a row by which the viewport is rendered shifted. See SetSmoothScrollOffset().
+        std::atomic<float> _smoothScrollOffset{ 0.0f };
+
+        // The selection end that QueueEndSelectionPoint() will apply on the next updateSelectionEnd.
+        // Only accessed on the UI thread.
+        std::optional<til::point> _pendingSelectionEnd;
+
+        // Set when SizeOrScaleChanged() only resized the swap chain and left the
+        // reflow to FlushPendingResize(). Only accessed on the UI thread.
+        bool _resizePending{ false };
 
         // NOTE: _renderEngine must be ordered before _renderer.
         //
@@ -349,6 +411,21 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         uint16_t _lastHoveredId{ 0 };
 
         bool _isReadOnly{ false };
+        bool _windowVisible{ true };
+        bool _paneVisible{ true };
+
+        // While the control is unfocused or hidden, output is collected in _batchedOutput
+        // and processed in larger batches. See _connectionOutputHandler().
+        std::atomic<bool> _outputUnfocused{ false };
+        std::atomic<bool> _outputHidden{ false };
+        std::mutex _batchedOutputMutex;
+        std::wstring _batchedOutput;
+        std::unique_ptr<til::throttled_func_trailing<>> _batchedOutputFlush;
+        // The number of characters of output that were received but haven't been parsed yet.
+        std::atomic<uint64_t> _outputQueueDepth{ 0 };
+        // Updates that were skipped while the control was hidden. See _flushDeferredUpdates().
+        std::atomic<bool> _outputIdleDeferred{ false };
+        std::atomic<bool> _scrollBarUpdateDeferred{ false };
 
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _lastHoveredInterval{ std::nullopt };
 
@@ -372,11 +449,21 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool _setFontSizeUnderLock(float fontSize);
         void _updateFont();
         void _refreshSizeUnderLock();
+        til::size _panelSizeInPixels() const noexcept;
         void _updateSelectionUI();
+        void _setEndSelectionPoint(const til::point position);
         bool _shouldTryUpdateSelection(const WORD vkey);
 
         void _handleControlC();
+        void _finishSearchUpdate(til::CoordType scrollOffset, const std::vector<til::point_span>& oldResults, til::point_span oldFocused);
+        SearchResults _searchResults(bool searchInvalidated) const;
+        std::optional<SearchResults> _adoptSearchResults(const SearchRequest& request, SearchFlag flags, uint64_t mutationId, std::optional<std::vector<til::point_span>>&& results, bool complete);
         void _sendInputToConnection(std::wstring_view wstr);
+        void _queueMouseMotion(std::wstring_view wstr);
+        safe_void_coroutine _pasteAsync(const winrt::hstring text, const bool bracketed);
+        void _setPasteProgress(int progress);
+        void _writeInputToConnection(std::wstring_view wstr);
+        safe_void_coroutine _drainInputQueue();
 
 #pragma region TerminalCoreCallbacks
         void _terminalCopyToClipboard(wil::zwstring_view wstr);
@@ -399,6 +486,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         MidiAudio _midiAudio;
         winrt::Windows::System::DispatcherQueueTimer _midiAudioSkipTimer{ nullptr };
+        winrt::Windows::System::DispatcherQueueTimer _hibernationTimer{ nullptr };
 
 #pragma region RendererCallbacks
         void _rendererWarning(const HRESULT hr, wil::zwstring_view parameter);
@@ -409,7 +497,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void _raiseReadOnlyWarning();
         void _updateAntiAliasingMode();
-        void _connectionOutputHandler(const hstring& hstr);
+        void _updateBackgroundPainting();
+        void _updateHibernation(const bool hidden);
+        void _connectionOutputHandler(std::wstring_view wstr);
+        static void __stdcall _nativeConnectionOutputHandler(void* context, const char* data, size_t length) noexcept;
+        void _revokeNativeConnectionOutput() noexcept;
+        void _flushBatchedOutput();
+        void _outputProcessed(std::wstring_view responses);
+        void _flushDeferredUpdates();
         void _updateHoveredCell(const std::optional<til::point> terminalPosition);
         void _setOpacity(const float opacity, const bool focused = true);
 
@@ -379,7 +379,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             }
 
-            SetEndSelectionPoint(pixelPosition);
+            // Unlike SetEndSelectionPoint(), this coalesces the pointer moves into one update per frame.
+            _core->QueueEndSelectionPoint(terminalPosition);
+            _selectionNeedsToBeCopied = true;
         }
 
         _core->SetHoveredCell(terminalPosition.to_core_point());
@@ -428,6 +430,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                                const ::Microsoft::Terminal::Core::ControlKeyStates modifiers,
                                                const Core::Point pixelPosition)
     {
+        // The selection must be complete before we copy it below.
+        _core->FlushPendingSelectionEnd();
+
         const auto terminalPosition = _getTerminalPosition(til::point{ pixelPosition });
         // Short-circuit isReadOnly check to avoid warning dialog
         if (!_core->IsInReadOnlyMode() && _canSendVTMouseInput(modifiers))
@@ -627,6 +632,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                                                                _core->ViewHeight(),
                                                                                _core->BufferHeight()));
         }
+
+        // With smooth scrolling the remaining fraction of a row is rendered as a sub-row offset,
+        // unless the viewport is at the bottom and there's nothing left to reveal below it.
+        if (_core->Settings().SmoothScrolling())
+        {
+            auto offset = static_cast<float>(viewTop) - _internalScrollbarPosition;
+            const auto maxViewTop = _core->BufferHeight() - _core->ViewHeight();
+            if (_core->ScrollOffset() != viewTop || (viewTop >= maxViewTop && offset < 0.0f))
+            {
+                offset = 0.0f;
+            }
+            _core->SetSmoothScrollOffset(offset);
+        }
     }
 
     void ControlInteractivity::_hyperlinkHandler(const std::wstring_view uri)
@@ -678,8 +696,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         // Get the size of the font, which is in pixels
         const til::size fontSize{ _core->GetFont().GetSize() };
+        // Undo the sub-row offset of smooth scrolling, if any, so that we hit the row that's drawn there.
+        auto position = pixelPosition;
+        position.y -= std::lround(_core->SmoothScrollOffset() * fontSize.height);
         // Convert the location in pixels to characters within the current viewport.
-        return pixelPosition / fontSize;
+        return position / fontSize;
     }
 
     bool ControlInteractivity::_sendMouseEventHelper(const til::point terminalPosition,
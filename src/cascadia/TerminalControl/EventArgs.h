@@ -19,6 +19,7 @@
 #include "CharSentEventArgs.g.h"
 #include "StringSentEventArgs.g.h"
 #include "SearchMissingCommandEventArgs.g.h"
+#include "ContextMenuOpeningEventArgs.g.h"
 #include "WindowSizeChangedEventArgs.g.h"
 
 namespace winrt::Microsoft::Terminal::Control::implementation
@@ -225,6 +226,17 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         til::property<til::CoordType> BufferRow;
     };
 
+    struct ContextMenuOpeningEventArgs : public ContextMenuOpeningEventArgsT<ContextMenuOpeningEventArgs>
+    {
+    public:
+        ContextMenuOpeningEventArgs(const winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout& menu, const bool withSelection) :
+            Menu(menu),
+            WithSelection(withSelection) {}
+
+        til::property<winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout> Menu;
+        til::property<bool> WithSelection;
+    };
+
     struct WindowSizeChangedEventArgs : public WindowSizeChangedEventArgsT<WindowSizeChangedEventArgs>
     {
     public:
@@ -383,10 +383,81 @@ void HwndTerminal::SendOutput(std::wstring_view data)
     {
         return;
     }
+
+    {
+        const std::lock_guard guard{ _batchedOutputMutex };
+        if (_outputBatchDepth != 0)
+        {
+            _batchedOutput.append(data);
+            return;
+        }
+    }
+
     const auto lock = _terminal->LockForWriting();
     _terminal->Write(data);
 }
 
+// Method Description:
+// - Same as SendOutput(), but for UTF-8 input, which is what most of the callers
+//   receive from their pipes anyway. Incomplete sequences at the end of the input
+//   are held back until the next call.
+void HwndTerminal::SendOutputUtf8(std::string_view data)
+{
+    if (!_terminal)
+    {
+        return;
+    }
+
+    std::wstring output;
+    {
+        const std::lock_guard guard{ _batchedOutputMutex };
+        THROW_IF_FAILED(til::u8u16(data, output, _u8State));
+    }
+
+    if (!output.empty())
+    {
+        SendOutput(output);
+    }
+}
+
+// Method Description:
+// - Starts collecting the output given to SendOutput() and SendOutputUtf8() until the matching
+//   EndOutputBatch() call. Callers that write line by line can thus avoid paying for the
+//   terminal lock, the parser setup and a render notification for every single line.
+//   Batches may be nested and only the outermost EndOutputBatch() writes the output.
+void HwndTerminal::BeginOutputBatch()
+{
+    const std::lock_guard guard{ _batchedOutputMutex };
+    _outputBatchDepth++;
+}
+
+void HwndTerminal::EndOutputBatch()
+{
+    if (!_terminal)
+    {
+        return;
+    }
+
+    // The terminal lock is acquired first, so that any output that's sent without
+    // a batch after we return is guaranteed to be written after the batch.
+    const auto lock = _terminal->LockForWriting();
+
+    std::wstring output;
+    {
+        const std::lock_guard guard{ _batchedOutputMutex };
+        if (_outputBatchDepth == 0 || --_outputBatchDepth != 0)
+        {
+            return;
+        }
+        output.swap(_batchedOutput);
+    }
+
+    if (!output.empty())
+    {
+        _terminal->Write(output);
+    }
+}
+
 HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal)
 {
     auto publicTerminal = std::make_unique<HwndTerminal>(parentHwnd);
@@ -423,6 +494,30 @@ try
 }
 CATCH_LOG()
 
+void _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, uint32_t length)
+try
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    publicTerminal->SendOutputUtf8({ data, length });
+}
+CATCH_LOG()
+
+void _stdcall TerminalBeginOutputBatch(void* terminal)
+try
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    publicTerminal->BeginOutputBatch();
+}
+CATCH_LOG()
+
+void _stdcall TerminalEndOutputBatch(void* terminal)
+try
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    publicTerminal->EndOutputBatch();
+}
+CATCH_LOG()
+
 /// <summary>
 /// Triggers a terminal resize using the new width and height in pixel.
 /// </summary>
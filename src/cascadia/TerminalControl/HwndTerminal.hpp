@@ -42,6 +42,9 @@ typedef struct _TerminalTheme
 extern "C" {
 __declspec(dllexport) HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal);
 __declspec(dllexport) void _stdcall TerminalSendOutput(void* terminal, LPCWSTR data);
+__declspec(dllexport) void _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, uint32_t length);
+__declspec(dllexport) void _stdcall TerminalBeginOutputBatch(void* terminal);
+__declspec(dllexport) void _stdcall TerminalEndOutputBatch(void* terminal);
 __declspec(dllexport) void _stdcall TerminalRegisterScrollCallback(void* terminal, void __stdcall callback(int, int, int));
 __declspec(dllexport) HRESULT _stdcall TerminalTriggerResize(_In_ void* terminal, _In_ til::CoordType width, _In_ til::CoordType height, _Out_ til::size* dimensions);
 __declspec(dllexport) HRESULT _stdcall TerminalTriggerResizeWithDimension(_In_ void* terminal, _In_ til::size dimensions, _Out_ til::size* dimensionsInPixels);
@@ -76,6 +79,9 @@ public:
     HRESULT Initialize();
     void Teardown() noexcept;
     void SendOutput(std::wstring_view data);
+    void SendOutputUtf8(std::string_view data);
+    void BeginOutputBatch();
+    void EndOutputBatch();
     HRESULT Refresh(const til::size windowSize, _Out_ til::size* dimensions);
     void RegisterScrollCallback(std::function<void(int, int, int)> callback);
     void RegisterWriteCallback(const void _stdcall callback(wchar_t*));
@@ -100,6 +106,14 @@ private:
 
     bool _focused{ false };
 
+    // Between BeginOutputBatch() and EndOutputBatch(), SendOutput() collects the output in _batchedOutput,
+    // so that it's parsed under a single lock and results in a single frame once the batch ends.
+    std::mutex _batchedOutputMutex;
+    std::wstring _batchedOutput;
+    uint32_t _outputBatchDepth{ 0 };
+    // SendOutputUtf8() callers may split UTF-8 sequences across calls.
+    til::u8state _u8State;
+
     std::chrono::milliseconds _multiClickTime;
     unsigned int _multiClickCounter{};
     std::chrono::steady_clock::time_point _lastMouseClickTimestamp{};
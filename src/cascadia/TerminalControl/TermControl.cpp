@@ -7,6 +7,7 @@
 #include <LibraryResources.h>
 
 #include "TermControlAutomationPeer.h"
+#include "UiThreadWatchdog.h"
 #include "../../renderer/atlas/AtlasEngine.h"
 #include "../../tsf/Handle.h"
 
@@ -349,58 +350,6 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         _ApplyUISettings();
 
-        _originalPrimaryElements = winrt::single_threaded_observable_vector<Controls::ICommandBarElement>();
-        _originalSecondaryElements = winrt::single_threaded_observable_vector<Controls::ICommandBarElement>();
-        _originalSelectedPrimaryElements = winrt::single_threaded_observable_vector<Controls::ICommandBarElement>();
-        _originalSelectedSecondaryElements = winrt::single_threaded_observable_vector<Controls::ICommandBarElement>();
-        for (const auto& e : ContextMenu().PrimaryCommands())
-        {
-            _originalPrimaryElements.Append(e);
-        }
-        for (const auto& e : ContextMenu().SecondaryCommands())
-        {
-            _originalSecondaryElements.Append(e);
-        }
-        for (const auto& e : SelectionContextMenu().PrimaryCommands())
-        {
-            _originalSelectedPrimaryElements.Append(e);
-        }
-        for (const auto& e : SelectionContextMenu().SecondaryCommands())
-        {
-            _originalSelectedSecondaryElements.Append(e);
-        }
-        ContextMenu().Closed([weakThis = get_weak()](auto&&, auto&&) {
-            if (auto control{ weakThis.get() }; control && !control->_IsClosing())
-            {
-                const auto& menu{ control->ContextMenu() };
-                menu.PrimaryCommands().Clear();
-                menu.SecondaryCommands().Clear();
-                for (const auto& e : control->_originalPrimaryElements)
-                {
-                    menu.PrimaryCommands().Append(e);
-                }
-                for (const auto& e : control->_originalSecondaryElements)
-                {
-                    menu.SecondaryCommands().Append(e);
-                }
-            }
-        });
-        SelectionContextMenu().Closed([weakThis = get_weak()](auto&&, auto&&) {
-            if (auto control{ weakThis.get() }; control && !control->_IsClosing())
-            {
-                const auto& menu{ control->SelectionContextMenu() };
-                menu.PrimaryCommands().Clear();
-                menu.SecondaryCommands().Clear();
-                for (const auto& e : control->_originalSelectedPrimaryElements)
-                {
-                    menu.PrimaryCommands().Append(e);
-                }
-                for (const auto& e : control->_originalSelectedSecondaryElements)
-                {
-                    menu.SecondaryCommands().Append(e);
-                }
-            }
-        });
         if constexpr (Feature_QuickFix::IsEnabled())
         {
             QuickFixMenu().Closed([weakThis = get_weak()](auto&&, auto&&) {
@@ -495,6 +444,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // * we're already not closing
         // * caller already checked weak ptr to make sure we're still alive
 
+        const UiThreadWatchdog::Scope watchdog{ ContentId(), "UpdateScrollbar" };
+
         _isInternalScrollBarUpdate = true;
 
         auto scrollBar = ScrollBar();
@@ -521,18 +472,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             const auto canvas = FindName(L"ScrollBarCanvas").as<Controls::Image>();
             auto source = canvas.Source().try_as<Media::Imaging::WriteableBitmap>();
 
+            auto recreated = false;
             if (!source || scrollBarWidthInPx != source.PixelWidth() || scrollBarHeightInPx != source.PixelHeight())
             {
                 source = Media::Imaging::WriteableBitmap{ scrollBarWidthInPx, scrollBarHeightInPx };
                 canvas.Source(source);
                 canvas.Width(scrollBarWidthInDIP);
                 canvas.Height(scrollBarHeightInDIP);
+                recreated = true;
             }
 
-            const auto buffer = source.PixelBuffer();
-            const auto data = buffer.data();
-            const auto stride = scrollBarWidthInPx * sizeof(til::color);
-
             // The bitmap has the size of the entire scrollbar, but we want the marks to only show in the range the "thumb"
             // (the scroll indicator) can move. That's why we need to add an offset to the start of the drawable bitmap area
             // (to offset the decrease button) and subtract twice that (to offset the increase button as well).
@@ -541,76 +490,98 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             // for the "VerticalDecrementTemplate" (and similar for the increment), but it seems neither of those is correct,
             // because a padding for 3 DIPs seem to be the exact right amount to add.
             const auto increaseDecreaseButtonHeight = scrollBarWidthInPx + lround(3 * scaleFactor);
-            const auto drawableDataStart = data + stride * increaseDecreaseButtonHeight;
             const auto drawableRange = scrollBarHeightInPx - 2 * increaseDecreaseButtonHeight;
+            const auto pipHeight = lround(1 * scaleFactor);
+            const auto maxOffsetY = drawableRange - pipHeight;
 
             // Protect the remaining code against negative offsets. This normally can't happen
             // and this code just exists so it doesn't crash if I'm ever wrong about this.
             // (The window has a min. size that ensures that there's always a scrollbar thumb.)
-            if (drawableRange < 0)
+            if (maxOffsetY < 0)
             {
                 return;
             }
 
-            // The scrollbar bitmap is divided into 3 evenly sized stripes:
-            // Left: Regular marks
-            // Center: nothing
-            // Right: Search marks
-            const auto pipWidth = (scrollBarWidthInPx + 1) / 3;
-            const auto pipHeight = lround(1 * scaleFactor);
-
-            const auto maxOffsetY = drawableRange - pipHeight;
+            // The marks are first aggregated into one bucket per pixel row for each of the two stripes (see below).
+            // With thousands of marks or search results most of them share a pixel row and the bitmap only needs
+            // to be redrawn (and uploaded by Invalidate()) if the buckets changed. During streaming output that's
+            // rare, because only the growth of the buffer moves the marks by at least a pixel.
+            // 0 means "no pip", which is fine, because the pixels are always opaque.
+            const auto buckets = gsl::narrow_cast<size_t>(maxOffsetY) + 1;
+            std::vector<DWORD> stripes(2 * buckets);
             const auto offsetScale = maxOffsetY / gsl::narrow_cast<float>(update.newMaximum + update.newViewportSize);
-            // A helper to turn a TextBuffer row offset into a bitmap offset.
-            const auto dataAt = [&](til::CoordType row) [[msvc::forceinline]] {
-                const auto y = std::clamp<long>(lrintf(row * offsetScale), 0, maxOffsetY);
-                return drawableDataStart + stride * y;
+            // A helper to turn a TextBuffer row offset into a bucket index.
+            const auto bucketAt = [&](til::CoordType row) [[msvc::forceinline]] {
+                return gsl::narrow_cast<size_t>(std::clamp<long>(lrintf(row * offsetScale), 0, maxOffsetY));
             };
-            // A helper to draw a single pip (mark) at the given location.
-            const auto drawPip = [&](uint8_t* beg, til::color color) [[msvc::forceinline]] {
-                const auto end = beg + pipHeight * stride;
-                for (; beg < end; beg += stride)
-                {
-                    // a til::color does NOT have the same RGBA format as the bitmap.
-#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
-                    const DWORD c = 0xff << 24 | color.r << 16 | color.g << 8 | color.b;
-                    std::fill_n(reinterpret_cast<DWORD*>(beg), pipWidth, c);
-                }
+            // a til::color does NOT have the same RGBA format as the bitmap.
+            const auto toPixel = [](til::color color) [[msvc::forceinline]] -> DWORD {
+                return 0xff << 24 | color.r << 16 | color.g << 8 | color.b;
             };
 
-            memset(data, 0, buffer.Length());
-
             if (const auto marks = _core.ScrollMarks())
             {
                 for (const auto& m : marks)
                 {
-                    const auto row = m.Row;
-                    const til::color color{ m.Color.Color };
-                    const auto base = dataAt(row);
-                    drawPip(base, color);
+                    til::at(stripes, bucketAt(m.Row)) = toPixel(til::color{ m.Color.Color });
                 }
             }
 
             if (_searchBox && _searchBox->IsOpen())
             {
                 const auto core = winrt::get_self<ControlCore>(_core);
-                const auto& searchMatches = core->SearchResultRows();
-                const auto color = core->ForegroundColor();
+                const auto color = toPixel(core->ForegroundColor());
+
+                for (const auto& span : core->SearchResultRows())
+                {
+                    til::at(stripes, buckets + bucketAt(span.start.y)) = color;
+                }
+            }
+
+            if (recreated || stripes != _scrollBarMarkStripes)
+            {
+                _scrollBarMarkStripes = std::move(stripes);
+
+                const auto buffer = source.PixelBuffer();
+                const auto data = buffer.data();
+                const auto stride = scrollBarWidthInPx * sizeof(til::color);
+                const auto drawableDataStart = data + stride * increaseDecreaseButtonHeight;
+
+                // The scrollbar bitmap is divided into 3 evenly sized stripes:
+                // Left: Regular marks
+                // Center: nothing
+                // Right: Search marks
+                const auto pipWidth = (scrollBarWidthInPx + 1) / 3;
                 const auto rightAlignedOffset = (scrollBarWidthInPx - pipWidth) * sizeof(til::color);
-                til::CoordType lastRow = til::CoordTypeMin;
 
-                for (const auto& span : searchMatches)
+                // A helper to draw a single pip (mark) at the given location.
+                const auto drawPip = [&](uint8_t* beg, DWORD c) [[msvc::forceinline]] {
+                    const auto end = beg + pipHeight * stride;
+                    for (; beg < end; beg += stride)
+                    {
+#pragma warning(suppress : 26490) // Don't use reinterpret_cast (type.1).
+                        std::fill_n(reinterpret_cast<DWORD*>(beg), pipWidth, c);
+                    }
+                };
+
+                memset(data, 0, buffer.Length());
+
+                for (size_t y = 0; y < buckets; ++y)
                 {
-                    if (lastRow != span.start.y)
+                    const auto base = drawableDataStart + stride * y;
+                    if (const auto c = til::at(_scrollBarMarkStripes, y))
                     {
-                        lastRow = span.start.y;
-                        const auto base = dataAt(lastRow) + rightAlignedOffset;
-                        drawPip(base, color);
+                        drawPip(base, c);
+                    }
+                    if (const auto c = til::at(_scrollBarMarkStripes, buckets + y))
+                    {
+                        drawPip(base + rightAlignedOffset, c);
                     }
                 }
+
+                source.Invalidate();
             }
 
-            source.Invalidate();
             canvas.Visibility(Visibility::Visible);
         }
     }
@@ -666,11 +637,20 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         else
         {
+            _cancelSearch();
             const auto request = SearchRequest{ _searchBox->Text(), goForward, _searchBox->CaseSensitive(), _searchBox->RegularExpression(), false, _searchScrollOffset };
             _handleSearchResults(_core.Search(request));
         }
     }
 
+    // Method Description:
+    // - Searches the entire buffer in the background. See ControlCore::SearchAllAsync.
+    //   This allows callers to search many controls in parallel, as it doesn't block on the UI thread.
+    Windows::Foundation::IAsyncOperationWithProgress<int32_t, Windows::Foundation::Collections::IVectorView<Control::SearchResultSpan>> TermControl::SearchAllAsync(const SearchRequest& request)
+    {
+        return _core.SearchAllAsync(request);
+    }
+
     // Method Description:
     // Find if search box text edit currently is in focus
     // Return Value:
@@ -701,6 +681,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         if (_searchBox && _searchBox->IsOpen())
         {
+            const UiThreadWatchdog::Scope watchdog{ ContentId(), "Search" };
+            _cancelSearch();
             const auto request = SearchRequest{ text, goForward, caseSensitive, regularExpression, false, _searchScrollOffset };
             _handleSearchResults(_core.Search(request));
         }
@@ -721,11 +703,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         if (_searchBox && _searchBox->IsOpen())
         {
+            const UiThreadWatchdog::Scope watchdog{ ContentId(), "SearchChanged" };
             // We only want to update the search results based on the new text. Set
             // `resetOnly` to true so we don't accidentally update the current match index.
             const auto request = SearchRequest{ text, goForward, caseSensitive, regularExpression, true, _searchScrollOffset };
-            const auto result = _core.Search(request);
-            _handleSearchResults(result);
+            _searchAsync(request);
         }
     }
 
@@ -741,6 +723,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                              const RoutedEventArgs& /*args*/)
     {
         _searchBox->Close();
+        _cancelSearch();
         _core.ClearSearch();
 
         // Clear search highlights scroll marks (by triggering an update after closing the search box)
@@ -882,6 +865,43 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _core.ToggleShaderEffects();
     }
 
+    // Method Description:
+    // - Shows or hides an overlay with percentiles of how long each phase
+    //   of the recently rendered frames took. The renderer only measures
+    //   these while the overlay is visible (or a trace session is listening).
+    void TermControl::ToggleRenderStatistics()
+    {
+        if (_renderStatisticsTimer.IsEnabled())
+        {
+            _renderStatisticsTimer.Stop();
+            _core.SetRenderStatisticsEnabled(false);
+            RenderStatisticsOverlay().Visibility(Visibility::Collapsed);
+            return;
+        }
+
+        if (!FindName(L"RenderStatisticsOverlay"))
+        {
+            return;
+        }
+
+        _core.SetRenderStatisticsEnabled(true);
+        RenderStatisticsText().Text(_core.RenderStatistics());
+        RenderStatisticsOverlay().Visibility(Visibility::Visible);
+
+        _renderStatisticsTimer.Interval(std::chrono::milliseconds(500));
+        _renderStatisticsTimer.Tick({ get_weak(), &TermControl::_RenderStatisticsTimerTick });
+        _renderStatisticsTimer.Start();
+    }
+
+    void TermControl::_RenderStatisticsTimerTick(const Windows::Foundation::IInspectable& /* sender */,
+                                                 const Windows::Foundation::IInspectable& /* e */)
+    {
+        if (!_IsClosing())
+        {
+            RenderStatisticsText().Text(_core.RenderStatistics());
+        }
+    }
+
     // Method Description:
     // - Style our UI elements based on the values in our settings, and set up
     //   other control-specific settings. This method will be called whenever
@@ -1375,8 +1395,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         if (blinkTime != INFINITE)
         {
             // Create a timer
-            _cursorTimer.Interval(std::chrono::milliseconds(blinkTime));
-            _cursorTimer.Tick({ get_weak(), &TermControl::_CursorTimerTick });
+            _cursorTimer.Initialize(std::chrono::milliseconds(blinkTime), [weakThis = get_weak()]() {
+                if (const auto self = weakThis.get())
+                {
+                    self->_CursorTimerTick();
+                }
+            });
             // As of GH#6586, don't start the cursor timer immediately, and
             // don't show the cursor initially. We'll show the cursor and start
             // the timer when the control is first focused.
@@ -1404,10 +1428,17 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         SystemParametersInfoW(SPI_GETCLIENTAREAANIMATION, 0, &animationsEnabled, 0);
         if (animationsEnabled && blinkTime != INFINITE)
         {
-            // Create a timer
-            _blinkTimer.Interval(std::chrono::milliseconds(blinkTime));
-            _blinkTimer.Tick({ get_weak(), &TermControl::_BlinkTimerTick });
-            _blinkTimer.Start();
+            // Create a timer. Just like the cursor timer, it only runs while we're focused.
+            _blinkTimer.Initialize(std::chrono::milliseconds(blinkTime), [weakThis = get_weak()]() {
+                if (const auto self = weakThis.get())
+                {
+                    self->_BlinkTimerTick();
+                }
+            });
+            if (_focused)
+            {
+                _blinkTimer.Start();
+            }
         }
         else
         {
@@ -1523,6 +1554,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _core.SendInput(text);
     }
 
+    void TermControl::SetInputQueueingEnabled(bool enabled)
+    {
+        _core.SetInputQueueingEnabled(enabled);
+    }
+
     // Method Description:
     // - Manually handles key events for certain keys that can't be passed to us
     //   normally. Namely, the keys we're concerned with are F7 down and Alt up.
@@ -1548,6 +1584,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     void TermControl::_KeyHandler(const Input::KeyRoutedEventArgs& e, const bool keyDown)
     {
+        const UiThreadWatchdog::Scope watchdog{ ContentId(), "Key" };
         const auto keyStatus = e.KeyStatus();
         const auto vkey = gsl::narrow_cast<WORD>(e.OriginalKey());
         const auto scanCode = gsl::narrow_cast<WORD>(keyStatus.ScanCode);
@@ -1947,6 +1984,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
+        const UiThreadWatchdog::Scope watchdog{ ContentId(), "PointerPressed" };
+
         RestorePointerCursor.raise(*this, nullptr);
 
         _CapturePointer(sender, args);
@@ -2003,6 +2042,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
+        const UiThreadWatchdog::Scope watchdog{ ContentId(), "PointerMoved" };
+
         RestorePointerCursor.raise(*this, nullptr);
 
         const auto ptr = args.Pointer();
@@ -2462,6 +2503,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
+        const UiThreadWatchdog::Scope watchdog{ ContentId(), "SizeChanged" };
+
         const auto newSize = e.NewSize();
         _core.SizeChanged(newSize.Width, newSize.Height);
 
@@ -2509,10 +2552,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // Method Description:
     // - Toggle the cursor on and off when called by the cursor blink timer.
     // Arguments:
-    // - sender: not used
-    // - e: not used
-    void TermControl::_CursorTimerTick(const Windows::Foundation::IInspectable& /* sender */,
-                                       const Windows::Foundation::IInspectable& /* e */)
+    // - <none>
+    void TermControl::_CursorTimerTick()
     {
         if (!_IsClosing())
         {
@@ -2523,10 +2564,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // Method Description:
     // - Toggle the blinking rendition state when called by the blink timer.
     // Arguments:
-    // - sender: not used
-    // - e: not used
-    void TermControl::_BlinkTimerTick(const Windows::Foundation::IInspectable& /* sender */,
-                                      const Windows::Foundation::IInspectable& /* e */)
+    // - <none>
+    void TermControl::_BlinkTimerTick()
     {
         if (!_IsClosing())
         {
@@ -2612,6 +2651,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return false;
         }
 
+        const UiThreadWatchdog::Scope watchdog{ ContentId(), "Copy" };
+
         const auto successfulCopy = _interactivity.CopySelectionToClipboard(singleLine, withControlSequences, formats);
 
         if (dismissSelection)
@@ -2675,6 +2716,22 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Like PersistToPath(), but writes the buffer on a background thread.
+    //   This is used to periodically save the buffer while we're running,
+    //   so that a crash doesn't lose everything since the last exit.
+    safe_void_coroutine TermControl::CheckpointToPath(winrt::hstring path) const
+    {
+        if (!_initializedTerminal)
+        {
+            co_return;
+        }
+
+        const auto core = _core;
+        co_await winrt::resume_background();
+        winrt::get_self<ControlCore>(core)->PersistToPath(path.c_str());
+    }
+
     void TermControl::Close()
     {
         if (!_IsClosing())
@@ -2699,6 +2756,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             _bellLightTimer.Stop();
             _cursorTimer.Stop();
             _blinkTimer.Stop();
+            _renderStatisticsTimer.Stop();
 
             // This is absolutely crucial, as the TSF code tries to hold a strong reference to _tsfDataProvider,
             // but right now _tsfDataProvider implements IUnknown as a no-op. This ensures that TSF stops referencing us.
@@ -2988,6 +3046,27 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _core.WindowVisibilityChanged(showOrHide);
     }
 
+    // Method Description:
+    // - TerminalPage swaps the content of the selected tab in and out of the UI tree,
+    //   so Loaded and Unloaded tell us whether we're part of a visible tab or not.
+    //   When a pane gets moved around, XAML may raise Loaded for the new parent
+    //   before Unloaded for the old one, which is why this is a counter.
+    void TermControl::_LoadedHandler(const IInspectable& /*sender*/, const RoutedEventArgs& /*args*/)
+    {
+        if (++_loadedCount == 1 && !_IsClosing() && !_detached)
+        {
+            _core.PaneVisibilityChanged(true);
+        }
+    }
+
+    void TermControl::_UnloadedHandler(const IInspectable& /*sender*/, const RoutedEventArgs& /*args*/)
+    {
+        if (--_loadedCount == 0 && !_IsClosing() && !_detached)
+        {
+            _core.PaneVisibilityChanged(false);
+        }
+    }
+
     // Method Description:
     // - Create XAML Thickness object based on padding props provided.
     //   Used for controlling the TermControl XAML Grid container's Padding prop.
@@ -3551,6 +3630,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             return;
         }
 
+        // The tooltip is only created once the first hyperlink is hovered.
+        if (!FindName(L"HyperlinkTooltipBorder"))
+        {
+            return;
+        }
+
         // Attackers abuse Unicode characters that happen to look similar to ASCII characters. Cyrillic for instance has
         // its own glyphs for а, с, е, о, р, х, and у that look practically identical to their ASCII counterparts.
         // This is called an "IDN homoglyph attack".
@@ -3804,6 +3889,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return _core.CurrentWorkingDirectory();
     }
 
+    Control::PerformanceCounters TermControl::GetPerformanceCounters()
+    {
+        return _core.GetPerformanceCounters();
+    }
+
     void TermControl::UpdateWinGetSuggestions(Windows::Foundation::Collections::IVector<hstring> suggestions)
     {
         get_self<ControlCore>(_core)->UpdateQuickFixes(suggestions);
@@ -3863,7 +3953,44 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const auto caseSensitive = _searchBox->CaseSensitive();
         const auto regularExpression = _searchBox->RegularExpression();
         const auto request = SearchRequest{ text, goForward, caseSensitive, regularExpression, true, _searchScrollOffset };
-        _handleSearchResults(_core.Search(request));
+        _searchAsync(request);
+    }
+
+    // Method Description:
+    // - Starts a background search via ControlCore::SearchAsync, cancelling the one that may still be in progress.
+    //   The matches in the viewport and then those in the entire buffer are shown as they arrive.
+    void TermControl::_searchAsync(const SearchRequest& request)
+    {
+        _cancelSearch();
+
+        const auto weakThis{ get_weak() };
+        _searchOperation = _core.SearchAsync(request);
+        _searchOperation.Progress([weakThis](auto&&, const SearchResults& results) {
+            if (const auto self = weakThis.get())
+            {
+                self->_handleSearchResults(results);
+            }
+        });
+        _searchOperation.Completed([weakThis](const auto& operation, const Windows::Foundation::AsyncStatus status) {
+            const auto self = weakThis.get();
+            if (!self || status != Windows::Foundation::AsyncStatus::Completed)
+            {
+                return;
+            }
+            if (self->_searchOperation == operation)
+            {
+                self->_searchOperation = nullptr;
+            }
+            self->_handleSearchResults(operation.GetResults());
+        });
+    }
+
+    void TermControl::_cancelSearch()
+    {
+        if (const auto operation = std::exchange(_searchOperation, nullptr))
+        {
+            operation.Cancel();
+        }
     }
 
     void TermControl::_handleSearchResults(SearchResults results)
@@ -4001,8 +4128,114 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         });
     }
 
+    winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout TermControl::ContextMenu()
+    {
+        _loadContextMenus();
+        return _contextMenu;
+    }
+
+    winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout TermControl::SelectionContextMenu()
+    {
+        _loadContextMenus();
+        return _selectionContextMenu;
+    }
+
+    // Method Description:
+    // - Creates the two context menus from our resources, unless that happened already.
+    //   Most controls never show them, which is why this isn't done in the constructor.
+    // - Whoever populates the menus with additional items should do so in
+    //   the ContextMenuOpening event. The items are removed again on close.
+    void TermControl::_loadContextMenus()
+    {
+        if (_contextMenu)
+        {
+            return;
+        }
+
+        const auto resources = Resources();
+        _contextMenu = resources.Lookup(winrt::box_value(L"ContextMenu")).as<winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout>();
+        _selectionContextMenu = resources.Lookup(winrt::box_value(L"SelectionContextMenu")).as<winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout>();
+
+        _originalPrimaryElements = winrt::single_threaded_observable_vector<Controls::ICommandBarElement>();
+        _originalSecondaryElements = winrt::single_threaded_observable_vector<Controls::ICommandBarElement>();
+        _originalSelectedPrimaryElements = winrt::single_threaded_observable_vector<Controls::ICommandBarElement>();
+        _originalSelectedSecondaryElements = winrt::single_threaded_observable_vector<Controls::ICommandBarElement>();
+        for (const auto& e : _contextMenu.PrimaryCommands())
+        {
+            _originalPrimaryElements.Append(e);
+        }
+        for (const auto& e : _contextMenu.SecondaryCommands())
+        {
+            _originalSecondaryElements.Append(e);
+        }
+        for (const auto& e : _selectionContextMenu.PrimaryCommands())
+        {
+            _originalSelectedPrimaryElements.Append(e);
+        }
+        for (const auto& e : _selectionContextMenu.SecondaryCommands())
+        {
+            _originalSelectedSecondaryElements.Append(e);
+        }
+        _contextMenu.Opening([weakThis = get_weak()](auto&&, auto&&) {
+            if (auto control{ weakThis.get() }; control && !control->_IsClosing())
+            {
+                control->ContextMenuOpening.raise(*control, winrt::make<ContextMenuOpeningEventArgs>(control->_contextMenu, false));
+            }
+        });
+        _selectionContextMenu.Opening([weakThis = get_weak()](auto&&, auto&&) {
+            if (auto control{ weakThis.get() }; control && !control->_IsClosing())
+            {
+                control->ContextMenuOpening.raise(*control, winrt::make<ContextMenuOpeningEventArgs>(control->_selectionContextMenu, true));
+            }
+        });
+        _contextMenu.Closed([weakThis = get_weak()](auto&&, auto&&) {
+            if (auto control{ weakThis.get() }; control && !control->_IsClosing())
+            {
+                const auto& menu{ control->_contextMenu };
+                menu.PrimaryCommands().Clear();
+                menu.SecondaryCommands().Clear();
+                for (const auto& e : control->_originalPrimaryElements)
+                {
+                    menu.PrimaryCommands().Append(e);
+                }
+                for (const auto& e : control->_originalSecondaryElements)
+                {
+                    menu.SecondaryCommands().Append(e);
+                }
+            }
+        });
+        _selectionContextMenu.Closed([weakThis = get_weak()](auto&&, auto&&) {
+            if (auto control{ weakThis.get() }; control && !control->_IsClosing())
+            {
+                const auto& menu{ control->_selectionContextMenu };
+                menu.PrimaryCommands().Clear();
+                menu.SecondaryCommands().Clear();
+                for (const auto& e : control->_originalSelectedPrimaryElements)
+                {
+                    menu.PrimaryCommands().Append(e);
+                }
+                for (const auto& e : control->_originalSelectedSecondaryElements)
+                {
+                    menu.SecondaryCommands().Append(e);
+                }
+            }
+        });
+    }
+
+    // Hides the context menus, without creating them if they don't exist yet.
+    void TermControl::_hideContextMenus()
+    {
+        if (_contextMenu)
+        {
+            _contextMenu.Hide();
+            _selectionContextMenu.Hide();
+        }
+    }
+
     void TermControl::_showContextMenuAt(const winrt::Windows::Foundation::Point& controlRelativePos)
     {
+        _loadContextMenus();
+
         Controls::Primitives::FlyoutShowOptions myOption{};
         myOption.ShowMode(Controls::Primitives::FlyoutShowMode::Standard);
         myOption.Placement(Controls::Primitives::FlyoutPlacementMode::TopEdgeAlignedLeft);
@@ -4017,8 +4250,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         SelectCommandWithSelectionButton().Visibility(shouldShowSelectCommand ? Visibility::Visible : Visibility::Collapsed);
         SelectOutputWithSelectionButton().Visibility(shouldShowSelectOutput ? Visibility::Visible : Visibility::Collapsed);
 
-        (_core.HasSelection() ? SelectionContextMenu() :
-                                ContextMenu())
+        (_core.HasSelection() ? _selectionContextMenu :
+                                _contextMenu)
             .ShowAt(*this, myOption);
     }
 
@@ -4168,22 +4401,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                            const IInspectable& /*args*/)
     {
         _interactivity.RequestPasteTextFromClipboard();
-        ContextMenu().Hide();
-        SelectionContextMenu().Hide();
+        _hideContextMenus();
     }
     void TermControl::_CopyCommandHandler(const IInspectable& /*sender*/,
                                           const IInspectable& /*args*/)
     {
         // formats = nullptr -> copy all formats
         _interactivity.CopySelectionToClipboard(false, false, nullptr);
-        ContextMenu().Hide();
-        SelectionContextMenu().Hide();
+        _hideContextMenus();
     }
     void TermControl::_SearchCommandHandler(const IInspectable& /*sender*/,
                                             const IInspectable& /*args*/)
     {
-        ContextMenu().Hide();
-        SelectionContextMenu().Hide();
+        _hideContextMenus();
 
         // CreateSearchBoxControl will actually create the search box and
         // pre-populate the box with the currently selected text.
@@ -4193,16 +4423,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     void TermControl::_SelectCommandHandler(const IInspectable& /*sender*/,
                                             const IInspectable& /*args*/)
     {
-        ContextMenu().Hide();
-        SelectionContextMenu().Hide();
+        _hideContextMenus();
         _core.ContextMenuSelectCommand();
     }
 
     void TermControl::_SelectOutputHandler(const IInspectable& /*sender*/,
                                            const IInspectable& /*args*/)
     {
-        ContextMenu().Hide();
-        SelectionContextMenu().Hide();
+        _hideContextMenus();
         _core.ContextMenuSelectOutput();
     }
 
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "BlinkScheduler.h"
 #include "SearchBoxControl.h"
 #include "TermControl.g.h"
 #include "../../buffer/out/search.h"
@@ -69,6 +70,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool ExpandSelectionToWord();
         void RestoreFromPath(winrt::hstring path);
         void PersistToPath(const winrt::hstring& path) const;
+        safe_void_coroutine CheckpointToPath(winrt::hstring path) const;
         void Close();
         Windows::Foundation::Size CharacterDimensions() const;
         Windows::Foundation::Size MinimumSize();
@@ -117,6 +119,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void SelectOutput(const bool goUp);
 
         winrt::hstring CurrentWorkingDirectory() const;
+
+        Control::PerformanceCounters GetPerformanceCounters();
 #pragma endregion
 
         void ScrollViewport(int viewTop);
@@ -129,6 +133,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void ClearBuffer(Control::ClearBufferType clearType);
 
         void ToggleShaderEffects();
+        void ToggleRenderStatistics();
 
         void RenderEngineSwapChainChanged(IInspectable sender, IInspectable args);
         void _AttachDxgiSwapChainToXaml(HANDLE swapChainHandle);
@@ -141,6 +146,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void CreateSearchBoxControl();
 
         void SearchMatch(const bool goForward);
+        Windows::Foundation::IAsyncOperationWithProgress<int32_t, Windows::Foundation::Collections::IVectorView<Control::SearchResultSpan>> SearchAllAsync(const SearchRequest& request);
 
         bool SearchBoxEditInFocus() const;
 
@@ -183,8 +189,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         bool RawWriteKeyEvent(const WORD vkey, const WORD scanCode, const winrt::Microsoft::Terminal::Core::ControlKeyStates modifiers, const bool keyDown);
         bool RawWriteChar(const wchar_t character, const WORD scanCode, const winrt::Microsoft::Terminal::Core::ControlKeyStates modifiers);
         void RawWriteString(const winrt::hstring& text);
+        void SetInputQueueingEnabled(bool enabled);
 
         void ShowContextMenu();
+        winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout ContextMenu();
+        winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout SelectionContextMenu();
         bool OpenQuickFixMenu();
         void RefreshQuickFixMenu();
         void ClearQuickFix();
@@ -206,6 +215,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         til::typed_event<> HidePointerCursor;
         til::typed_event<> RestorePointerCursor;
         til::typed_event<> ReadOnlyChanged;
+        til::typed_event<IInspectable, Control::ContextMenuOpeningEventArgs> ContextMenuOpening;
         til::typed_event<IInspectable, IInspectable> FocusFollowMouseRequested;
         til::typed_event<Control::TermControl, Windows::UI::Xaml::RoutedEventArgs> Initialized;
         til::typed_event<> WarningBell;
@@ -250,6 +260,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         Control::ControlCore _core{ nullptr };
         TsfDataProvider _tsfDataProvider{ this };
         winrt::com_ptr<SearchBoxControl> _searchBox;
+        Windows::Foundation::IAsyncOperationWithProgress<SearchResults, SearchResults> _searchOperation{ nullptr };
 
         enum class AltNumpadEncoding
         {
@@ -309,17 +320,24 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         winrt::Windows::UI::Composition::ScalarKeyFrameAnimation _bellDarkAnimation{ nullptr };
         SafeDispatcherTimer _bellLightTimer;
 
-        SafeDispatcherTimer _cursorTimer;
-        SafeDispatcherTimer _blinkTimer;
+        BlinkScheduler::Timer _cursorTimer;
+        BlinkScheduler::Timer _blinkTimer;
+        SafeDispatcherTimer _renderStatisticsTimer;
 
         winrt::Windows::UI::Xaml::Controls::SwapChainPanel::LayoutUpdated_revoker _layoutUpdatedRevoker;
         winrt::hstring _restorePath;
         bool _showMarksInScrollbar{ false };
+        // The pixel colors of the two pip stripes in the ScrollBarCanvas, one bucket per pixel row. See _throttledUpdateScrollbar().
+        std::vector<DWORD> _scrollBarMarkStripes;
 
         bool _isBackgroundLight{ false };
         bool _detached{ false };
+        int _loadedCount = 0;
         til::CoordType _searchScrollOffset = 0;
 
+        // Created by _loadContextMenus() the first time they're needed.
+        winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout _contextMenu{ nullptr };
+        winrt::Microsoft::UI::Xaml::Controls::CommandBarFlyout _selectionContextMenu{ nullptr };
         Windows::Foundation::Collections::IObservableVector<Windows::UI::Xaml::Controls::ICommandBarElement> _originalPrimaryElements{ nullptr };
         Windows::Foundation::Collections::IObservableVector<Windows::UI::Xaml::Controls::ICommandBarElement> _originalSecondaryElements{ nullptr };
         Windows::Foundation::Collections::IObservableVector<Windows::UI::Xaml::Controls::ICommandBarElement> _originalSelectedPrimaryElements{ nullptr };
@@ -378,15 +396,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void _GotFocusHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& e);
         void _LostFocusHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& e);
+        void _LoadedHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& e);
+        void _UnloadedHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& e);
 
         safe_void_coroutine _DragDropHandler(Windows::Foundation::IInspectable sender, Windows::UI::Xaml::DragEventArgs e);
         void _DragOverHandler(const Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::DragEventArgs& e);
 
         safe_void_coroutine _HyperlinkHandler(Windows::Foundation::IInspectable sender, Control::OpenHyperlinkEventArgs e);
 
-        void _CursorTimerTick(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
-        void _BlinkTimerTick(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
+        void _CursorTimerTick();
+        void _BlinkTimerTick();
         void _BellLightOff(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
+        void _RenderStatisticsTimerTick(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
 
         void _SetEndSelectionPointAtCursor(const Windows::Foundation::Point& cursorPosition);
 
@@ -420,6 +441,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _SearchChanged(const winrt::hstring& text, const bool goForward, const bool caseSensitive, const bool regularExpression);
         void _CloseSearchBoxControl(const winrt::Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& args);
         void _refreshSearch();
+        void _searchAsync(const SearchRequest& request);
+        void _cancelSearch();
         void _handleSearchResults(SearchResults results);
 
         void _hoveredHyperlinkChanged(const IInspectable& sender, const IInspectable& args);
@@ -438,6 +461,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void _contextMenuHandler(IInspectable sender, Control::ContextMenuRequestedEventArgs args);
         void _showContextMenuAt(const winrt::Windows::Foundation::Point& controlRelativePos);
+        void _loadContextMenus();
+        void _hideContextMenus();
 
         void _bubbleSearchMissingCommand(const IInspectable& sender, const Control::SearchMissingCommandEventArgs& args);
         winrt::fire_and_forget _bubbleWindowSizeChanged(const IInspectable& sender, Control::WindowSizeChangedEventArgs args);
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "UiThreadWatchdog.h"
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    static uint32_t toMilliseconds(std::chrono::steady_clock::duration duration) noexcept
+    {
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+        return gsl::narrow_cast<uint32_t>(std::clamp<decltype(ms)>(ms, 0, UINT32_MAX));
+    }
+
+    UiThreadWatchdog::Scope::Scope(uint64_t paneId, const char* operation) noexcept
+    {
+        auto& watchdog = _get();
+        if (watchdog._depth++ == 0)
+        {
+            _watchdog = &watchdog;
+            _start = std::chrono::steady_clock::now();
+            _watchdog->_begin(paneId, operation, _start);
+        }
+    }
+
+    UiThreadWatchdog::Scope::~Scope()
+    {
+        if (_watchdog)
+        {
+            _watchdog->_end(_start);
+        }
+        else
+        {
+            _get()._depth--;
+        }
+    }
+
+    UiThreadWatchdog::UiThreadWatchdog() noexcept :
+        _timer{ CreateThreadpoolTimer(&_timerCallback, this, nullptr) }
+    {
+        LOG_LAST_ERROR_IF(!_timer);
+    }
+
+    UiThreadWatchdog& UiThreadWatchdog::_get() noexcept
+    {
+        // Each window has its own UI thread, so each one gets its own watchdog.
+        static thread_local UiThreadWatchdog watchdog;
+        return watchdog;
+    }
+
+    void __stdcall UiThreadWatchdog::_timerCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
+    {
+        const auto self = static_cast<UiThreadWatchdog*>(context);
+        const auto startTicks = self->_startTicks.load(std::memory_order_acquire);
+        if (startTicks == 0)
+        {
+            return;
+        }
+
+        // The Scope that armed the timer may have ended and another one may have started since.
+        // That one re-armed the timer, but the callback for the previous one may already be running.
+        const auto elapsed = std::chrono::steady_clock::now() - std::chrono::steady_clock::time_point{ std::chrono::steady_clock::duration{ startTicks } };
+        if (elapsed < StallThreshold)
+        {
+            return;
+        }
+
+        TraceLoggingWrite(g_hTerminalControlProvider,
+                          "UiThreadStallDetected",
+                          TraceLoggingDescription("A pane has kept its UI thread busy for too long and is still running"),
+                          TraceLoggingUInt64(self->_paneId.load(std::memory_order_relaxed), "paneId"),
+                          TraceLoggingString(self->_operation.load(std::memory_order_relaxed), "operation"),
+                          TraceLoggingUInt32(toMilliseconds(elapsed), "elapsedMs"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_WARNING),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
+
+    void UiThreadWatchdog::_begin(uint64_t paneId, const char* operation, std::chrono::steady_clock::time_point start) noexcept
+    {
+        // The pane and operation are written before the start time, so if the
+        // callback sees a start time, the other two are at worst a tad newer.
+        _paneId.store(paneId, std::memory_order_relaxed);
+        _operation.store(operation, std::memory_order_relaxed);
+        _startTicks.store(start.time_since_epoch().count(), std::memory_order_release);
+
+        if (_timer)
+        {
+            // Negative due times are relative, in units of 100ns.
+            const auto due = -std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>>(StallThreshold).count();
+            FILETIME dueTime;
+            memcpy(&dueTime, &due, sizeof(dueTime));
+            SetThreadpoolTimerEx(_timer.get(), &dueTime, 0, 0);
+        }
+    }
+
+    void UiThreadWatchdog::_end(std::chrono::steady_clock::time_point start) noexcept
+    {
+        _depth--;
+        _startTicks.store(0, std::memory_order_relaxed);
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed < StallThreshold)
+        {
+            return;
+        }
+
+        TraceLoggingWrite(g_hTerminalControlProvider,
+                          "UiThreadStall",
+                          TraceLoggingDescription("A pane has kept its UI thread busy for too long"),
+                          TraceLoggingUInt64(_paneId.load(std::memory_order_relaxed), "paneId"),
+                          TraceLoggingString(_operation.load(std::memory_order_relaxed), "operation"),
+                          TraceLoggingUInt32(toMilliseconds(elapsed), "durationMs"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_WARNING),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+namespace winrt::Microsoft::Terminal::Control::implementation
+{
+    // All panes in a window share its UI thread, so a single pane with a pathological workload (a huge selection,
+    // a search with millions of results, ...) makes every tab in that window unresponsive. The TermControl event
+    // handlers which may get expensive are wrapped in a Scope, and if one of them keeps the thread busy for longer
+    // than StallThreshold, a trace event with the ID of its pane and the operation is emitted: Once from a thread
+    // pool timer while the handler is still running (in case it never returns), and once more when it's done.
+    class UiThreadWatchdog
+    {
+    public:
+        static constexpr std::chrono::milliseconds StallThreshold{ 200 };
+
+        // Marks the current thread as busy with the given pane until it goes out of scope.
+        // Nested scopes are attributed to the outermost one. The operation must be a string literal.
+        class Scope
+        {
+        public:
+            Scope(uint64_t paneId, const char* operation) noexcept;
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+            Scope(Scope&&) = delete;
+            Scope& operator=(Scope&&) = delete;
+
+        private:
+            // nullptr if this scope is nested in another one.
+            UiThreadWatchdog* _watchdog = nullptr;
+            std::chrono::steady_clock::time_point _start{};
+        };
+
+    private:
+        UiThreadWatchdog() noexcept;
+
+        static UiThreadWatchdog& _get() noexcept;
+        static void __stdcall _timerCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer) noexcept;
+
+        void _begin(uint64_t paneId, const char* operation, std::chrono::steady_clock::time_point start) noexcept;
+        void _end(std::chrono::steady_clock::time_point start) noexcept;
+
+        // Only accessed by the thread that owns this watchdog.
+        uint32_t _depth = 0;
+
+        // Written by the owning thread and read by _timerCallback(). 0 means that no Scope is active.
+        std::atomic<int64_t> _startTicks{ 0 };
+        std::atomic<uint64_t> _paneId{ 0 };
+        std::atomic<const char*> _operation{ nullptr };
+
+        // Declared last, so that it's destroyed (which waits for pending callbacks) before the members above.
+        wil::unique_threadpool_timer _timer;
+    };
+}
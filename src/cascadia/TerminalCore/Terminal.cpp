@@ -11,7 +11,6 @@
 #include "../../buffer/out/search.h"
 #include "../../buffer/out/UTextAdapter.h"
 
-#include <til/hash.h>
 #include <winrt/Microsoft.Terminal.Core.h>
 
 using namespace winrt::Microsoft::Terminal::Core;
@@ -90,6 +89,14 @@ void Terminal::UpdateSettings(ICoreSettings settings)
     _autoMarkPrompts = settings.AutoMarkPrompts();
     _rainbowSuggestions = settings.RainbowSuggestions();
 
+    if (_mainBuffer)
+    {
+        _mainBuffer->SetColdScrollbackThreshold(settings.ColdScrollbackThreshold());
+        _mainBuffer->SetColdScrollbackFileBacked(settings.ColdScrollbackFileBacked());
+        // The setting is in KiB.
+        _mainBuffer->SetRetainedScrollbackSize(gsl::narrow_cast<size_t>(std::max(0, settings.RetainedScrollbackSize())) * 1024);
+    }
+
     if (_stateMachine)
     {
         SetVtChecksumReportSupport(settings.AllowVtChecksumReport());
@@ -429,6 +436,58 @@ void Terminal::Write(std::wstring_view stringView)
     _stateMachine->ProcessString(stringView);
 }
 
+// Method Description:
+// - Like Write(), but if another thread (usually the renderer) waits for the lock while we're processing a large
+//   string, we let it have the lock in between, at most once every `interval`. We yield right after a line feed
+//   where possible, so that the renderer doesn't present half-written lines. The caller must hold the lock exactly
+//   once and must be fine with other threads modifying the terminal in the meantime, like they would between two
+//   calls to Write().
+// Arguments:
+// - stringView - the output to process
+// - interval - how long to process output before we yield to a waiting thread
+void Terminal::WriteYielding(std::wstring_view stringView, std::chrono::steady_clock::duration interval)
+{
+    // The number of characters we process at least before checking for waiters.
+    static constexpr size_t granularity = 4096;
+
+    auto deadline = std::chrono::steady_clock::now() + interval;
+
+    while (stringView.size() > granularity)
+    {
+        // Stop after the first line feed following the first `granularity` characters,
+        // but don't look further than another `granularity` characters for it.
+        auto end = stringView.substr(0, 2 * granularity).find(L'\n', granularity - 1);
+        if (end != std::wstring_view::npos)
+        {
+            end++;
+        }
+        else
+        {
+            end = granularity;
+            // Don't split surrogate pairs.
+            if (til::is_leading_surrogate(stringView[end - 1]))
+            {
+                end++;
+            }
+        }
+
+        _stateMachine->ProcessString(stringView.substr(0, end));
+        stringView = stringView.substr(end);
+
+        if (_readWriteLock.has_waiters() && std::chrono::steady_clock::now() >= deadline)
+        {
+            // Our lock is a fair ticket lock: Unlocking it hands it to the waiting thread
+            // and locking it again puts us at the end of the queue.
+            {
+                const auto suspension = _readWriteLock.suspend();
+            }
+            deadline = std::chrono::steady_clock::now() + interval;
+        }
+    }
+
+    _stateMachine->ProcessString(stringView);
+}
+
 // Method Description:
 // - Attempts to snap to the bottom of the buffer, if SnapOnInput is true. Does
 //   nothing if SnapOnInput is set to false, or we're already at the bottom of
@@ -483,7 +542,7 @@ std::wstring Terminal::GetHyperlinkAtViewportPosition(const til::point viewportP
 std::wstring Terminal::GetHyperlinkAtBufferPosition(const til::point bufferPos)
 {
     // Case 1: buffer position has a hyperlink stored in the buffer
-    const auto attr = _activeBuffer().GetCellDataAt(bufferPos)->TextAttr();
+    const auto attr = _activeBuffer().GetRowByOffset(bufferPos.y).GetAttrByColumn(bufferPos.x);
     if (attr.IsHyperlink())
     {
         return _activeBuffer().GetHyperlinkUriFromId(attr.GetHyperlinkId());
@@ -543,7 +602,8 @@ std::wstring Terminal::GetHyperlinkAtBufferPosition(const til::point bufferPos)
 // - The hyperlink ID
 uint16_t Terminal::GetHyperlinkIdAtViewportPosition(const til::point viewportPos)
 {
-    return _activeBuffer().GetCellDataAt(_ConvertToBufferCell(viewportPos))->TextAttr().GetHyperlinkId();
+    const auto bufferPos = _ConvertToBufferCell(viewportPos);
+    return _activeBuffer().GetRowByOffset(bufferPos.y).GetAttrByColumn(bufferPos.x).GetHyperlinkId();
 }
 
 // Method description:
@@ -940,8 +1000,14 @@ void Terminal::_assertUnlocked() const noexcept
 
 // Method Description:
 // - Acquire a read lock on the terminal.
+// - NOTE: This is the same exclusive lock as LockForWriting(), on purpose. Readers can't share it:
+//   * Several "read" functions update state as they go. GetSelectionSpans() caches its result
+//     in mutable members, and UIA selects text and scrolls the viewport (SelectNewRegion()).
+//   * The lock is recursive and readers regularly call into code that locks for writing.
+//     An upgrade from shared to exclusive deadlocks as soon as two readers do it at the same time.
+//   * Terminal::WriteYielding() already hands the lock to waiting readers in between parsing.
 // Return Value:
-// - a shared_lock which can be used to unlock the terminal. The shared_lock
+// - a unique_lock which can be used to unlock the terminal. The unique_lock
 //      will release this lock when it's destructed.
 [[nodiscard]] std::unique_lock<til::recursive_ticket_lock> Terminal::LockForReading() const noexcept
 {
@@ -1188,9 +1254,43 @@ void Terminal::SetCursorOn(const bool isOn) noexcept
 // - INVARIANT: this function can only be called if the caller has the writing lock on the terminal
 void Terminal::UpdatePatternsUnderLock()
 {
+    if (!_detectURLs)
+    {
+        _clearPatternTree();
+        return;
+    }
+
+    const auto mutationId = _activeBuffer().GetLastMutationId();
+    const auto beg = _VisibleStartIndex();
+    const auto end = _VisibleEndIndex();
+
+    // Mutation IDs are unique across TextBuffer instances, so if neither the
+    // contents nor the viewport changed, the current tree is still accurate.
+    if (_patternCache.mutationId == mutationId && _patternCache.top == beg && _patternCache.bottom == end)
+    {
+        return;
+    }
+
+    // Build the new tree before touching the current one, so that
+    // the renderer never observes a partially updated set of patterns.
+    const auto start = std::chrono::steady_clock::now();
+    auto tree = _getPatterns(beg, end);
+    _lastPatternUpdateDuration = std::chrono::steady_clock::now() - start;
+
     _InvalidatePatternTree();
-    _patternIntervalTree = _getPatterns(_VisibleStartIndex(), _VisibleEndIndex());
+    _patternIntervalTree = std::move(tree);
+    _updatePatternSpans();
     _InvalidatePatternTree();
+
+    _patternCache.mutationId = mutationId;
+    _patternCache.top = beg;
+    _patternCache.bottom = end;
+}
+
+std::chrono::steady_clock::duration Terminal::GetLastPatternUpdateDuration() const noexcept
+{
+    _assertLocked();
+    return _lastPatternUpdateDuration;
 }
 
 // Method Description:
@@ -1200,13 +1300,30 @@ void Terminal::UpdatePatternsUnderLock()
 void Terminal::_clearPatternTree()
 {
     _assertLocked();
+    _patternCache = {};
     if (!_patternIntervalTree.empty())
     {
         _InvalidatePatternTree();
         _patternIntervalTree = {};
+        _updatePatternSpans();
     }
 }
 
+// Method Description:
+// - Rebuilds _patternSpans from _patternIntervalTree
+void Terminal::_updatePatternSpans()
+{
+    auto& spans = *_patternSpans.write();
+    spans.clear();
+    _patternIntervalTree.visit_all([&](const PointTree::interval& interval) {
+        // PointTree uses half-open ranges, whereas til::point_span is inclusive.
+        spans.push_back({ interval.start, { interval.stop.x - 1, interval.stop.y } });
+    });
+    std::sort(spans.begin(), spans.end(), [](const til::point_span& a, const til::point_span& b) noexcept {
+        return a.start < b.start;
+    });
+}
+
 // Method Description:
 // - Returns the tab color
 // If the starting color exists, its value is preferred
@@ -1370,105 +1487,98 @@ void Terminal::_updateUrlDetection()
     }
 }
 
-struct URegularExpressionInterner
+// Returns the inclusive ranges of all pattern matches within rows [beg,end],
+// with their y coordinates relative to `beg`.
+static std::vector<til::point_span> matchPatterns(const TextBuffer& buffer, til::CoordType beg, til::CoordType end)
 {
-    // Interns (caches) URegularExpression instances so that they can be reused. This method is thread-safe.
-    // uregex_open is not terribly expensive at ~10us/op, but it's also much more expensive than uregex_clone
-    // at ~400ns/op and would effectively double the time it takes to scan the viewport for patterns.
-    //
-    // An alternative approach would be to not make this method thread-safe and give each
-    // Terminal instance its own cache. I'm not sure which approach would have been better.
-    ICU::unique_uregex Intern(const std::wstring_view& pattern)
-    {
-        UErrorCode status = U_ZERO_ERROR;
-
-        {
-            const auto guard = _lock.lock_shared();
-            if (const auto it = _cache.find(pattern); it != _cache.end())
-            {
-                return ICU::unique_uregex{ uregex_clone(it->second.re.get(), &status) };
-            }
-        }
-
-        // Even if the URegularExpression creation failed, we'll insert it into the cache, because there's no point in retrying.
-        // (Apart from OOM but in that case this application will crash anyways in 3.. 2.. 1..)
-        auto re = ICU::CreateRegex(pattern, 0, &status);
-        ICU::unique_uregex clone{ uregex_clone(re.get(), &status) };
-        std::wstring key{ pattern };
-
-        const auto guard = _lock.lock_exclusive();
-
-        _cache.insert_or_assign(std::move(key), CacheValue{ std::move(re), _totalInsertions });
-        _totalInsertions++;
-
-        // If the cache is full remove the oldest element (oldest = lowest generation, just like with humans).
-        if (_cache.size() > cacheSizeLimit)
-        {
-            _cache.erase(std::min_element(_cache.begin(), _cache.end(), [](const auto& it, const auto& smallest) {
-                return it.second.generation < smallest.second.generation;
-            }));
-        }
-
-        return clone;
-    }
-
-private:
-    struct CacheValue
-    {
-        ICU::unique_uregex re;
-        size_t generation = 0;
+    static constexpr std::array<std::wstring_view, 1> patterns{
+        LR"(\b(?:https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])",
     };
 
-    struct CacheKeyHasher
+    auto text = ICU::UTextFromTextBuffer(buffer, beg, end + 1);
+    UErrorCode status = U_ZERO_ERROR;
+    std::vector<til::point_span> matches;
+
+    for (size_t i = 0; i < patterns.size(); ++i)
     {
-        using is_transparent = void;
+        const auto re = ICU::InternRegex(patterns.at(i), 0, &status);
+        uregex_setUText(re.get(), &text, &status);
 
-        std::size_t operator()(const std::wstring_view& str) const noexcept
+        if (uregex_find(re.get(), -1, &status))
         {
-            return til::hash(str);
+            do
+            {
+                auto range = ICU::BufferRangeFromMatch(&text, re.get());
+                range.start.y -= beg;
+                range.end.y -= beg;
+                matches.emplace_back(range);
+            } while (uregex_findNext(re.get(), &status));
         }
-    };
-
-    static constexpr size_t cacheSizeLimit = 128;
-    wil::srwlock _lock;
-    std::unordered_map<std::wstring, CacheValue, CacheKeyHasher, std::equal_to<>> _cache;
-    size_t _totalInsertions = 0;
-};
+    }
 
-static URegularExpressionInterner uregexInterner;
+    return matches;
+}
 
-PointTree Terminal::_getPatterns(til::CoordType beg, til::CoordType end) const
+PointTree Terminal::_getPatterns(til::CoordType beg, til::CoordType end)
 {
-    static constexpr std::array<std::wstring_view, 1> patterns{
-        LR"(\b(?:https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])",
-    };
-
     if (!_detectURLs)
     {
         return {};
     }
 
-    auto text = ICU::UTextFromTextBuffer(_activeBuffer(), beg, end + 1);
-    UErrorCode status = U_ZERO_ERROR;
+    const auto& buffer = _activeBuffer();
+    const auto width = buffer.GetSize().Width();
+
+    // Only the lines that are visible now are kept around for the next call.
+    auto previous = std::move(_patternCache.lines);
+    _patternCache.lines.clear();
+    if (_patternCache.width != width)
+    {
+        previous.clear();
+        _patternCache.width = width;
+    }
+
     PointTree::interval_vector intervals;
+    std::wstring key;
 
-    for (size_t i = 0; i < patterns.size(); ++i)
+    for (auto lineBeg = beg; lineBeg <= end;)
     {
-        const auto re = uregexInterner.Intern(patterns.at(i));
-        uregex_setUText(re.get(), &text, &status);
+        // The UText separates rows that weren't wrapped with a newline, which none of the
+        // patterns can match across. Each logical line can thus be matched on its own.
+        auto lineEnd = lineBeg;
+        key.clear();
+        for (;; ++lineEnd)
+        {
+            const auto& row = buffer.GetRowByOffset(lineEnd);
+            key.append(row.GetText());
+            key.push_back(L'\n');
+            if (lineEnd >= end || !row.WasWrapForced())
+            {
+                break;
+            }
+        }
 
-        if (uregex_find(re.get(), -1, &status))
+        auto it = _patternCache.lines.find(key);
+        if (it == _patternCache.lines.end())
         {
-            do
+            if (auto node = previous.extract(key))
             {
-                auto range = ICU::BufferRangeFromMatch(&text, re.get());
-                // PointTree uses half-open ranges and viewport-relative coordinates.
-                range.start.y -= beg;
-                range.end.y -= beg;
-                range.end.x++;
-                intervals.push_back(PointTree::interval(range.start, range.end, 0));
-            } while (uregex_findNext(re.get(), &status));
+                it = _patternCache.lines.insert(std::move(node)).position;
+            }
+            else
+            {
+                it = _patternCache.lines.emplace(key, matchPatterns(buffer, lineBeg, lineEnd)).first;
+            }
         }
+
+        // PointTree uses half-open ranges and viewport-relative coordinates.
+        const auto offset = lineBeg - beg;
+        for (const auto& range : it->second)
+        {
+            intervals.push_back(PointTree::interval({ range.start.x, range.start.y + offset }, { range.end.x + 1, range.end.y + offset }, 0));
+        }
+
+        lineBeg = lineEnd + 1;
     }
 
     return PointTree{ std::move(intervals) };
@@ -1570,7 +1680,66 @@ std::wstring Terminal::CurrentCommand() const
 
 void Terminal::SerializeMainBuffer(const wchar_t* destination) const
 {
-    _mainBuffer->SerializeToPath(destination);
+    _mainBuffer->SerializeImageToPath(destination);
+}
+
+// Method Description:
+// - Replaces the contents of the main buffer with an image written by SerializeMainBuffer().
+//   The image is loaded at the width it was written at and then reflowed to our current size,
+//   the same way UserResize() does it. The viewport ends up at the bottom, with the cursor
+//   at the start of the line below the restored text.
+// Arguments:
+// - image - the contents of the file, preferably memory mapped
+// Return Value:
+// - false if `image` isn't an image. Throws if it is one, but it's malformed.
+bool Terminal::RestoreMainBuffer(const std::span<const std::byte> image)
+{
+    const auto imageSize = TextBuffer::GetImageSize(image);
+    if (!imageSize)
+    {
+        return false;
+    }
+
+    TextBuffer imageBuffer{ *imageSize, TextAttribute{}, 0, false, nullptr };
+    imageBuffer.LoadImage(image);
+
+    const auto viewportSize = _mutableViewport.Dimensions();
+    auto newTextBuffer = std::make_unique<TextBuffer>(_mainBuffer->GetSize().Dimensions(),
+                                                      TextAttribute{},
+                                                      0,
+                                                      _mainBuffer->IsActiveBuffer(),
+                                                      _mainBuffer->GetRenderer());
+    TextBuffer::Reflow(imageBuffer, *newTextBuffer);
+
+    // Reflow() copied the properties of the image buffer, which are just the defaults.
+    newTextBuffer->CopyProperties(*_mainBuffer);
+    newTextBuffer->GetCursor().SetSize(_mainBuffer->GetCursor().GetSize());
+    newTextBuffer->SetCurrentAttributes(_mainBuffer->GetCurrentAttributes());
+
+    const auto cursorY = newTextBuffer->GetCursor().GetPosition().y;
+    const auto maxTop = newTextBuffer->GetSize().Height() - viewportSize.height;
+    const auto top = std::clamp(cursorY - viewportSize.height + 1, 0, std::max(0, maxTop));
+    _mutableViewport = Viewport::FromDimensions({ 0, top }, viewportSize);
+    _scrollOffset = 0;
+
+    _mainBuffer.swap(newTextBuffer);
+    _mainBuffer->TriggerRedrawAll();
+    _NotifyScrollEvent();
+    return true;
+}
+
+uint64_t Terminal::GetMainBufferMutationId() const noexcept
+{
+    return _mainBuffer->GetLastMutationId();
+}
+
+// Packs the scrollback of the main buffer above the rows that were last visible
+// into the cold scrollback tier. This is used to reduce the memory usage of
+// controls that have been hidden for a while.
+void Terminal::CompactScrollback() noexcept
+{
+    _assertLocked();
+    _mainBuffer->CompactRowsAbove(std::max(0, _mutableViewport.Top() - _scrollOffset));
 }
 
 void Terminal::ColorSelection(const TextAttribute& attr, winrt::Microsoft::Terminal::Core::MatchMode matchMode)
@@ -102,6 +102,7 @@ public:
 
     // Write comes from the PTY and goes to our parser to be stored in the output buffer
     void Write(std::wstring_view stringView);
+    void WriteYielding(std::wstring_view stringView, std::chrono::steady_clock::duration interval);
 
     void _assertLocked() const noexcept;
     void _assertUnlocked() const noexcept;
@@ -126,6 +127,9 @@ public:
     std::wstring CurrentCommand() const;
 
     void SerializeMainBuffer(const wchar_t* destination) const;
+    bool RestoreMainBuffer(std::span<const std::byte> image);
+    uint64_t GetMainBufferMutationId() const noexcept;
+    void CompactScrollback() noexcept;
 
 #pragma region ITerminalApi
     // These methods are defined in TerminalApi.cpp
@@ -207,7 +211,8 @@ public:
     const bool IsGridLineDrawingAllowed() noexcept override;
     const std::wstring GetHyperlinkUri(uint16_t id) const override;
     const std::wstring GetHyperlinkCustomId(uint16_t id) const override;
-    const std::vector<size_t> GetPatternId(const til::point location) const override;
+    std::span<const til::point_span> GetPatternSpans() const noexcept override;
+    til::generation_t GetPatternGeneration() const noexcept override;
 
     std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override;
     std::span<const til::point_span> GetSelectionSpans() const noexcept override;
@@ -243,6 +248,7 @@ public:
     void SetCursorOn(const bool isOn) noexcept;
 
     void UpdatePatternsUnderLock();
+    std::chrono::steady_clock::duration GetLastPatternUpdateDuration() const noexcept;
 
     const std::optional<til::color> GetTabColor() const;
 
@@ -410,6 +416,8 @@ private:
 
     std::unique_ptr<TextBuffer> _mainBuffer;
     std::unique_ptr<TextBuffer> _altBuffer;
+    // The previous alt buffer, which UseAlternateScreenBuffer() reuses if the size still matches.
+    std::unique_ptr<TextBuffer> _spareAltBuffer;
     Microsoft::Console::Types::Viewport _mutableViewport;
     til::CoordType _scrollbackLines = 0;
     bool _detectURLs = false;
@@ -434,7 +442,24 @@ private:
     //      Either way, we should make this behavior controlled by a setting.
 
     interval_tree::IntervalTree<til::point, size_t> _patternIntervalTree;
+    // The same matches as _patternIntervalTree, as inclusive spans sorted by their start. This is
+    // what the renderer consumes. It's rebuilt by _updatePatternSpans() whenever the tree changes.
+    til::generational<std::vector<til::point_span>> _patternSpans;
+    // The matches of each logical line (a run of wrapped rows) in the viewport, keyed by its text.
+    // This allows UpdatePatternsUnderLock() to only run the regex over the lines that changed.
+    struct PatternCache
+    {
+        std::unordered_map<std::wstring, std::vector<til::point_span>> lines;
+        til::CoordType width = 0;
+        // The buffer state that _patternIntervalTree was last computed for.
+        uint64_t mutationId = 0;
+        til::CoordType top = -1;
+        til::CoordType bottom = -1;
+    } _patternCache;
+    // How long the last UpdatePatternsUnderLock() call took that actually ran the regex.
+    std::chrono::steady_clock::duration _lastPatternUpdateDuration{};
     void _clearPatternTree();
+    void _updatePatternSpans();
     void _InvalidatePatternTree();
     void _InvalidateFromCoords(const til::point start, const til::point end);
 
@@ -470,7 +495,7 @@ private:
     bool _inAltBuffer() const noexcept;
     TextBuffer& _activeBuffer() const noexcept;
     void _updateUrlDetection();
-    interval_tree::IntervalTree<til::point, size_t> _getPatterns(til::CoordType beg, til::CoordType end) const;
+    interval_tree::IntervalTree<til::point, size_t> _getPatterns(til::CoordType beg, til::CoordType end);
 
 #pragma region TextSelection
     // These methods are defined in TerminalSelection.cpp
@@ -231,12 +231,24 @@ void Terminal::UseAlternateScreenBuffer(const TextAttribute& attrs)
 
     ClearSelection();
 
-    // Create a new alt buffer
-    _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
-                                              attrs,
-                                              cursorSize,
-                                              true,
-                                              _mainBuffer->GetRenderer());
+    // Pagers like less enter and exit the alt buffer all the time. If the previous alt buffer
+    // still has the right size we'll reuse it, which saves us from allocating and committing
+    // the memory for a new one. Otherwise, create a new alt buffer.
+    if (_spareAltBuffer && _spareAltBuffer->GetSize().Dimensions() == _altBufferSize && _spareAltBuffer->GetRenderer() == _mainBuffer->GetRenderer())
+    {
+        _altBuffer = std::move(_spareAltBuffer);
+        _altBuffer->Recycle(attrs, cursorSize);
+        _altBuffer->SetAsActiveBuffer(true);
+    }
+    else
+    {
+        _spareAltBuffer.reset();
+        _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
+                                                  attrs,
+                                                  cursorSize,
+                                                  true,
+                                                  _mainBuffer->GetRenderer());
+    }
     _mainBuffer->SetAsActiveBuffer(false);
 
     // Copy our cursor state to the new buffer's cursor
@@ -277,7 +289,7 @@ void Terminal::UseMainScreenBuffer()
     // _altBuffer, which is used throughout this class as an indicator via _inAltBuffer().
     //
     // We delay destroying the alt buffer instance to get a valid altBuffer->GetCursor() reference below.
-    const auto altBuffer = std::exchange(_altBuffer, nullptr);
+    auto altBuffer = std::exchange(_altBuffer, nullptr);
     if (!altBuffer)
     {
         return;
@@ -323,6 +335,10 @@ void Terminal::UseMainScreenBuffer()
 
     // redraw the screen
     _activeBuffer().TriggerRedrawAll();
+
+    // Keep the alt buffer around for the next UseAlternateScreenBuffer().
+    altBuffer->SetAsActiveBuffer(false);
+    _spareAltBuffer = std::move(altBuffer);
 }
 
 // Method Description:
@@ -393,6 +409,8 @@ void Terminal::NotifyBufferRotation(const int delta)
 
     // manually erase our pattern intervals since the locations have changed now
     _patternIntervalTree = {};
+    _updatePatternSpans();
+    _patternCache.top = -1;
 
     const auto oldScrollOffset = _scrollOffset;
     _PreserveUserScrollOffset(delta);
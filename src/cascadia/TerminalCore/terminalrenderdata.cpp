@@ -95,31 +95,19 @@ const std::wstring Microsoft::Terminal::Core::Terminal::GetHyperlinkCustomId(uin
 }
 
 // Method Description:
-// - Gets the regex pattern ids of a location
-// Arguments:
-// - The location
+// - Gets the regex pattern matches in the viewport
 // Return value:
-// - The pattern IDs of the location
-const std::vector<size_t> Terminal::GetPatternId(const til::point location) const
+// - The matches in viewport-relative coordinates, sorted by their start
+std::span<const til::point_span> Terminal::GetPatternSpans() const noexcept
 {
     _assertLocked();
+    return *_patternSpans;
+}
 
-    // Look through our interval tree for this location
-    const auto intervals = _patternIntervalTree.findOverlapping({ location.x + 1, location.y }, location);
-    if (intervals.size() == 0)
-    {
-        return {};
-    }
-    else
-    {
-        std::vector<size_t> result{};
-        for (const auto& interval : intervals)
-        {
-            result.emplace_back(interval.value);
-        }
-        return result;
-    }
-    return {};
+til::generation_t Terminal::GetPatternGeneration() const noexcept
+{
+    _assertLocked();
+    return _patternSpans.generation();
 }
 
 std::pair<COLORREF, COLORREF> Terminal::GetAttributeColors(const TextAttribute& attr) const noexcept
@@ -132,7 +120,13 @@ try
 {
     if (_selection.generation() != _lastSelectionGeneration)
     {
-        _lastSelectionSpans = _GetSelectionSpans();
+        // Refill the cached vector in place. Block selections have one span per row
+        // and this runs every time the selection changes while dragging.
+        _lastSelectionSpans.clear();
+        if (IsSelectionActive())
+        {
+            _activeBuffer().GetTextSpans(_selection->start, _selection->end, _selection->blockSelection, false, _lastSelectionSpans);
+        }
         _lastSelectionGeneration = _selection.generation();
     }
 
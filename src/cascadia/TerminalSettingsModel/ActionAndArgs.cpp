@@ -63,6 +63,7 @@ static constexpr std::string_view TogglePaneZoomKey{ "togglePaneZoom" };
 static constexpr std::string_view ToggleSplitOrientationKey{ "toggleSplitOrientation" };
 static constexpr std::string_view LegacyToggleRetroEffectKey{ "toggleRetroEffect" };
 static constexpr std::string_view ToggleShaderEffectsKey{ "toggleShaderEffects" };
+static constexpr std::string_view ToggleRenderStatisticsKey{ "toggleRenderStatistics" };
 static constexpr std::string_view MoveTabKey{ "moveTab" };
 static constexpr std::string_view BreakIntoDebuggerKey{ "breakIntoDebugger" };
 static constexpr std::string_view FindMatchKey{ "findMatch" };
@@ -98,6 +99,7 @@ static constexpr std::string_view ExpandSelectionToWordKey{ "expandSelectionToWo
 static constexpr std::string_view RestartConnectionKey{ "restartConnection" };
 static constexpr std::string_view ToggleBroadcastInputKey{ "toggleBroadcastInput" };
 static constexpr std::string_view OpenScratchpadKey{ "experimental.openScratchpad" };
+static constexpr std::string_view OpenPerformanceDashboardKey{ "experimental.openPerformanceDashboard" };
 static constexpr std::string_view OpenAboutKey{ "openAbout" };
 static constexpr std::string_view QuickFixKey{ "quickFix" };
 
@@ -400,6 +402,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                 { ShortcutAction::TogglePaneZoom, RS_(L"TogglePaneZoomCommandKey") },
                 { ShortcutAction::ToggleSplitOrientation, RS_(L"ToggleSplitOrientationCommandKey") },
                 { ShortcutAction::ToggleShaderEffects, RS_(L"ToggleShaderEffectsCommandKey") },
+                { ShortcutAction::ToggleRenderStatistics, RS_(L"ToggleRenderStatisticsCommandKey") },
                 { ShortcutAction::MoveTab, MustGenerate },
                 { ShortcutAction::BreakIntoDebugger, RS_(L"BreakIntoDebuggerCommandKey") },
                 { ShortcutAction::FindMatch, MustGenerate },
@@ -435,6 +438,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                 { ShortcutAction::RestartConnection, RS_(L"RestartConnectionKey") },
                 { ShortcutAction::ToggleBroadcastInput, RS_(L"ToggleBroadcastInputCommandKey") },
                 { ShortcutAction::OpenScratchpad, RS_(L"OpenScratchpadKey") },
+                { ShortcutAction::OpenPerformanceDashboard, RS_(L"OpenPerformanceDashboardKey") },
                 { ShortcutAction::OpenAbout, RS_(L"OpenAboutCommandKey") },
                 { ShortcutAction::QuickFix, RS_(L"QuickFixCommandKey") },
             };
@@ -100,8 +100,10 @@ Model::CascadiaSettings CascadiaSettings::Copy() const
             settings->_baseLayerProfile = _baseLayerProfile->CopyInheritanceGraph(visited);
             Profile::CopyInheritanceGraphs(visited, sourceProfiles, targetProfiles);
 
+            settings->_baseLayerProfile->_ResolveSettings();
             for (const auto& profile : targetProfiles)
             {
+                profile->_ResolveSettings();
                 allProfiles.emplace_back(*profile);
                 if (!profile->Hidden() && !profile->Orphaned())
                 {
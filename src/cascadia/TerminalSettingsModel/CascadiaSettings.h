@@ -75,7 +75,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     private:
         struct JsonSettings
         {
-            Json::Value root;
+            std::shared_ptr<const Json::Value> document;
+            const Json::Value& root;
             const Json::Value& colorSchemes;
             const Json::Value& profileDefaults;
             const Json::Value& profilesList;
@@ -85,16 +86,17 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         static std::pair<size_t, size_t> _lineAndColumnFromPosition(const std::string_view& string, const size_t position);
         static void _rethrowSerializationExceptionWithLocationInfo(const JsonUtils::DeserializationError& e, const std::string_view& settingsString);
         static Json::Value _parseJSON(const std::string_view& content);
+        static std::shared_ptr<const Json::Value> _parseJSONCached(const std::string_view& content);
         static const Json::Value& _getJSONValue(const Json::Value& json, const std::string_view& key) noexcept;
         std::span<const winrt::com_ptr<implementation::Profile>> _getNonUserOriginProfiles() const;
         void _parse(const OriginTag origin, const winrt::hstring& source, const std::string_view& content, ParsedSettings& settings);
         void _parseFragment(const winrt::hstring& source, const std::string_view& content, ParsedSettings& settings);
-        static JsonSettings _parseJson(const std::string_view& content);
+        static JsonSettings _parseJson(const std::string_view& content, bool cacheable = false);
         static winrt::com_ptr<implementation::Profile> _parseProfile(const OriginTag origin, const winrt::hstring& source, const Json::Value& profileJson);
         void _appendProfile(winrt::com_ptr<Profile>&& profile, const winrt::guid& guid, ParsedSettings& settings);
         void _addUserProfileParent(const winrt::com_ptr<implementation::Profile>& profile);
         void _addOrMergeUserColorScheme(const winrt::com_ptr<implementation::ColorScheme>& colorScheme);
-        void _executeGenerator(const IDynamicProfileGenerator& generator);
+        void _addGeneratedProfiles(const IDynamicProfileGenerator& generator, std::vector<winrt::com_ptr<implementation::Profile>>&& profiles);
 
         std::unordered_set<winrt::hstring, til::transparent_hstring_hash, til::transparent_hstring_equal_to> _ignoredNamespaces;
         std::set<std::string> themesChangeLog;
@@ -107,6 +109,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     public:
         static Model::CascadiaSettings LoadDefaults();
         static Model::CascadiaSettings LoadAll();
+        static bool RefreshFragmentExtensions();
 
         static winrt::hstring SettingsDirectory();
         static winrt::hstring SettingsPath();
@@ -7,10 +7,12 @@
 #include <LibraryResources.h>
 #include <fmt/chrono.h>
 #include <shlobj.h>
+#include <til/hash.h>
 #include <til/latch.h>
 #include <til/io.h>
 
 #include "resource.h"
+#include "../inc/StartupTracing.h"
 
 #include "AzureCloudShellGenerator.h"
 #include "PowershellCoreProfileGenerator.h"
@@ -42,6 +44,11 @@ static constexpr std::string_view ProfilesListKey{ "list" };
 static constexpr std::string_view SchemesKey{ "schemes" };
 static constexpr std::string_view ThemesKey{ "themes" };
 
+// The number of parsed documents _parseJSONCached() holds on to. It's
+// flushed entirely whenever it fills up, so this only needs to be larger
+// than the number of fragments a typical user has installed.
+static constexpr size_t MaxCachedDocuments{ 64 };
+
 constexpr std::wstring_view systemThemeName{ L"system" };
 constexpr std::wstring_view darkThemeName{ L"dark" };
 constexpr std::wstring_view lightThemeName{ L"light" };
@@ -90,6 +97,70 @@ static auto extractValueFromTaskWithoutMainThreadAwait(TTask&& task) -> decltype
     return finalVal.value();
 }
 
+// Enumerates all app extensions that provide settings fragments and returns their
+// fragment directories, mapped to the package family name that's used as their source.
+// This is slow on machines with many packaged apps. The result is thus cached in
+// the ApplicationState and only revalidated in the background (RefreshFragmentExtensions).
+//
+// GH#12305: Open() can throw an 0x80070490 "Element not found.".
+// It's unclear to me under which circumstances this happens as no one on the team
+// was able to reproduce the user's issue, even if the application was run unpackaged.
+// The error originates from `CallerIdentity::GetCallingProcessAppId` which returns E_NOT_SET.
+// A comment can be found, reading:
+// > Gets the "strong" AppId from the process token. This works for UWAs and Centennial apps,
+// > strongly named processes where the AppId is stored securely in the process token. [...]
+// > E_NOT_SET is returned for processes without strong AppIds.
+static IMap<winrt::hstring, winrt::hstring> findFragmentExtensions()
+{
+    // Gets the catalog of extensions with the name "com.microsoft.windows.terminal.settings".
+    const auto catalog = AppExtensionCatalog::Open(AppExtensionHostName);
+    const auto extensions = extractValueFromTaskWithoutMainThreadAwait(catalog.FindAllAsync());
+    auto result = winrt::single_threaded_map<winrt::hstring, winrt::hstring>();
+
+    for (const auto& ext : extensions)
+    {
+        // Likewise, getting the public folder from an extension is an async operation.
+        const auto foundFolder = extractValueFromTaskWithoutMainThreadAwait(ext.GetPublicFolderAsync());
+        if (!foundFolder)
+        {
+            continue;
+        }
+
+        // the StorageFolder class has its own methods for obtaining the files within the folder
+        // however, all those methods are Async methods
+        // you may have noticed that we need to resort to clunky implementations for async operations
+        // (they are in extractValueFromTaskWithoutMainThreadAwait)
+        // so for now we will just take the folder path and access the files that way
+        const auto path = buildPath(foundFolder.Path(), FragmentsSubDirectory);
+        result.Insert(winrt::hstring{ path.native() }, ext.Package().Id().FamilyName());
+    }
+
+    return result;
+}
+
+// As the name implies it executes a generator, on a background thread.
+// Generated profiles are stored in `profiles` and `latch` is counted down once it's done.
+// Used by SettingsLoader::GenerateProfiles().
+static safe_void_coroutine executeGenerator(const Model::IDynamicProfileGenerator& generator, std::vector<winrt::com_ptr<Profile>>& profiles, til::latch& latch)
+{
+    const auto cleanup = wil::scope_exit([&]() {
+        latch.count_down();
+    });
+
+    co_await winrt::resume_background();
+
+    const auto generatorNamespace = generator.GetNamespace();
+
+    try
+    {
+        // Thread pool threads aren't guaranteed to be in an apartment,
+        // but generators like the VS one rely on COM.
+        const auto coInit = wil::CoInitializeEx(COINIT_MULTITHREADED);
+        generator.GenerateProfiles(profiles);
+    }
+    CATCH_LOG_MSG("Dynamic Profile Namespace: \"%.*s\"", gsl::narrow<int>(generatorNamespace.size()), generatorNamespace.data())
+}
+
 // Concatenates the two given strings (!) and returns them as a path.
 // You better make sure there's a path separator at the end of lhs or at the start of rhs.
 static std::filesystem::path buildPath(const std::wstring_view& lhs, const std::wstring_view& rhs)
@@ -178,13 +249,47 @@ SettingsLoader::SettingsLoader(const std::string_view& userJSON, const std::stri
 // (meaning profiles specified by the application rather by the user).
 void SettingsLoader::GenerateProfiles()
 {
-    _executeGenerator(PowershellCoreProfileGenerator{});
-    _executeGenerator(WslDistroGenerator{});
-    _executeGenerator(AzureCloudShellGenerator{});
-    _executeGenerator(VisualStudioGenerator{});
+    const PowershellCoreProfileGenerator powershellCoreGenerator;
+    const WslDistroGenerator wslDistroGenerator;
+    const AzureCloudShellGenerator azureCloudShellGenerator;
+    const VisualStudioGenerator visualStudioGenerator;
 #if TIL_FEATURE_DYNAMICSSHPROFILES_ENABLED
-    _executeGenerator(SshHostGenerator{});
+    const SshHostGenerator sshHostGenerator;
 #endif
+
+    const IDynamicProfileGenerator* generators[]{
+        &powershellCoreGenerator,
+        &wslDistroGenerator,
+        &azureCloudShellGenerator,
+        &visualStudioGenerator,
+#if TIL_FEATURE_DYNAMICSSHPROFILES_ENABLED
+        &sshHostGenerator,
+#endif
+    };
+
+    // Some of the generators are slow (for instance, the VS one queries COM and the WSL one walks the registry).
+    // We run them concurrently on the thread pool, but add their profiles in the order given above,
+    // so that the result doesn't depend on which generator happened to finish first.
+    std::array<std::vector<winrt::com_ptr<implementation::Profile>>, std::size(generators)> results;
+    til::latch latch{ gsl::narrow_cast<ptrdiff_t>(std::size(generators)) };
+
+    for (size_t i = 0; i < std::size(generators); ++i)
+    {
+        const auto& generator = *til::at(generators, i);
+        if (_ignoredNamespaces.contains(generator.GetNamespace()))
+        {
+            latch.count_down();
+            continue;
+        }
+        executeGenerator(generator, til::at(results, i), latch);
+    }
+
+    latch.wait();
+
+    for (size_t i = 0; i < std::size(generators); ++i)
+    {
+        _addGeneratedProfiles(*til::at(generators, i), std::move(til::at(results, i)));
+    }
 }
 
 // A new settings.json gets a special treatment:
@@ -287,54 +392,47 @@ void SettingsLoader::FindFragmentsAndMergeIntoUserSettings()
     }
 
     // Search through app extensions.
-    // Gets the catalog of extensions with the name "com.microsoft.windows.terminal.settings".
-    //
-    // GH#12305: Open() can throw an 0x80070490 "Element not found.".
-    // It's unclear to me under which circumstances this happens as no one on the team
-    // was able to reproduce the user's issue, even if the application was run unpackaged.
-    // The error originates from `CallerIdentity::GetCallingProcessAppId` which returns E_NOT_SET.
-    // A comment can be found, reading:
-    // > Gets the "strong" AppId from the process token. This works for UWAs and Centennial apps,
-    // > strongly named processes where the AppId is stored securely in the process token. [...]
-    // > E_NOT_SET is returned for processes without strong AppIds.
-    IVectorView<AppExtension> extensions;
-    try
+    // Querying the app extension catalog is slow, so we use the list of extensions we found last time.
+    // AppLogic calls RefreshFragmentExtensions() in the background and reloads the settings if it changed.
+    // Only if we never searched before (or the last search failed) do we have to do it right now.
+    const auto state = winrt::get_self<ApplicationState>(ApplicationState::SharedInstance());
+    auto extensions = state->FragmentExtensions();
+
+    if (!extensions)
     {
-        const auto catalog = AppExtensionCatalog::Open(AppExtensionHostName);
-        extensions = extractValueFromTaskWithoutMainThreadAwait(catalog.FindAllAsync());
+        try
+        {
+            extensions = findFragmentExtensions();
+            state->FragmentExtensions(extensions);
+        }
+        CATCH_LOG();
     }
-    CATCH_LOG();
 
     if (!extensions)
     {
         return;
     }
 
+    // The cached map is unordered. Sorting it ensures that fragments are always layered in the same order.
+    std::vector<std::pair<winrt::hstring, winrt::hstring>> sortedExtensions;
+    sortedExtensions.reserve(extensions.Size());
     for (const auto& ext : extensions)
     {
-        const auto packageName = ext.Package().Id().FamilyName();
-        if (_ignoredNamespaces.contains(std::wstring_view{ packageName }))
-        {
-            continue;
-        }
+        sortedExtensions.emplace_back(ext.Key(), ext.Value());
+    }
+    std::ranges::sort(sortedExtensions);
 
-        // Likewise, getting the public folder from an extension is an async operation.
-        auto foundFolder = extractValueFromTaskWithoutMainThreadAwait(ext.GetPublicFolderAsync());
-        if (!foundFolder)
+    for (const auto& [path, packageName] : sortedExtensions)
+    {
+        if (_ignoredNamespaces.contains(std::wstring_view{ packageName }))
         {
             continue;
         }
 
-        // the StorageFolder class has its own methods for obtaining the files within the folder
-        // however, all those methods are Async methods
-        // you may have noticed that we need to resort to clunky implementations for async operations
-        // (they are in extractValueFromTaskWithoutMainThreadAwait)
-        // so for now we will just take the folder path and access the files that way
-        const auto path = buildPath(foundFolder.Path(), FragmentsSubDirectory);
-
-        if (std::filesystem::is_directory(path))
+        const std::filesystem::path fragmentPath{ std::wstring_view{ path } };
+        if (std::filesystem::is_directory(fragmentPath))
         {
-            parseAndLayerFragmentFiles(path, packageName);
+            parseAndLayerFragmentFiles(fragmentPath, packageName);
         }
     }
 }
@@ -365,7 +463,7 @@ void SettingsLoader::FinalizeLayering()
     // actions, this is the time to do it.
     if (userSettings.globals->EnableColorSelection())
     {
-        const auto json = _parseJson(LoadStringResource(IDR_ENABLE_COLOR_SELECTION));
+        const auto json = _parseJson(LoadStringResource(IDR_ENABLE_COLOR_SELECTION), true);
         const auto globals = GlobalAppSettings::FromJson(json.root, OriginTag::InBox);
         userSettings.globals->AddLeastImportantParent(globals);
     }
@@ -622,6 +720,46 @@ Json::Value SettingsLoader::_parseJSON(const std::string_view& content)
     return json;
 }
 
+// Like _parseJSON, but remembers the result for the lifetime of the process.
+// The defaults and fragments are (almost) always the same when the settings get reloaded,
+// but parsing them makes up a considerable part of the load time. The returned document
+// is shared between all callers and must not be modified. Must only be used for content
+// that doesn't originate from the user's settings.json, as it'd just bloat the cache.
+std::shared_ptr<const Json::Value> SettingsLoader::_parseJSONCached(const std::string_view& content)
+{
+    struct Entry
+    {
+        std::string content;
+        std::shared_ptr<const Json::Value> json;
+    };
+
+    static wil::srwlock lock;
+    static std::unordered_map<size_t, Entry> cache;
+
+    const auto hash = til::hash(content.data(), content.size());
+
+    {
+        const auto guard = lock.lock_shared();
+        if (const auto it = cache.find(hash); it != cache.end() && it->second.content == content)
+        {
+            return it->second.json;
+        }
+    }
+
+    auto json = std::make_shared<const Json::Value>(_parseJSON(content));
+
+    {
+        const auto guard = lock.lock_exclusive();
+        if (cache.size() >= MaxCachedDocuments)
+        {
+            cache.clear();
+        }
+        cache.insert_or_assign(hash, Entry{ std::string{ content }, json });
+    }
+
+    return json;
+}
+
 // A helper method similar to Json::Value::operator[], but compatible with std::string_view.
 const Json::Value& SettingsLoader::_getJSONValue(const Json::Value& json, const std::string_view& key) noexcept
 {
@@ -653,7 +791,8 @@ std::span<const winrt::com_ptr<Profile>> SettingsLoader::_getNonUserOriginProfil
 // This function is to be used for user settings files.
 void SettingsLoader::_parse(const OriginTag origin, const winrt::hstring& source, const std::string_view& content, ParsedSettings& settings)
 {
-    const auto json = _parseJson(content);
+    // The inbox settings are a resource and thus identical on every load.
+    const auto json = _parseJson(content, origin == OriginTag::InBox);
 
     settings.clear();
 
@@ -726,7 +865,7 @@ void SettingsLoader::_parse(const OriginTag origin, const winrt::hstring& source
 // schemes and profiles. Additionally this function supports profiles which specify an "updates" key.
 void SettingsLoader::_parseFragment(const winrt::hstring& source, const std::string_view& content, ParsedSettings& settings)
 {
-    auto json = _parseJson(content);
+    const auto json = _parseJson(content, true);
 
     settings.clear();
 
@@ -808,15 +947,29 @@ void SettingsLoader::_parseFragment(const winrt::hstring& source, const std::str
     userSettings.globals->AddLeastImportantParent(settings.globals);
 }
 
-SettingsLoader::JsonSettings SettingsLoader::_parseJson(const std::string_view& content)
+SettingsLoader::JsonSettings SettingsLoader::_parseJson(const std::string_view& content, bool cacheable)
 {
-    auto root = content.empty() ? Json::Value{ Json::ValueType::objectValue } : _parseJSON(content);
+    std::shared_ptr<const Json::Value> document;
+    if (content.empty())
+    {
+        document = std::make_shared<const Json::Value>(Json::ValueType::objectValue);
+    }
+    else if (cacheable)
+    {
+        document = _parseJSONCached(content);
+    }
+    else
+    {
+        document = std::make_shared<const Json::Value>(_parseJSON(content));
+    }
+
+    const auto& root = *document;
     const auto& colorSchemes = _getJSONValue(root, SchemesKey);
     const auto& themes = _getJSONValue(root, ThemesKey);
     const auto& profilesObject = _getJSONValue(root, ProfilesKey);
     const auto& profileDefaults = _getJSONValue(profilesObject, DefaultSettingsKey);
     const auto& profilesList = profilesObject.isArray() ? profilesObject : _getJSONValue(profilesObject, ProfilesListKey);
-    return JsonSettings{ std::move(root), colorSchemes, profileDefaults, profilesList, themes };
+    return JsonSettings{ std::move(document), root, colorSchemes, profileDefaults, profilesList, themes };
 }
 
 // Just a common helper function between _parse and _parseFragment.
@@ -936,35 +1089,23 @@ void SettingsLoader::_addOrMergeUserColorScheme(const winrt::com_ptr<implementat
     }
 }
 
-// As the name implies it executes a generator.
 // Generated profiles are added to .inboxSettings. Used by GenerateProfiles().
-void SettingsLoader::_executeGenerator(const IDynamicProfileGenerator& generator)
+void SettingsLoader::_addGeneratedProfiles(const IDynamicProfileGenerator& generator, std::vector<winrt::com_ptr<implementation::Profile>>&& profiles)
 {
-    const auto generatorNamespace = generator.GetNamespace();
-    if (_ignoredNamespaces.contains(generatorNamespace))
+    if (profiles.empty())
     {
         return;
     }
 
-    const auto previousSize = inboxSettings.profiles.size();
-
-    try
-    {
-        generator.GenerateProfiles(inboxSettings.profiles);
-    }
-    CATCH_LOG_MSG("Dynamic Profile Namespace: \"%.*s\"", gsl::narrow<int>(generatorNamespace.size()), generatorNamespace.data())
-
     // If the generator produced some profiles we're going to give them default attributes.
     // By setting the Origin/Source/etc. here, we deduplicate some code and ensure they aren't missing accidentally.
-    if (inboxSettings.profiles.size() > previousSize)
-    {
-        const winrt::hstring source{ generatorNamespace };
+    const winrt::hstring source{ generator.GetNamespace() };
 
-        for (const auto& profile : std::span(inboxSettings.profiles).subspan(previousSize))
-        {
-            profile->Origin(OriginTag::Generated);
-            profile->Source(source);
-        }
+    for (auto& profile : profiles)
+    {
+        profile->Origin(OriginTag::Generated);
+        profile->Source(source);
+        inboxSettings.profiles.emplace_back(std::move(profile));
     }
 }
 
@@ -983,6 +1124,8 @@ void SettingsLoader::_executeGenerator(const IDynamicProfileGenerator& generator
 Model::CascadiaSettings CascadiaSettings::LoadAll()
 try
 {
+    const ::Microsoft::Terminal::StartupStageScope startupStage{ g_hSettingsModelProvider, "LoadSettings" };
+
     FILETIME lastWriteTime{};
     auto settingsString = til::io::read_file_as_utf8_string_if_exists(_settingsPath(), false, &lastWriteTime);
     auto firstTimeSetup = settingsString.empty();
@@ -1089,6 +1232,31 @@ catch (const SettingsTypedDeserializationException& e)
     return *settings;
 }
 
+// Searches the app extension catalog for fragment extensions and updates
+// the list that LoadAll() uses, because LoadAll() doesn't query the catalog itself.
+// This is slow and should be called on a background thread.
+// Returns true if the list changed, in which case the settings should be reloaded.
+bool CascadiaSettings::RefreshFragmentExtensions()
+{
+    const auto current = findFragmentExtensions();
+    const auto state = winrt::get_self<ApplicationState>(ApplicationState::SharedInstance());
+    const auto previous = state->FragmentExtensions();
+
+    if (previous && previous.Size() == current.Size())
+    {
+        const auto unchanged = std::ranges::all_of(current, [&](const auto& ext) {
+            return previous.HasKey(ext.Key()) && previous.Lookup(ext.Key()) == ext.Value();
+        });
+        if (unchanged)
+        {
+            return false;
+        }
+    }
+
+    state->FragmentExtensions(current);
+    return true;
+}
+
 void CascadiaSettings::_researchOnLoad()
 {
     // Only do this if we're actually being sampled
@@ -1263,6 +1431,14 @@ CascadiaSettings::CascadiaSettings(SettingsLoader&& loader) :
     _validateSettings();
 
     ExpandCommands();
+
+    // The profiles are fully layered now. Most of their settings won't change from here on,
+    // but will be read over and over (for instance for each new pane), so we flatten them.
+    loader.userSettings.baseLayerProfile->_ResolveSettings();
+    for (const auto& profile : loader.userSettings.profiles)
+    {
+        profile->_ResolveSettings();
+    }
 }
 
 // Method Description:
@@ -296,6 +296,10 @@ Json::Value GlobalAppSettings::ToJson()
     {
         _DisablePartialInvalidation.reset();
     }
+    if (_PersistGlyphAtlas == false)
+    {
+        _PersistGlyphAtlas.reset();
+    }
     if (_SoftwareRendering == false)
     {
         _SoftwareRendering.reset();
@@ -44,16 +44,19 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void ClearParents()
         {
             _parents.clear();
+            _InvalidateInheritance();
         }
 
         void AddLeastImportantParent(com_ptr<T> parent)
         {
             _parents.emplace_back(std::move(parent));
+            _InvalidateInheritance();
         }
 
         void AddMostImportantParent(com_ptr<T> parent)
         {
             _parents.emplace(_parents.begin(), std::move(parent));
+            _InvalidateInheritance();
         }
 
         const std::vector<com_ptr<T>>& Parents()
@@ -64,6 +67,16 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
     protected:
         std::vector<com_ptr<T>> _parents{};
 
+        // Incremented whenever a setting or the parents of any T change. Since a change to
+        // one object affects the resolved values of all of its children, anything that caches
+        // resolved values must discard them once this differs from the value it cached them at.
+        static inline std::atomic<uint64_t> _inheritanceGeneration{ 0 };
+
+        static void _InvalidateInheritance() noexcept
+        {
+            _inheritanceGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+
         // Method Description:
         // - Actions to be performed after a child was created. Generally used to set
         //   any extraneous data from the parent into the child.
@@ -109,6 +122,7 @@ public:                                                                     \
     void Clear##name()                                                      \
     {                                                                       \
         _##name = std::nullopt;                                             \
+        _InvalidateInheritance();                                           \
     }                                                                       \
                                                                             \
 private:                                                                    \
@@ -183,6 +197,7 @@ public:                                                                      \
     void name(const type& value)                                             \
     {                                                                        \
         _##name = value;                                                     \
+        _InvalidateInheritance();                                            \
     }
 
 #define INHERITABLE_SETTING_WITH_LOGGING(projectedType, type, name, jsonKey, ...) \
@@ -204,6 +219,37 @@ public:
             _logSettingSet(jsonKey);                                              \
         }                                                                         \
         _##name = value;                                                          \
+        _InvalidateInheritance();                                                 \
+    }
+
+// Same as INHERITABLE_SETTING_WITH_LOGGING, but the getter is served from a flattened
+// snapshot of the resolved values if there's one. The class must implement _resolvedSettings(),
+// which returns a pointer to a struct with a member for each such setting, or nullptr if the
+// snapshot is missing or outdated (see _inheritanceGeneration).
+#define RESOLVED_INHERITABLE_SETTING_WITH_LOGGING(projectedType, type, name, jsonKey, ...) \
+    _BASE_INHERITABLE_SETTING(projectedType, std::optional<type>, name, ...)               \
+public:                                                                                    \
+    /* Returns the resolved value for this setting */                                      \
+    /* fallback: user set value --> inherited value --> system set value */                \
+    type name() const                                                                      \
+    {                                                                                      \
+        if (const auto resolved = _resolvedSettings())                                     \
+        {                                                                                  \
+            return resolved->name;                                                         \
+        }                                                                                  \
+        const auto val{ _get##name##Impl() };                                              \
+        return val ? *val : type{ __VA_ARGS__ };                                           \
+    }                                                                                      \
+                                                                                           \
+    /* Overwrite the user set value */                                                     \
+    void name(const type& value)                                                           \
+    {                                                                                      \
+        if (!_##name.has_value() || _##name.value() != value)                              \
+        {                                                                                  \
+            _logSettingSet(jsonKey);                                                       \
+        }                                                                                  \
+        _##name = value;                                                                   \
+        _InvalidateInheritance();                                                          \
     }
 
 // This macro is similar to the one above, but is reserved for optional settings
@@ -241,4 +287,5 @@ public:                                                                        \
             /* note we're setting the _inner_ value */                         \
             _##name = std::optional<type>{ std::nullopt };                     \
         }                                                                      \
+        _InvalidateInheritance();                                              \
     }
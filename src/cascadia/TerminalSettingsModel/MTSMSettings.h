@@ -26,7 +26,9 @@ Author(s):
     X(bool, FocusFollowMouse, "focusFollowMouse", false)                                                                                                                                              \
     X(winrt::Microsoft::Terminal::Control::GraphicsAPI, GraphicsAPI, "rendering.graphicsAPI")                                                                                                         \
     X(bool, DisablePartialInvalidation, "rendering.disablePartialInvalidation", false)                                                                                                                \
+    X(bool, PersistGlyphAtlas, "rendering.persistGlyphAtlas", false)                                                                                                                                  \
     X(bool, SoftwareRendering, "rendering.software", false)                                                                                                                                           \
+    X(int32_t, AnimationFrameRate, "rendering.animationFrameRate", 0)                                                                                                                                 \
     X(winrt::Microsoft::Terminal::Control::TextMeasurement, TextMeasurement, "compatibility.textMeasurement")                                                                                         \
     X(winrt::Microsoft::Terminal::Control::DefaultInputScope, DefaultInputScope, "defaultInputScope")                                                                                                 \
     X(bool, UseBackgroundImageForWindow, "experimental.useBackgroundImageForWindow", false)                                                                                                           \
@@ -65,6 +67,7 @@ Author(s):
     X(bool, TrimPaste, "trimPaste", true)                                                                                                                                                             \
     X(bool, EnableColorSelection, "experimental.enableColorSelection", false)                                                                                                                         \
     X(bool, EnableShellCompletionMenu, "experimental.enableShellCompletionMenu", false)                                                                                                               \
+    X(bool, PrewarmConnections, "experimental.prewarmConnections", false)                                                                                                                             \
     X(bool, EnableUnfocusedAcrylic, "compatibility.enableUnfocusedAcrylic", true)                                                                                                                     \
     X(winrt::Windows::Foundation::Collections::IVector<Model::NewTabMenuEntry>, NewTabMenu, "newTabMenu", winrt::single_threaded_vector<Model::NewTabMenuEntry>({ Model::RemainingProfilesEntry{} })) \
     X(bool, AllowHeadless, "compatibility.allowHeadless", false)                                                                                                                                      \
@@ -98,8 +101,15 @@ Author(s):
     X(bool, AutoMarkPrompts, "autoMarkPrompts", true)                                                                                                          \
     X(bool, ShowMarks, "showMarksOnScrollbar", false)                                                                                                          \
     X(bool, RepositionCursorWithMouse, "experimental.repositionCursorWithMouse", false)                                                                        \
+    X(bool, SmoothScrolling, "experimental.smoothScrolling", false)                                                                                            \
     X(bool, ReloadEnvironmentVariables, "compatibility.reloadEnvironmentVariables", true)                                                                      \
     X(bool, RainbowSuggestions, "experimental.rainbowSuggestions", false)                                                                                      \
+    X(int32_t, ColdScrollbackThreshold, "experimental.coldScrollbackThreshold", 0)                                                                             \
+    X(bool, ColdScrollbackFileBacked, "experimental.coldScrollbackFileBacked", false)                                                                          \
+    X(int32_t, RetainedScrollbackSize, "experimental.retainedScrollbackSize", 0)                                                                               \
+    X(hstring, SessionLogDirectory, "experimental.sessionLog.directory")                                                                                       \
+    X(int32_t, SessionLogMaxSize, "experimental.sessionLog.maxSize", 0)                                                                                        \
+    X(bool, SessionLogBlockOnFull, "experimental.sessionLog.blockOnFull", false)                                                                               \
     X(bool, ForceVTInput, "compatibility.input.forceVT", false)                                                                                                \
     X(bool, AllowVtChecksumReport, "compatibility.allowDECRQCRA", false)                                                                                       \
     X(bool, AllowKeypadMode, "compatibility.allowDECNKM", false)                                                                                               \
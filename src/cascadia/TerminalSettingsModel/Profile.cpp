@@ -165,6 +165,9 @@ winrt::com_ptr<winrt::Microsoft::Terminal::Settings::Model::implementation::Prof
 // <none>
 void Profile::LayerJson(const Json::Value& json)
 {
+    // The settings below are assigned directly instead of through their setters.
+    _InvalidateInheritance();
+
     // Appearance Settings
     auto defaultAppearanceImpl = winrt::get_self<implementation::AppearanceConfig>(_DefaultAppearance);
     defaultAppearanceImpl->LayerJson(json);
@@ -224,6 +227,27 @@ void Profile::LayerJson(const Json::Value& json)
     }
 }
 
+// Method Description:
+// - Computes a flattened snapshot of the resolved values of all MTSM_PROFILE_SETTINGS,
+//   so that their getters don't need to walk the parent chain on every access.
+// - Any change to a setting or the parents of any profile invalidates the snapshot,
+//   and the getters fall back to walking the parents until this is called again.
+// - Call this once the settings are fully layered, and before they're shared with
+//   other threads, since the snapshot is replaced without any synchronization.
+void Profile::_ResolveSettings()
+{
+    _resolved.reset();
+
+    auto resolved = std::make_unique<ResolvedSettings>();
+#define PROFILE_SETTINGS_RESOLVE(type, name, jsonKey, ...) \
+    resolved->name = name();
+    MTSM_PROFILE_SETTINGS(PROFILE_SETTINGS_RESOLVE)
+#undef PROFILE_SETTINGS_RESOLVE
+
+    _resolved = std::move(resolved);
+    _resolvedGeneration = _inheritanceGeneration.load(std::memory_order_relaxed);
+}
+
 winrt::hstring Profile::EvaluatedStartingDirectory() const
 {
     auto path{ StartingDirectory() };
@@ -107,6 +107,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         static std::wstring NormalizeCommandLine(LPCWSTR commandLine);
 
         void _FinalizeInheritance() override;
+        void _ResolveSettings();
 
         void LogSettingChanges(std::set<std::string>& changes, const std::string_view& context) const;
 
@@ -134,11 +135,27 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
     public:
 #define PROFILE_SETTINGS_INITIALIZE(type, name, jsonKey, ...) \
-    INHERITABLE_SETTING_WITH_LOGGING(Model::Profile, type, name, jsonKey, ##__VA_ARGS__)
+    RESOLVED_INHERITABLE_SETTING_WITH_LOGGING(Model::Profile, type, name, jsonKey, ##__VA_ARGS__)
         MTSM_PROFILE_SETTINGS(PROFILE_SETTINGS_INITIALIZE)
 #undef PROFILE_SETTINGS_INITIALIZE
 
     private:
+        // The resolved values of all MTSM_PROFILE_SETTINGS as of _resolvedGeneration. See _ResolveSettings().
+        struct ResolvedSettings
+        {
+#define PROFILE_SETTINGS_RESOLVED(type, name, jsonKey, ...) type name{};
+            MTSM_PROFILE_SETTINGS(PROFILE_SETTINGS_RESOLVED)
+#undef PROFILE_SETTINGS_RESOLVED
+        };
+
+        const ResolvedSettings* _resolvedSettings() const noexcept
+        {
+            return _resolved && _resolvedGeneration == _inheritanceGeneration.load(std::memory_order_relaxed) ? _resolved.get() : nullptr;
+        }
+
+        std::unique_ptr<const ResolvedSettings> _resolved;
+        uint64_t _resolvedGeneration{ 0 };
+
         Model::IAppearanceConfig _DefaultAppearance{ winrt::make<AppearanceConfig>(weak_ref<Model::Profile>(*this)) };
         Model::FontConfig _FontInfo{ winrt::make<FontConfig>(weak_ref<Model::Profile>(*this)) };
 
@@ -344,10 +344,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         _RightClickContextMenu = profile.RightClickContextMenu();
         _RepositionCursorWithMouse = profile.RepositionCursorWithMouse();
+        _SmoothScrolling = profile.SmoothScrolling();
         _ReloadEnvironmentVariables = profile.ReloadEnvironmentVariables();
         _RainbowSuggestions = profile.RainbowSuggestions();
         _ForceVTInput = profile.ForceVTInput();
         _AllowVtChecksumReport = profile.AllowVtChecksumReport();
+        _ColdScrollbackThreshold = profile.ColdScrollbackThreshold();
+        _ColdScrollbackFileBacked = profile.ColdScrollbackFileBacked();
+        _RetainedScrollbackSize = profile.RetainedScrollbackSize();
         _PathTranslationStyle = profile.PathTranslationStyle();
     }
 
@@ -368,7 +372,9 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _FocusFollowMouse = globalSettings.FocusFollowMouse();
         _GraphicsAPI = globalSettings.GraphicsAPI();
         _DisablePartialInvalidation = globalSettings.DisablePartialInvalidation();
+        _PersistGlyphAtlas = globalSettings.PersistGlyphAtlas();
         _SoftwareRendering = globalSettings.SoftwareRendering();
+        _AnimationFrameRate = globalSettings.AnimationFrameRate();
         _TextMeasurement = globalSettings.TextMeasurement();
         _DefaultInputScope = globalSettings.DefaultInputScope();
         _UseBackgroundImageForWindow = globalSettings.UseBackgroundImageForWindow();
@@ -377,6 +383,94 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _EnableUnfocusedAcrylic = globalSettings.EnableUnfocusedAcrylic();
     }
 
+    // These compare the resolved values of two settings for IsEquivalentTo().
+    // Most types can be compared directly, but references and maps
+    // are distinct objects on every settings load and need a deep comparison.
+    template<typename T>
+    static bool settingEquals(const T& lhs, const T& rhs)
+    {
+        return lhs == rhs;
+    }
+
+    template<typename T>
+    static bool settingEquals(const Windows::Foundation::IReference<T>& lhs, const Windows::Foundation::IReference<T>& rhs)
+    {
+        if (!lhs || !rhs)
+        {
+            return lhs == rhs;
+        }
+        return lhs.Value() == rhs.Value();
+    }
+
+    template<typename T>
+    static bool settingEquals(const Windows::Foundation::Collections::IMap<hstring, T>& lhs, const Windows::Foundation::Collections::IMap<hstring, T>& rhs)
+    {
+        if (!lhs || !rhs)
+        {
+            return lhs == rhs;
+        }
+        if (lhs.Size() != rhs.Size())
+        {
+            return false;
+        }
+        for (const auto& pair : lhs)
+        {
+            if (!rhs.HasKey(pair.Key()) || rhs.Lookup(pair.Key()) != pair.Value())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The colors of the scheme are already part of the other settings (ColorTable, DefaultForeground, etc.).
+    static bool settingEquals(const Model::ColorScheme& lhs, const Model::ColorScheme& rhs)
+    {
+        if (!lhs || !rhs)
+        {
+            return lhs == rhs;
+        }
+        return lhs.Name() == rhs.Name();
+    }
+
+    // Method Description:
+    // - Checks whether the given settings resolve to the same values as these settings,
+    //   including any values they inherit from their parents.
+    // - This allows TerminalApp to skip updating controls after a settings reload,
+    //   if none of the settings they're using actually changed.
+    // Arguments:
+    // - other: the settings to compare against
+    // Return Value:
+    // - true if both settings would result in the same control configuration
+    bool TerminalSettings::IsEquivalentTo(const Model::TerminalSettings& other)
+    {
+        if (!other)
+        {
+            return false;
+        }
+
+        const auto otherImpl = winrt::get_self<TerminalSettings>(other);
+        if (otherImpl == this)
+        {
+            return true;
+        }
+        if (ColorTable() != otherImpl->ColorTable())
+        {
+            return false;
+        }
+
+#define TERMINAL_SETTINGS_COMPARE(type, name, ...) \
+    if (!settingEquals(name(), otherImpl->name())) \
+    {                                              \
+        return false;                              \
+    }
+        MTSM_TERMINAL_CORE_SETTINGS(TERMINAL_SETTINGS_COMPARE)
+        MTSM_TERMINAL_CONTROL_SETTINGS(TERMINAL_SETTINGS_COMPARE)
+#undef TERMINAL_SETTINGS_COMPARE
+
+        return true;
+    }
+
     // Method Description:
     // - Apply a given ColorScheme's values to the TerminalSettings object.
     //      Sets the foreground, background, and color table of the settings object.
@@ -24,6 +24,101 @@ using IFontAxesMap = winrt::Windows::Foundation::Collections::IMap<winrt::hstrin
 using IFontFeatureMap = winrt::Windows::Foundation::Collections::IMap<winrt::hstring, float>;
 using IEnvironmentVariableMap = winrt::Windows::Foundation::Collections::IMap<winrt::hstring, winrt::hstring>;
 
+// Macro format (defaultArgs are optional):
+// (type, name, defaultArgs)
+//
+// All of these settings are defined in ICoreSettings.
+//
+// When set, StartingTabColor allows to create a terminal with a "sticky" tab color.
+// This color is prioritized above the TabColor (that is usually initialized based on profile settings).
+// Due to this prioritization, the tab color will be preserved upon settings reload
+// (even if the profile's tab color gets altered or removed).
+// This property is expected to be passed only once upon terminal creation.
+// TODO: to ensure that this property is not populated during settings reload,
+// we should consider moving this property to a separate interface,
+// passed to the terminal only upon creation.
+#define MTSM_TERMINAL_CORE_SETTINGS(X)                                                                                                          \
+    X(til::color, DefaultForeground, DEFAULT_FOREGROUND)                                                                                        \
+    X(til::color, DefaultBackground, DEFAULT_BACKGROUND)                                                                                        \
+    X(til::color, SelectionBackground, DEFAULT_FOREGROUND)                                                                                      \
+    X(int32_t, HistorySize, DEFAULT_HISTORY_SIZE)                                                                                               \
+    X(int32_t, InitialRows, 30)                                                                                                                 \
+    X(int32_t, InitialCols, 80)                                                                                                                 \
+    X(bool, SnapOnInput, true)                                                                                                                  \
+    X(bool, AltGrAliasing, true)                                                                                                                \
+    X(hstring, AnswerbackMessage)                                                                                                               \
+    X(til::color, CursorColor, DEFAULT_CURSOR_COLOR)                                                                                            \
+    X(Microsoft::Terminal::Core::CursorStyle, CursorShape, Core::CursorStyle::Vintage)                                                          \
+    X(uint32_t, CursorHeight, DEFAULT_CURSOR_HEIGHT)                                                                                            \
+    X(hstring, WordDelimiters, DEFAULT_WORD_DELIMITERS)                                                                                         \
+    X(bool, CopyOnSelect, false)                                                                                                                \
+    X(Microsoft::Terminal::Control::CopyFormat, CopyFormatting, 0)                                                                              \
+    X(bool, FocusFollowMouse, false)                                                                                                            \
+    X(bool, AllowVtChecksumReport, false)                                                                                                       \
+    X(int32_t, ColdScrollbackThreshold, 0)                                                                                                      \
+    X(bool, ColdScrollbackFileBacked, false)                                                                                                    \
+    X(int32_t, RetainedScrollbackSize, 0)                                                                                                       \
+    X(bool, TrimBlockSelection, true)                                                                                                           \
+    X(bool, DetectURLs, true)                                                                                                                   \
+    X(Windows::Foundation::IReference<Microsoft::Terminal::Core::Color>, TabColor, nullptr)                                                     \
+    X(Windows::Foundation::IReference<Microsoft::Terminal::Core::Color>, StartingTabColor, nullptr)                                             \
+    X(bool, IntenseIsBold)                                                                                                                      \
+    X(bool, IntenseIsBright)                                                                                                                    \
+    X(Microsoft::Terminal::Core::AdjustTextMode, AdjustIndistinguishableColors, Core::AdjustTextMode::Never)                                    \
+    X(bool, RainbowSuggestions, false)
+
+// All of these settings are defined in IControlSettings.
+#define MTSM_TERMINAL_CONTROL_SETTINGS(X)                                                                                                       \
+    X(hstring, ProfileName)                                                                                                                     \
+    X(guid, SessionId)                                                                                                                          \
+    X(bool, EnableUnfocusedAcrylic, false)                                                                                                      \
+    X(bool, UseAcrylic, false)                                                                                                                  \
+    X(float, Opacity, UseAcrylic() ? 0.5f : 1.0f)                                                                                               \
+    X(hstring, Padding, DEFAULT_PADDING)                                                                                                        \
+    X(hstring, FontFace, DEFAULT_FONT_FACE)                                                                                                     \
+    X(float, FontSize, DEFAULT_FONT_SIZE)                                                                                                       \
+    X(winrt::Windows::UI::Text::FontWeight, FontWeight)                                                                                         \
+    X(IFontAxesMap, FontAxes)                                                                                                                   \
+    X(IFontFeatureMap, FontFeatures)                                                                                                            \
+    X(bool, EnableBuiltinGlyphs, true)                                                                                                          \
+    X(bool, EnableColorGlyphs, true)                                                                                                            \
+    X(hstring, CellWidth)                                                                                                                       \
+    X(hstring, CellHeight)                                                                                                                      \
+    X(Model::ColorScheme, AppliedColorScheme)                                                                                                   \
+    X(hstring, BackgroundImage)                                                                                                                 \
+    X(float, BackgroundImageOpacity, 1.0f)                                                                                                      \
+    X(winrt::Windows::UI::Xaml::Media::Stretch, BackgroundImageStretchMode, winrt::Windows::UI::Xaml::Media::Stretch::UniformToFill)            \
+    X(winrt::Windows::UI::Xaml::HorizontalAlignment, BackgroundImageHorizontalAlignment, winrt::Windows::UI::Xaml::HorizontalAlignment::Center) \
+    X(winrt::Windows::UI::Xaml::VerticalAlignment, BackgroundImageVerticalAlignment, winrt::Windows::UI::Xaml::VerticalAlignment::Center)       \
+    X(Microsoft::Terminal::Control::IKeyBindings, KeyBindings, nullptr)                                                                         \
+    X(hstring, Commandline)                                                                                                                     \
+    X(hstring, StartingDirectory)                                                                                                               \
+    X(hstring, StartingTitle)                                                                                                                   \
+    X(bool, SuppressApplicationTitle)                                                                                                           \
+    X(IEnvironmentVariableMap, EnvironmentVariables)                                                                                            \
+    X(Microsoft::Terminal::Control::ScrollbarState, ScrollState, Microsoft::Terminal::Control::ScrollbarState::Visible)                         \
+    X(Microsoft::Terminal::Control::TextAntialiasingMode, AntialiasingMode, Microsoft::Terminal::Control::TextAntialiasingMode::Grayscale)      \
+    X(bool, RetroTerminalEffect, false)                                                                                                         \
+    X(Microsoft::Terminal::Control::GraphicsAPI, GraphicsAPI)                                                                                   \
+    X(bool, DisablePartialInvalidation, false)                                                                                                  \
+    X(bool, PersistGlyphAtlas, false)                                                                                                           \
+    X(bool, SoftwareRendering, false)                                                                                                           \
+    X(int32_t, AnimationFrameRate, 0)                                                                                                           \
+    X(Microsoft::Terminal::Control::TextMeasurement, TextMeasurement)                                                                           \
+    X(Microsoft::Terminal::Control::DefaultInputScope, DefaultInputScope)                                                                       \
+    X(bool, UseBackgroundImageForWindow, false)                                                                                                 \
+    X(bool, ForceVTInput, false)                                                                                                                \
+    X(hstring, PixelShaderPath)                                                                                                                 \
+    X(hstring, PixelShaderImagePath)                                                                                                            \
+    X(bool, Elevate, false)                                                                                                                     \
+    X(bool, AutoMarkPrompts, false)                                                                                                             \
+    X(bool, ShowMarks, false)                                                                                                                   \
+    X(bool, RightClickContextMenu, false)                                                                                                       \
+    X(bool, RepositionCursorWithMouse, false)                                                                                                   \
+    X(bool, SmoothScrolling, false)                                                                                                             \
+    X(bool, ReloadEnvironmentVariables, true)                                                                                                   \
+    X(Microsoft::Terminal::Control::PathTranslationStyle, PathTranslationStyle, Microsoft::Terminal::Control::PathTranslationStyle::None)
+
 // fwdecl unittest classes
 namespace SettingsModelUnitTests
 {
@@ -67,6 +162,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
                                                                              const Control::IKeyBindings& keybindings);
 
         void ApplyColorScheme(const Model::ColorScheme& scheme);
+        bool IsEquivalentTo(const Model::TerminalSettings& other);
 
         // --------------------------- Core Settings ---------------------------
         //  All of these settings are defined in ICoreSettings.
@@ -77,107 +173,14 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         void ColorTable(std::array<Microsoft::Terminal::Core::Color, 16> colors);
         std::array<Microsoft::Terminal::Core::Color, 16> ColorTable();
 
-        INHERITABLE_SETTING(Model::TerminalSettings, til::color, DefaultForeground, DEFAULT_FOREGROUND);
-        INHERITABLE_SETTING(Model::TerminalSettings, til::color, DefaultBackground, DEFAULT_BACKGROUND);
-        INHERITABLE_SETTING(Model::TerminalSettings, til::color, SelectionBackground, DEFAULT_FOREGROUND);
-        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, HistorySize, DEFAULT_HISTORY_SIZE);
-        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, InitialRows, 30);
-        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, InitialCols, 80);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, SnapOnInput, true);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, AltGrAliasing, true);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, AnswerbackMessage);
-        INHERITABLE_SETTING(Model::TerminalSettings, til::color, CursorColor, DEFAULT_CURSOR_COLOR);
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Core::CursorStyle, CursorShape, Core::CursorStyle::Vintage);
-        INHERITABLE_SETTING(Model::TerminalSettings, uint32_t, CursorHeight, DEFAULT_CURSOR_HEIGHT);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, WordDelimiters, DEFAULT_WORD_DELIMITERS);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, CopyOnSelect, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::CopyFormat, CopyFormatting, 0);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, FocusFollowMouse, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, AllowVtChecksumReport, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, TrimBlockSelection, true);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, DetectURLs, true);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Windows::Foundation::IReference<Microsoft::Terminal::Core::Color>, TabColor, nullptr);
-
-        // When set, StartingTabColor allows to create a terminal with a "sticky" tab color.
-        // This color is prioritized above the TabColor (that is usually initialized based on profile settings).
-        // Due to this prioritization, the tab color will be preserved upon settings reload
-        // (even if the profile's tab color gets altered or removed).
-        // This property is expected to be passed only once upon terminal creation.
-        // TODO: to ensure that this property is not populated during settings reload,
-        // we should consider moving this property to a separate interface,
-        // passed to the terminal only upon creation.
-        INHERITABLE_SETTING(Model::TerminalSettings, Windows::Foundation::IReference<Microsoft::Terminal::Core::Color>, StartingTabColor, nullptr);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, IntenseIsBold);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, IntenseIsBright);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Core::AdjustTextMode, AdjustIndistinguishableColors, Core::AdjustTextMode::Never);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, RainbowSuggestions, false);
+#define TERMINAL_SETTINGS_INITIALIZE(type, name, ...) \
+    INHERITABLE_SETTING(Model::TerminalSettings, type, name, ##__VA_ARGS__)
+        MTSM_TERMINAL_CORE_SETTINGS(TERMINAL_SETTINGS_INITIALIZE)
 
         // ------------------------ End of Core Settings -----------------------
 
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, ProfileName);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, guid, SessionId);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, EnableUnfocusedAcrylic, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, UseAcrylic, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, float, Opacity, UseAcrylic() ? 0.5f : 1.0f);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, Padding, DEFAULT_PADDING);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, FontFace, DEFAULT_FONT_FACE);
-        INHERITABLE_SETTING(Model::TerminalSettings, float, FontSize, DEFAULT_FONT_SIZE);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, winrt::Windows::UI::Text::FontWeight, FontWeight);
-        INHERITABLE_SETTING(Model::TerminalSettings, IFontAxesMap, FontAxes);
-        INHERITABLE_SETTING(Model::TerminalSettings, IFontFeatureMap, FontFeatures);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, EnableBuiltinGlyphs, true);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, EnableColorGlyphs, true);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, CellWidth);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, CellHeight);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Model::ColorScheme, AppliedColorScheme);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, BackgroundImage);
-        INHERITABLE_SETTING(Model::TerminalSettings, float, BackgroundImageOpacity, 1.0f);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, winrt::Windows::UI::Xaml::Media::Stretch, BackgroundImageStretchMode, winrt::Windows::UI::Xaml::Media::Stretch::UniformToFill);
-        INHERITABLE_SETTING(Model::TerminalSettings, winrt::Windows::UI::Xaml::HorizontalAlignment, BackgroundImageHorizontalAlignment, winrt::Windows::UI::Xaml::HorizontalAlignment::Center);
-        INHERITABLE_SETTING(Model::TerminalSettings, winrt::Windows::UI::Xaml::VerticalAlignment, BackgroundImageVerticalAlignment, winrt::Windows::UI::Xaml::VerticalAlignment::Center);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::IKeyBindings, KeyBindings, nullptr);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, Commandline);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, StartingDirectory);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, StartingTitle);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, SuppressApplicationTitle);
-        INHERITABLE_SETTING(Model::TerminalSettings, IEnvironmentVariableMap, EnvironmentVariables);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::ScrollbarState, ScrollState, Microsoft::Terminal::Control::ScrollbarState::Visible);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::TextAntialiasingMode, AntialiasingMode, Microsoft::Terminal::Control::TextAntialiasingMode::Grayscale);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, RetroTerminalEffect, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::GraphicsAPI, GraphicsAPI);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, DisablePartialInvalidation, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, SoftwareRendering, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::TextMeasurement, TextMeasurement);
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::DefaultInputScope, DefaultInputScope);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, UseBackgroundImageForWindow, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, ForceVTInput, false);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, PixelShaderPath);
-        INHERITABLE_SETTING(Model::TerminalSettings, hstring, PixelShaderImagePath);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, Elevate, false);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, AutoMarkPrompts, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, ShowMarks, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, RightClickContextMenu, false);
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, RepositionCursorWithMouse, false);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, bool, ReloadEnvironmentVariables, true);
-
-        INHERITABLE_SETTING(Model::TerminalSettings, Microsoft::Terminal::Control::PathTranslationStyle, PathTranslationStyle, Microsoft::Terminal::Control::PathTranslationStyle::None);
+        MTSM_TERMINAL_CONTROL_SETTINGS(TERMINAL_SETTINGS_INITIALIZE)
+#undef TERMINAL_SETTINGS_INITIALIZE
 
     private:
         std::optional<std::array<Microsoft::Terminal::Core::Color, COLOR_TABLE_SIZE>> _ColorTable;
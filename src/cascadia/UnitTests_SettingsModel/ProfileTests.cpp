@@ -30,6 +30,7 @@ namespace SettingsModelUnitTests
         TEST_METHOD(DuplicateProfileTest);
         TEST_METHOD(TestGenGuidsForProfiles);
         TEST_METHOD(TestCorrectOldDefaultShellPaths);
+        TEST_METHOD(ResolvedSettingsFollowChanges);
     };
 
     void ProfileTests::ProfileGeneratesGuid()
@@ -470,4 +471,47 @@ namespace SettingsModelUnitTests
         VERIFY_ARE_EQUAL(L"%SystemRoot%\\System32\\cmd.exe", allProfiles.GetAt(2).Commandline());
         VERIFY_ARE_EQUAL(L"cmd.exe", allProfiles.GetAt(3).Commandline());
     }
-}
+
+    void ProfileTests::ResolvedSettingsFollowChanges()
+    {
+        static constexpr std::string_view userProfiles{ R"({
+            "profiles": {
+                "defaults": {
+                    "historySize": 123
+                },
+                "list": [
+                    {
+                        "name": "profile0",
+                        "guid": "{6239a42c-0000-49a3-80bd-e8fdd045185c}"
+                    },
+                    {
+                        "name": "profile1",
+                        "guid": "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+                        "historySize": 456
+                    }
+                ]
+            }
+        })" };
+
+        const auto settings = winrt::make_self<implementation::CascadiaSettings>(userProfiles);
+        const auto profile0 = settings->AllProfiles().GetAt(0);
+        const auto profile1 = settings->AllProfiles().GetAt(1);
+
+        VERIFY_ARE_EQUAL(123, profile0.HistorySize());
+        VERIFY_ARE_EQUAL(456, profile1.HistorySize());
+
+        // A change to the parent must be visible in its children, even though they cached their values.
+        settings->ProfileDefaults().HistorySize(789);
+        VERIFY_ARE_EQUAL(789, profile0.HistorySize());
+        VERIFY_ARE_EQUAL(456, profile1.HistorySize());
+
+        profile1.ClearHistorySize();
+        VERIFY_ARE_EQUAL(789, profile1.HistorySize());
+
+        // Copies are flattened as well and must not be affected by changes to the original.
+        const auto copy = settings->Copy();
+        settings->ProfileDefaults().HistorySize(1000);
+        VERIFY_ARE_EQUAL(789, copy.AllProfiles().GetAt(0).HistorySize());
+        VERIFY_ARE_EQUAL(1000, profile0.HistorySize());
+    }
+}
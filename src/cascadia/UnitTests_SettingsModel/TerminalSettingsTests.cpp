@@ -32,6 +32,7 @@ namespace SettingsModelUnitTests
         TEST_METHOD(MakeSettingsForDefaultProfileThatDoesntExist);
         TEST_METHOD(TestLayerProfileOnColorScheme);
         TEST_METHOD(TestCommandlineToTitlePromotion);
+        TEST_METHOD(TestSettingsEquivalence);
 
         TEST_CLASS_SETUP(ClassSetup)
         {
@@ -894,4 +895,57 @@ namespace SettingsModelUnitTests
             VERIFY_ARE_EQUAL(L"", settingsStruct.DefaultSettings().StartingTitle());
         }
     }
+
+    void TerminalSettingsTests::TestSettingsEquivalence()
+    {
+        static constexpr std::string_view settingsString{ R"(
+        {
+            "defaultProfile": "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+            "profiles": [
+                {
+                    "name" : "profile0",
+                    "guid": "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+                    "colorScheme": "Campbell",
+                    "font": { "face": "Cascadia Mono", "axes": { "wght": 400 } },
+                    "unfocusedAppearance": { "opacity": 50 }
+                }
+            ]
+        })" };
+        static constexpr std::string_view changedSettingsString{ R"(
+        {
+            "defaultProfile": "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+            "profiles": [
+                {
+                    "name" : "profile0",
+                    "guid": "{6239a42c-1111-49a3-80bd-e8fdd045185c}",
+                    "colorScheme": "Campbell",
+                    "font": { "face": "Cascadia Mono", "axes": { "wght": 500 } },
+                    "unfocusedAppearance": { "opacity": 50 }
+                }
+            ]
+        })" };
+
+        const auto guid = ::Microsoft::Console::Utils::GuidFromString(L"{6239a42c-1111-49a3-80bd-e8fdd045185c}");
+
+        // Two independent loads of the same settings produce distinct, but equivalent objects.
+        const auto settings1 = winrt::make_self<implementation::CascadiaSettings>(settingsString);
+        const auto settings2 = winrt::make_self<implementation::CascadiaSettings>(settingsString);
+        const auto result1 = TerminalSettings::CreateWithProfile(*settings1, settings1->FindProfile(guid), nullptr);
+        const auto result2 = TerminalSettings::CreateWithProfile(*settings2, settings2->FindProfile(guid), nullptr);
+        VERIFY_IS_FALSE(result1.DefaultSettings() == result2.DefaultSettings());
+        VERIFY_IS_TRUE(result1.DefaultSettings().IsEquivalentTo(result2.DefaultSettings()));
+        VERIFY_IS_TRUE(result1.UnfocusedSettings().IsEquivalentTo(result2.UnfocusedSettings()));
+
+        // The focused and unfocused appearance differ in their opacity.
+        VERIFY_IS_FALSE(result1.DefaultSettings().IsEquivalentTo(result1.UnfocusedSettings()));
+
+        // A change in a map-valued setting is detected, too.
+        const auto settings3 = winrt::make_self<implementation::CascadiaSettings>(changedSettingsString);
+        const auto result3 = TerminalSettings::CreateWithProfile(*settings3, settings3->FindProfile(guid), nullptr);
+        VERIFY_IS_FALSE(result1.DefaultSettings().IsEquivalentTo(result3.DefaultSettings()));
+
+        // Runtime changes to the settings object are detected as well.
+        result2.DefaultSettings().Commandline(L"foo.exe");
+        VERIFY_IS_FALSE(result1.DefaultSettings().IsEquivalentTo(result2.DefaultSettings()));
+    }
 }
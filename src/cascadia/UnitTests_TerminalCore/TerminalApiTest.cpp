@@ -41,6 +41,8 @@ namespace TerminalCoreUnitTests
 
         TEST_METHOD(SetTaskbarProgress);
         TEST_METHOD(SetWorkingDirectory);
+
+        TEST_METHOD(WriteYieldingMatchesWrite);
     };
 };
 
@@ -477,3 +479,44 @@ void TerminalCoreUnitTests::TerminalApiTest::SetWorkingDirectory()
     stateMachine.ProcessString(L"\x1b]9;9;D:\\中文\x1b\\");
     VERIFY_ARE_EQUAL(term.GetWorkingDirectory(), L"D:\\中文");
 }
+
+void TerminalCoreUnitTests::TerminalApiTest::WriteYieldingMatchesWrite()
+{
+    // WriteYielding() splits the output into pieces near line feeds. The pieces must
+    // add up to the same output, even where they end in an escape sequence or a surrogate pair.
+    std::wstring text;
+    for (auto i = 0; i < 2000; ++i)
+    {
+        text.append(gsl::narrow_cast<size_t>(i % 97), gsl::narrow_cast<wchar_t>(L'a' + i % 26));
+        text.append(i % 3 ? L"\x1b[3" : L"\U0001F600\x1b[4");
+        text.push_back(gsl::narrow_cast<wchar_t>(L'0' + i % 8));
+        text.append(i % 5 ? L"m\r\n" : L"m");
+    }
+
+    Terminal expected{ Terminal::TestDummyMarker{} };
+    DummyRenderer expectedRenderer{ &expected };
+    expected.Create({ 100, 30 }, 3000, expectedRenderer);
+    expected.Write(text);
+
+    Terminal actual{ Terminal::TestDummyMarker{} };
+    DummyRenderer actualRenderer{ &actual };
+    actual.Create({ 100, 30 }, 3000, actualRenderer);
+    actual.WriteYielding(text, std::chrono::steady_clock::duration::zero());
+
+    const auto& expectedBuffer = expected.GetTextBuffer();
+    const auto& actualBuffer = actual.GetTextBuffer();
+    VERIFY_ARE_EQUAL(expectedBuffer.GetCursor().GetPosition(), actualBuffer.GetCursor().GetPosition());
+    for (til::CoordType y = 0; y < expectedBuffer.TotalRowCount(); ++y)
+    {
+        const auto& expectedRow = expectedBuffer.GetRowByOffset(y);
+        const auto& actualRow = actualBuffer.GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(expectedRow.GetText(), actualRow.GetText());
+
+        auto sameAttributes = true;
+        for (til::CoordType x = 0; x < 100; ++x)
+        {
+            sameAttributes &= expectedRow.GetAttrByColumn(x) == actualRow.GetAttrByColumn(x);
+        }
+        VERIFY_IS_TRUE(sameAttributes);
+    }
+}
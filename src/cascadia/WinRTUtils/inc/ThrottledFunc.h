@@ -27,6 +27,7 @@ public:
         winrt::Windows::System::DispatcherQueue dispatcher,
         filetime_duration delay,
         function func) :
+        _window{ til::details::throttled_func_window(delay) },
         _dispatcher{ std::move(dispatcher) },
         _func{ std::move(func) },
         _timer{ _create_timer() }
@@ -90,13 +91,13 @@ private:
                     }
                     CATCH_LOG();
 
-                    SetThreadpoolTimerEx(self->_timer.get(), &self->_delay, 0, 0);
+                    SetThreadpoolTimerEx(self->_timer.get(), &self->_delay, 0, self->_window);
                 }
             });
         }
         else
         {
-            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, 0);
+            SetThreadpoolTimerEx(_timer.get(), &_delay, 0, _window);
         }
     }
 
@@ -129,6 +130,7 @@ private:
     }
 
     FILETIME _delay;
+    DWORD _window;
     winrt::Windows::System::DispatcherQueue _dispatcher;
     function _func;
 
@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "IslandWindow.h"
 #include "../types/inc/Viewport.hpp"
+#include "../inc/StartupTracing.h"
 #include "resource.h"
 #include "icon.h"
 #include "NotificationIcon.h"
@@ -365,6 +366,8 @@ bool IslandWindow::Initialize()
 // - This should only be called once.
 void IslandWindow::_coldInitialize()
 {
+    const ::Microsoft::Terminal::StartupStageScope startupStage{ g_hWindowsTerminalProvider, "XamlIsland" };
+
     _source = DesktopWindowXamlSource{};
 
     auto interop = _source.as<IDesktopWindowXamlSourceNative>();
@@ -737,9 +740,8 @@ void IslandWindow::_OnGetMinMaxInfo(const WPARAM /*wParam*/, const LPARAM lParam
     }
     case WM_SETTINGCHANGE:
     {
-        // Currently, we only support checking when the OS theme changes. In
-        // that case, wParam is 0. Re-evaluate when we decide to reload env vars
-        // (GH#1125)
+        // We check for changes of the OS theme and the environment variables.
+        // In both cases wParam is 0.
         if (wparam == 0 && lparam != 0)
         {
             const std::wstring param{ (wchar_t*)lparam };
@@ -759,6 +761,12 @@ void IslandWindow::_OnGetMinMaxInfo(const WPARAM /*wParam*/, const LPARAM lParam
                     UpdateSettingsRequested.raise();
                 }
             }
+            // The environment variables were changed, for instance in the System Properties.
+            // Connections that reload them (reloadEnvironmentVariables) need to read them again.
+            else if (param == L"Environment")
+            {
+                winrt::Microsoft::Terminal::TerminalConnection::ConptyConnection::InvalidateEnvironmentCache();
+            }
         }
         break;
     }
@@ -4,6 +4,7 @@
 #include "pch.h"
 #include "WindowEmperor.h"
 
+#include "../inc/StartupTracing.h"
 #include "../inc/WindowingBehavior.h"
 #include "../../types/inc/utils.hpp"
 #include "../WinRTUtils/inc/WtExeUtils.h"
@@ -91,8 +92,14 @@ void WindowEmperor::HandleCommandlineArgs(int nCmdShow)
     }
 
     const Remoting::CommandlineArgs eventArgs{ args, cwd, gsl::narrow_cast<uint32_t>(nCmdShow), std::move(env) };
-    const auto isolatedMode{ _app.Logic().IsolatedMode() };
-    const auto result = _manager.ProposeCommandline(eventArgs, isolatedMode);
+    // If a monarch is already accepting commandlines, it isn't running in isolated mode, and so
+    // we can hand our commandline over right away. This avoids loading the settings in every
+    // process that's spawned by `wt -w 0 nt` and similar, just to exit again afterwards.
+    const auto isolatedMode{ !_manager.IsMonarchReady() && _app.Logic().IsolatedMode() };
+    const auto result = [&]() {
+        const ::Microsoft::Terminal::StartupStageScope startupStage{ g_hWindowsTerminalProvider, "WindowManagerElection" };
+        return _manager.ProposeCommandline(eventArgs, isolatedMode);
+    }();
     int exitCode = 0;
 
     if (result.ShouldCreateWindow())
@@ -337,6 +344,7 @@ void WindowEmperor::_becomeMonarch()
         {
             _setupGlobalHotkeys();
             _checkWindowsForNotificationIcon();
+            _manager.SetMonarchReady(!_app.Logic().IsolatedMode());
         }
     });
 
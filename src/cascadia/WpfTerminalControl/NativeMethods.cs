@@ -185,6 +185,15 @@ namespace Microsoft.Terminal.Wpf
         [DllImport("Microsoft.Terminal.Control.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.StdCall, PreserveSig = true)]
         public static extern void TerminalSendOutput(IntPtr terminal, string lpdata);
 
+        [DllImport("Microsoft.Terminal.Control.dll", CallingConvention = CallingConvention.StdCall, PreserveSig = true)]
+        public static extern void TerminalSendOutputUtf8(IntPtr terminal, byte[] data, uint length);
+
+        [DllImport("Microsoft.Terminal.Control.dll", CallingConvention = CallingConvention.StdCall, PreserveSig = true)]
+        public static extern void TerminalBeginOutputBatch(IntPtr terminal);
+
+        [DllImport("Microsoft.Terminal.Control.dll", CallingConvention = CallingConvention.StdCall, PreserveSig = true)]
+        public static extern void TerminalEndOutputBatch(IntPtr terminal);
+
         [DllImport("Microsoft.Terminal.Control.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.StdCall, PreserveSig = false)]
         public static extern void TerminalTriggerResize(IntPtr terminal, int width, int height, out TilSize dimensions);
 
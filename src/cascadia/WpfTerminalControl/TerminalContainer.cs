@@ -163,6 +163,53 @@ namespace Microsoft.Terminal.Wpf
             }
         }
 
+        /// <summary>
+        /// Writes UTF-8 encoded output to the terminal.
+        /// </summary>
+        /// <param name="data">The output. UTF-8 sequences may be split across calls.</param>
+        /// <param name="count">The number of bytes in <paramref name="data"/> to write.</param>
+        internal void SendOutput(byte[] data, int count)
+        {
+            if (data == null)
+            {
+                throw new ArgumentNullException(nameof(data));
+            }
+
+            if (count < 0 || count > data.Length)
+            {
+                throw new ArgumentOutOfRangeException(nameof(count));
+            }
+
+            if (this.terminal == IntPtr.Zero || count == 0)
+            {
+                return;
+            }
+
+            NativeMethods.TerminalSendOutputUtf8(this.terminal, data, (uint)count);
+        }
+
+        /// <summary>
+        /// Starts collecting the terminal output until the matching <see cref="EndOutputBatch"/> call.
+        /// </summary>
+        internal void BeginOutputBatch()
+        {
+            if (this.terminal != IntPtr.Zero)
+            {
+                NativeMethods.TerminalBeginOutputBatch(this.terminal);
+            }
+        }
+
+        /// <summary>
+        /// Writes the output collected since <see cref="BeginOutputBatch"/> to the terminal at once.
+        /// </summary>
+        internal void EndOutputBatch()
+        {
+            if (this.terminal != IntPtr.Zero)
+            {
+                NativeMethods.TerminalEndOutputBatch(this.terminal);
+            }
+        }
+
         /// <summary>
         /// Gets the selected text from the terminal renderer and clears the selection.
         /// </summary>
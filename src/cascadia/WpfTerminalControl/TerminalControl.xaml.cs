@@ -111,6 +111,35 @@ namespace Microsoft.Terminal.Wpf
             return this.termContainer.GetSelectedText();
         }
 
+        /// <summary>
+        /// Writes UTF-8 encoded output directly to the terminal, bypassing the connection.
+        /// This avoids converting the output to strings first, which is useful for output read from pipes.
+        /// </summary>
+        /// <param name="data">The output. UTF-8 sequences may be split across calls.</param>
+        /// <param name="count">The number of bytes in <paramref name="data"/> to write.</param>
+        public void SendOutput(byte[] data, int count)
+        {
+            this.termContainer.SendOutput(data, count);
+        }
+
+        /// <summary>
+        /// Starts batching the terminal output. Until the matching <see cref="EndOutputBatch"/> call, the output written
+        /// by the connection and <see cref="SendOutput"/> is collected and then processed and rendered at once.
+        /// Batches may be nested.
+        /// </summary>
+        public void BeginOutputBatch()
+        {
+            this.termContainer.BeginOutputBatch();
+        }
+
+        /// <summary>
+        /// Ends a batch started by <see cref="BeginOutputBatch"/>.
+        /// </summary>
+        public void EndOutputBatch()
+        {
+            this.termContainer.EndOutputBatch();
+        }
+
         /// <summary>
         /// Resizes the terminal to the specified rows and columns.
         /// </summary>
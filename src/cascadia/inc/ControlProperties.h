@@ -34,6 +34,9 @@
 //  All of these settings are defined in ICoreSettings.
 #define CORE_SETTINGS(X)                                                                                          \
     X(int32_t, HistorySize, DEFAULT_HISTORY_SIZE)                                                                 \
+    X(int32_t, ColdScrollbackThreshold, 0)                                                                        \
+    X(bool, ColdScrollbackFileBacked, false)                                                                      \
+    X(int32_t, RetainedScrollbackSize, 0)                                                                         \
     X(int32_t, InitialRows, 30)                                                                                   \
     X(int32_t, InitialCols, 80)                                                                                   \
     X(bool, SnapOnInput, true)                                                                                    \
@@ -51,6 +54,7 @@
     X(bool, DetectURLs, true)                                                                                     \
     X(bool, AutoMarkPrompts)                                                                                      \
     X(bool, RepositionCursorWithMouse, false)                                                                     \
+    X(bool, SmoothScrolling, false)                                                                               \
     X(bool, RainbowSuggestions)                                                                                   \
     X(bool, AllowVtChecksumReport)
 
@@ -77,7 +81,9 @@
     X(winrt::Microsoft::Terminal::Control::TextAntialiasingMode, AntialiasingMode, winrt::Microsoft::Terminal::Control::TextAntialiasingMode::Grayscale) \
     X(winrt::Microsoft::Terminal::Control::GraphicsAPI, GraphicsAPI)                                                                                     \
     X(bool, DisablePartialInvalidation, false)                                                                                                           \
+    X(bool, PersistGlyphAtlas, false)                                                                                                                    \
     X(bool, SoftwareRendering, false)                                                                                                                    \
+    X(int32_t, AnimationFrameRate, 0)                                                                                                                    \
     X(winrt::Microsoft::Terminal::Control::TextMeasurement, TextMeasurement)                                                                             \
     X(winrt::Microsoft::Terminal::Control::DefaultInputScope, DefaultInputScope, winrt::Microsoft::Terminal::Control::DefaultInputScope::Default)        \
     X(bool, UseBackgroundImageForWindow, false)                                                                                                          \
@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <unknwn.h>
+
+// A connection may implement this classic COM interface in addition to ITerminalConnection.
+// ControlCore queries for it and, if present, also accepts output through the callback below.
+// That avoids allocating an hstring and going through the WinRT event dispatch for every chunk,
+// which matters for high-bandwidth connections. The TerminalOutput event keeps working
+// for infrequent output like status messages, but just like with two threads raising
+// TerminalOutput, the connection is responsible for the order in which both arrive.
+//
+// Everything else (input, resizing, state changes) still goes through ITerminalConnection.
+struct __declspec(uuid("3f5bd0a2-6b0e-4b8e-9d3c-2a6f1e7c8b41")) ITerminalConnectionNative : ::IUnknown
+{
+    // Receives a chunk of UTF-8 output. It's called on the connection's reader thread, one call at a time.
+    // The connection owns the buffer and may reuse it once the callback returns: The receiver consumes
+    // the data before it returns, and the time it takes doing so is the connection's backpressure.
+    // A chunk may end in the middle of a UTF-8 sequence, which then continues in the next chunk.
+    using OutputCallback = void(__stdcall*)(void* context, const char* data, size_t length) noexcept;
+
+    // Replaces the output callback. Passing nullptr unregisters it, and the connection must not
+    // return until any call to the previous callback has returned.
+    virtual HRESULT __stdcall SetOutputCallback(OutputCallback callback, void* context) noexcept = 0;
+};
@@ -0,0 +1,69 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- StartupTracing.h
+
+Abstract:
+- Helpers to emit the "StartupStage" events that mark the beginning and end of
+  each stage on the startup critical path (settings load, window creation, etc.).
+- Each module emits them through its own TraceLogging provider. They're only
+  written if a trace session enabled the TIL_KEYWORD_TRACE keyword at the verbose
+  level, which tools/Measure-StartupPerformance.ps1 does.
+--*/
+
+#pragma once
+
+#include <TraceLoggingProvider.h>
+#include <winmeta.h>
+
+namespace Microsoft::Terminal
+{
+    inline void TraceStartupStageStart(TraceLoggingHProvider provider, const char* stage) noexcept
+    {
+#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
+        TraceLoggingWrite(provider,
+                          "StartupStage",
+                          TraceLoggingString(stage, "stage"),
+                          TraceLoggingOpcode(WINEVENT_OPCODE_START),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
+
+    inline void TraceStartupStageStop(TraceLoggingHProvider provider, const char* stage) noexcept
+    {
+#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
+        TraceLoggingWrite(provider,
+                          "StartupStage",
+                          TraceLoggingString(stage, "stage"),
+                          TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                          TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+    }
+
+    // Emits the start event on construction and the stop event on destruction.
+    // The stage name must be a string literal (or otherwise outlive the scope).
+    class StartupStageScope
+    {
+    public:
+        StartupStageScope(TraceLoggingHProvider provider, const char* stage) noexcept :
+            _provider{ provider },
+            _stage{ stage }
+        {
+            TraceStartupStageStart(_provider, _stage);
+        }
+
+        ~StartupStageScope()
+        {
+            TraceStartupStageStop(_provider, _stage);
+        }
+
+        StartupStageScope(const StartupStageScope&) = delete;
+        StartupStageScope& operator=(const StartupStageScope&) = delete;
+
+    private:
+        TraceLoggingHProvider _provider;
+        const char* _stage;
+    };
+}
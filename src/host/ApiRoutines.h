@@ -46,7 +46,7 @@ public:
     [[nodiscard]] HRESULT SetConsoleOutputModeImpl(SCREEN_INFORMATION& context,
                                                    const ULONG Mode) noexcept override;
 
-    [[nodiscard]] HRESULT GetNumberOfConsoleInputEventsImpl(const InputBuffer& context,
+    [[nodiscard]] HRESULT GetNumberOfConsoleInputEventsImpl(InputBuffer& context,
                                                             ULONG& events) noexcept override;
 
     [[nodiscard]] HRESULT GetConsoleInputImpl(IConsoleInputObject& context,
@@ -22,6 +22,9 @@ const std::wstring_view ConsoleArguments::FEATURE_ARG = L"--feature";
 const std::wstring_view ConsoleArguments::FEATURE_PTY_ARG = L"pty";
 const std::wstring_view ConsoleArguments::COM_SERVER_ARG = L"-Embedding";
 static constexpr std::wstring_view GLYPH_WIDTH{ L"--textMeasurement" };
+static constexpr std::wstring_view OUTPUT_RING_ARG{ L"--outputRing" };
+static constexpr std::wstring_view OUTPUT_RING_DATA_EVENT_ARG{ L"--outputRingDataEvent" };
+static constexpr std::wstring_view OUTPUT_RING_SPACE_EVENT_ARG{ L"--outputRingSpaceEvent" };
 // NOTE: Thinking about adding more commandline args that control conpty, for
 // the Terminal? Make sure you add them to the commandline in
 // ConsoleEstablishHandoff. We use that to initialize the ConsoleArguments for a
@@ -115,6 +118,9 @@ ConsoleArguments::ConsoleArguments(const std::wstring& commandline,
     _createServerHandle = true;
     _serverHandle = 0;
     _signalHandle = 0;
+    _outputRingSection = 0;
+    _outputRingDataEvent = 0;
+    _outputRingSpaceEvent = 0;
     _forceV1 = false;
     _forceNoHandoff = false;
     _width = 0;
@@ -139,6 +145,9 @@ ConsoleArguments& ConsoleArguments::operator=(const ConsoleArguments& other)
         _createServerHandle = other._createServerHandle;
         _serverHandle = other._serverHandle;
         _signalHandle = other._signalHandle;
+        _outputRingSection = other._outputRingSection;
+        _outputRingDataEvent = other._outputRingDataEvent;
+        _outputRingSpaceEvent = other._outputRingSpaceEvent;
         _forceV1 = other._forceV1;
         _width = other._width;
         _height = other._height;
@@ -443,6 +452,18 @@ void ConsoleArguments::s_ConsumeArg(_Inout_ std::vector<std::wstring>& args, _In
                 hr = s_ParseHandleArg(signalHandleVal, _signalHandle);
             }
         }
+        else if (arg == OUTPUT_RING_ARG || arg == OUTPUT_RING_DATA_EVENT_ARG || arg == OUTPUT_RING_SPACE_EVENT_ARG)
+        {
+            auto& target = arg == OUTPUT_RING_ARG ? _outputRingSection : arg == OUTPUT_RING_DATA_EVENT_ARG ? _outputRingDataEvent : _outputRingSpaceEvent;
+
+            std::wstring handleVal;
+            hr = s_GetArgumentValue(args, i, &handleVal);
+
+            if (SUCCEEDED(hr))
+            {
+                hr = s_ParseHandleArg(handleVal, target);
+            }
+        }
         else if (arg == FORCE_V1_ARG)
         {
             // -ForceV1 command line switch for NTVDM support
@@ -596,6 +617,28 @@ HANDLE ConsoleArguments::GetSignalHandle() const
     return ULongToHandle(_signalHandle);
 }
 
+// Routine Description:
+// - Returns true if we were given all handles of a shared memory ring to write our output into.
+bool ConsoleArguments::HasOutputRing() const
+{
+    return IsValidHandle(GetOutputRingSection()) && IsValidHandle(GetOutputRingDataEvent()) && IsValidHandle(GetOutputRingSpaceEvent());
+}
+
+HANDLE ConsoleArguments::GetOutputRingSection() const
+{
+    return ULongToHandle(_outputRingSection);
+}
+
+HANDLE ConsoleArguments::GetOutputRingDataEvent() const
+{
+    return ULongToHandle(_outputRingDataEvent);
+}
+
+HANDLE ConsoleArguments::GetOutputRingSpaceEvent() const
+{
+    return ULongToHandle(_outputRingSpaceEvent);
+}
+
 HANDLE ConsoleArguments::GetVtInHandle() const
 {
     return _vtInHandle;
@@ -44,6 +44,11 @@ public:
     bool HasSignalHandle() const;
     HANDLE GetSignalHandle() const;
 
+    bool HasOutputRing() const;
+    HANDLE GetOutputRingSection() const;
+    HANDLE GetOutputRingDataEvent() const;
+    HANDLE GetOutputRingSpaceEvent() const;
+
     std::wstring GetOriginalCommandLine() const;
     std::wstring GetClientCommandline() const;
     const std::wstring& GetTextMeasurement() const;
@@ -103,6 +108,9 @@ private:
         _createServerHandle(createServerHandle),
         _serverHandle(serverHandle),
         _signalHandle(signalHandle),
+        _outputRingSection(0),
+        _outputRingDataEvent(0),
+        _outputRingSpaceEvent(0),
         _inheritCursor(inheritCursor),
         _runAsComServer{ runAsComServer }
     {
@@ -130,6 +138,9 @@ private:
     bool _createServerHandle;
     DWORD _serverHandle;
     DWORD _signalHandle;
+    DWORD _outputRingSection;
+    DWORD _outputRingDataEvent;
+    DWORD _outputRingSpaceEvent;
     bool _inheritCursor;
 
     [[nodiscard]] HRESULT _GetClientCommandline(_Inout_ std::vector<std::wstring>& args,
@@ -135,6 +135,12 @@ try
                 return S_OK;
             }
 
+            // Every resize reflows the buffer and makes us send a full redraw to the terminal.
+            // If it has already sent us the next size, the current one is stale, so we skip it.
+            while (_TryGetQueuedResize(resizeMsg))
+            {
+            }
+
             _DoResizeWindow(resizeMsg);
             break;
         }
@@ -274,6 +280,39 @@ void PtySignalInputThread::_DoSetWindowParent(const SetParentData& data)
     return true;
 }
 
+// Method Description:
+// - Checks whether the next message in the pipe is another resize and consumes it if so.
+//   Never blocks: Messages that haven't arrived entirely yet are left in the pipe.
+// Arguments:
+// - data - Receives the size of the queued resize message.
+// Return Value:
+// - True if a queued resize message was read into data. False otherwise.
+[[nodiscard]] bool PtySignalInputThread::_TryGetQueuedResize(ResizeWindowData& data)
+{
+#pragma pack(push, 1)
+    struct
+    {
+        PtySignal signalId;
+        ResizeWindowData resize;
+    } msg;
+#pragma pack(pop)
+
+    DWORD dwRead = 0;
+    if (!_hFile || !PeekNamedPipe(_hFile.get(), &msg, sizeof(msg), &dwRead, nullptr, nullptr) ||
+        dwRead != sizeof(msg) || msg.signalId != PtySignal::ResizeWindow)
+    {
+        return false;
+    }
+
+    if (!_GetData(&msg, sizeof(msg)))
+    {
+        return false;
+    }
+
+    data = msg.resize;
+    return true;
+}
+
 // Method Description:
 // - Starts the PTY Signal input thread.
 [[nodiscard]] HRESULT PtySignalInputThread::Start() noexcept
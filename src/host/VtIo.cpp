@@ -50,7 +50,22 @@ using namespace Microsoft::Console::Interactivity;
             CodepointWidthDetector::Singleton().Reset(mode);
         }
 
-        return _Initialize(pArgs->GetVtInHandle(), pArgs->GetVtOutHandle(), pArgs->GetSignalHandle());
+        RETURN_IF_FAILED(_Initialize(pArgs->GetVtInHandle(), pArgs->GetVtOutHandle(), pArgs->GetSignalHandle()));
+
+        // The terminal can ask us to write our output into a shared memory ring. If that doesn't work
+        // out, we fall back to the output pipe, which the terminal keeps reading from either way.
+        if (pArgs->HasOutputRing())
+        {
+            try
+            {
+                _outputRing = SharedRingBuffer::Open(wil::unique_handle{ pArgs->GetOutputRingSection() },
+                                                     wil::unique_event{ pArgs->GetOutputRingDataEvent() },
+                                                     wil::unique_event{ pArgs->GetOutputRingSpaceEvent() });
+            }
+            CATCH_LOG();
+        }
+
+        return S_OK;
     }
     // Didn't need to initialize if we didn't have VT stuff. It's still OK, but report we did nothing.
     else
@@ -92,6 +107,12 @@ using namespace Microsoft::Console::Interactivity;
         {
             _overlappedBuf.hEvent = _overlappedEvent.get();
             _overlapped = &_overlappedBuf;
+
+            // We only coalesce output if the pipe is overlapped (as it is with CreatePseudoConsole).
+            // With a synchronous handle, the timer callback could otherwise block a threadpool
+            // thread for as long as the terminal doesn't read, while holding the console lock.
+            _flushTimer.reset(CreateThreadpoolTimer(&_flushTimerCallback, this, nullptr));
+            LOG_LAST_ERROR_IF(!_flushTimer);
         }
     }
 
@@ -188,6 +209,9 @@ bool VtIo::IsUsingVt() const
         );
 
         writer.Submit();
+
+        // We'll wait for the responses below, so this must not be held back.
+        Flush();
     }
 
     {
@@ -294,6 +318,50 @@ void VtIo::SendCloseEvent()
     }
 }
 
+// Flushes any output that's being held back for coalescing (see _shouldCoalesce()).
+// This is called whenever a client is about to read input: What it wrote until
+// now must be visible by the time the user is expected to respond to it.
+void VtIo::Flush()
+{
+    if (_flushScheduled && _corked <= 0)
+    {
+        _flushNow();
+    }
+}
+
+VtIo::FlushStatistics VtIo::GetFlushStatistics() const noexcept
+{
+    return _flushStats;
+}
+
+void CALLBACK VtIo::_flushTimerCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
+try
+{
+    const auto self = static_cast<VtIo*>(context);
+
+    LockConsole();
+    const auto unlock = wil::scope_exit([] { UnlockConsole(); });
+
+    if (self->_corked > 0)
+    {
+        // A writer is active (e.g. one that batches multiple API calls) and
+        // will decide anew whether to flush or coalesce once it's submitted.
+        self->_flushScheduled = false;
+        return;
+    }
+
+    // The output may have been flushed in the meantime, for instance by a read.
+    if (self->_flushScheduled)
+    {
+        self->_flushNow();
+
+        // Pending I/O gets canceled when the thread that issued it exits and threadpool
+        // threads come and go as they please. We must wait for it while we're still here.
+        self->_waitForPendingWrite();
+    }
+}
+CATCH_LOG()
+
 // Returns true for C0 characters and C1 [single-character] CSI.
 // A copy of isActionableFromGround() from stateMachine.cpp.
 static constexpr bool IsControlCharacter(wchar_t wch) noexcept
@@ -409,16 +477,23 @@ VtIo::Writer::Writer(VtIo* io) noexcept :
     if (_io)
     {
         _io->_corked += 1;
+        _rollbackSize = _io->_back.size();
+        _rollbackRestoreCursor = _io->_writerRestoreCursor;
     }
 }
 
 VtIo::Writer::~Writer() noexcept
 {
     // If _io is non-null, then we didn't call Submit, e.g. because of an exception.
-    // We need to avoid flushing the buffer in that case.
+    // We need to avoid flushing the broken pieces in that case.
+    //
+    // The buffer may already contain output that is being held back for coalescing or that belongs
+    // to an outer writer (for instance one that batches multiple API calls). We only discard
+    // what we wrote ourselves and leave the rest intact.
     if (_io)
     {
-        _io->_writerTainted = true;
+        _io->_back.resize(_rollbackSize);
+        _io->_writerRestoreCursor = _rollbackRestoreCursor;
         _io->_uncork();
     }
 }
@@ -439,7 +514,45 @@ void VtIo::_uncork()
     _corked -= 1;
     if (_corked <= 0)
     {
-        _flushNow();
+        if (_shouldCoalesce())
+        {
+            _scheduleFlush();
+        }
+        else
+        {
+            _flushNow();
+        }
+    }
+}
+
+// Chatty applications that call WriteConsole() in a tight loop would otherwise result in one
+// tiny WriteFile() per call. If output arrives shortly after the previous flush (= we're in
+// the middle of a burst), we hold it back until either _coalesceMaxSize bytes piled up or
+// _coalesceDelay has passed, whichever comes first. The first write after a pause is never
+// held back, so that the latency of interactive use remains unaffected.
+bool VtIo::_shouldCoalesce() const noexcept
+{
+    if (!_flushTimer || _back.size() >= _coalesceMaxSize)
+    {
+        return false;
+    }
+    if (_flushScheduled)
+    {
+        return true;
+    }
+    return std::chrono::steady_clock::now() - _lastFlush < _coalesceDelay;
+}
+
+void VtIo::_scheduleFlush() noexcept
+{
+    _flushStats.coalesced++;
+
+    // The deadline is relative to the first write that was held back.
+    if (!std::exchange(_flushScheduled, true))
+    {
+        // The FILETIME struct measures time in 100ns steps and negative values are relative due times.
+        auto dueTime = -std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10000000>>>(_coalesceDelay).count();
+        SetThreadpoolTimer(_flushTimer.get(), reinterpret_cast<FILETIME*>(&dueTime), 0, 0);
     }
 }
 
@@ -447,6 +560,12 @@ void VtIo::_flushNow()
 {
     size_t minSize = 0;
 
+    if (_flushTimer)
+    {
+        _flushScheduled = false;
+        _lastFlush = std::chrono::steady_clock::now();
+    }
+
     if (_writerRestoreCursor)
     {
         minSize = 4;
@@ -454,18 +573,7 @@ void VtIo::_flushNow()
         _back.append("\x1b\x38"); // DECRC: DEC Restore Cursor (+ attributes)
     }
 
-    if (_overlappedPending)
-    {
-        _overlappedPending = false;
-
-        DWORD written;
-        if (FAILED(Utils::GetOverlappedResultSameThread(_overlapped, &written)))
-        {
-            // Not much we can do here. Let's treat this like a ERROR_BROKEN_PIPE.
-            _hOutput.reset();
-            SendCloseEvent();
-        }
-    }
+    _waitForPendingWrite();
 
     _front.clear();
     _front.swap(_back);
@@ -477,13 +585,6 @@ void VtIo::_flushNow()
         _back = std::string{};
     }
 
-    // We encountered an exception and shouldn't flush the broken pieces.
-    if (_writerTainted)
-    {
-        _writerTainted = false;
-        return;
-    }
-
     // If _back (now _front) was empty, we can return early. If all _front contains is
     // DECSC/DECRC that was added by BackupCursor & us, we can also return early.
     if (_front.size() <= minSize)
@@ -500,13 +601,25 @@ void VtIo::_flushNow()
 
     const auto write = gsl::narrow_cast<DWORD>(_front.size());
 
+    _flushStats.writes++;
+    _flushStats.bytes += write;
+
     TraceLoggingWrite(
         g_hConhostV2EventTraceProvider,
         "ConPTY WriteFile",
         TraceLoggingCountedUtf8String(_front.data(), write, "buffer"),
+        TraceLoggingUInt64(_flushStats.writes, "totalWrites"),
+        TraceLoggingUInt64(_flushStats.bytes, "totalBytes"),
+        TraceLoggingUInt64(_flushStats.coalesced, "totalCoalesced"),
         TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
         TraceLoggingKeyword(TIL_KEYWORD_TRACE));
 
+    if (_outputRing)
+    {
+        _writeOutputRing();
+        return;
+    }
+
     for (;;)
     {
         if (WriteFile(_hOutput.get(), _front.data(), write, nullptr, _overlapped))
@@ -530,6 +643,47 @@ void VtIo::_flushNow()
     }
 }
 
+// The output pipe stays open while we use the shared memory ring, because the terminal uses it
+// to detect when we exit. We use it to detect the reverse: If the ring stays full for a while,
+// we check whether the terminal is still around, because it can't tell us if it crashed.
+void VtIo::_writeOutputRing()
+{
+    std::string_view remaining{ _front };
+
+    for (;;)
+    {
+        remaining = remaining.substr(_outputRing.Write(remaining, 100));
+        if (remaining.empty())
+        {
+            return;
+        }
+
+        if (_outputRing.IsPeerClosed() ||
+            (!PeekNamedPipe(_hOutput.get(), nullptr, 0, nullptr, nullptr, nullptr) && GetLastError() == ERROR_BROKEN_PIPE))
+        {
+            _hOutput.reset();
+            SendCloseEvent();
+            return;
+        }
+    }
+}
+
+void VtIo::_waitForPendingWrite()
+{
+    if (_overlappedPending)
+    {
+        _overlappedPending = false;
+
+        DWORD written;
+        if (FAILED(Utils::GetOverlappedResultSameThread(_overlapped, &written)))
+        {
+            // Not much we can do here. Let's treat this like a ERROR_BROKEN_PIPE.
+            _hOutput.reset();
+            SendCloseEvent();
+        }
+    }
+}
+
 void VtIo::Writer::BackupCursor() const
 {
     if (!_io->_writerRestoreCursor)
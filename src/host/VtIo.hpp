@@ -5,6 +5,7 @@
 
 #include "VtInputThread.hpp"
 #include "PtySignalInputThread.hpp"
+#include "../types/inc/SharedRingBuffer.hpp"
 
 class ConsoleArguments;
 
@@ -48,10 +49,21 @@ namespace Microsoft::Console::VirtualTerminal
 
         private:
             VtIo* _io = nullptr;
+            size_t _rollbackSize = 0;
+            bool _rollbackRestoreCursor = false;
         };
 
         friend struct Writer;
 
+        struct FlushStatistics
+        {
+            // The number of WriteFile calls and the total number of bytes they wrote.
+            uint64_t writes = 0;
+            uint64_t bytes = 0;
+            // The number of times a writer was submitted without resulting in an immediate WriteFile.
+            uint64_t coalesced = 0;
+        };
+
         static void FormatAttributes(std::string& target, const TextAttribute& attributes);
         static void FormatAttributes(std::wstring& target, const TextAttribute& attributes);
         static wchar_t SanitizeUCS2(wchar_t ch);
@@ -68,11 +80,20 @@ namespace Microsoft::Console::VirtualTerminal
         void SendCloseEvent();
         void CreatePseudoWindow();
 
+        void Flush();
+        FlushStatistics GetFlushStatistics() const noexcept;
+
     private:
         [[nodiscard]] HRESULT _Initialize(const HANDLE InHandle, const HANDLE OutHandle, _In_opt_ const HANDLE SignalHandle);
 
+        static void CALLBACK _flushTimerCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer) noexcept;
+
         void _uncork();
+        bool _shouldCoalesce() const noexcept;
+        void _scheduleFlush() noexcept;
         void _flushNow();
+        void _writeOutputRing();
+        void _waitForPendingWrite();
 
         // After CreateIoHandlers is called, these will be invalid.
         wil::unique_hfile _hInput;
@@ -93,8 +114,17 @@ namespace Microsoft::Console::VirtualTerminal
         OVERLAPPED _overlappedBuf{};
         wil::unique_event _overlappedEvent;
         bool _overlappedPending = false;
+        // If the terminal gave us a shared memory ring, we write into it instead of _hOutput.
+        Microsoft::Console::Utils::SharedRingBuffer _outputRing;
         bool _writerRestoreCursor = false;
-        bool _writerTainted = false;
+
+        // Output coalescing, see _shouldCoalesce(). _flushTimer is only set if it's enabled.
+        wil::unique_threadpool_timer_nowait _flushTimer;
+        std::chrono::steady_clock::time_point _lastFlush;
+        std::chrono::microseconds _coalesceDelay{ 1000 };
+        size_t _coalesceMaxSize = 16 * 1024;
+        bool _flushScheduled = false;
+        FlushStatistics _flushStats;
 
         bool _initialized = false;
         bool _lookingForCursorPosition = false;
@@ -214,30 +214,43 @@ static FillConsoleResult FillConsoleImpl(SCREEN_INFORMATION& screenInfo, FillCon
         // Ironically that's a bug that cannot happen with C pointers. To no ones surprise, C keeps on winning.
         auto attrs = static_cast<const uint16_t*>(data);
         auto chars = static_cast<const wchar_t*>(data);
+        auto& textBuffer = screenBuffer.GetTextBuffer();
 
-        OutputCellIterator it;
-
-        switch (mode)
+        // Filling doesn't need to look at each cell individually, unless the fill character is wide.
+        // Each cell consumes exactly one input element, so lengthRead is the same as cellsModified.
+        if (mode == FillConsoleMode::FillAttribute)
+        {
+            result.cellsModified = textBuffer.FillAttributes(startingCoordinate, TextAttribute(*attrs), lengthToWrite);
+            result.lengthRead = gsl::narrow_cast<size_t>(result.cellsModified);
+        }
+        else if (mode == FillConsoleMode::FillCharacter && (*chars < 0x80 || !IsGlyphFullWidth(*chars)))
         {
-        case FillConsoleMode::WriteAttribute:
-            it = OutputCellIterator({ attrs, lengthToWrite });
-            break;
-        case FillConsoleMode::WriteCharacter:
-            it = OutputCellIterator({ chars, lengthToWrite });
-            break;
-        case FillConsoleMode::FillAttribute:
-            it = OutputCellIterator(TextAttribute(*attrs), lengthToWrite);
-            break;
-        case FillConsoleMode::FillCharacter:
-            it = OutputCellIterator(*chars, lengthToWrite);
-            break;
-        default:
-            __assume(false);
+            result.cellsModified = textBuffer.FillNarrowText(startingCoordinate, *chars, lengthToWrite);
+            result.lengthRead = gsl::narrow_cast<size_t>(result.cellsModified);
         }
+        else
+        {
+            OutputCellIterator it;
 
-        const auto done = screenBuffer.Write(it, startingCoordinate, false);
-        result.lengthRead = done.GetInputDistance(it);
-        result.cellsModified = done.GetCellDistance(it);
+            switch (mode)
+            {
+            case FillConsoleMode::WriteAttribute:
+                it = OutputCellIterator({ attrs, lengthToWrite });
+                break;
+            case FillConsoleMode::WriteCharacter:
+                it = OutputCellIterator({ chars, lengthToWrite });
+                break;
+            case FillConsoleMode::FillCharacter:
+                it = OutputCellIterator(*chars, lengthToWrite);
+                break;
+            default:
+                __assume(false);
+            }
+
+            const auto done = screenBuffer.Write(it, startingCoordinate, false);
+            result.lengthRead = done.GetInputDistance(it);
+            result.cellsModified = done.GetCellDistance(it);
+        }
 
         // If we've overwritten image content, it needs to be erased.
         ImageSlice::EraseCells(screenInfo.GetTextBuffer(), startingCoordinate, result.cellsModified);
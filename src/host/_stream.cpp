@@ -386,6 +386,46 @@ void WriteCharsVT(SCREEN_INFORMATION& screenInfo, const std::wstring_view& str)
     }
 }
 
+// Same as WriteCharsVT, but if the string is large, it's processed in slices with the console lock released in between.
+// Otherwise, an application flooding the console with output would hold the lock for so long, that the processing
+// of input (which the VtInputThread needs the lock for) would be visibly delayed.
+//
+// This is only safe for ConPTY, because it has no window thread that could suspend output in between slices,
+// and because API calls, which are the only other source of output, are all serviced by the IO thread which is us.
+// To other threads an individual WriteConsole call is thus still atomic. We only release the lock while the
+// state machine is in the ground state, so that no one can interleave their output with a partially passed-through
+// escape sequence either. The caller must be holding the console lock exactly once.
+static void WriteCharsVTSliced(SCREEN_INFORMATION& screenInfo, std::wstring_view str)
+{
+    static constexpr size_t sliceSize = 16 * 1024;
+
+    // `screenInfo` may be the alternate screen buffer, which a VT sequence in `str` may destroy.
+    // The main buffer on the other hand lives at least as long as the handle the application is writing to.
+    auto& mainBuffer = screenInfo.GetMainBuffer();
+    auto activeBuffer = &screenInfo;
+
+    while (!str.empty())
+    {
+        auto len = std::min(str.size(), sliceSize);
+        // Don't split up surrogate pairs or CRLFs. The latter would make WriteUTF16TranslateCRLF emit CRCRLF.
+        if (len < str.size() && (til::is_leading_surrogate(str[len - 1]) || str[len - 1] == L'\r'))
+        {
+            len++;
+        }
+
+        WriteCharsVT(*activeBuffer, str.substr(0, len));
+        str = str.substr(len);
+        activeBuffer = &mainBuffer.GetActiveBuffer();
+
+        if (!str.empty() && activeBuffer->GetStateMachine().IsInGroundState())
+        {
+            UnlockConsole();
+            LockConsole();
+            activeBuffer = &mainBuffer.GetActiveBuffer();
+        }
+    }
+}
+
 // Erases all contents of the given screenInfo, including the current screen and scrollback.
 void WriteClearScreen(SCREEN_INFORMATION& screenInfo)
 {
@@ -408,6 +448,8 @@ void WriteClearScreen(SCREEN_INFORMATION& screenInfo)
 // - screenInfo - Screen Information class to write the text into at the current cursor position
 // - ppWaiter - If writing to the console is blocked for whatever reason, this will be filled with a pointer to context
 //              that can be used by the server to resume the call at a later time.
+// - mayReleaseLock - True if the caller acquired the console lock just for this call and doesn't
+//                    mind it being released briefly in between (see WriteCharsVTSliced).
 // Return Value:
 // - STATUS_SUCCESS if OK.
 // - CONSOLE_STATUS_WAIT if we couldn't finish now and need to be called back later (see ppWaiter).
@@ -415,7 +457,8 @@ void WriteClearScreen(SCREEN_INFORMATION& screenInfo)
 [[nodiscard]] NTSTATUS DoWriteConsole(_In_reads_bytes_(*pcbBuffer) PCWCHAR pwchBuffer,
                                       _Inout_ size_t* const pcbBuffer,
                                       SCREEN_INFORMATION& screenInfo,
-                                      std::unique_ptr<WriteData>& waiter)
+                                      std::unique_ptr<WriteData>& waiter,
+                                      const bool mayReleaseLock)
 try
 {
     auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
@@ -434,6 +477,10 @@ try
     {
         WriteCharsLegacy(screenInfo, str, nullptr);
     }
+    else if (mayReleaseLock && gci.IsInVtIoMode() && gci.GetCSRecursionCount() == 1)
+    {
+        WriteCharsVTSliced(screenInfo, str);
+    }
     else
     {
         WriteCharsVT(screenInfo, str);
@@ -472,7 +519,8 @@ NT_CATCH_RETURN()
         size_t cbTextBufferLength;
         RETURN_IF_FAILED(SizeTMult(buffer.size(), sizeof(wchar_t), &cbTextBufferLength));
 
-        auto Status = DoWriteConsole(const_cast<wchar_t*>(buffer.data()), &cbTextBufferLength, context, waiter);
+        // We're called by the WriteConsole API routines, which acquired the console lock themselves.
+        auto Status = DoWriteConsole(const_cast<wchar_t*>(buffer.data()), &cbTextBufferLength, context, waiter, true);
 
         // Convert back from bytes to characters for the resulting string length written.
         read = cbTextBufferLength / sizeof(wchar_t);
@@ -526,9 +574,20 @@ NT_CATCH_RETURN()
         const auto codepage{ consoleInfo.OutputCP };
         auto leadByteCaptured{ false };
         auto leadByteConsumed{ false };
-        std::wstring wstr{};
         static til::u8state u8State{};
 
+        // The conversion result is only needed for the duration of this call (WriteData makes its own copy),
+        // so we reuse a single buffer across calls instead of allocating a new one each time.
+        // This is safe because we're holding the console lock, just like for u8State above.
+        static std::wstring wstr;
+        const auto trimScratch = wil::scope_exit([&]() noexcept {
+            // Don't hold onto the memory of an unusually large write forever. Same limit as VtIo's output buffer.
+            if (wstr.capacity() > 128 * 1024)
+            {
+                wstr = std::wstring{};
+            }
+        });
+
         // Convert our input parameters to Unicode
         if (codepage == CP_UTF8)
         {
@@ -604,8 +663,23 @@ NT_CATCH_RETURN()
 
             if (mbPtrLength != 0)
             {
-                // convert the remaining bytes in mbPtr to wide chars
-                mbPtrLength = sizeof(wchar_t) * MultiByteToWideChar(codepage, 0, mbPtr, mbPtrLength, wcPtr, mbPtrLength);
+                // Most of the text written by legacy applications is ASCII, which we can widen without asking the OS.
+                // Either way, the result is measured in bytes (because dbcsLength is), hence the sizeof(wchar_t).
+                size_t asciiLength = 0;
+                if (consoleInfo.OutputCPInfo.asciiCompatible)
+                {
+                    asciiLength = til::details::widen_ascii(mbPtr, gsl::narrow_cast<size_t>(mbPtrLength), wcPtr);
+                }
+
+                const auto remaining = mbPtrLength - gsl::narrow_cast<int>(asciiLength);
+                auto converted = 0;
+                if (remaining != 0)
+                {
+                    // convert the remaining bytes in mbPtr to wide chars
+                    converted = MultiByteToWideChar(codepage, 0, mbPtr + asciiLength, remaining, wcPtr + asciiLength, remaining);
+                }
+
+                mbPtrLength = sizeof(wchar_t) * (gsl::narrow_cast<int>(asciiLength) + converted);
             }
 
             wstr.resize((dbcsLength + mbPtrLength) / sizeof(wchar_t));
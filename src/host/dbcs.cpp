@@ -20,8 +20,16 @@ using Microsoft::Console::Interactivity::ServiceLocator;
 // Return Value:
 // - TRUE - Bisected character.
 // - FALSE - Correctly.
-bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf, const CPINFO* const pCPInfo)
+bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf, const ConsoleCPInfo* const pCPInfo)
 {
+    FAIL_FAST_IF_NULL(pCPInfo);
+
+    // Single byte code pages like 437 can't bisect anything.
+    if (!pCPInfo->hasLeadBytes)
+    {
+        return false;
+    }
+
     while (cbBuf)
     {
         if (IsDBCSLeadByteConsole(*pchBuf, pCPInfo))
@@ -53,25 +61,11 @@ bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf,
 // - pCPInfo - the code page to check the char in.
 // Return Value:
 // true if ch is a lead byte, false otherwise.
-bool IsDBCSLeadByteConsole(const CHAR ch, const CPINFO* const pCPInfo)
+bool IsDBCSLeadByteConsole(const CHAR ch, const ConsoleCPInfo* const pCPInfo)
 {
     FAIL_FAST_IF_NULL(pCPInfo);
-    // NOTE: This must be unsigned for the comparison. If we compare signed, this will never hit
-    // because lead bytes are ironically enough always above 0x80 (signed char negative range).
-    const auto uchComparison = (unsigned char)ch;
-
-    auto i = 0;
-    // this is ok because the array is guaranteed to have 2
-    // null bytes at the end.
-    while (pCPInfo->LeadByte[i])
-    {
-        if (pCPInfo->LeadByte[i] <= uchComparison && uchComparison <= pCPInfo->LeadByte[i + 1])
-        {
-            return true;
-        }
-        i += 2;
-    }
-    return false;
+    // The table is built from the LeadByte ranges by SetConsoleCPInfo().
+    return til::at(pCPInfo->leadBytes, static_cast<uint8_t>(ch));
 }
 
 BYTE CodePageToCharSet(const UINT uiCodePage)
@@ -20,9 +20,9 @@ Revision History:
 
 #include "screenInfo.hpp"
 
-bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf, const CPINFO* const pCPInfo);
+bool CheckBisectStringA(_In_reads_bytes_(cbBuf) PCHAR pchBuf, _In_ DWORD cbBuf, const ConsoleCPInfo* const pCPInfo);
 
-bool IsDBCSLeadByteConsole(const CHAR ch, const CPINFO* const pCPInfo);
+bool IsDBCSLeadByteConsole(const CHAR ch, const ConsoleCPInfo* const pCPInfo);
 
 BYTE CodePageToCharSet(const UINT uiCodePage);
 
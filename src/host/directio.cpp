@@ -24,6 +24,7 @@
 
 using namespace Microsoft::Console::Types;
 using Microsoft::Console::Interactivity::ServiceLocator;
+using Microsoft::Console::VirtualTerminal::VtIo;
 
 // Routine Description:
 // - This routine reads or peeks input events.  In both cases, the events
@@ -70,6 +71,9 @@ using Microsoft::Console::Interactivity::ServiceLocator;
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
+        // What the client wrote so far should be visible before it waits for the user.
+        ServiceLocator::LocateGlobals().getConsoleInformation().GetVtIo()->Flush();
+
         const auto Status = inputBuffer.Read(outEvents,
                                              eventReadCount,
                                              IsPeek,
@@ -446,14 +450,42 @@ CATCH_RETURN();
             return E_INVALIDARG;
         }
 
+        const auto& textBuffer = storageBuffer.GetTextBuffer();
+        const auto columnBegin = clippedRectangle.Left();
+        const auto columnEnd = clippedRectangle.RightExclusive();
+
         for (til::CoordType y = clippedRectangle.Top(); y <= clippedRectangle.BottomInclusive(); y++)
         {
-            auto it = storageBuffer.GetCellDataAt({ clippedRectangle.Left(), y });
+            const auto target = targetBuffer.subspan(totalOffset, width);
+            const auto& row = textBuffer.GetRowByOffset(y);
 
-            for (size_t i = 0; i < width; i++)
+            // Most TUI applications only use narrow characters, in which case we can copy the text
+            // straight out of the ROW and convert the attributes once per run instead of once per cell.
+            // This produces the same CHAR_INFOs as AsCharInfo(): Single-width cells have no DBCS flags.
+            if (const auto text = row.GetNarrowText(columnBegin, columnEnd); !text.empty())
+            {
+                for (size_t i = 0; i < width; i++)
+                {
+                    til::at(target, i).Char.UnicodeChar = til::at(text, i);
+                }
+                row.ForEachAttributeRun(columnBegin, columnEnd, [&](const TextAttribute& attr, til::CoordType beg, til::CoordType end) {
+                    const auto legacy = attr.GetLegacyAttributes();
+                    for (auto x = beg; x < end; ++x)
+                    {
+                        til::at(target, gsl::narrow_cast<size_t>(x - columnBegin)).Attributes = legacy;
+                    }
+                    return true;
+                });
+            }
+            else
             {
-                targetBuffer[totalOffset + i] = gci.AsCharInfo(*it);
-                ++it;
+                auto it = storageBuffer.GetCellDataAt({ columnBegin, y });
+
+                for (size_t i = 0; i < width; i++)
+                {
+                    til::at(target, i) = gci.AsCharInfo(*it);
+                    ++it;
+                }
             }
 
             totalOffset += bufferStride;
@@ -502,11 +534,105 @@ CATCH_RETURN();
     CATCH_RETURN();
 }
 
+// Routine Description:
+// - Emits the VT sequences for those parts of `infos` that differ from what `screenInfo` contains at `target`.
+// - Since all output passes through us, the buffer contents match what the terminal is displaying.
+//   Legacy TUI applications tend to repaint their entire screen with WriteConsoleOutput,
+//   even if only a few cells changed, and this avoids sending the unchanged ones again.
+// - This must be called before `infos` is written into the buffer. It's only used for the public
+//   WriteConsoleOutput APIs, as our own callers (FillConsoleOutput, etc.) know what they're changing.
+static void WriteChangedInfos(const VtIo::Writer& writer, const SCREEN_INFORMATION& screenInfo, const til::point target, const std::span<const CHAR_INFO> infos)
+{
+    // A new run costs a CUP and SGR sequence, which is about as much as repeating a few unchanged cells.
+    // Runs that are closer together than this are thus merged.
+    static constexpr size_t mergeDistance = 8;
+
+    // Images get erased by WriteConsoleOutput, but we can't tell which of the cells they covered.
+    if (screenInfo.GetTextBuffer().GetRowByOffset(target.y).GetImageSlice())
+    {
+        writer.WriteInfos(target, infos);
+        return;
+    }
+
+    const auto size = infos.size();
+    auto it = screenInfo.GetCellDataAt(target);
+    size_t runBeg = 0;
+    size_t runEnd = 0;
+    auto hasRun = false;
+
+    // Compares the next cell in the buffer with `ci` the same way OutputCellIterator would store it.
+    const auto unchanged = [&](const CHAR_INFO& ci) {
+        auto dbcsAttr = DbcsAttribute::Single;
+        if (WI_IsFlagSet(ci.Attributes, COMMON_LVB_LEADING_BYTE))
+        {
+            dbcsAttr = DbcsAttribute::Leading;
+        }
+        else if (WI_IsFlagSet(ci.Attributes, COMMON_LVB_TRAILING_BYTE))
+        {
+            dbcsAttr = DbcsAttribute::Trailing;
+        }
+
+        const auto& cell = *it;
+        const auto result = cell.DbcsAttr() == dbcsAttr &&
+                            cell.Chars() == std::wstring_view{ &ci.Char.UnicodeChar, 1 } &&
+                            cell.TextAttr() == TextAttribute{ ci.Attributes };
+        ++it;
+        return result;
+    };
+
+    const auto flush = [&]() {
+        const til::point runTarget{ target.x + gsl::narrow_cast<til::CoordType>(runBeg), target.y };
+        writer.WriteInfos(runTarget, infos.subspan(runBeg, runEnd - runBeg));
+    };
+
+    for (size_t i = 0; i < size;)
+    {
+        const auto& ci = til::at(infos, i);
+        size_t count = 1;
+        auto same = unchanged(ci);
+
+        if (WI_IsFlagSet(ci.Attributes, COMMON_LVB_LEADING_BYTE) && i + 1 < size)
+        {
+            // Both halves of a wide glyph need to be emitted together.
+            same = unchanged(til::at(infos, i + 1)) && same;
+            count = 2;
+        }
+        else if (WI_IsAnyFlagSet(ci.Attributes, COMMON_LVB_LEADING_BYTE | COMMON_LVB_TRAILING_BYTE))
+        {
+            // A lone half at the edge of the rectangle is turned into a whitespace by WriteInfos.
+            same = false;
+        }
+
+        if (!same)
+        {
+            if (hasRun && i - runEnd >= mergeDistance)
+            {
+                flush();
+                hasRun = false;
+            }
+            if (!hasRun)
+            {
+                runBeg = i;
+                hasRun = true;
+            }
+            runEnd = i + count;
+        }
+
+        i += count;
+    }
+
+    if (hasRun)
+    {
+        flush();
+    }
+}
+
 [[nodiscard]] HRESULT WriteConsoleOutputWImplHelper(SCREEN_INFORMATION& context,
                                                     std::span<const CHAR_INFO> buffer,
                                                     til::CoordType bufferStride,
                                                     const Viewport& requestRectangle,
-                                                    Viewport& writtenRectangle) noexcept
+                                                    Viewport& writtenRectangle,
+                                                    const bool onlyEmitChanges) noexcept
 {
     try
     {
@@ -547,12 +673,23 @@ CATCH_RETURN();
             const auto charInfos = buffer.subspan(totalOffset, width);
             const til::point target{ clippedRectangle.Left(), y };
 
-            // Make the iterator and write to the target position.
-            storageBuffer.Write(OutputCellIterator(charInfos), target);
-
             if (writer)
             {
-                writer.WriteInfos(target, charInfos);
+                if (onlyEmitChanges)
+                {
+                    WriteChangedInfos(writer, storageBuffer, target, charInfos);
+                }
+                else
+                {
+                    writer.WriteInfos(target, charInfos);
+                }
+            }
+
+            // Rows without wide glyphs are written directly into the ROW. Otherwise, make the
+            // iterator and write to the target position, which handles DBCS leading/trailing bytes.
+            if (!storageBuffer.GetTextBuffer().TryWriteCharInfos(target, charInfos))
+            {
+                storageBuffer.Write(OutputCellIterator(charInfos), target);
             }
 
             totalOffset += bufferStride;
@@ -595,7 +732,7 @@ CATCH_RETURN();
         const auto codepage = gci.OutputCP;
         LOG_IF_FAILED(_ConvertCellsToWInplace(codepage, buffer, requestRectangle));
 
-        RETURN_IF_FAILED(WriteConsoleOutputWImplHelper(context, buffer, requestRectangle.Width(), requestRectangle, writtenRectangle));
+        RETURN_IF_FAILED(WriteConsoleOutputWImplHelper(context, buffer, requestRectangle.Width(), requestRectangle, writtenRectangle, true));
 
         if (writer)
         {
@@ -625,7 +762,7 @@ CATCH_RETURN();
             writer.BackupCursor();
         }
 
-        RETURN_IF_FAILED(WriteConsoleOutputWImplHelper(context, buffer, requestRectangle.Width(), requestRectangle, writtenRectangle));
+        RETURN_IF_FAILED(WriteConsoleOutputWImplHelper(context, buffer, requestRectangle.Width(), requestRectangle, writtenRectangle, true));
 
         if (writer)
         {
@@ -649,9 +786,7 @@ CATCH_RETURN();
 
     try
     {
-        const auto attrs = ReadOutputAttributes(context.GetActiveBuffer(), origin, buffer.size());
-        std::copy(attrs.cbegin(), attrs.cend(), buffer.begin());
-        written = attrs.size();
+        written = ReadOutputAttributes(context.GetActiveBuffer(), origin, buffer);
 
         return S_OK;
     }
@@ -699,16 +834,8 @@ CATCH_RETURN();
 
     try
     {
-        const auto chars = ReadOutputStringW(context.GetActiveBuffer(),
-                                             origin,
-                                             buffer.size());
-
-        // Only copy if the whole result will fit.
-        if (chars.size() <= buffer.size())
-        {
-            std::copy(chars.cbegin(), chars.cend(), buffer.begin());
-            written = chars.size();
-        }
+        // Each cell produces at most 1 character, so this always fits and can be written directly into the reply.
+        written = ReadOutputStringW(context.GetActiveBuffer(), origin, buffer);
 
         return S_OK;
     }
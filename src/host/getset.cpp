@@ -79,13 +79,16 @@ void ApiRoutines::GetConsoleOutputModeImpl(SCREEN_INFORMATION& context, ULONG& m
 // - event - The count of events in the queue
 // Return Value:
 //  - S_OK or math failure.
-[[nodiscard]] HRESULT ApiRoutines::GetNumberOfConsoleInputEventsImpl(const InputBuffer& context, ULONG& events) noexcept
+[[nodiscard]] HRESULT ApiRoutines::GetNumberOfConsoleInputEventsImpl(InputBuffer& context, ULONG& events) noexcept
 {
     try
     {
         LockConsole();
         auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
 
+        // Clients poll this while waiting for input, so we flush for the same reason as ReadConsole.
+        ServiceLocator::LocateGlobals().getConsoleInformation().GetVtIo()->Flush();
+
         const auto readyEventCount = context.GetNumberOfReadyEvents();
         RETURN_IF_FAILED(SizeTToULong(readyEventCount, &events));
 
@@ -129,7 +129,7 @@ void CommandHistory::_Reset()
             // add newCommand to array
             if (!reuse.empty())
             {
-                _commands.emplace_back(reuse);
+                _commands.emplace_back(std::move(reuse));
             }
             else
             {
@@ -412,7 +412,7 @@ std::wstring CommandHistory::Remove(const Index iDel)
         return {};
     }
 
-    const auto str = std::move(_commands.at(iDel));
+    auto str = std::move(_commands.at(iDel));
     _commands.erase(_commands.begin() + iDel);
 
     if (LastDisplayed == iDel)
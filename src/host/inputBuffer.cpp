@@ -9,14 +9,177 @@
 
 #include "misc.h"
 #include "stream.h"
+#include "../interactivity/inc/EventSynthesis.hpp"
 #include "../interactivity/inc/ServiceLocator.hpp"
 
 #define INPUT_BUFFER_DEFAULT_INPUT_MODE (ENABLE_LINE_INPUT | ENABLE_PROCESSED_INPUT | ENABLE_ECHO_INPUT | ENABLE_MOUSE_INPUT)
 
+using Microsoft::Console::Interactivity::CharToKeyEvents;
 using Microsoft::Console::Interactivity::ServiceLocator;
 using Microsoft::Console::VirtualTerminal::TerminalInput;
 using namespace Microsoft::Console;
 
+bool InputRecordQueue::empty() const noexcept
+{
+    return _head == _buffer.size();
+}
+
+size_t InputRecordQueue::size() const noexcept
+{
+    return _buffer.size() - _head;
+}
+
+InputRecordQueue::iterator InputRecordQueue::begin() noexcept
+{
+    return _buffer.begin() + _head;
+}
+
+InputRecordQueue::const_iterator InputRecordQueue::begin() const noexcept
+{
+    return _buffer.begin() + _head;
+}
+
+InputRecordQueue::iterator InputRecordQueue::end() noexcept
+{
+    return _buffer.end();
+}
+
+InputRecordQueue::const_iterator InputRecordQueue::end() const noexcept
+{
+    return _buffer.end();
+}
+
+INPUT_RECORD& InputRecordQueue::front() noexcept
+{
+    return til::at(_buffer, _head);
+}
+
+const INPUT_RECORD& InputRecordQueue::front() const noexcept
+{
+    return til::at(_buffer, _head);
+}
+
+INPUT_RECORD& InputRecordQueue::back() noexcept
+{
+    return _buffer.back();
+}
+
+const INPUT_RECORD& InputRecordQueue::back() const noexcept
+{
+    return _buffer.back();
+}
+
+INPUT_RECORD& InputRecordQueue::operator[](size_t offset) noexcept
+{
+    return til::at(_buffer, _head + offset);
+}
+
+const INPUT_RECORD& InputRecordQueue::operator[](size_t offset) const noexcept
+{
+    return til::at(_buffer, _head + offset);
+}
+
+void InputRecordQueue::clear() noexcept
+{
+    _buffer.clear();
+    _head = 0;
+}
+
+void InputRecordQueue::swap(InputRecordQueue& other) noexcept
+{
+    _buffer.swap(other._buffer);
+    std::swap(_head, other._head);
+}
+
+// Ensures that `count` more records can be appended without reallocating.
+void InputRecordQueue::reserve_additional(size_t count)
+{
+    if (_buffer.size() + count <= _buffer.capacity())
+    {
+        return;
+    }
+
+    _reclaim();
+
+    const auto needed = _buffer.size() + count;
+    const auto capacity = _buffer.capacity();
+    if (needed > capacity)
+    {
+        // Grow geometrically, just like push_back() would.
+        _buffer.reserve(std::max(needed, capacity + capacity / 2));
+    }
+}
+
+void InputRecordQueue::push_back(const INPUT_RECORD& record)
+{
+    if (_buffer.size() == _buffer.capacity())
+    {
+        _reclaim();
+    }
+    _buffer.push_back(record);
+}
+
+void InputRecordQueue::append(std::span<const INPUT_RECORD> records)
+{
+    reserve_additional(records.size());
+    _buffer.insert(_buffer.end(), records.begin(), records.end());
+}
+
+// Replaces the first `count` records with `records`. This reuses the space of
+// already consumed records if possible, which makes it cheap to call repeatedly.
+void InputRecordQueue::replace_front(size_t count, std::span<const INPUT_RECORD> records)
+{
+    assert(count <= size());
+    auto available = _head + count;
+
+    if (records.size() > available)
+    {
+        const auto missing = records.size() - available;
+        _buffer.insert(_buffer.begin() + available, missing, INPUT_RECORD{});
+        available += missing;
+    }
+
+    _head = available - records.size();
+    std::copy(records.begin(), records.end(), _buffer.begin() + _head);
+}
+
+void InputRecordQueue::erase(const_iterator first, const_iterator last)
+{
+    _buffer.erase(first, last);
+    if (empty())
+    {
+        clear();
+    }
+}
+
+// Removes the first `count` records from the queue.
+void InputRecordQueue::consume(size_t count) noexcept
+{
+    assert(count <= size());
+    _head += count;
+
+    if (_head == _buffer.size())
+    {
+        // Release the memory of large pastes eagerly, but keep
+        // the allocation around for regular typing.
+        if (_buffer.capacity() > 4096)
+        {
+            _buffer = std::vector<INPUT_RECORD>{};
+        }
+        clear();
+    }
+}
+
+// Moves the unconsumed records to the front of the buffer, which makes room at its end.
+void InputRecordQueue::_reclaim()
+{
+    if (_head != 0)
+    {
+        _buffer.erase(_buffer.begin(), begin());
+        _head = 0;
+    }
+}
+
 // Routine Description:
 // - This method creates an input buffer.
 // Arguments:
@@ -60,7 +223,21 @@ void InputBuffer::Consume(bool isUnicode, std::wstring_view& source, std::span<c
         // If we're here, `_cachedTextReaderA` should be empty.
         assert(_cachedTextReaderA.empty());
 
-        const auto cp = ServiceLocator::LocateGlobals().getConsoleInformation().CP;
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto cp = gci.CP;
+
+        // Fastest path: Most input is ASCII, which we can narrow without asking the OS.
+        if (gci.CPInfo.asciiCompatible)
+        {
+            const auto length = til::details::narrow_ascii(source.data(), std::min(source.size(), target.size()), target.data());
+            source = source.substr(length);
+            til::bytes_advance(target, length);
+
+            if (source.empty() || target.empty())
+            {
+                return;
+            }
+        }
 
         // Fast path: Batch convert all data in case the user provided buffer is large enough.
         {
@@ -167,16 +344,11 @@ size_t InputBuffer::ConsumeCached(bool isUnicode, size_t count, InputEventQueue&
 {
     _switchReadingMode(isUnicode ? ReadingMode::InputEventsW : ReadingMode::InputEventsA);
 
-    size_t i = 0;
-
-    while (i < count && !_cachedInputEvents.empty())
-    {
-        target.push_back(std::move(_cachedInputEvents.front()));
-        _cachedInputEvents.pop_front();
-        i++;
-    }
-
-    return i;
+    const auto n = std::min(count, _cachedInputEvents.size());
+    const auto beg = _cachedInputEvents.begin();
+    target.insert(target.end(), beg, beg + n);
+    _cachedInputEvents.consume(n);
+    return n;
 }
 
 // Copies up to `count`, previously cached events into `target`.
@@ -184,20 +356,10 @@ size_t InputBuffer::PeekCached(bool isUnicode, size_t count, InputEventQueue& ta
 {
     _switchReadingMode(isUnicode ? ReadingMode::InputEventsW : ReadingMode::InputEventsA);
 
-    size_t i = 0;
-
-    for (const auto& e : _cachedInputEvents)
-    {
-        if (i >= count)
-        {
-            break;
-        }
-
-        target.push_back(e);
-        i++;
-    }
-
-    return i;
+    const auto n = std::min(count, _cachedInputEvents.size());
+    const auto beg = _cachedInputEvents.begin();
+    target.insert(target.end(), beg, beg + n);
+    return n;
 }
 
 // Trims `source` to have a size below or equal to `expectedSourceSize` by
@@ -208,10 +370,7 @@ void InputBuffer::Cache(bool isUnicode, InputEventQueue& source, size_t expected
 
     if (source.size() > expectedSourceSize)
     {
-        _cachedInputEvents.insert(
-            _cachedInputEvents.end(),
-            std::make_move_iterator(source.begin() + expectedSourceSize),
-            std::make_move_iterator(source.end()));
+        _cachedInputEvents.append(std::span{ source }.subspan(expectedSourceSize));
         source.resize(expectedSourceSize);
     }
 }
@@ -232,7 +391,7 @@ void InputBuffer::_switchReadingModeSlowPath(ReadingMode mode)
     _cachedTextW = std::wstring{};
     _cachedTextReaderW = {};
 
-    _cachedInputEvents = std::deque<INPUT_RECORD>{};
+    _cachedInputEvents = InputRecordQueue{};
 
     _readingMode = mode;
 }
@@ -285,6 +444,7 @@ void InputBuffer::ReinitializeInputBuffer()
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
     InputMode = INPUT_BUFFER_DEFAULT_INPUT_MODE;
     _storage.clear();
+    _clearKeyText();
 }
 
 // Routine Description:
@@ -317,8 +477,10 @@ void InputBuffer::TerminateRead(_In_ WaitTerminationReason Flag)
 // - The number of events currently in the input buffer.
 // Note:
 // - The console lock must be held when calling this routine.
-size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
+// - Any text written by WriteKeyText() needs to be turned into key events to be counted.
+size_t InputBuffer::GetNumberOfReadyEvents()
 {
+    _expandKeyText(SIZE_MAX);
     return _storage.size();
 }
 
@@ -333,6 +495,7 @@ size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
 void InputBuffer::Flush()
 {
     _storage.clear();
+    _clearKeyText();
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
 }
 
@@ -346,6 +509,8 @@ void InputBuffer::Flush()
 // - The console lock must be held when calling this routine.
 void InputBuffer::FlushAllButKeys()
 {
+    _expandKeyText(SIZE_MAX);
+
     auto newEnd = std::remove_if(_storage.begin(), _storage.end(), [](const INPUT_RECORD& event) {
         return event.EventType != KEY_EVENT;
     });
@@ -390,9 +555,23 @@ try
         ConsumeCached(Unicode, AmountToRead, OutEvents);
     }
 
+    // Every record in _storage results in at least one event in OutEvents,
+    // so we only need key events for the text within the first `window` records.
+    const auto window = AmountToRead - std::min(AmountToRead, OutEvents.size());
+    _expandKeyText(window);
+
     auto it = _storage.begin();
     const auto end = _storage.end();
 
+    // Unicode, non-stream reads return the records verbatim, which allows us to copy them in bulk.
+    // This matters for large pastes, which consist of hundreds of thousands of key events.
+    if (Unicode && !Stream)
+    {
+        const auto n = std::min(window, _storage.size());
+        OutEvents.insert(OutEvents.end(), it, it + n);
+        it += n;
+    }
+
     while (it != end && OutEvents.size() < AmountToRead)
     {
         if (it->EventType == KEY_EVENT)
@@ -454,7 +633,9 @@ try
 
     if (!Peek)
     {
-        _storage.erase(_storage.begin(), it);
+        const auto consumed = gsl::narrow_cast<size_t>(it - _storage.begin());
+        _storage.consume(consumed);
+        _recordsConsumed += consumed;
     }
 
     Cache(Unicode, OutEvents, AmountToRead);
@@ -463,7 +644,7 @@ try
     {
         return WaitForData ? CONSOLE_STATUS_WAIT : STATUS_SUCCESS;
     }
-    if (_storage.empty())
+    if (_isEmpty())
     {
         ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
     }
@@ -495,12 +676,15 @@ size_t InputBuffer::Prepend(const std::span<const INPUT_RECORD>& inEvents)
         _vtInputShouldSuppress = true;
         auto resetVtInputSuppress = wil::scope_exit([&]() { _vtInputShouldSuppress = false; });
 
+        // The text is located relative to the existing records, which are about to be moved.
+        _expandKeyText(SIZE_MAX);
+
         // read all of the records out of the buffer, then write the
         // prepend ones, then write the original set. We need to do it
         // this way to handle any coalescing that might occur.
 
         // get all of the existing records, "emptying" the buffer
-        std::deque<INPUT_RECORD> existingStorage;
+        InputRecordQueue existingStorage;
         existingStorage.swap(_storage);
 
         // We will need this variable to pass to _WriteBuffer so it can attempt to determine wait status.
@@ -514,10 +698,7 @@ size_t InputBuffer::Prepend(const std::span<const INPUT_RECORD>& inEvents)
         _WriteBuffer(inEvents, prependEventsWritten, unusedWaitStatus);
         FAIL_FAST_IF(!(unusedWaitStatus));
 
-        for (const auto& event : existingStorage)
-        {
-            _storage.push_back(event);
-        }
+        _storage.append({ existingStorage.begin(), existingStorage.end() });
 
         // We need to set the wait event if there were 0 events in the
         // input queue when we started.
@@ -620,6 +801,104 @@ try
 }
 CATCH_LOG()
 
+// Routine Description:
+// - Writes text that stands for key presses, like text pasted into the terminal.
+// - Unless VT input mode or a suspended console need the key events right away, the text is stored as-is.
+//   Character reads consume it directly via ConsumeKeyTextChar() and the 2 or more INPUT_RECORDs
+//   per character are only synthesized once a client asks for them (for instance via ReadConsoleInput).
+// Arguments:
+// - text - The text to write.
+// - codepage - The codepage to synthesize the key events with.
+// Note:
+// - The console lock must be held when calling this routine.
+void InputBuffer::WriteKeyText(const std::wstring_view& text, const UINT codepage)
+try
+{
+    if (text.empty())
+    {
+        return;
+    }
+
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    // Control characters may be pause keys or may be filtered out by GetChar(),
+    // so we only store text that's guaranteed to be read back verbatim.
+    const auto needsKeyEvents = IsInVirtualTerminalInputMode() ||
+                                WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) ||
+                                std::any_of(text.begin(), text.end(), [](const wchar_t wch) { return wch < L' '; });
+
+    if (needsKeyEvents)
+    {
+        InputEventQueue keyEvents;
+        for (const auto& wch : text)
+        {
+            CharToKeyEvents(wch, codepage, keyEvents);
+        }
+        Write(keyEvents);
+        return;
+    }
+
+    const auto wasEmpty = _isEmpty();
+    const auto position = _recordsConsumed + _storage.size();
+
+    if (_endsWithKeyText() && _keyTextRuns.back().codepage == codepage)
+    {
+        _keyTextRuns.back().length += text.size();
+    }
+    else
+    {
+        _keyTextRuns.push_back({ position, text.size(), codepage });
+    }
+    _keyText.append(text);
+
+    if (wasEmpty)
+    {
+        ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
+    }
+
+    WakeUpReadersWaitingForData();
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Consumes the next character of the text written by WriteKeyText(),
+//   as long as no other input precedes it.
+// Arguments:
+// - wch - On success, receives the character.
+// Return Value:
+// - true if a character was consumed.
+// Note:
+// - The console lock must be held when calling this routine.
+bool InputBuffer::ConsumeKeyTextChar(wchar_t& wch)
+{
+    // Read() would discard any cached strings the same way.
+    _switchReadingMode(ReadingMode::InputEventsW);
+
+    if (_keyTextRuns.empty() || !_cachedInputEvents.empty() || _keyTextRuns.front().position != _recordsConsumed)
+    {
+        return false;
+    }
+
+    auto& run = _keyTextRuns.front();
+    wch = til::at(_keyText, _keyTextOffset);
+    _keyTextOffset++;
+    run.length--;
+
+    if (run.length == 0)
+    {
+        _keyTextRuns.pop_front();
+        if (_keyTextRuns.empty())
+        {
+            _clearKeyText();
+        }
+    }
+
+    if (_isEmpty())
+    {
+        ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
+    }
+    return true;
+}
+
 // This can be considered a "privileged" variant of Write() which allows FOCUS_EVENTs to generate focus VT sequences.
 // If we didn't do this, someone could write a FOCUS_EVENT_RECORD with WriteConsoleInput, exit without flushing the
 // input buffer and the next application will suddenly get a "\x1b[I" sequence in their input. See GH#13238.
@@ -712,19 +991,35 @@ void InputBuffer::_WriteBuffer(const std::span<const INPUT_RECORD>& inEvents, _O
     const auto initialInEventsSize = inEvents.size();
     const auto vtInputMode = IsInVirtualTerminalInputMode();
 
-    for (const auto& inEvent : inEvents)
+    // Events that are stored as-is are collected into runs, which are then appended in bulk.
+    // runBeg is the index of the first event of the current run.
+    size_t runBeg = 0;
+    const auto flushRun = [&](size_t runEnd) {
+        if (runEnd > runBeg)
+        {
+            _storage.append(inEvents.subspan(runBeg, runEnd - runBeg));
+            eventsWritten += runEnd - runBeg;
+        }
+        runBeg = runEnd + 1;
+    };
+
+    for (size_t i = 0; i < initialInEventsSize; ++i)
     {
+        const auto& inEvent = til::at(inEvents, i);
+
         if (inEvent.EventType == KEY_EVENT && inEvent.Event.KeyEvent.bKeyDown)
         {
             // if output is suspended, any keyboard input releases it.
             if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) && !IsSystemKey(inEvent.Event.KeyEvent.wVirtualKeyCode))
             {
+                flushRun(i);
                 UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
                 continue;
             }
             // intercept control-s
             if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && IsPauseKey(inEvent.Event.KeyEvent))
             {
+                flushRun(i);
                 WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
                 continue;
             }
@@ -739,6 +1034,7 @@ void InputBuffer::_WriteBuffer(const std::span<const INPUT_RECORD>& inEvents, _O
             // GH#11682: TerminalInput::HandleKey can handle both KeyEvents and Focus events seamlessly
             if (const auto out = _termInput.HandleKey(inEvent))
             {
+                flushRun(i);
                 _HandleTerminalInputCallback(*out);
                 eventsWritten++;
                 continue;
@@ -749,16 +1045,17 @@ void InputBuffer::_WriteBuffer(const std::span<const INPUT_RECORD>& inEvents, _O
         // record at a time because this is the original behavior of
         // the input buffer. Changing this behavior may break stuff
         // that was depending on it.
-        if (initialInEventsSize == 1 && !_storage.empty() && _CoalesceEvent(inEvents[0]))
+        if (initialInEventsSize == 1 && !_storage.empty() && !_endsWithKeyText() && _CoalesceEvent(inEvents[0]))
         {
             eventsWritten++;
             return;
         }
 
         // At this point, the event was neither coalesced, nor processed by VT.
-        _storage.push_back(inEvent);
-        ++eventsWritten;
+        // It'll be stored as part of the current run.
     }
+    flushRun(initialInEventsSize);
+
     if (initiallyEmptyQueue && !_storage.empty())
     {
         setWaitEvent = true;
@@ -815,6 +1112,90 @@ bool InputBuffer::_CoalesceEvent(const INPUT_RECORD& inEvent) noexcept
     return false;
 }
 
+bool InputBuffer::_isEmpty() const noexcept
+{
+    return _storage.empty() && _keyTextRuns.empty();
+}
+
+// Returns true if the last input in the buffer is text written by WriteKeyText().
+bool InputBuffer::_endsWithKeyText() const noexcept
+{
+    return !_keyTextRuns.empty() && _keyTextRuns.back().position == _recordsConsumed + _storage.size();
+}
+
+// Routine Description:
+// - Turns the text written by WriteKeyText() into key events, if it's located within the first `window` records.
+// - Text is expanded in chunks of at least 1024 characters. That way the space of the records consumed
+//   in the meantime can be reused by the next expansion, even if clients read one record at a time.
+// Arguments:
+// - window - The number of records that need to be available as INPUT_RECORDs.
+// Note:
+// - The console lock must be held when calling this routine.
+void InputBuffer::_expandKeyText(const size_t window)
+{
+    static constexpr size_t minimumChunk = 1024;
+
+    if (_keyTextRuns.empty() || _keyTextRuns.front().position - _recordsConsumed >= window)
+    {
+        return;
+    }
+
+    // The new records in front of the first `copied` existing ones.
+    InputEventQueue prefix;
+    size_t copied = 0;
+    size_t inserted = 0;
+
+    while (!_keyTextRuns.empty())
+    {
+        auto& run = _keyTextRuns.front();
+        const auto index = gsl::narrow_cast<size_t>(run.position - _recordsConsumed);
+        if (index + inserted >= window)
+        {
+            break;
+        }
+
+        const auto beg = _storage.begin();
+        prefix.insert(prefix.end(), beg + copied, beg + index);
+        copied = index;
+
+        // Each character results in at least 1 record, so this will fill the window.
+        const auto count = std::min(run.length, std::max(window - index - inserted, minimumChunk));
+        const auto sizeBefore = prefix.size();
+        for (const auto& wch : std::wstring_view{ _keyText }.substr(_keyTextOffset, count))
+        {
+            CharToKeyEvents(wch, run.codepage, prefix);
+        }
+        inserted += prefix.size() - sizeBefore;
+
+        _keyTextOffset += count;
+        run.length -= count;
+
+        if (run.length != 0)
+        {
+            break;
+        }
+        _keyTextRuns.pop_front();
+    }
+
+    _storage.replace_front(copied, prefix);
+
+    for (auto& run : _keyTextRuns)
+    {
+        run.position += inserted;
+    }
+    if (_keyTextRuns.empty())
+    {
+        _clearKeyText();
+    }
+}
+
+void InputBuffer::_clearKeyText() noexcept
+{
+    _keyText.clear();
+    _keyTextOffset = 0;
+    _keyTextRuns.clear();
+}
+
 // Routine Description:
 // - Returns true if this input buffer is in VT Input mode.
 // Arguments:
@@ -858,6 +1239,8 @@ void InputBuffer::_HandleTerminalInputCallback(const TerminalInput::StringType&
 
 void InputBuffer::_writeString(const std::wstring_view& text)
 {
+    _storage.reserve_additional(text.size());
+
     for (const auto& wch : text)
     {
         if (wch == UNICODE_NULL)
@@ -17,6 +17,48 @@ namespace Microsoft::Console::Render
     class Renderer;
 }
 
+// A FIFO of INPUT_RECORDs in contiguous memory, optimized for bulk operations.
+// Consuming records only advances the read offset, and the consumed prefix is
+// reclaimed once appending would otherwise require a reallocation. This way
+// large pastes don't allocate for every single record (as std::deque does with
+// MSVC's tiny block size) and records can be appended and consumed with memcpy.
+class InputRecordQueue
+{
+public:
+    using iterator = std::vector<INPUT_RECORD>::iterator;
+    using const_iterator = std::vector<INPUT_RECORD>::const_iterator;
+
+    bool empty() const noexcept;
+    size_t size() const noexcept;
+
+    iterator begin() noexcept;
+    const_iterator begin() const noexcept;
+    iterator end() noexcept;
+    const_iterator end() const noexcept;
+
+    INPUT_RECORD& front() noexcept;
+    const INPUT_RECORD& front() const noexcept;
+    INPUT_RECORD& back() noexcept;
+    const INPUT_RECORD& back() const noexcept;
+    INPUT_RECORD& operator[](size_t offset) noexcept;
+    const INPUT_RECORD& operator[](size_t offset) const noexcept;
+
+    void clear() noexcept;
+    void swap(InputRecordQueue& other) noexcept;
+    void reserve_additional(size_t count);
+    void push_back(const INPUT_RECORD& record);
+    void append(std::span<const INPUT_RECORD> records);
+    void replace_front(size_t count, std::span<const INPUT_RECORD> records);
+    void erase(const_iterator first, const_iterator last);
+    void consume(size_t count) noexcept;
+
+private:
+    void _reclaim();
+
+    std::vector<INPUT_RECORD> _buffer;
+    size_t _head = 0;
+};
+
 class InputBuffer final : public ConsoleObjectHeader
 {
 public:
@@ -42,7 +84,7 @@ public:
     void ReinitializeInputBuffer();
     void WakeUpReadersWaitingForData();
     void TerminateRead(_In_ WaitTerminationReason Flag);
-    size_t GetNumberOfReadyEvents() const noexcept;
+    size_t GetNumberOfReadyEvents();
     void Flush();
     void FlushAllButKeys();
 
@@ -57,6 +99,8 @@ public:
     size_t Write(const INPUT_RECORD& inEvent);
     size_t Write(const std::span<const INPUT_RECORD>& inEvents);
     void WriteString(const std::wstring_view& text);
+    void WriteKeyText(const std::wstring_view& text, UINT codepage);
+    bool ConsumeKeyTextChar(wchar_t& wch);
     void WriteFocusEvent(bool focused) noexcept;
     bool WriteMouseEvent(til::point position, unsigned int button, short keyState, short wheelDelta);
 
@@ -76,10 +120,24 @@ private:
     std::string_view _cachedTextReaderA;
     std::wstring _cachedTextW;
     std::wstring_view _cachedTextReaderW;
-    std::deque<INPUT_RECORD> _cachedInputEvents;
+    InputRecordQueue _cachedInputEvents;
     ReadingMode _readingMode = ReadingMode::StringA;
 
-    std::deque<INPUT_RECORD> _storage;
+    // Text written by WriteKeyText() that hasn't been turned into key events yet.
+    // Each run is located in front of the record with the absolute index `position`,
+    // where the absolute index of _storage.front() is _recordsConsumed.
+    struct KeyTextRun
+    {
+        uint64_t position = 0;
+        size_t length = 0;
+        UINT codepage = 0;
+    };
+
+    InputRecordQueue _storage;
+    uint64_t _recordsConsumed = 0;
+    std::wstring _keyText;
+    size_t _keyTextOffset = 0;
+    std::deque<KeyTextRun> _keyTextRuns;
     INPUT_RECORD _writePartialByteSequence{};
     bool _writePartialByteSequenceAvailable = false;
     Microsoft::Console::VirtualTerminal::TerminalInput _termInput;
@@ -94,6 +152,10 @@ private:
     void _switchReadingModeSlowPath(ReadingMode mode);
     void _WriteBuffer(const std::span<const INPUT_RECORD>& inRecords, _Out_ size_t& eventsWritten, _Out_ bool& setWaitEvent);
     bool _CoalesceEvent(const INPUT_RECORD& inEvent) noexcept;
+    bool _isEmpty() const noexcept;
+    bool _endsWithKeyText() const noexcept;
+    void _expandKeyText(size_t window);
+    void _clearKeyText() noexcept;
     void _HandleTerminalInputCallback(const Microsoft::Console::VirtualTerminal::TerminalInput::StringType& text);
     void _writeString(const std::wstring_view& text);
 
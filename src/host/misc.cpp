@@ -23,28 +23,92 @@ WCHAR CharToWchar(_In_reads_(cch) const char* const pch, const UINT cch)
 
     FAIL_FAST_IF(!(IsDBCSLeadByteConsole(*pch, &gci.OutputCPInfo) || cch == 1));
 
+    // Printable ASCII is the same in all the code pages we'd care about. The C0 controls and DEL
+    // aren't, because MB_USEGLYPHCHARS translates them into glyphs like U+263A in code page 437.
+    if (cch == 1 && gci.OutputCPInfo.asciiCompatible && *pch >= 0x20 && *pch < 0x7f)
+    {
+        return static_cast<wchar_t>(*pch);
+    }
+
     ConvertOutputToUnicode(gci.OutputCP, pch, cch, &wc, 1);
 
     return wc;
 }
 
-void SetConsoleCPInfo(const BOOL fOutput)
+// Routine Description:
+// - Retrieves the CPINFO for the given code page and builds the lookup tables in ConsoleCPInfo from it.
+static void s_InitializeCPInfo(const UINT codePage, ConsoleCPInfo& info) noexcept
 {
-    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
-    if (fOutput)
+    info = {};
+
+    if (!GetCPInfo(codePage, &info))
+    {
+        info.LeadByte[0] = 0;
+    }
+
+    // The array is guaranteed to end with 2 null bytes.
+    for (size_t i = 0; i + 1 < std::size(info.LeadByte) && info.LeadByte[i]; i += 2)
     {
-        if (!GetCPInfo(gci.OutputCP, &gci.OutputCPInfo))
+        for (auto b = gsl::narrow_cast<size_t>(info.LeadByte[i]); b <= info.LeadByte[i + 1]; ++b)
         {
-            gci.OutputCPInfo.LeadByte[0] = 0;
+            til::at(info.leadBytes, b) = true;
+            info.hasLeadBytes = true;
         }
     }
-    else
+
+    // UTF-8 is known to be ASCII compatible, and its conversions are handled separately anyway.
+    if (codePage == CP_UTF8)
+    {
+        info.asciiCompatible = true;
+        return;
+    }
+
+    char narrow[128];
+    wchar_t wide[128];
+    for (int i = 0; i < 128; ++i)
+    {
+        til::at(narrow, i) = gsl::narrow_cast<char>(i);
+    }
+
+    if (MultiByteToWideChar(codePage, 0, &narrow[0], 128, &wide[0], 128) != 128)
+    {
+        return;
+    }
+    for (int i = 0; i < 128; ++i)
+    {
+        if (til::at(wide, i) != i)
+        {
+            return;
+        }
+    }
+
+    // The conversion back must round-trip as well, for the ReadConsoleA side of things.
+    if (WideCharToMultiByte(codePage, 0, &wide[0], 128, &narrow[0], 128, nullptr, nullptr) != 128)
+    {
+        return;
+    }
+    for (int i = 0; i < 128; ++i)
     {
-        if (!GetCPInfo(gci.CP, &gci.CPInfo))
+        if (til::at(narrow, i) != i)
         {
-            gci.CPInfo.LeadByte[0] = 0;
+            return;
         }
     }
+
+    info.asciiCompatible = true;
+}
+
+void SetConsoleCPInfo(const BOOL fOutput)
+{
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    if (fOutput)
+    {
+        s_InitializeCPInfo(gci.OutputCP, gci.OutputCPInfo);
+    }
+    else
+    {
+        s_InitializeCPInfo(gci.CP, gci.CPInfo);
+    }
 }
 
 // Routine Description:
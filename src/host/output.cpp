@@ -121,126 +121,143 @@ static void _CopyRectangle(SCREEN_INFORMATION& screenInfo,
     }
 }
 
+// Calls func(row, columnBegin, columnEnd, offset) for each row segment covered by `count` cells,
+// starting at `origin` and continuing at the start of the following rows, the same way
+// TextBufferCellIterator walks the buffer. `offset` is the number of cells preceding the segment.
+template<typename Func>
+static void forEachRowSegment(const SCREEN_INFORMATION& screenInfo, const til::point origin, const size_t count, Func&& func)
+{
+    const auto& textBuffer = screenInfo.GetTextBuffer();
+    const auto size = screenInfo.GetBufferSize();
+    const auto width = size.Width();
+    size_t offset = 0;
+    auto x = origin.x;
+
+    for (auto y = origin.y; y < size.Height() && offset < count; ++y)
+    {
+        const auto end = x + gsl::narrow_cast<til::CoordType>(std::min<size_t>(count - offset, gsl::narrow_cast<size_t>(width - x)));
+        func(textBuffer.GetRowByOffset(y), x, end, offset);
+        offset += gsl::narrow_cast<size_t>(end - x);
+        x = 0;
+    }
+}
+
 // Routine Description:
 // - This routine reads a sequence of attributes from the screen buffer.
+// - The attributes are converted once per run of identical attributes and only
+//   rows containing wide glyphs are looked at cell by cell to add the DBCS flags.
 // Arguments:
 // - screenInfo - reference to screen buffer information.
 // - coordRead - Screen buffer coordinate to begin reading from.
-// - amountToRead - the number of elements to read
+// - buffer - receives one attribute per cell. Its size is the number of cells to read.
 // Return Value:
-// - vector of attribute data
-std::vector<WORD> ReadOutputAttributes(const SCREEN_INFORMATION& screenInfo,
-                                       const til::point coordRead,
-                                       const size_t amountToRead)
+// - the number of attributes written to buffer
+size_t ReadOutputAttributes(const SCREEN_INFORMATION& screenInfo,
+                            const til::point coordRead,
+                            const std::span<WORD> buffer)
 {
-    // Short circuit. If nothing to read, leave early.
-    if (amountToRead == 0)
-    {
-        return {};
-    }
+    const auto amountToRead = buffer.size();
+    size_t amountRead = 0;
 
-    // Short circuit, if reading out of bounds, leave early.
-    if (!screenInfo.GetBufferSize().IsInBounds(coordRead))
+    // Short circuit. If nothing to read or reading out of bounds, leave early.
+    if (amountToRead == 0 || !screenInfo.GetBufferSize().IsInBounds(coordRead))
     {
-        return {};
+        return 0;
     }
 
-    // Get iterator to the position we should start reading at.
-    auto it = screenInfo.GetCellDataAt(coordRead);
-    // Count up the number of cells we've attempted to read.
-    ULONG amountRead = 0;
-    // Prepare the return value string.
-    std::vector<WORD> retVal;
-    // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
-    retVal.reserve(amountToRead);
-
-    // While we haven't read enough cells yet and the iterator is still valid (hasn't reached end of buffer)
-    while (amountRead < amountToRead && it)
-    {
-        const auto legacyAttributes = it->TextAttr().GetLegacyAttributes();
+    forEachRowSegment(screenInfo, coordRead, amountToRead, [&](const ROW& row, til::CoordType columnBegin, til::CoordType columnEnd, size_t offset) {
+        const auto target = buffer.subspan(offset, gsl::narrow_cast<size_t>(columnEnd - columnBegin));
 
-        // If the first thing we read is trailing, pad with a space.
-        // OR If the last thing we read is leading, pad with a space.
-        if ((amountRead == 0 && it->DbcsAttr() == DbcsAttribute::Trailing) ||
-            (amountRead == (amountToRead - 1) && it->DbcsAttr() == DbcsAttribute::Leading))
-        {
-            retVal.push_back(legacyAttributes);
-        }
-        else
+        row.ForEachAttributeRun(columnBegin, columnEnd, [&](const TextAttribute& attr, til::CoordType beg, til::CoordType end) {
+            std::fill_n(target.begin() + (beg - columnBegin), end - beg, attr.GetLegacyAttributes());
+            return true;
+        });
+
+        if (row.GetNarrowText(columnBegin, columnEnd).empty())
         {
-            retVal.push_back(legacyAttributes | GeneratePublicApiAttributeFormat(it->DbcsAttr()));
+            for (auto x = columnBegin; x < columnEnd; ++x)
+            {
+                const auto i = offset + gsl::narrow_cast<size_t>(x - columnBegin);
+                const auto dbcsAttr = row.DbcsAttrAt(x);
+
+                // If the first thing we read is trailing, pad with a space.
+                // OR If the last thing we read is leading, pad with a space.
+                if ((i == 0 && dbcsAttr == DbcsAttribute::Trailing) ||
+                    (i == (amountToRead - 1) && dbcsAttr == DbcsAttribute::Leading))
+                {
+                    continue;
+                }
+
+                til::at(buffer, i) |= GeneratePublicApiAttributeFormat(dbcsAttr);
+            }
         }
 
-        amountRead++;
-        it++;
-    }
+        amountRead = offset + target.size();
+    });
 
-    return retVal;
+    return amountRead;
 }
 
 // Routine Description:
-// - This routine reads a sequence of unicode characters from the screen buffer
+// - This routine reads a sequence of unicode characters from the screen buffer.
+// - Rows without wide glyphs or complex graphemes are copied directly out of the ROW.
 // Arguments:
 // - screenInfo - reference to screen buffer information.
 // - coordRead - Screen buffer coordinate to begin reading from.
-// - amountToRead - the number of elements to read
+// - buffer - receives the text. Its size is the number of cells to read.
+//   Each cell produces at most 1 character, so the text always fits.
 // Return Value:
-// - wstring
-std::wstring ReadOutputStringW(const SCREEN_INFORMATION& screenInfo,
-                               const til::point coordRead,
-                               const size_t amountToRead)
+// - the number of characters written to buffer
+size_t ReadOutputStringW(const SCREEN_INFORMATION& screenInfo,
+                         const til::point coordRead,
+                         const std::span<wchar_t> buffer)
 {
-    // Short circuit. If nothing to read, leave early.
-    if (amountToRead == 0)
-    {
-        return {};
-    }
+    const auto amountToRead = buffer.size();
+    size_t written = 0;
 
-    // Short circuit, if reading out of bounds, leave early.
-    if (!screenInfo.GetBufferSize().IsInBounds(coordRead))
+    // Short circuit. If nothing to read or reading out of bounds, leave early.
+    if (amountToRead == 0 || !screenInfo.GetBufferSize().IsInBounds(coordRead))
     {
-        return {};
+        return 0;
     }
 
-    // Get iterator to the position we should start reading at.
-    auto it = screenInfo.GetCellDataAt(coordRead);
-
-    // Count up the number of cells we've attempted to read.
-    ULONG amountRead = 0;
-
-    // Prepare the return value string.
-    std::wstring retVal;
-    retVal.reserve(amountToRead); // Reserve the number of cells. If we have >U+FFFF, it will auto-grow later and that's OK.
-
-    // While we haven't read enough cells yet and the iterator is still valid (hasn't reached end of buffer)
-    while (amountRead < amountToRead && it)
-    {
-        // If the first thing we read is trailing, pad with a space.
-        // OR If the last thing we read is leading, pad with a space.
-        if ((amountRead == 0 && it->DbcsAttr() == DbcsAttribute::Trailing) ||
-            (amountRead == (amountToRead - 1) && it->DbcsAttr() == DbcsAttribute::Leading))
+    forEachRowSegment(screenInfo, coordRead, amountToRead, [&](const ROW& row, til::CoordType columnBegin, til::CoordType columnEnd, size_t offset) {
+        if (const auto text = row.GetNarrowText(columnBegin, columnEnd); !text.empty())
         {
-            retVal += UNICODE_SPACE;
+            std::copy(text.begin(), text.end(), buffer.begin() + written);
+            written += text.size();
+            return;
         }
-        else
+
+        for (auto x = columnBegin; x < columnEnd; ++x)
         {
+            const auto i = offset + gsl::narrow_cast<size_t>(x - columnBegin);
+            const auto dbcsAttr = row.DbcsAttrAt(x);
+
+            // If the first thing we read is trailing, pad with a space.
+            // OR If the last thing we read is leading, pad with a space.
+            if ((i == 0 && dbcsAttr == DbcsAttribute::Trailing) ||
+                (i == (amountToRead - 1) && dbcsAttr == DbcsAttribute::Leading))
+            {
+                til::at(buffer, written++) = UNICODE_SPACE;
+            }
             // Otherwise, add anything that isn't a trailing cell. (Trailings are duplicate copies of the leading.)
-            if (it->DbcsAttr() != DbcsAttribute::Trailing)
+            else if (dbcsAttr != DbcsAttribute::Trailing)
             {
-                auto chars = it->Chars();
+                auto chars = row.GlyphAt(x);
                 if (chars.size() > 1)
                 {
                     chars = { &UNICODE_REPLACEMENT, 1 };
                 }
-                retVal += chars;
+                for (const auto ch : chars)
+                {
+                    til::at(buffer, written++) = ch;
+                }
             }
         }
+    });
 
-        amountRead++;
-        it++;
-    }
-
-    return retVal;
+    return written;
 }
 
 // Routine Description:
@@ -255,7 +272,9 @@ std::string ReadOutputStringA(const SCREEN_INFORMATION& screenInfo,
                               const til::point coordRead,
                               const size_t amountToRead)
 {
-    const auto wstr = ReadOutputStringW(screenInfo, coordRead, amountToRead);
+    std::wstring wstr;
+    wstr.resize(amountToRead);
+    wstr.resize(ReadOutputStringW(screenInfo, coordRead, wstr));
 
     const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
     return ConvertToA(gci.OutputCP, wstr);
@@ -26,13 +26,13 @@ void ScreenBufferSizeChange(const til::size coordNewSize);
 
 [[nodiscard]] NTSTATUS DoCreateScreenBuffer();
 
-std::vector<WORD> ReadOutputAttributes(const SCREEN_INFORMATION& screenInfo,
-                                       const til::point coordRead,
-                                       const size_t amountToRead);
+size_t ReadOutputAttributes(const SCREEN_INFORMATION& screenInfo,
+                            const til::point coordRead,
+                            const std::span<WORD> buffer);
 
-std::wstring ReadOutputStringW(const SCREEN_INFORMATION& screenInfo,
-                               const til::point coordRead,
-                               const size_t amountToRead);
+size_t ReadOutputStringW(const SCREEN_INFORMATION& screenInfo,
+                         const til::point coordRead,
+                         const std::span<wchar_t> buffer);
 
 std::string ReadOutputStringA(const SCREEN_INFORMATION& screenInfo,
                               const til::point coordRead,
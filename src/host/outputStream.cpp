@@ -326,7 +326,7 @@ void ConhostInternalGetSet::PlayMidiNote(const int noteNumber, const int velocit
     // Unlock the console, so the UI doesn't hang while we're busy.
     UnlockConsole();
 
-    // This call will block for the duration, unless shutdown early.
+    // This call may block until the previous notes have been played, unless shutdown early.
     const auto windowHandle = window->GetWindowHandle();
     auto& midiAudio = ServiceLocator::LocateGlobals().getConsoleInformation().GetMidiAudio();
     midiAudio.PlayNote(windowHandle, noteNumber, velocity, std::chrono::duration_cast<std::chrono::milliseconds>(duration));
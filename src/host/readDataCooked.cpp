@@ -900,10 +900,48 @@ void COOKED_READ_DATA::_redisplay()
         LayoutResult res{ .column = cursorPositionFinal.x };
         lines.emplace_back(std::wstring{}, 0, cursorPositionFinal.x, cursorPositionFinal.x);
 
+        // Lines that end before the first modified character and before the cursor are going to be laid out
+        // exactly like they were during the last call. We skip them and only fill in their text if they need to
+        // be redrawn (= if they get scrolled into view). Without this, typing or moving the cursor at the end of
+        // a long prompt would be O(n) for every single key press, because each call would layout the entire buffer.
+        size_t layoutBeg = 0;
+        if (_lineOffsetsWidth == size.width && _lineOffsetsColumn == _originInViewport.x)
+        {
+            const auto reusableEnd = std::min(_bufferDirtyBeg, _bufferCursor);
+            size_t reuse = 0;
+            while (reuse + 1 < _lineOffsets.size() && til::at(_lineOffsets, reuse + 1) <= reusableEnd)
+            {
+                reuse++;
+            }
+
+            if (reuse != 0)
+            {
+                // All lines but the last one of the prompt are full, since a line only ends once it's full.
+                for (size_t i = 0; i < reuse; i++)
+                {
+                    if (i != 0)
+                    {
+                        lines.emplace_back();
+                    }
+
+                    auto& line = lines.back();
+                    line.dirtyBegColumn = size.width;
+                    line.columns = size.width;
+                    line.bufferOffset = til::at(_lineOffsets, i);
+                    line.reused = true;
+                }
+
+                layoutBeg = til::at(_lineOffsets, reuse);
+                res.column = size.width;
+                // If the cursor is at layoutBeg, none of the segments below will contain it.
+                cursorPositionFinal = { size.width, gsl::narrow_cast<til::CoordType>(lines.size() - 1) };
+            }
+        }
+
         // Split the buffer into 3 segments, so that we can find the row/column coordinates of
         // the cursor within the buffer, as well as the start of the dirty parts of the buffer.
         const size_t offsets[]{
-            0,
+            layoutBeg,
             std::min(_bufferDirtyBeg, _bufferCursor),
             std::max(_bufferDirtyBeg, _bufferCursor),
             npos,
@@ -924,7 +962,7 @@ void COOKED_READ_DATA::_redisplay()
             {
                 if (res.column >= size.width)
                 {
-                    lines.emplace_back();
+                    lines.emplace_back().bufferOffset = offsets[i] + beg;
                 }
 
                 auto& line = lines.back();
@@ -1151,6 +1189,12 @@ void COOKED_READ_DATA::_redisplay()
         for (auto i = beg; i < end; i++)
         {
             auto& line = lines.at(i + pagerContentTop);
+            if (line.reused)
+            {
+                const auto column = i + pagerContentTop == 0 ? _originInViewport.x : 0;
+                _layoutLine(line.text, _buffer, line.bufferOffset, column, size.width);
+                line.reused = false;
+            }
             line.dirtyBegOffset = 0;
             line.dirtyBegColumn = 0;
         }
@@ -1243,6 +1287,16 @@ void COOKED_READ_DATA::_redisplay()
     _pagerHeight = pagerHeight;
     _bufferDirtyBeg = _buffer.size();
     _dirty = false;
+
+    // Remember the layout of the prompt lines (but not of the popups) for the next call.
+    const auto promptLineCount = gsl::narrow_cast<size_t>(pagerPromptEnd.y) + 1;
+    _lineOffsets.resize(promptLineCount);
+    for (size_t i = 0; i < promptLineCount; i++)
+    {
+        til::at(_lineOffsets, i) = til::at(lines, i).bufferOffset;
+    }
+    _lineOffsetsWidth = size.width;
+    _lineOffsetsColumn = _originInViewport.x;
 }
 
 COOKED_READ_DATA::LayoutResult COOKED_READ_DATA::_layoutLine(std::wstring& output, const std::wstring_view& input, const size_t inputOffset, const til::CoordType columnBegin, const til::CoordType columnLimit) const
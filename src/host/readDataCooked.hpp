@@ -118,6 +118,10 @@ private:
         size_t dirtyBegOffset = 0;
         til::CoordType dirtyBegColumn = 0;
         til::CoordType columns = 0;
+        // The offset into _buffer at which this line starts.
+        size_t bufferOffset = 0;
+        // Lines reused from the previous layout have no text until it's needed. See _redisplay().
+        bool reused = false;
     };
 
     static size_t _wordPrev(const std::wstring_view& chars, size_t position);
@@ -175,6 +179,11 @@ private:
     til::CoordType _pagerContentTop = 0;
     // Contains the viewport height for which it previously was drawn for.
     til::CoordType _pagerHeight = 0;
+    // The _buffer offsets at which each line of the prompt started during the last _redisplay(),
+    // as well as the viewport width and starting column used for that layout.
+    std::vector<size_t> _lineOffsets;
+    til::CoordType _lineOffsetsWidth = -1;
+    til::CoordType _lineOffsetsColumn = -1;
 
     std::vector<Popup> _popups;
     bool _popupOpened = false;
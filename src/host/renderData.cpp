@@ -271,7 +271,12 @@ const std::wstring RenderData::GetHyperlinkCustomId(uint16_t id) const
 }
 
 // For now, we ignore regex patterns in conhost
-const std::vector<size_t> RenderData::GetPatternId(const til::point /*location*/) const
+std::span<const til::point_span> RenderData::GetPatternSpans() const noexcept
+{
+    return {};
+}
+
+til::generation_t RenderData::GetPatternGeneration() const noexcept
 {
     return {};
 }
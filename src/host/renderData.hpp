@@ -45,7 +45,8 @@ public:
     const std::wstring GetHyperlinkUri(uint16_t id) const override;
     const std::wstring GetHyperlinkCustomId(uint16_t id) const override;
 
-    const std::vector<size_t> GetPatternId(const til::point location) const override;
+    std::span<const til::point_span> GetPatternSpans() const noexcept override;
+    til::generation_t GetPatternGeneration() const noexcept override;
 
     std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override;
     const bool IsSelectionActive() const override;
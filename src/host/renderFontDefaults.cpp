@@ -7,20 +7,28 @@
 
 #pragma hdrstop
 
-RenderFontDefaults::RenderFontDefaults()
-{
-    LOG_IF_NTSTATUS_FAILED(TrueTypeFontList::s_Initialize());
-}
+RenderFontDefaults::RenderFontDefaults() = default;
 
 RenderFontDefaults::~RenderFontDefaults()
 {
-    LOG_IF_FAILED(TrueTypeFontList::s_Destroy());
+    if (_initialized)
+    {
+        LOG_IF_FAILED(TrueTypeFontList::s_Destroy());
+    }
 }
 
 [[nodiscard]] HRESULT RenderFontDefaults::RetrieveDefaultFontNameForCodepage(const unsigned int codePage,
                                                                              std::wstring& outFaceName)
 try
 {
+    // The TrueType font list is read from the registry on first use, not on construction:
+    // ConPTY sessions don't render and usually never ask for a default font,
+    // so they shouldn't pay for the enumeration during startup.
+    std::call_once(_initOnce, [this]() {
+        LOG_IF_NTSTATUS_FAILED(TrueTypeFontList::s_Initialize());
+        _initialized = true;
+    });
+
     // GH#3123: Propagate font length changes up through Settings and propsheet
     wchar_t faceName[LF_FACESIZE]{ 0 };
     auto status = TrueTypeFontList::s_SearchByCodePage(codePage, faceName, ARRAYSIZE(faceName));
@@ -5,6 +5,7 @@
 #include "screenInfo.hpp"
 
 #include "output.h"
+#include "handle.h"
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../types/inc/CodepointWidthDetector.hpp"
 #include "../types/inc/convert.hpp"
@@ -73,6 +74,7 @@ SCREEN_INFORMATION::~SCREEN_INFORMATION()
 // - coordWindowSize - the initial size of screen buffer's window (in rows/columns)
 // - nFont - the initial font to generate text with.
 // - dwScreenBufferSize - the initial size of the screen buffer (in rows/columns).
+// - recycledTextBuffer - optionally, a text buffer to reuse if it has the right size.
 // Return Value:
 [[nodiscard]] NTSTATUS SCREEN_INFORMATION::CreateInstance(_In_ til::size coordWindowSize,
                                                           const FontInfo fontInfo,
@@ -80,7 +82,8 @@ SCREEN_INFORMATION::~SCREEN_INFORMATION()
                                                           const TextAttribute defaultAttributes,
                                                           const TextAttribute popupAttributes,
                                                           const UINT uiCursorSize,
-                                                          _Outptr_ SCREEN_INFORMATION** const ppScreen)
+                                                          _Outptr_ SCREEN_INFORMATION** const ppScreen,
+                                                          std::unique_ptr<TextBuffer> recycledTextBuffer)
 {
     *ppScreen = nullptr;
 
@@ -101,11 +104,20 @@ SCREEN_INFORMATION::~SCREEN_INFORMATION()
         pScreen->UpdateBottom();
 
         // Set up text buffer
-        pScreen->_textBuffer = std::make_unique<TextBuffer>(coordScreenBufferSize,
-                                                            defaultAttributes,
-                                                            uiCursorSize,
-                                                            pScreen->IsActiveScreenBuffer(),
-                                                            ServiceLocator::LocateGlobals().pRender);
+        if (recycledTextBuffer && recycledTextBuffer->GetSize().Dimensions() == coordScreenBufferSize)
+        {
+            recycledTextBuffer->Recycle(defaultAttributes, uiCursorSize);
+            recycledTextBuffer->SetAsActiveBuffer(pScreen->IsActiveScreenBuffer());
+            pScreen->_textBuffer = std::move(recycledTextBuffer);
+        }
+        else
+        {
+            pScreen->_textBuffer = std::make_unique<TextBuffer>(coordScreenBufferSize,
+                                                                defaultAttributes,
+                                                                uiCursorSize,
+                                                                pScreen->IsActiveScreenBuffer(),
+                                                                ServiceLocator::LocateGlobals().pRender);
+        }
 
         const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
         pScreen->_textBuffer->GetCursor().SetType(gci.GetCursorType());
@@ -508,6 +520,27 @@ til::size SCREEN_INFORMATION::GetScreenFontSize() const
 
 #pragma region Set Data
 
+// Resolves the widths of ambiguous characters via the renderer on the thread pool, so that
+// writing them later doesn't need to call into the renderer on the output path. It works in
+// small batches, because the fallback needs the console lock and we don't want to block output.
+static void prefillWidthCache()
+{
+    static constexpr size_t batchSize = 256;
+
+    const auto generation = CodepointWidthDetector::Singleton().FallbackCacheGeneration();
+    const auto callback = [](PTP_CALLBACK_INSTANCE, void* context) noexcept {
+        const auto generation = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(context));
+        for (auto more = true; more;)
+        {
+            LockConsole();
+            const auto unlock = wil::scope_exit([&] { UnlockConsole(); });
+            more = CodepointWidthDetector::Singleton().PrefillFallbackCache(generation, batchSize);
+        }
+    };
+
+    LOG_IF_WIN32_BOOL_FALSE(TrySubmitThreadpoolCallback(callback, reinterpret_cast<void*>(static_cast<uintptr_t>(generation)), nullptr));
+}
+
 void SCREEN_INFORMATION::RefreshFontWithRenderer()
 {
     if (IsActiveScreenBuffer())
@@ -536,6 +569,11 @@ void SCREEN_INFORMATION::RefreshFontWithRenderer()
         }
 
         CodepointWidthDetector::Singleton().Reset(mode);
+
+        if (mode == TextMeasurementMode::Console && globals.pRender != nullptr)
+        {
+            prefillWidthCache();
+        }
     }
 }
 
@@ -1775,7 +1813,8 @@ const SCREEN_INFORMATION* SCREEN_INFORMATION::GetAltBuffer() const noexcept
                                                      initAttributes,
                                                      GetPopupAttributes(),
                                                      Cursor::CURSOR_SMALL_SIZE,
-                                                     ppsiNewScreenBuffer);
+                                                     ppsiNewScreenBuffer,
+                                                     std::move(GetMainBuffer()._spareAltTextBuffer));
     if (SUCCEEDED_NTSTATUS(Status))
     {
         // Update the alt buffer's cursor style, visibility, and position to match our own.
@@ -1938,6 +1977,10 @@ void SCREEN_INFORMATION::UseMainScreenBuffer()
         // Copy the alt buffer's output mode back to the main buffer.
         psiMain->OutputMode = psiAlt->OutputMode;
 
+        // Pagers like less enter and exit the alt buffer all the time. We hold onto its text
+        // buffer, so that the next alt buffer doesn't need to allocate and commit a new one.
+        psiMain->_spareAltTextBuffer = std::move(psiAlt->_textBuffer);
+
         s_RemoveScreenBuffer(psiAlt); // this will also delete the alt buffer
         // deleting the alt buffer will give the GetSet back to its main
 
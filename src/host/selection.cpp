@@ -44,10 +44,11 @@ void Selection::_RegenerateSelectionSpans() const
     endSelectionAnchor.y = (_d->coordSelectionAnchor.y == _d->srSelectionRect.top) ? _d->srSelectionRect.bottom : _d->srSelectionRect.top;
 
     const auto blockSelection = !IsLineSelection();
-    _lastSelectionSpans = screenInfo.GetTextBuffer().GetTextSpans(_d->coordSelectionAnchor,
-                                                                  endSelectionAnchor,
-                                                                  blockSelection,
-                                                                  false);
+    screenInfo.GetTextBuffer().GetTextSpans(_d->coordSelectionAnchor,
+                                            endSelectionAnchor,
+                                            blockSelection,
+                                            false,
+                                            _lastSelectionSpans);
     _lastSelectionGeneration = _d.generation();
 }
 
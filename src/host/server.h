@@ -28,6 +28,18 @@ Revision History:
 
 #include <til/ticket_lock.h>
 
+// The result of GetCPInfo() for one of the console's code pages, along with lookup tables that
+// SetConsoleCPInfo() derives from it, so that the A APIs don't need to ask the OS about every byte.
+struct ConsoleCPInfo : CPINFO
+{
+    // Whether the byte is a DBCS lead byte in this code page (all false for single byte code pages).
+    std::array<bool, 256> leadBytes{};
+    bool hasLeadBytes = false;
+    // Whether 0x00-0x7F convert to and from U+0000-U+007F unchanged, which is true for all the usual
+    // ANSI and OEM code pages, but not for EBCDIC or 7-bit ones. ASCII runs can then be widened directly.
+    bool asciiCompatible = false;
+};
+
 // clang-format off
 // Flags flags
 #define CONSOLE_IS_ICONIC               0x00000001
@@ -97,8 +109,8 @@ public:
     ULONG CtrlFlags = 0; // indicates outstanding ctrl requests
     ULONG LimitingProcessId = 0;
 
-    CPINFO CPInfo = {};
-    CPINFO OutputCPInfo = {};
+    ConsoleCPInfo CPInfo = {};
+    ConsoleCPInfo OutputCPInfo = {};
 
     void LockConsole() noexcept;
     void UnlockConsole() noexcept;
@@ -803,3 +803,8 @@ bool Settings::GetEnableBuiltinGlyphs() const noexcept
 {
     return _fEnableBuiltinGlyphs;
 }
+
+DWORD Settings::GetMaxPaintRate() const noexcept
+{
+    return _maxPaintRate;
+}
@@ -184,6 +184,7 @@ public:
     SettingsTextMeasurementMode GetTextMeasurementMode() const noexcept;
     void SetTextMeasurementMode(SettingsTextMeasurementMode mode) noexcept;
     bool GetEnableBuiltinGlyphs() const noexcept;
+    DWORD GetMaxPaintRate() const noexcept;
 
 private:
     RenderSettings _renderSettings;
@@ -229,6 +230,7 @@ private:
     bool _fUseDx;
     bool _fCopyColor;
     bool _fEnableBuiltinGlyphs = true;
+    DWORD _maxPaintRate = 60; // frames per second of the classic window, 0 for no limit
 
     // this is used for the special STARTF_USESIZE mode.
     bool _fUseWindowSizePixels;
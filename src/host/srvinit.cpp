@@ -4,6 +4,8 @@
 #include "precomp.h"
 #include "srvinit.h"
 
+#include <condition_variable>
+
 #include "dbcs.h"
 #include "handle.h"
 #include "registry.hpp"
@@ -27,6 +29,39 @@ using namespace Microsoft::Console::Render;
 const UINT CONSOLE_EVENT_FAILURE_ID = 21790;
 const UINT CONSOLE_LPC_PORT_FAILURE_ID = 21791;
 
+// Routine Description:
+// - Logs how long it took since the process was created to get to the given point of the startup.
+//   Used to keep an eye on the startup time of ConPTY sessions, which every terminal tab pays for.
+// Arguments:
+// - phase - A short name for the point of the startup that was reached.
+static void s_TraceStartupPhase(const char* const phase) noexcept
+{
+    if (!TraceLoggingProviderEnabled(g_hConhostV2EventTraceProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
+    {
+        return;
+    }
+
+    FILETIME creationTime, exitTime, kernelTime, userTime, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+    {
+        return;
+    }
+    GetSystemTimePreciseAsFileTime(&now);
+
+    const auto toTicks = [](const FILETIME& ft) noexcept {
+        return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    };
+    const auto elapsed = (toTicks(now) - toTicks(creationTime)) / 10;
+
+    TraceLoggingWrite(g_hConhostV2EventTraceProvider,
+                      "SrvInit_StartupPhase",
+                      TraceLoggingString(phase, "Phase"),
+                      TraceLoggingUInt64(elapsed, "ElapsedMicroseconds"),
+                      TraceLoggingBool(ServiceLocator::LocateGlobals().launchArgs.InConptyMode(), "InConptyMode"),
+                      TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+}
+
 [[nodiscard]] HRESULT ConsoleServerInitialization(_In_ HANDLE Server, const ConsoleArguments* const args)
 try
 {
@@ -47,6 +82,13 @@ try
 
     FontInfoBase::s_SetFontDefaultList(Globals.pFontDefaultList);
 
+    // A PTY never hands its clients off to another console (see IoDispatchers),
+    // so there's no need to read the default terminal settings from the registry.
+    if (Globals.delegationPair.IsUndecided() && args->InConptyMode())
+    {
+        Globals.delegationPair = DelegationConfig::ConhostDelegationPair;
+    }
+
     // Check if this conhost is allowed to delegate its activities to another.
     // If so, look up the registered default console handler.
     if (Globals.delegationPair.IsUndecided())
@@ -84,6 +126,8 @@ try
         RETURN_IF_FAILED(ServiceLocator::CreateAccessibilityNotifier());
     }
 
+    s_TraceStartupPhase("ServerInitialized");
+
     // Removed allocation of scroll buffer here.
     return S_OK;
 }
@@ -876,9 +920,14 @@ PWSTR TranslateConsoleTitle(_In_ PCWSTR pwszConsoleTitle, const BOOL fUnexpand,
         return Status;
     }
 
+    s_TraceStartupPhase("ConsoleSetUp");
+
     // Allow the renderer to paint once the rest of the console is hooked up.
     if (g.pRender)
     {
+        // Painting holds the console lock, so the frame rate limits how much a slow engine
+        // (GDI in a VM without a GPU) can hold up clients that are writing output.
+        g.pRender->SetMaxFrameRate(gsl::narrow_cast<int>(std::min<DWORD>(gci.GetMaxPaintRate(), 1000)));
         g.pRender->EnablePainting();
     }
 
@@ -971,12 +1020,237 @@ PWSTR TranslateConsoleTitle(_In_ PCWSTR pwszConsoleTitle, const BOOL fUnexpand,
         }
     }
 
+    if (SUCCEEDED_NTSTATUS(Status))
+    {
+        s_TraceStartupPhase("ConsoleAllocated");
+    }
+
     return Status;
 }
 
+namespace
+{
+    // The message slots shared between ConsoleIoReaderThread, which fills them with
+    // messages from the driver, and ConsoleIoServiceBatches, which services them.
+    class ConsoleIoBatchQueue
+    {
+    public:
+        static constexpr size_t Capacity = 32;
+
+        ConsoleIoBatchQueue() :
+            _storage{ std::make_unique<CONSOLE_API_MSG[]>(Capacity) }
+        {
+            _free.reserve(Capacity);
+            for (size_t i = 0; i < Capacity; ++i)
+            {
+                _free.push_back(&_storage[i]);
+            }
+        }
+
+        // Returns an unused slot. Blocks while all of them are in use.
+        CONSOLE_API_MSG* AcquireFree()
+        {
+            std::unique_lock lock{ _mutex };
+            _freeAvailable.wait(lock, [&]() { return !_free.empty(); });
+            const auto msg = _free.back();
+            _free.pop_back();
+            return msg;
+        }
+
+        // Returns a slot acquired with AcquireFree() or Pop() back to the pool.
+        void Release(CONSOLE_API_MSG* msg)
+        {
+            {
+                const std::lock_guard lock{ _mutex };
+                _free.push_back(msg);
+            }
+            _freeAvailable.notify_one();
+        }
+
+        // Hands a slot filled with a message over to the servicing thread.
+        void Push(CONSOLE_API_MSG* msg)
+        {
+            {
+                const std::lock_guard lock{ _mutex };
+                _pending.push_back(msg);
+            }
+            _pendingAvailable.notify_one();
+        }
+
+        // Returns the oldest pending message. Blocks until there's one.
+        CONSOLE_API_MSG* WaitPop()
+        {
+            std::unique_lock lock{ _mutex };
+            _pendingAvailable.wait(lock, [&]() { return !_pending.empty(); });
+            const auto msg = _pending.front();
+            _pending.pop_front();
+            return msg;
+        }
+
+        // Returns the oldest pending message, if there's one and the predicate accepts it.
+        template<typename T>
+        CONSOLE_API_MSG* TryPopIf(T&& predicate)
+        {
+            const std::lock_guard lock{ _mutex };
+            if (_pending.empty() || !predicate(*_pending.front()))
+            {
+                return nullptr;
+            }
+            const auto msg = _pending.front();
+            _pending.pop_front();
+            return msg;
+        }
+
+    private:
+        std::unique_ptr<CONSOLE_API_MSG[]> _storage;
+        std::mutex _mutex;
+        std::condition_variable _freeAvailable;
+        std::condition_variable _pendingAvailable;
+        std::vector<CONSOLE_API_MSG*> _free;
+        std::deque<CONSOLE_API_MSG*> _pending;
+    };
+
+    // A batch is closed after this many messages or once it took this long,
+    // whichever comes first. The latter bounds how long other threads wait
+    // for the console lock and how long clients wait for their completion.
+    constexpr size_t maxBatchSize = ConsoleIoBatchQueue::Capacity;
+    constexpr auto maxBatchLatency = std::chrono::milliseconds{ 1 };
+
+    // Connection and object management messages lock and unlock the console themselves, because
+    // for instance the connection request has to let the input thread initialize while it waits.
+    // They can't run under the lock held by a batch and are serviced on their own instead.
+    bool IsBatchable(const CONSOLE_API_MSG& msg) noexcept
+    {
+        switch (msg.Descriptor.Function)
+        {
+        case CONSOLE_IO_USER_DEFINED:
+        case CONSOLE_IO_RAW_WRITE:
+        case CONSOLE_IO_RAW_READ:
+        case CONSOLE_IO_RAW_FLUSH:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // Routine Description:
+    // - Reads messages from the driver as fast as clients submit them and queues them up. Unlike
+    //   ConsoleIoThread's loop it can't complete the previous message in the same call, because
+    //   the messages are completed by ConsoleIoServiceBatches, concurrently with this.
+    DWORD WINAPI ConsoleIoReaderThread(LPVOID lpParameter)
+    {
+        auto& globals = ServiceLocator::LocateGlobals();
+        auto& queue = *static_cast<ConsoleIoBatchQueue*>(lpParameter);
+
+        for (;;)
+        {
+            const auto msg = queue.AcquireFree();
+
+            if (const auto hr = globals.pDeviceComm->ReadIo(nullptr, msg); FAILED(hr))
+            {
+                if (hr == HRESULT_FROM_WIN32(ERROR_PIPE_NOT_CONNECTED))
+                {
+                    // This will not return. Terminate immediately when disconnected.
+                    ServiceLocator::RundownAndExit(STATUS_SUCCESS);
+                }
+                LOG_HR_MSG(hr, "DeviceIoControl failed");
+                queue.Release(msg);
+                continue;
+            }
+
+            msg->_pApiRoutines = globals.api;
+            msg->_pDeviceComm = globals.pDeviceComm;
+            queue.Push(msg);
+        }
+    }
+
+    // Routine Description:
+    // - Services the messages queued up by ConsoleIoReaderThread in batches: All messages that
+    //   are pending when we wake up (and those that arrive while we're at it) are serviced under
+    //   a single acquisition of the console lock and with the VT output corked, so that they
+    //   result in a single write to the terminal. Only then are they completed, all together.
+    // - This runs on the IO thread and never returns.
+    [[noreturn]] void ConsoleIoServiceBatches(ConsoleIoBatchQueue& queue)
+    {
+        auto& globals = ServiceLocator::LocateGlobals();
+        auto& gci = globals.getConsoleInformation();
+        std::vector<CONSOLE_API_MSG*> replies;
+        replies.reserve(maxBatchSize);
+
+        for (;;)
+        {
+            auto msg = queue.WaitPop();
+
+            if (!IsBatchable(*msg))
+            {
+                PCONSOLE_API_MSG reply = nullptr;
+                IoSorter::ServiceIoOperation(msg, &reply);
+                if (reply)
+                {
+                    replies.push_back(reply);
+                }
+                else
+                {
+                    queue.Release(msg);
+                }
+            }
+            else
+            {
+                LockConsole();
+                const auto unlock = wil::scope_exit([]() { UnlockConsole(); });
+                auto writer = gci.GetVtWriter();
+                const auto deadline = std::chrono::steady_clock::now() + maxBatchLatency;
+
+                for (size_t count = 1;; ++count)
+                {
+                    // IoSorter returns either the message itself, if it's to be completed
+                    // by us, or nullptr if it was completed already or turned into a wait.
+                    // Waits copy the message, so in either case the slot can be reused.
+                    PCONSOLE_API_MSG reply = nullptr;
+                    IoSorter::ServiceIoOperation(msg, &reply);
+                    if (reply)
+                    {
+                        replies.push_back(reply);
+                    }
+                    else
+                    {
+                        queue.Release(msg);
+                    }
+
+                    if (count >= maxBatchSize || std::chrono::steady_clock::now() >= deadline)
+                    {
+                        break;
+                    }
+
+                    msg = queue.TryPopIf(IsBatchable);
+                    if (!msg)
+                    {
+                        break;
+                    }
+                }
+
+                if (writer)
+                {
+                    writer.Submit();
+                }
+            }
+
+            for (const auto reply : replies)
+            {
+                LOG_IF_FAILED(reply->ReleaseMessageBuffers());
+                LOG_IF_FAILED(globals.pDeviceComm->CompleteIo(&reply->Complete));
+                queue.Release(reply);
+            }
+            replies.clear();
+        }
+    }
+}
+
 // Routine Description:
 // - This routine is the main one in the console server IO thread.
 // - It reads IO requests submitted by clients through the driver, services and completes them in a loop.
+// - With Feature_ConsoleApiBatching it leaves the reading to ConsoleIoReaderThread and services
+//   the messages in batches instead. See ConsoleIoServiceBatches.
 // Arguments:
 // - lpParameter - PCONSOLE_API_MSG being handed off to us from the previous I/O.
 // Return Value:
@@ -1003,6 +1277,31 @@ DWORD WINAPI ConsoleIoThread(LPVOID lpParameter)
         IoSorter::ServiceIoOperation(&ReceiveMsg, &ReplyMsg);
     }
 
+    if constexpr (Feature_ConsoleApiBatching::IsEnabled())
+    {
+        if (ReplyMsg != nullptr)
+        {
+            LOG_IF_FAILED(ReplyMsg->ReleaseMessageBuffers());
+            LOG_IF_FAILED(globals.pDeviceComm->CompleteIo(&ReplyMsg->Complete));
+        }
+
+        // The queue is never freed, because neither of the two threads ever exits.
+        // The process terminates once the last client disconnects.
+        const auto queue = new ConsoleIoBatchQueue();
+        const auto hThread = CreateThread(nullptr, 0, ConsoleIoReaderThread, queue, 0, nullptr);
+        if (hThread)
+        {
+            LOG_IF_FAILED(SetThreadDescription(hThread, L"Console Driver Message Reader Thread"));
+            LOG_IF_WIN32_BOOL_FALSE(CloseHandle(hThread));
+            ConsoleIoServiceBatches(*queue);
+        }
+
+        // If we failed to start the reader thread, fall back to the regular loop below.
+        LOG_LAST_ERROR();
+        delete queue;
+        ReplyMsg = nullptr;
+    }
+
     auto fShouldExit = false;
     while (!fShouldExit)
     {
@@ -143,6 +143,13 @@ static bool IsCommandLineEditingKey(const KEY_EVENT_RECORD& event)
 
     for (;;)
     {
+        // Text written via WriteKeyText() can be returned without synthesizing key events for it.
+        // Popups need the modifier state of each key though, which that text doesn't have.
+        if (!pPopupKeys && pInputBuffer->ConsumeKeyTextChar(*pwchOut))
+        {
+            return STATUS_SUCCESS;
+        }
+
         InputEventQueue events;
         const auto Status = pInputBuffer->Read(events, 1, false, Wait, true, true);
         if (FAILED_NTSTATUS(Status))
@@ -487,6 +494,9 @@ NT_CATCH_RETURN()
 
         waiter.reset();
 
+        // What the client wrote so far should be visible before it waits for the user.
+        ServiceLocator::LocateGlobals().getConsoleInformation().GetVtIo()->Flush();
+
         bytesRead = 0;
 
         if (buffer.size() < 1)
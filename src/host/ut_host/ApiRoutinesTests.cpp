@@ -416,6 +416,39 @@ class ApiRoutinesTests
         }
     }
 
+    TEST_METHOD(ConsoleCPInfoTables)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto restoreCP = wil::scope_exit([&, oldCP = gci.OutputCP] {
+            gci.OutputCP = oldCP;
+            SetConsoleCPInfo(TRUE);
+        });
+
+        Log::Comment(L"Code page 437 is ASCII compatible and has no lead bytes.");
+        gci.OutputCP = CP_USA;
+        SetConsoleCPInfo(TRUE);
+        VERIFY_IS_TRUE(gci.OutputCPInfo.asciiCompatible);
+        VERIFY_IS_FALSE(gci.OutputCPInfo.hasLeadBytes);
+        VERIFY_IS_FALSE(IsDBCSLeadByteConsole('\x82', &gci.OutputCPInfo));
+
+        Log::Comment(L"Code page 932 is ASCII compatible, but has lead bytes.");
+        gci.OutputCP = CP_JAPANESE;
+        SetConsoleCPInfo(TRUE);
+        VERIFY_IS_TRUE(gci.OutputCPInfo.asciiCompatible);
+        VERIFY_IS_TRUE(gci.OutputCPInfo.hasLeadBytes);
+        VERIFY_IS_TRUE(IsDBCSLeadByteConsole('\x82', &gci.OutputCPInfo));
+        VERIFY_IS_FALSE(IsDBCSLeadByteConsole('A', &gci.OutputCPInfo));
+
+        char bisected[]{ 'A', '\x82', '\xa0', '\x82' };
+        VERIFY_IS_FALSE(CheckBisectStringA(&bisected[0], 3, &gci.OutputCPInfo));
+        VERIFY_IS_TRUE(CheckBisectStringA(&bisected[0], 4, &gci.OutputCPInfo));
+
+        Log::Comment(L"Code page 37 (EBCDIC) isn't ASCII compatible.");
+        gci.OutputCP = 37;
+        SetConsoleCPInfo(TRUE);
+        VERIFY_IS_FALSE(gci.OutputCPInfo.asciiCompatible);
+    }
+
     TEST_METHOD(ApiWriteConsoleW)
     {
         BEGIN_TEST_METHOD_PROPERTIES()
@@ -32,6 +32,7 @@ public:
     TEST_METHOD(HeadlessArgTests);
     TEST_METHOD(SignalHandleTests);
     TEST_METHOD(FeatureArgTests);
+    TEST_METHOD(OutputRingTests);
 };
 
 ConsoleArguments CreateAndParse(std::wstring& commandline, HANDLE hVtIn, HANDLE hVtOut)
@@ -1169,3 +1170,25 @@ void ConsoleArgumentsTests::FeatureArgTests()
                                     false), // runAsComServer
                    false); // successful parse?
 }
+
+void ConsoleArgumentsTests::OutputRingTests()
+{
+    auto hInSample = UlongToHandle(0x10);
+    auto hOutSample = UlongToHandle(0x24);
+
+    std::wstring commandline = L"conhost.exe --server 0x4 --signal 0x8 --outputRing 0xc --outputRingDataEvent 0x14 --outputRingSpaceEvent 0x18";
+    auto args = CreateAndParse(commandline, hInSample, hOutSample);
+    VERIFY_IS_TRUE(args.HasOutputRing());
+    VERIFY_ARE_EQUAL(UlongToHandle(0xc), args.GetOutputRingSection());
+    VERIFY_ARE_EQUAL(UlongToHandle(0x14), args.GetOutputRingDataEvent());
+    VERIFY_ARE_EQUAL(UlongToHandle(0x18), args.GetOutputRingSpaceEvent());
+    VERIFY_ARE_EQUAL(UlongToHandle(0x8), args.GetSignalHandle());
+
+    // All three handles are required.
+    commandline = L"conhost.exe --server 0x4 --outputRing 0xc --outputRingDataEvent 0x14";
+    args = CreateAndParse(commandline, hInSample, hOutSample);
+    VERIFY_IS_FALSE(args.HasOutputRing());
+
+    commandline = L"conhost.exe --server 0x4 --outputRing ASDF";
+    CreateAndParseUnsuccessfully(commandline, hInSample, hOutSample);
+}
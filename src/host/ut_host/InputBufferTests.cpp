@@ -353,6 +353,100 @@ class InputBufferTests
         }
     }
 
+    TEST_METHOD(CanReadLargeAmountsOfInputInChunks)
+    {
+        Log::Comment(L"Events should be returned in order across reads, even while new ones are written in between");
+
+        InputBuffer inputBuffer;
+        static constexpr size_t total = 100000;
+        static constexpr size_t chunk = 4096;
+
+        const auto makeRecord = [&](size_t i) {
+            const auto ch = static_cast<WCHAR>(L'A' + i % 26);
+            return MakeKeyEvent(TRUE, 1, ch, 0, ch, 0);
+        };
+
+        InputEventQueue inEvents;
+        for (size_t i = 0; i < total / 2; ++i)
+        {
+            inEvents.push_back(makeRecord(i));
+        }
+        VERIFY_ARE_EQUAL(total / 2, inputBuffer.Write(inEvents));
+
+        size_t read = 0;
+        while (read < total)
+        {
+            InputEventQueue outEvents;
+            VERIFY_NT_SUCCESS(inputBuffer.Read(outEvents, chunk, false, false, true, false));
+            VERIFY_IS_FALSE(outEvents.empty());
+
+            for (const auto& e : outEvents)
+            {
+                VERIFY_ARE_EQUAL(makeRecord(read), e);
+                read++;
+            }
+
+            // Write the second half of the records after the first read, so that
+            // the already consumed records need to be reclaimed at some point.
+            if (!inEvents.empty())
+            {
+                inEvents.clear();
+                for (size_t i = total / 2; i < total; ++i)
+                {
+                    inEvents.push_back(makeRecord(i));
+                }
+                VERIFY_ARE_EQUAL(total / 2, inputBuffer.Write(inEvents));
+                inEvents.clear();
+            }
+        }
+
+        VERIFY_ARE_EQUAL(total, read);
+        VERIFY_ARE_EQUAL(0u, inputBuffer.GetNumberOfReadyEvents());
+    }
+
+    TEST_METHOD(KeyTextIsSynthesizedOnDemand)
+    {
+        Log::Comment(L"Text written with WriteKeyText should be readable as characters and as key events, in order with other events");
+
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        InputBuffer inputBuffer;
+
+        INPUT_RECORD menuRecord;
+        menuRecord.EventType = MENU_EVENT;
+
+        inputBuffer.WriteKeyText(L"ab", gci.CP);
+        VERIFY_IS_GREATER_THAN(inputBuffer.Write(menuRecord), 0u);
+        inputBuffer.WriteKeyText(L"c", gci.CP);
+
+        // No key events were synthesized yet.
+        VERIFY_ARE_EQUAL(1u, inputBuffer._storage.size());
+
+        wchar_t wch = 0;
+        VERIFY_IS_TRUE(inputBuffer.ConsumeKeyTextChar(wch));
+        VERIFY_ARE_EQUAL(L'a', wch);
+
+        // "b" is followed by the menu event.
+        InputEventQueue outEvents;
+        VERIFY_NT_SUCCESS(inputBuffer.Read(outEvents, SIZE_MAX, false, false, true, false));
+
+        std::wstring text;
+        for (const auto& e : outEvents)
+        {
+            if (e.EventType == KEY_EVENT && e.Event.KeyEvent.bKeyDown && e.Event.KeyEvent.uChar.UnicodeChar)
+            {
+                text.push_back(e.Event.KeyEvent.uChar.UnicodeChar);
+            }
+            else if (e.EventType == MENU_EVENT)
+            {
+                text.push_back(L'|');
+            }
+        }
+        VERIFY_ARE_EQUAL(L"b|c", text);
+
+        VERIFY_ARE_EQUAL(0u, inputBuffer.GetNumberOfReadyEvents());
+        VERIFY_IS_FALSE(inputBuffer.ConsumeKeyTextChar(wch));
+    }
+
     TEST_METHOD(EmptyingBufferDuringReadSetsResetWaitEvent)
     {
         Log::Comment(L"hInputEvent should be reset if a read to the buffer completely empties it");
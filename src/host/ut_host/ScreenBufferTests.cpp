@@ -154,6 +154,7 @@ class ScreenBufferTests
     TEST_METHOD(TestAltBufferCursorState);
     TEST_METHOD(TestAltBufferVtDispatching);
     TEST_METHOD(TestAltBufferRIS);
+    TEST_METHOD(TestAltBufferReuse);
 
     TEST_METHOD(SetDefaultsIndividuallyBothDefault);
     TEST_METHOD(SetDefaultsTogether);
@@ -2613,6 +2614,34 @@ void ScreenBufferTests::TestAltBufferRIS()
     VERIFY_IS_FALSE(gci.GetActiveOutputBuffer()._IsAltBuffer());
 }
 
+void ScreenBufferTests::TestAltBufferReuse()
+{
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    gci.LockConsole(); // Lock must be taken to manipulate buffer.
+    auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& stateMachine = si.GetStateMachine();
+
+    Log::Comment(L"Write some text into the alt buffer and return to the main buffer");
+    stateMachine.ProcessString(L"\x1b[?1049h");
+    const auto altTextBuffer = &gci.GetActiveOutputBuffer().GetTextBuffer();
+    stateMachine.ProcessString(L"\x1b[H\x1b[31mABC\x1b[m");
+    stateMachine.ProcessString(L"\x1b[?1049l");
+    VERIFY_IS_FALSE(gci.GetActiveOutputBuffer()._IsAltBuffer());
+
+    Log::Comment(L"The next alt buffer reuses the text buffer, which must be blank again");
+    stateMachine.ProcessString(L"\x1b[?1049h");
+    const auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+    VERIFY_ARE_EQUAL(altTextBuffer, &textBuffer);
+    const auto& row = textBuffer.GetRowByOffset(0);
+    VERIFY_ARE_EQUAL(L"   ", row.GetText().substr(0, 3));
+    VERIFY_ARE_EQUAL(TextAttribute{}, row.GetAttrByColumn(0));
+
+    stateMachine.ProcessString(L"\x1b[?1049l");
+    VERIFY_IS_FALSE(gci.GetActiveOutputBuffer()._IsAltBuffer());
+}
+
 void ScreenBufferTests::SetDefaultsIndividuallyBothDefault()
 {
     // Tests MSFT:19828103
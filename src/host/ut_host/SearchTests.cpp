@@ -201,4 +201,25 @@ class SearchTests
         s.Reset(gci.renderData, L"(?i)ab", SearchFlag::RegularExpression, false);
         DoFoundChecks(s, {}, 1, false);
     }
+
+    TEST_METHOD(ForwardCaseSensitiveRefined)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Log::Comment(L"Extending the needle refines the previous results instead of searching the entire buffer.");
+        Search s;
+        s.Reset(gci.renderData, L"A", SearchFlag::None, false);
+        VERIFY_IS_FALSE(s.Results().empty());
+        s.Reset(gci.renderData, L"AB", SearchFlag::None, false);
+        DoFoundChecks(s, {}, 1, false);
+
+        Search expected;
+        expected.Reset(gci.renderData, L"AB", SearchFlag::None, false);
+        VERIFY_ARE_EQUAL(expected.Results().size(), s.Results().size());
+        for (size_t i = 0; i < expected.Results().size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expected.Results()[i].start, s.Results()[i].start);
+            VERIFY_ARE_EQUAL(expected.Results()[i].end, s.Results()[i].end);
+        }
+    }
 };
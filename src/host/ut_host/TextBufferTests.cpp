@@ -12,6 +12,7 @@
 
 #include "globals.h"
 #include "../buffer/out/textBuffer.hpp"
+#include "../buffer/out/search.h"
 
 #include "input.h"
 #include "_stream.h"
@@ -153,6 +154,20 @@ class TextBufferTests
     TEST_METHOD(NoHyperlinkTrim);
 
     TEST_METHOD(ReflowPromptRegions);
+
+    TEST_METHOD(ColdScrollbackRoundTrip);
+    TEST_METHOD(CompactRowsAboveIgnoresThreshold);
+    TEST_METHOD(ColdScrollbackFileBackedRoundTrip);
+    TEST_METHOD(ImageRoundTrip);
+    TEST_METHOD(ClearScrollbackDecommitsRows);
+    TEST_METHOD(InternedAttributesAreSwept);
+    TEST_METHOD(RowsChangedSinceRevision);
+    TEST_METHOD(RowContentHash);
+    TEST_METHOD(MarkRowsFollowCircularBuffer);
+    TEST_METHOD(CommandOutputIndex);
+    TEST_METHOD(RetainedScrollback);
+    TEST_METHOD(TryWriteCharInfosMatchesWriteLine);
+    TEST_METHOD(FillMatchesWrite);
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -2724,20 +2739,26 @@ void TextBufferTests::HyperlinkTrim()
     _buffer->GetMutableRowByOffset(otherPos.y).SetAttrToEnd(otherPos.x, newAttr);
     _buffer->AddHyperlinkToMap(otherUrl, otherId);
 
+    // Unused links are swept in batches. Add enough of them to make the next increment sweep.
+    while (!_buffer->_hyperlinks.WantsSweep())
+    {
+        _buffer->GetHyperlinkId(url, {});
+    }
+
     // Increment the circular buffer
     _buffer->IncrementCircularBuffer();
 
-    const auto finalCustomId = fmt::format(L"{}%{}", customId, til::hash(url));
     const auto finalOtherCustomId = fmt::format(L"{}%{}", otherCustomId, til::hash(otherUrl));
 
     // The hyperlink reference that was only in the first row should be deleted from the map
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkMap.find(id), _buffer->_hyperlinkMap.end());
+    VERIFY_IS_FALSE(_buffer->_hyperlinks.Contains(id));
     // Since there was a custom id, that should be deleted as well
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap.find(finalCustomId), _buffer->_hyperlinkCustomIdMap.end());
+    VERIFY_ARE_NOT_EQUAL(id, _buffer->GetHyperlinkId(url, customId));
 
     // The other hyperlink reference should not be deleted
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkMap[otherId], otherUrl);
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalOtherCustomId], otherId);
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(otherId), otherUrl);
+    VERIFY_ARE_EQUAL(_buffer->GetCustomIdFromId(otherId), finalOtherCustomId);
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkId(otherUrl, otherCustomId), otherId);
 }
 
 // This tests that when we increment the circular buffer, non-obsolete hyperlink references
@@ -2765,6 +2786,12 @@ void TextBufferTests::NoHyperlinkTrim()
     const til::point otherPos{ 70, 5 };
     _buffer->GetMutableRowByOffset(otherPos.y).SetAttrToEnd(otherPos.x, newAttr);
 
+    // Unused links are swept in batches. Add enough of them to make the next increment sweep.
+    while (!_buffer->_hyperlinks.WantsSweep())
+    {
+        _buffer->GetHyperlinkId(url, {});
+    }
+
     // Increment the circular buffer
     _buffer->IncrementCircularBuffer();
 
@@ -2772,7 +2799,8 @@ void TextBufferTests::NoHyperlinkTrim()
 
     // The hyperlink reference should not be deleted from the map since it is still present in the buffer
     VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
-    VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalCustomId], id);
+    VERIFY_ARE_EQUAL(_buffer->GetCustomIdFromId(id), finalCustomId);
+    VERIFY_ARE_EQUAL(_buffer->GetHyperlinkId(url, customId), id);
 }
 
 #define FTCS_A L"\x1b]133;A\x1b\\"
@@ -2900,3 +2928,584 @@ void TextBufferTests::ReflowPromptRegions()
     Log::Comment(L"========== Checking the host buffer state (after) ==========");
     verifyBuffer(*newBuffer, si.GetViewport().ToExclusive(), false, true);
 }
+
+void TextBufferTests::ColdScrollbackRoundTrip()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 2000;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    buffer.SetColdScrollbackThreshold(100);
+
+    const TextAttribute red{ FOREGROUND_RED };
+    std::vector<std::wstring> expectedText;
+    expectedText.reserve(height);
+
+    Log::Comment(L"Fill the buffer with narrow, wide and surrogate pair characters, as well as attributes.");
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        buffer.GetCursor().SetYPosition(y);
+
+        auto& row = buffer.GetMutableRowByOffset(y);
+        row.ReplaceCharacters(0, 1, std::wstring_view{ &L"0123456789"[y % 10], 1 });
+        row.ReplaceCharacters(4, 1, y % 2 ? L"\u00e4" : L"\u0444");
+        row.ReplaceCharacters(10, 2, L"\u304b");
+        if (y % 3 == 0)
+        {
+            row.ReplaceCharacters(14, 2, L"\U0001F600");
+            row.SetWrapForced(true);
+        }
+        if (y % 2)
+        {
+            row.SetAttrToEnd(5, red);
+        }
+        expectedText.emplace_back(row.GetText());
+    }
+
+    VERIFY_IS_GREATER_THAN(buffer._coldChunkCount, 0u);
+    VERIFY_IS_NOT_NULL(buffer._getPackedRow(height / 2));
+    VERIFY_IS_NULL(buffer._getPackedRow(height - 1));
+
+    Log::Comment(L"Verify that rows round-trip through the cold scrollback tier unchanged.");
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        const auto& row = buffer.GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(expectedText[y], row.GetText());
+        VERIFY_ARE_EQUAL(y % 3 == 0, row.WasWrapForced());
+        VERIFY_ARE_EQUAL(TextAttribute{ 0x7 }, row.GetAttrByColumn(0));
+        VERIFY_ARE_EQUAL(y % 2 ? red : TextAttribute{ 0x7 }, row.GetAttrByColumn(width - 1));
+    }
+
+    VERIFY_ARE_EQUAL(0u, buffer._coldChunkCount);
+}
+
+void TextBufferTests::ImageRoundTrip()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 50;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+
+    auto link = TextAttribute{ FOREGROUND_GREEN };
+    link.SetHyperlinkId(buffer.GetHyperlinkId(L"https://example.com", L"custom"));
+    const TextAttribute red{ FOREGROUND_RED };
+    std::vector<std::wstring> expectedText;
+
+    Log::Comment(L"Fill the buffer with narrow, wide and surrogate pair characters, attributes, marks and a hyperlink.");
+    for (til::CoordType y = 0; y < 30; ++y)
+    {
+        auto& row = buffer.GetMutableRowByOffset(y);
+        row.ReplaceCharacters(0, 1, std::wstring_view{ &L"0123456789"[y % 10], 1 });
+        row.ReplaceCharacters(4, 1, y % 2 ? L"\u00e4" : L"\u0444");
+        if (y % 3 == 0)
+        {
+            row.ReplaceCharacters(10, 2, L"\u304b");
+            row.ReplaceCharacters(14, 2, L"\U0001F600");
+            row.SetWrapForced(true);
+        }
+        if (y % 2)
+        {
+            row.SetAttrToEnd(5, red);
+        }
+        expectedText.emplace_back(row.GetText());
+    }
+    buffer.GetMutableRowByOffset(7).ReplaceAttributes(0, 3, link);
+    buffer.GetMutableRowByOffset(9).SetScrollbarData(ScrollbarData{ MarkCategory::Prompt, til::color{ 0x12, 0x34, 0x56 }, 1u });
+
+    const auto image = buffer.SerializeImage();
+    const auto size = TextBuffer::GetImageSize(image);
+    VERIFY_IS_TRUE(size.has_value());
+    VERIFY_ARE_EQUAL((til::size{ width, 31 }), *size);
+
+    TextBuffer restored{ *size, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    restored.LoadImage(image);
+    VERIFY_ARE_EQUAL((til::point{ 0, 30 }), restored.GetCursor().GetPosition());
+
+    Log::Comment(L"Verify that rows round-trip through the image unchanged.");
+    for (til::CoordType y = 0; y < 30; ++y)
+    {
+        const auto& row = restored.GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(expectedText[y], row.GetText());
+        VERIFY_ARE_EQUAL(y % 3 == 0, row.WasWrapForced());
+        VERIFY_ARE_EQUAL(y % 2 ? red : TextAttribute{ 0x7 }, row.GetAttrByColumn(width - 1));
+    }
+
+    const auto restoredLink = restored.GetRowByOffset(7).GetAttrByColumn(0);
+    VERIFY_IS_TRUE(restoredLink.IsHyperlink());
+    VERIFY_ARE_EQUAL(L"https://example.com", restored.GetHyperlinkUriFromId(restoredLink.GetHyperlinkId()));
+    VERIFY_ARE_EQUAL(L"custom", restored.GetCustomIdFromId(restoredLink.GetHyperlinkId()));
+
+    const auto& mark = restored.GetRowByOffset(9).GetScrollbarData();
+    VERIFY_IS_TRUE(mark.has_value());
+    VERIFY_IS_TRUE(mark->category == MarkCategory::Prompt);
+    VERIFY_IS_TRUE(mark->color == til::color{ 0x12, 0x34, 0x56 });
+    VERIFY_ARE_EQUAL(1u, mark->exitCode.value());
+
+    Log::Comment(L"Truncated images are rejected instead of being partially loaded.");
+    TextBuffer truncated{ *size, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    VERIFY_THROWS(truncated.LoadImage({ image.data(), image.size() - 1 }), wil::ResultException);
+
+    Log::Comment(L"Anything else isn't an image.");
+    static constexpr wchar_t text[]{ L"\uFEFFhello" };
+    VERIFY_IS_FALSE(TextBuffer::GetImageSize(std::as_bytes(std::span{ text })).has_value());
+}
+
+void TextBufferTests::CompactRowsAboveIgnoresThreshold()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 2000;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    VERIFY_ARE_EQUAL(0, buffer.GetColdScrollbackThreshold());
+
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        buffer.GetCursor().SetYPosition(y);
+        buffer.GetMutableRowByOffset(y).ReplaceCharacters(0, 1, std::wstring_view{ &L"0123456789"[y % 10], 1 });
+    }
+
+    Log::Comment(L"Without a threshold, nothing gets evicted on its own.");
+    VERIFY_ARE_EQUAL(0u, buffer._coldChunkCount);
+
+    buffer.CompactRowsAbove(height - 30);
+    VERIFY_IS_GREATER_THAN(buffer._coldChunkCount, 0u);
+    VERIFY_IS_NOT_NULL(buffer._getPackedRow(height / 2));
+    VERIFY_IS_NULL(buffer._getPackedRow(height - 30));
+    VERIFY_IS_NULL(buffer._getPackedRow(height - 1));
+
+    Log::Comment(L"Compacted rows get rehydrated when they're accessed again.");
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        VERIFY_ARE_EQUAL(std::wstring(1, L"0123456789"[y % 10]), buffer.GetRowByOffset(y).GetText().substr(0, 1));
+    }
+
+    VERIFY_ARE_EQUAL(0u, buffer._coldChunkCount);
+}
+
+void TextBufferTests::RowsChangedSinceRevision()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 300;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    const auto initial = buffer.GetLastMutationId();
+    VERIFY_ARE_EQUAL(0u, buffer.GetRowsChangedSince(initial).size());
+
+    Log::Comment(L"Modified rows are reported, with adjacent rows merged into one range.");
+    buffer.GetMutableRowByOffset(3).ReplaceCharacters(0, 1, L"a");
+    buffer.GetMutableRowByOffset(4).ReplaceCharacters(0, 1, L"b");
+    buffer.GetMutableRowByOffset(250).ReplaceCharacters(0, 1, L"c");
+
+    auto ranges = buffer.GetRowsChangedSince(initial);
+    VERIFY_ARE_EQUAL(2u, ranges.size());
+    VERIFY_ARE_EQUAL(3, ranges[0].begin);
+    VERIFY_ARE_EQUAL(5, ranges[0].end);
+    VERIFY_ARE_EQUAL(250, ranges[1].begin);
+    VERIFY_ARE_EQUAL(251, ranges[1].end);
+    VERIFY_IS_GREATER_THAN(buffer.GetRowRevision(3), initial);
+    VERIFY_ARE_EQUAL(initial, buffer.GetRowRevision(5));
+
+    Log::Comment(L"Only rows modified after the given revision are reported.");
+    const auto revision = buffer.GetLastMutationId();
+    buffer.GetMutableRowByOffset(100).ReplaceCharacters(0, 1, L"d");
+    ranges = buffer.GetRowsChangedSince(revision);
+    VERIFY_ARE_EQUAL(1u, ranges.size());
+    VERIFY_ARE_EQUAL(100, ranges[0].begin);
+    VERIFY_ARE_EQUAL(101, ranges[0].end);
+
+    Log::Comment(L"Rows keep their revision when the circular buffer rotates.");
+    buffer.IncrementCircularBuffer();
+    ranges = buffer.GetRowsChangedSince(revision);
+    VERIFY_ARE_EQUAL(2u, ranges.size());
+    VERIFY_ARE_EQUAL(99, ranges[0].begin);
+    VERIFY_ARE_EQUAL(height - 1, ranges[1].begin);
+    VERIFY_ARE_EQUAL(height, ranges[1].end);
+
+    Log::Comment(L"Resetting the buffer marks all rows as changed.");
+    const auto beforeReset = buffer.GetLastMutationId();
+    buffer.Reset();
+    ranges = buffer.GetRowsChangedSince(beforeReset);
+    VERIFY_ARE_EQUAL(1u, ranges.size());
+    VERIFY_ARE_EQUAL(0, ranges[0].begin);
+    VERIFY_ARE_EQUAL(height, ranges[0].end);
+}
+
+void TextBufferTests::RowContentHash()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 10;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    TextBuffer other{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    const auto blank = buffer.GetRowContentHash(0);
+    VERIFY_ARE_EQUAL(blank, buffer.GetRowContentHash(1));
+
+    Log::Comment(L"Writing text, attributes or the line rendition changes the hash.");
+    buffer.GetMutableRowByOffset(1).ReplaceCharacters(0, 1, L"a");
+    const auto text = buffer.GetRowContentHash(1);
+    VERIFY_ARE_NOT_EQUAL(blank, text);
+
+    buffer.GetMutableRowByOffset(1).ReplaceAttributes(0, 1, TextAttribute{ 0x1e });
+    const auto attributes = buffer.GetRowContentHash(1);
+    VERIFY_ARE_NOT_EQUAL(text, attributes);
+
+    buffer.GetMutableRowByOffset(1).SetLineRendition(LineRendition::DoubleWidth);
+    VERIFY_ARE_NOT_EQUAL(attributes, buffer.GetRowContentHash(1));
+
+    Log::Comment(L"A narrow and a wide glyph with the same text hash differently.");
+    buffer.GetMutableRowByOffset(2).ReplaceCharacters(0, 1, L"\x4e00");
+    buffer.GetMutableRowByOffset(3).ReplaceCharacters(0, 2, L"\x4e00");
+    VERIFY_ARE_NOT_EQUAL(buffer.GetRowContentHash(2), buffer.GetRowContentHash(3));
+
+    Log::Comment(L"Rows with the same contents hash equally, even across buffers.");
+    other.GetMutableRowByOffset(5).ReplaceCharacters(0, 1, L"a");
+    other.GetMutableRowByOffset(5).ReplaceAttributes(0, 1, TextAttribute{ 0x1e });
+    buffer.GetMutableRowByOffset(1).SetLineRendition(LineRendition::SingleWidth);
+    VERIFY_ARE_EQUAL(buffer.GetRowContentHash(1), other.GetRowContentHash(5));
+    VERIFY_ARE_EQUAL(blank, other.GetRowContentHash(0));
+}
+
+void TextBufferTests::MarkRowsFollowCircularBuffer()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 10;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    // Touch all rows, so that they're committed.
+    buffer.GetMutableRowByOffset(height - 1);
+
+    for (const auto y : { 7, 1, 4 })
+    {
+        buffer.GetCursor().SetYPosition(y);
+        buffer.StartPrompt();
+    }
+
+    auto marks = buffer.GetMarkRows();
+    VERIFY_ARE_EQUAL(3u, marks.size());
+    VERIFY_ARE_EQUAL(1, marks[0].row);
+    VERIFY_ARE_EQUAL(4, marks[1].row);
+    VERIFY_ARE_EQUAL(7, marks[2].row);
+
+    Log::Comment(L"Marks move up as the circular buffer rotates and disappear once they scroll out.");
+    buffer.IncrementCircularBuffer();
+    buffer.IncrementCircularBuffer();
+    buffer.GetCursor().SetYPosition(height - 1);
+    buffer.StartPrompt();
+
+    marks = buffer.GetMarkRows();
+    VERIFY_ARE_EQUAL(3u, marks.size());
+    VERIFY_ARE_EQUAL(2, marks[0].row);
+    VERIFY_ARE_EQUAL(5, marks[1].row);
+    VERIFY_ARE_EQUAL(height - 1, marks[2].row);
+
+    Log::Comment(L"The exit code is set on the closest prompt above the cursor.");
+    buffer.GetCursor().SetYPosition(6);
+    buffer.EndCurrentCommand(1);
+    marks = buffer.GetMarkRows();
+    VERIFY_ARE_EQUAL(MarkCategory::Error, marks[1].data.category);
+    VERIFY_ARE_EQUAL(MarkCategory::Prompt, marks[2].data.category);
+
+    buffer.ClearAllMarks();
+    VERIFY_ARE_EQUAL(0u, buffer.GetMarkRows().size());
+}
+
+void TextBufferTests::CommandOutputIndex()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 10;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    // Touch all rows, so that they're committed.
+    buffer.GetMutableRowByOffset(height - 1);
+
+    const auto write = [&](til::CoordType x, til::CoordType y, std::wstring_view text) {
+        buffer.GetCursor().SetPosition({ x, y });
+        RowWriteState state{ .text = text, .columnBegin = x };
+        buffer.Replace(y, buffer.GetCurrentAttributes(), state);
+    };
+    const auto command = [&](til::CoordType y, std::wstring_view commandLine, std::initializer_list<std::wstring_view> output, unsigned int exitCode) {
+        buffer.GetCursor().SetPosition({ 0, y });
+        buffer.StartPrompt();
+        write(0, y, L"PS> ");
+        buffer.StartCommand();
+        write(4, y, commandLine);
+        buffer.StartOutput();
+        for (const auto& line : output)
+        {
+            write(0, ++y, line);
+        }
+        buffer.EndCurrentCommand(exitCode);
+    };
+
+    command(0, L"build", { L"error: foo", L"ok" }, 1);
+    command(3, L"test", { L"error: bar" }, 0);
+    buffer.GetCursor().SetPosition({ 0, 5 });
+    buffer.StartPrompt();
+    write(0, 5, L"PS> ");
+
+    auto marks = buffer.GetMarkExtents();
+    VERIFY_ARE_EQUAL(3u, marks.size());
+    VERIFY_ARE_EQUAL((til::point{ 9, 0 }), *marks[0].commandEnd);
+    VERIFY_ARE_EQUAL((til::point{ 2, 2 }), *marks[0].outputEnd);
+    VERIFY_ARE_EQUAL(1u, *marks[0].data.exitCode);
+    VERIFY_ARE_EQUAL((til::point{ 10, 4 }), *marks[1].outputEnd);
+    VERIFY_IS_FALSE(marks[2].HasOutput());
+
+    const auto output = buffer.GetCommandOutput(marks[0]);
+    VERIFY_ARE_NOT_EQUAL(std::wstring::npos, output.find(L"error: foo"));
+    VERIFY_ARE_NOT_EQUAL(std::wstring::npos, output.find(L"ok"));
+    VERIFY_ARE_EQUAL(std::wstring::npos, output.find(L"build"));
+
+    Log::Comment(L"Only the output of the given number of most recent prompts is searched.");
+    VERIFY_ARE_EQUAL(0u, buffer.SearchCommandOutputs(L"error", SearchFlag::None, 1)->size());
+    VERIFY_ARE_EQUAL(1u, buffer.SearchCommandOutputs(L"error", SearchFlag::None, 2)->size());
+    VERIFY_ARE_EQUAL(2u, buffer.SearchCommandOutputs(L"error", SearchFlag::None, SIZE_T_MAX)->size());
+    VERIFY_ARE_EQUAL(0u, buffer.SearchCommandOutputs(L"test", SearchFlag::None, SIZE_T_MAX)->size());
+
+    Log::Comment(L"The cached extents are updated when the output of a command changes.");
+    {
+        auto attr = buffer.GetCurrentAttributes();
+        attr.SetMarkAttributes(MarkKind::Output);
+        RowWriteState state{ .text = L"okay" };
+        buffer.Replace(2, attr, state);
+    }
+    marks = buffer.GetMarkExtents();
+    VERIFY_ARE_EQUAL((til::point{ 4, 2 }), *marks[0].outputEnd);
+
+    Log::Comment(L"The cached extents move up as the circular buffer rotates.");
+    buffer.IncrementCircularBuffer();
+    marks = buffer.GetMarkExtents();
+    VERIFY_ARE_EQUAL(2u, marks.size());
+    VERIFY_ARE_EQUAL((til::point{ 0, 2 }), marks[0].start);
+    VERIFY_ARE_EQUAL((til::point{ 10, 3 }), *marks[0].outputEnd);
+}
+
+void TextBufferTests::RetainedScrollback()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 10;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    buffer.SetRetainedScrollbackSize(64 * 1024);
+    buffer.GetMutableRowByOffset(height - 1);
+
+    const auto write = [&](til::CoordType x, til::CoordType y, std::wstring_view text) {
+        buffer.GetCursor().SetPosition({ x, y });
+        RowWriteState state{ .text = text, .columnBegin = x };
+        buffer.Replace(y, buffer.GetCurrentAttributes(), state);
+    };
+    const auto command = [&](til::CoordType y, std::wstring_view commandLine, std::initializer_list<std::wstring_view> output, unsigned int exitCode) {
+        buffer.GetCursor().SetPosition({ 0, y });
+        buffer.StartPrompt();
+        write(0, y, L"PS> ");
+        buffer.StartCommand();
+        write(4, y, commandLine);
+        buffer.StartOutput();
+        for (const auto& line : output)
+        {
+            write(0, ++y, line);
+        }
+        buffer.EndCurrentCommand(exitCode);
+    };
+
+    command(0, L"build", { L"error: foo", L"error: foo", L"error: foo", L"ok" }, 1);
+    command(5, L"test", { L"fine" }, 0);
+    buffer.SetScrollbarData({ .category = MarkCategory::Default }, 7);
+    write(0, 7, L"bookmarked");
+
+    for (auto i = 0; i < 8; ++i)
+    {
+        buffer.IncrementCircularBuffer(buffer.GetCurrentAttributes());
+    }
+
+    Log::Comment(L"The failed command and the bookmark are retained, the successful command isn't.");
+    VERIFY_ARE_EQUAL(std::wstring{ L"PS> build\r\nerror: foo\r\n[repeated 2 more times]\r\nok\r\nbookmarked\r\n" }, buffer.GetRetainedScrollbackText());
+
+    Log::Comment(L"Shrinking the budget evicts the oldest rows.");
+    buffer.SetRetainedScrollbackSize(1);
+    VERIFY_ARE_EQUAL(std::wstring{}, buffer.GetRetainedScrollbackText());
+}
+
+void TextBufferTests::TryWriteCharInfosMatchesWriteLine()
+{
+    static constexpr til::size bufferSize{ 10, 2 };
+    TextBuffer buffer{ bufferSize, TextAttribute{ 0x7 }, 12, false, &_renderer };
+
+    // Both rows start out with a wide glyph in columns 3-4, whose trailing half gets overwritten.
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        RowWriteState state{ .text = L"\u3042", .columnBegin = 3 };
+        buffer.Replace(y, TextAttribute{ 0x7 }, state);
+    }
+
+    const std::array infos{
+        CHAR_INFO{ { L'a' }, 0x1f },
+        CHAR_INFO{ { L'b' }, 0x1f },
+        CHAR_INFO{ { L'c' }, 0x2e },
+    };
+    VERIFY_IS_TRUE(buffer.TryWriteCharInfos({ 4, 0 }, infos));
+    buffer.WriteLine(OutputCellIterator{ infos }, { 4, 1 });
+
+    const auto& fast = buffer.GetRowByOffset(0);
+    const auto& slow = buffer.GetRowByOffset(1);
+    VERIFY_ARE_EQUAL(L"    abc   ", fast.GetText());
+    VERIFY_ARE_EQUAL(slow.GetText(), fast.GetText());
+    for (til::CoordType x = 0; x < bufferSize.width; ++x)
+    {
+        VERIFY_ARE_EQUAL(slow.GetAttrByColumn(x), fast.GetAttrByColumn(x));
+        VERIFY_IS_TRUE(slow.DbcsAttrAt(x) == fast.DbcsAttrAt(x));
+    }
+
+    Log::Comment(L"DBCS halves aren't supported and leave the row untouched.");
+    const std::array wide{
+        CHAR_INFO{ { L'\u3042' }, COMMON_LVB_LEADING_BYTE | 0x7 },
+        CHAR_INFO{ { L'\u3042' }, COMMON_LVB_TRAILING_BYTE | 0x7 },
+    };
+    VERIFY_IS_FALSE(buffer.TryWriteCharInfos({ 0, 0 }, wide));
+    VERIFY_ARE_EQUAL(L"    abc   ", fast.GetText());
+}
+
+void TextBufferTests::FillMatchesWrite()
+{
+    static constexpr til::size bufferSize{ 10, 4 };
+    static constexpr til::point target{ 7, 0 };
+    // Covers the end of the first row, the entire second row and half of the third one.
+    static constexpr size_t count = 18;
+    static constexpr wchar_t fill = L'x';
+    const TextAttribute attributes{ 0x1e };
+
+    TextBuffer fast{ bufferSize, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    TextBuffer slow{ bufferSize, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    for (auto buffer : { &fast, &slow })
+    {
+        // A wide glyph whose leading half gets overwritten and rows that are wrapped.
+        RowWriteState state{ .text = L"\u3042", .columnBegin = 4 };
+        buffer->Replace(2, TextAttribute{ 0x7 }, state);
+        buffer->GetMutableRowByOffset(0).SetWrapForced(true);
+        buffer->GetMutableRowByOffset(1).SetWrapForced(true);
+    }
+
+    VERIFY_ARE_EQUAL(18, fast.FillNarrowText(target, fill, count));
+    VERIFY_ARE_EQUAL(18, fast.FillAttributes(target, attributes, count));
+    slow.Write(OutputCellIterator{ fill, count }, target, false);
+    slow.Write(OutputCellIterator{ attributes, count }, target, false);
+
+    VERIFY_ARE_EQUAL(L"xxxxx     ", fast.GetRowByOffset(2).GetText());
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        const auto& a = fast.GetRowByOffset(y);
+        const auto& b = slow.GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(b.GetText(), a.GetText());
+        VERIFY_ARE_EQUAL(b.WasWrapForced(), a.WasWrapForced());
+        for (til::CoordType x = 0; x < bufferSize.width; ++x)
+        {
+            VERIFY_ARE_EQUAL(b.GetAttrByColumn(x), a.GetAttrByColumn(x));
+        }
+    }
+
+    Log::Comment(L"The fill stops at the end of the buffer.");
+    VERIFY_ARE_EQUAL(bufferSize.width, fast.FillNarrowText({ 0, bufferSize.height - 1 }, fill, 100));
+}
+
+void TextBufferTests::ColdScrollbackFileBackedRoundTrip()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 2000;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    buffer.SetColdScrollbackThreshold(100);
+    buffer.SetColdScrollbackFileBacked(true);
+
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        buffer.GetCursor().SetYPosition(y);
+        auto& row = buffer.GetMutableRowByOffset(y);
+        row.ReplaceCharacters(0, 1, std::wstring_view{ &L"0123456789"[y % 10], 1 });
+        row.ReplaceCharacters(4, 2, L"\u304b");
+    }
+
+    VERIFY_IS_GREATER_THAN(buffer._coldChunkCount, 0u);
+    const auto packed = buffer._getPackedRow(height / 2);
+    VERIFY_IS_NOT_NULL(packed);
+    VERIFY_IS_NULL(packed->data.get());
+    VERIFY_IS_NOT_NULL(packed->mappedData);
+
+    Log::Comment(L"Rows stored in the temporary file are restored unchanged.");
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        const auto text = buffer.GetRowByOffset(y).GetText();
+        VERIFY_ARE_EQUAL(L"0123456789"[y % 10], text[0]);
+        VERIFY_ARE_EQUAL(L'\u304b', text[4]);
+    }
+
+    VERIFY_ARE_EQUAL(0u, buffer._coldChunkCount);
+}
+
+void TextBufferTests::ClearScrollbackDecommitsRows()
+{
+    static constexpr til::CoordType width = 20;
+    static constexpr til::CoordType height = 2000;
+    static constexpr til::CoordType top = 1500;
+    static constexpr til::CoordType rowsToKeep = 30;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+    buffer.SetColdScrollbackThreshold(100);
+
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        buffer.GetCursor().SetYPosition(y);
+        buffer.GetMutableRowByOffset(y).ReplaceCharacters(0, 1, std::wstring_view{ &L"0123456789"[y % 10], 1 });
+    }
+
+    VERIFY_IS_GREATER_THAN(buffer._coldChunkCount, 0u);
+    const auto revision = buffer.GetLastMutationId();
+
+    buffer.ClearScrollback(top, rowsToKeep);
+
+    Log::Comment(L"The cold rows are dropped without being rehydrated and the rest of the buffer is decommitted.");
+    VERIFY_ARE_EQUAL(0u, buffer._coldChunkCount);
+    VERIFY_ARE_EQUAL(rowsToKeep, buffer._estimateOffsetOfLastCommittedRow() + 1);
+
+    for (til::CoordType y = 0; y < rowsToKeep; ++y)
+    {
+        VERIFY_ARE_EQUAL(std::wstring(1, L"0123456789"[(top + y) % 10]), buffer.GetRowByOffset(y).GetText().substr(0, 1));
+    }
+    for (til::CoordType y = rowsToKeep; y < height; y += 97)
+    {
+        VERIFY_ARE_EQUAL(std::wstring(width, L' '), buffer.GetRowByOffset(y).GetText());
+        VERIFY_IS_GREATER_THAN(buffer.GetRowRevision(y), revision);
+    }
+}
+
+void TextBufferTests::InternedAttributesAreSwept()
+{
+    static constexpr til::CoordType width = 10;
+    static constexpr til::CoordType height = 10;
+    static constexpr int iterations = 10000;
+
+    TextBuffer buffer{ { width, height }, TextAttribute{ 0x7 }, 12, false, &_renderer };
+
+    const auto makeAttr = [](int i) {
+        TextAttribute attr;
+        attr.SetForeground(RGB(i & 0xff, (i >> 8) & 0xff, 0));
+        return attr;
+    };
+
+    Log::Comment(L"Scroll through a lot of distinct attributes, while only a few of them are alive at any time.");
+    for (auto i = 0; i < iterations; ++i)
+    {
+        buffer.GetMutableRowByOffset(height - 1).SetAttrToEnd(0, makeAttr(i));
+        buffer.IncrementCircularBuffer(TextAttribute{});
+    }
+
+    Log::Comment(L"Entries of attributes that scrolled out of the buffer should have been reused.");
+    VERIFY_IS_LESS_THAN(buffer._attrTable->Capacity(), static_cast<size_t>(iterations / 2));
+
+    Log::Comment(L"The attributes that are still alive must have survived all sweeps.");
+    for (til::CoordType y = 0; y < height - 1; ++y)
+    {
+        const auto expected = makeAttr(iterations - height + 1 + y);
+        VERIFY_ARE_EQUAL(expected, buffer.GetRowByOffset(y).GetAttrByColumn(0));
+        VERIFY_ARE_EQUAL(expected, buffer.GetRowByOffset(y).GetAttrByColumn(width - 1));
+    }
+}
@@ -275,6 +275,36 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         VERIFY_ARE_EQUAL(expected, actual);
     }
 
+    TEST_METHOD(WriteConsoleOutputWUnchanged)
+    {
+        resetContents();
+
+        std::array payload{ ci_red('a'), ci_red('b'), ci_blu('A'), ci_blu('B'), ci_red('c'), ci_red('d'), ci_blu('C'), ci_blu('D') };
+        const auto target = Viewport::FromDimensions({ 0, 1 }, { 8, 1 });
+        Viewport written;
+        std::string_view expected;
+        std::string_view actual;
+
+        THROW_IF_FAILED(routines.WriteConsoleOutputWImpl(*screenInfo, payload, target, written));
+        expected = decsc() cup(2, 1) sgr_red("ab") sgr_blu("AB") sgr_red("cd") sgr_blu("CD") decrc();
+        actual = readOutput();
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        // Repainting the same contents shouldn't emit anything.
+        THROW_IF_FAILED(routines.WriteConsoleOutputWImpl(*screenInfo, payload, target, written));
+        expected = "";
+        actual = readOutput();
+        VERIFY_ARE_EQUAL(expected, actual);
+
+        // Only the changed cells should be emitted. Runs that are close together are merged.
+        til::at(payload, 1) = ci_blu('x');
+        til::at(payload, 3) = ci_red('y');
+        THROW_IF_FAILED(routines.WriteConsoleOutputWImpl(*screenInfo, payload, target, written));
+        expected = decsc() cup(2, 2) sgr_blu("xA") sgr_red("y") decrc();
+        actual = readOutput();
+        VERIFY_ARE_EQUAL(expected, actual);
+    }
+
     TEST_METHOD(WriteConsoleOutputAttribute)
     {
         setupInitialContents();
@@ -815,4 +845,73 @@ class ::Microsoft::Console::VirtualTerminal::VtIoTests
         const auto actual = readOutput();
         VERIFY_ARE_EQUAL(expected, actual);
     }
+
+    TEST_METHOD(NestedWriters)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        THROW_IF_FAILED(routines.SetConsoleCursorPositionImpl(*screenInfo, { 7, 3 }));
+        readOutput();
+
+        {
+            auto outer = gci.GetVtWriter();
+
+            // Nothing is flushed while an outer writer holds the output corked.
+            THROW_IF_FAILED(routines.SetConsoleCursorPositionImpl(*screenInfo, { 2, 3 }));
+            VERIFY_ARE_EQUAL(std::string_view{}, readOutput());
+
+            // A nested writer that doesn't submit (e.g. due to an exception)
+            // only discards its own output and not that of the outer writer.
+            {
+                const auto inner = gci.GetVtWriter();
+                inner.WriteUTF8("discarded");
+            }
+
+            THROW_IF_FAILED(routines.SetConsoleCursorPositionImpl(*screenInfo, { 0, 0 }));
+            outer.Submit();
+        }
+
+        const auto expected = cup(4, 3) cup(1, 1);
+        const auto actual = readOutput();
+        VERIFY_ARE_EQUAL(expected, actual);
+    }
+
+    TEST_METHOD(CoalescedFlush)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& io = *gci.GetVtIo();
+
+        // Our test pipe isn't overlapped, so coalescing isn't enabled by default.
+        // The long delay ensures that the timer doesn't fire in the middle of the test.
+        io._flushTimer.reset(CreateThreadpoolTimer(&VtIo::_flushTimerCallback, &io, nullptr));
+        io._coalesceDelay = std::chrono::minutes{ 1 };
+        const auto cleanup = wil::scope_exit([&]() {
+            SetThreadpoolTimer(io._flushTimer.get(), nullptr, 0, 0);
+            WaitForThreadpoolTimerCallbacks(io._flushTimer.get(), TRUE);
+            io._flushTimer.reset();
+            io._coalesceDelay = std::chrono::microseconds{ 1000 };
+            io._flushScheduled = false;
+            io._lastFlush = {};
+        });
+
+        const auto before = io.GetFlushStatistics();
+
+        // The first write after a pause is flushed immediately...
+        THROW_IF_FAILED(routines.SetConsoleCursorPositionImpl(*screenInfo, { 2, 3 }));
+        VERIFY_ARE_EQUAL(cup(4, 3), readOutput());
+
+        // ...but the ones following it shortly after are held back...
+        THROW_IF_FAILED(routines.SetConsoleCursorPositionImpl(*screenInfo, { 0, 0 }));
+        THROW_IF_FAILED(routines.SetConsoleCursorPositionImpl(*screenInfo, { 7, 3 }));
+        VERIFY_ARE_EQUAL(std::string_view{}, readOutput());
+
+        // ...until the client looks for input.
+        ULONG events = 0;
+        THROW_IF_FAILED(routines.GetNumberOfConsoleInputEventsImpl(*gci.pInputBuffer, events));
+        VERIFY_ARE_EQUAL(cup(1, 1) cup(4, 8), readOutput());
+
+        const auto after = io.GetFlushStatistics();
+        VERIFY_ARE_EQUAL(uint64_t{ 2 }, after.writes - before.writes);
+        VERIFY_ARE_EQUAL(uint64_t{ 2 }, after.coalesced - before.coalesced);
+    }
 };
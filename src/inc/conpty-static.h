@@ -34,8 +34,19 @@
 #define PSEUDOCONSOLE_GLYPH_WIDTH_CONSOLE 0x18
 #endif
 
+#ifndef _CONPTY_OUTPUT_RING_DEFINED
+#define _CONPTY_OUTPUT_RING_DEFINED
+typedef struct _CONPTY_OUTPUT_RING
+{
+    HANDLE hSection;
+    HANDLE hDataEvent;
+    HANDLE hSpaceEvent;
+} CONPTY_OUTPUT_RING;
+#endif
+
 CONPTY_EXPORT HRESULT WINAPI ConptyCreatePseudoConsole(COORD size, HANDLE hInput, HANDLE hOutput, DWORD dwFlags, HPCON* phPC);
 CONPTY_EXPORT HRESULT WINAPI ConptyCreatePseudoConsoleAsUser(HANDLE hToken, COORD size, HANDLE hInput, HANDLE hOutput, DWORD dwFlags, HPCON* phPC);
+CONPTY_EXPORT HRESULT WINAPI ConptyCreatePseudoConsoleWithOutputRing(HANDLE hToken, COORD size, HANDLE hInput, HANDLE hOutput, const CONPTY_OUTPUT_RING* pOutputRing, DWORD dwFlags, HPCON* phPC);
 
 CONPTY_EXPORT HRESULT WINAPI ConptyResizePseudoConsole(HPCON hPC, COORD size);
 CONPTY_EXPORT HRESULT WINAPI ConptyClearPseudoConsole(HPCON hPC);
@@ -231,6 +231,62 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             ParentIt _it;
             size_type _pos;
         };
+
+        // Returns a pointer to the first element in [it, end) that isn't equal to value.
+        // Values that are 4 bytes large and have unique object representations (like the ids of
+        // a TextAttributeTable) are equal exactly if they're bitwise equal, so we can compare 4 at a time.
+        template<typename T>
+        const T* rle_find_mismatch(const T* it, const T* end, const T& value) noexcept
+        {
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+#if defined(TIL_SSE_INTRINSICS)
+            if constexpr (sizeof(T) == 4 && std::has_unique_object_representations_v<T>)
+            {
+                int bits;
+                memcpy(&bits, &value, sizeof(bits));
+                const auto needle = _mm_set1_epi32(bits);
+
+                for (; end - it >= 4; it += 4)
+                {
+                    const auto eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(it)), needle);
+                    const auto mask = static_cast<unsigned long>(_mm_movemask_epi8(eq)) ^ 0xffff;
+
+                    if (mask)
+                    {
+                        unsigned long offset;
+                        _BitScanForward(&offset, mask);
+                        return it + offset / 4;
+                    }
+                }
+            }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+            if constexpr (sizeof(T) == 4 && std::has_unique_object_representations_v<T>)
+            {
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                const auto needle = vdupq_n_u32(bits);
+
+                // NEON lacks a movemask, so we only skip over blocks of 4 that are entirely equal
+                // and let the scalar loop below find the exact position within the last one.
+                for (; end - it >= 4; it += 4)
+                {
+                    if (vminvq_u32(vceqq_u32(vld1q_u32(reinterpret_cast<const uint32_t*>(it)), needle)) == 0)
+                    {
+                        break;
+                    }
+                }
+            }
+#endif
+
+            for (; it != end && *it == value; ++it)
+            {
+            }
+
+            return it;
+#pragma warning(pop)
+        }
     } // namespace details
 
     // rle_pair is a simple clone of std::pair, with one difference:
@@ -505,6 +561,123 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             _compact();
         }
 
+        // Replaces each of the given [begin, end) ranges with the given value.
+        // The ranges must be sorted and must not overlap. End indices larger than size() are set to size().
+        // This is equivalent to calling replace() for each range, but rebuilds the runs only once.
+        void replace(const std::span<const std::pair<size_type, size_type>> ranges, const value_type& value)
+        {
+            container runs;
+            runs.reserve(_runs.size() + 2 * ranges.size());
+
+            const auto append = [&](const value_type& v, size_type length) {
+                if (!length)
+                {
+                    return;
+                }
+                if (!runs.empty() && runs.back().value == v)
+                {
+                    runs.back().length += length;
+                }
+                else
+                {
+                    runs.emplace_back(v, length);
+                }
+            };
+
+            auto it = _runs.begin();
+            size_type pos = 0;
+            size_type remaining = it != _runs.end() ? it->length : 0;
+
+            // Advances pos to target, copying the old runs over if copy is true.
+            const auto advance = [&](size_type target, bool copy) {
+                while (pos < target)
+                {
+                    const auto length = std::min<size_type>(remaining, target - pos);
+                    if (copy)
+                    {
+                        append(it->value, length);
+                    }
+                    pos += length;
+                    remaining -= length;
+                    if (!remaining && ++it != _runs.end())
+                    {
+                        remaining = it->length;
+                    }
+                }
+            };
+
+            for (auto [start_index, end_index] : ranges)
+            {
+                end_index = std::min(end_index, _total_length);
+                if (start_index < pos || start_index > end_index)
+                {
+                    throw std::out_of_range("ranges must be sorted and must not overlap");
+                }
+
+                advance(start_index, true);
+                advance(end_index, false);
+                append(value, gsl::narrow_cast<size_type>(end_index - start_index));
+            }
+
+            advance(_total_length, true);
+            _runs = std::move(runs);
+        }
+
+        // Replaces each value in the range [start_index, end_index) with func(value).
+        // func is called once per run instead of once per value, and the result is compacted.
+        // If end_index is larger than size() it's set to size().
+        // start_index must be smaller or equal to end_index.
+        template<typename Func>
+        void transform(size_type start_index, size_type end_index, Func&& func)
+        {
+            _check_indices(start_index, end_index);
+            if (start_index == end_index)
+            {
+                return;
+            }
+
+            auto replacements = slice(start_index, end_index);
+            for (auto& run : replacements._runs)
+            {
+                run.value = func(std::as_const(run.value));
+            }
+            replacements._compact();
+
+            _replace_unchecked(start_index, end_index, replacements._runs);
+        }
+
+        // Writes the decoded values into out, which must be at least size() large.
+        void expand(const std::span<value_type> out) const
+        {
+            if (out.size() < _total_length)
+            {
+                throw std::out_of_range("out.size() >= size()");
+            }
+
+            auto it = out.begin();
+            for (const auto& run : _runs)
+            {
+                it = std::fill_n(it, run.length, run.value);
+            }
+        }
+
+        // Returns the run length encoding of the given values.
+        [[nodiscard]] static basic_rle compress(const std::span<const value_type> values)
+        {
+            container runs;
+
+            const auto beg = values.data();
+            const auto end = beg + values.size();
+            for (auto it = beg; it != end;)
+            {
+                const auto next = details::rle_find_mismatch(it, end, *it);
+                runs.emplace_back(*it, gsl::narrow<size_type>(next - it));
+                it = next;
+            }
+
+            return { std::move(runs), gsl::narrow<size_type>(values.size()) };
+        }
+
         // Adjust the size of the vector.
         // If the size is being increased, the last run is extended to fill up the new vector size.
         // If the size is being decreased, the trailing runs are cut off to fit.
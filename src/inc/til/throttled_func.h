@@ -91,6 +91,16 @@ namespace til
         private:
             std::atomic<bool> _isPending;
         };
+
+        // Returns the msWindowLength for SetThreadpoolTimerEx(): The threadpool may delay each timer by up to
+        // this long, which allows it to coalesce their expirations. Each throttled function owns a timer,
+        // and with dozens of panes there are hundreds of them, whose wakeups would otherwise be spread out.
+        // Running a callback up to 1/4 of its delay later is fine for anything that's worth throttling.
+        inline DWORD throttled_func_window(const std::chrono::duration<int64_t, std::ratio<1, 10000000>> delay) noexcept
+        {
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(delay).count() / 4;
+            return static_cast<DWORD>(std::clamp<int64_t>(ms, 0, 1000));
+        }
     } // namespace details
 
     template<bool Debounce, bool Leading, typename... Args>
@@ -110,6 +120,7 @@ namespace til
         //
         // After `func` was invoked the state is reset and this cycle is repeated again.
         throttled_func(filetime_duration delay, function func) :
+            _window{ details::throttled_func_window(delay) },
             _func{ std::move(func) },
             _timer{ _createTimer() }
         {
@@ -143,13 +154,13 @@ namespace til
 
             if constexpr (Debounce)
             {
-                SetThreadpoolTimerEx(_timer.get(), &_delay, 0, 0);
+                SetThreadpoolTimerEx(_timer.get(), &_delay, 0, _window);
             }
             else
             {
                 if (!hadValue)
                 {
-                    SetThreadpoolTimerEx(_timer.get(), &_delay, 0, 0);
+                    SetThreadpoolTimerEx(_timer.get(), &_delay, 0, _window);
                 }
             }
 
@@ -210,6 +221,7 @@ namespace til
         }
 
         FILETIME _delay;
+        DWORD _window;
         function _func;
         wil::unique_threadpool_timer _timer;
         details::throttled_func_storage<Args...> _storage;
@@ -41,6 +41,13 @@ namespace til
             til::atomic_notify_all(_now_serving);
         }
 
+        // Returns true if another thread is waiting for the lock. It may only be called
+        // while holding the lock, and it's only a hint: It can change right after returning.
+        bool has_waiters() const noexcept
+        {
+            return _next_ticket.load(std::memory_order_relaxed) - _now_serving.load(std::memory_order_relaxed) > 1;
+        }
+
     private:
         // You may be inclined to add alignas(std::hardware_destructive_interference_size)
         // here to force the two atomics on separate cache lines, but I suggest to carefully
@@ -135,6 +142,12 @@ namespace til
             return { *this, owner, recursion };
         }
 
+        // Returns true if the current thread holds the lock and another thread is waiting for it.
+        bool has_waiters() const noexcept
+        {
+            return is_locked() && _lock.has_waiters();
+        }
+
         uint32_t is_locked() const noexcept
         {
             const auto id = GetCurrentThreadId();
@@ -14,6 +14,9 @@ could overcome disadvantages of syscalls. Test results can be read up
 in PR #4093 and the test algorithms are available in src\tools\U8U16Test.
 Based on the results the decision was made to keep using the platform
 functions MultiByteToWideChar and WideCharToMultiByte.
+Since most of the text going through ConPTY is ASCII, runs of ASCII characters
+are converted with SIMD instructions however, and only the remaining text is
+given to the platform functions (see til::details::u8u16 and u16u8).
 
 Author(s):
 - Steffen Illhardt (german-one), Leonard Hecker (lhecker) 2020-2021
@@ -47,6 +50,219 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
         }
     };
 
+    namespace details
+    {
+#pragma warning(push)
+#pragma warning(disable : 26429 26481 26490) // use not_null, pointer arithmetic, reinterpret_cast
+        // Routine Description:
+        // - Widens the run of ASCII characters at the start of `in` into `out`, 32 bytes per step.
+        // Return Value:
+        // - The length of that ASCII run. The same number of characters has been written to `out`.
+        inline size_t widen_ascii(const char* const in, const size_t len, wchar_t* out) noexcept
+        {
+            auto it = in;
+            const auto end = in + len;
+
+#if defined(TIL_SSE_INTRINSICS)
+            for (const auto end32 = in + (len & ~size_t{ 31 }); it < end32; it += 32, out += 32)
+            {
+                const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+                const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it + 16));
+                // The MSB of every byte is set for non-ASCII characters.
+                if (_mm_movemask_epi8(_mm_or_si128(a, b)))
+                {
+                    break;
+                }
+
+                const auto z = _mm_setzero_si128();
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0), _mm_unpacklo_epi8(a, z));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(a, z));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpacklo_epi8(b, z));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 24), _mm_unpackhi_epi8(b, z));
+            }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+            for (const auto end32 = in + (len & ~size_t{ 31 }); it < end32; it += 32, out += 32)
+            {
+                const auto a = vld1q_u8(reinterpret_cast<const uint8_t*>(it));
+                const auto b = vld1q_u8(reinterpret_cast<const uint8_t*>(it + 16));
+                const auto high = vreinterpretq_u64_u8(vandq_u8(vorrq_u8(a, b), vdupq_n_u8(0x80)));
+                if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1))
+                {
+                    break;
+                }
+
+                const auto dst = reinterpret_cast<uint16_t*>(out);
+                vst1q_u16(dst + 0, vmovl_u8(vget_low_u8(a)));
+                vst1q_u16(dst + 8, vmovl_u8(vget_high_u8(a)));
+                vst1q_u16(dst + 16, vmovl_u8(vget_low_u8(b)));
+                vst1q_u16(dst + 24, vmovl_u8(vget_high_u8(b)));
+            }
+#endif
+
+            // This handles the remainder, as well as the block which contained the first non-ASCII character.
+            for (; it < end && static_cast<uint8_t>(*it) < 0x80; ++it, ++out)
+            {
+                *out = static_cast<wchar_t>(*it);
+            }
+
+            return gsl::narrow_cast<size_t>(it - in);
+        }
+
+        // Routine Description:
+        // - Narrows the run of ASCII characters at the start of `in` into `out`, 16 characters per step.
+        // Return Value:
+        // - The length of that ASCII run. The same number of characters has been written to `out`.
+        inline size_t narrow_ascii(const wchar_t* const in, const size_t len, char* out) noexcept
+        {
+            auto it = in;
+            const auto end = in + len;
+
+#if defined(TIL_SSE_INTRINSICS)
+            for (const auto end16 = in + (len & ~size_t{ 15 }); it < end16; it += 16, out += 16)
+            {
+                const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+                const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it + 8));
+                // Any bit in 0xff80 being set means that the character isn't ASCII.
+                const auto high = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(static_cast<short>(0xff80)));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xffff)
+                {
+                    break;
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(a, b));
+            }
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+            for (const auto end16 = in + (len & ~size_t{ 15 }); it < end16; it += 16, out += 16)
+            {
+                const auto a = vld1q_u16(reinterpret_cast<const uint16_t*>(it));
+                const auto b = vld1q_u16(reinterpret_cast<const uint16_t*>(it + 8));
+                const auto high = vreinterpretq_u64_u16(vandq_u16(vorrq_u16(a, b), vdupq_n_u16(0xff80)));
+                if (vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1))
+                {
+                    break;
+                }
+
+                vst1q_u8(reinterpret_cast<uint8_t*>(out), vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+            }
+#endif
+
+            for (; it < end && *it < 0x80; ++it, ++out)
+            {
+                *out = static_cast<char>(*it);
+            }
+
+            return gsl::narrow_cast<size_t>(it - in);
+        }
+
+        // Routine Description:
+        // - Returns the offset of the next block of 16 ASCII characters in `in`, or `len` if there is none.
+        // - ASCII characters are always code point boundaries, which means that splitting the input there
+        //   and converting the two halves individually yields the same result as converting it as a whole.
+        //   Requiring an entire block prevents us from calling into the platform functions for every
+        //   single non-ASCII character in text like "a ä a ä".
+        template<typename T>
+        size_t find_ascii_block(const T* const in, const size_t len) noexcept
+        {
+            static constexpr size_t block = 16;
+            static constexpr auto nonAscii = gsl::narrow_cast<T>(~T{ 0x7f });
+
+            for (size_t off = 0; off + block <= len; off += block)
+            {
+                T bits = 0;
+                for (size_t i = 0; i < block; ++i)
+                {
+                    bits |= in[off + i];
+                }
+                if (!(bits & nonAscii))
+                {
+                    return off;
+                }
+            }
+
+            return len;
+        }
+
+        // Routine Description:
+        // - Equivalent to MultiByteToWideChar(CP_UTF8, 0, ...), but converts runs of ASCII characters itself.
+        // Return Value:
+        // - The number of characters written to `out`, or 0 if the conversion failed.
+        inline int u8u16(const char* in, int len, wchar_t* out, int capacity) noexcept
+        {
+            int written = 0;
+
+            while (len > 0)
+            {
+                const auto ascii = gsl::narrow_cast<int>(widen_ascii(in, gsl::narrow_cast<size_t>(len), out));
+                in += ascii;
+                len -= ascii;
+                out += ascii;
+                written += ascii;
+                capacity -= ascii;
+
+                if (len <= 0)
+                {
+                    break;
+                }
+
+                // The block at `in` starts with a non-ASCII character, so it's never the one we're looking for.
+                const auto other = gsl::narrow_cast<int>(find_ascii_block(in, gsl::narrow_cast<size_t>(len)));
+                const auto converted = MultiByteToWideChar(CP_UTF8, 0UL, in, other, out, capacity);
+                if (!converted)
+                {
+                    return 0;
+                }
+
+                in += other;
+                len -= other;
+                out += converted;
+                written += converted;
+                capacity -= converted;
+            }
+
+            return written;
+        }
+
+        // Routine Description:
+        // - Equivalent to WideCharToMultiByte(CP_UTF8, 0, ...), but converts runs of ASCII characters itself.
+        // Return Value:
+        // - The number of characters written to `out`, or 0 if the conversion failed.
+        inline int u16u8(const wchar_t* in, int len, char* out, int capacity) noexcept
+        {
+            int written = 0;
+
+            while (len > 0)
+            {
+                const auto ascii = gsl::narrow_cast<int>(narrow_ascii(in, gsl::narrow_cast<size_t>(len), out));
+                in += ascii;
+                len -= ascii;
+                out += ascii;
+                written += ascii;
+                capacity -= ascii;
+
+                if (len <= 0)
+                {
+                    break;
+                }
+
+                const auto other = gsl::narrow_cast<int>(find_ascii_block(in, gsl::narrow_cast<size_t>(len)));
+                const auto converted = WideCharToMultiByte(CP_UTF8, 0UL, in, other, out, capacity, nullptr, nullptr);
+                if (!converted)
+                {
+                    return 0;
+                }
+
+                in += other;
+                len -= other;
+                out += converted;
+                written += converted;
+                capacity -= converted;
+            }
+
+            return written;
+        }
+#pragma warning(pop)
+    }
+
     // Routine Description:
     // - Takes a UTF-8 string and performs the conversion to UTF-16. NOTE: The function relies on getting complete UTF-8 characters at the string boundaries.
     // Arguments:
@@ -70,7 +286,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // The worst ratio of UTF-8 code units to UTF-16 code units is 1 to 1 if UTF-8 consists of ASCII only.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthRequired));
             out.resize(in.length()); // avoid to call MultiByteToWideChar twice only to get the required size
-            const int lengthOut = MultiByteToWideChar(CP_UTF8, 0ul, in.data(), lengthRequired, out.data(), lengthRequired);
+            const int lengthOut = details::u8u16(in.data(), lengthRequired, out.data(), lengthRequired);
             out.resize(gsl::narrow_cast<size_t>(lengthOut));
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
@@ -104,68 +320,90 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // The worst ratio of UTF-8 code units to UTF-16 code units is 1 to 1 if UTF-8 consists of ASCII only.
             RETURN_HR_IF(E_ABORT, !base::CheckAdd(in.length(), state.have).AssignIfValid(&capa16));
 
-            out.resize(gsl::narrow_cast<size_t>(capa16));
-            auto len8{ gsl::narrow_cast<int>(in.length()) };
-            int len16{};
-            auto cursor8{ in.data() };
-            if (state.have)
-            {
-                const auto copyable{ std::min<int>(state.want, len8) };
-                std::move(cursor8, cursor8 + copyable, &state.partials[state.have]);
-                state.have += gsl::narrow_cast<uint8_t>(copyable);
-                state.want -= gsl::narrow_cast<uint8_t>(copyable);
-                if (state.want) // we still didn't get enough data to complete the code point, however this is not an error
+            // Large reads (like the ones from ConptyConnection) would otherwise spend a noticeable amount
+            // of time zero-filling `out` up to capa16, only for MultiByteToWideChar to overwrite it.
+            HRESULT hr = S_OK;
+            const auto convert = [&](wchar_t* data) noexcept -> size_t {
+                int len16{};
+                auto len8{ gsl::narrow_cast<int>(in.length()) };
+                auto cursor8{ in.data() };
+                if (state.have)
                 {
-                    out.clear();
-                    return S_OK;
+                    const auto copyable{ std::min<int>(state.want, len8) };
+                    std::move(cursor8, cursor8 + copyable, &state.partials[state.have]);
+                    state.have += gsl::narrow_cast<uint8_t>(copyable);
+                    state.want -= gsl::narrow_cast<uint8_t>(copyable);
+                    if (state.want) // we still didn't get enough data to complete the code point, however this is not an error
+                    {
+                        return 0;
+                    }
+
+                    len16 = MultiByteToWideChar(CP_UTF8, 0UL, &state.partials[0], gsl::narrow_cast<int>(state.have), data, capa16);
+                    if (!len16)
+                    {
+                        hr = E_UNEXPECTED;
+                        return 0;
+                    }
+
+                    capa16 -= len16;
+                    len8 -= copyable;
+                    cursor8 += copyable;
+                    // state.want is already zero at this point
+                    state.have = 0;
                 }
 
-                len16 = MultiByteToWideChar(CP_UTF8, 0UL, &state.partials[0], gsl::narrow_cast<int>(state.have), out.data(), capa16);
-                RETURN_HR_IF(E_UNEXPECTED, !len16);
-
-                capa16 -= len16;
-                len8 -= copyable;
-                cursor8 += copyable;
-                // state.want is already zero at this point
-                state.have = 0;
-            }
-
-            if (len8)
-            {
-                auto backIter{ cursor8 + len8 - 1 };
-                int sequenceLen{ 1 };
-
-                // skip UTF8 continuation bytes
-                while (backIter != cursor8 && (*backIter & 0b11'000000) == 0b10'000000)
+                if (len8)
                 {
-                    --backIter;
-                    ++sequenceLen;
+                    auto backIter{ cursor8 + len8 - 1 };
+                    int sequenceLen{ 1 };
+
+                    // skip UTF8 continuation bytes
+                    while (backIter != cursor8 && (*backIter & 0b11'000000) == 0b10'000000)
+                    {
+                        --backIter;
+                        ++sequenceLen;
+                    }
+
+                    // credits go to Christopher Wellons for this algorithm to determine the length of a UTF-8 code point
+                    // it is released into the Public Domain. https://github.com/skeeto/branchless-utf8
+                    static constexpr uint8_t lengths[]{ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 3, 3, 4, 0 };
+                    const auto codePointLen{ lengths[gsl::narrow_cast<uint8_t>(*backIter) >> 3] };
+
+                    if (codePointLen > sequenceLen)
+                    {
+                        std::move(backIter, backIter + sequenceLen, &state.partials[0]);
+                        len8 -= sequenceLen;
+                        state.have = gsl::narrow_cast<uint8_t>(sequenceLen);
+                        state.want = gsl::narrow_cast<uint8_t>(codePointLen - sequenceLen);
+                    }
                 }
 
-                // credits go to Christopher Wellons for this algorithm to determine the length of a UTF-8 code point
-                // it is released into the Public Domain. https://github.com/skeeto/branchless-utf8
-                static constexpr uint8_t lengths[]{ 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 3, 3, 4, 0 };
-                const auto codePointLen{ lengths[gsl::narrow_cast<uint8_t>(*backIter) >> 3] };
-
-                if (codePointLen > sequenceLen)
+                if (len8)
                 {
-                    std::move(backIter, backIter + sequenceLen, &state.partials[0]);
-                    len8 -= sequenceLen;
-                    state.have = gsl::narrow_cast<uint8_t>(sequenceLen);
-                    state.want = gsl::narrow_cast<uint8_t>(codePointLen - sequenceLen);
+                    const auto convLen{ details::u8u16(cursor8, len8, data + len16, capa16) };
+                    if (!convLen)
+                    {
+                        hr = E_UNEXPECTED;
+                        return 0;
+                    }
+
+                    len16 += convLen;
                 }
-            }
 
-            if (len8)
-            {
-                const auto convLen{ MultiByteToWideChar(CP_UTF8, 0UL, cursor8, len8, out.data() + len16, capa16) };
-                RETURN_HR_IF(E_UNEXPECTED, !convLen);
+                return gsl::narrow_cast<size_t>(len16);
+            };
 
-                len16 += convLen;
+            if constexpr (requires { out._Resize_and_overwrite(size_t{}, [](wchar_t*, size_t) noexcept { return size_t{}; }); })
+            {
+                out._Resize_and_overwrite(gsl::narrow_cast<size_t>(capa16), [&](wchar_t* data, size_t) noexcept { return convert(data); });
+            }
+            else
+            {
+                out.resize(gsl::narrow_cast<size_t>(capa16));
+                out.resize(convert(out.data()));
             }
 
-            out.resize(gsl::narrow_cast<size_t>(len16));
-            return S_OK;
+            return hr;
         }
         CATCH_RETURN();
     }
@@ -197,7 +435,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // Thus, the worst ratio of UTF-16 code units to UTF-8 code units is 1 to 3.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthIn) || !base::CheckMul(lengthIn, 3).AssignIfValid(&lengthRequired));
             out.resize(gsl::narrow_cast<size_t>(lengthRequired)); // avoid to call WideCharToMultiByte twice only to get the required size
-            const int lengthOut = WideCharToMultiByte(CP_UTF8, 0ul, in.data(), lengthIn, out.data(), lengthRequired, nullptr, nullptr);
+            const int lengthOut = details::u16u8(in.data(), lengthIn, out.data(), lengthRequired);
             out.resize(gsl::narrow_cast<size_t>(lengthOut));
 
             return lengthOut == 0 ? E_UNEXPECTED : S_OK;
@@ -259,7 +497,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
 
             if (len16)
             {
-                const auto convLen{ WideCharToMultiByte(CP_UTF8, 0UL, cursor16, len16, out.data() + len8, capa8, nullptr, nullptr) };
+                const auto convLen{ details::u16u8(cursor16, len16, out.data() + len8, capa8) };
                 RETURN_HR_IF(E_UNEXPECTED, !convLen);
 
                 len8 += convLen;
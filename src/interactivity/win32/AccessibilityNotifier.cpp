@@ -11,8 +11,15 @@
 using namespace Microsoft::Console::Types;
 using namespace Microsoft::Console::Interactivity::Win32;
 
+AccessibilityNotifier::AccessibilityNotifier() :
+    _updateFlush{ UpdateFlushDelay, [this]() { _flushPendingUpdate(); } }
+{
+}
+
 void AccessibilityNotifier::NotifyConsoleCaretEvent(_In_ const til::rect& rectangle)
 {
+    _flushPendingUpdate();
+
     const auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow != nullptr)
     {
@@ -28,6 +35,8 @@ void AccessibilityNotifier::NotifyConsoleCaretEvent(_In_ const til::rect& rectan
 
 void AccessibilityNotifier::NotifyConsoleCaretEvent(_In_ ConsoleCaretEventFlags flags, _In_ LONG position)
 {
+    _flushPendingUpdate();
+
     const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
     DWORD dwFlags = 0;
 
@@ -64,6 +73,8 @@ void AccessibilityNotifier::NotifyConsoleCaretEvent(_In_ ConsoleCaretEventFlags
 
 void AccessibilityNotifier::NotifyConsoleUpdateScrollEvent(_In_ LONG x, _In_ LONG y)
 {
+    _flushPendingUpdate();
+
     auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow)
     {
@@ -74,32 +85,27 @@ void AccessibilityNotifier::NotifyConsoleUpdateScrollEvent(_In_ LONG x, _In_ LON
     }
 }
 
+// The positions are packed with MAKELONG(x, y).
+static til::point unpackPosition(const LONG position) noexcept
+{
+    return { static_cast<SHORT>(LOWORD(position)), static_cast<SHORT>(HIWORD(position)) };
+}
+
 void AccessibilityNotifier::NotifyConsoleUpdateSimpleEvent(_In_ LONG start, _In_ LONG charAndAttribute)
 {
-    auto pWindow = ServiceLocator::LocateConsoleWindow();
-    if (pWindow)
-    {
-        NotifyWinEvent(EVENT_CONSOLE_UPDATE_SIMPLE,
-                       pWindow->GetWindowHandle(),
-                       start,
-                       charAndAttribute);
-    }
+    const auto position = unpackPosition(start);
+    _queueUpdate(position, position, charAndAttribute);
 }
 
 void AccessibilityNotifier::NotifyConsoleUpdateRegionEvent(_In_ LONG startXY, _In_ LONG endXY)
 {
-    auto pWindow = ServiceLocator::LocateConsoleWindow();
-    if (pWindow)
-    {
-        NotifyWinEvent(EVENT_CONSOLE_UPDATE_REGION,
-                       pWindow->GetWindowHandle(),
-                       startXY,
-                       endXY);
-    }
+    _queueUpdate(unpackPosition(startXY), unpackPosition(endXY), std::nullopt);
 }
 
 void AccessibilityNotifier::NotifyConsoleLayoutEvent()
 {
+    _flushPendingUpdate();
+
     auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow)
     {
@@ -112,6 +118,8 @@ void AccessibilityNotifier::NotifyConsoleLayoutEvent()
 
 void AccessibilityNotifier::NotifyConsoleStartApplicationEvent(_In_ DWORD processId)
 {
+    _flushPendingUpdate();
+
     auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow)
     {
@@ -124,6 +132,8 @@ void AccessibilityNotifier::NotifyConsoleStartApplicationEvent(_In_ DWORD proces
 
 void AccessibilityNotifier::NotifyConsoleEndApplicationEvent(_In_ DWORD processId)
 {
+    _flushPendingUpdate();
+
     auto pWindow = ServiceLocator::LocateConsoleWindow();
     if (pWindow)
     {
@@ -133,3 +143,79 @@ void AccessibilityNotifier::NotifyConsoleEndApplicationEvent(_In_ DWORD processI
                        0);
     }
 }
+
+// Routine Description:
+// - Merges the given update into the pending one and makes sure that it's raised within UpdateFlushDelay.
+// Arguments:
+// - start - the top left cell of the update
+// - end - the bottom right cell of the update (inclusive)
+// - charAndAttribute - the argument for an EVENT_CONSOLE_UPDATE_SIMPLE, if the update is a single cell
+void AccessibilityNotifier::_queueUpdate(const til::point start, const til::point end, const std::optional<LONG> charAndAttribute)
+{
+    // Nothing's listening (this is what NotifyWinEvent checks as well), so there's nothing to accumulate.
+    if (!IsWinEventHookInstalled(EVENT_CONSOLE_UPDATE_SIMPLE) && !IsWinEventHookInstalled(EVENT_CONSOLE_UPDATE_REGION))
+    {
+        return;
+    }
+
+    const auto pWindow = ServiceLocator::LocateConsoleWindow();
+    if (!pWindow)
+    {
+        return;
+    }
+
+    {
+        const std::lock_guard guard{ _pendingUpdateLock };
+
+        if (!_pendingUpdate)
+        {
+            _pendingUpdate.emplace(PendingUpdate{ pWindow->GetWindowHandle(), start.x, start.y, end.x, end.y, charAndAttribute });
+        }
+        else
+        {
+            auto& p = *_pendingUpdate;
+            p.left = std::min(p.left, start.x);
+            p.top = std::min(p.top, start.y);
+            p.right = std::max(p.right, end.x);
+            p.bottom = std::max(p.bottom, end.y);
+
+            // A repeated write to the same cell can stay a simple event. Anything else becomes a region.
+            const auto singleCell = p.left == p.right && p.top == p.bottom;
+            p.charAndAttribute = singleCell ? charAndAttribute : std::nullopt;
+        }
+    }
+
+    _updateFlush();
+}
+
+// Routine Description:
+// - Raises the pending update event, if there is one.
+void AccessibilityNotifier::_flushPendingUpdate() noexcept
+{
+    // The lock is held while raising the event, so that the timer
+    // can't raise an update after a later event was already raised.
+    const std::lock_guard guard{ _pendingUpdateLock };
+
+    if (!_pendingUpdate)
+    {
+        return;
+    }
+
+    const auto p = *_pendingUpdate;
+    _pendingUpdate.reset();
+
+    if (p.charAndAttribute)
+    {
+        NotifyWinEvent(EVENT_CONSOLE_UPDATE_SIMPLE,
+                       p.hwnd,
+                       MAKELONG(p.left, p.top),
+                       *p.charAndAttribute);
+    }
+    else
+    {
+        NotifyWinEvent(EVENT_CONSOLE_UPDATE_REGION,
+                       p.hwnd,
+                       MAKELONG(p.left, p.top),
+                       MAKELONG(p.right, p.bottom));
+    }
+}
@@ -20,11 +20,14 @@ Author(s):
 
 #pragma hdrstop
 
+#include <til/throttled_func.h>
+
 namespace Microsoft::Console::Interactivity::Win32
 {
     class AccessibilityNotifier final : public IAccessibilityNotifier
     {
     public:
+        AccessibilityNotifier();
         ~AccessibilityNotifier() = default;
 
         void NotifyConsoleCaretEvent(_In_ const til::rect& rectangle);
@@ -35,5 +38,31 @@ namespace Microsoft::Console::Interactivity::Win32
         void NotifyConsoleLayoutEvent();
         void NotifyConsoleStartApplicationEvent(_In_ DWORD processId);
         void NotifyConsoleEndApplicationEvent(_In_ DWORD processId);
+
+    private:
+        // Heavy output used to raise an update event for every single write, which all need to travel
+        // across processes to any WinEvent hook. Instead, the updated cells are accumulated here and
+        // raised as a single event once per frame. Every other event flushes the pending update first,
+        // so that listeners still see them in order.
+        struct PendingUpdate
+        {
+            HWND hwnd = nullptr;
+            til::CoordType left = 0;
+            til::CoordType top = 0;
+            til::CoordType right = 0;
+            til::CoordType bottom = 0;
+            // If the update consists of a single EVENT_CONSOLE_UPDATE_SIMPLE, this is its charAndAttribute.
+            std::optional<LONG> charAndAttribute;
+        };
+
+        static constexpr auto UpdateFlushDelay = std::chrono::milliseconds{ 16 };
+
+        void _queueUpdate(const til::point start, const til::point end, const std::optional<LONG> charAndAttribute);
+        void _flushPendingUpdate() noexcept;
+
+        std::mutex _pendingUpdateLock;
+        std::optional<PendingUpdate> _pendingUpdate;
+        // Must be destroyed first, as its callback uses the other members.
+        til::throttled_func_trailing<> _updateFlush;
     };
 }
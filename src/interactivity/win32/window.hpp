@@ -178,6 +178,8 @@ namespace Microsoft::Console::Interactivity::Win32
 
         WORD _resizingWindow = 0; // > 0 if we should ignore WM_SIZE messages
         bool _fInDPIChange = false;
+        bool _inSizeMove = false; // true between WM_ENTERSIZEMOVE and WM_EXITSIZEMOVE
+        std::optional<til::rect> _rcClientDeferred; // the client rect of a resize that's waiting for WM_EXITSIZEMOVE
 
         static void s_ConvertWindowPosToWindowRect(const LPWINDOWPOS lpWindowPos,
                                                    _Out_ til::rect* const prc);
@@ -242,6 +242,29 @@ static constexpr TsfDataProvider s_tsfDataProvider;
         break;
     }
 
+    case WM_ENTERSIZEMOVE:
+    {
+        _inSizeMove = true;
+        goto CallDefWin;
+        break;
+    }
+
+    case WM_EXITSIZEMOVE:
+    {
+        _inSizeMove = false;
+
+        // Apply the final size of the drag, if it was deferred by _HandleWindowPosChanged.
+        if (_rcClientDeferred)
+        {
+            const auto rcNew = *_rcClientDeferred;
+            _rcClientDeferred.reset();
+            ScreenInfo.ProcessResizeWindow(&rcNew, &_rcClientLast);
+            _rcClientLast = rcNew;
+        }
+        goto CallDefWin;
+        break;
+    }
+
     case WM_GETDPISCALEDSIZE:
     {
         // This message will send us the DPI we're about to be changed to.
@@ -861,6 +884,12 @@ void Window::_HandleWindowPosChanged(const LPARAM lParam)
         _UpdateSystemMetrics();
     }
 
+    // There's no point in painting a minimized window at full speed.
+    if (const auto pRender = ServiceLocator::LocateGlobals().pRender)
+    {
+        pRender->SetBackgroundPainting(IsIconic(hWnd) != FALSE);
+    }
+
     // This message is sent as the result of someone calling SetWindowPos(). We use it here to set/clear the
     // CONSOLE_IS_ICONIC bit appropriately. doing so in the WM_SIZE handler is incorrect because the WM_SIZE
     // comes after the WM_ERASEBKGND during SetWindowPos() processing, and the WM_ERASEBKGND needs to know if
@@ -876,6 +905,17 @@ void Window::_HandleWindowPosChanged(const LPARAM lParam)
         // don't do anything except update our windowrect
         if (!WI_IsFlagSet(lpWindowPos->flags, SWP_NOSIZE) || _fInDPIChange)
         {
+            // With wrap text enabled every size change reflows the entire buffer, including its scrollback.
+            // While the user drags the window border that happens for every mouse move, so we only remember
+            // the latest size and reflow once when the drag ends (WM_EXITSIZEMOVE). Until then the old grid
+            // is painted into the window, clipped or padded. DPI changes are always applied immediately.
+            if (_inSizeMove && !_fInDPIChange && ServiceLocator::LocateGlobals().getConsoleInformation().GetWrapText())
+            {
+                _rcClientDeferred = rcNew;
+                return;
+            }
+
+            _rcClientDeferred.reset();
             ScreenInfo.ProcessResizeWindow(&rcNew, &_rcClientLast);
         }
 
@@ -179,10 +179,21 @@ void AtlasEngine::_invalidateSpans(std::span<const til::point_span> spans, const
 
 [[nodiscard]] HRESULT AtlasEngine::UpdateSoftFont(const std::span<const uint16_t> bitPattern, const til::size cellSize, const size_t centeringHint) noexcept
 {
+    const auto& font = *_api.s->font;
+    const auto width = std::max(0, cellSize.width);
+    const auto height = std::max(0, cellSize.height);
+
+    // Applications tend to send the same DECDLD over and over again (for instance on every redraw).
+    // Modifying the font settings resets the glyph atlas and all text has to be rasterized again, so don't.
+    if (font.softFontCellSize.width == width && font.softFontCellSize.height == height && std::ranges::equal(font.softFontPattern, bitPattern))
+    {
+        return S_OK;
+    }
+
     const auto softFont = _api.s.write()->font.write();
     softFont->softFontPattern.assign(bitPattern.begin(), bitPattern.end());
-    softFont->softFontCellSize.width = std::max(0, cellSize.width);
-    softFont->softFontCellSize.height = std::max(0, cellSize.height);
+    softFont->softFontCellSize.width = width;
+    softFont->softFontCellSize.height = height;
     return S_OK;
 }
 
@@ -356,6 +367,12 @@ CATCH_RETURN()
     return Types::Viewport::FromDimensions(viewInCharacters.Origin(), { viewInCharacters.Width() * _api.s->font->cellSize.x, viewInCharacters.Height() * _api.s->font->cellSize.y });
 }
 
+// Returns E_PENDING until the frame requested via SetFrameCapturePath() has been saved.
+[[nodiscard]] HRESULT AtlasEngine::GetFrameCaptureResult() const noexcept
+{
+    return _api.captureFrameResult;
+}
+
 #pragma endregion
 
 #pragma region setter
@@ -432,6 +449,14 @@ void AtlasEngine::SetSoftwareRendering(bool enable) noexcept
     }
 }
 
+// Shifts the rendered viewport vertically by a fraction of a row, so that scrolling with a precision
+// touchpad doesn't have to snap to whole rows. Changing it only redraws the already shaped rows
+// with a different translation; the text buffer is only read again when a row boundary is crossed.
+void AtlasEngine::SetSmoothScrollOffset(f32 offsetInPx) noexcept
+{
+    _api.smoothScrollOffsetY = offsetInPx;
+}
+
 void AtlasEngine::SetDisablePartialInvalidation(bool enable) noexcept
 {
     if (_api.s->target->disablePresent1 != enable)
@@ -440,6 +465,27 @@ void AtlasEngine::SetDisablePartialInvalidation(bool enable) noexcept
     }
 }
 
+// The next Present() saves the frame to the given path as a PNG before presenting it.
+// Without a HWND the engine renders into a composition swap chain that nobody displays,
+// which lets it render snapshots without a window. Neither this nor GetFrameCaptureResult()
+// are synchronized with the render thread. They're meant for renderers without one,
+// which call Renderer::PaintFrame() themselves. See Snapshot.h.
+void AtlasEngine::SetFrameCapturePath(std::wstring_view path) noexcept
+try
+{
+    _api.captureFramePath = path;
+    _api.captureFrameResult = path.empty() ? S_OK : E_PENDING;
+}
+CATCH_LOG()
+
+void AtlasEngine::SetPersistGlyphAtlas(bool enable) noexcept
+{
+    if (_api.s->font->persistGlyphAtlas != enable)
+    {
+        _api.s.write()->font.write()->persistGlyphAtlas = enable;
+    }
+}
+
 void AtlasEngine::SetGraphicsAPI(GraphicsAPI graphicsAPI) noexcept
 {
     if (_api.s->target->graphicsAPI != graphicsAPI)
@@ -515,7 +561,10 @@ void AtlasEngine::_resolveTransparencySettings() noexcept
     // If the user asks for ClearType, but also for a transparent background
     // (which our ClearType shader doesn't simultaneously support)
     // then we need to sneakily force the renderer to grayscale AA.
-    const auto antialiasingMode = useAlpha && _api.antialiasingMode == AntialiasingMode::ClearType ? AntialiasingMode::Grayscale : _api.antialiasingMode;
+    // The same applies to remote sessions: The color fringes of ClearType compress poorly
+    // in the RDP codecs and don't match the subpixel layout of the client's display anyway.
+    const auto forceGrayscale = useAlpha || GetSystemMetrics(SM_REMOTESESSION);
+    const auto antialiasingMode = forceGrayscale && _api.antialiasingMode == AntialiasingMode::ClearType ? AntialiasingMode::Grayscale : _api.antialiasingMode;
 
     if (antialiasingMode != _api.s->font->antialiasingMode || useAlpha != _api.s->target->useAlpha)
     {
@@ -631,108 +680,15 @@ void AtlasEngine::_resolveFontMetrics(const FontInfoDesired& fontInfoDesired, Fo
         requestedWeight = DWRITE_FONT_WEIGHT_NORMAL;
     }
 
-    // UpdateFont() (and its NearbyFontLoading feature path specifically) sets `_api.s->font->fontCollection`
-    // to a custom font collection that includes .ttf files that are bundled with our app package. See GH#9375.
-    // Doing it this way is a bit hacky, but it does have the benefit that we can cache a font collection
-    // instance across font changes, like when zooming the font size rapidly using the scroll wheel.
-    auto fontCollection = _api.s->font->fontCollection;
-    if (!fontCollection)
-    {
-        THROW_IF_FAILED(_p.dwriteFactory->GetSystemFontCollection(fontCollection.addressof(), FALSE));
-    }
-
-    std::wstring primaryFontName;
-    std::wstring missingFontNames;
-    wil::com_ptr<IDWriteFontFamily> primaryFontFamily;
-    wil::com_ptr<IDWriteFontFallbackBuilder> fontFallbackBuilder;
-
-    // Resolves a comma-separated font list similar to CSS' font-family property. The first font in the list
-    // that can be resolved successfully will be the primary font which dictates the cell size among others.
-    // All remaining fonts are "secondary" fonts used for font fallback.
-    til::iterate_font_families(faceName, [&](std::wstring&& fontName) {
-        u32 index = 0;
-        BOOL exists = false;
-        THROW_IF_FAILED(fontCollection->FindFamilyName(fontName.c_str(), &index, &exists));
-
-        // In case of a portable build, the given font may not be installed and instead be bundled next to our executable.
-        if constexpr (Feature_NearbyFontLoading::IsEnabled())
-        {
-            if (!exists && _updateWithNearbyFontCollection())
-            {
-                fontCollection = _api.s->font->fontCollection;
-                THROW_IF_FAILED(fontCollection->FindFamilyName(fontName.c_str(), &index, &exists));
-            }
-        }
-
-        if (!exists)
-        {
-            if (!missingFontNames.empty())
-            {
-                missingFontNames.append(L", ");
-            }
-            missingFontNames.append(fontName);
-            return;
-        }
-
-        if (!primaryFontFamily)
-        {
-            primaryFontName = std::move(fontName);
-            THROW_IF_FAILED(fontCollection->GetFontFamily(index, primaryFontFamily.addressof()));
-        }
-        else
-        {
-            if (!fontFallbackBuilder)
-            {
-                THROW_IF_FAILED(_p.dwriteFactory->CreateFontFallbackBuilder(fontFallbackBuilder.addressof()));
-            }
-
-            static constexpr DWRITE_UNICODE_RANGE fullRange{ 0, 0x10FFFF };
-            auto fontNamePtr = fontName.c_str();
-            THROW_IF_FAILED(fontFallbackBuilder->AddMapping(
-                /* ranges                 */ &fullRange,
-                /* rangesCount            */ 1,
-                /* targetFamilyNames      */ &fontNamePtr,
-                /* targetFamilyNamesCount */ 1,
-                /* fontCollection         */ fontCollection.get(),
-                /* localeName             */ nullptr,
-                /* baseFamilyName         */ nullptr,
-                /* scale                  */ 1.0f));
-        }
-    });
-
-    if (!missingFontNames.empty() && _p.warningCallback)
-    {
-        _p.warningCallback(DWRITE_E_NOFONT, missingFontNames);
-    }
-
-    // Fall back to Consolas if no font was found or specified.
-    if (!primaryFontFamily)
-    {
-        primaryFontName = L"Consolas";
-
-        u32 index = 0;
-        BOOL exists = false;
-        THROW_IF_FAILED(fontCollection->FindFamilyName(primaryFontName.c_str(), &index, &exists));
-        THROW_HR_IF(DWRITE_E_NOFONT, !exists);
-
-        THROW_IF_FAILED(fontCollection->GetFontFamily(index, primaryFontFamily.addressof()));
-    }
+    const auto resolved = _resolveFontFamily(faceName, requestedWeight);
+    _api.resolvedFontFamily = resolved;
 
-    auto fontFallback = _api.systemFontFallback;
-    if (fontFallbackBuilder)
+    if (!resolved->missingFontNames.empty() && _p.warningCallback)
     {
-        THROW_IF_FAILED(fontFallbackBuilder->AddMappings(_api.systemFontFallback.get()));
-        THROW_IF_FAILED(fontFallbackBuilder->CreateFontFallback(fontFallback.put()));
+        _p.warningCallback(DWRITE_E_NOFONT, resolved->missingFontNames);
     }
 
-    wil::com_ptr<IDWriteFont> primaryFont;
-    THROW_IF_FAILED(primaryFontFamily->GetFirstMatchingFont(static_cast<DWRITE_FONT_WEIGHT>(requestedWeight), DWRITE_FONT_STRETCH_NORMAL, DWRITE_FONT_STYLE_NORMAL, primaryFont.addressof()));
-
-    wil::com_ptr<IDWriteFontFace> primaryFontFace;
-    THROW_IF_FAILED(primaryFont->CreateFontFace(primaryFontFace.addressof()));
-
-    DWRITE_FONT_METRICS metrics{};
-    primaryFontFace->GetMetrics(&metrics);
+    const auto& metrics = resolved->metrics;
 
     // Point sizes are commonly treated at a 72 DPI scale
     // (including by OpenType), whereas DirectWrite uses 96 DPI.
@@ -754,18 +710,9 @@ void AtlasEngine::_resolveFontMetrics(const FontInfoDesired& fontInfoDesired, Fo
     // According to the CSS spec, if it's impossible to determine the advance width,
     // it must be assumed to be 0.5em wide. em in CSS refers to the computed font-size.
     auto advanceWidth = 0.5f * fontSizeInPx;
+    if (resolved->zeroAdvanceWidth)
     {
-        static constexpr u32 codePoint = '0';
-
-        u16 glyphIndex;
-        THROW_IF_FAILED(primaryFontFace->GetGlyphIndicesW(&codePoint, 1, &glyphIndex));
-
-        if (glyphIndex)
-        {
-            DWRITE_GLYPH_METRICS glyphMetrics{};
-            THROW_IF_FAILED(primaryFontFace->GetDesignGlyphMetrics(&glyphIndex, 1, &glyphMetrics, FALSE));
-            advanceWidth = static_cast<f32>(glyphMetrics.advanceWidth) * designUnitsPerPx;
-        }
+        advanceWidth = static_cast<f32>(*resolved->zeroAdvanceWidth) * designUnitsPerPx;
     }
 
     auto adjustedWidth = std::roundf(fontInfoDesired.GetCellWidth().Resolve(advanceWidth, dpi, fontSizeInPx, advanceWidth));
@@ -822,7 +769,7 @@ void AtlasEngine::_resolveFontMetrics(const FontInfoDesired& fontInfoDesired, Fo
             requestedSize.width = gsl::narrow_cast<til::CoordType>(lrintf(fontSize / cellHeight * cellWidth));
         }
 
-        fontInfo.SetFromEngine(primaryFontName, requestedFamily, requestedWeight, false, coordSize, requestedSize);
+        fontInfo.SetFromEngine(resolved->primaryFontName, requestedFamily, requestedWeight, false, coordSize, requestedSize);
     }
 
     if (fontMetrics)
@@ -847,10 +794,11 @@ void AtlasEngine::_resolveFontMetrics(const FontInfoDesired& fontInfoDesired, Fo
         // NOTE: From this point onward no early returns or throwing code should exist,
         // as we might cause _api to be in an inconsistent state otherwise.
 
-        fontMetrics->fontCollection = std::move(fontCollection);
-        fontMetrics->fontFallback = std::move(fontFallback);
+        fontMetrics->fontCollection = resolved->fontCollection;
+        fontMetrics->fontFallback = resolved->fontFallback ? resolved->fontFallback : _api.systemFontFallback;
         fontMetrics->fontFallback.try_query_to(fontMetrics->fontFallback1.put());
-        fontMetrics->fontName = std::move(primaryFontName);
+        fontMetrics->fontName = resolved->primaryFontName;
+        fontMetrics->fontFallbackNames = resolved->fallbackFontNames;
         fontMetrics->fontSize = fontSizeInPx;
         fontMetrics->cellSize = { cellWidth, cellHeight };
         fontMetrics->fontWeight = fontWeightU16;
@@ -875,6 +823,156 @@ void AtlasEngine::_resolveFontMetrics(const FontInfoDesired& fontInfoDesired, Fo
     }
 }
 
+// Returns the ResolvedFontFamily for the given font-family list and weight in the current font collection.
+// The results are shared with all other engines that use the same font, so that a font change in the settings
+// only queries DirectWrite once, instead of once for each pane. The cache doesn't hold on to the entries itself.
+// They live for as long as an engine uses them (see ApiState::resolvedFontFamily), just like FontFallbackTable.
+std::shared_ptr<const AtlasEngine::ResolvedFontFamily> AtlasEngine::_resolveFontFamily(const std::wstring& faceName, const u32 weight)
+{
+    // UpdateFont() (and its NearbyFontLoading feature path specifically) sets `_api.s->font->fontCollection`
+    // to a custom font collection that includes .ttf files that are bundled with our app package. See GH#9375.
+    // Doing it this way is a bit hacky, but it does have the benefit that we can cache a font collection
+    // instance across font changes, like when zooming the font size rapidly using the scroll wheel.
+    auto fontCollection = _api.s->font->fontCollection;
+    if (!fontCollection)
+    {
+        THROW_IF_FAILED(_p.dwriteFactory->GetSystemFontCollection(fontCollection.addressof(), FALSE));
+    }
+
+    // There's one entry for each distinct font in use, so a linear scan is plenty fast. The lock is held while
+    // resolving a new entry, so that engines that change their font at the same time only resolve it once.
+    static std::mutex mutex;
+    static std::vector<std::weak_ptr<const ResolvedFontFamily>> registry;
+
+    const std::lock_guard guard{ mutex };
+
+    std::erase_if(registry, [](const auto& weak) { return weak.expired(); });
+
+    for (const auto& weak : registry)
+    {
+        if (auto shared = weak.lock(); shared &&
+                                       shared->requestedCollection == fontCollection &&
+                                       shared->weight == weight &&
+                                       shared->faceName == faceName)
+        {
+            return shared;
+        }
+    }
+
+    auto resolved = std::make_shared<ResolvedFontFamily>();
+    resolved->requestedCollection = fontCollection;
+    resolved->faceName = faceName;
+    resolved->weight = weight;
+
+    wil::com_ptr<IDWriteFontFamily> primaryFontFamily;
+    wil::com_ptr<IDWriteFontFallbackBuilder> fontFallbackBuilder;
+
+    // Resolves a comma-separated font list similar to CSS' font-family property. The first font in the list
+    // that can be resolved successfully will be the primary font which dictates the cell size among others.
+    // All remaining fonts are "secondary" fonts used for font fallback.
+    til::iterate_font_families(faceName, [&](std::wstring&& fontName) {
+        u32 index = 0;
+        BOOL exists = false;
+        THROW_IF_FAILED(fontCollection->FindFamilyName(fontName.c_str(), &index, &exists));
+
+        // In case of a portable build, the given font may not be installed and instead be bundled next to our executable.
+        if constexpr (Feature_NearbyFontLoading::IsEnabled())
+        {
+            if (!exists && _updateWithNearbyFontCollection())
+            {
+                fontCollection = _api.s->font->fontCollection;
+                THROW_IF_FAILED(fontCollection->FindFamilyName(fontName.c_str(), &index, &exists));
+            }
+        }
+
+        if (!exists)
+        {
+            if (!resolved->missingFontNames.empty())
+            {
+                resolved->missingFontNames.append(L", ");
+            }
+            resolved->missingFontNames.append(fontName);
+            return;
+        }
+
+        if (!primaryFontFamily)
+        {
+            resolved->primaryFontName = std::move(fontName);
+            THROW_IF_FAILED(fontCollection->GetFontFamily(index, primaryFontFamily.addressof()));
+        }
+        else
+        {
+            if (!fontFallbackBuilder)
+            {
+                THROW_IF_FAILED(_p.dwriteFactory->CreateFontFallbackBuilder(fontFallbackBuilder.addressof()));
+            }
+
+            static constexpr DWRITE_UNICODE_RANGE fullRange{ 0, 0x10FFFF };
+            auto fontNamePtr = fontName.c_str();
+            THROW_IF_FAILED(fontFallbackBuilder->AddMapping(
+                /* ranges                 */ &fullRange,
+                /* rangesCount            */ 1,
+                /* targetFamilyNames      */ &fontNamePtr,
+                /* targetFamilyNamesCount */ 1,
+                /* fontCollection         */ fontCollection.get(),
+                /* localeName             */ nullptr,
+                /* baseFamilyName         */ nullptr,
+                /* scale                  */ 1.0f));
+
+            if (!resolved->fallbackFontNames.empty())
+            {
+                resolved->fallbackFontNames.append(L", ");
+            }
+            resolved->fallbackFontNames.append(fontName);
+        }
+    });
+
+    // Fall back to Consolas if no font was found or specified.
+    if (!primaryFontFamily)
+    {
+        resolved->primaryFontName = L"Consolas";
+
+        u32 index = 0;
+        BOOL exists = false;
+        THROW_IF_FAILED(fontCollection->FindFamilyName(resolved->primaryFontName.c_str(), &index, &exists));
+        THROW_HR_IF(DWRITE_E_NOFONT, !exists);
+
+        THROW_IF_FAILED(fontCollection->GetFontFamily(index, primaryFontFamily.addressof()));
+    }
+
+    if (fontFallbackBuilder)
+    {
+        THROW_IF_FAILED(fontFallbackBuilder->AddMappings(_api.systemFontFallback.get()));
+        THROW_IF_FAILED(fontFallbackBuilder->CreateFontFallback(resolved->fontFallback.put()));
+    }
+
+    wil::com_ptr<IDWriteFont> primaryFont;
+    THROW_IF_FAILED(primaryFontFamily->GetFirstMatchingFont(static_cast<DWRITE_FONT_WEIGHT>(weight), DWRITE_FONT_STRETCH_NORMAL, DWRITE_FONT_STYLE_NORMAL, primaryFont.addressof()));
+
+    wil::com_ptr<IDWriteFontFace> primaryFontFace;
+    THROW_IF_FAILED(primaryFont->CreateFontFace(primaryFontFace.addressof()));
+
+    primaryFontFace->GetMetrics(&resolved->metrics);
+
+    {
+        static constexpr u32 codePoint = '0';
+
+        u16 glyphIndex;
+        THROW_IF_FAILED(primaryFontFace->GetGlyphIndicesW(&codePoint, 1, &glyphIndex));
+
+        if (glyphIndex)
+        {
+            DWRITE_GLYPH_METRICS glyphMetrics{};
+            THROW_IF_FAILED(primaryFontFace->GetDesignGlyphMetrics(&glyphIndex, 1, &glyphMetrics, FALSE));
+            resolved->zeroAdvanceWidth = glyphMetrics.advanceWidth;
+        }
+    }
+
+    resolved->fontCollection = std::move(fontCollection);
+    registry.emplace_back(resolved);
+    return resolved;
+}
+
 // Nearby fonts are described a couple of times throughout the file.
 // This abstraction in particular helps us avoid retrying when it's pointless:
 // After all, if the font collection didn't change (no nearby fonts, loading failed, it's already loaded),
@@ -9,6 +9,7 @@
 #include "Backend.h"
 #include "BuiltinGlyphs.h"
 #include "DWriteTextAnalysis.h"
+#include "FontFallbackCache.h"
 #include "../../interactivity/win32/CustomWindowMessages.h"
 
 #include "../types/inc/ColorFix.hpp"
@@ -58,6 +59,10 @@ AtlasEngine::AtlasEngine()
 [[nodiscard]] HRESULT AtlasEngine::StartPaint() noexcept
 try
 {
+    // The lines queued up by the previous frame are usually shaped by Present(). If it didn't get
+    // called, because painting failed half-way through, we need to catch up before touching any rows.
+    _shapeBufferLines();
+
     if (const auto hwnd = _api.s->target->hwnd)
     {
         RECT rect;
@@ -134,6 +139,15 @@ try
     _p.scrollOffsetX = _api.viewportOffset.x;
     _p.scrollDeltaY = _api.scrollOffset;
 
+    // A frame that's translated by a sub-row offset (or was, previously) differs from its predecessor
+    // in every pixel, which neither dirty rects nor the scroll rect of Present1() can express.
+    // Such frames only occur while smooth scrolling, so we just draw and present them in full.
+    if (_api.smoothScrollOffsetY != 0 || _p.smoothScrollOffsetY != 0)
+    {
+        _p.dirtyRectInPx = { 0, 0, _p.s->targetSize.x, _p.s->targetSize.y };
+    }
+    _p.smoothScrollOffsetY = _api.smoothScrollOffsetY;
+
     // This if condition serves 2 purposes:
     // * By setting top/bottom to the full height we ensure that we call Present() without
     //   any dirty rects and not Present1() on the first frame after the settings change.
@@ -212,6 +226,10 @@ try
                 {
                     memmove(dst, src, bytes);
                     _p.colorBitmapGenerations[i].bump();
+                    if (i == 0)
+                    {
+                        _p.backgroundBitmapDirtyRows = { 0, _p.s->viewportCellCount.y };
+                    }
                 }
 
                 src += _p.colorBitmapDepthStride;
@@ -257,6 +275,7 @@ CATCH_RETURN()
 [[nodiscard]] HRESULT AtlasEngine::EndPaint() noexcept
 try
 {
+    // The lines are shaped in Present(), after the console lock has been released.
     _flushBufferLine();
 
     for (const auto r : _p.rows)
@@ -375,6 +394,10 @@ void AtlasEngine::_fillColorBitmap(const size_t y, const size_t x1, const size_t
             if (*it != color)
             {
                 _p.colorBitmapGenerations[i].bump();
+                if (i == 0)
+                {
+                    _markBackgroundBitmapRowDirty(y);
+                }
                 std::fill(it, end, color);
                 break;
             }
@@ -386,6 +409,22 @@ void AtlasEngine::_fillColorBitmap(const size_t y, const size_t x1, const size_t
     }
 }
 
+void AtlasEngine::_markBackgroundBitmapRowDirty(const size_t y) noexcept
+{
+    const auto row = gsl::narrow_cast<u16>(y);
+    auto& dirty = _p.backgroundBitmapDirtyRows;
+
+    if (dirty.empty())
+    {
+        dirty = { row, gsl::narrow_cast<u16>(row + 1) };
+    }
+    else
+    {
+        dirty.start = std::min(dirty.start, row);
+        dirty.end = std::max(dirty.end, gsl::narrow_cast<u16>(row + 1));
+    }
+}
+
 // Method Description:
 // - Applies the given highlighting colors to the columns in the highlighted regions within a given range.
 // - Resumes from the last partially painted region if any.
@@ -714,6 +753,13 @@ void AtlasEngine::_recreateFontDependentResources()
     _api.replacementCharacterFontFace.reset();
     _api.replacementCharacterGlyphIndex = 0;
     _api.replacementCharacterLookedUp = false;
+    _api.shapingCache.clear();
+    _api.shapingCachePrevious.clear();
+    _api.shapingCacheFreeNodes.clear();
+    for (auto& scratch : _api.shapingScratch)
+    {
+        scratch.analysisCache.clear();
+    }
 
     {
         wchar_t localeName[LOCALE_NAME_MAX_LENGTH];
@@ -754,6 +800,31 @@ void AtlasEngine::_recreateFontDependentResources()
             _api.textFormatAxes[i] = { fontAxisValues.data(), fontAxisValues.size() };
         }
     }
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        const auto bold = (i & static_cast<size_t>(FontRelevantAttributes::Bold)) != 0;
+        const auto italic = (i & static_cast<size_t>(FontRelevantAttributes::Italic)) != 0;
+        const auto& axes = _api.textFormatAxes[i];
+
+        // This must match the arguments that _mapCharactersUncached() passes to MapCharacters().
+        FontFallbackTable::Config config;
+        config.fontCollection = _p.s->font->fontCollection.get();
+        config.familyName = _p.s->font->fontName;
+        config.fallbackFamilies = _p.s->font->fontFallbackNames;
+        config.localeName = _p.userLocaleName;
+        if (axes)
+        {
+            config.axes = { axes.data(), axes.size() };
+        }
+        else
+        {
+            config.weight = bold ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_p.s->font->fontWeight);
+            config.style = italic ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
+        }
+
+        _api.fontFallbackTables[i] = FontFallbackTable::Get(config);
+    }
 }
 
 void AtlasEngine::_recreateCellCountDependentResources()
@@ -768,13 +839,20 @@ void AtlasEngine::_recreateCellCountDependentResources()
     _api.bufferLine.reserve(projectedTextSize);
     _api.bufferLineColumn.reserve(projectedTextSize + 1);
 
-    _api.analysisResults = std::vector<TextAnalysisSinkResult>{};
-    _api.clusterMap = Buffer<u16>{ projectedTextSize };
-    _api.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ projectedTextSize };
-    _api.glyphIndices = Buffer<u16>{ projectedGlyphSize };
-    _api.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ projectedGlyphSize };
-    _api.glyphAdvances = Buffer<f32>{ projectedGlyphSize };
-    _api.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ projectedGlyphSize };
+    if (_api.shapingScratch.empty())
+    {
+        _api.shapingScratch.resize(1);
+    }
+    for (auto& scratch : _api.shapingScratch)
+    {
+        scratch.analysisResults = std::vector<TextAnalysisSinkResult>{};
+        scratch.clusterMap = Buffer<u16>{ projectedTextSize };
+        scratch.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ projectedTextSize };
+        scratch.glyphIndices = Buffer<u16>{ projectedGlyphSize };
+        scratch.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ projectedGlyphSize };
+        scratch.glyphAdvances = Buffer<f32>{ projectedGlyphSize };
+        scratch.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ projectedGlyphSize };
+    }
 
     _p.unorderedRows = Buffer<ShapedRow>(_p.s->viewportCellCount.y);
     _p.rowsScratch = Buffer<ShapedRow*>(_p.s->viewportCellCount.y);
@@ -791,6 +869,7 @@ void AtlasEngine::_recreateCellCountDependentResources()
     _p.foregroundBitmap = { _p.colorBitmap.data() + _p.colorBitmapDepthStride, _p.colorBitmapDepthStride };
 
     memset(_p.colorBitmap.data(), 0, _p.colorBitmap.size() * sizeof(u32));
+    _p.backgroundBitmapDirtyRows = { 0, _p.s->viewportCellCount.y };
 
     auto it = _p.unorderedRows.data();
     for (auto& r : _p.rows)
@@ -799,6 +878,9 @@ void AtlasEngine::_recreateCellCountDependentResources()
     }
 }
 
+// Queues up the current _api.bufferLine for _shapeBufferLines().
+// Shaping is deferred until Present(), so that all dirty rows of a frame can be shaped concurrently
+// and without holding the console lock. The lines are copies of the TextBuffer contents after all.
 void AtlasEngine::_flushBufferLine()
 {
     if (_api.bufferLine.empty())
@@ -806,17 +888,281 @@ void AtlasEngine::_flushBufferLine()
         return;
     }
 
+    // This would seriously blow us up otherwise.
+    Expects(_api.bufferLineColumn.size() == _api.bufferLine.size() + 1);
+
+    if (_api.pendingLineCount == _api.pendingLines.size())
+    {
+        _api.pendingLines.emplace_back();
+    }
+
+    // The pending line was cleared by _shapeBufferLines(). Swapping
+    // the vectors recycles their allocations between frames.
+    auto& line = _api.pendingLines[_api.pendingLineCount++];
+    line.text.swap(_api.bufferLine);
+    line.columns.swap(_api.bufferLineColumn);
+    line.y = _api.lastPaintBufferLineCoord.y;
+    line.attributes = _api.attributes;
+}
+
+void AtlasEngine::_shapeBufferLines()
+{
+    const auto count = gsl::narrow<u32>(_api.pendingLineCount);
+    if (count == 0)
+    {
+        return;
+    }
+
     const auto cleanup = wil::scope_exit([this]() noexcept {
-        _api.bufferLine.clear();
-        _api.bufferLineColumn.clear();
+        for (size_t i = 0; i < _api.pendingLineCount; ++i)
+        {
+            auto& line = _api.pendingLines[i];
+            line.text.clear();
+            line.columns.clear();
+            line.cached = nullptr;
+        }
+        _api.pendingLineCount = 0;
     });
 
-    // This would seriously blow us up otherwise.
-    Expects(_api.bufferLineColumn.size() == _api.bufferLine.size() + 1);
+    // A row may have been painted by multiple, not necessarily adjacent PaintBufferLine() calls.
+    // All of them append to the same ShapedRow and so they must be shaped in order and on the same thread.
+    // A stable sort ensures the former and splitting them into one run per row ensures the latter.
+    _api.pendingLineOrder.resize(count);
+    std::iota(_api.pendingLineOrder.begin(), _api.pendingLineOrder.end(), 0u);
+    std::stable_sort(_api.pendingLineOrder.begin(), _api.pendingLineOrder.end(), [&](const u32 a, const u32 b) noexcept {
+        return _api.pendingLines[a].y < _api.pendingLines[b].y;
+    });
+
+    _api.pendingLineRuns.clear();
+    for (u32 beg = 0, end = 0; beg < count; beg = end)
+    {
+        const auto y = _api.pendingLines[_api.pendingLineOrder[beg]].y;
+        end = beg + 1;
+        while (end < count && _api.pendingLines[_api.pendingLineOrder[end]].y == y)
+        {
+            ++end;
+        }
+        _api.pendingLineRuns.emplace_back(range<u32>{ beg, end });
+    }
+
+    // The replacement character is looked up lazily, which isn't thread-safe.
+    // Since it's only done once per font we can just as well do it upfront.
+    _lookupReplacementCharacter();
+
+    // Full redraws of TUIs like htop or vim tend to repaint lines with the exact same contents.
+    // Those can skip font fallback and shaping entirely. The cache is only modified here on the render
+    // thread, which makes it safe for the shaping threads to read the entries pointed to by `cached`.
+    if (_api.shapingCache.size() >= shapingCacheCapacity)
+    {
+        while (!_api.shapingCachePrevious.empty())
+        {
+            _recycleShapedLine(_api.shapingCachePrevious.extract(_api.shapingCachePrevious.begin()));
+        }
+        // Swapping instead of moving retains the bucket arrays of both maps.
+        std::swap(_api.shapingCache, _api.shapingCachePrevious);
+    }
+    for (u32 i = 0; i < count; ++i)
+    {
+        auto& line = _api.pendingLines[i];
+        line.cached = _lookupShapedLine(line);
+    }
+
+    static const size_t cpuCount = std::max(1u, std::thread::hardware_concurrency());
+    const auto threads = std::min({ cpuCount, shapingMaxThreads, _api.pendingLineRuns.size() / shapingMinRowsPerThread });
+
+    _api.shapingNextRun.store(0, std::memory_order_relaxed);
+    _api.shapingNextScratch.store(1, std::memory_order_relaxed);
+    _api.shapingResult.store(S_OK, std::memory_order_relaxed);
+
+    if (threads > 1)
+    {
+        if (!_api.shapingWork)
+        {
+            _api.shapingWork.reset(CreateThreadpoolWork(&_shapeBufferLinesCallback, this, nullptr));
+            THROW_LAST_ERROR_IF(!_api.shapingWork);
+        }
+
+        if (_api.shapingScratch.size() < threads)
+        {
+            _api.shapingScratch.resize(threads);
+        }
+
+        for (size_t i = 1; i < threads; ++i)
+        {
+            SubmitThreadpoolWork(_api.shapingWork.get());
+        }
+    }
+
+    // The render thread participates as well. If the pool is slow to pick up
+    // the work items, it'll simply end up shaping all of the rows by itself.
+    _shapeBufferLineRuns(_api.shapingScratch[0]);
+
+    if (threads > 1)
+    {
+        WaitForThreadpoolWorkCallbacks(_api.shapingWork.get(), FALSE);
+    }
+
+    THROW_IF_FAILED(_api.shapingResult.load(std::memory_order_relaxed));
+
+    for (u32 i = 0; i < count; ++i)
+    {
+        auto& line = _api.pendingLines[i];
+        if (line.cached)
+        {
+            continue;
+        }
+
+        if (_api.shapingCacheFreeNodes.empty())
+        {
+            _api.shapingCache.insert_or_assign(line.hash, std::move(line.shaped));
+            continue;
+        }
+
+        // Swapping the result with a recycled entry hands its vectors to the pending line,
+        // which is reused by the next frame. Once warmed up, this makes shaping allocation free.
+        auto node = std::move(_api.shapingCacheFreeNodes.back());
+        _api.shapingCacheFreeNodes.pop_back();
+        node.key() = line.hash;
+        std::swap(node.mapped(), line.shaped);
+
+        auto res = _api.shapingCache.insert(std::move(node));
+        if (!res.inserted)
+        {
+            std::swap(res.position->second, res.node.mapped());
+            _recycleShapedLine(std::move(res.node));
+        }
+    }
+}
+
+const AtlasEngine::ShapedLine* AtlasEngine::_lookupShapedLine(PendingBufferLine& line)
+{
+    const auto columnBase = line.columns.front();
+    const u16 meta[2]{ static_cast<u16>(line.attributes), gsl::narrow_cast<u16>(line.columns.back() - columnBase) };
+
+    // Hashing the columns would be expensive, but their sum is included in the form of the line width.
+    // A hash collision with a differently laid out line gets caught by the comparison below.
+    til::hasher hasher;
+    hasher.write(line.text.data(), line.text.size());
+    hasher.write(&meta[0], 2);
+    line.hash = hasher.finalize();
+
+    const auto matches = [&](const ShapedLine& s) {
+        if (s.attributes != line.attributes || s.text != line.text || s.columns.size() != line.columns.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < s.columns.size(); ++i)
+        {
+            if (s.columns[i] != line.columns[i] - columnBase)
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (const auto it = _api.shapingCache.find(line.hash); it != _api.shapingCache.end())
+    {
+        return matches(it->second) ? &it->second : nullptr;
+    }
+
+    if (auto node = _api.shapingCachePrevious.extract(line.hash); !node.empty())
+    {
+        if (matches(node.mapped()))
+        {
+            return &_api.shapingCache.insert(std::move(node)).position->second;
+        }
+        _recycleShapedLine(std::move(node));
+    }
+
+    return nullptr;
+}
+
+void AtlasEngine::_recycleShapedLine(ShapingCache::node_type&& node)
+{
+    if (_api.shapingCacheFreeNodes.size() >= shapingCacheCapacity)
+    {
+        return;
+    }
+
+    // The vectors are overwritten with assign() by _shapeBufferLineRuns(), so their contents don't matter,
+    // but the mappings hold references to font faces that shouldn't be kept alive.
+    node.mapped().mappings.clear();
+    _api.shapingCacheFreeNodes.emplace_back(std::move(node));
+}
+
+void CALLBACK AtlasEngine::_shapeBufferLinesCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_WORK /*work*/) noexcept
+{
+    const auto self = static_cast<AtlasEngine*>(context);
+    const auto slot = self->_api.shapingNextScratch.fetch_add(1, std::memory_order_relaxed);
+    self->_shapeBufferLineRuns(self->_api.shapingScratch[slot]);
+}
+
+// Shapes runs from _api.pendingLineRuns until there are none left. This is called concurrently from multiple threads:
+// Each of them only writes into the ShapedRow of the runs it claimed and into its own scratch buffers.
+void AtlasEngine::_shapeBufferLineRuns(ShapingScratch& scratch) noexcept
+try
+{
+    const auto runCount = _api.pendingLineRuns.size();
+
+    for (;;)
+    {
+        const size_t i = _api.shapingNextRun.fetch_add(1, std::memory_order_relaxed);
+        if (i >= runCount || FAILED(_api.shapingResult.load(std::memory_order_relaxed)))
+        {
+            break;
+        }
+
+        const auto run = _api.pendingLineRuns[i];
+        for (auto j = run.start; j < run.end; ++j)
+        {
+            _shapeBufferLine(_api.pendingLines[_api.pendingLineOrder[j]], scratch);
+        }
+    }
+}
+catch (...)
+{
+    auto expected = S_OK;
+    _api.shapingResult.compare_exchange_strong(expected, wil::ResultFromCaughtException(), std::memory_order_relaxed);
+}
+
+void AtlasEngine::_shapeBufferLine(PendingBufferLine& line, ShapingScratch& scratch) const
+{
+    auto& row = *_p.rows[line.y];
+    const auto columnBase = line.columns.front();
+    const auto glyphsBeg = row.glyphIndices.size();
+    const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
+    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * line.y;
+
+    // The colors aren't part of the cache key, because they change a lot more often than the text.
+    // Instead, both code paths below remember the column of every glyph and we look up its color here.
+    const auto appendColors = [&](const std::vector<u16>& glyphColumns, const u16 offset) {
+        for (const auto col : glyphColumns)
+        {
+            row.colors.emplace_back(colors[static_cast<size_t>(col + offset) << shift]);
+        }
+    };
+
+    if (line.cached)
+    {
+        const auto& c = *line.cached;
+        row.glyphIndices.insert(row.glyphIndices.end(), c.glyphIndices.begin(), c.glyphIndices.end());
+        row.glyphAdvances.insert(row.glyphAdvances.end(), c.glyphAdvances.begin(), c.glyphAdvances.end());
+        row.glyphOffsets.insert(row.glyphOffsets.end(), c.glyphOffsets.begin(), c.glyphOffsets.end());
+        for (const auto& m : c.mappings)
+        {
+            row.mappings.emplace_back(m.fontFace, m.glyphsFrom + glyphsBeg, m.glyphsTo + glyphsBeg);
+        }
+        appendColors(c.glyphColumns, columnBase);
+        return;
+    }
+
+    const auto mappingsBeg = row.mappings.size();
+    scratch.glyphColumns.clear();
 
     const auto builtinGlyphs = _p.s->font->builtinGlyphs;
-    const auto beg = _api.bufferLine.data();
-    const auto len = _api.bufferLine.size();
+    const auto beg = line.text.data();
+    const auto len = line.text.size();
     size_t segmentBeg = 0;
     size_t segmentEnd = 0;
     bool custom = false;
@@ -846,33 +1192,66 @@ void AtlasEngine::_flushBufferLine()
         {
             if (custom)
             {
-                _mapBuiltinGlyphs(segmentBeg, segmentEnd);
+                _mapBuiltinGlyphs(line, scratch, segmentBeg, segmentEnd);
             }
             else
             {
-                _mapRegularText(segmentBeg, segmentEnd);
+                _mapRegularText(line, scratch, segmentBeg, segmentEnd);
             }
         }
 
         segmentBeg = segmentEnd;
         custom = !custom;
     }
+
+    const auto glyphsEnd = row.glyphIndices.size();
+    assert(scratch.glyphColumns.size() == glyphsEnd - glyphsBeg);
+    appendColors(scratch.glyphColumns, 0);
+
+    auto& s = line.shaped;
+    s.text = line.text;
+    s.columns.assign(line.columns.begin(), line.columns.end());
+    for (auto& col : s.columns)
+    {
+        col -= columnBase;
+    }
+    s.attributes = line.attributes;
+    s.glyphIndices.assign(row.glyphIndices.begin() + glyphsBeg, row.glyphIndices.end());
+    s.glyphAdvances.assign(row.glyphAdvances.begin() + glyphsBeg, row.glyphAdvances.end());
+    s.glyphOffsets.assign(row.glyphOffsets.begin() + glyphsBeg, row.glyphOffsets.end());
+    s.glyphColumns.assign(scratch.glyphColumns.begin(), scratch.glyphColumns.end());
+    for (auto& col : s.glyphColumns)
+    {
+        col -= columnBase;
+    }
+
+    // _mapRegularText() may have extended the last mapping of a preceding line in this row.
+    s.mappings.clear();
+    for (auto i = mappingsBeg > 0 ? mappingsBeg - 1 : 0; i < row.mappings.size(); ++i)
+    {
+        const auto& m = row.mappings[i];
+        const auto from = std::max(m.glyphsFrom, glyphsBeg);
+        if (from < m.glyphsTo)
+        {
+            s.mappings.emplace_back(m.fontFace, from - glyphsBeg, m.glyphsTo - glyphsBeg);
+        }
+    }
 }
 
-void AtlasEngine::_mapRegularText(size_t offBeg, size_t offEnd)
+void AtlasEngine::_mapRegularText(const PendingBufferLine& line, ShapingScratch& scratch, size_t offBeg, size_t offEnd) const
 {
-    auto& row = *_p.rows[_api.lastPaintBufferLineCoord.y];
+    auto& row = *_p.rows[line.y];
 
     for (u32 idx = gsl::narrow_cast<u32>(offBeg), mappedEnd = 0; idx < offEnd; idx = mappedEnd)
     {
         u32 mappedLength = 0;
         wil::com_ptr<IDWriteFontFace2> mappedFontFace;
-        _mapCharacters(_api.bufferLine.data() + idx, gsl::narrow_cast<u32>(offEnd - idx), &mappedLength, mappedFontFace.addressof());
+        _mapCharacters(line.text.data() + idx, gsl::narrow_cast<u32>(offEnd - idx), line.attributes, &mappedLength, mappedFontFace.addressof());
         mappedEnd = idx + mappedLength;
 
         if (!mappedFontFace)
         {
-            _mapReplacementCharacter(idx, mappedEnd, row);
+            _mapReplacementCharacter(line, scratch, idx, mappedEnd, row);
             continue;
         }
 
@@ -881,14 +1260,14 @@ void AtlasEngine::_mapRegularText(size_t offBeg, size_t offEnd)
         // GetTextComplexity() returns as many glyph indices as its textLength parameter (here: mappedLength).
         // This block ensures that the buffer has sufficient capacity. It also initializes the glyphProps buffer because it and
         // glyphIndices sort of form a "pair" in the _mapComplex() code and are always simultaneously resized there as well.
-        if (mappedLength > _api.glyphIndices.size())
+        if (mappedLength > scratch.glyphIndices.size())
         {
-            auto size = _api.glyphIndices.size();
+            auto size = scratch.glyphIndices.size();
             size = size + (size >> 1);
             size = std::max<size_t>(size, mappedLength);
-            Expects(size > _api.glyphIndices.size());
-            _api.glyphIndices = Buffer<u16>{ size };
-            _api.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ size };
+            Expects(size > scratch.glyphIndices.size());
+            scratch.glyphIndices = Buffer<u16>{ size };
+            scratch.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ size };
         }
 
         if (_p.s->font->fontFeatures.empty())
@@ -897,34 +1276,30 @@ void AtlasEngine::_mapRegularText(size_t offBeg, size_t offEnd)
             for (u32 complexityLength = 0; idx < mappedEnd; idx += complexityLength)
             {
                 BOOL isTextSimple = FALSE;
-                THROW_IF_FAILED(_p.textAnalyzer->GetTextComplexity(_api.bufferLine.data() + idx, mappedEnd - idx, mappedFontFace.get(), &isTextSimple, &complexityLength, _api.glyphIndices.data()));
+                THROW_IF_FAILED(_p.textAnalyzer->GetTextComplexity(line.text.data() + idx, mappedEnd - idx, mappedFontFace.get(), &isTextSimple, &complexityLength, scratch.glyphIndices.data()));
 
                 if (isTextSimple)
                 {
-                    const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
-                    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * _api.lastPaintBufferLineCoord.y;
-
                     for (size_t i = 0; i < complexityLength; ++i)
                     {
-                        const auto col1 = _api.bufferLineColumn[idx + i + 0];
-                        const auto col2 = _api.bufferLineColumn[idx + i + 1];
+                        const auto col1 = line.columns[idx + i + 0];
+                        const auto col2 = line.columns[idx + i + 1];
                         const auto glyphAdvance = (col2 - col1) * _p.s->font->cellSize.x;
-                        const auto fg = colors[static_cast<size_t>(col1) << shift];
-                        row.glyphIndices.emplace_back(_api.glyphIndices[i]);
+                        row.glyphIndices.emplace_back(scratch.glyphIndices[i]);
                         row.glyphAdvances.emplace_back(static_cast<f32>(glyphAdvance));
                         row.glyphOffsets.emplace_back();
-                        row.colors.emplace_back(fg);
+                        scratch.glyphColumns.emplace_back(col1);
                     }
                 }
                 else
                 {
-                    _mapComplex(mappedFontFace.get(), idx, complexityLength, row);
+                    _mapComplex(line, scratch, mappedFontFace.get(), idx, complexityLength, row);
                 }
             }
         }
         else
         {
-            _mapComplex(mappedFontFace.get(), idx, mappedLength, row);
+            _mapComplex(line, scratch, mappedFontFace.get(), idx, mappedLength, row);
         }
 
         const auto indicesCount = row.glyphIndices.size();
@@ -944,32 +1319,101 @@ void AtlasEngine::_mapRegularText(size_t offBeg, size_t offEnd)
     }
 }
 
-void AtlasEngine::_mapBuiltinGlyphs(size_t offBeg, size_t offEnd)
+void AtlasEngine::_mapBuiltinGlyphs(const PendingBufferLine& line, ShapingScratch& scratch, size_t offBeg, size_t offEnd) const
 {
-    auto& row = *_p.rows[_api.lastPaintBufferLineCoord.y];
+    auto& row = *_p.rows[line.y];
     auto initialIndicesCount = row.glyphIndices.size();
-    const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
-    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * _api.lastPaintBufferLineCoord.y;
-    const auto base = reinterpret_cast<const u16*>(_api.bufferLine.data());
+    const auto base = reinterpret_cast<const u16*>(line.text.data());
     const auto len = offEnd - offBeg;
 
     row.glyphIndices.insert(row.glyphIndices.end(), base + offBeg, base + offEnd);
     row.glyphAdvances.insert(row.glyphAdvances.end(), len, static_cast<f32>(_p.s->font->cellSize.x));
     row.glyphOffsets.insert(row.glyphOffsets.end(), len, {});
+    scratch.glyphColumns.insert(scratch.glyphColumns.end(), line.columns.begin() + offBeg, line.columns.begin() + offEnd);
 
-    for (size_t i = offBeg; i < offEnd; ++i)
+    row.mappings.emplace_back(nullptr, gsl::narrow_cast<u32>(initialIndicesCount), gsl::narrow_cast<u32>(row.glyphIndices.size()));
+}
+
+void AtlasEngine::_mapCharacters(const wchar_t* text, const u32 textLength, const FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const
+{
+    if (const auto& table = _api.fontFallbackTables[static_cast<size_t>(attributes)])
     {
-        const auto col = _api.bufferLineColumn[i];
-        row.colors.emplace_back(colors[static_cast<size_t>(col) << shift]);
+        if (_mapCharactersCached(*table, text, textLength, attributes, mappedLength, mappedFontFace))
+        {
+            return;
+        }
     }
 
-    row.mappings.emplace_back(nullptr, gsl::narrow_cast<u32>(initialIndicesCount), gsl::narrow_cast<u32>(row.glyphIndices.size()));
+    _mapCharactersUncached(text, textLength, attributes, mappedLength, mappedFontFace);
+}
+
+// Maps the longest prefix of the given text that consists of cacheable code points with the same font.
+// Returns false if not even the first code point could be mapped that way.
+bool AtlasEngine::_mapCharactersCached(FontFallbackTable& table, const wchar_t* text, const u32 textLength, const FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const
+{
+    wil::com_ptr<IDWriteFontFace2> runFontFace;
+    u32 runLength = 0;
+    u32 lastCodepointOffset = 0;
+
+    for (u32 idx = 0; idx < textLength;)
+    {
+        char32_t codepoint = til::at(text, idx);
+        u32 codepointLength = 1;
+
+        if (til::is_leading_surrogate(codepoint) && idx + 1 < textLength && til::is_trailing_surrogate(til::at(text, idx + 1)))
+        {
+            codepoint = til::combine_surrogates(codepoint, til::at(text, idx + 1));
+            codepointLength = 2;
+        }
+
+        if (!FontFallbackTable::IsCacheable(codepoint))
+        {
+            // The previous code point may form a cluster with this one (e.g. a combining mark),
+            // in which case MapCharacters() may pick another font for the two of them.
+            runLength = lastCodepointOffset;
+            break;
+        }
+
+        wil::com_ptr<IDWriteFontFace2> fontFace;
+        if (!table.Lookup(codepoint, fontFace))
+        {
+            u32 length = 0;
+            _mapCharactersUncached(text + idx, codepointLength, attributes, &length, fontFace.addressof());
+            if (length != codepointLength)
+            {
+                break;
+            }
+            table.Insert(codepoint, fontFace.get());
+        }
+
+        if (idx == 0)
+        {
+            runFontFace = std::move(fontFace);
+        }
+        else if (fontFace != runFontFace)
+        {
+            break;
+        }
+
+        lastCodepointOffset = idx;
+        idx += codepointLength;
+        runLength = idx;
+    }
+
+    if (runLength == 0)
+    {
+        return false;
+    }
+
+    *mappedLength = runLength;
+    *mappedFontFace = runFontFace.detach();
+    return true;
 }
 
-void AtlasEngine::_mapCharacters(const wchar_t* text, const u32 textLength, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const
+void AtlasEngine::_mapCharactersUncached(const wchar_t* text, const u32 textLength, const FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const
 {
     TextAnalysisSource analysisSource{ _p.userLocaleName.c_str(), text, textLength };
-    const auto& textFormatAxis = _api.textFormatAxes[static_cast<size_t>(_api.attributes)];
+    const auto& textFormatAxis = _api.textFormatAxes[static_cast<size_t>(attributes)];
 
     // We don't read from scale anyways.
 #pragma warning(suppress : 26494) // Variable 'scale' is uninitialized. Always initialize an object (type.5).
@@ -991,8 +1435,8 @@ void AtlasEngine::_mapCharacters(const wchar_t* text, const u32 textLength, u32*
     }
     else
     {
-        const auto baseWeight = WI_IsFlagSet(_api.attributes, FontRelevantAttributes::Bold) ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_p.s->font->fontWeight);
-        const auto baseStyle = WI_IsFlagSet(_api.attributes, FontRelevantAttributes::Italic) ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
+        const auto baseWeight = WI_IsFlagSet(attributes, FontRelevantAttributes::Bold) ? DWRITE_FONT_WEIGHT_BOLD : static_cast<DWRITE_FONT_WEIGHT>(_p.s->font->fontWeight);
+        const auto baseStyle = WI_IsFlagSet(attributes, FontRelevantAttributes::Italic) ? DWRITE_FONT_STYLE_ITALIC : DWRITE_FONT_STYLE_NORMAL;
         wil::com_ptr<IDWriteFont> font;
 
         THROW_IF_FAILED(_p.s->font->fontFallback->MapCharacters(
@@ -1019,15 +1463,48 @@ void AtlasEngine::_mapCharacters(const wchar_t* text, const u32 textLength, u32*
     assert(scale == 1);
 }
 
-void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 length, ShapedRow& row)
+void AtlasEngine::_mapComplex(const PendingBufferLine& line, ShapingScratch& scratch, IDWriteFontFace2* mappedFontFace, u32 idx, u32 length, ShapedRow& row) const
 {
-    _api.analysisResults.clear();
+    scratch.analysisResults.clear();
+
+    // Lines that changed only partially, like a log line that is still being written to, miss the shaping cache.
+    // Most of their complex runs are the same as in the previous frame though. The script analysis of a run only
+    // depends on its text and the preceding character, which DirectWrite may look at, so it can be reused.
+    const auto contextBeg = idx ? idx - 1 : idx;
+    const std::wstring_view key{ line.text.data() + contextBeg, idx + length - contextBeg };
+    til::hasher hasher;
+    hasher.write(key.data(), key.size());
+    const auto hash = hasher.finalize();
+
+    if (const auto it = scratch.analysisCache.find(hash); it != scratch.analysisCache.end() && it->second.text == key)
+    {
+        for (auto a : it->second.results)
+        {
+            a.textPosition += idx;
+            scratch.analysisResults.emplace_back(a);
+        }
+    }
+    else
+    {
+        TextAnalysisSource analysisSource{ _p.userLocaleName.c_str(), line.text.data(), gsl::narrow<UINT32>(line.text.size()) };
+        TextAnalysisSink analysisSink{ scratch.analysisResults };
+        THROW_IF_FAILED(_p.textAnalyzer->AnalyzeScript(&analysisSource, idx, length, &analysisSink));
 
-    TextAnalysisSource analysisSource{ _p.userLocaleName.c_str(), _api.bufferLine.data(), gsl::narrow<UINT32>(_api.bufferLine.size()) };
-    TextAnalysisSink analysisSink{ _api.analysisResults };
-    THROW_IF_FAILED(_p.textAnalyzer->AnalyzeScript(&analysisSource, idx, length, &analysisSink));
+        if (scratch.analysisCache.size() >= analysisCacheCapacity)
+        {
+            scratch.analysisCache.clear();
+        }
 
-    for (const auto& a : _api.analysisResults)
+        auto& entry = scratch.analysisCache[hash];
+        entry.text.assign(key);
+        entry.results.assign(scratch.analysisResults.begin(), scratch.analysisResults.end());
+        for (auto& a : entry.results)
+        {
+            a.textPosition -= idx;
+        }
+    }
+
+    for (const auto& a : scratch.analysisResults)
     {
         u32 actualGlyphCount = 0;
 
@@ -1053,16 +1530,16 @@ void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 len
             featureRanges = 1;
         }
 
-        if (_api.clusterMap.size() <= a.textLength)
+        if (scratch.clusterMap.size() <= a.textLength)
         {
-            _api.clusterMap = Buffer<u16>{ static_cast<size_t>(a.textLength) + 1 };
-            _api.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ a.textLength };
+            scratch.clusterMap = Buffer<u16>{ static_cast<size_t>(a.textLength) + 1 };
+            scratch.textProps = Buffer<DWRITE_SHAPING_TEXT_PROPERTIES>{ a.textLength };
         }
 
         for (auto retry = 0;;)
         {
             const auto hr = _p.textAnalyzer->GetGlyphs(
-                /* textString          */ _api.bufferLine.data() + a.textPosition,
+                /* textString          */ line.text.data() + a.textPosition,
                 /* textLength          */ a.textLength,
                 /* fontFace            */ mappedFontFace,
                 /* isSideways          */ false,
@@ -1073,22 +1550,22 @@ void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 len
                 /* features            */ &features,
                 /* featureRangeLengths */ &featureRangeLengths,
                 /* featureRanges       */ featureRanges,
-                /* maxGlyphCount       */ gsl::narrow_cast<u32>(_api.glyphIndices.size()),
-                /* clusterMap          */ _api.clusterMap.data(),
-                /* textProps           */ _api.textProps.data(),
-                /* glyphIndices        */ _api.glyphIndices.data(),
-                /* glyphProps          */ _api.glyphProps.data(),
+                /* maxGlyphCount       */ gsl::narrow_cast<u32>(scratch.glyphIndices.size()),
+                /* clusterMap          */ scratch.clusterMap.data(),
+                /* textProps           */ scratch.textProps.data(),
+                /* glyphIndices        */ scratch.glyphIndices.data(),
+                /* glyphProps          */ scratch.glyphProps.data(),
                 /* actualGlyphCount    */ &actualGlyphCount);
 
             if (hr == HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER) && ++retry < 8)
             {
                 // Grow factor 1.5x.
-                auto size = _api.glyphIndices.size();
+                auto size = scratch.glyphIndices.size();
                 size = size + (size >> 1);
                 // Overflow check.
-                Expects(size > _api.glyphIndices.size());
-                _api.glyphIndices = Buffer<u16>{ size };
-                _api.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ size };
+                Expects(size > scratch.glyphIndices.size());
+                scratch.glyphIndices = Buffer<u16>{ size };
+                scratch.glyphProps = Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES>{ size };
                 continue;
             }
 
@@ -1096,24 +1573,24 @@ void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 len
             break;
         }
 
-        if (_api.glyphAdvances.size() < actualGlyphCount)
+        if (scratch.glyphAdvances.size() < actualGlyphCount)
         {
             // Grow the buffer by at least 1.5x and at least of `actualGlyphCount` items.
             // The 1.5x growth ensures we don't reallocate every time we need 1 more slot.
-            auto size = _api.glyphAdvances.size();
+            auto size = scratch.glyphAdvances.size();
             size = size + (size >> 1);
             size = std::max<size_t>(size, actualGlyphCount);
-            _api.glyphAdvances = Buffer<f32>{ size };
-            _api.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ size };
+            scratch.glyphAdvances = Buffer<f32>{ size };
+            scratch.glyphOffsets = Buffer<DWRITE_GLYPH_OFFSET>{ size };
         }
 
         THROW_IF_FAILED(_p.textAnalyzer->GetGlyphPlacements(
-            /* textString          */ _api.bufferLine.data() + a.textPosition,
-            /* clusterMap          */ _api.clusterMap.data(),
-            /* textProps           */ _api.textProps.data(),
+            /* textString          */ line.text.data() + a.textPosition,
+            /* clusterMap          */ scratch.clusterMap.data(),
+            /* textProps           */ scratch.textProps.data(),
             /* textLength          */ a.textLength,
-            /* glyphIndices        */ _api.glyphIndices.data(),
-            /* glyphProps          */ _api.glyphProps.data(),
+            /* glyphIndices        */ scratch.glyphIndices.data(),
+            /* glyphProps          */ scratch.glyphProps.data(),
             /* glyphCount          */ actualGlyphCount,
             /* fontFace            */ mappedFontFace,
             /* fontEmSize          */ _p.s->font->fontSize,
@@ -1124,56 +1601,53 @@ void AtlasEngine::_mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 len
             /* features            */ &features,
             /* featureRangeLengths */ &featureRangeLengths,
             /* featureRanges       */ featureRanges,
-            /* glyphAdvances       */ _api.glyphAdvances.data(),
-            /* glyphOffsets        */ _api.glyphOffsets.data()));
+            /* glyphAdvances       */ scratch.glyphAdvances.data(),
+            /* glyphOffsets        */ scratch.glyphOffsets.data()));
 
-        _api.clusterMap[a.textLength] = gsl::narrow_cast<u16>(actualGlyphCount);
+        scratch.clusterMap[a.textLength] = gsl::narrow_cast<u16>(actualGlyphCount);
 
-        const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
-        const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * _api.lastPaintBufferLineCoord.y;
-        auto prevCluster = _api.clusterMap[0];
+        auto prevCluster = scratch.clusterMap[0];
         size_t beg = 0;
 
         for (size_t i = 1; i <= a.textLength; ++i)
         {
-            const auto nextCluster = _api.clusterMap[i];
+            const auto nextCluster = scratch.clusterMap[i];
             if (prevCluster == nextCluster)
             {
                 continue;
             }
 
-            const size_t col1 = _api.bufferLineColumn[a.textPosition + beg];
-            const size_t col2 = _api.bufferLineColumn[a.textPosition + i];
-            const auto fg = colors[col1 << shift];
+            const size_t col1 = line.columns[a.textPosition + beg];
+            const size_t col2 = line.columns[a.textPosition + i];
 
             const auto expectedAdvance = (col2 - col1) * _p.s->font->cellSize.x;
             f32 actualAdvance = 0;
             for (auto j = prevCluster; j < nextCluster; ++j)
             {
-                actualAdvance += _api.glyphAdvances[j];
+                actualAdvance += scratch.glyphAdvances[j];
             }
-            _api.glyphAdvances[nextCluster - 1] += expectedAdvance - actualAdvance;
+            scratch.glyphAdvances[nextCluster - 1] += expectedAdvance - actualAdvance;
 
-            row.colors.insert(row.colors.end(), nextCluster - prevCluster, fg);
+            scratch.glyphColumns.insert(scratch.glyphColumns.end(), nextCluster - prevCluster, gsl::narrow_cast<u16>(col1));
 
             prevCluster = nextCluster;
             beg = i;
         }
 
-        row.glyphIndices.insert(row.glyphIndices.end(), _api.glyphIndices.begin(), _api.glyphIndices.begin() + actualGlyphCount);
-        row.glyphAdvances.insert(row.glyphAdvances.end(), _api.glyphAdvances.begin(), _api.glyphAdvances.begin() + actualGlyphCount);
-        row.glyphOffsets.insert(row.glyphOffsets.end(), _api.glyphOffsets.begin(), _api.glyphOffsets.begin() + actualGlyphCount);
+        row.glyphIndices.insert(row.glyphIndices.end(), scratch.glyphIndices.begin(), scratch.glyphIndices.begin() + actualGlyphCount);
+        row.glyphAdvances.insert(row.glyphAdvances.end(), scratch.glyphAdvances.begin(), scratch.glyphAdvances.begin() + actualGlyphCount);
+        row.glyphOffsets.insert(row.glyphOffsets.end(), scratch.glyphOffsets.begin(), scratch.glyphOffsets.begin() + actualGlyphCount);
     }
 }
 
-void AtlasEngine::_mapReplacementCharacter(u32 from, u32 to, ShapedRow& row)
+void AtlasEngine::_lookupReplacementCharacter()
 {
     if (!_api.replacementCharacterLookedUp)
     {
         bool succeeded = false;
 
         u32 mappedLength = 0;
-        _mapCharacters(L"\uFFFD", 1, &mappedLength, _api.replacementCharacterFontFace.put());
+        _mapCharacters(L"\uFFFD", 1, FontRelevantAttributes::None, &mappedLength, _api.replacementCharacterFontFace.put());
 
         if (mappedLength == 1)
         {
@@ -1189,21 +1663,23 @@ void AtlasEngine::_mapReplacementCharacter(u32 from, u32 to, ShapedRow& row)
 
         _api.replacementCharacterLookedUp = true;
     }
+}
 
+// _lookupReplacementCharacter() must have been called beforehand.
+void AtlasEngine::_mapReplacementCharacter(const PendingBufferLine& line, ShapingScratch& scratch, u32 from, u32 to, ShapedRow& row) const
+{
     if (!_api.replacementCharacterFontFace)
     {
         return;
     }
 
     auto pos = from;
-    auto col1 = _api.bufferLineColumn[from];
+    auto col1 = line.columns[from];
     auto initialIndicesCount = row.glyphIndices.size();
-    const auto shift = gsl::narrow_cast<u8>(row.lineRendition != LineRendition::SingleWidth);
-    const auto colors = _p.foregroundBitmap.begin() + _p.colorBitmapRowStride * _api.lastPaintBufferLineCoord.y;
 
     while (pos < to)
     {
-        const auto col2 = _api.bufferLineColumn[++pos];
+        const auto col2 = line.columns[++pos];
         if (col1 == col2)
         {
             continue;
@@ -1212,7 +1688,7 @@ void AtlasEngine::_mapReplacementCharacter(u32 from, u32 to, ShapedRow& row)
         row.glyphIndices.emplace_back(_api.replacementCharacterGlyphIndex);
         row.glyphAdvances.emplace_back(static_cast<f32>((col2 - col1) * _p.s->font->cellSize.x));
         row.glyphOffsets.emplace_back();
-        row.colors.emplace_back(colors[static_cast<size_t>(col1) << shift]);
+        scratch.glyphColumns.emplace_back(col1);
 
         col1 = col2;
     }
@@ -4,17 +4,21 @@
 #pragma once
 
 #include <dwrite_3.h>
-#include <d3d11_2.h>
+#include <d3d11_4.h>
 #include <dxgi1_3.h>
 
 #include "common.h"
 
 namespace Microsoft::Console::Render::Atlas
 {
+    struct FontFallbackTable;
     struct TextAnalysisSinkResult;
 
     class AtlasEngine final : public IRenderEngine
     {
+        struct SharedDevice;
+        struct ResolvedFontFamily;
+
     public:
         explicit AtlasEngine();
 
@@ -26,6 +30,8 @@ namespace Microsoft::Console::Render::Atlas
         [[nodiscard]] HRESULT EndPaint() noexcept override;
         [[nodiscard]] bool RequiresContinuousRedraw() noexcept override;
         void WaitUntilCanRender() noexcept override;
+        void TrimResources() noexcept override;
+        void SetFrameTimings(FrameTimings* timings) noexcept override;
         [[nodiscard]] HRESULT Present() noexcept override;
         [[nodiscard]] HRESULT ScrollFrame() noexcept override;
         [[nodiscard]] HRESULT Invalidate(const til::rect* psrRegion) noexcept override;
@@ -63,6 +69,7 @@ namespace Microsoft::Console::Render::Atlas
         [[nodiscard]] bool GetRetroTerminalEffect() const noexcept;
         [[nodiscard]] Types::Viewport GetViewportInCharacters(const Types::Viewport& viewInPixels) const noexcept;
         [[nodiscard]] Types::Viewport GetViewportInPixels(const Types::Viewport& viewInCharacters) const noexcept;
+        [[nodiscard]] HRESULT GetFrameCaptureResult() const noexcept;
         // setter
         void SetAntialiasingMode(D2D1_TEXT_ANTIALIAS_MODE antialiasingMode) noexcept;
         void SetCallback(std::function<void(HANDLE)> pfn) noexcept;
@@ -73,41 +80,116 @@ namespace Microsoft::Console::Render::Atlas
         void SetRetroTerminalEffect(bool enable) noexcept;
         void SetSoftwareRendering(bool enable) noexcept;
         void SetDisablePartialInvalidation(bool enable) noexcept;
+        void SetFrameCapturePath(std::wstring_view path) noexcept;
+        void SetPersistGlyphAtlas(bool enable) noexcept;
         void SetGraphicsAPI(GraphicsAPI graphicsAPI) noexcept;
+        void SetSmoothScrollOffset(f32 offsetInPx) noexcept;
         void SetWarningCallback(std::function<void(HRESULT, wil::zwstring_view)> pfn) noexcept;
         [[nodiscard]] HRESULT SetWindowSize(til::size pixels) noexcept;
         [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& pfiFontInfoDesired, FontInfo& fiFontInfo, const std::unordered_map<std::wstring_view, float>& features, const std::unordered_map<std::wstring_view, float>& axes) noexcept;
 
     private:
+        struct AnalysisCacheEntry
+        {
+            std::wstring text;
+            std::vector<TextAnalysisSinkResult> results;
+        };
+
+        // Scratch buffers used while shaping a line of text.
+        // Every thread taking part in _shapeBufferLines() owns one of these.
+        struct ShapingScratch
+        {
+            std::vector<TextAnalysisSinkResult> analysisResults;
+            // AnalyzeScript() results of recent complex runs, keyed by the hash of their text. See _mapComplex().
+            // The positions are relative to the start of the run. The locale isn't part of the key,
+            // because it only changes in _recreateFontDependentResources(), which clears the cache.
+            std::unordered_map<size_t, AnalysisCacheEntry> analysisCache;
+            Buffer<u16> clusterMap;
+            Buffer<DWRITE_SHAPING_TEXT_PROPERTIES> textProps;
+            Buffer<u16> glyphIndices;
+            Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES> glyphProps;
+            Buffer<f32> glyphAdvances;
+            Buffer<DWRITE_GLYPH_OFFSET> glyphOffsets;
+            // The column of each glyph appended to the ShapedRow. Used to look up its color.
+            std::vector<u16> glyphColumns;
+        };
+
+        // The result of shaping a PendingBufferLine, as stored in the shaping cache.
+        // Columns and glyph indices are relative to the start of the line,
+        // so that it can be reused no matter in which row or at which column the text is.
+        struct ShapedLine
+        {
+            std::vector<wchar_t> text;
+            std::vector<u16> columns;
+            FontRelevantAttributes attributes = FontRelevantAttributes::None;
+
+            std::vector<FontMapping> mappings;
+            std::vector<u16> glyphIndices;
+            std::vector<f32> glyphAdvances;
+            std::vector<DWRITE_GLYPH_OFFSET> glyphOffsets;
+            std::vector<u16> glyphColumns;
+        };
+
+        using ShapingCache = std::unordered_map<size_t, ShapedLine>;
+
+        // A line of text assembled by PaintBufferLine() which is waiting to be shaped in Present().
+        struct PendingBufferLine
+        {
+            std::vector<wchar_t> text;
+            std::vector<u16> columns;
+            u16 y = 0;
+            FontRelevantAttributes attributes = FontRelevantAttributes::None;
+
+            size_t hash = 0;
+            // Points into _api.shapingCache if the line was shaped before.
+            const ShapedLine* cached = nullptr;
+            // Otherwise, this receives the result, which is then added to the cache.
+            ShapedLine shaped;
+        };
+
         // AtlasEngine.cpp
         ATLAS_ATTR_COLD void _handleSettingsUpdate();
         void _recreateFontDependentResources();
         void _recreateCellCountDependentResources();
         void _flushBufferLine();
-        void _mapRegularText(size_t offBeg, size_t offEnd);
-        void _mapBuiltinGlyphs(size_t offBeg, size_t offEnd);
-        void _mapCharacters(const wchar_t* text, u32 textLength, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const;
-        void _mapComplex(IDWriteFontFace2* mappedFontFace, u32 idx, u32 length, ShapedRow& row);
-        ATLAS_ATTR_COLD void _mapReplacementCharacter(u32 from, u32 to, ShapedRow& row);
+        void _shapeBufferLines();
+        static void CALLBACK _shapeBufferLinesCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work) noexcept;
+        void _shapeBufferLineRuns(ShapingScratch& scratch) noexcept;
+        const ShapedLine* _lookupShapedLine(PendingBufferLine& line);
+        void _recycleShapedLine(ShapingCache::node_type&& node);
+        void _shapeBufferLine(PendingBufferLine& line, ShapingScratch& scratch) const;
+        void _mapRegularText(const PendingBufferLine& line, ShapingScratch& scratch, size_t offBeg, size_t offEnd) const;
+        void _mapBuiltinGlyphs(const PendingBufferLine& line, ShapingScratch& scratch, size_t offBeg, size_t offEnd) const;
+        void _mapCharacters(const wchar_t* text, u32 textLength, FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const;
+        bool _mapCharactersCached(FontFallbackTable& table, const wchar_t* text, u32 textLength, FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const;
+        void _mapCharactersUncached(const wchar_t* text, u32 textLength, FontRelevantAttributes attributes, u32* mappedLength, IDWriteFontFace2** mappedFontFace) const;
+        void _mapComplex(const PendingBufferLine& line, ShapingScratch& scratch, IDWriteFontFace2* mappedFontFace, u32 idx, u32 length, ShapedRow& row) const;
+        ATLAS_ATTR_COLD void _lookupReplacementCharacter();
+        ATLAS_ATTR_COLD void _mapReplacementCharacter(const PendingBufferLine& line, ShapingScratch& scratch, u32 from, u32 to, ShapedRow& row) const;
         void _fillColorBitmap(const size_t y, const size_t x1, const size_t x2, const u32 fgColor, const u32 bgColor) noexcept;
+        void _markBackgroundBitmapRowDirty(size_t y) noexcept;
         [[nodiscard]] HRESULT _drawHighlighted(std::span<const til::point_span>& highlights, const u16 row, const u16 begX, const u16 endX, const u32 fgColor, const u32 bgColor) noexcept;
 
         // AtlasEngine.api.cpp
         void _resolveTransparencySettings() noexcept;
         [[nodiscard]] HRESULT _updateFont(const FontInfoDesired& fontInfoDesired, FontInfo& fontInfo, const std::unordered_map<std::wstring_view, float>& features, const std::unordered_map<std::wstring_view, float>& axes) noexcept;
         void _resolveFontMetrics(const FontInfoDesired& fontInfoDesired, FontInfo& fontInfo, FontSettings* fontMetrics = nullptr);
+        ATLAS_ATTR_COLD std::shared_ptr<const ResolvedFontFamily> _resolveFontFamily(const std::wstring& faceName, u32 weight);
         [[nodiscard]] bool _updateWithNearbyFontCollection() noexcept;
         void _invalidateSpans(std::span<const til::point_span> spans, const TextBuffer& buffer) noexcept;
 
         // AtlasEngine.r.cpp
         ATLAS_ATTR_COLD void _recreateAdapter();
         ATLAS_ATTR_COLD void _recreateBackend();
+        ATLAS_ATTR_COLD std::shared_ptr<SharedDevice> _acquireSharedDevice(UINT deviceFlags);
+        void _updateBackendProbe(std::chrono::steady_clock::duration frameCost);
         ATLAS_ATTR_COLD void _handleSwapChainUpdate();
         void _createSwapChain();
         void _destroySwapChain();
         void _resizeBuffers();
         void _updateMatrixTransform();
         void _waitUntilCanRender() noexcept;
+        void _captureFrame() noexcept;
         void _present();
 
         static constexpr u16 u16min = 0x0000;
@@ -123,7 +205,94 @@ namespace Microsoft::Console::Render::Atlas
         static constexpr u32 highlightFocusBg = 0xff3296ff;
         static constexpr u32 highlightFocusFg = 0xff000000;
 
+        // Shaping is spread across the thread pool only if at least this many rows
+        // are dirty and each thread gets at least shapingMinRowsPerThread of them.
+        // Small updates like typing or a blinking cursor are cheaper to shape inline.
+        static constexpr size_t shapingMinRowsPerThread = 8;
+        static constexpr size_t shapingMaxThreads = 4;
+        // Once the shaping cache has this many entries it's moved to shapingCachePrevious.
+        static constexpr size_t shapingCacheCapacity = 1024;
+        // Once a ShapingScratch::analysisCache has this many entries it's cleared.
+        static constexpr size_t analysisCacheCapacity = 256;
+
+        // All engines in the process which render on the same adapter share a D3D device. See _acquireSharedDevice().
+        struct SharedDevice
+        {
+            wil::com_ptr<IDXGIFactory2> factory;
+            wil::com_ptr<ID3D11Device2> device;
+            wil::com_ptr<ID3D11DeviceContext2> deviceContext;
+            // nullptr if the device couldn't be made thread-safe, in which case it isn't shared.
+            wil::com_ptr<ID3D11Multithread> multithread;
+            D3D_FEATURE_LEVEL featureLevel{};
+            LUID adapterLuid{};
+            UINT deviceFlags = 0;
+            // The engine that last used the deviceContext, and whose pipeline state is still bound. Guarded by Lock().
+            const AtlasEngine* contextOwner = nullptr;
+
+            // Serializes the use of deviceContext with the render threads of the other engines.
+            // The underlying critical section is recursive and also used by D3D11 and D2D internally.
+            [[nodiscard]] auto Lock() const noexcept
+            {
+                if (multithread)
+                {
+                    multithread->Enter();
+                }
+                return wil::scope_exit([this]() noexcept {
+                    if (multithread)
+                    {
+                        multithread->Leave();
+                    }
+                });
+            }
+        };
+
+        // The part of _resolveFontMetrics() that doesn't depend on the font size or DPI: The font-family list and weight
+        // resolved to a font and its metrics in design units. It takes dozens of DirectWrite calls to produce, and every
+        // pane would otherwise repeat them whenever the font settings change. All engines in the process share it.
+        struct ResolvedFontFamily
+        {
+            // The key. Holds on to the collection, so that its address can't be reused by another one.
+            wil::com_ptr<IDWriteFontCollection> requestedCollection;
+            std::wstring faceName;
+            u32 weight = 0;
+
+            // This differs from requestedCollection if the fonts were only found after loading our nearby fonts.
+            wil::com_ptr<IDWriteFontCollection> fontCollection;
+            // nullptr if the list has no secondary fonts, in which case the system font fallback is used.
+            wil::com_ptr<IDWriteFontFallback> fontFallback;
+            std::wstring primaryFontName;
+            std::wstring fallbackFontNames;
+            std::wstring missingFontNames;
+            DWRITE_FONT_METRICS metrics{};
+            // The advance width of "0" in design units, unless the font lacks the glyph.
+            std::optional<u32> zeroAdvanceWidth;
+        };
+
+        // While the GraphicsAPI is Automatic and the heuristics in _recreateBackend() didn't already decide,
+        // the engine renders the first frames with BackendD3D and then with BackendD2D, measures how long
+        // each takes to render and present them and keeps the faster one. See _updateBackendProbe().
+        struct BackendProbe
+        {
+            enum class Phase : u8
+            {
+                None,
+                Direct3D11,
+                Direct2D,
+            };
+
+            // The first frames of a backend include the creation of its resources and aren't counted.
+            static constexpr u32 warmupFrames = 4;
+            static constexpr u32 measuredFrames = 60;
+
+            Phase phase = Phase::None;
+            u32 frames = 0;
+            std::chrono::steady_clock::duration direct3D11{};
+            std::chrono::steady_clock::duration direct2D{};
+        };
+
         std::unique_ptr<IBackend> _b;
+        std::shared_ptr<SharedDevice> _sharedDevice;
+        BackendProbe _backendProbe;
         RenderingPayload _p;
 
         struct ApiState
@@ -143,13 +312,32 @@ namespace Microsoft::Console::Render::Atlas
             std::vector<u16> bufferLineColumn;
 
             std::array<Buffer<DWRITE_FONT_AXIS_VALUE>, 4> textFormatAxes;
-            std::vector<TextAnalysisSinkResult> analysisResults;
-            Buffer<u16> clusterMap;
-            Buffer<DWRITE_SHAPING_TEXT_PROPERTIES> textProps;
-            Buffer<u16> glyphIndices;
-            Buffer<DWRITE_SHAPING_GLYPH_PROPERTIES> glyphProps;
-            Buffer<f32> glyphAdvances;
-            Buffer<DWRITE_GLYPH_OFFSET> glyphOffsets;
+            // The process-wide _mapCharacters() caches for each of the 4 FontRelevantAttributes combinations.
+            std::array<std::shared_ptr<FontFallbackTable>, 4> fontFallbackTables;
+            // Keeps the current font alive in the process-wide cache of _resolveFontFamily().
+            std::shared_ptr<const ResolvedFontFamily> resolvedFontFamily;
+
+            // _flushBufferLine() queues up lines in pendingLines and _shapeBufferLines() shapes them.
+            // The entries are reused across frames, so only the first pendingLineCount are valid.
+            std::vector<PendingBufferLine> pendingLines;
+            size_t pendingLineCount = 0;
+            // pendingLines indices sorted by row and split into one run per row.
+            std::vector<u32> pendingLineOrder;
+            std::vector<range<u32>> pendingLineRuns;
+            // [0] belongs to the render thread, the rest to the thread pool.
+            std::vector<ShapingScratch> shapingScratch;
+            std::atomic<u32> shapingNextRun{ 0 };
+            std::atomic<u32> shapingNextScratch{ 0 };
+            std::atomic<HRESULT> shapingResult{ S_OK };
+            wil::unique_threadpool_work shapingWork;
+            // Shaped lines keyed by PendingBufferLine::hash. It consists of two generations:
+            // Hits in shapingCachePrevious are moved back into shapingCache and entries that
+            // weren't used for an entire generation get dropped. It's a cheap approximation of a LRU.
+            ShapingCache shapingCache;
+            ShapingCache shapingCachePrevious;
+            // Entries dropped from the shaping cache. Their nodes and vectors are reused for newly shaped lines,
+            // so that a steady stream of new lines (scrolling output, etc.) doesn't allocate on every frame.
+            std::vector<ShapingCache::node_type> shapingCacheFreeNodes;
 
             wil::com_ptr<IDWriteFontFallback> systemFontFallback;
             wil::com_ptr<IDWriteFontFace2> replacementCharacterFontFace;
@@ -166,6 +354,9 @@ namespace Microsoft::Console::Render::Atlas
             u16x2 lastPaintBufferLineCoord{};
             // UpdateHyperlinkHoveredId()
             u16 hyperlinkHoveredId = 0;
+            // SetFrameCapturePath()
+            std::wstring captureFramePath;
+            HRESULT captureFrameResult = S_OK;
 
             // These tracks the highlighted regions on the screen that are yet to be painted.
             std::span<const til::point_span> searchHighlights;
@@ -178,6 +369,8 @@ namespace Microsoft::Console::Render::Atlas
             u16r invalidatedCursorArea = invalidatedAreaNone;
             range<u16> invalidatedRows = invalidatedRowsNone; // x is treated as "top" and y as "bottom"
             i16 scrollOffset = 0;
+            // The sub-row offset by which the viewport contents are drawn shifted. In pixel.
+            f32 smoothScrollOffsetY = 0;
 
             // The position of the viewport inside the text buffer (in cells).
             u16x2 viewportOffset{ 0, 0 };
@@ -6,6 +6,7 @@
 
 #include "BackendD2D.h"
 #include "BackendD3D.h"
+#include "wic.h"
 
 // #### NOTE ####
 // If you see any code in here that contains "_api." you might be seeing a race condition.
@@ -25,6 +26,44 @@
 
 using namespace Microsoft::Console::Render::Atlas;
 
+// The GraphicsAPI that the BackendProbe picked for each adapter. Every engine that renders
+// on an adapter after the first probe finished reuses its result instead of probing again.
+struct ProbedBackend
+{
+    LUID adapterLuid{};
+    GraphicsAPI graphicsAPI{};
+};
+
+static std::mutex probedBackendsMutex;
+static std::vector<ProbedBackend> probedBackends;
+
+static std::optional<GraphicsAPI> loadProbedBackend(const LUID& adapterLuid)
+{
+    const std::lock_guard guard{ probedBackendsMutex };
+    for (const auto& probed : probedBackends)
+    {
+        if (memcmp(&probed.adapterLuid, &adapterLuid, sizeof(LUID)) == 0)
+        {
+            return probed.graphicsAPI;
+        }
+    }
+    return std::nullopt;
+}
+
+static void storeProbedBackend(const LUID& adapterLuid, GraphicsAPI graphicsAPI)
+{
+    const std::lock_guard guard{ probedBackendsMutex };
+    for (auto& probed : probedBackends)
+    {
+        if (memcmp(&probed.adapterLuid, &adapterLuid, sizeof(LUID)) == 0)
+        {
+            probed.graphicsAPI = graphicsAPI;
+            return;
+        }
+    }
+    probedBackends.push_back({ adapterLuid, graphicsAPI });
+}
+
 #pragma region IRenderEngine
 
 // Present() is called without the console buffer lock being held.
@@ -32,6 +71,13 @@ using namespace Microsoft::Console::Render::Atlas;
 [[nodiscard]] HRESULT AtlasEngine::Present() noexcept
 try
 {
+    // Font fallback and shaping are the most expensive part of a frame on the CPU side.
+    // All the inputs were copied out of the TextBuffer during PaintBufferLine().
+    {
+        const FrameTimings::Scope timing{ _p.timings, FramePhase::Shaping };
+        _shapeBufferLines();
+    }
+
     if (!_p.dxgi.adapter)
     {
         _recreateAdapter();
@@ -42,13 +88,42 @@ try
         _recreateBackend();
     }
 
+    // The other engines sharing our device render on their own threads. The lock ensures that
+    // they don't interleave their draw calls with ours, but they still overwrite our pipeline state.
+    const auto sharedDevice = _sharedDevice;
+    const auto lock = sharedDevice->Lock();
+    if (sharedDevice->contextOwner != this)
+    {
+        sharedDevice->contextOwner = this;
+        _p.deviceContextStateLost = true;
+    }
+
     if (_p.swapChain.generation != _p.s.generation())
     {
         _handleSwapChainUpdate();
     }
 
+    const auto probeStart = _backendProbe.phase != BackendProbe::Phase::None ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
     _b->Render(_p);
-    _present();
+    _p.deviceContextStateLost = false;
+    _p.backgroundBitmapDirtyRows = {};
+    _p.backgroundBitmapBaseGeneration = _p.colorBitmapGenerations[0];
+
+    if (!_api.captureFramePath.empty())
+    {
+        _captureFrame();
+    }
+
+    {
+        const FrameTimings::Scope timing{ _p.timings, FramePhase::SwapChainPresent };
+        _present();
+    }
+
+    if (_backendProbe.phase != BackendProbe::Phase::None)
+    {
+        _updateBackendProbe(std::chrono::steady_clock::now() - probeStart);
+    }
     return S_OK;
 }
 catch (const wil::ResultException& exception)
@@ -89,6 +164,43 @@ void AtlasEngine::WaitUntilCanRender() noexcept
     _waitUntilCanRender();
 }
 
+// Called by the render thread once painting of a hidden window got suspended.
+// The backend (including its glyph atlas) and the swap chain are the bulk of our GPU memory usage.
+// Everything we need to draw the next frame is retained in _p.rows, so we can simply drop them and
+// let Present() recreate them like it would after a device loss. _recreateBackend() marks everything
+// as dirty, which makes the first frame after resuming a single full repaint.
+void AtlasEngine::TrimResources() noexcept
+try
+{
+    if (!_b)
+    {
+        return;
+    }
+
+    _destroySwapChain();
+    _b.reset();
+
+    // Trimming a device that other engines are still drawing with would only make them reallocate it all again.
+    if (_sharedDevice.use_count() == 1)
+    {
+        if (const auto dxgiDevice = _p.device.try_query<IDXGIDevice3>())
+        {
+            const auto lock = _sharedDevice->Lock();
+            dxgiDevice->Trim();
+        }
+    }
+
+    _p.deviceContext = {};
+    _p.device = {};
+    _sharedDevice.reset();
+}
+CATCH_LOG()
+
+void AtlasEngine::SetFrameTimings(FrameTimings* timings) noexcept
+{
+    _p.timings = timings;
+}
+
 #pragma endregion
 
 void AtlasEngine::_recreateAdapter()
@@ -168,18 +280,18 @@ void AtlasEngine::_recreateBackend()
 
     auto graphicsAPI = _p.s->target->graphicsAPI;
 
-    auto deviceFlags =
-        D3D11_CREATE_DEVICE_SINGLETHREADED
+    // NOTE: The device is shared with other engines and thus can't be created with D3D11_CREATE_DEVICE_SINGLETHREADED.
+    UINT deviceFlags =
 #ifndef NDEBUG
-        | D3D11_CREATE_DEVICE_DEBUG
+        D3D11_CREATE_DEVICE_DEBUG |
 #endif
         // This flag prevents the driver from creating a large thread pool for things like shader computations
         // that would be advantageous for games. For us this has only a minimal performance benefit,
         // but comes with a large memory usage overhead. At the time of writing the Nvidia
         // driver launches $cpu_thread_count more worker threads without this flag.
-        | D3D11_CREATE_DEVICE_PREVENT_INTERNAL_THREADING_OPTIMIZATIONS
+        D3D11_CREATE_DEVICE_PREVENT_INTERNAL_THREADING_OPTIMIZATIONS |
         // Direct2D support.
-        | D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+        D3D11_CREATE_DEVICE_BGRA_SUPPORT;
 
     if (WI_IsFlagSet(_p.dxgi.adapterFlags, DXGI_ADAPTER_FLAG_SOFTWARE))
     {
@@ -193,9 +305,157 @@ void AtlasEngine::_recreateBackend()
         }
     }
 
+    // Over RDP every changed pixel has to be encoded and sent over the network. BackendD2D strictly
+    // only redraws the dirty rows and never needs a continuous redraw, which keeps the Present1() dirty
+    // rects small. BackendD3D is only needed for custom shaders and the retro effect, which BackendD2D lacks.
+    if (graphicsAPI == GraphicsAPI::Automatic && GetSystemMetrics(SM_REMOTESESSION) &&
+        _p.s->misc->customPixelShaderPath.empty() && !_p.s->misc->useRetroTerminalEffect)
+    {
+        graphicsAPI = GraphicsAPI::Direct2D;
+    }
+
+    _sharedDevice = _acquireSharedDevice(deviceFlags);
+
+    if (graphicsAPI == GraphicsAPI::Automatic)
+    {
+        if (_sharedDevice->featureLevel < D3D_FEATURE_LEVEL_10_0)
+        {
+            graphicsAPI = GraphicsAPI::Direct2D;
+        }
+        else if (_sharedDevice->featureLevel < D3D_FEATURE_LEVEL_11_0)
+        {
+            D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS options{};
+            if (FAILED(_sharedDevice->device->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &options, sizeof(options))) ||
+                !options.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x)
+            {
+                graphicsAPI = GraphicsAPI::Direct2D;
+            }
+        }
+    }
+
+    // None of the heuristics above applied, so we measure which backend is faster on this machine (see _updateBackendProbe()).
+    // A WARP device was already handled above, but a VDI or a VM may have a hardware adapter that's just as slow.
+    if (graphicsAPI == GraphicsAPI::Automatic && _p.s->misc->customPixelShaderPath.empty() && !_p.s->misc->useRetroTerminalEffect)
+    {
+        if (const auto probed = loadProbedBackend(_p.dxgi.adapterLuid))
+        {
+            graphicsAPI = *probed;
+            _backendProbe = {};
+        }
+        else if (_backendProbe.phase == BackendProbe::Phase::Direct2D)
+        {
+            graphicsAPI = GraphicsAPI::Direct2D;
+            _backendProbe.frames = 0;
+            _backendProbe.direct2D = {};
+        }
+        else
+        {
+            _backendProbe = {};
+            _backendProbe.phase = BackendProbe::Phase::Direct3D11;
+        }
+    }
+    else
+    {
+        _backendProbe = {};
+    }
+
+    // Swap chains must be created with the factory of the shared device's adapter.
+    _p.dxgi.factory = _sharedDevice->factory;
+    _p.device = _sharedDevice->device;
+    _p.deviceContext = _sharedDevice->deviceContext;
+
+    switch (graphicsAPI)
+    {
+    case GraphicsAPI::Direct2D:
+        _b = std::make_unique<BackendD2D>();
+        break;
+    default:
+        _b = std::make_unique<BackendD3D>(_p);
+        break;
+    }
+
+    // This ensures that the backends redraw their entire viewports whenever a new swap chain is created,
+    // EVEN IF we got called when no actual settings changed (i.e. rendering failure, etc.).
+    _p.MarkAllAsDirty();
+}
+
+// Accumulates the cost of a frame rendered during the backend probe. Once enough frames were measured with
+// BackendD3D it switches to BackendD2D, and once that's done too, it picks the one with the lower average.
+// The frames of both phases don't show the same content, so BackendD2D only wins if it's clearly faster.
+void AtlasEngine::_updateBackendProbe(std::chrono::steady_clock::duration frameCost)
+{
+    auto& probe = _backendProbe;
+
+    probe.frames++;
+    if (probe.frames <= BackendProbe::warmupFrames)
+    {
+        return;
+    }
+
+    auto& total = probe.phase == BackendProbe::Phase::Direct3D11 ? probe.direct3D11 : probe.direct2D;
+    total += frameCost;
+
+    if (probe.frames < BackendProbe::warmupFrames + BackendProbe::measuredFrames)
+    {
+        return;
+    }
+
+    if (probe.phase == BackendProbe::Phase::Direct3D11)
+    {
+        probe.phase = BackendProbe::Phase::Direct2D;
+        probe.frames = 0;
+        _b.reset();
+        return;
+    }
+
+    const auto direct3D11 = probe.direct3D11 / BackendProbe::measuredFrames;
+    const auto direct2D = probe.direct2D / BackendProbe::measuredFrames;
+    const auto graphicsAPI = direct2D * 4 < direct3D11 * 3 ? GraphicsAPI::Direct2D : GraphicsAPI::Direct3D11;
+
+    storeProbedBackend(_p.dxgi.adapterLuid, graphicsAPI);
+    FrameTimings::TraceBackendSelection(graphicsAPI == GraphicsAPI::Direct2D ? L"Direct2D" : L"Direct3D11", direct3D11, direct2D);
+
+    probe = {};
+    if (graphicsAPI != GraphicsAPI::Direct2D)
+    {
+        _b.reset();
+    }
+}
+
+// Each pane has its own AtlasEngine, but creating a D3D device per pane is wasteful: Every device comes with its
+// own driver-internal allocations, shader caches and command buffers, and D3D11CreateDevice() itself is one of the
+// most expensive parts of the first frame. So, all engines that render on the same adapter share one device.
+// Since each of them has its own render thread, the device is made thread-safe via ID3D11Multithread.
+std::shared_ptr<AtlasEngine::SharedDevice> AtlasEngine::_acquireSharedDevice(const UINT deviceFlags)
+{
+    static std::mutex mutex;
+    static std::vector<std::weak_ptr<SharedDevice>> registry;
+
+    const std::lock_guard guard{ mutex };
+
+    std::erase_if(registry, [](const auto& weak) { return weak.expired(); });
+
+    for (const auto& weak : registry)
+    {
+        // A removed device stays removed. The engines still using it will run into
+        // DXGI_ERROR_DEVICE_REMOVED on their own and acquire a new one as well.
+        if (auto shared = weak.lock(); shared &&
+                                       memcmp(&shared->adapterLuid, &_p.dxgi.adapterLuid, sizeof(LUID)) == 0 &&
+                                       shared->deviceFlags == deviceFlags &&
+                                       shared->device->GetDeviceRemovedReason() == S_OK)
+        {
+            return shared;
+        }
+    }
+
+    auto shared = std::make_shared<SharedDevice>();
+    shared->factory = _p.dxgi.factory;
+    shared->adapterLuid = _p.dxgi.adapterLuid;
+    shared->deviceFlags = deviceFlags;
+
+    auto createFlags = deviceFlags;
     wil::com_ptr<ID3D11Device> device0;
     wil::com_ptr<ID3D11DeviceContext> deviceContext0;
-    D3D_FEATURE_LEVEL featureLevel{};
 
     static constexpr std::array featureLevels{
         D3D_FEATURE_LEVEL_11_1,
@@ -212,12 +472,12 @@ void AtlasEngine::_recreateBackend()
         /* pAdapter           */ _p.dxgi.adapter.get(),
         /* DriverType         */ D3D_DRIVER_TYPE_UNKNOWN,
         /* Software           */ nullptr,
-        /* Flags              */ deviceFlags,
+        /* Flags              */ createFlags,
         /* pFeatureLevels     */ featureLevels.data(),
         /* FeatureLevels      */ gsl::narrow_cast<UINT>(featureLevels.size()),
         /* SDKVersion         */ D3D11_SDK_VERSION,
         /* ppDevice           */ device0.put(),
-        /* pFeatureLevel      */ &featureLevel,
+        /* pFeatureLevel      */ &shared->featureLevel,
         /* ppImmediateContext */ deviceContext0.put());
 #ifndef NDEBUG
     if (hr == DXGI_ERROR_SDK_COMPONENT_MISSING)
@@ -225,30 +485,30 @@ void AtlasEngine::_recreateBackend()
         // This might happen if you don't have "Graphics debugger and GPU
         // profiler for DirectX" installed in VS. We shouldn't just explode if
         // you don't though - instead, disable debugging and try again.
-        WI_ClearFlag(deviceFlags, D3D11_CREATE_DEVICE_DEBUG);
+        WI_ClearFlag(createFlags, D3D11_CREATE_DEVICE_DEBUG);
 
         hr = D3D11CreateDevice(
             /* pAdapter           */ _p.dxgi.adapter.get(),
             /* DriverType         */ D3D_DRIVER_TYPE_UNKNOWN,
             /* Software           */ nullptr,
-            /* Flags              */ deviceFlags,
+            /* Flags              */ createFlags,
             /* pFeatureLevels     */ featureLevels.data(),
             /* FeatureLevels      */ gsl::narrow_cast<UINT>(featureLevels.size()),
             /* SDKVersion         */ D3D11_SDK_VERSION,
             /* ppDevice           */ device0.put(),
-            /* pFeatureLevel      */ &featureLevel,
+            /* pFeatureLevel      */ &shared->featureLevel,
             /* ppImmediateContext */ deviceContext0.put());
     }
 #endif
     THROW_IF_FAILED(hr);
 
-    auto device = device0.query<ID3D11Device2>();
-    auto deviceContext = deviceContext0.query<ID3D11DeviceContext2>();
+    shared->device = device0.query<ID3D11Device2>();
+    shared->deviceContext = deviceContext0.query<ID3D11DeviceContext2>();
 
 #ifndef NDEBUG
     if (IsDebuggerPresent())
     {
-        if (const auto d3dInfoQueue = device.try_query<ID3D11InfoQueue>())
+        if (const auto d3dInfoQueue = shared->device.try_query<ID3D11InfoQueue>())
         {
             for (const auto severity : { D3D11_MESSAGE_SEVERITY_CORRUPTION, D3D11_MESSAGE_SEVERITY_ERROR, D3D11_MESSAGE_SEVERITY_WARNING, D3D11_MESSAGE_SEVERITY_INFO })
             {
@@ -258,39 +518,16 @@ void AtlasEngine::_recreateBackend()
     }
 #endif
 
-    if (graphicsAPI == GraphicsAPI::Automatic)
+    // This is available on all systems with the D3D 11.4 runtime (Windows 10 1703 and later).
+    // Without it, the device is still fine to use for this engine alone.
+    shared->multithread = shared->device.try_query<ID3D11Multithread>();
+    if (shared->multithread)
     {
-        if (featureLevel < D3D_FEATURE_LEVEL_10_0)
-        {
-            graphicsAPI = GraphicsAPI::Direct2D;
-        }
-        else if (featureLevel < D3D_FEATURE_LEVEL_11_0)
-        {
-            D3D11_FEATURE_DATA_D3D10_X_HARDWARE_OPTIONS options{};
-            if (FAILED(device->CheckFeatureSupport(D3D11_FEATURE_D3D10_X_HARDWARE_OPTIONS, &options, sizeof(options))) ||
-                !options.ComputeShaders_Plus_RawAndStructuredBuffers_Via_Shader_4_x)
-            {
-                graphicsAPI = GraphicsAPI::Direct2D;
-            }
-        }
+        shared->multithread->SetMultithreadProtected(TRUE);
+        registry.emplace_back(shared);
     }
 
-    _p.device = std::move(device);
-    _p.deviceContext = std::move(deviceContext);
-
-    switch (graphicsAPI)
-    {
-    case GraphicsAPI::Direct2D:
-        _b = std::make_unique<BackendD2D>();
-        break;
-    default:
-        _b = std::make_unique<BackendD3D>(_p);
-        break;
-    }
-
-    // This ensures that the backends redraw their entire viewports whenever a new swap chain is created,
-    // EVEN IF we got called when no actual settings changed (i.e. rendering failure, etc.).
-    _p.MarkAllAsDirty();
+    return shared;
 }
 
 void AtlasEngine::_handleSwapChainUpdate()
@@ -398,8 +635,10 @@ void AtlasEngine::_destroySwapChain()
         }
         if (_p.deviceContext)
         {
+            const auto lock = _sharedDevice->Lock();
             _p.deviceContext->ClearState();
             _p.deviceContext->Flush();
+            _sharedDevice->contextOwner = nullptr;
         }
     }
 }
@@ -411,6 +650,7 @@ void AtlasEngine::_resizeBuffers()
 
     THROW_IF_FAILED(_p.swapChain.swapChain->ResizeBuffers(0, _p.s->targetSize.x, _p.s->targetSize.y, DXGI_FORMAT_UNKNOWN, swapChainFlags));
     _p.swapChain.targetSize = _p.s->targetSize;
+    _p.swapChain.retainsContents = false;
 }
 
 void AtlasEngine::_updateMatrixTransform()
@@ -443,6 +683,23 @@ void AtlasEngine::_waitUntilCanRender() noexcept
     }
 }
 
+// Saves the back buffer that was just rendered into. After _present() it would contain an older frame.
+void AtlasEngine::_captureFrame() noexcept
+try
+{
+    const auto path = std::exchange(_api.captureFramePath, {});
+
+    wil::com_ptr<ID3D11Texture2D> buffer;
+    THROW_IF_FAILED(_p.swapChain.swapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(buffer.addressof())));
+    WIC::SaveTextureToPNG(_p.deviceContext.get(), buffer.get(), _p.s->font->dpi, path.c_str());
+
+    _api.captureFrameResult = S_OK;
+}
+catch (...)
+{
+    _api.captureFrameResult = wil::ResultFromCaughtException();
+}
+
 void AtlasEngine::_present()
 {
     const RECT fullRect{ 0, 0, _p.swapChain.targetSize.x, _p.swapChain.targetSize.y };
@@ -491,6 +748,7 @@ void AtlasEngine::_present()
     }
 
     auto hr = _p.swapChain.swapChain->Present1(1, 0, &params);
+    _p.swapChain.retainsContents = SUCCEEDED(hr) && !_p.s->target->disablePresent1;
     if constexpr (Feature_AtlasEnginePresentFallback::IsEnabled())
     {
         if (FAILED(hr) && params.DirtyRectsCount != 0)
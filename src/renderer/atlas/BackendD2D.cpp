@@ -40,6 +40,26 @@ void BackendD2D::Render(RenderingPayload& p)
         _handleSettingsUpdate(p);
     }
 
+    const i32r fullRect{ 0, 0, p.s->targetSize.x, p.s->targetSize.y };
+    auto clip = fullRect;
+
+    // If the swap chain retains the previous frame, we only need to redraw the dirty rect. This way a blinking
+    // cursor or a scroll (whose Present1() scroll rect moves the old contents for us) doesn't redraw everything.
+#pragma warning(suppress : 4127) // conditional expression is constant
+    if (!ATLAS_DEBUG_SHOW_DIRTY && !ATLAS_DEBUG_DUMP_RENDER_TARGET && p.swapChain.retainsContents)
+    {
+        clip = {
+            std::max(p.dirtyRectInPx.left, 0),
+            std::max(p.dirtyRectInPx.top, 0),
+            std::min(p.dirtyRectInPx.right, fullRect.right),
+            std::min(p.dirtyRectInPx.bottom, fullRect.bottom),
+        };
+        if (clip.left >= clip.right || clip.top >= clip.bottom)
+        {
+            return;
+        }
+    }
+
     _renderTarget->BeginDraw();
     try
     {
@@ -47,10 +67,14 @@ void BackendD2D::Render(RenderingPayload& p)
         // Invalidating the render target helps with spotting Present1() bugs.
         _renderTarget->Clear();
 #endif
-        _drawBackground(p);
-        _drawCursorPart1(p);
-        _drawText(p);
-        _drawCursorPart2(p);
+        _drawFrame(p, clip);
+
+        // The new text may overhang the dirty rect (for instance tall glyphs that reach into the next row).
+        // Those parts of the neighboring rows need a redraw too, and the easiest way to do that is to draw everything.
+        if (clip != fullRect && (p.dirtyRectInPx.top < clip.top || p.dirtyRectInPx.bottom > clip.bottom))
+        {
+            _drawFrame(p, fullRect);
+        }
 #if ATLAS_DEBUG_SHOW_DIRTY
         _debugShowDirty(p);
 #endif
@@ -74,6 +98,22 @@ bool BackendD2D::RequiresContinuousRedraw() noexcept
     return false;
 }
 
+void BackendD2D::_drawFrame(RenderingPayload& p, const i32r& clip)
+{
+    const D2D1_RECT_F clipF{
+        static_cast<f32>(clip.left),
+        static_cast<f32>(clip.top),
+        static_cast<f32>(clip.right),
+        static_cast<f32>(clip.bottom),
+    };
+    _renderTarget->PushAxisAlignedClip(&clipF, D2D1_ANTIALIAS_MODE_ALIASED);
+    _drawBackground(p);
+    _drawCursorPart1(p);
+    _drawText(p, clip);
+    _drawCursorPart2(p);
+    _renderTarget->PopAxisAlignedClip();
+}
+
 void BackendD2D::_handleSettingsUpdate(const RenderingPayload& p)
 {
     const auto renderTargetChanged = !_renderTarget;
@@ -206,7 +246,7 @@ void BackendD2D::_drawBackground(const RenderingPayload& p)
     _renderTarget->SetPrimitiveBlend(D2D1_PRIMITIVE_BLEND_SOURCE_OVER);
 }
 
-void BackendD2D::_drawText(RenderingPayload& p)
+void BackendD2D::_drawText(RenderingPayload& p, const i32r& clip)
 {
     til::CoordType dirtyTop = til::CoordTypeMax;
     til::CoordType dirtyBottom = til::CoordTypeMin;
@@ -221,6 +261,18 @@ void BackendD2D::_drawText(RenderingPayload& p)
     u16 y = 0;
     for (const auto row : p.rows)
     {
+        // Skip rows that don't reach into the clip rect. dirtyTop/Bottom hold the extent of their last drawn contents.
+        {
+            const auto cellTop = y * p.s->font->cellSize.y;
+            const auto top = std::min<i32>(cellTop, row->dirtyTop);
+            const auto bottom = std::max<i32>(cellTop + p.s->font->cellSize.y, row->dirtyBottom);
+            if (bottom <= clip.top || top >= clip.bottom)
+            {
+                ++y;
+                continue;
+            }
+        }
+
         auto baselineX = 0.0f;
         auto baselineY = static_cast<f32>(p.s->font->cellSize.y * y + p.s->font->baseline);
 
@@ -436,6 +488,13 @@ void BackendD2D::_prepareBuiltinGlyphRenderTarget(const RenderingPayload& p)
     // The initial contents of the bitmap are undefined.
     // -> We need to define them. :)
     _builtinGlyphsRenderTarget->Clear();
+
+    // The bitmap has room for all of them anyway, so we might as well draw them all in one go. Otherwise,
+    // the first frame of a TUI full of borders gets stuck drawing them one by one in between its text.
+    for (u32 off = 0; off < BuiltinGlyphs::TotalCharCount; ++off)
+    {
+        _prepareBuiltinGlyph(p, BuiltinGlyphs::GetBitmapCellCodepoint(off), off);
+    }
 }
 
 D2D1_RECT_U BackendD2D::_prepareBuiltinGlyph(const RenderingPayload& p, char32_t ch, u32 off)
@@ -19,7 +19,8 @@ namespace Microsoft::Console::Render::Atlas
     private:
         ATLAS_ATTR_COLD void _handleSettingsUpdate(const RenderingPayload& p);
         void _drawBackground(const RenderingPayload& p);
-        void _drawText(RenderingPayload& p);
+        void _drawFrame(RenderingPayload& p, const i32r& clip);
+        void _drawText(RenderingPayload& p, const i32r& clip);
         ATLAS_ATTR_COLD f32 _drawBuiltinGlyphs(const RenderingPayload& p, const ShapedRow* row, const FontMapping& m, f32 baselineY, f32 baselineX);
         void _prepareBuiltinGlyphRenderTarget(const RenderingPayload& p);
         D2D1_RECT_U _prepareBuiltinGlyph(const RenderingPayload& p, char32_t ch, u32 off);
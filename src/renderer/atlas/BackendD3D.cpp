@@ -49,6 +49,28 @@ using namespace Microsoft::Console::Render::Atlas;
 static constexpr D2D1_MATRIX_3X2_F identityTransform{ .m11 = 1, .m22 = 1 };
 static constexpr D2D1_COLOR_F whiteColor{ 1, 1, 1, 1 };
 
+// The on-disk glyph atlas cache consists of a GlyphAtlasCacheHeader, followed by `faceCount` times a
+// GlyphAtlasCacheFace and its AtlasGlyphEntry items, followed by the `width * height` pixels of the text atlas.
+// Those are A8 or BGRA8, depending on the antialiasing mode, which is part of the file name (see _glyphAtlasFormat()).
+// Bump the version whenever the file format or the way glyphs are rasterized changes.
+static constexpr u32 glyphAtlasCacheMagic = 0x54414c47; // "GLAT"
+static constexpr u32 glyphAtlasCacheVersion = 3;
+
+struct GlyphAtlasCacheHeader
+{
+    u32 magic;
+    u32 version;
+    u16 width;
+    u16 height;
+    u32 faceCount;
+};
+
+struct GlyphAtlasCacheFace
+{
+    u64 key;
+    u32 glyphCount[4];
+};
+
 static u64 queryPerfFreq() noexcept
 {
     LARGE_INTEGER li;
@@ -133,6 +155,16 @@ BackendD3D::BackendD3D(const RenderingPayload& p)
         THROW_IF_FAILED(p.device->CreateBuffer(&desc, nullptr, _psConstantBuffer.addressof()));
     }
 
+    {
+        static constexpr D3D11_BUFFER_DESC desc{
+            .ByteWidth = sizeof(CursorConstBuffer),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+        };
+        const D3D11_SUBRESOURCE_DATA initialData{ &_cursorConstBufferData };
+        THROW_IF_FAILED(p.device->CreateBuffer(&desc, &initialData, _cursorConstantBuffer.addressof()));
+    }
+
     {
         // The final step of the ClearType blending algorithm is a lerp() between the premultiplied alpha
         // background color and straight alpha foreground color given the 3 RGB weights in alphaCorrected:
@@ -173,6 +205,18 @@ BackendD3D::BackendD3D(const RenderingPayload& p)
         THROW_IF_FAILED(p.device->CreateBlendState(&desc, _blendState.addressof()));
     }
 
+    {
+        // Identical to the default rasterizer state, but with scissor testing
+        // enabled, so that _beginIncrementalFrame() can limit drawing to the dirty area.
+        static constexpr D3D11_RASTERIZER_DESC desc{
+            .FillMode = D3D11_FILL_SOLID,
+            .CullMode = D3D11_CULL_BACK,
+            .DepthClipEnable = TRUE,
+            .ScissorEnable = TRUE,
+        };
+        THROW_IF_FAILED(p.device->CreateRasterizerState(&desc, _rasterizerState.addressof()));
+    }
+
 #if ATLAS_DEBUG_SHADER_HOT_RELOAD
     _sourceDirectory = std::filesystem::path{ __FILE__ }.parent_path();
     _sourceCodeWatcher = wil::make_folder_change_reader_nothrow(_sourceDirectory.c_str(), false, wil::FolderChangeEvents::FileName | wil::FolderChangeEvents::LastWriteTime, [this](wil::FolderChangeEvent, PCWSTR path) {
@@ -191,10 +235,13 @@ BackendD3D::~BackendD3D()
 {
     // In case an exception is thrown for some reason between BeginDraw() and EndDraw()
     // we still technically need to call EndDraw() before releasing any resources.
-    if (_d2dBeganDrawing)
+    for (auto& atlas : _glyphAtlases)
     {
+        if (atlas.d2dBeganDrawing)
+        {
 #pragma warning(suppress : 26447) // The function is declared 'noexcept' but calls function '...' which may throw exceptions (f.6).
-        LOG_IF_FAILED(_d2dRenderTarget->EndDraw());
+            LOG_IF_FAILED(atlas.d2dRenderTarget->EndDraw());
+        }
     }
 }
 
@@ -202,19 +249,49 @@ void BackendD3D::ReleaseResources() noexcept
 {
     _renderTargetView.reset();
     _customRenderTargetView.reset();
+    _previousFrame.reset();
+    _previousFrameValid = false;
     // Ensure _handleSettingsUpdate() is called so that _renderTarget gets recreated.
     _generation = {};
 }
 
 void BackendD3D::Render(RenderingPayload& p)
 {
-    if (_generation != p.s.generation())
+    // _drawGlyph() reports the time spent on rasterizing glyphs separately,
+    // so that time gets subtracted from the QuadBuilding phase again.
+    const auto timings = p.timings && p.timings->IsCapturing() ? p.timings : nullptr;
+    const auto renderStart = timings ? FrameTimings::clock::now() : FrameTimings::clock::time_point{};
+    const auto rasterizationBefore = timings ? timings->Get(FramePhase::GlyphRasterization) : FrameTimings::clock::duration{};
+    const auto recordTiming = wil::scope_exit([&]() noexcept {
+        if (timings)
+        {
+            const auto rasterization = timings->Get(FramePhase::GlyphRasterization) - rasterizationBefore;
+            timings->Add(FramePhase::QuadBuilding, FrameTimings::clock::now() - renderStart - rasterization);
+        }
+    });
+
+    _glyphAtlasFrame++;
+
+    // Any settings change (including a resize of the swap chain) may change the
+    // contents of the entire frame. The previous frame is of no use then.
+    const auto settingsChanged = _generation != p.s.generation();
+    if (settingsChanged)
     {
         _handleSettingsUpdate(p);
     }
+    else if (p.deviceContextStateLost)
+    {
+        _setupDeviceContextState(p);
+    }
 
     _debugUpdateShaders(p);
 
+    if (_smoothScrollOffsetY != p.smoothScrollOffsetY)
+    {
+        _smoothScrollOffsetY = p.smoothScrollOffsetY;
+        _updateVSConstBuffer(p);
+    }
+
     // After a Present() the render target becomes unbound.
     p.deviceContext->OMSetRenderTargets(1, _customRenderTargetView ? _customRenderTargetView.addressof() : _renderTargetView.addressof(), nullptr);
 
@@ -226,9 +303,42 @@ void BackendD3D::Render(RenderingPayload& p)
     }
 #endif
 
+    _incrementalFrame = !settingsChanged && _beginIncrementalFrame(p);
+    // If we throw half-way through, the back buffer is in an unknown state and the next frame must be drawn in full.
+    _previousFrameValid = false;
+
+    const auto unsavedGlyphs = _glyphAtlasCacheUnsaved;
     _drawBackground(p);
     _drawCursorBackground(p);
     _drawText(p);
+
+    // _drawText() extends the dirty rect by the glyphs of the invalidated rows. If any
+    // of them reach beyond the area we restricted drawing to, we'd cut them off.
+    // That's rare enough that we can simply start over and draw the entire frame.
+    if (_incrementalFrame)
+    {
+        const auto& s = _scissorRect;
+        const auto& d = p.dirtyRectInPx;
+        const auto targetSizeY = static_cast<til::CoordType>(p.s->targetSize.y);
+
+        if (d.left < s.left || d.right > s.right || std::max(d.top, 0) < s.top || std::min(d.bottom, targetSizeY) > s.bottom)
+        {
+            _incrementalFrame = false;
+            _instancesCount = 0;
+            _setScissorRect(p, { 0, 0, p.s->targetSize.x, p.s->targetSize.y });
+            _drawBackground(p);
+            _drawCursorBackground(p);
+            _drawText(p);
+        }
+    }
+
+    // Persist the glyph atlas once a frame didn't need any new glyphs. At that point it holds everything
+    // that's needed to draw the current contents, like the prompt of a freshly launched shell.
+    if (!_glyphAtlasCacheFile.empty() && _glyphAtlasCacheUnsaved >= _glyphAtlasCacheSaveThreshold && _glyphAtlasCacheUnsaved == unsavedGlyphs)
+    {
+        _saveGlyphAtlasCache(p);
+    }
+
     _debugShowDirty(p);
     _flushQuads(p);
 
@@ -236,6 +346,10 @@ void BackendD3D::Render(RenderingPayload& p)
     {
         _executeCustomShader(p);
     }
+    else
+    {
+        _savePreviousFrame(p);
+    }
 
     _debugDumpRenderTarget(p);
 }
@@ -345,19 +459,22 @@ void BackendD3D::_updateFontDependents(const RenderingPayload& p)
         }
     }
 
-    if (_d2dRenderTarget)
+    for (const auto& atlas : _glyphAtlases)
     {
-        _d2dRenderTargetUpdateFontSettings(p);
+        if (atlas.d2dRenderTarget)
+        {
+            _d2dRenderTargetUpdateFontSettings(p, atlas.d2dRenderTarget.get());
+        }
     }
 
     _softFontBitmap.reset();
 }
 
-void BackendD3D::_d2dRenderTargetUpdateFontSettings(const RenderingPayload& p) const noexcept
+void BackendD3D::_d2dRenderTargetUpdateFontSettings(const RenderingPayload& p, ID2D1DeviceContext* renderTarget) noexcept
 {
     const auto& font = *p.s->font;
-    _d2dRenderTarget->SetDpi(font.dpi, font.dpi);
-    _d2dRenderTarget->SetTextAntialiasMode(static_cast<D2D1_TEXT_ANTIALIAS_MODE>(font.antialiasingMode));
+    renderTarget->SetDpi(font.dpi, font.dpi);
+    renderTarget->SetTextAntialiasMode(static_cast<D2D1_TEXT_ANTIALIAS_MODE>(font.antialiasingMode));
 }
 
 void BackendD3D::_recreateCustomShader(const RenderingPayload& p)
@@ -562,22 +679,37 @@ void BackendD3D::_recreateBackgroundColorBitmap(const RenderingPayload& p)
         .ArraySize = 1,
         .Format = DXGI_FORMAT_R8G8B8A8_UNORM,
         .SampleDesc = { 1, 0 },
-        .Usage = D3D11_USAGE_DYNAMIC,
+        // Not D3D11_USAGE_DYNAMIC, because that only allows us to replace the entire texture,
+        // whereas _uploadBackgroundBitmap() only uploads the rows that changed.
+        .Usage = D3D11_USAGE_DEFAULT,
         .BindFlags = D3D11_BIND_SHADER_RESOURCE,
-        .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
     };
     THROW_IF_FAILED(p.device->CreateTexture2D(&desc, nullptr, _backgroundBitmap.addressof()));
     THROW_IF_FAILED(p.device->CreateShaderResourceView(_backgroundBitmap.get(), nullptr, _backgroundBitmapView.addressof()));
     _backgroundBitmapGeneration = {};
+
+    _decorationBitmap.reset();
+    _decorationBitmapView.reset();
+
+    auto decorationDesc = desc;
+    decorationDesc.Format = DXGI_FORMAT_R32G32_UINT;
+    THROW_IF_FAILED(p.device->CreateTexture2D(&decorationDesc, nullptr, _decorationBitmap.addressof()));
+    THROW_IF_FAILED(p.device->CreateShaderResourceView(_decorationBitmap.get(), nullptr, _decorationBitmapView.addressof()));
+
+    const size_t width = p.s->viewportCellCount.x;
+    const size_t height = p.s->viewportCellCount.y;
+    _decorationBitmapData = Buffer<u32x2>{ width * height };
+    _decorationRowScratch = Buffer<u32x2>{ width };
+    _decorationRowsUsed = Buffer<u8>{ height };
+    std::fill_n(_decorationBitmapData.data(), _decorationBitmapData.size(), u32x2{});
+    std::fill_n(_decorationRowsUsed.data(), _decorationRowsUsed.size(), u8{});
+    _decorationRowsUsedCount = 0;
+    _decorationBitmapDirty = true;
 }
 
 void BackendD3D::_recreateConstBuffer(const RenderingPayload& p) const
 {
-    {
-        VSConstBuffer data{};
-        data.positionScale = { 2.0f / p.s->targetSize.x, -2.0f / p.s->targetSize.y };
-        p.deviceContext->UpdateSubresource(_vsConstantBuffer.get(), 0, nullptr, &data, 0, 0);
-    }
+    _updateVSConstBuffer(p);
     {
         PSConstBuffer data{};
         data.backgroundColor = colorFromU32Premultiply<f32x4>(p.s->misc->backgroundColor);
@@ -592,10 +724,30 @@ void BackendD3D::_recreateConstBuffer(const RenderingPayload& p) const
         // So this ends up using a quarter line width for the dotted glyphs.
         // We use half that for the `cellSize.y`, because usually cells have an aspect ratio of 1:2.
         data.shadedGlyphDotSize = std::max(1.0f, std::roundf(std::max(p.s->font->cellSize.x / 12.0f, p.s->font->cellSize.y / 24.0f)));
+        const auto pos = [](const FontDecorationPosition& d) {
+            return f32x2{ static_cast<f32>(d.position), static_cast<f32>(d.height) };
+        };
+        data.gridTopPos = pos(p.s->font->gridTop);
+        data.gridBottomPos = pos(p.s->font->gridBottom);
+        data.gridLeftPos = pos(p.s->font->gridLeft);
+        data.gridRightPos = pos(p.s->font->gridRight);
+        data.strikethroughPos = pos(p.s->font->strikethrough);
+        data.underlinePos = pos(p.s->font->underline);
+        data.doubleUnderlinePos0 = pos(p.s->font->doubleUnderline[0]);
+        data.doubleUnderlinePos1 = pos(p.s->font->doubleUnderline[1]);
+        data.curlyUnderlinePos = pos(_curlyUnderline);
         p.deviceContext->UpdateSubresource(_psConstantBuffer.get(), 0, nullptr, &data, 0, 0);
     }
 }
 
+void BackendD3D::_updateVSConstBuffer(const RenderingPayload& p) const
+{
+    VSConstBuffer data{};
+    data.positionScale = { 2.0f / p.s->targetSize.x, -2.0f / p.s->targetSize.y };
+    data.positionOffset = { 0.0f, _smoothScrollOffsetY };
+    p.deviceContext->UpdateSubresource(_vsConstantBuffer.get(), 0, nullptr, &data, 0, 0);
+}
+
 void BackendD3D::_setupDeviceContextState(const RenderingPayload& p)
 {
     // IA: Input Assembler
@@ -618,14 +770,135 @@ void BackendD3D::_setupDeviceContextState(const RenderingPayload& p)
     p.deviceContext->RSSetViewports(1, &viewport);
 
     // PS: Pixel Shader
-    ID3D11ShaderResourceView* resources[]{ _backgroundBitmapView.get(), _glyphAtlasView.get() };
+    ID3D11Buffer* constantBuffers[]{ _psConstantBuffer.get(), _cursorConstantBuffer.get() };
     p.deviceContext->PSSetShader(_pixelShader.get(), nullptr, 0);
-    p.deviceContext->PSSetConstantBuffers(0, 1, _psConstantBuffer.addressof());
-    p.deviceContext->PSSetShaderResources(0, 2, &resources[0]);
+    p.deviceContext->PSSetConstantBuffers(0, 2, &constantBuffers[0]);
+    _bindShaderResources(p);
 
     // OM: Output Merger
     p.deviceContext->OMSetBlendState(_blendState.get(), nullptr, 0xffffffff);
     p.deviceContext->OMSetRenderTargets(1, _customRenderTargetView ? _customRenderTargetView.addressof() : _renderTargetView.addressof(), nullptr);
+
+    p.deviceContext->RSSetState(_rasterizerState.get());
+    _setScissorRect(p, { 0, 0, p.s->targetSize.x, p.s->targetSize.y });
+}
+
+// Most frames only change a few rows, or scroll the viewport by a line or two while tailing a log file.
+// Our swap chain is a flip model one however, where the back buffer holds whatever was drawn 3 frames ago.
+// To avoid drawing the entire frame anyway, we keep a copy of the previous frame around, and restore it
+// into the back buffer the same way Present1() restores it on the compositor's side: Shifted by the
+// scroll offset, with the newly scrolled in area being part of the dirty rect. Then we only need to
+// draw the dirty rect, which _drawText() helps with by skipping the rows that are entirely outside of it.
+//
+// Returns false if the entire frame needs to be drawn.
+bool BackendD3D::_beginIncrementalFrame(const RenderingPayload& p)
+{
+    const til::CoordType targetSizeX = p.s->targetSize.x;
+    const til::CoordType targetSizeY = p.s->targetSize.y;
+    const D3D11_RECT fullRect{ 0, 0, targetSizeX, targetSizeY };
+    const D3D11_RECT dirtyRect{
+        std::max(p.dirtyRectInPx.left, 0),
+        std::max(p.dirtyRectInPx.top, 0),
+        std::min(p.dirtyRectInPx.right, targetSizeX),
+        std::min(p.dirtyRectInPx.bottom, targetSizeY),
+    };
+
+#if ATLAS_DEBUG_SHOW_DIRTY || ATLAS_DEBUG_DUMP_RENDER_TARGET || ATLAS_DEBUG_CONTINUOUS_REDRAW
+    static constexpr bool debugForceFullFrame = true;
+#else
+    static constexpr bool debugForceFullFrame = false;
+#endif
+
+    // Restoring the previous frame costs about as much as drawing the background.
+    // If most of the frame is dirty anyway, it isn't worth it.
+    const auto dirtyArea = static_cast<LONGLONG>(std::max(0L, dirtyRect.right - dirtyRect.left)) * std::max(0L, dirtyRect.bottom - dirtyRect.top);
+    const auto fullArea = static_cast<LONGLONG>(targetSizeX) * targetSizeY;
+
+    if (debugForceFullFrame || _customPixelShader || !_previousFrameValid || dirtyArea * 2 > fullArea)
+    {
+        _setScissorRect(p, fullRect);
+        return false;
+    }
+
+    const auto height = static_cast<til::CoordType>(p.s->viewportCellCount.y) * p.s->font->cellSize.y;
+    const auto offsetInPx = p.scrollDeltaY * p.s->font->cellSize.y;
+    // Same as the scroll rect in AtlasEngine::_present(): It's the destination
+    // of the scrolled contents, which are read from y - offsetInPx.
+    const auto scrollTop = std::max(0, offsetInPx);
+    const auto scrollBottom = std::min(height + std::min(0, offsetInPx), targetSizeY);
+
+    if (scrollTop >= scrollBottom)
+    {
+        _setScissorRect(p, fullRect);
+        return false;
+    }
+
+    wil::com_ptr<ID3D11Resource> backBuffer;
+    _renderTargetView->GetResource(backBuffer.addressof());
+
+    if (offsetInPx == 0)
+    {
+        p.deviceContext->CopyResource(backBuffer.get(), _previousFrame.get());
+    }
+    else
+    {
+        const auto copy = [&](til::CoordType dstTop, til::CoordType srcTop, til::CoordType srcBottom) {
+            if (srcTop < srcBottom)
+            {
+                const D3D11_BOX box{ 0, gsl::narrow_cast<UINT>(srcTop), 0, gsl::narrow_cast<UINT>(targetSizeX), gsl::narrow_cast<UINT>(srcBottom), 1 };
+                p.deviceContext->CopySubresourceRegion(backBuffer.get(), 0, 0, gsl::narrow_cast<UINT>(dstTop), 0, _previousFrame.get(), 0, &box);
+            }
+        };
+
+        // The scrolled area and the unscrolled parts above and below it. The source and destination are
+        // different textures, so the overlap that CopySubresourceRegion() doesn't support can't happen.
+        // The newly scrolled in rows get copied as well, but they're part of the dirty rect anyway.
+        copy(scrollTop, scrollTop - offsetInPx, scrollBottom - offsetInPx);
+        copy(0, 0, scrollTop);
+        copy(scrollBottom, scrollBottom, targetSizeY);
+    }
+
+    _setScissorRect(p, dirtyRect);
+    return true;
+}
+
+void BackendD3D::_setScissorRect(const RenderingPayload& p, const D3D11_RECT& rect) noexcept
+{
+    p.deviceContext->RSSetScissorRects(1, &rect);
+    _scissorRect = rect;
+}
+
+void BackendD3D::_savePreviousFrame(const RenderingPayload& p)
+{
+    wil::com_ptr<ID3D11Resource> resource;
+    _renderTargetView->GetResource(resource.addressof());
+    const auto backBuffer = resource.query<ID3D11Texture2D>();
+
+    D3D11_TEXTURE2D_DESC desc{};
+    backBuffer->GetDesc(&desc);
+
+    if (_previousFrame)
+    {
+        D3D11_TEXTURE2D_DESC previousDesc{};
+        _previousFrame->GetDesc(&previousDesc);
+
+        if (previousDesc.Width != desc.Width || previousDesc.Height != desc.Height || previousDesc.Format != desc.Format)
+        {
+            _previousFrame.reset();
+        }
+    }
+
+    if (!_previousFrame)
+    {
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = 0;
+        desc.CPUAccessFlags = 0;
+        desc.MiscFlags = 0;
+        THROW_IF_FAILED(p.device->CreateTexture2D(&desc, nullptr, _previousFrame.addressof()));
+    }
+
+    p.deviceContext->CopyResource(_previousFrame.get(), backBuffer.get());
+    _previousFrameValid = true;
 }
 
 void BackendD3D::_debugUpdateShaders(const RenderingPayload& p) noexcept
@@ -724,25 +997,52 @@ void BackendD3D::_debugUpdateShaders(const RenderingPayload& p) noexcept
 #endif
 }
 
-void BackendD3D::_d2dBeginDrawing() noexcept
+void BackendD3D::_d2dBeginDrawing(GlyphAtlas& atlas) noexcept
 {
-    if (!_d2dBeganDrawing)
+    if (!atlas.d2dBeganDrawing)
     {
-        _d2dRenderTarget->BeginDraw();
-        _d2dBeganDrawing = true;
+        atlas.d2dRenderTarget->BeginDraw();
+        atlas.d2dBeganDrawing = true;
     }
 }
 
 void BackendD3D::_d2dEndDrawing()
 {
-    if (_d2dBeganDrawing)
+    for (auto& atlas : _glyphAtlases)
     {
-        THROW_IF_FAILED(_d2dRenderTarget->EndDraw());
-        _d2dBeganDrawing = false;
+        if (atlas.d2dBeganDrawing)
+        {
+            THROW_IF_FAILED(atlas.d2dRenderTarget->EndDraw());
+            atlas.d2dBeganDrawing = false;
+        }
     }
 }
 
-void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p, u32 minWidth, u32 minHeight)
+// Returns the atlas that glyphs with the given shading type are stored in.
+BackendD3D::GlyphAtlasKind BackendD3D::_glyphAtlasKind(ShadingType shadingType) noexcept
+{
+    return shadingType == ShadingType::TextBuiltinGlyph || shadingType == ShadingType::TextPassthrough ? GlyphAtlasKind::Color : GlyphAtlasKind::Text;
+}
+
+BackendD3D::GlyphAtlas& BackendD3D::_glyphAtlas(GlyphAtlasKind kind) noexcept
+{
+    return til::at(_glyphAtlases, WI_EnumValue(kind));
+}
+
+DXGI_FORMAT BackendD3D::_glyphAtlasFormat(const RenderingPayload& p, GlyphAtlasKind kind) noexcept
+{
+    // Grayscale and aliased text only needs the alpha channel, which cuts the size of the text atlas to a fourth.
+    // Rendering into A8 is supported by Direct2D and by every D3D device with feature level 10.0 and above,
+    // which is the minimum for BackendD3D. The 3 ClearType weights need BGRA, as there's no 24-bit format.
+    if (kind == GlyphAtlasKind::Text && p.s->font->antialiasingMode != AntialiasingMode::ClearType)
+    {
+        return DXGI_FORMAT_A8_UNORM;
+    }
+    return DXGI_FORMAT_B8G8R8A8_UNORM;
+}
+
+// Returns the size of the glyph atlas texture that _resetGlyphAtlas() and _compactGlyphAtlas() should use.
+u16x2 BackendD3D::_glyphAtlasSize(const RenderingPayload& p, GlyphAtlasKind kind, u32 minWidth, u32 minHeight) const noexcept
 {
     // The index returned by _BitScanReverse is undefined when the input is 0. We can simultaneously guard
     // against that and avoid unreasonably small textures, by clamping the min. texture size to `minArea`.
@@ -750,11 +1050,15 @@ void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p, u32 minWidth, u32 m
     static constexpr u32 minArea = 128 * 128;
     static constexpr u32 maxArea = D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION * D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION;
 
+    const auto& atlas = til::at(_glyphAtlases, WI_EnumValue(kind));
     const auto cellArea = static_cast<u32>(p.s->font->cellSize.x) * p.s->font->cellSize.y;
     const auto targetArea = static_cast<u32>(p.s->targetSize.x) * p.s->targetSize.y;
 
-    const auto minAreaByFont = cellArea * 95; // Covers all printable ASCII characters
-    const auto minAreaByGrowth = static_cast<u32>(_rectPacker.width) * _rectPacker.height * 2;
+    // The text atlas should fit all printable ASCII characters and the color atlas the builtin
+    // glyphs that _drawBuiltinGlyphsUpfront() puts in there. Color glyphs are comparatively rare.
+    const auto minCellsByFont = kind == GlyphAtlasKind::Text ? 95u : (p.s->font->builtinGlyphs ? BuiltinGlyphs::TotalCharCount : 0u);
+    const auto minAreaByFont = cellArea * minCellsByFont;
+    const auto minAreaByGrowth = static_cast<u32>(atlas.rectPacker.width) * atlas.rectPacker.height * 2;
 
     // It's hard to say what the max. size of the cache should be. Optimally I think we should use as much
     // memory as is available, but the rendering code in this project is a big mess and so integrating
@@ -787,12 +1091,37 @@ void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p, u32 minWidth, u32 m
         v = 1u << (index + 1);
     }
 
-    if (u != _rectPacker.width || v != _rectPacker.height)
+    return { u, v };
+}
+
+// Discards all glyphs in both atlases. minWidth/minHeight are the size of the glyph that didn't fit, if any.
+void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p, u32 minWidth, u32 minHeight)
+{
+    if (p.timings)
     {
-        _resizeGlyphAtlas(p, u, v);
+        p.timings->AddAtlasReset();
     }
 
-    stbrp_init_target(&_rectPacker, u, v, _rectPackerData.data(), _rectPackerData.size());
+    const auto fontChanged = _fontChangedResetGlyphAtlas;
+
+    for (const auto kind : { GlyphAtlasKind::Text, GlyphAtlasKind::Color })
+    {
+        auto& atlas = _glyphAtlas(kind);
+        const auto size = _glyphAtlasSize(p, kind, minWidth, minHeight);
+        const auto u = size.x;
+        const auto v = size.y;
+
+        // The format of the text atlas depends on the antialiasing mode.
+        if (u != atlas.rectPacker.width || v != atlas.rectPacker.height || atlas.format != _glyphAtlasFormat(p, kind))
+        {
+            _resizeGlyphAtlas(p, kind, u, v);
+        }
+
+        stbrp_init_target(&atlas.rectPacker, u, v, atlas.rectPackerData.data(), atlas.rectPackerData.size());
+
+        _d2dBeginDrawing(atlas);
+        atlas.d2dRenderTarget->Clear();
+    }
 
     // This is a little imperfect, because it only releases the memory of the glyph mappings, not the memory held by
     // any DirectWrite fonts. On the other side, the amount of fonts on a system is always finite, where "finite"
@@ -810,14 +1139,162 @@ void BackendD3D::_resetGlyphAtlas(const RenderingPayload& p, u32 minWidth, u32 m
         glyphs.clear();
     }
     _glyphAtlasBitmaps.clear();
+    _builtinGlyphsPending = true;
 
-    _d2dBeginDrawing();
-    _d2dRenderTarget->Clear();
+    _glyphAtlasCachedFaces.clear();
+    _glyphAtlasCacheUnsaved = 0;
+    _glyphAtlasCacheSaveThreshold = 1;
+
+    // Only the initial atlas for a given font is worth caching. When it's reset because it filled up
+    // we'll keep saving to the same file, but it won't be loaded unless the next atlas is equally large.
+    if (fontChanged)
+    {
+        _glyphAtlasCacheFile.clear();
+        if (p.s->font->persistGlyphAtlas)
+        {
+            _glyphAtlasCacheFile = _glyphAtlasCachePath(p, _gamma, _cleartypeEnhancedContrast, _grayscaleEnhancedContrast);
+            _loadGlyphAtlasCache(p);
+        }
+    }
 
     _fontChangedResetGlyphAtlas = false;
 }
 
-void BackendD3D::_resizeGlyphAtlas(const RenderingPayload& p, const u16 u, const u16 v)
+// Called when the given glyph atlas is full. Instead of discarding all glyphs like _resetGlyphAtlas() does, this copies
+// the most recently used ones into a new (possibly larger) atlas texture and only evicts the remaining ones.
+// The glyphs in the other atlas are unaffected.
+void BackendD3D::_compactGlyphAtlas(const RenderingPayload& p, GlyphAtlasKind kind, u32 minWidth, u32 minHeight)
+{
+    if (p.timings)
+    {
+        p.timings->AddAtlasReset();
+    }
+
+    struct Glyph
+    {
+        AtlasFontFaceEntry* fontFaceEntry;
+        size_t lineRendition;
+        AtlasGlyphEntry entry;
+    };
+
+    auto& atlas = _glyphAtlas(kind);
+    const auto oldArea = static_cast<u32>(atlas.rectPacker.width) * atlas.rectPacker.height;
+    const auto size = _glyphAtlasSize(p, kind, minWidth, minHeight);
+    const auto newArea = static_cast<u32>(size.x) * size.y;
+    // If the atlas grows we can keep all glyphs. Otherwise, we keep as many of the most recently used ones as fit
+    // into half of it. This leaves enough room for new glyphs, so that we don't need to compact it again right away.
+    const auto budget = newArea > oldArea ? newArea : newArea / 2;
+
+    std::vector<Glyph> glyphs;
+    const auto collect = [&](AtlasFontFaceEntry& fontFaceEntry) {
+        for (size_t i = 0; i < std::size(fontFaceEntry.glyphs); ++i)
+        {
+            auto& set = fontFaceEntry.glyphs[i];
+            for (const auto& g : set.container())
+            {
+                if (g.occupied)
+                {
+                    glyphs.emplace_back(&fontFaceEntry, i, g);
+                }
+            }
+            set.clear();
+        }
+    };
+    for (auto& slot : _glyphAtlasMap.container())
+    {
+        if (slot.fontFace)
+        {
+            collect(slot);
+        }
+    }
+    collect(_builtinGlyphs);
+
+    // Whitespace glyphs don't occupy any space in the atlas and the ones in the other atlas aren't moved. Both are always kept.
+    const auto whitespaceEnd = std::partition(glyphs.begin(), glyphs.end(), [&](const Glyph& g) {
+        return g.entry.shadingType == ShadingType::Default || _glyphAtlasKind(g.entry.shadingType) != kind;
+    });
+    // The builtin glyphs are pinned, no matter how long ago they were last used. See _drawBuiltinGlyphsUpfront().
+    const auto pinnedEnd = std::partition(whitespaceEnd, glyphs.end(), [&](const Glyph& g) {
+        return g.fontFaceEntry == &_builtinGlyphs && g.lineRendition == 0 && g.entry.shadingType == ShadingType::TextBuiltinGlyph;
+    });
+    std::sort(pinnedEnd, glyphs.end(), [](const Glyph& a, const Glyph& b) {
+        return a.entry.lastUsed > b.entry.lastUsed;
+    });
+
+    auto keepEnd = whitespaceEnd;
+    for (u32 area = 0; keepEnd != glyphs.end(); ++keepEnd)
+    {
+        area += static_cast<u32>(keepEnd->entry.size.x) * keepEnd->entry.size.y;
+        if (area > budget)
+        {
+            break;
+        }
+    }
+
+    const auto keepBeg = static_cast<size_t>(whitespaceEnd - glyphs.begin());
+    const auto keepCount = static_cast<size_t>(keepEnd - whitespaceEnd);
+    std::vector<stbrp_rect> rects(keepCount);
+    for (size_t i = 0; i < keepCount; ++i)
+    {
+        const auto& entry = glyphs[keepBeg + i].entry;
+        rects[i].w = entry.size.x;
+        rects[i].h = entry.size.y;
+    }
+
+    // Always create a new texture, because CopySubresourceRegion() doesn't support overlapping regions.
+    const auto oldGlyphAtlas = atlas.texture;
+    _resizeGlyphAtlas(p, kind, size.x, size.y);
+    stbrp_init_target(&atlas.rectPacker, size.x, size.y, atlas.rectPackerData.data(), atlas.rectPackerData.size());
+    if (!rects.empty())
+    {
+        stbrp_pack_rects(&atlas.rectPacker, rects.data(), gsl::narrow_cast<int>(rects.size()));
+    }
+
+    _d2dBeginDrawing(atlas);
+    atlas.d2dRenderTarget->Clear();
+    _d2dEndDrawing();
+
+    for (auto it = glyphs.begin(); it != whitespaceEnd; ++it)
+    {
+        *it->fontFaceEntry->glyphs[it->lineRendition].insert(it->entry.glyphIndex).first = it->entry;
+    }
+    for (size_t i = 0; i < keepCount; ++i)
+    {
+        const auto& rect = rects[i];
+        if (!rect.was_packed)
+        {
+            continue;
+        }
+
+        auto& g = glyphs[keepBeg + i];
+        const D3D11_BOX box{
+            g.entry.texcoord.x,
+            g.entry.texcoord.y,
+            0,
+            static_cast<UINT>(g.entry.texcoord.x + g.entry.size.x),
+            static_cast<UINT>(g.entry.texcoord.y + g.entry.size.y),
+            1,
+        };
+        p.deviceContext->CopySubresourceRegion(atlas.texture.get(), 0, rect.x, rect.y, 0, oldGlyphAtlas.get(), 0, &box);
+
+        g.entry.texcoord.x = rect.x;
+        g.entry.texcoord.y = rect.y;
+        *g.fontFaceEntry->glyphs[g.lineRendition].insert(g.entry.glyphIndex).first = g.entry;
+    }
+
+    if (kind == GlyphAtlasKind::Color)
+    {
+        // Bitmaps are cheap to upload again.
+        _glyphAtlasBitmaps.clear();
+    }
+    else
+    {
+        // The glyphs from the on-disk cache refer to the old atlas layout.
+        _glyphAtlasCachedFaces.clear();
+    }
+}
+
+void BackendD3D::_resizeGlyphAtlas(const RenderingPayload& p, GlyphAtlasKind kind, const u16 u, const u16 v)
 {
 #if defined(_M_X64) || defined(_M_IX86)
     static const auto faultyMacTypeVersion = _checkMacTypeVersion(p);
@@ -826,10 +1303,14 @@ void BackendD3D::_resizeGlyphAtlas(const RenderingPayload& p, const u16 u, const
     static constexpr auto faultyMacTypeVersion = false;
 #endif
 
-    _d2dRenderTarget.reset();
-    _d2dRenderTarget4.reset();
-    _glyphAtlas.reset();
-    _glyphAtlasView.reset();
+    auto& atlas = _glyphAtlas(kind);
+    const auto format = _glyphAtlasFormat(p, kind);
+
+    atlas.d2dRenderTarget.reset();
+    atlas.d2dRenderTarget4.reset();
+    atlas.texture.reset();
+    atlas.view.reset();
+    atlas.format = format;
 
     {
         const D3D11_TEXTURE2D_DESC desc{
@@ -837,59 +1318,463 @@ void BackendD3D::_resizeGlyphAtlas(const RenderingPayload& p, const u16 u, const
             .Height = v,
             .MipLevels = 1,
             .ArraySize = 1,
-            .Format = DXGI_FORMAT_B8G8R8A8_UNORM,
+            .Format = format,
             .SampleDesc = { 1, 0 },
             .BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET,
         };
-        THROW_IF_FAILED(p.device->CreateTexture2D(&desc, nullptr, _glyphAtlas.addressof()));
-        THROW_IF_FAILED(p.device->CreateShaderResourceView(_glyphAtlas.get(), nullptr, _glyphAtlasView.addressof()));
+        THROW_IF_FAILED(p.device->CreateTexture2D(&desc, nullptr, atlas.texture.addressof()));
+        THROW_IF_FAILED(p.device->CreateShaderResourceView(atlas.texture.get(), nullptr, atlas.view.addressof()));
+    }
+
+    {
+        const auto surface = atlas.texture.query<IDXGISurface>();
+
+        const D2D1_RENDER_TARGET_PROPERTIES props{
+            .type = D2D1_RENDER_TARGET_TYPE_DEFAULT,
+            .pixelFormat = { format, D2D1_ALPHA_MODE_PREMULTIPLIED },
+        };
+        // ID2D1RenderTarget and ID2D1DeviceContext are the same and I'm tired of pretending they're not.
+        THROW_IF_FAILED(p.d2dFactory->CreateDxgiSurfaceRenderTarget(surface.get(), &props, reinterpret_cast<ID2D1RenderTarget**>(atlas.d2dRenderTarget.addressof())));
+        atlas.d2dRenderTarget.try_query_to(atlas.d2dRenderTarget4.addressof());
+
+        atlas.d2dRenderTarget->SetUnitMode(D2D1_UNIT_MODE_PIXELS);
+        // Ensure that D2D uses the exact same gamma as our shader uses.
+        atlas.d2dRenderTarget->SetTextRenderingParams(_textRenderingParams.get());
+
+        _d2dRenderTargetUpdateFontSettings(p, atlas.d2dRenderTarget.get());
+    }
+
+    // We have our own glyph cache so Direct2D's cache doesn't help much.
+    // This saves us 1MB of RAM, which is not much, but also not nothing.
+    if (atlas.d2dRenderTarget4)
+    {
+        wil::com_ptr<ID2D1Device> device;
+        atlas.d2dRenderTarget4->GetDevice(device.addressof());
+
+        device->SetMaximumTextureMemory(0);
+
+        if (!faultyMacTypeVersion)
+        {
+            if (const auto device4 = device.try_query<ID2D1Device4>())
+            {
+                device4->SetMaximumColorGlyphCacheMemory(0);
+            }
+        }
+    }
+
+    // The brushes are shared by both atlases, which is fine since their render targets share a device.
+    {
+        THROW_IF_FAILED(atlas.d2dRenderTarget->CreateSolidColorBrush(&whiteColor, nullptr, _emojiBrush.put()));
+        THROW_IF_FAILED(atlas.d2dRenderTarget->CreateSolidColorBrush(&whiteColor, nullptr, _brush.put()));
+    }
+
+    if (p.timings)
+    {
+        u64 bytes = 0;
+        for (const auto& a : _glyphAtlases)
+        {
+            if (a.texture)
+            {
+                D3D11_TEXTURE2D_DESC desc;
+                a.texture->GetDesc(&desc);
+                bytes += u64{ desc.Width } * desc.Height * (desc.Format == DXGI_FORMAT_A8_UNORM ? 1 : 4);
+            }
+        }
+        p.timings->SetGlyphAtlasBytes(bytes);
+    }
+
+    _bindShaderResources(p);
+
+    atlas.rectPackerData = Buffer<stbrp_node>{ u };
+}
+
+void BackendD3D::_bindShaderResources(const RenderingPayload& p) const noexcept
+{
+    ID3D11ShaderResourceView* resources[]{
+        _backgroundBitmapView.get(),
+        til::at(_glyphAtlases, WI_EnumValue(GlyphAtlasKind::Text)).view.get(),
+        _decorationBitmapView.get(),
+        til::at(_glyphAtlases, WI_EnumValue(GlyphAtlasKind::Color)).view.get(),
+    };
+    p.deviceContext->PSSetShaderResources(0, 4, &resources[0]);
+}
+
+// The glyph atlas cache file is keyed by everything that affects how glyphs get rasterized.
+// Font faces are identified separately via _fontFaceCacheKey(), since the font fallback may pick any of them.
+std::wstring BackendD3D::_glyphAtlasCachePath(const RenderingPayload& p, f32 gamma, f32 cleartypeEnhancedContrast, f32 grayscaleEnhancedContrast)
+{
+    const auto& font = *p.s->font;
+
+    til::hasher h;
+    h.write(glyphAtlasCacheVersion);
+    h.write(font.fontName);
+    h.write(font.fontFeatures.data(), font.fontFeatures.size());
+    for (const auto& axis : font.fontAxisValues)
+    {
+        h.write(axis.axisTag);
+        h.write(axis.value);
+    }
+    h.write(font.fontSize);
+    h.write(font.cellSize);
+    h.write(font.fontWeight);
+    h.write(font.baseline);
+    h.write(font.dpi);
+    h.write(font.antialiasingMode);
+    h.write(font.colorGlyphs);
+    h.write(gamma);
+    h.write(cleartypeEnhancedContrast);
+    h.write(grayscaleEnhancedContrast);
+
+    wchar_t tempPath[MAX_PATH + 1];
+    const auto tempPathLength = GetTempPathW(MAX_PATH + 1, &tempPath[0]);
+    THROW_LAST_ERROR_IF(tempPathLength == 0 || tempPathLength > MAX_PATH);
+
+    // GetTempPathW() returns a path with a trailing backslash.
+    return fmt::format(FMT_COMPILE(L"{}AtlasEngine\\glyphs-{:016x}.bin"), std::wstring_view{ &tempPath[0], tempPathLength }, h.finalize());
+}
+
+// Returns a key that identifies the given font face across processes, or 0 if there isn't one.
+u64 BackendD3D::_fontFaceCacheKey(IDWriteFontFace2* fontFace)
+{
+    // Only faces backed by a single local font file can be identified reliably. Their
+    // reference key contains the file path and last modification time of the file.
+    UINT32 numberOfFiles = 0;
+    THROW_IF_FAILED(fontFace->GetFiles(&numberOfFiles, nullptr));
+    if (numberOfFiles != 1)
+    {
+        return 0;
+    }
+
+    wil::com_ptr<IDWriteFontFile> fontFile;
+    THROW_IF_FAILED(fontFace->GetFiles(&numberOfFiles, fontFile.addressof()));
+
+    wil::com_ptr<IDWriteFontFileLoader> loader;
+    THROW_IF_FAILED(fontFile->GetLoader(loader.addressof()));
+    if (!loader.try_query<IDWriteLocalFontFileLoader>())
+    {
+        return 0;
+    }
+
+    const void* fontFileReferenceKey;
+    UINT32 fontFileReferenceKeySize;
+    THROW_IF_FAILED(fontFile->GetReferenceKey(&fontFileReferenceKey, &fontFileReferenceKeySize));
+
+    til::hasher h;
+    h.write(fontFileReferenceKey, fontFileReferenceKeySize);
+    h.write(fontFace->GetIndex());
+    h.write(fontFace->GetSimulations());
+
+    if (const auto fontFace5 = wil::try_com_query<IDWriteFontFace5>(fontFace))
+    {
+        std::vector<DWRITE_FONT_AXIS_VALUE> axisValues(fontFace5->GetFontAxisValueCount());
+        THROW_IF_FAILED(fontFace5->GetFontAxisValues(axisValues.data(), gsl::narrow_cast<UINT32>(axisValues.size())));
+        for (const auto& axis : axisValues)
+        {
+            h.write(axis.axisTag);
+            h.write(axis.value);
+        }
+    }
+
+    return std::max<u64>(1, h.finalize());
+}
+
+// Called by _resetGlyphAtlas() to fill the freshly cleared atlas with the contents of _glyphAtlasCacheFile.
+// The glyph entries are restored lazily by _restoreCachedGlyphs() once we encounter their font face.
+void BackendD3D::_loadGlyphAtlasCache(const RenderingPayload& p) noexcept
+try
+{
+    const wil::unique_hfile file{ CreateFileW(_glyphAtlasCacheFile.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+    if (!file)
+    {
+        // Most likely this is the first time we're using this font.
+        return;
     }
 
+    // The cache can't be bigger than the largest atlas we could possibly create (plus some metadata).
+    static constexpr LONGLONG maxFileSize = 2ll * D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION * D3D10_REQ_TEXTURE2D_U_OR_V_DIMENSION * 4;
+    LARGE_INTEGER fileSize;
+    THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(file.get(), &fileSize));
+    if (fileSize.QuadPart < static_cast<LONGLONG>(sizeof(GlyphAtlasCacheHeader)) || fileSize.QuadPart > maxFileSize)
     {
-        const auto surface = _glyphAtlas.query<IDXGISurface>();
+        return;
+    }
+
+    std::vector<u8> data(gsl::narrow_cast<size_t>(fileSize.QuadPart));
+    DWORD read = 0;
+    THROW_IF_WIN32_BOOL_FALSE(ReadFile(file.get(), data.data(), gsl::narrow_cast<DWORD>(data.size()), &read, nullptr));
+
+    auto ptr = data.data();
+    const auto end = ptr + read;
+    const auto consume = [&](void* dst, size_t size) noexcept {
+        if (static_cast<size_t>(end - ptr) < size)
+        {
+            return false;
+        }
+        memcpy(dst, ptr, size);
+        ptr += size;
+        return true;
+    };
+
+    // Only the text atlas is persisted. Color glyphs are comparatively rare and builtin glyphs are cheap to draw.
+    auto& atlas = _glyphAtlas(GlyphAtlasKind::Text);
+
+    GlyphAtlasCacheHeader header;
+    if (!consume(&header, sizeof(header)) ||
+        header.magic != glyphAtlasCacheMagic ||
+        header.version != glyphAtlasCacheVersion ||
+        header.width != atlas.rectPacker.width ||
+        header.height == 0 ||
+        header.height > atlas.rectPacker.height ||
+        header.faceCount > static_cast<size_t>(end - ptr) / sizeof(GlyphAtlasCacheFace))
+    {
+        return;
+    }
+
+    std::vector<AtlasCachedFontFace> faces(header.faceCount);
+    for (auto& face : faces)
+    {
+        GlyphAtlasCacheFace faceHeader;
+        if (!consume(&faceHeader, sizeof(faceHeader)))
+        {
+            return;
+        }
+
+        face.key = faceHeader.key;
+
+        for (size_t i = 0; i < std::size(face.glyphs); ++i)
+        {
+            const auto count = faceHeader.glyphCount[i];
+            if (count > static_cast<size_t>(end - ptr) / sizeof(AtlasGlyphEntry))
+            {
+                return;
+            }
+
+            auto& glyphs = face.glyphs[i];
+            glyphs.resize(count);
+            consume(glyphs.data(), count * sizeof(AtlasGlyphEntry));
+
+            for (const auto& g : glyphs)
+            {
+                if (!g.occupied || _glyphAtlasKind(g.shadingType) != GlyphAtlasKind::Text || g.texcoord.x + g.size.x > header.width || g.texcoord.y + g.size.y > header.height)
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    const auto stride = static_cast<size_t>(header.width) * (atlas.format == DXGI_FORMAT_A8_UNORM ? 1 : 4);
+    if (static_cast<size_t>(end - ptr) != stride * header.height)
+    {
+        return;
+    }
+
+    // The Clear() in _resetGlyphAtlas() hasn't been submitted yet and would otherwise overwrite the upload.
+    _d2dEndDrawing();
+
+    const D3D11_BOX box{ 0, 0, 0, header.width, header.height, 1 };
+    p.deviceContext->UpdateSubresource(atlas.texture.get(), 0, &box, ptr, gsl::narrow_cast<UINT>(stride), 0);
+
+    // Reserve the restored area, so that new glyphs are placed below.
+    stbrp_rect rect{};
+    rect.w = header.width;
+    rect.h = header.height;
+    stbrp_pack_rects(&atlas.rectPacker, &rect, 1);
+
+    _glyphAtlasCachedFaces = std::move(faces);
+    for (auto& slot : _glyphAtlasMap.container())
+    {
+        if (slot.fontFace && !_glyphAtlasCachedFaces.empty())
+        {
+            _restoreCachedGlyphs(slot);
+        }
+    }
+
+    // There's no point in writing the same atlas back to disk unless it changed substantially.
+    _glyphAtlasCacheSaveThreshold = 64;
+}
+CATCH_LOG()
+
+// Writes the glyph atlas and the entries of all font faces that can be identified across processes to _glyphAtlasCacheFile.
+void BackendD3D::_saveGlyphAtlasCache(const RenderingPayload& p) noexcept
+try
+{
+    // Don't retry on every frame if this fails.
+    _glyphAtlasCacheUnsaved = 0;
+    _glyphAtlasCacheSaveThreshold = 64;
+
+    // Glyphs that were loaded from the cache, but haven't been used yet, are still valid.
+    auto faces = _glyphAtlasCachedFaces;
+    for (const auto& slot : _glyphAtlasMap.container())
+    {
+        if (!slot.fontFace)
+        {
+            continue;
+        }
+
+        const auto key = _fontFaceCacheKey(slot.fontFace.get());
+        if (!key)
+        {
+            continue;
+        }
+
+        auto& face = faces.emplace_back();
+        face.key = key;
+
+        for (size_t i = 0; i < std::size(face.glyphs); ++i)
+        {
+            for (const auto& g : slot.glyphs[i].container())
+            {
+                if (g.occupied && _glyphAtlasKind(g.shadingType) == GlyphAtlasKind::Text)
+                {
+                    face.glyphs[i].emplace_back(g);
+                }
+            }
+        }
+    }
+
+    u16 height = 0;
+    for (const auto& face : faces)
+    {
+        for (const auto& glyphs : face.glyphs)
+        {
+            for (const auto& g : glyphs)
+            {
+                height = std::max<u16>(height, g.texcoord.y + g.size.y);
+            }
+        }
+    }
+
+    if (!height)
+    {
+        return;
+    }
+
+    const auto& atlas = _glyphAtlas(GlyphAtlasKind::Text);
+    const auto width = static_cast<u16>(atlas.rectPacker.width);
+    const auto stride = static_cast<size_t>(width) * (atlas.format == DXGI_FORMAT_A8_UNORM ? 1 : 4);
+
+    wil::com_ptr<ID3D11Texture2D> staging;
+    {
+        const D3D11_TEXTURE2D_DESC desc{
+            .Width = width,
+            .Height = height,
+            .MipLevels = 1,
+            .ArraySize = 1,
+            .Format = atlas.format,
+            .SampleDesc = { 1, 0 },
+            .Usage = D3D11_USAGE_STAGING,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_READ,
+        };
+        THROW_IF_FAILED(p.device->CreateTexture2D(&desc, nullptr, staging.addressof()));
+    }
+
+    const D3D11_BOX box{ 0, 0, 0, width, height, 1 };
+    p.deviceContext->CopySubresourceRegion(staging.get(), 0, 0, 0, 0, atlas.texture.get(), 0, &box);
+
+    std::vector<u8> data;
+    const auto append = [&](const void* src, size_t size) {
+        const auto beg = static_cast<const u8*>(src);
+        data.insert(data.end(), beg, beg + size);
+    };
 
-        static constexpr D2D1_RENDER_TARGET_PROPERTIES props{
-            .type = D2D1_RENDER_TARGET_TYPE_DEFAULT,
-            .pixelFormat = { DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED },
-        };
-        // ID2D1RenderTarget and ID2D1DeviceContext are the same and I'm tired of pretending they're not.
-        THROW_IF_FAILED(p.d2dFactory->CreateDxgiSurfaceRenderTarget(surface.get(), &props, reinterpret_cast<ID2D1RenderTarget**>(_d2dRenderTarget.addressof())));
-        _d2dRenderTarget.try_query_to(_d2dRenderTarget4.addressof());
+    const GlyphAtlasCacheHeader header{
+        .magic = glyphAtlasCacheMagic,
+        .version = glyphAtlasCacheVersion,
+        .width = width,
+        .height = height,
+        .faceCount = gsl::narrow_cast<u32>(faces.size()),
+    };
+    append(&header, sizeof(header));
 
-        _d2dRenderTarget->SetUnitMode(D2D1_UNIT_MODE_PIXELS);
-        // Ensure that D2D uses the exact same gamma as our shader uses.
-        _d2dRenderTarget->SetTextRenderingParams(_textRenderingParams.get());
+    for (const auto& face : faces)
+    {
+        GlyphAtlasCacheFace faceHeader{ .key = face.key };
+        for (size_t i = 0; i < std::size(face.glyphs); ++i)
+        {
+            faceHeader.glyphCount[i] = gsl::narrow_cast<u32>(face.glyphs[i].size());
+        }
+        append(&faceHeader, sizeof(faceHeader));
 
-        _d2dRenderTargetUpdateFontSettings(p);
+        for (const auto& glyphs : face.glyphs)
+        {
+            append(glyphs.data(), glyphs.size() * sizeof(AtlasGlyphEntry));
+        }
     }
 
-    // We have our own glyph cache so Direct2D's cache doesn't help much.
-    // This saves us 1MB of RAM, which is not much, but also not nothing.
-    if (_d2dRenderTarget4)
     {
-        wil::com_ptr<ID2D1Device> device;
-        _d2dRenderTarget4->GetDevice(device.addressof());
+        D3D11_MAPPED_SUBRESOURCE mapped{};
+        THROW_IF_FAILED(p.deviceContext->Map(staging.get(), 0, D3D11_MAP_READ, 0, &mapped));
+        const auto unmap = wil::scope_exit([&]() noexcept {
+            p.deviceContext->Unmap(staging.get(), 0);
+        });
+
+        data.reserve(data.size() + stride * height);
+        auto src = static_cast<const u8*>(mapped.pData);
+        for (u16 y = 0; y < height; ++y)
+        {
+            append(src, stride);
+            src += mapped.RowPitch;
+        }
+    }
 
-        device->SetMaximumTextureMemory(0);
+    // Multiple windows may save the same cache file concurrently. Writing to a unique temporary
+    // file and moving it into place ensures that readers never observe a partially written file.
+    std::filesystem::path path{ _glyphAtlasCacheFile };
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
 
-        if (!faultyMacTypeVersion)
+    const auto tempPath = fmt::format(FMT_COMPILE(L"{}.{:x}.{:x}.tmp"), _glyphAtlasCacheFile, GetCurrentProcessId(), std::bit_cast<uintptr_t>(this));
+    {
+        const wil::unique_hfile file{ CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) };
+        THROW_LAST_ERROR_IF(!file);
+
+        DWORD written = 0;
+        const auto ok = WriteFile(file.get(), data.data(), gsl::narrow_cast<DWORD>(data.size()), &written, nullptr);
+        if (!ok || written != data.size())
         {
-            if (const auto device4 = device.try_query<ID2D1Device4>())
-            {
-                device4->SetMaximumColorGlyphCacheMemory(0);
-            }
+            LOG_LAST_ERROR_IF(!ok);
+            DeleteFileW(tempPath.c_str());
+            return;
         }
     }
 
+    if (!MoveFileExW(tempPath.c_str(), _glyphAtlasCacheFile.c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        LOG_LAST_ERROR();
+        DeleteFileW(tempPath.c_str());
+    }
+}
+CATCH_LOG()
+
+// Moves the glyphs loaded from the glyph atlas cache for the given font face (if any) into its glyph map.
+void BackendD3D::_restoreCachedGlyphs(AtlasFontFaceEntry& fontFaceEntry)
+{
+    const auto key = _fontFaceCacheKey(fontFaceEntry.fontFace.get());
+    if (!key)
+    {
+        return;
+    }
+
+    const auto it = std::find_if(_glyphAtlasCachedFaces.begin(), _glyphAtlasCachedFaces.end(), [&](const AtlasCachedFontFace& face) {
+        return face.key == key;
+    });
+    if (it == _glyphAtlasCachedFaces.end())
     {
-        THROW_IF_FAILED(_d2dRenderTarget->CreateSolidColorBrush(&whiteColor, nullptr, _emojiBrush.put()));
-        THROW_IF_FAILED(_d2dRenderTarget->CreateSolidColorBrush(&whiteColor, nullptr, _brush.put()));
+        return;
     }
 
-    ID3D11ShaderResourceView* resources[]{ _backgroundBitmapView.get(), _glyphAtlasView.get() };
-    p.deviceContext->PSSetShaderResources(0, 2, &resources[0]);
+    for (size_t i = 0; i < std::size(it->glyphs); ++i)
+    {
+        for (const auto& g : it->glyphs[i])
+        {
+            const auto entry = fontFaceEntry.glyphs[i].insert(g.glyphIndex).first;
+            *entry = g;
+            entry->lastUsed = 0;
+        }
+    }
 
-    _rectPackerData = Buffer<stbrp_node>{ u };
+    _glyphAtlasCachedFaces.erase(it);
 }
 
 // MacType is a popular 3rd party system to give the font rendering on Windows a softer look.
@@ -988,21 +1873,30 @@ void BackendD3D::_flushQuads(const RenderingPayload& p)
         return;
     }
 
-    if (!_cursorRects.empty())
-    {
-        _drawCursorForeground();
-    }
-
     // TODO: Shrink instances buffer
     if (_instancesCount > _instanceBufferCapacity)
     {
         _recreateInstanceBuffers(p);
     }
 
+    // _instanceBuffer is used as a ring buffer: Each flush appends its instances behind those of the
+    // previous one with D3D11_MAP_WRITE_NO_OVERWRITE, which promises the driver that we won't touch
+    // anything the GPU may still be reading. That's a lot cheaper than D3D11_MAP_WRITE_DISCARD,
+    // which makes the driver rename (= allocate) the entire buffer for each of the many flushes
+    // per frame. Only once we reach the end of the buffer we discard it and start over at 0.
+    // The driver takes care of keeping the old contents alive until the GPU is done with them,
+    // which is why we don't need any fences of our own.
+    auto mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+    if (_instanceBufferOffset + _instancesCount > _instanceBufferCapacity)
+    {
+        mapType = D3D11_MAP_WRITE_DISCARD;
+        _instanceBufferOffset = 0;
+    }
+
     {
         D3D11_MAPPED_SUBRESOURCE mapped{};
-        THROW_IF_FAILED(p.deviceContext->Map(_instanceBuffer.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
-        memcpy(mapped.pData, _instances.data(), _instancesCount * sizeof(QuadInstance));
+        THROW_IF_FAILED(p.deviceContext->Map(_instanceBuffer.get(), 0, mapType, 0, &mapped));
+        memcpy(static_cast<QuadInstance*>(mapped.pData) + _instanceBufferOffset, _instances.data(), _instancesCount * sizeof(QuadInstance));
         p.deviceContext->Unmap(_instanceBuffer.get(), 0);
     }
 
@@ -1025,15 +1919,17 @@ void BackendD3D::_flushQuads(const RenderingPayload& p)
     //   Instead I found that packing instance data as tightly as possible made the biggest performance difference,
     //   and packing 16 bit integers with ID3D11InputLayout is quite a bit more convenient too.
 
-    p.deviceContext->DrawIndexedInstanced(6, static_cast<UINT>(_instancesCount), 0, 0, 0);
+    p.deviceContext->DrawIndexedInstanced(6, static_cast<UINT>(_instancesCount), 0, 0, static_cast<UINT>(_instanceBufferOffset));
+    _instanceBufferOffset += _instancesCount;
     _instancesCount = 0;
 }
 
 void BackendD3D::_recreateInstanceBuffers(const RenderingPayload& p)
 {
     // We use the viewport size of the terminal as the initial estimate for the amount of instances we'll see.
+    // Since the buffer holds several flushes (see _flushQuads), we grow it geometrically beyond that.
     const auto minCapacity = static_cast<size_t>(p.s->viewportCellCount.x) * p.s->viewportCellCount.y;
-    auto newCapacity = std::max(_instancesCount, minCapacity);
+    auto newCapacity = std::max({ _instancesCount, minCapacity, _instanceBufferCapacity * 2 });
     auto newSize = newCapacity * sizeof(QuadInstance);
     // Round up to multiples of 64kB to avoid reallocating too often.
     // 64kB is the minimum alignment for committed resources in D3D12.
@@ -1060,6 +1956,7 @@ void BackendD3D::_recreateInstanceBuffers(const RenderingPayload& p)
     p.deviceContext->IASetVertexBuffers(0, 2, &vertexBuffers[0], &strides[0], &offsets[0]);
 
     _instanceBufferCapacity = newCapacity;
+    _instanceBufferOffset = 0;
 }
 
 void BackendD3D::_drawBackground(const RenderingPayload& p)
@@ -1078,23 +1975,30 @@ void BackendD3D::_drawBackground(const RenderingPayload& p)
 
 void BackendD3D::_uploadBackgroundBitmap(const RenderingPayload& p)
 {
-    D3D11_MAPPED_SUBRESOURCE mapped{};
-    THROW_IF_FAILED(p.deviceContext->Map(_backgroundBitmap.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
-
-    auto src = std::bit_cast<const char*>(p.backgroundBitmap.data());
-    const auto srcEnd = std::bit_cast<const char*>(p.backgroundBitmap.data() + p.backgroundBitmap.size());
-    const auto srcWidth = p.s->viewportCellCount.x * sizeof(u32);
-    const auto srcStride = p.colorBitmapRowStride * sizeof(u32);
-    auto dst = static_cast<char*>(mapped.pData);
+    // If we uploaded the bitmap during the previous Render() we only need to upload the rows that changed
+    // since then. Otherwise (the texture was just created, or we missed a frame) we upload all of it.
+    range<u16> rows{ 0, p.s->viewportCellCount.y };
+    if (_backgroundBitmapGeneration == p.backgroundBitmapBaseGeneration)
+    {
+        rows.start = std::min(p.backgroundBitmapDirtyRows.start, rows.end);
+        rows.end = std::min(p.backgroundBitmapDirtyRows.end, rows.end);
+    }
 
-    while (src < srcEnd)
+    if (rows.non_empty())
     {
-        memcpy(dst, src, srcWidth);
-        src += srcStride;
-        dst += mapped.RowPitch;
+        const D3D11_BOX box{
+            .left = 0,
+            .top = rows.start,
+            .front = 0,
+            .right = p.s->viewportCellCount.x,
+            .bottom = rows.end,
+            .back = 1,
+        };
+        const auto srcStride = p.colorBitmapRowStride * sizeof(u32);
+        const auto src = p.backgroundBitmap.data() + p.colorBitmapRowStride * rows.start;
+        p.deviceContext->UpdateSubresource(_backgroundBitmap.get(), 0, &box, src, gsl::narrow_cast<UINT>(srcStride), 0);
     }
 
-    p.deviceContext->Unmap(_backgroundBitmap.get(), 0);
     _backgroundBitmapGeneration = p.colorBitmapGenerations[0];
 }
 
@@ -1104,6 +2008,10 @@ void BackendD3D::_drawText(RenderingPayload& p)
     {
         _resetGlyphAtlas(p, 0, 0);
     }
+    if (_builtinGlyphsPending)
+    {
+        _drawBuiltinGlyphsUpfront(p);
+    }
 
     til::CoordType dirtyTop = til::CoordTypeMax;
     til::CoordType dirtyBottom = til::CoordTypeMin;
@@ -1127,6 +2035,17 @@ void BackendD3D::_drawText(RenderingPayload& p)
             }
         }
 
+        // This needs to happen even for rows we skip below, because scrolling moves rows around without invalidating them.
+        const auto gridlinesAsQuads = _updateDecorationBitmapRow(p, y);
+
+        // Rows outside of the dirty area have been restored from the previous frame by _beginIncrementalFrame().
+        // Their dirtyTop/Bottom still span all of their glyphs, because they were set when the row was last drawn.
+        if (_incrementalFrame && !p.invalidatedRows.contains(y) && (row->dirtyBottom <= _scissorRect.top || row->dirtyTop >= _scissorRect.bottom))
+        {
+            ++y;
+            continue;
+        }
+
         const u8x2 renditionScale{
             static_cast<u8>(row->lineRendition != LineRendition::SingleWidth ? 2 : 1),
             static_cast<u8>(row->lineRendition >= LineRendition::DoubleHeightTop ? 2 : 1),
@@ -1142,7 +2061,13 @@ void BackendD3D::_drawText(RenderingPayload& p)
             AtlasFontFaceEntry* fontFaceEntry = &_builtinGlyphs;
             if (fontFace) [[likely]]
             {
-                fontFaceEntry = _glyphAtlasMap.insert(fontFace).first;
+                const auto [entry, inserted] = _glyphAtlasMap.insert(fontFace);
+                fontFaceEntry = entry;
+
+                if (inserted && !_glyphAtlasCachedFaces.empty()) [[unlikely]]
+                {
+                    _restoreCachedGlyphs(*fontFaceEntry);
+                }
             }
 
             const auto& glyphs = fontFaceEntry->glyphs[WI_EnumValue(row->lineRendition)];
@@ -1165,6 +2090,7 @@ void BackendD3D::_drawText(RenderingPayload& p)
                 {
                     glyphEntry = _drawGlyph(p, *row, *fontFaceEntry, glyphIndex);
                 }
+                glyphEntry->lastUsed = _glyphAtlasFrame;
 
                 // A shadingType of 0 (ShadingType::Default) indicates a glyph that is whitespace.
                 if (glyphEntry->shadingType != ShadingType::Default)
@@ -1198,7 +2124,7 @@ void BackendD3D::_drawText(RenderingPayload& p)
             }
         }
 
-        if (!row->gridLineRanges.empty())
+        if (gridlinesAsQuads)
         {
             _drawGridlines(p, y);
         }
@@ -1217,6 +2143,11 @@ void BackendD3D::_drawText(RenderingPayload& p)
         ++y;
     }
 
+    if (_decorationRowsUsedCount)
+    {
+        _drawDecorations(p);
+    }
+
     if (dirtyTop < dirtyBottom)
     {
         p.dirtyRectInPx.top = std::min(p.dirtyRectInPx.top, dirtyTop);
@@ -1319,12 +2250,16 @@ void BackendD3D::_drawTextOverlapSplit(const RenderingPayload& p, u16 y)
 
 BackendD3D::AtlasGlyphEntry* BackendD3D::_drawGlyph(const RenderingPayload& p, const ShapedRow& row, AtlasFontFaceEntry& fontFaceEntry, u32 glyphIndex)
 {
+    const FrameTimings::Scope timing{ p.timings, FramePhase::GlyphRasterization };
+
     // The lack of a fontFace indicates a soft font.
     if (!fontFaceEntry.fontFace)
     {
         return _drawBuiltinGlyph(p, row, fontFaceEntry, glyphIndex);
     }
 
+    _glyphAtlasCacheUnsaved++;
+
     const auto glyphIndexU16 = static_cast<u16>(glyphIndex);
     const DWRITE_GLYPH_RUN glyphRun{
         .fontFace = fontFaceEntry.fontFace.get(),
@@ -1434,6 +2369,17 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawGlyph(const RenderingPayload& p, c
     }
 #endif
 
+    wil::com_ptr<IDWriteColorGlyphRunEnumerator1> enumerator;
+    if (p.s->font->colorGlyphs)
+    {
+        enumerator = TranslateColorGlyphRun(p.dwriteFactory4.get(), {}, &glyphRun);
+    }
+
+    const auto isColorGlyph = static_cast<bool>(enumerator);
+    const auto atlasKind = isColorGlyph ? GlyphAtlasKind::Color : GlyphAtlasKind::Text;
+    // NOTE: _drawGlyphAtlasAllocate() may recreate the render target. Don't hold onto it.
+    auto& atlas = _glyphAtlas(atlasKind);
+
     const int scale = row.lineRendition != LineRendition::SingleWidth;
     D2D1_MATRIX_3X2_F transform = identityTransform;
 
@@ -1441,11 +2387,11 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawGlyph(const RenderingPayload& p, c
     {
         transform.m11 = 2.0f;
         transform.m22 = row.lineRendition >= LineRendition::DoubleHeightTop ? 2.0f : 1.0f;
-        _d2dRenderTarget->SetTransform(&transform);
+        atlas.d2dRenderTarget->SetTransform(&transform);
     }
 
     const auto restoreTransform = wil::scope_exit([&]() noexcept {
-        _d2dRenderTarget->SetTransform(&identityTransform);
+        atlas.d2dRenderTarget->SetTransform(&identityTransform);
     });
 
     // This calculates the black box of the glyph, or in other words,
@@ -1466,38 +2412,27 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawGlyph(const RenderingPayload& p, c
     //                 (-1)           (+14)
     //
 
-    bool isColorGlyph = false;
     D2D1_RECT_F bounds = GlyphRunEmptyBounds;
 
     const auto antialiasingCleanup = wil::scope_exit([&]() {
         if (isColorGlyph)
         {
-            _d2dRenderTarget4->SetTextAntialiasMode(static_cast<D2D1_TEXT_ANTIALIAS_MODE>(p.s->font->antialiasingMode));
+            atlas.d2dRenderTarget4->SetTextAntialiasMode(static_cast<D2D1_TEXT_ANTIALIAS_MODE>(p.s->font->antialiasingMode));
         }
     });
 
+    if (!isColorGlyph)
     {
-        wil::com_ptr<IDWriteColorGlyphRunEnumerator1> enumerator;
-
-        if (p.s->font->colorGlyphs)
-        {
-            enumerator = TranslateColorGlyphRun(p.dwriteFactory4.get(), {}, &glyphRun);
-        }
+        THROW_IF_FAILED(atlas.d2dRenderTarget->GetGlyphRunWorldBounds({}, &glyphRun, DWRITE_MEASURING_MODE_NATURAL, &bounds));
+    }
+    else
+    {
+        atlas.d2dRenderTarget4->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
 
-        if (!enumerator)
-        {
-            THROW_IF_FAILED(_d2dRenderTarget->GetGlyphRunWorldBounds({}, &glyphRun, DWRITE_MEASURING_MODE_NATURAL, &bounds));
-        }
-        else
+        while (ColorGlyphRunMoveNext(enumerator.get()))
         {
-            isColorGlyph = true;
-            _d2dRenderTarget4->SetTextAntialiasMode(D2D1_TEXT_ANTIALIAS_MODE_GRAYSCALE);
-
-            while (ColorGlyphRunMoveNext(enumerator.get()))
-            {
-                const auto colorGlyphRun = ColorGlyphRunGetCurrentRun(enumerator.get());
-                ColorGlyphRunAccumulateBounds(_d2dRenderTarget.get(), colorGlyphRun, bounds);
-            }
+            const auto colorGlyphRun = ColorGlyphRunGetCurrentRun(enumerator.get());
+            ColorGlyphRunAccumulateBounds(atlas.d2dRenderTarget.get(), colorGlyphRun, bounds);
         }
     }
 
@@ -1516,8 +2451,8 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawGlyph(const RenderingPayload& p, c
         .w = br - bl,
         .h = bb - bt,
     };
-    _drawGlyphAtlasAllocate(p, rect);
-    _d2dBeginDrawing();
+    _drawGlyphAtlasAllocate(p, atlasKind, rect);
+    _d2dBeginDrawing(atlas);
 
     const D2D1_POINT_2F baselineOrigin{
         static_cast<f32>(rect.x - bl),
@@ -1528,20 +2463,20 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawGlyph(const RenderingPayload& p, c
     {
         transform.dx = (1.0f - transform.m11) * baselineOrigin.x;
         transform.dy = (1.0f - transform.m22) * baselineOrigin.y;
-        _d2dRenderTarget->SetTransform(&transform);
+        atlas.d2dRenderTarget->SetTransform(&transform);
     }
 
     if (!isColorGlyph)
     {
-        _d2dRenderTarget->DrawGlyphRun(baselineOrigin, &glyphRun, _brush.get(), DWRITE_MEASURING_MODE_NATURAL);
+        atlas.d2dRenderTarget->DrawGlyphRun(baselineOrigin, &glyphRun, _brush.get(), DWRITE_MEASURING_MODE_NATURAL);
     }
     else
     {
-        const auto enumerator = TranslateColorGlyphRun(p.dwriteFactory4.get(), baselineOrigin, &glyphRun);
+        enumerator = TranslateColorGlyphRun(p.dwriteFactory4.get(), baselineOrigin, &glyphRun);
         while (ColorGlyphRunMoveNext(enumerator.get()))
         {
             const auto colorGlyphRun = ColorGlyphRunGetCurrentRun(enumerator.get());
-            ColorGlyphRunDraw(_d2dRenderTarget4.get(), _emojiBrush.get(), _brush.get(), colorGlyphRun);
+            ColorGlyphRunDraw(atlas.d2dRenderTarget4.get(), _emojiBrush.get(), _brush.get(), colorGlyphRun);
         }
     }
 
@@ -1572,6 +2507,19 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawGlyph(const RenderingPayload& p, c
     return glyphEntry;
 }
 
+// This code works in tandem with SHADING_TYPE_TEXT_BUILTIN_GLYPH in our pixel shader.
+// Unless someone removed it, it should have a lengthy comment visually explaining
+// what each of the 3 RGB components do. The short version is:
+//   R: stretch the checkerboard pattern (Shape_Filled050) horizontally
+//   G: invert the pixels
+//   B: overrides the above and fills it
+static constexpr D2D1_COLOR_F builtinGlyphShadeColorMap[] = {
+    { 1, 0, 0, 1 }, // Shape_Filled025
+    { 0, 0, 0, 1 }, // Shape_Filled050
+    { 1, 1, 0, 1 }, // Shape_Filled075
+    { 1, 1, 1, 1 }, // Shape_Filled100
+};
+
 BackendD3D::AtlasGlyphEntry* BackendD3D::_drawBuiltinGlyph(const RenderingPayload& p, const ShapedRow& row, AtlasFontFaceEntry& fontFaceEntry, u32 glyphIndex)
 {
     auto baseline = p.s->font->baseline;
@@ -1587,8 +2535,13 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawBuiltinGlyph(const RenderingPayloa
         baseline <<= heightShift;
     }
 
-    _drawGlyphAtlasAllocate(p, rect);
-    _d2dBeginDrawing();
+    // Soft fonts are monochrome and go into the text atlas, while builtin glyphs use the RGB channels.
+    const auto isSoftFont = BuiltinGlyphs::IsSoftFontChar(glyphIndex);
+    const auto atlasKind = isSoftFont ? GlyphAtlasKind::Text : GlyphAtlasKind::Color;
+    _drawGlyphAtlasAllocate(p, atlasKind, rect);
+
+    auto& atlas = _glyphAtlas(atlasKind);
+    _d2dBeginDrawing(atlas);
 
     auto shadingType = ShadingType::TextGrayscale;
     const D2D1_RECT_F r{
@@ -1598,25 +2551,13 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawBuiltinGlyph(const RenderingPayloa
         static_cast<f32>(rect.y + rect.h),
     };
 
-    if (BuiltinGlyphs::IsSoftFontChar(glyphIndex))
+    if (isSoftFont)
     {
         shadingType = _drawSoftFontGlyph(p, r, glyphIndex);
     }
     else
     {
-        // This code works in tandem with SHADING_TYPE_TEXT_BUILTIN_GLYPH in our pixel shader.
-        // Unless someone removed it, it should have a lengthy comment visually explaining
-        // what each of the 3 RGB components do. The short version is:
-        //   R: stretch the checkerboard pattern (Shape_Filled050) horizontally
-        //   G: invert the pixels
-        //   B: overrides the above and fills it
-        static constexpr D2D1_COLOR_F shadeColorMap[] = {
-            { 1, 0, 0, 1 }, // Shape_Filled025
-            { 0, 0, 0, 1 }, // Shape_Filled050
-            { 1, 1, 0, 1 }, // Shape_Filled075
-            { 1, 1, 1, 1 }, // Shape_Filled100
-        };
-        BuiltinGlyphs::DrawBuiltinGlyph(p.d2dFactory.get(), _d2dRenderTarget.get(), _brush.get(), shadeColorMap, r, glyphIndex);
+        BuiltinGlyphs::DrawBuiltinGlyph(p.d2dFactory.get(), atlas.d2dRenderTarget.get(), _brush.get(), builtinGlyphShadeColorMap, r, glyphIndex);
         shadingType = ShadingType::TextBuiltinGlyph;
     }
 
@@ -1638,6 +2579,77 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawBuiltinGlyph(const RenderingPayloa
     return glyphEntry;
 }
 
+// Draws all single-width builtin glyphs into the atlas in a single batch, right after it was reset. A TUI full of borders
+// (tmux, lazygit, ...) would otherwise have to rasterize dozens of them one by one in the first frame after each reset.
+// _compactGlyphAtlas() keeps them around. Glyphs that don't fit are skipped and drawn on demand by _drawBuiltinGlyph().
+void BackendD3D::_drawBuiltinGlyphsUpfront(const RenderingPayload& p)
+{
+    _builtinGlyphsPending = false;
+
+    if (!p.s->font->builtinGlyphs)
+    {
+        return;
+    }
+
+    auto& glyphs = _builtinGlyphs.glyphs[WI_EnumValue(LineRendition::SingleWidth)];
+    std::array<stbrp_rect, BuiltinGlyphs::TotalCharCount> rects;
+    int count = 0;
+
+    for (u32 i = 0; i < BuiltinGlyphs::TotalCharCount; ++i)
+    {
+        const auto ch = BuiltinGlyphs::GetBitmapCellCodepoint(i);
+        // If the atlas was reset in the middle of the last frame, some of them may have been drawn since.
+        if (glyphs.lookup(static_cast<u16>(ch)))
+        {
+            continue;
+        }
+
+        auto& rect = til::at(rects, count++);
+        rect = {
+            .id = static_cast<int>(ch),
+            .w = p.s->font->cellSize.x,
+            .h = p.s->font->cellSize.y,
+        };
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    auto& atlas = _glyphAtlas(GlyphAtlasKind::Color);
+    stbrp_pack_rects(&atlas.rectPacker, rects.data(), count);
+    _d2dBeginDrawing(atlas);
+
+    for (int i = 0; i < count; ++i)
+    {
+        const auto& rect = til::at(rects, i);
+        if (!rect.was_packed)
+        {
+            continue;
+        }
+
+        const D2D1_RECT_F r{
+            static_cast<f32>(rect.x),
+            static_cast<f32>(rect.y),
+            static_cast<f32>(rect.x + rect.w),
+            static_cast<f32>(rect.y + rect.h),
+        };
+        BuiltinGlyphs::DrawBuiltinGlyph(p.d2dFactory.get(), atlas.d2dRenderTarget.get(), _brush.get(), builtinGlyphShadeColorMap, r, static_cast<char32_t>(rect.id));
+
+        const auto glyphEntry = glyphs.insert(static_cast<u16>(rect.id)).first;
+        glyphEntry->shadingType = ShadingType::TextBuiltinGlyph;
+        glyphEntry->overlapSplit = 0;
+        glyphEntry->offset.x = 0;
+        glyphEntry->offset.y = -p.s->font->baseline;
+        glyphEntry->size.x = rect.w;
+        glyphEntry->size.y = rect.h;
+        glyphEntry->texcoord.x = rect.x;
+        glyphEntry->texcoord.y = rect.y;
+        glyphEntry->lastUsed = 0;
+    }
+}
+
 BackendD3D::ShadingType BackendD3D::_drawSoftFontGlyph(const RenderingPayload& p, const D2D1_RECT_F& rect, u32 glyphIndex)
 {
     const auto width = static_cast<size_t>(p.s->font->softFontCellSize.width);
@@ -1651,62 +2663,84 @@ BackendD3D::ShadingType BackendD3D::_drawSoftFontGlyph(const RenderingPayload& p
         return ShadingType::Default;
     }
 
+    // Each glyph gets SoftFontGlyphPadding transparent rows above and below it, so that
+    // the cubic interpolation doesn't pick up the neighboring glyphs in the bitmap.
+    const auto stride = height + 2 * SoftFontGlyphPadding;
+    const auto renderTarget = _glyphAtlas(GlyphAtlasKind::Text).d2dRenderTarget.get();
+
     if (!_softFontBitmap)
     {
-        // Allocating such a tiny texture is very wasteful (min. texture size on GPUs
-        // right now is 64kB), but this is a seldom used feature, so it's fine...
+        // All glyphs of the soft font are uploaded at once, stacked on top of each other, instead of
+        // copying each one into a tiny bitmap of its own whenever it gets drawn. The bitmap is reset
+        // whenever the font (and with it the soft font) changes, which also clears the glyph atlas.
+        const auto glyphCount = p.s->font->softFontPattern.size() / height;
         const D2D1_SIZE_U size{
             static_cast<UINT32>(width),
-            static_cast<UINT32>(height),
+            static_cast<UINT32>(glyphCount * stride),
         };
+        // The DPI is left at the default of 96, which means that the source rectangles below are in pixels.
         const D2D1_BITMAP_PROPERTIES1 bitmapProperties{
             .pixelFormat = { DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED },
-            .dpiX = static_cast<f32>(p.s->font->dpi),
-            .dpiY = static_cast<f32>(p.s->font->dpi),
         };
-        THROW_IF_FAILED(_d2dRenderTarget->CreateBitmap(size, nullptr, 0, &bitmapProperties, _softFontBitmap.addressof()));
-    }
 
-    {
-        auto bitmapData = Buffer<u32>{ width * height };
+        auto bitmapData = Buffer<u32>{ size.width * size.height };
         auto dst = bitmapData.begin();
 
-        for (auto srcBits : data)
+        for (size_t i = 0; i < glyphCount; i++)
         {
-            for (size_t x = 0; x < width; x++)
+            dst = std::fill_n(dst, width * SoftFontGlyphPadding, 0u);
+
+            for (auto srcBits : til::safe_slice_len(p.s->font->softFontPattern, height * i, height))
             {
-                const auto srcBitIsSet = (srcBits & 0x8000) != 0;
-                *dst++ = srcBitIsSet ? 0xffffffff : 0x00000000;
-                srcBits <<= 1;
+                for (size_t x = 0; x < width; x++)
+                {
+                    const auto srcBitIsSet = (srcBits & 0x8000) != 0;
+                    *dst++ = srcBitIsSet ? 0xffffffff : 0x00000000;
+                    srcBits <<= 1;
+                }
             }
+
+            dst = std::fill_n(dst, width * SoftFontGlyphPadding, 0u);
         }
 
         const auto pitch = static_cast<UINT32>(width * sizeof(u32));
-        THROW_IF_FAILED(_softFontBitmap->CopyFromMemory(nullptr, bitmapData.data(), pitch));
+        THROW_IF_FAILED(renderTarget->CreateBitmap(size, bitmapData.data(), pitch, &bitmapProperties, _softFontBitmap.addressof()));
     }
 
-    _d2dRenderTarget->PushAxisAlignedClip(&rect, D2D1_ANTIALIAS_MODE_ALIASED);
+    renderTarget->PushAxisAlignedClip(&rect, D2D1_ANTIALIAS_MODE_ALIASED);
     const auto restoreD2D = wil::scope_exit([&]() {
-        _d2dRenderTarget->PopAxisAlignedClip();
+        renderTarget->PopAxisAlignedClip();
     });
 
+    const auto top = static_cast<f32>(softFontIndex * stride + SoftFontGlyphPadding);
+    const D2D1_RECT_F srcRect{ 0, top, static_cast<f32>(width), top + static_cast<f32>(height) };
     const auto interpolation = p.s->font->antialiasingMode == AntialiasingMode::Aliased ? D2D1_INTERPOLATION_MODE_NEAREST_NEIGHBOR : D2D1_INTERPOLATION_MODE_HIGH_QUALITY_CUBIC;
-    _d2dRenderTarget->DrawBitmap(_softFontBitmap.get(), &rect, 1, interpolation, nullptr, nullptr);
+    renderTarget->DrawBitmap(_softFontBitmap.get(), &rect, 1, interpolation, &srcRect, nullptr);
     return ShadingType::TextGrayscale;
 }
 
-void BackendD3D::_drawGlyphAtlasAllocate(const RenderingPayload& p, stbrp_rect& rect)
+void BackendD3D::_drawGlyphAtlasAllocate(const RenderingPayload& p, GlyphAtlasKind kind, stbrp_rect& rect)
 {
-    if (stbrp_pack_rects(&_rectPacker, &rect, 1))
+    auto& atlas = _glyphAtlas(kind);
+
+    if (stbrp_pack_rects(&atlas.rectPacker, &rect, 1))
     {
         return;
     }
 
     _d2dEndDrawing();
     _flushQuads(p);
+    _compactGlyphAtlas(p, kind, rect.w, rect.h);
+
+    if (stbrp_pack_rects(&atlas.rectPacker, &rect, 1))
+    {
+        return;
+    }
+
+    // The atlas is too fragmented to fit the glyph even after evicting the least recently used ones.
     _resetGlyphAtlas(p, rect.w, rect.h);
 
-    if (!stbrp_pack_rects(&_rectPacker, &rect, 1))
+    if (!stbrp_pack_rects(&atlas.rectPacker, &rect, 1))
     {
         THROW_HR(HRESULT_FROM_WIN32(ERROR_POSSIBLE_DEADLOCK));
     }
@@ -1716,6 +2750,7 @@ BackendD3D::AtlasGlyphEntry* BackendD3D::_drawGlyphAllocateEntry(const ShapedRow
 {
     const auto glyphEntry = fontFaceEntry.glyphs[WI_EnumValue(row.lineRendition)].insert(glyphIndex).first;
     glyphEntry->shadingType = ShadingType::Default;
+    glyphEntry->lastUsed = 0;
     return glyphEntry;
 }
 
@@ -1756,6 +2791,100 @@ void BackendD3D::_splitDoubleHeightGlyph(const RenderingPayload& p, const Shaped
     }
 }
 
+// Encodes the gridlines of the given row into _decorationBitmapData, which _drawDecorations() then draws in a single quad.
+// Rows with a line rendition need their lines to be scaled and clipped, which is rare and left to _drawGridlines().
+//
+// Returns true if _drawGridlines() needs to be called for this row.
+bool BackendD3D::_updateDecorationBitmapRow(const RenderingPayload& p, u16 y)
+{
+    const auto row = p.rows[y];
+    const auto asQuads = row->lineRendition != LineRendition::SingleWidth;
+    const auto encode = !asQuads && !row->gridLineRanges.empty();
+    const size_t width = p.s->viewportCellCount.x;
+    const auto dst = _decorationBitmapData.data() + y * width;
+    auto& used = _decorationRowsUsed[y];
+
+    if (!encode)
+    {
+        if (used)
+        {
+            std::fill_n(dst, width, u32x2{});
+            used = false;
+            _decorationRowsUsedCount--;
+            _decorationBitmapDirty = true;
+        }
+        return asQuads && !row->gridLineRanges.empty();
+    }
+
+    // See shader_ps.hlsl: The colors are always opaque (see AtlasEngine::PaintBufferGridLines)
+    // which means we can store the GridLineSet in their alpha bytes instead.
+    static_assert(static_cast<int>(GridLines::HyperlinkUnderline) < 16);
+
+    const auto scratch = _decorationRowScratch.data();
+    std::fill_n(scratch, width, u32x2{});
+
+    for (const auto& r : row->gridLineRanges)
+    {
+        const auto bits = static_cast<u32>(r.lines.bits());
+        const auto gridline = (r.gridlineColor & 0xffffff) | (bits & 0xff) << 24;
+        const auto underline = (r.underlineColor & 0xffffff) | (bits >> 8 & 0xff) << 24;
+
+        // Overlapping ranges combine their lines, but the last one decides the colors.
+        for (auto x = r.from; x < r.to; ++x)
+        {
+            auto& c = scratch[x];
+            c.x = (c.x & 0xff000000) | gridline;
+            c.y = (c.y & 0xff000000) | underline;
+        }
+    }
+
+    if (memcmp(dst, scratch, width * sizeof(u32x2)) != 0)
+    {
+        memcpy(dst, scratch, width * sizeof(u32x2));
+        _decorationBitmapDirty = true;
+    }
+    if (!used)
+    {
+        used = true;
+        _decorationRowsUsedCount++;
+    }
+    return false;
+}
+
+void BackendD3D::_drawDecorations(const RenderingPayload& p)
+{
+    if (_decorationBitmapDirty)
+    {
+        _uploadDecorationBitmap(p);
+    }
+
+    _appendQuad() = {
+        .shadingType = static_cast<u16>(ShadingType::Decorations),
+        .size = p.s->targetSize,
+    };
+}
+
+void BackendD3D::_uploadDecorationBitmap(const RenderingPayload& p)
+{
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    THROW_IF_FAILED(p.deviceContext->Map(_decorationBitmap.get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped));
+
+    auto src = std::bit_cast<const char*>(_decorationBitmapData.data());
+    const auto srcEnd = std::bit_cast<const char*>(_decorationBitmapData.data() + _decorationBitmapData.size());
+    const auto srcStride = p.s->viewportCellCount.x * sizeof(u32x2);
+    auto dst = static_cast<char*>(mapped.pData);
+
+    while (src < srcEnd)
+    {
+        memcpy(dst, src, srcStride);
+        src += srcStride;
+        dst += mapped.RowPitch;
+    }
+
+    p.deviceContext->Unmap(_decorationBitmap.get(), 0);
+    _decorationBitmapDirty = false;
+}
+
 void BackendD3D::_drawGridlines(const RenderingPayload& p, u16 y)
 {
     const auto row = p.rows[y];
@@ -1880,8 +3009,10 @@ void BackendD3D::_drawBitmap(const RenderingPayload& p, const ShapedRow* row, u1
             .w = p.s->font->cellSize.x * b.targetWidth,
             .h = p.s->font->cellSize.y,
         };
-        _drawGlyphAtlasAllocate(p, rect);
-        _d2dBeginDrawing();
+        _drawGlyphAtlasAllocate(p, GlyphAtlasKind::Color, rect);
+
+        auto& atlas = _glyphAtlas(GlyphAtlasKind::Color);
+        _d2dBeginDrawing(atlas);
 
         const D2D1_SIZE_U size{
             static_cast<UINT32>(b.sourceSize.x),
@@ -1893,7 +3024,7 @@ void BackendD3D::_drawBitmap(const RenderingPayload& p, const ShapedRow* row, u1
             .dpiY = static_cast<f32>(p.s->font->dpi),
         };
         wil::com_ptr<ID2D1Bitmap> bitmap;
-        THROW_IF_FAILED(_d2dRenderTarget->CreateBitmap(size, b.source.data(), static_cast<UINT32>(b.sourceSize.x) * 4, &bitmapProperties, bitmap.addressof()));
+        THROW_IF_FAILED(atlas.d2dRenderTarget->CreateBitmap(size, b.source.data(), static_cast<UINT32>(b.sourceSize.x) * 4, &bitmapProperties, bitmap.addressof()));
 
         const D2D1_RECT_F rectF{
             static_cast<f32>(rect.x),
@@ -1901,7 +3032,7 @@ void BackendD3D::_drawBitmap(const RenderingPayload& p, const ShapedRow* row, u1
             static_cast<f32>(rect.x + rect.w),
             static_cast<f32>(rect.y + rect.h),
         };
-        _d2dRenderTarget->DrawBitmap(bitmap.get(), &rectF, 1, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR);
+        atlas.d2dRenderTarget->DrawBitmap(bitmap.get(), &rectF, 1, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR);
 
         ab = _glyphAtlasBitmaps.insert(b.revision).first;
         ab->size.x = static_cast<u16>(rect.w);
@@ -1926,18 +3057,18 @@ void BackendD3D::_drawCursorBackground(const RenderingPayload& p)
 {
     _cursorRects.clear();
 
+    // Besides the cursor's background quads, this also provides the pixel shader with the cursor's
+    // location, which it uses to recolor the text and gridlines underneath it. Doing this on the GPU
+    // means we don't need to split up the text quads around the cursor whenever it moves or blinks.
+    const auto updateConstBuffer = wil::scope_exit([&]() {
+        _updateCursorConstBuffer(p);
+    });
+
     if (p.cursorRect.empty())
     {
         return;
     }
 
-    _cursorPosition = {
-        p.s->font->cellSize.x * p.cursorRect.left,
-        p.s->font->cellSize.y * p.cursorRect.top,
-        p.s->font->cellSize.x * p.cursorRect.right,
-        p.s->font->cellSize.y * p.cursorRect.bottom,
-    };
-
     const auto cursorColor = p.s->cursor->cursorColor;
     const auto offset = p.cursorRect.top * p.colorBitmapRowStride;
 
@@ -2043,211 +3174,44 @@ void BackendD3D::_drawCursorBackground(const RenderingPayload& p)
     }
 }
 
-void BackendD3D::_drawCursorForeground()
+void BackendD3D::_updateCursorConstBuffer(const RenderingPayload& p)
 {
-    // NOTE: _appendQuad() may reallocate the _instances vector. It's important to iterate
-    // by index, because pointers (or iterators) would get invalidated. It's also important
-    // to cache the original _instancesCount since it'll get changed with each append.
-    auto instancesCount = _instancesCount;
-    size_t instancesOffset = 0;
-
-    assert(instancesCount != 0);
-
-    // All of the text drawing primitives are drawn as a single block, after drawing
-    // the background and cursor background and before drawing the selection overlay.
-    // To avoid having to check the shadingType in the loop below, we'll find the
-    // start and end of this "block" here in advance.
-    for (; instancesOffset < instancesCount; ++instancesOffset)
-    {
-        const auto shadingType = static_cast<ShadingType>(_instances[instancesOffset].shadingType);
-        if (shadingType >= ShadingType::TextDrawingFirst && shadingType <= ShadingType::TextDrawingLast)
-        {
-            break;
-        }
-    }
-    // We can also skip any instances (= any rows) at the beginning that are clearly not overlapping with
-    // the cursor. This reduces the CPU cost of this function by roughly half (a few microseconds).
-    for (; instancesOffset < instancesCount; ++instancesOffset)
-    {
-        const auto& it = _instances[instancesOffset];
-        if ((it.position.y + it.size.y) > _cursorPosition.top)
-        {
-            break;
-        }
-    }
-
-    // Now do the same thing as above, but backwards from the end.
-    for (; instancesCount > instancesOffset; --instancesCount)
-    {
-        const auto shadingType = static_cast<ShadingType>(_instances[instancesCount - 1].shadingType);
-        if (shadingType >= ShadingType::TextDrawingFirst && shadingType <= ShadingType::TextDrawingLast)
-        {
-            break;
-        }
-    }
-    for (; instancesCount > instancesOffset; --instancesCount)
-    {
-        const auto& it = _instances[instancesCount - 1];
-        if (it.position.y < _cursorPosition.bottom)
-        {
-            break;
-        }
-    }
+    CursorConstBuffer data{};
 
-    // For cursors with multiple rectangles this really isn't all that fast, because it iterates
-    // over the instances vector multiple times. But I also don't really care, because the
-    // double-underline and empty-box cursors are pretty annoying to deal with in any case.
-    //
-    // It would definitely help if instead of position & size QuadInstances would use left/top/right/bottom
-    // with f32, because then computing the intersection would be much faster via SIMD. But that would
-    // make the struct size larger and cost more power to transmit more data to the GPU. ugh.
-    for (const auto& c : _cursorRects)
+    if (!_cursorRects.empty())
     {
-        const int cursorL = c.position.x;
-        const int cursorT = c.position.y;
-        const int cursorR = cursorL + c.size.x;
-        const int cursorB = cursorT + c.size.y;
+        assert(_cursorRects.size() <= MaxCursorRects);
+        data.count = gsl::narrow_cast<u32>(std::min(_cursorRects.size(), MaxCursorRects));
+        data.bounds = {
+            static_cast<f32>(p.s->font->cellSize.x * p.cursorRect.left),
+            static_cast<f32>(p.s->font->cellSize.y * p.cursorRect.top),
+            static_cast<f32>(p.s->font->cellSize.x * p.cursorRect.right),
+            static_cast<f32>(p.s->font->cellSize.y * p.cursorRect.bottom),
+        };
 
-        for (size_t i = instancesOffset; i < instancesCount; ++i)
+        for (u32 i = 0; i < data.count; ++i)
         {
-            const auto& it = _instances[i];
-            const int instanceL = it.position.x;
-            const int instanceT = it.position.y;
-            const int instanceR = instanceL + it.size.x;
-            const int instanceB = instanceT + it.size.y;
-
-            if (instanceL < cursorR && instanceR > cursorL && instanceT < cursorB && instanceB > cursorT)
+            const auto& c = _cursorRects[i];
+            const auto l = static_cast<f32>(c.position.x);
+            const auto t = static_cast<f32>(c.position.y);
+            data.rects[i] = { l, t, l + c.size.x, t + c.size.y };
+            data.backgrounds[i] = colorFromU32<f32x4>(c.background);
+
+            // White is the marker for inverting the colors of the text underneath. The shader then ensures that the
+            // inverted color is perceivable just like we do here, which only needs to be done once for a fixed color.
+            if (c.foreground != 0xffffffff)
             {
-                // The _instances vector is _huge_ (easily up to 50k items) whereas only 1-2 items will actually overlap
-                // with the cursor. --> Make this loop more compact by putting as much as possible into a function call.
-                const auto added = _drawCursorForegroundSlowPath(c, i);
-                i += added;
-                instancesCount += added;
+                data.foregrounds[i] = colorFromU32<f32x4>(ColorFix::GetPerceivableColor(c.foreground, c.background, 0.5f * 0.5f) | 0xff000000);
             }
         }
     }
-}
-
-size_t BackendD3D::_drawCursorForegroundSlowPath(const CursorRect& c, size_t offset)
-{
-    // We won't die from copying 24 bytes. It simplifies the code below especially in
-    // respect to when/if we overwrite the _instances[offset] slot with a cutout.
-#pragma warning(suppress : 26820) // This is a potentially expensive copy operation. Consider using a reference unless a copy is required (p.9).
-    const auto it = _instances[offset];
-
-    // There's one special exception to the rule: Emojis. We currently don't really support inverting
-    // (or reversing) colored glyphs like that, so we can return early here and avoid cutting them up.
-    // It'd be too expensive to check for these rare glyph types inside the _drawCursorForeground() loop.
-    if (static_cast<ShadingType>(it.shadingType) == ShadingType::TextPassthrough)
-    {
-        return 0;
-    }
-
-    const int cursorL = c.position.x;
-    const int cursorT = c.position.y;
-    const int cursorR = cursorL + c.size.x;
-    const int cursorB = cursorT + c.size.y;
-
-    const int instanceL = it.position.x;
-    const int instanceT = it.position.y;
-    const int instanceR = instanceL + it.size.x;
-    const int instanceB = instanceT + it.size.y;
-
-    const auto intersectionL = std::max(cursorL, instanceL);
-    const auto intersectionT = std::max(cursorT, instanceT);
-    const auto intersectionR = std::min(cursorR, instanceR);
-    const auto intersectionB = std::min(cursorB, instanceB);
-
-    // We should only get called if there's actually an intersection.
-    assert(intersectionL < intersectionR && intersectionT < intersectionB);
-
-    // We need to ensure that the glyph doesn't "dirty" the cursor background with its un-inverted/un-reversed color.
-    // If it did, and we'd draw the inverted/reversed glyph on top, it would look smudged.
-    // As such, this cuts a cursor-sized hole into the original glyph and splits it up.
-    //
-    // > Always initialize an object
-    // I would pay money if this warning was a little smarter. The array can remain uninitialized,
-    // because it acts like a tiny small_vector, but without the assertions.
-#pragma warning(suppress : 26494) // Variable 'cutouts' is uninitialized. Always initialize an object (type.5).
-    rect<int> cutouts[4];
-    size_t cutoutCount = 0;
-
-    if (instanceT < intersectionT)
-    {
-        cutouts[cutoutCount++] = { instanceL, instanceT, instanceR, intersectionT };
-    }
-    if (instanceB > intersectionB)
-    {
-        cutouts[cutoutCount++] = { instanceL, intersectionB, instanceR, instanceB };
-    }
-    if (instanceL < intersectionL)
-    {
-        cutouts[cutoutCount++] = { instanceL, intersectionT, intersectionL, intersectionB };
-    }
-    if (instanceR > intersectionR)
-    {
-        cutouts[cutoutCount++] = { intersectionR, intersectionT, instanceR, intersectionB };
-    }
-
-    const auto addedInstances = cutoutCount ? cutoutCount - 1 : 0;
-
-    // Make place for cutoutCount-many items at position.
-    // NOTE: _bumpInstancesSize() reallocates the vector and all references to _instances will now be invalid.
-    if (addedInstances)
-    {
-        const auto instancesCount = _instancesCount;
-
-        _instancesCount += addedInstances;
-        if (_instancesCount >= _instances.size())
-        {
-            _bumpInstancesSize();
-        }
-
-        const auto src = _instances.data() + offset;
-        const auto dst = src + addedInstances;
-        const auto count = instancesCount - offset;
-        assert(src >= _instances.begin() && (src + count) < _instances.end());
-        assert(dst >= _instances.begin() && (dst + count) < _instances.end());
-        memmove(dst, src, count * sizeof(QuadInstance));
-    }
 
-    // Now that there's space we can write the glyph cutouts back into the instances vector.
-    for (size_t i = 0; i < cutoutCount; ++i)
+    // The comparison stops at `count`, because the padding after it isn't necessarily zeroed.
+    if (memcmp(&data, &_cursorConstBufferData, offsetof(CursorConstBuffer, count) + sizeof(data.count)) != 0)
     {
-        const auto& cutout = cutouts[i];
-        auto& target = _instances[offset + i];
-
-        target.shadingType = it.shadingType;
-        target.renditionScale.x = it.renditionScale.x;
-        target.renditionScale.y = it.renditionScale.y;
-        target.position.x = static_cast<i16>(cutout.left);
-        target.position.y = static_cast<i16>(cutout.top);
-        target.size.x = static_cast<u16>(cutout.right - cutout.left);
-        target.size.y = static_cast<u16>(cutout.bottom - cutout.top);
-        target.texcoord.x = static_cast<u16>(it.texcoord.x + cutout.left - instanceL);
-        target.texcoord.y = static_cast<u16>(it.texcoord.y + cutout.top - instanceT);
-        target.color = it.color;
+        p.deviceContext->UpdateSubresource(_cursorConstantBuffer.get(), 0, nullptr, &data, 0, 0);
+        _cursorConstBufferData = data;
     }
-
-    auto color = c.foreground == 0xffffffff ? it.color ^ 0xffffff : c.foreground;
-    color = ColorFix::GetPerceivableColor(color, c.background, 0.5f * 0.5f);
-
-    // If the cursor covers the entire glyph (like, let's say, a full-box cursor with an ASCII character),
-    // we don't append a new quad, but rather reuse the one that already exists (cutoutCount == 0).
-    auto& target = cutoutCount ? _appendQuad() : _instances[offset];
-
-    target.shadingType = it.shadingType;
-    target.renditionScale.x = it.renditionScale.x;
-    target.renditionScale.y = it.renditionScale.y;
-    target.position.x = static_cast<i16>(intersectionL);
-    target.position.y = static_cast<i16>(intersectionT);
-    target.size.x = static_cast<u16>(intersectionR - intersectionL);
-    target.size.y = static_cast<u16>(intersectionB - intersectionT);
-    target.texcoord.x = static_cast<u16>(it.texcoord.x + intersectionL - instanceL);
-    target.texcoord.y = static_cast<u16>(it.texcoord.y + intersectionT - instanceT);
-    target.color = color;
-
-    return addedInstances;
 }
 
 void BackendD3D::_debugShowDirty(const RenderingPayload& p)
@@ -2368,10 +3332,10 @@ void BackendD3D::_executeCustomShader(RenderingPayload& p)
         p.deviceContext->VSSetConstantBuffers(0, 1, _vsConstantBuffer.addressof());
 
         // PS: Pixel Shader
-        ID3D11ShaderResourceView* resources[]{ _backgroundBitmapView.get(), _glyphAtlasView.get() };
+        ID3D11Buffer* constantBuffers[]{ _psConstantBuffer.get(), _cursorConstantBuffer.get() };
         p.deviceContext->PSSetShader(_pixelShader.get(), nullptr, 0);
-        p.deviceContext->PSSetConstantBuffers(0, 1, _psConstantBuffer.addressof());
-        p.deviceContext->PSSetShaderResources(0, 2, &resources[0]);
+        p.deviceContext->PSSetConstantBuffers(0, 2, &constantBuffers[0]);
+        _bindShaderResources(p);
         p.deviceContext->PSSetSamplers(0, 0, nullptr);
 
         // OM: Output Merger
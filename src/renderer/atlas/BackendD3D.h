@@ -30,6 +30,7 @@ namespace Microsoft::Console::Render::Atlas
             // * bool will probably not work the way you want it to,
             //   because HLSL uses 32-bit bools and C++ doesn't.
             alignas(sizeof(f32x2)) f32x2 positionScale;
+            alignas(sizeof(f32x2)) f32x2 positionOffset;
 #pragma warning(suppress : 4324) // 'VSConstBuffer': structure was padded due to alignment specifier
         };
 
@@ -45,9 +46,39 @@ namespace Microsoft::Console::Render::Atlas
             alignas(sizeof(f32)) f32 doubleUnderlineWidth = 0;
             alignas(sizeof(f32)) f32 curlyLineHalfHeight = 0;
             alignas(sizeof(f32)) f32 shadedGlyphDotSize = 0;
+            // HLSL packs this right after shadedGlyphDotSize, into the same 16 byte register.
+            alignas(sizeof(f32)) f32x2 gridTopPos;
+            alignas(sizeof(f32x2)) f32x2 gridBottomPos;
+            alignas(sizeof(f32x2)) f32x2 gridLeftPos;
+            alignas(sizeof(f32x2)) f32x2 gridRightPos;
+            alignas(sizeof(f32x2)) f32x2 strikethroughPos;
+            alignas(sizeof(f32x2)) f32x2 underlinePos;
+            alignas(sizeof(f32x2)) f32x2 doubleUnderlinePos0;
+            alignas(sizeof(f32x2)) f32x2 doubleUnderlinePos1;
+            alignas(sizeof(f32x2)) f32x2 curlyUnderlinePos;
 #pragma warning(suppress : 4324) // 'PSConstBuffer': structure was padded due to alignment specifier
         };
 
+        // An empty-box cursor spanning a wide glyph that has different
+        // background colors on each side results in 6 lines being drawn.
+        static constexpr size_t MaxCursorRects = 6;
+        // The number of empty rows between the glyphs in _softFontBitmap.
+        static constexpr size_t SoftFontGlyphPadding = 2;
+
+        // WARNING: Same rules as for VSConstBuffer above apply.
+        struct alignas(16) CursorConstBuffer
+        {
+            // The bounding rect of all rects (left, top, right, bottom), so that the pixel shader can skip
+            // most pixels with a single comparison. It's all 0 if there's no cursor.
+            alignas(sizeof(f32x4)) f32x4 bounds;
+            alignas(sizeof(f32x4)) f32x4 rects[MaxCursorRects];
+            // The color of the text under the cursor. Its alpha is 0 if the text's color should be inverted instead.
+            alignas(sizeof(f32x4)) f32x4 foregrounds[MaxCursorRects];
+            alignas(sizeof(f32x4)) f32x4 backgrounds[MaxCursorRects];
+            alignas(sizeof(u32)) u32 count = 0;
+#pragma warning(suppress : 4324) // 'CursorConstBuffer': structure was padded due to alignment specifier
+        };
+
         // WARNING: Same rules as for VSConstBuffer above apply.
         struct alignas(16) CustomConstBuffer
         {
@@ -65,6 +96,7 @@ namespace Microsoft::Console::Render::Atlas
 
             // This block of values will be used for the TextDrawingFirst/Last range and need to stay together.
             // This is used to quickly check if an instance is related to a "text drawing primitive".
+            // The pixel shader uses the same range to decide what gets recolored by the cursor.
             TextGrayscale,
             TextClearType,
             TextBuiltinGlyph,
@@ -78,6 +110,9 @@ namespace Microsoft::Console::Render::Atlas
             Cursor,
             FilledRect,
 
+            // Draws all the gridlines of the single-width rows in one quad. See _updateDecorationBitmapRow().
+            Decorations,
+
             TextDrawingFirst = TextGrayscale,
             TextDrawingLast = SolidLine,
         };
@@ -110,6 +145,8 @@ namespace Microsoft::Console::Render::Atlas
             i16x2 offset;
             u16x2 size;
             u16x2 texcoord;
+            // The value of _glyphAtlasFrame when this glyph was last drawn. Used for LRU eviction.
+            u32 lastUsed;
         };
 
         struct AtlasGlyphEntryHashTrait
@@ -215,6 +252,35 @@ namespace Microsoft::Console::Render::Atlas
             }
         };
 
+        // Glyphs are split across two atlas textures. Regular text only needs a single coverage channel
+        // (or 3 with ClearType), whereas color glyphs, bitmaps and builtin glyphs (whose RGB channels
+        // control the pixel shader) need BGRA. See _glyphAtlasKind().
+        enum class GlyphAtlasKind : u8
+        {
+            Text,
+            Color,
+        };
+
+        struct GlyphAtlas
+        {
+            wil::com_ptr<ID3D11Texture2D> texture;
+            wil::com_ptr<ID3D11ShaderResourceView> view;
+            wil::com_ptr<ID2D1DeviceContext> d2dRenderTarget;
+            wil::com_ptr<ID2D1DeviceContext4> d2dRenderTarget4; // Optional. Supported since Windows 10 14393.
+            Buffer<stbrp_node> rectPackerData;
+            stbrp_context rectPacker{};
+            DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+            bool d2dBeganDrawing = false;
+        };
+
+        // The glyphs of a font face that were loaded from the on-disk glyph atlas cache.
+        // They're waiting for _drawText() to encounter the matching IDWriteFontFace2.
+        struct AtlasCachedFontFace
+        {
+            u64 key;
+            std::vector<AtlasGlyphEntry> glyphs[4];
+        };
+
     private:
         struct CursorRect
         {
@@ -226,19 +292,34 @@ namespace Microsoft::Console::Render::Atlas
 
         ATLAS_ATTR_COLD void _handleSettingsUpdate(const RenderingPayload& p);
         void _updateFontDependents(const RenderingPayload& p);
-        void _d2dRenderTargetUpdateFontSettings(const RenderingPayload& p) const noexcept;
+        static void _d2dRenderTargetUpdateFontSettings(const RenderingPayload& p, ID2D1DeviceContext* renderTarget) noexcept;
         void _recreateCustomShader(const RenderingPayload& p);
         void _recreateCustomRenderTargetView(const RenderingPayload& p);
         void _recreateBackgroundColorBitmap(const RenderingPayload& p);
         void _recreateConstBuffer(const RenderingPayload& p) const;
+        void _updateVSConstBuffer(const RenderingPayload& p) const;
         void _setupDeviceContextState(const RenderingPayload& p);
+        bool _beginIncrementalFrame(const RenderingPayload& p);
+        void _setScissorRect(const RenderingPayload& p, const D3D11_RECT& rect) noexcept;
+        void _savePreviousFrame(const RenderingPayload& p);
         void _debugUpdateShaders(const RenderingPayload& p) noexcept;
         void _debugShowDirty(const RenderingPayload& p);
         void _debugDumpRenderTarget(const RenderingPayload& p);
-        void _d2dBeginDrawing() noexcept;
+        static void _d2dBeginDrawing(GlyphAtlas& atlas) noexcept;
         void _d2dEndDrawing();
+        static GlyphAtlasKind _glyphAtlasKind(ShadingType shadingType) noexcept;
+        GlyphAtlas& _glyphAtlas(GlyphAtlasKind kind) noexcept;
+        static DXGI_FORMAT _glyphAtlasFormat(const RenderingPayload& p, GlyphAtlasKind kind) noexcept;
+        u16x2 _glyphAtlasSize(const RenderingPayload& p, GlyphAtlasKind kind, u32 minWidth, u32 minHeight) const noexcept;
         ATLAS_ATTR_COLD void _resetGlyphAtlas(const RenderingPayload& p, u32 minWidth, u32 minHeight);
-        ATLAS_ATTR_COLD void _resizeGlyphAtlas(const RenderingPayload& p, u16 u, u16 v);
+        ATLAS_ATTR_COLD void _compactGlyphAtlas(const RenderingPayload& p, GlyphAtlasKind kind, u32 minWidth, u32 minHeight);
+        ATLAS_ATTR_COLD void _resizeGlyphAtlas(const RenderingPayload& p, GlyphAtlasKind kind, u16 u, u16 v);
+        void _bindShaderResources(const RenderingPayload& p) const noexcept;
+        ATLAS_ATTR_COLD static std::wstring _glyphAtlasCachePath(const RenderingPayload& p, f32 gamma, f32 cleartypeEnhancedContrast, f32 grayscaleEnhancedContrast);
+        ATLAS_ATTR_COLD static u64 _fontFaceCacheKey(IDWriteFontFace2* fontFace);
+        ATLAS_ATTR_COLD void _loadGlyphAtlasCache(const RenderingPayload& p) noexcept;
+        ATLAS_ATTR_COLD void _saveGlyphAtlasCache(const RenderingPayload& p) noexcept;
+        ATLAS_ATTR_COLD void _restoreCachedGlyphs(AtlasFontFaceEntry& fontFaceEntry);
         static bool _checkMacTypeVersion(const RenderingPayload& p);
         QuadInstance& _getLastQuad() noexcept;
         QuadInstance& _appendQuad();
@@ -251,15 +332,18 @@ namespace Microsoft::Console::Render::Atlas
         ATLAS_ATTR_COLD void _drawTextOverlapSplit(const RenderingPayload& p, u16 y);
         [[nodiscard]] ATLAS_ATTR_COLD AtlasGlyphEntry* _drawGlyph(const RenderingPayload& p, const ShapedRow& row, AtlasFontFaceEntry& fontFaceEntry, u32 glyphIndex);
         AtlasGlyphEntry* _drawBuiltinGlyph(const RenderingPayload& p, const ShapedRow& row, AtlasFontFaceEntry& fontFaceEntry, u32 glyphIndex);
+        ATLAS_ATTR_COLD void _drawBuiltinGlyphsUpfront(const RenderingPayload& p);
         ShadingType _drawSoftFontGlyph(const RenderingPayload& p, const D2D1_RECT_F& rect, u32 glyphIndex);
-        void _drawGlyphAtlasAllocate(const RenderingPayload& p, stbrp_rect& rect);
+        void _drawGlyphAtlasAllocate(const RenderingPayload& p, GlyphAtlasKind kind, stbrp_rect& rect);
         static AtlasGlyphEntry* _drawGlyphAllocateEntry(const ShapedRow& row, AtlasFontFaceEntry& fontFaceEntry, u32 glyphIndex);
         static void _splitDoubleHeightGlyph(const RenderingPayload& p, const ShapedRow& row, AtlasFontFaceEntry& fontFaceEntry, AtlasGlyphEntry* glyphEntry);
+        bool _updateDecorationBitmapRow(const RenderingPayload& p, u16 y);
+        void _drawDecorations(const RenderingPayload& p);
+        void _uploadDecorationBitmap(const RenderingPayload& p);
         ATLAS_ATTR_COLD void _drawGridlines(const RenderingPayload& p, u16 y);
         ATLAS_ATTR_COLD void _drawBitmap(const RenderingPayload& p, const ShapedRow* row, u16 y);
         void _drawCursorBackground(const RenderingPayload& p);
-        ATLAS_ATTR_COLD void _drawCursorForeground();
-        ATLAS_ATTR_COLD size_t _drawCursorForegroundSlowPath(const CursorRect& c, size_t offset);
+        void _updateCursorConstBuffer(const RenderingPayload& p);
         void _drawSelection(const RenderingPayload& p);
         void _executeCustomShader(RenderingPayload& p);
 
@@ -268,12 +352,16 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<ID3D11VertexShader> _vertexShader;
         wil::com_ptr<ID3D11PixelShader> _pixelShader;
         wil::com_ptr<ID3D11BlendState> _blendState;
+        wil::com_ptr<ID3D11RasterizerState> _rasterizerState;
         wil::com_ptr<ID3D11Buffer> _vsConstantBuffer;
         wil::com_ptr<ID3D11Buffer> _psConstantBuffer;
+        wil::com_ptr<ID3D11Buffer> _cursorConstantBuffer;
         wil::com_ptr<ID3D11Buffer> _vertexBuffer;
         wil::com_ptr<ID3D11Buffer> _indexBuffer;
         wil::com_ptr<ID3D11Buffer> _instanceBuffer;
         size_t _instanceBufferCapacity = 0;
+        // The position in _instanceBuffer at which the next _flushQuads() writes its instances.
+        size_t _instanceBufferOffset = 0;
         Buffer<QuadInstance, 32> _instances;
         size_t _instancesCount = 0;
 
@@ -293,23 +381,42 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<ID3D11ShaderResourceView> _backgroundBitmapView;
         til::generation_t _backgroundBitmapGeneration;
 
-        wil::com_ptr<ID3D11Texture2D> _glyphAtlas;
-        wil::com_ptr<ID3D11ShaderResourceView> _glyphAtlasView;
+        // The gridlines of the single-width rows as per-cell flags and colors, with the same size as
+        // _backgroundBitmap. _decorationBitmapData is the CPU-side copy that gets uploaded on changes.
+        // Drawing them in the pixel shader avoids emitting one quad per gridline range and per cell for
+        // vertical gridlines, which adds up quickly with diff tools that underline wide parts of the screen.
+        wil::com_ptr<ID3D11Texture2D> _decorationBitmap;
+        wil::com_ptr<ID3D11ShaderResourceView> _decorationBitmapView;
+        Buffer<u32x2> _decorationBitmapData;
+        Buffer<u32x2> _decorationRowScratch;
+        // Whether the corresponding row in _decorationBitmapData contains anything.
+        Buffer<u8> _decorationRowsUsed;
+        size_t _decorationRowsUsedCount = 0;
+        bool _decorationBitmapDirty = false;
+
+        // Indexed by GlyphAtlasKind.
+        std::array<GlyphAtlas, 2> _glyphAtlases;
         til::linear_flat_set<AtlasFontFaceEntry, AtlasFontFaceEntryHashTrait> _glyphAtlasMap;
         til::linear_flat_set<AtlasBitmap, AtlasBitmapHashTrait> _glyphAtlasBitmaps;
         AtlasFontFaceEntry _builtinGlyphs;
-        Buffer<stbrp_node> _rectPackerData;
-        stbrp_context _rectPacker{};
+        u32 _glyphAtlasFrame = 0;
+        // Empty if the glyph atlas isn't supposed to be persisted to disk.
+        std::wstring _glyphAtlasCacheFile;
+        std::vector<AtlasCachedFontFace> _glyphAtlasCachedFaces;
+        // The number of glyphs drawn since the atlas was last loaded or saved,
+        // and how many of those it takes to make saving it again worthwhile.
+        u32 _glyphAtlasCacheUnsaved = 0;
+        u32 _glyphAtlasCacheSaveThreshold = 1;
         til::CoordType _ligatureOverhangTriggerLeft = 0;
         til::CoordType _ligatureOverhangTriggerRight = 0;
 
-        wil::com_ptr<ID2D1DeviceContext> _d2dRenderTarget;
-        wil::com_ptr<ID2D1DeviceContext4> _d2dRenderTarget4; // Optional. Supported since Windows 10 14393.
         wil::com_ptr<ID2D1SolidColorBrush> _emojiBrush;
         wil::com_ptr<ID2D1SolidColorBrush> _brush;
+        // Holds all glyphs of the soft font. See _drawSoftFontGlyph().
         wil::com_ptr<ID2D1Bitmap1> _softFontBitmap;
-        bool _d2dBeganDrawing = false;
         bool _fontChangedResetGlyphAtlas = false;
+        // Set by _resetGlyphAtlas(). See _drawBuiltinGlyphsUpfront().
+        bool _builtinGlyphsPending = false;
 
         float _gamma = 0;
         float _cleartypeEnhancedContrast = 0;
@@ -323,17 +430,24 @@ namespace Microsoft::Console::Render::Atlas
         u16x2 _viewportCellCount{};
         ShadingType _textShadingType = ShadingType::Default;
 
-        // An empty-box cursor spanning a wide glyph that has different
-        // background colors on each side results in 6 lines being drawn.
-        til::small_vector<CursorRect, 6> _cursorRects;
-        // The bounding rect of _cursorRects in pixels.
-        til::rect _cursorPosition;
+        til::small_vector<CursorRect, MaxCursorRects> _cursorRects;
+        // The contents of _cursorConstantBuffer, so that we only upload it when the cursor changes.
+        CursorConstBuffer _cursorConstBufferData{};
 
         f32 _curlyLineHalfHeight = 0.0f;
+        // The RenderingPayload::smoothScrollOffsetY that's currently in the _vsConstantBuffer.
+        f32 _smoothScrollOffsetY = 0.0f;
         FontDecorationPosition _curlyUnderline;
 
         bool _requiresContinuousRedraw = false;
 
+        // A copy of the last frame we've drawn. It allows us to only draw the
+        // dirty area of the next frame, see _beginIncrementalFrame().
+        wil::com_ptr<ID3D11Texture2D> _previousFrame;
+        D3D11_RECT _scissorRect{};
+        bool _previousFrameValid = false;
+        bool _incrementalFrame = false;
+
 #if ATLAS_DEBUG_SHOW_DIRTY
         i32r _presentRects[9]{};
         size_t _presentRectsPos = 0;
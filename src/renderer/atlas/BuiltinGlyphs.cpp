@@ -1080,6 +1080,12 @@ i32 BuiltinGlyphs::GetBitmapCellIndex(char32_t codepoint) noexcept
     return -1;
 }
 
+char32_t BuiltinGlyphs::GetBitmapCellCodepoint(u32 index) noexcept
+{
+    assert(index < TotalCharCount);
+    return index < BoxDrawing_CharCount ? BoxDrawing_FirstChar + index : Powerline_FirstChar + (index - BoxDrawing_CharCount);
+}
+
 void BuiltinGlyphs::DrawBuiltinGlyph(ID2D1Factory* factory, ID2D1DeviceContext* renderTarget, ID2D1SolidColorBrush* brush, const D2D1_COLOR_F (&shadeColorMap)[4], const D2D1_RECT_F& rect, char32_t codepoint)
 {
     renderTarget->PushAxisAlignedClip(&rect, D2D1_ANTIALIAS_MODE_ALIASED);
@@ -19,6 +19,8 @@ namespace Microsoft::Console::Render::Atlas::BuiltinGlyphs
     inline constexpr u32 TotalCharCount = BoxDrawing_CharCount + Powerline_CharCount;
 
     i32 GetBitmapCellIndex(char32_t codepoint) noexcept;
+    // The inverse of GetBitmapCellIndex(). index must be less than TotalCharCount.
+    char32_t GetBitmapCellCodepoint(u32 index) noexcept;
 
     // This is just an extra. It's not actually implemented as part of BuiltinGlyphs.cpp.
     constexpr bool IsSoftFontChar(char32_t ch) noexcept
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "FontFallbackCache.h"
+
+using namespace Microsoft::Console::Render::Atlas;
+
+std::shared_ptr<FontFallbackTable> FontFallbackTable::Get(const Config& config)
+{
+    // The key is only ever compared for equality, so we can just concatenate the raw bytes.
+    std::wstring key;
+    const auto append = [&](const void* data, size_t bytes) {
+        key.append(static_cast<const wchar_t*>(data), bytes / sizeof(wchar_t));
+    };
+    const auto appendString = [&](std::wstring_view str) {
+        key.append(str);
+        key.push_back(L'\0');
+    };
+
+    append(&config.fontCollection, sizeof(config.fontCollection));
+    append(&config.weight, sizeof(config.weight));
+    append(&config.style, sizeof(config.style));
+    append(config.axes.data(), config.axes.size_bytes());
+    key.push_back(L'\0');
+    appendString(config.familyName);
+    appendString(config.fallbackFamilies);
+    appendString(config.localeName);
+
+    // There's one entry for each distinct font configuration in use, so a linear scan is plenty fast.
+    static std::mutex mutex;
+    static std::vector<std::pair<std::wstring, std::weak_ptr<FontFallbackTable>>> registry;
+
+    const std::lock_guard guard{ mutex };
+
+    std::erase_if(registry, [](const auto& entry) { return entry.second.expired(); });
+
+    for (const auto& [k, weak] : registry)
+    {
+        if (k == key)
+        {
+            if (auto table = weak.lock())
+            {
+                return table;
+            }
+        }
+    }
+
+    auto table = std::make_shared<FontFallbackTable>();
+    table->_fontCollection = config.fontCollection;
+    registry.emplace_back(std::move(key), table);
+    return table;
+}
+
+// DirectWrite maps clusters, not code points: A base character followed by a combining mark
+// or a variation selector (for instance U+2764 U+FE0F) may map to another font than the base alone.
+// This function returns true for code points that aren't affected by their neighbors, which means
+// that they can be looked up individually, as long as the next code point is cacheable as well.
+// It's a rather conservative list that covers what terminals usually deal with.
+bool FontFallbackTable::IsCacheable(const char32_t codepoint) noexcept
+{
+    static constexpr std::pair<char32_t, char32_t> ranges[]{
+        { 0x0020, 0x007E }, // Basic Latin
+        { 0x00A0, 0x02FF }, // Latin-1 Supplement, Latin Extended-A/B, IPA Extensions, Spacing Modifier Letters
+        { 0x0370, 0x03FF }, // Greek and Coptic
+        { 0x0400, 0x0482 }, // Cyrillic, up to the combining marks
+        { 0x048A, 0x052F }, // Cyrillic, Cyrillic Supplement
+        { 0x2010, 0x2027 }, // General Punctuation, after the ZWJ and friends
+        { 0x2030, 0x205E }, // General Punctuation, up to the invisible operators
+        { 0x2070, 0x20CF }, // Superscripts and Subscripts, Currency Symbols
+        { 0x2100, 0x2BFF }, // Letterlike Symbols up to Miscellaneous Symbols and Arrows (incl. Box Drawing)
+        { 0x3000, 0x3029 }, // CJK Symbols and Punctuation, up to the tone marks
+        { 0x3041, 0x3096 }, // Hiragana
+        { 0x309B, 0x30FF }, // Hiragana/Katakana, after the combining sound marks
+        { 0x3400, 0x4DBF }, // CJK Unified Ideographs Extension A
+        { 0x4E00, 0x9FFF }, // CJK Unified Ideographs
+        { 0xAC00, 0xD7A3 }, // Hangul Syllables
+        { 0xF900, 0xFAFF }, // CJK Compatibility Ideographs
+        { 0xFF01, 0xFF9D }, // Halfwidth and Fullwidth Forms, up to the halfwidth sound marks
+        { 0x1F300, 0x1F3FA }, // Miscellaneous Symbols and Pictographs, up to the skin tone modifiers
+        { 0x1F400, 0x1FAFF }, // Emoji, after the skin tone modifiers
+        { 0x20000, 0x3FFFF }, // CJK Unified Ideographs Extension B and later
+    };
+
+    for (const auto& [beg, end] : ranges)
+    {
+        if (codepoint <= end)
+        {
+            return codepoint >= beg;
+        }
+    }
+
+    return false;
+}
+
+bool FontFallbackTable::Lookup(const char32_t codepoint, wil::com_ptr<IDWriteFontFace2>& fontFace) const
+{
+    const std::shared_lock guard{ _mutex };
+    const auto it = _map.find(codepoint);
+    if (it == _map.end())
+    {
+        return false;
+    }
+    fontFace = it->second;
+    return true;
+}
+
+void FontFallbackTable::Insert(const char32_t codepoint, IDWriteFontFace2* fontFace)
+{
+    const std::unique_lock guard{ _mutex };
+    if (_map.size() < MaxEntries)
+    {
+        _map.try_emplace(codepoint, fontFace);
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "common.h"
+
+namespace Microsoft::Console::Render::Atlas
+{
+    // Caches the results of IDWriteFontFallback::MapCharacters() per code point.
+    // The tables are shared by all AtlasEngine instances in the process (one per pane), so that
+    // panes with the same font settings don't each pay for the same CJK/emoji fallback queries,
+    // and so that a font reset that ends up with the same settings can reuse the previous results.
+    //
+    // Only code points which DirectWrite maps to the same font regardless of their neighbors are cached.
+    // See IsCacheable(). Lookups and insertions are thread-safe, since shaping runs on the thread pool.
+    struct FontFallbackTable
+    {
+        struct Config
+        {
+            IDWriteFontCollection* fontCollection = nullptr;
+            std::wstring_view familyName;
+            // The comma-separated secondary fonts of the font-family list, or empty if only the system fallback is used.
+            std::wstring_view fallbackFamilies;
+            std::wstring_view localeName;
+            DWRITE_FONT_WEIGHT weight = DWRITE_FONT_WEIGHT_NORMAL;
+            DWRITE_FONT_STYLE style = DWRITE_FONT_STYLE_NORMAL;
+            std::span<const DWRITE_FONT_AXIS_VALUE> axes;
+        };
+
+        // Returns the table for the given settings, creating it if no other engine uses it yet.
+        static std::shared_ptr<FontFallbackTable> Get(const Config& config);
+        static bool IsCacheable(char32_t codepoint) noexcept;
+
+        // Returns false if the code point isn't cached yet. A cached nullptr means that no font supports it.
+        bool Lookup(char32_t codepoint, wil::com_ptr<IDWriteFontFace2>& fontFace) const;
+        void Insert(char32_t codepoint, IDWriteFontFace2* fontFace);
+
+    private:
+        // There are far fewer code points that are used in practice, but this
+        // ensures that the table can't grow without bounds in any case.
+        static constexpr size_t MaxEntries = 65536;
+
+        // Holds on to the collection, so that its address in the registry key can't be reused by another one.
+        wil::com_ptr<IDWriteFontCollection> _fontCollection;
+        mutable std::shared_mutex _mutex;
+        std::unordered_map<char32_t, wil::com_ptr<IDWriteFontFace2>> _map;
+    };
+}
@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "Snapshot.h"
+
+#include "AtlasEngine.h"
+#include "../base/renderer.hpp"
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Render::Atlas;
+using namespace Microsoft::Console::Types;
+
+namespace
+{
+    // A minimal IRenderData for a TextBuffer that isn't attached to a terminal.
+    // There's no selection, no search highlights, no patterns and the cursor is hidden.
+    class SnapshotRenderData final : public IRenderData
+    {
+    public:
+        SnapshotRenderData(TextBuffer& buffer, const RenderSettings& renderSettings, const Viewport& viewport, const FontInfo& fontInfo) noexcept :
+            _buffer{ buffer },
+            _renderSettings{ renderSettings },
+            _viewport{ viewport },
+            _fontInfo{ fontInfo }
+        {
+        }
+
+        Viewport GetViewport() noexcept override { return _viewport; }
+        til::point GetTextBufferEndPosition() const noexcept override { return { _viewport.Width() - 1, _viewport.BottomInclusive() }; }
+        TextBuffer& GetTextBuffer() const noexcept override { return _buffer; }
+        const FontInfo& GetFontInfo() const noexcept override { return _fontInfo; }
+        std::span<const til::point_span> GetSearchHighlights() const noexcept override { return {}; }
+        const til::point_span* GetSearchHighlightFocused() const noexcept override { return nullptr; }
+        std::span<const til::point_span> GetSelectionSpans() const noexcept override { return {}; }
+        void LockConsole() noexcept override {}
+        void UnlockConsole() noexcept override {}
+
+        til::point GetCursorPosition() const noexcept override { return _buffer.GetCursor().GetPosition(); }
+        bool IsCursorVisible() const noexcept override { return false; }
+        bool IsCursorOn() const noexcept override { return false; }
+        ULONG GetCursorHeight() const noexcept override { return _buffer.GetCursor().GetSize(); }
+        CursorType GetCursorStyle() const noexcept override { return _buffer.GetCursor().GetType(); }
+        ULONG GetCursorPixelWidth() const noexcept override { return 1; }
+        bool IsCursorDoubleWidth() const override { return false; }
+        const bool IsGridLineDrawingAllowed() noexcept override { return true; }
+        const std::wstring_view GetConsoleTitle() const noexcept override { return {}; }
+        const std::wstring GetHyperlinkUri(uint16_t id) const override { return _buffer.GetHyperlinkUriFromId(id); }
+        const std::wstring GetHyperlinkCustomId(uint16_t id) const override { return _buffer.GetCustomIdFromId(id); }
+        std::span<const til::point_span> GetPatternSpans() const noexcept override { return {}; }
+        til::generation_t GetPatternGeneration() const noexcept override { return {}; }
+
+        std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override { return _renderSettings.GetAttributeColors(attr); }
+        const bool IsSelectionActive() const override { return false; }
+        const bool IsBlockSelection() const override { return false; }
+        void ClearSelection() override {}
+        void SelectNewRegion(const til::point /*coordStart*/, const til::point /*coordEnd*/) override {}
+        const til::point GetSelectionAnchor() const noexcept override { return {}; }
+        const til::point GetSelectionEnd() const noexcept override { return {}; }
+        const bool IsUiaDataInitialized() const noexcept override { return true; }
+
+    private:
+        TextBuffer& _buffer;
+        const RenderSettings& _renderSettings;
+        Viewport _viewport;
+        const FontInfo& _fontInfo;
+    };
+}
+
+void Atlas::RenderSnapshot(SnapshotRequest& request)
+try
+{
+    THROW_HR_IF_NULL(E_INVALIDARG, request.buffer);
+    THROW_HR_IF_NULL(E_INVALIDARG, request.renderSettings);
+    THROW_HR_IF(E_INVALIDARG, request.path.empty());
+
+    auto& buffer = *request.buffer;
+    const auto viewport = request.viewport.value_or(Viewport::FromExclusive({ 0, 0, buffer.GetSize().Width(), buffer.GetLastNonSpaceCharacter().y + 1 }));
+
+    AtlasEngine engine;
+    engine.SetSoftwareRendering(true);
+    engine.SetGraphicsAPI(GraphicsAPI::Direct2D);
+
+    FontInfo fontInfo{ L"", 0, 0, {}, 0 };
+    SnapshotRenderData data{ buffer, *request.renderSettings, viewport, fontInfo };
+    Renderer renderer{ *request.renderSettings, &data, nullptr, 0, nullptr };
+    renderer.AddRenderEngine(&engine);
+
+    THROW_IF_FAILED(engine.UpdateDpi(request.dpi));
+    THROW_IF_FAILED(engine.UpdateFont(request.font, fontInfo));
+
+    const auto cellSize = fontInfo.GetSize();
+    THROW_IF_FAILED(engine.SetWindowSize({ viewport.Width() * cellSize.width, viewport.Height() * cellSize.height }));
+    engine.SetFrameCapturePath(request.path);
+
+    renderer.TriggerRedrawAll();
+    THROW_IF_FAILED(renderer.PaintFrame());
+
+    // PaintFrame() only logs rendering failures, which is why we need to ask the engine.
+    request.result = engine.GetFrameCaptureResult();
+    renderer.RemoveRenderEngine(&engine);
+}
+catch (...)
+{
+    request.result = wil::ResultFromCaughtException();
+}
+
+void Atlas::RenderSnapshots(std::span<SnapshotRequest> requests)
+{
+    // The engines share a single WARP device (see AtlasEngine::_acquireSharedDevice()), which serializes their
+    // draw calls, but text shaping and glyph rasterization make up most of the cost and those run in parallel.
+    const auto threadCount = std::min<size_t>(requests.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::atomic<size_t> next{ 0 };
+
+    const auto worker = [&]() noexcept {
+        // Saving the PNG uses WIC, which needs COM.
+        const auto coUninitialize = wil::CoInitializeEx_failfast(COINIT_MULTITHREADED);
+
+        for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < requests.size(); i = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            RenderSnapshot(requests[i]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+
+    // The calling thread does its share of the work as well.
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+}
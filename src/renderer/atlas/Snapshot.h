@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "../inc/FontInfoDesired.hpp"
+#include "../inc/RenderSettings.hpp"
+#include "../../types/inc/viewport.hpp"
+
+class TextBuffer;
+
+namespace Microsoft::Console::Render::Atlas
+{
+    // Renders the contents of a TextBuffer into a PNG file, the same way TextBuffer::GenHTML() turns it into HTML.
+    // It doesn't need a window or a GPU: It runs the regular Renderer with an AtlasEngine that uses BackendD2D
+    // on WARP and captures the frame from the engine's (never displayed) composition swap chain.
+    struct SnapshotRequest
+    {
+        TextBuffer* buffer = nullptr;
+        const RenderSettings* renderSettings = nullptr;
+        FontInfoDesired font{ L"Cascadia Mono", 0, DWRITE_FONT_WEIGHT_NORMAL, 12.0f, CP_UTF8 };
+        int dpi = USER_DEFAULT_SCREEN_DPI;
+        // The part of the buffer to render. Defaults to the entire width of the buffer,
+        // from the first row up to and including the last one that isn't blank.
+        std::optional<Types::Viewport> viewport;
+        std::wstring path;
+
+        // The outcome of the request, filled in by RenderSnapshot().
+        HRESULT result = E_PENDING;
+    };
+
+    void RenderSnapshot(SnapshotRequest& request);
+    // Renders all requests on multiple threads. The buffers must not be modified until this returns,
+    // and each of them may only be referenced by one request, because rendering reads their caches.
+    void RenderSnapshots(std::span<SnapshotRequest> requests);
+}
@@ -352,6 +352,8 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<IDWriteFontFallback> fontFallback;
         wil::com_ptr<IDWriteFontFallback1> fontFallback1; // optional, might be nullptr
         std::wstring fontName;
+        // The secondary fonts of the font-family list that fontFallback was built from. See FontFallbackTable.
+        std::wstring fontFallbackNames;
         std::vector<DWRITE_FONT_FEATURE> fontFeatures;
         std::vector<DWRITE_FONT_AXIS_VALUE> fontAxisValues;
         f32 fontSize = 0;
@@ -376,6 +378,7 @@ namespace Microsoft::Console::Render::Atlas
         AntialiasingMode antialiasingMode = DefaultAntialiasingMode;
         bool builtinGlyphs = false;
         bool colorGlyphs = true;
+        bool persistGlyphAtlas = false;
 
         std::vector<uint16_t> softFontPattern;
         til::size softFontCellSize;
@@ -509,6 +512,8 @@ namespace Microsoft::Console::Render::Atlas
         wil::com_ptr<IDWriteTextAnalyzer1> textAnalyzer;
         std::function<void(HRESULT, wil::zwstring_view)> warningCallback;
         std::function<void(HANDLE)> swapChainChangedCallback;
+        // Owned by the Renderer. Backends report their internal phases to it. May be nullptr.
+        FrameTimings* timings = nullptr;
 
         //// Parameters which are constant for the existence of the backend.
         struct
@@ -528,9 +533,15 @@ namespace Microsoft::Console::Render::Atlas
             til::generation_t fontGeneration;
             u16x2 targetSize{};
             bool waitForPresentation = false;
+            // True if the last frame was presented with Present1(). The swap chain then carries over the contents
+            // of the previous frame (including the scrolled area) and backends may just draw the dirty rect.
+            bool retainsContents = false;
         } swapChain;
         wil::com_ptr<ID3D11Device2> device;
         wil::com_ptr<ID3D11DeviceContext2> deviceContext;
+        // The device is shared with other AtlasEngine instances. This is true if one of them
+        // used the deviceContext since the last frame and the backend has to bind its state again.
+        bool deviceContextStateLost = false;
 
         //// Parameters which change seldom.
         GenerationalSettings s;
@@ -570,6 +581,11 @@ namespace Microsoft::Console::Render::Atlas
         // A generation of 1 ensures that the backends redraw the background on the first Present().
         // The 1st entry in this array corresponds to the background and the 2nd to the foreground bitmap.
         std::array<til::generation_t, 2> colorBitmapGenerations{ 1, 1 };
+        // The rows of the background bitmap that changed since the last Render(), and the generation
+        // the background bitmap had after it. A backend that's up to date with that generation only
+        // needs to upload those rows. The initial 1 is never equal to a backend's reset generation.
+        range<u16> backgroundBitmapDirtyRows{};
+        til::generation_t backgroundBitmapBaseGeneration{ 1 };
         // In columns/rows.
         til::rect cursorRect;
         // The viewport/SwapChain area to be presented. In pixel.
@@ -584,6 +600,8 @@ namespace Microsoft::Console::Render::Atlas
         i32 scrollOffsetX = 0;
         // In pixel.
         i16 scrollDeltaY = 0;
+        // In pixel. The entire frame is translated vertically by this amount. Only supported by BackendD3D.
+        f32 smoothScrollOffsetY = 0;
 
         void MarkAllAsDirty() noexcept
         {
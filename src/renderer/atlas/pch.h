@@ -6,16 +6,20 @@
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 
+#include <atomic>
 #include <filesystem>
 #include <functional>
+#include <mutex>
+#include <numeric>
 #include <optional>
 #include <shared_mutex>
 #include <span>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include <d2d1_3.h>
-#include <d3d11_2.h>
+#include <d3d11_4.h>
 #include <d3dcompiler.h>
 #include <dcomp.h>
 #include <dwrite_3.h>
@@ -7,6 +7,7 @@
 // Depends on the glyphAtlas texture
 #define SHADING_TYPE_TEXT_GRAYSCALE     1
 #define SHADING_TYPE_TEXT_CLEARTYPE     2
+// Depends on the colorGlyphAtlas texture
 #define SHADING_TYPE_TEXT_BUILTIN_GLYPH 3
 #define SHADING_TYPE_TEXT_PASSTHROUGH   4
 
@@ -18,6 +19,9 @@
 #define SHADING_TYPE_CURSOR             9
 #define SHADING_TYPE_FILLED_RECT       10
 
+// Depends on the decorations texture
+#define SHADING_TYPE_DECORATIONS       11
+
 struct VSData
 {
     float2 vertex : SV_Position;
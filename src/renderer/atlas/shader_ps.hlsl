@@ -15,10 +15,49 @@ cbuffer ConstBuffer : register(b0)
     float doubleUnderlineWidth;
     float curlyLineHalfHeight;
     float shadedGlyphDotSize;
+    // The position of each of the lines (.x) inside a cell and their width (.y) in pixels.
+    float2 gridTopPos;
+    float2 gridBottomPos;
+    float2 gridLeftPos;
+    float2 gridRightPos;
+    float2 strikethroughPos;
+    float2 underlinePos;
+    float2 doubleUnderlinePos0;
+    float2 doubleUnderlinePos1;
+    float2 curlyUnderlinePos;
+}
+
+cbuffer CursorBuffer : register(b1)
+{
+    // See BackendD3D::CursorConstBuffer.
+    float4 cursorBounds;
+    float4 cursorRects[6];
+    float4 cursorForegrounds[6];
+    float4 cursorBackgrounds[6];
+    uint cursorRectCount;
 }
 
 Texture2D<float4> background : register(t0);
+// Contains grayscale (A8) or ClearType glyphs. See BackendD3D::GlyphAtlasKind.
 Texture2D<float4> glyphAtlas : register(t1);
+// .x contains the gridline color and .y the underline color. Their alpha bytes contain
+// the lower and upper 8 bits of the GridLineSet. See BackendD3D::_updateDecorationBitmapRow().
+Texture2D<uint2> decorations : register(t2);
+// Contains color glyphs, bitmaps and builtin glyphs.
+Texture2D<float4> colorGlyphAtlas : register(t3);
+
+// The bits of the GridLines enum in IRenderEngine.hpp.
+#define GRIDLINE_TOP                 (1 << 1)
+#define GRIDLINE_BOTTOM              (1 << 2)
+#define GRIDLINE_LEFT                (1 << 3)
+#define GRIDLINE_RIGHT               (1 << 4)
+#define GRIDLINE_UNDERLINE           (1 << 5)
+#define GRIDLINE_DOUBLE_UNDERLINE    (1 << 6)
+#define GRIDLINE_CURLY_UNDERLINE     (1 << 7)
+#define GRIDLINE_DOTTED_UNDERLINE    (1 << 8)
+#define GRIDLINE_DASHED_UNDERLINE    (1 << 9)
+#define GRIDLINE_STRIKETHROUGH       (1 << 10)
+#define GRIDLINE_HYPERLINK_UNDERLINE (1 << 11)
 
 struct Output
 {
@@ -26,6 +65,211 @@ struct Output
     float4 weights;
 };
 
+float dottedLine(float x, float2 renditionScale)
+{
+    return frac(x / (3.0f * underlineWidth * renditionScale.x)) < (1.0f / 3.0f);
+}
+
+float dashedLine(float x, float2 renditionScale)
+{
+    return frac(x / (6.0f * underlineWidth * renditionScale.x)) < (4.0f / 6.0f);
+}
+
+// x is the horizontal position in the render target and y the vertical one relative to the top of the line.
+float curlyLine(float x, float y, float2 renditionScale)
+{
+    // The curly line has the same thickness as a double underline.
+    // We halve it to make the math a bit easier.
+    float strokeWidthHalf = doubleUnderlineWidth * renditionScale.y * 0.5f;
+    float center = curlyLineHalfHeight * renditionScale.y;
+    float amplitude = center - strokeWidthHalf;
+    // We multiply the frequency by pi/2 to get a sine wave which has an integer period.
+    // This makes every period of the wave look exactly the same.
+    float frequency = 1.57079632679489661923f / (curlyLineHalfHeight * renditionScale.x);
+    // At very small sizes, like when the wave is just 3px tall and 1px wide, it'll look too fat and/or blurry.
+    // Because we multiplied our frequency with pi, the extrema of the curve and its intersections with the
+    // centerline always occur right between two pixels. This causes both to be lit with the same color.
+    // By adding a small phase shift, we can break this symmetry up. It'll make the wave look a lot more crispy.
+    float phase = 1.57079632679489661923f;
+    float sine = sin(x * frequency + phase);
+    // We use the distance to the sine curve as its alpha value - the closer the more opaque.
+    // To give it a smooth appearance we don't want to simply calculate the vertical distance to the curve:
+    //   abs(pixel.y - sin(pixel.x))
+    //
+    // ...because while a pixel may be vertically far away it may be horizontally close to the sine curve.
+    // We need a proper distance calculation. This makes a large difference at especially small font sizes.
+    //
+    // While calculating the distance to a sine curve is complex, calculating the distance to its tangent is easy,
+    // because tangents are straight lines and line-point distance are trivial. The tangent of sin(x) is cos(x).
+    // The line-point distance is the vertical distance multiplied by the cos(angle) of the line.
+    // To turn out tangent cos(x) into an angle we need to calculate atan(cos(x)). This nets us:
+    //   abs(pixel.y - sin(pixel.x)) * cos(atan(cos(pixel.x))
+    //
+    // The expanded sine form of cos(atan(cos(x))) is 1 / sqrt(2 - sin(x)^2), which results in:
+    //   abs(pixel.y - sin(pixel.x)) * rsqrt(2 - sin(pixel.x)^2)
+    float distance = abs(center - y - sine * amplitude) * rsqrt(2 - sine * sine);
+    // Since pixel coordinates are always offset by half a pixel (i.e. y is 1.5f, 2.5f, 3.5f, ...)
+    // the distance is also off by half a pixel. We undo that by adding half a pixel to the distance.
+    // This gives the line its proper thickness appearance.
+    return 1 - saturate(distance - strokeWidthHalf + 0.5f);
+}
+
+// Returns 1 if the given position inside a cell is covered by the line at the given pos (see ConstBuffer).
+float lineCoverage(float position, float2 pos)
+{
+    return position >= pos.x && position < pos.x + pos.y;
+}
+
+float3 srgbToLinear(float3 c)
+{
+    return c <= 0.04045f ? c / 12.92f : pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float3 linearToSrgb(float3 c)
+{
+    c = saturate(c);
+    return c <= 0.0031308f ? c * 12.92f : 1.055f * pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+// See https://bottosson.github.io/posts/oklab/
+float3 linearToOklab(float3 c)
+{
+    float3 lms = mul(float3x3(
+        0.4122214708f, 0.5363325363f, 0.0514459929f,
+        0.2119034982f, 0.6806995451f, 0.1073969566f,
+        0.0883024619f, 0.2817188376f, 0.6299787005f), c);
+    return mul(float3x3(
+        0.2104542553f, 0.7936177850f, -0.0040720468f,
+        1.9779984951f, -2.4285922050f, 0.4505937099f,
+        0.0259040371f, 0.7827717662f, -0.8086757660f), pow(lms, 1.0f / 3.0f));
+}
+
+float3 oklabToLinear(float3 c)
+{
+    float3 lms = mul(float3x3(
+        1.0f, 0.3963377774f, 0.2158037573f,
+        1.0f, -0.1055613458f, -0.0638541728f,
+        1.0f, -0.0894841775f, -1.2914855480f), c);
+    return mul(float3x3(
+        4.0767416621f, -3.3077115913f, 0.2309699292f,
+        -1.2684380046f, 2.6097574011f, -0.3413193965f,
+        -0.0041960863f, -0.7034186147f, 1.7076147010f), lms * lms * lms);
+}
+
+// The same as ColorFix::GetPerceivableColor(): Changes the lightness of `color` until
+// it's at least a deltaEOK of sqrt(minSquaredDistance) away from `reference`.
+float3 perceivableColor(float3 color, float3 reference, float minSquaredDistance)
+{
+    float3 referenceOklab = linearToOklab(srgbToLinear(reference));
+    float3 colorOklab = linearToOklab(srgbToLinear(color));
+    float3 delta = referenceOklab - colorOklab;
+    delta *= delta;
+
+    if (delta.x + delta.y + delta.z >= minSquaredDistance)
+    {
+        return color;
+    }
+
+    float deltaL = sqrt(minSquaredDistance - delta.y - delta.z);
+    if (colorOklab.x < referenceOklab.x)
+    {
+        deltaL = -deltaL;
+    }
+
+    colorOklab.x = referenceOklab.x + deltaL;
+    if (colorOklab.x < 0 || colorOklab.x > 1)
+    {
+        colorOklab.x = referenceOklab.x - deltaL;
+    }
+
+    return linearToSrgb(oklabToLinear(colorOklab));
+}
+
+// Returns the color that text (or gridlines) of the given color should have at the given position,
+// which is either the color itself or the cursor's foreground color. See BackendD3D::_drawCursorBackground().
+float4 cursorForeground(float2 position, float4 color)
+{
+    if (all(position >= cursorBounds.xy) && all(position < cursorBounds.zw))
+    {
+        for (uint i = 0; i < cursorRectCount; ++i)
+        {
+            float4 rect = cursorRects[i];
+            if (all(position >= rect.xy) && all(position < rect.zw))
+            {
+                float4 foreground = cursorForegrounds[i];
+                if (foreground.a == 0)
+                {
+                    foreground = float4(perceivableColor(1 - color.rgb, cursorBackgrounds[i].rgb, 0.5f * 0.5f), color.a);
+                }
+                return foreground;
+            }
+        }
+    }
+    return color;
+}
+
+float4 decorationsColor(float2 position)
+{
+    float2 cell = position / backgroundCellSize;
+    if (any(cell >= backgroundCellCount))
+    {
+        return float4(0, 0, 0, 0);
+    }
+
+    uint2 d = decorations[cell];
+    uint lines = (d.x >> 24) | (d.y >> 24 << 8);
+    float2 offset = position - floor(cell) * backgroundCellSize;
+
+    float gridlines = 0;
+    if (lines & GRIDLINE_LEFT)
+    {
+        gridlines = max(gridlines, lineCoverage(offset.x, gridLeftPos));
+    }
+    if (lines & GRIDLINE_RIGHT)
+    {
+        gridlines = max(gridlines, lineCoverage(offset.x, gridRightPos));
+    }
+    if (lines & GRIDLINE_TOP)
+    {
+        gridlines = max(gridlines, lineCoverage(offset.y, gridTopPos));
+    }
+    if (lines & GRIDLINE_BOTTOM)
+    {
+        gridlines = max(gridlines, lineCoverage(offset.y, gridBottomPos));
+    }
+    if (lines & GRIDLINE_STRIKETHROUGH)
+    {
+        gridlines = max(gridlines, lineCoverage(offset.y, strikethroughPos));
+    }
+
+    // Same order of precedence as in BackendD3D::_drawGridlines().
+    float underline = 0;
+    if (lines & GRIDLINE_UNDERLINE)
+    {
+        underline = lineCoverage(offset.y, underlinePos);
+    }
+    else if (lines & (GRIDLINE_DOTTED_UNDERLINE | GRIDLINE_HYPERLINK_UNDERLINE))
+    {
+        underline = lineCoverage(offset.y, underlinePos) * dottedLine(position.x, float2(1, 1));
+    }
+    else if (lines & GRIDLINE_DASHED_UNDERLINE)
+    {
+        underline = lineCoverage(offset.y, underlinePos) * dashedLine(position.x, float2(1, 1));
+    }
+    else if (lines & GRIDLINE_CURLY_UNDERLINE)
+    {
+        underline = lineCoverage(offset.y, curlyUnderlinePos) * curlyLine(position.x, offset.y - curlyUnderlinePos.x, float2(1, 1));
+    }
+    else if (lines & GRIDLINE_DOUBLE_UNDERLINE)
+    {
+        underline = max(lineCoverage(offset.y, doubleUnderlinePos0), lineCoverage(offset.y, doubleUnderlinePos1));
+    }
+
+    float4 gridlineColor = premultiplyColor(cursorForeground(position, decodeRGBA(d.x | 0xff000000))) * gridlines;
+    float4 underlineColor = premultiplyColor(cursorForeground(position, decodeRGBA(d.y | 0xff000000))) * underline;
+    return alphaBlendPremultiplied(gridlineColor, underlineColor);
+}
+
 // clang-format off
 Output main(PSData data) : SV_Target
 // clang-format on
@@ -33,6 +277,12 @@ Output main(PSData data) : SV_Target
     float4 color;
     float4 weights;
 
+    // Emojis aren't recolored, because we don't really support inverting colored glyphs.
+    if (data.shadingType >= SHADING_TYPE_TEXT_GRAYSCALE && data.shadingType <= SHADING_TYPE_SOLID_LINE && data.shadingType != SHADING_TYPE_TEXT_PASSTHROUGH)
+    {
+        data.color = cursorForeground(data.position.xy, data.color);
+    }
+
     switch (data.shadingType)
     {
     case SHADING_TYPE_TEXT_BACKGROUND:
@@ -106,7 +356,7 @@ Output main(PSData data) : SV_Target
         //         ########
         //         ########
         //
-        float4 glyph = glyphAtlas[data.texcoord];
+        float4 glyph = colorGlyphAtlas[data.texcoord];
         float2 pos = floor(data.position.xy / (shadedGlyphDotSize * data.renditionScale));
 
         // A series of on/off/on/off/on/off pixels can be generated with:
@@ -151,61 +401,31 @@ Output main(PSData data) : SV_Target
     }
     case SHADING_TYPE_TEXT_PASSTHROUGH:
     {
-        color = glyphAtlas[data.texcoord];
+        color = colorGlyphAtlas[data.texcoord];
         weights = color.aaaa;
         break;
     }
     case SHADING_TYPE_DOTTED_LINE:
     {
-        bool on = frac(data.position.x / (3.0f * underlineWidth * data.renditionScale.x)) < (1.0f / 3.0f);
-        color = on * premultiplyColor(data.color);
+        color = dottedLine(data.position.x, data.renditionScale) * premultiplyColor(data.color);
         weights = color.aaaa;
         break;
     }
     case SHADING_TYPE_DASHED_LINE:
     {
-        bool on = frac(data.position.x / (6.0f * underlineWidth * data.renditionScale.x)) < (4.0f / 6.0f);
-        color = on * premultiplyColor(data.color);
+        color = dashedLine(data.position.x, data.renditionScale) * premultiplyColor(data.color);
         weights = color.aaaa;
         break;
     }
     case SHADING_TYPE_CURLY_LINE:
     {
-        // The curly line has the same thickness as a double underline.
-        // We halve it to make the math a bit easier.
-        float strokeWidthHalf = doubleUnderlineWidth * data.renditionScale.y * 0.5f;
-        float center = curlyLineHalfHeight * data.renditionScale.y;
-        float amplitude = center - strokeWidthHalf;
-        // We multiply the frequency by pi/2 to get a sine wave which has an integer period.
-        // This makes every period of the wave look exactly the same.
-        float frequency = 1.57079632679489661923f / (curlyLineHalfHeight * data.renditionScale.x);
-        // At very small sizes, like when the wave is just 3px tall and 1px wide, it'll look too fat and/or blurry.
-        // Because we multiplied our frequency with pi, the extrema of the curve and its intersections with the
-        // centerline always occur right between two pixels. This causes both to be lit with the same color.
-        // By adding a small phase shift, we can break this symmetry up. It'll make the wave look a lot more crispy.
-        float phase = 1.57079632679489661923f;
-        float sine = sin(data.position.x * frequency + phase);
-        // We use the distance to the sine curve as its alpha value - the closer the more opaque.
-        // To give it a smooth appearance we don't want to simply calculate the vertical distance to the curve:
-        //   abs(pixel.y - sin(pixel.x))
-        //
-        // ...because while a pixel may be vertically far away it may be horizontally close to the sine curve.
-        // We need a proper distance calculation. This makes a large difference at especially small font sizes.
-        //
-        // While calculating the distance to a sine curve is complex, calculating the distance to its tangent is easy,
-        // because tangents are straight lines and line-point distance are trivial. The tangent of sin(x) is cos(x).
-        // The line-point distance is the vertical distance multiplied by the cos(angle) of the line.
-        // To turn out tangent cos(x) into an angle we need to calculate atan(cos(x)). This nets us:
-        //   abs(pixel.y - sin(pixel.x)) * cos(atan(cos(pixel.x))
-        //
-        // The expanded sine form of cos(atan(cos(x))) is 1 / sqrt(2 - sin(x)^2), which results in:
-        //   abs(pixel.y - sin(pixel.x)) * rsqrt(2 - sin(pixel.x)^2)
-        float distance = abs(center - data.texcoord.y - sine * amplitude) * rsqrt(2 - sine * sine);
-        // Since pixel coordinates are always offset by half a pixel (i.e. data.texcoord is 1.5f, 2.5f, 3.5f, ...)
-        // the distance is also off by half a pixel. We undo that by adding half a pixel to the distance.
-        // This gives the line its proper thickness appearance.
-        float a = 1 - saturate(distance - strokeWidthHalf + 0.5f);
-        color = a * premultiplyColor(data.color);
+        color = curlyLine(data.position.x, data.texcoord.y, data.renditionScale) * premultiplyColor(data.color);
+        weights = color.aaaa;
+        break;
+    }
+    case SHADING_TYPE_DECORATIONS:
+    {
+        color = decorationsColor(data.position.xy);
         weights = color.aaaa;
         break;
     }
@@ -0,0 +1,348 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "../inc/FrameTimings.hpp"
+
+#include <TraceLoggingProvider.h>
+
+using namespace Microsoft::Console::Render;
+
+#pragma warning(push)
+#pragma warning(disable : 26426) // Global initializer calls a non-constexpr function '...' (i.22).)
+#pragma warning(disable : 26447) // The function is declared 'noexcept' but calls function '...' which may throw exceptions
+#pragma warning(disable : 26477) // Use 'nullptr' rather than 0 or NULL
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+
+TRACELOGGING_DEFINE_PROVIDER(g_hConsoleRenderTraceProvider,
+                             "Microsoft.Windows.Console.Render",
+                             // {41a35baf-cd55-5e23-782b-7323338b5283}
+                             (0x41a35baf, 0xcd55, 0x5e23, 0x78, 0x2b, 0x73, 0x23, 0x38, 0x8b, 0x52, 0x83));
+
+static const auto cleanup = []() noexcept {
+    TraceLoggingRegister(g_hConsoleRenderTraceProvider);
+    return wil::scope_exit([]() noexcept {
+        TraceLoggingUnregister(g_hConsoleRenderTraceProvider);
+    });
+}();
+
+static uint32_t toMicroseconds(FrameTimings::clock::duration duration) noexcept
+{
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    return static_cast<uint32_t>(std::clamp<decltype(us)>(us, 0, UINT32_MAX));
+}
+
+static int64_t nowTicks() noexcept
+{
+    return FrameTimings::clock::now().time_since_epoch().count();
+}
+
+static FrameTimings::clock::duration ticksBetween(int64_t from, int64_t to) noexcept
+{
+    return FrameTimings::clock::duration{ to - from };
+}
+
+static FrameTimings::Percentiles computePercentiles(uint32_t* begin, size_t count) noexcept
+{
+    std::sort(begin, begin + count);
+
+    const auto percentile = [&](size_t p) noexcept {
+        return begin[(count - 1) * p / 100];
+    };
+
+    FrameTimings::Percentiles out;
+    out.p50 = percentile(50);
+    out.p90 = percentile(90);
+    out.p99 = percentile(99);
+    out.max = begin[count - 1];
+    return out;
+}
+
+FrameTimings::Scope::Scope(FrameTimings* timings, FramePhase phase) noexcept :
+    _timings{ timings && timings->IsCapturing() ? timings : nullptr },
+    _phase{ phase }
+{
+    if (_timings)
+    {
+        _start = clock::now();
+    }
+}
+
+FrameTimings::Scope::~Scope()
+{
+    if (_timings)
+    {
+        _timings->Add(_phase, Elapsed());
+    }
+}
+
+FrameTimings::clock::duration FrameTimings::Scope::Elapsed() const noexcept
+{
+    return _timings ? clock::now() - _start : clock::duration{};
+}
+
+// Routine Description:
+// - Turns on capturing independent of whether a trace session is listening.
+//   This is used by the rendering statistics overlay.
+void FrameTimings::SetCaptureEnabled(bool enabled) noexcept
+{
+    _captureRequested.store(enabled, std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Emits the backend that AtlasEngine picked after measuring the average frame cost of both.
+void FrameTimings::TraceBackendSelection(std::wstring_view backend, clock::duration direct3D11FrameCost, clock::duration direct2DFrameCost) noexcept
+{
+    TraceLoggingWrite(g_hConsoleRenderTraceProvider,
+                      "BackendSelection",
+                      TraceLoggingCountedWideString(backend.data(), gsl::narrow_cast<ULONG>(backend.size()), "backend"),
+                      TraceLoggingUInt32(toMicroseconds(direct3D11FrameCost), "direct3D11FrameUs"),
+                      TraceLoggingUInt32(toMicroseconds(direct2DFrameCost), "direct2DFrameUs"),
+                      TraceLoggingLevel(WINEVENT_LEVEL_INFO),
+                      TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+}
+
+// Routine Description:
+// - Resets the timings of the current frame and decides whether this frame is captured at all.
+void FrameTimings::BeginFrame() noexcept
+{
+    _capturing = _captureRequested.load(std::memory_order_relaxed) ||
+                 TraceLoggingProviderEnabled(g_hConsoleRenderTraceProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE);
+    _current = {};
+    _currentAtlasResets = 0;
+    _frameStart = clock::now();
+}
+
+// Routine Description:
+// - Commits the current frame to the history and emits it as an ETW event.
+void FrameTimings::EndFrame() noexcept
+{
+    _frameCount.fetch_add(1, std::memory_order_relaxed);
+    if (clock::now() - _frameStart > SlowFrameThreshold)
+    {
+        _slowFrameCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (_latchedInput.output)
+    {
+        _commitInput();
+    }
+
+    if (!_capturing)
+    {
+        return;
+    }
+
+    Frame frame;
+    for (size_t i = 0; i < PhaseCount; ++i)
+    {
+        til::at(frame.phases, i) = toMicroseconds(til::at(_current, i));
+    }
+    frame.atlasResets = _currentAtlasResets;
+
+    {
+        const std::lock_guard guard{ _historyMutex };
+        til::at(_history, _historyNext) = frame;
+        _historyNext = (_historyNext + 1) % HistorySize;
+        _historyCount = std::min(_historyCount + 1, HistorySize);
+    }
+
+    const auto& ph = frame.phases;
+    TraceLoggingWrite(g_hConsoleRenderTraceProvider,
+                      "RenderFrame",
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::LockWait)), "lockWaitUs"),
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::LockHeld)), "lockHeldUs"),
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::PrepareRenderInfo)), "prepareRenderInfoUs"),
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::Present)), "presentUs"),
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::Shaping)), "shapingUs"),
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::GlyphRasterization)), "glyphRasterizationUs"),
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::QuadBuilding)), "quadBuildingUs"),
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::SwapChainPresent)), "swapChainPresentUs"),
+                      TraceLoggingUInt32(til::at(ph, static_cast<size_t>(FramePhase::Total)), "totalUs"),
+                      TraceLoggingUInt32(frame.atlasResets, "atlasResets"),
+                      TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+}
+
+bool FrameTimings::IsCapturing() const noexcept
+{
+    return _capturing;
+}
+
+bool FrameTimings::_wantsCapture() const noexcept
+{
+    return _captureRequested.load(std::memory_order_relaxed) ||
+           TraceLoggingProviderEnabled(g_hConsoleRenderTraceProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE);
+}
+
+// Routine Description:
+// - Marks that a key press was received. If an earlier key press hasn't been answered with
+//   output yet, this is ignored, so that we measure the latency of the oldest pending one.
+void FrameTimings::MarkKeyReceived() noexcept
+{
+    if (!_wantsCapture())
+    {
+        return;
+    }
+
+    int64_t expected = 0;
+    if (_keyTime.compare_exchange_strong(expected, nowTicks(), std::memory_order_relaxed))
+    {
+        _inputSequence.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Routine Description:
+// - Marks that the input generated by the pending key press was written to the connection.
+void FrameTimings::MarkInputWritten() noexcept
+{
+    if (_keyTime.load(std::memory_order_relaxed))
+    {
+        int64_t expected = 0;
+        _writtenTime.compare_exchange_strong(expected, nowTicks(), std::memory_order_relaxed);
+    }
+}
+
+// Routine Description:
+// - Marks that output arrived from the connection. We can't tell whether it's the echo of the
+//   key press, but as far as the user is concerned, that's what the latency is about anyway.
+void FrameTimings::MarkOutputReceived() noexcept
+{
+    if (_writtenTime.load(std::memory_order_relaxed))
+    {
+        int64_t expected = 0;
+        _outputTime.compare_exchange_strong(expected, nowTicks(), std::memory_order_release);
+    }
+}
+
+// Routine Description:
+// - Attributes the pending key press to the current frame, if its output arrived already.
+//   Since the output is processed under the console lock, the frame is then guaranteed to contain it.
+void FrameTimings::LatchInput() noexcept
+{
+    const auto output = _outputTime.load(std::memory_order_acquire);
+    if (!output)
+    {
+        return;
+    }
+
+    _latchedInput.sequence = _inputSequence.load(std::memory_order_relaxed);
+    _latchedInput.output = output;
+    _latchedInput.written = _writtenTime.load(std::memory_order_relaxed);
+    _latchedInput.key = _keyTime.load(std::memory_order_relaxed);
+
+    // Reset in the opposite order of how they're set, so that the Mark*() functions don't observe a half-reset state.
+    _outputTime.store(0, std::memory_order_relaxed);
+    _writtenTime.store(0, std::memory_order_relaxed);
+    _keyTime.store(0, std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Commits the input latency of the latched key press to the history and emits it as an ETW event.
+void FrameTimings::_commitInput() noexcept
+{
+    const auto input = std::exchange(_latchedInput, {});
+    const auto presented = nowTicks();
+    const auto totalUs = toMicroseconds(ticksBetween(input.key, presented));
+
+    {
+        const std::lock_guard guard{ _historyMutex };
+        til::at(_inputHistory, _inputHistoryNext) = totalUs;
+        _inputHistoryNext = (_inputHistoryNext + 1) % HistorySize;
+        _inputHistoryCount = std::min(_inputHistoryCount + 1, HistorySize);
+    }
+
+    TraceLoggingWrite(g_hConsoleRenderTraceProvider,
+                      "InputLatency",
+                      TraceLoggingUInt32(input.sequence, "sequence"),
+                      TraceLoggingUInt32(toMicroseconds(ticksBetween(input.key, input.written)), "translateUs"),
+                      TraceLoggingUInt32(toMicroseconds(ticksBetween(input.written, input.output)), "echoUs"),
+                      TraceLoggingUInt32(toMicroseconds(ticksBetween(input.output, presented)), "presentUs"),
+                      TraceLoggingUInt32(totalUs, "totalUs"),
+                      TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                      TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+}
+
+void FrameTimings::Add(FramePhase phase, clock::duration duration) noexcept
+{
+    til::at(_current, static_cast<size_t>(phase)) += duration;
+}
+
+FrameTimings::clock::duration FrameTimings::Get(FramePhase phase) const noexcept
+{
+    return til::at(_current, static_cast<size_t>(phase));
+}
+
+void FrameTimings::AddAtlasReset() noexcept
+{
+    _currentAtlasResets++;
+}
+
+void FrameTimings::SetGlyphAtlasBytes(uint64_t bytes) noexcept
+{
+    _glyphAtlasBytes.store(bytes, std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Returns the cumulative frame counters. Unlike GetStatistics(), these don't depend on capturing.
+FrameTimings::Counters FrameTimings::GetCounters() const noexcept
+{
+    Counters counters;
+    counters.frames = _frameCount.load(std::memory_order_relaxed);
+    counters.slowFrames = _slowFrameCount.load(std::memory_order_relaxed);
+    counters.glyphAtlasBytes = _glyphAtlasBytes.load(std::memory_order_relaxed);
+    return counters;
+}
+
+// Routine Description:
+// - Computes the p50/p90/p99/max of each phase over the frames in the history.
+FrameTimings::Statistics FrameTimings::GetStatistics() const
+{
+    std::array<Frame, HistorySize> history;
+    std::array<uint32_t, HistorySize> inputHistory;
+    size_t count;
+    size_t inputCount;
+
+    {
+        const std::lock_guard guard{ _historyMutex };
+        history = _history;
+        count = _historyCount;
+        inputHistory = _inputHistory;
+        inputCount = _inputHistoryCount;
+    }
+
+    Statistics stats;
+    stats.frames = count;
+    stats.inputSamples = inputCount;
+    if (inputCount)
+    {
+        stats.inputLatency = computePercentiles(inputHistory.data(), inputCount);
+    }
+    if (!count)
+    {
+        return stats;
+    }
+
+    // The order of the frames doesn't matter for percentiles, only which slots are filled.
+    // Until the ring buffer wrapped around for the first time, that's the first `count` ones.
+    for (size_t i = 0; i < count; ++i)
+    {
+        stats.atlasResets += til::at(history, i).atlasResets;
+    }
+
+    std::array<uint32_t, HistorySize> values{};
+
+    for (size_t phase = 0; phase < PhaseCount; ++phase)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            til::at(values, i) = til::at(til::at(history, i).phases, phase);
+        }
+
+        til::at(stats.phases, phase) = computePercentiles(values.data(), count);
+    }
+
+    return stats;
+}
+
+#pragma warning(pop)
@@ -94,6 +94,21 @@ void RenderEngineBase::WaitUntilCanRender() noexcept
     Sleep(8);
 }
 
+// Method Description:
+// - Releases resources while painting is suspended. Most engines don't hold
+//   on to anything worth releasing, so this does nothing by default.
+void RenderEngineBase::TrimResources() noexcept
+{
+}
+
+// Method Description:
+// - Gives the engine a place to report the timings of its internal phases to.
+//   The Renderer already measures the engine's Present() as a whole,
+//   so engines without any notable internal phases can ignore this.
+void RenderEngineBase::SetFrameTimings(FrameTimings* /*timings*/) noexcept
+{
+}
+
 void RenderEngineBase::UpdateHyperlinkHoveredId(const uint16_t /*hoveredId*/) noexcept
 {
 }
@@ -11,6 +11,24 @@
 using namespace Microsoft::Console::Render;
 using Microsoft::Console::Utils::InitializeColorTable;
 
+static constexpr size_t NoColorIndex = SIZE_MAX;
+static constexpr auto MinSquaredDistance = 0.5f * 0.5f;
+
+// Returns the color table index that TextColor::GetColor() would resolve the color to,
+// or NoColorIndex if it isn't one (RGB colors and brightened default colors).
+static size_t getColorTableIndex(const TextColor& color, const size_t defaultIndex, const bool brighten) noexcept
+{
+    if (color.IsDefault())
+    {
+        return brighten ? NoColorIndex : defaultIndex;
+    }
+    if (color.IsRgb())
+    {
+        return NoColorIndex;
+    }
+    return color.IsIndex16() && brighten ? color.GetIndex() | 8 : color.GetIndex();
+}
+
 RenderSettings::RenderSettings() noexcept
 {
     InitializeColorTable(_colorTable);
@@ -46,9 +64,10 @@ void RenderSettings::RestoreDefaultSettings() noexcept
 {
     _colorTable = _defaultColorTable;
     _colorAliasIndices = _defaultColorAliasIndices;
-    // For now, DECSCNM is the only render mode we need to reset. The others are
-    // all user preferences that can't be changed programmatically.
-    _renderMode.reset(Mode::ScreenReversed);
+    _perceivableColors.clear();
+    // For now, DECSCNM and the synchronized output mode are the only render modes we need
+    // to reset. The others are all user preferences that can't be changed programmatically.
+    _renderMode.reset(Mode::ScreenReversed, Mode::SynchronizedOutput);
 }
 
 // Routine Description:
@@ -89,6 +108,7 @@ const std::array<COLORREF, TextColor::TABLE_SIZE>& RenderSettings::GetColorTable
 void RenderSettings::ResetColorTable() noexcept
 {
     InitializeColorTable({ _colorTable.data(), 16 });
+    _perceivableColors.clear();
 }
 
 // Routine Description:
@@ -98,7 +118,12 @@ void RenderSettings::ResetColorTable() noexcept
 // - color - The new COLORREF to use as that color table value.
 void RenderSettings::SetColorTableEntry(const size_t tableIndex, const COLORREF color)
 {
-    _colorTable.at(tableIndex) = color;
+    auto& entry = _colorTable.at(tableIndex);
+    if (entry != color)
+    {
+        entry = color;
+        _perceivableColors.clear();
+    }
 }
 
 // Routine Description:
@@ -182,14 +207,18 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColors(const TextAttri
 
     auto fg = fgTextColor.GetColor(_colorTable, defaultFgIndex, brightenFg);
     auto bg = bgTextColor.GetColor(_colorTable, defaultBgIndex);
+    auto fgIndex = getColorTableIndex(fgTextColor, defaultFgIndex, brightenFg);
+    auto bgIndex = getColorTableIndex(bgTextColor, defaultBgIndex, false);
 
     if (dimFg)
     {
         fg = (fg >> 1) & 0x7F7F7F; // Divide foreground color components by two.
+        fgIndex = NoColorIndex;
     }
     if (swapFgAndBg)
     {
         std::swap(fg, bg);
+        std::swap(fgIndex, bgIndex);
     }
     if (attr.IsInvisible())
     {
@@ -206,7 +235,7 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColors(const TextAttri
             fg != bg &&
             (_renderMode.test(Mode::AlwaysDistinguishableColors) || (fgTextColor.IsDefaultOrLegacy() && bgTextColor.IsDefaultOrLegacy())))
         {
-            fg = ColorFix::GetPerceivableColor(fg, bg, 0.5f * 0.5f);
+            fg = _getPerceivableColor(fg, bg, fgIndex, bgIndex);
         }
     }
 
@@ -270,13 +299,55 @@ COLORREF RenderSettings::GetAttributeUnderlineColor(const TextAttribute& attr) c
             (_renderMode.test(Mode::AlwaysDistinguishableColors) ||
              (_renderMode.test(Mode::IndexedDistinguishableColors) && ulTextColor.IsDefaultOrLegacy() && attr.GetBackground().IsDefaultOrLegacy())))
         {
-            ul = ColorFix::GetPerceivableColor(ul, bg, 0.5f * 0.5f);
+            const auto ulIndex = getColorTableIndex(ulTextColor, defaultUlIndex, true);
+            const auto bgIndex = getColorTableIndex(attr.GetBackground(), GetColorAliasIndex(ColorAlias::DefaultBackground), false);
+            const auto swapped = attr.IsReverseVideo() ^ GetRenderMode(Mode::ScreenReversed);
+            ul = _getPerceivableColor(ul, bg, ulIndex, swapped ? NoColorIndex : bgIndex);
         }
     }
 
     return ul;
 }
 
+// Routine Description:
+// - Returns ColorFix::GetPerceivableColor(fg, bg), but looks the answer up in
+//   _perceivableColors if both colors are color table entries. The table is
+//   built in one go on first use after the color table changed, which is
+//   cheaper than computing the Oklab conversions for every attribute run.
+// Arguments:
+// - fg, bg - The foreground and background colors.
+// - fgIndex, bgIndex - Their color table indices or NoColorIndex.
+// Return Value:
+// - The adjusted foreground color.
+COLORREF RenderSettings::_getPerceivableColor(const COLORREF fg, const COLORREF bg, const size_t fgIndex, const size_t bgIndex) const noexcept
+try
+{
+    static constexpr auto N = TextColor::TABLE_SIZE;
+
+    if (fgIndex >= N || bgIndex >= N)
+    {
+        return ColorFix::GetPerceivableColor(fg, bg, MinSquaredDistance);
+    }
+
+    if (_perceivableColors.empty())
+    {
+        _perceivableColors.resize(N * N);
+        for (size_t i = 0; i < N; ++i)
+        {
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+            const std::span row{ _perceivableColors.data() + i * N, N };
+            ColorFix::GetPerceivableColors(_colorTable, til::at(_colorTable, i), MinSquaredDistance, row);
+        }
+    }
+
+    return til::at(_perceivableColors, bgIndex * N + fgIndex);
+}
+catch (...)
+{
+    _perceivableColors.clear();
+    return ColorFix::GetPerceivableColor(fg, bg, MinSquaredDistance);
+}
+
 // Routine Description:
 // - Increments the position in the blink cycle, toggling the blink rendition
 //   state on every second call, potentially triggering a redraw of the given
@@ -14,6 +14,9 @@ using PointTree = interval_tree::IntervalTree<til::point, size_t>;
 static constexpr auto maxRetriesForRenderEngine = 3;
 // The renderer will wait this number of milliseconds * how many tries have elapsed before trying again.
 static constexpr auto renderBackoffBaseTimeMilliseconds{ 150 };
+// How long we hold off painting for an application that began a synchronized update (DECSET 2026),
+// at most. This ensures that the window doesn't freeze if it never ends the update.
+static constexpr std::chrono::milliseconds synchronizedOutputTimeout{ 100 };
 
 #define FOREACH_ENGINE(var)   \
     for (auto var : _engines) \
@@ -69,6 +72,11 @@ IRenderData* Renderer::GetRenderData() const noexcept
 // - HRESULT S_OK, GDI error, Safe Math error, or state/argument errors.
 [[nodiscard]] HRESULT Renderer::PaintFrame()
 {
+    if (_isSynchronizingOutput())
+    {
+        return S_OK;
+    }
+
     auto tries = maxRetriesForRenderEngine;
     while (tries > 0)
     {
@@ -91,7 +99,10 @@ IRenderData* Renderer::GetRenderData() const noexcept
         if (--tries == 0)
         {
             // Stop trying.
-            _pThread->DisablePainting();
+            if (_pThread)
+            {
+                _pThread->DisablePainting();
+            }
             if (_pfnRendererEnteredErrorState)
             {
                 _pfnRendererEnteredErrorState();
@@ -110,13 +121,55 @@ IRenderData* Renderer::GetRenderData() const noexcept
     return S_OK;
 }
 
+// Routine Description:
+// - Returns true if the frame should be skipped, because the application is in the middle of
+//   a synchronized update. The invalidated regions keep accumulating in the engines until
+//   the update ends or the timeout is reached, at which point they get painted in one go.
+bool Renderer::_isSynchronizingOutput() noexcept
+{
+    auto deadline = _synchronizedOutputDeadline.load(std::memory_order_relaxed);
+    if (deadline == 0)
+    {
+        return false;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::time_point deadlineTime{ std::chrono::steady_clock::duration{ deadline } };
+    if (now < deadlineTime)
+    {
+        if (_pThread)
+        {
+            _pThread->NotifyPaintAt(deadlineTime);
+        }
+        return true;
+    }
+
+    // The application took too long. We'll paint as usual until it begins its next update.
+    _synchronizedOutputDeadline.compare_exchange_strong(deadline, 0, std::memory_order_relaxed);
+    return false;
+}
+
 [[nodiscard]] HRESULT Renderer::_PaintFrame() noexcept
 {
+    _frameTimings.BeginFrame();
+    const auto endFrame = wil::scope_exit([&]() noexcept {
+        _frameTimings.EndFrame();
+    });
+    // Declared after endFrame, so that it's recorded before the frame is committed.
+    const FrameTimings::Scope totalTiming{ &_frameTimings, FramePhase::Total };
+
     {
-        _pData->LockConsole();
+        {
+            const FrameTimings::Scope lockWaitTiming{ &_frameTimings, FramePhase::LockWait };
+            _pData->LockConsole();
+        }
         auto unlock = wil::scope_exit([&]() {
             _pData->UnlockConsole();
         });
+        const FrameTimings::Scope lockHeldTiming{ &_frameTimings, FramePhase::LockHeld };
+
+        // Any output that arrived up until now will be part of this frame.
+        _frameTimings.LatchInput();
 
         // Last chance check if anything scrolled without an explicit invalidate notification since the last frame.
         _CheckViewportAndScroll();
@@ -130,6 +183,9 @@ IRenderData* Renderer::GetRenderData() const noexcept
         _invalidateCurrentCursor(); // Invalidate the new cursor position.
         _prepareNewComposition();
 
+        _updatePatternRanges();
+        _prepareRenderInfo();
+
         FOREACH_ENGINE(pEngine)
         {
             RETURN_IF_FAILED(_PaintFrameForEngine(pEngine));
@@ -138,6 +194,7 @@ IRenderData* Renderer::GetRenderData() const noexcept
 
     FOREACH_ENGINE(pEngine)
     {
+        const FrameTimings::Scope presentTiming{ &_frameTimings, FramePhase::Present };
         RETURN_IF_FAILED(pEngine->Present());
     }
 
@@ -164,12 +221,12 @@ try
     auto endPaint = wil::scope_exit([&]() {
         LOG_IF_FAILED(pEngine->EndPaint());
 
-        // If the engine tells us it really wants to redraw immediately,
+        // If the engine tells us it really wants to redraw continuously,
         // tell the thread so it doesn't go to sleep and ticks again
-        // at the next opportunity.
-        if (pEngine->RequiresContinuousRedraw())
+        // once the next animation frame is due.
+        if (pEngine->RequiresContinuousRedraw() && _pThread)
         {
-            NotifyPaintFrame();
+            _pThread->NotifyAnimationFrame();
         }
     });
 
@@ -180,7 +237,10 @@ try
     RETURN_IF_FAILED(_PerformScrolling(pEngine));
 
     // C. Prepare the engine with additional information before we start drawing.
-    RETURN_IF_FAILED(_PrepareRenderInfo(pEngine));
+    {
+        const FrameTimings::Scope timing{ &_frameTimings, FramePhase::PrepareRenderInfo };
+        RETURN_IF_FAILED(_PrepareRenderInfo(pEngine));
+    }
 
     // 1. Paint Background
     RETURN_IF_FAILED(_PaintBackground(pEngine));
@@ -330,41 +390,67 @@ try
     const auto spans = _pData->GetSelectionSpans();
     if (spans.size() != _lastSelectionPaintSize || (!spans.empty() && _lastSelectionPaintSpan != til::point_span{ spans.front().start, spans.back().end }))
     {
-        std::vector<til::rect> newSelectionViewportRects;
+        _updateSelectionRects(spans);
+        NotifyPaintFrame();
+    }
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Turns the given selection spans into _lastSelectionRectsByViewport
+//   and invalidates the rows whose selection changed.
+// - A selection may span the entire scrollback, but only the rows within the viewport
+//   can be drawn. Everything else is skipped and computed once it's scrolled into view.
+void Renderer::_updateSelectionRects(const std::span<const til::point_span> spans)
+{
+    std::vector<til::rect> newSelectionViewportRects;
+
+    _lastSelectionPaintSize = spans.size();
+    if (_lastSelectionPaintSize)
+    {
+        _lastSelectionPaintSpan = til::point_span{ spans.front().start, spans.back().end };
 
-        _lastSelectionPaintSize = spans.size();
-        if (_lastSelectionPaintSize)
+        const auto& buffer = _pData->GetTextBuffer();
+        const auto bufferWidth = buffer.GetSize().Width();
+        const til::rect vp{ _viewport.ToExclusive() };
+        for (auto sp : til::point_span_subspan_within_rect(spans, vp))
         {
-            _lastSelectionPaintSpan = til::point_span{ spans.front().start, spans.back().end };
-
-            const auto& buffer = _pData->GetTextBuffer();
-            const auto bufferWidth = buffer.GetSize().Width();
-            const til::rect vp{ _viewport.ToExclusive() };
-            for (auto&& sp : spans)
+            // Clip the span to the rows of the viewport.
+            if (sp.start.y < vp.top)
             {
-                sp.iterate_rows(bufferWidth, [&](til::CoordType row, til::CoordType min, til::CoordType max) {
-                    const auto shift = buffer.GetLineRendition(row) != LineRendition::SingleWidth ? 1 : 0;
-                    max += 1; // Selection spans are inclusive (still)
-                    min <<= shift;
-                    max <<= shift;
-                    til::rect r{ min, row, max, row + 1 };
-                    newSelectionViewportRects.emplace_back(r.to_origin(vp));
-                });
+                sp.start = { 0, vp.top };
+            }
+            if (sp.end.y >= vp.bottom)
+            {
+                sp.end = { bufferWidth - 1, vp.bottom - 1 };
+            }
+            if (sp.start > sp.end)
+            {
+                continue;
             }
-        }
 
-        FOREACH_ENGINE(pEngine)
-        {
-            LOG_IF_FAILED(pEngine->InvalidateSelection(_lastSelectionRectsByViewport));
-            LOG_IF_FAILED(pEngine->InvalidateSelection(newSelectionViewportRects));
+            sp.iterate_rows(bufferWidth, [&](til::CoordType row, til::CoordType min, til::CoordType max) {
+                const auto shift = buffer.GetLineRendition(row) != LineRendition::SingleWidth ? 1 : 0;
+                max += 1; // Selection spans are inclusive (still)
+                min <<= shift;
+                max <<= shift;
+                til::rect r{ min, row, max, row + 1 };
+                newSelectionViewportRects.emplace_back(r.to_origin(vp));
+            });
         }
+    }
 
-        std::exchange(_lastSelectionRectsByViewport, newSelectionViewportRects);
+    // While dragging a large selection, only the rows around its moving end change.
+    // Redrawing everything that's selected would be wasteful, so we only invalidate the difference.
+    const auto changedRects = _GetChangedSelectionRects(_lastSelectionRectsByViewport, newSelectionViewportRects);
 
-        NotifyPaintFrame();
+    FOREACH_ENGINE(pEngine)
+    {
+        LOG_IF_FAILED(pEngine->InvalidateSelection(changedRects));
     }
+
+    std::exchange(_lastSelectionRectsByViewport, newSelectionViewportRects);
 }
-CATCH_LOG()
 
 // Routine Description:
 // - Called when the search highlight areas in the console have changed.
@@ -373,19 +459,47 @@ try
 {
     // no need to invalidate focused search highlight separately as they are
     // included in (all) search highlights.
-    const auto newHighlights = _pData->GetSearchHighlights();
+    const auto allNewHighlights = _pData->GetSearchHighlights();
+    const auto focused = _pData->GetSearchHighlightFocused();
+    const auto oldFocused = std::exchange(_lastSearchHighlightFocused, focused ? std::optional{ *focused } : std::nullopt);
+    const auto& buffer = _pData->GetTextBuffer();
 
-    if (oldHighlights.empty() && newHighlights.empty())
+    // The search is usually re-run after every buffer change, which mostly yields the same highlights.
+    // In that case only the focused highlight may have moved and everything else can be skipped.
+    if (std::ranges::equal(oldHighlights, allNewHighlights))
     {
+        if (oldFocused == _lastSearchHighlightFocused)
+        {
+            return;
+        }
+
+        FOREACH_ENGINE(pEngine)
+        {
+            if (oldFocused)
+            {
+                LOG_IF_FAILED(pEngine->InvalidateHighlight({ &*oldFocused, 1 }, buffer));
+            }
+            if (_lastSearchHighlightFocused)
+            {
+                LOG_IF_FAILED(pEngine->InvalidateHighlight({ &*_lastSearchHighlightFocused, 1 }, buffer));
+            }
+        }
+
+        NotifyPaintFrame();
         return;
     }
 
-    const auto& buffer = _pData->GetTextBuffer();
+    // A search may yield tens of thousands of hits, but only those within the viewport need to be redrawn.
+    // Both lists are sorted, so they can be narrowed down with a binary search. Anything outside
+    // the viewport gets painted anyway once it's scrolled into view.
+    const til::rect viewport{ _viewport.ToExclusive() };
+    const auto oldVisible = til::point_span_subspan_within_rect(oldHighlights, viewport);
+    const auto newVisible = til::point_span_subspan_within_rect(allNewHighlights, viewport);
 
     FOREACH_ENGINE(pEngine)
     {
-        LOG_IF_FAILED(pEngine->InvalidateHighlight(oldHighlights, buffer));
-        LOG_IF_FAILED(pEngine->InvalidateHighlight(newHighlights, buffer));
+        LOG_IF_FAILED(pEngine->InvalidateHighlight(oldVisible, buffer));
+        LOG_IF_FAILED(pEngine->InvalidateHighlight(newVisible, buffer));
     }
 
     NotifyPaintFrame();
@@ -423,6 +537,17 @@ bool Renderer::_CheckViewportAndScroll()
 
     _ScrollPreviousSelection(coordDelta);
 
+    // _lastSelectionRectsByViewport only covers the previous viewport.
+    // Any selected rows that scrolled into view need their rects now.
+    if (_lastSelectionPaintSize)
+    {
+        try
+        {
+            _updateSelectionRects(_pData->GetSelectionSpans());
+        }
+        CATCH_LOG();
+    }
+
     // The cursor may have moved out of or into the viewport. Update the .inViewport property.
     {
         const auto view = ScreenToBufferLine(srNewViewport, _currentCursorOptions.lineRendition);
@@ -544,6 +669,30 @@ void Renderer::TriggerFontChange(const int iDpi, const FontInfoDesired& FontInfo
 // - centeringHint - The horizontal extent that glyphs are offset from center.
 // Return Value:
 // - <none>
+// Routine Description:
+// - Called when an application begins (DECSET 2026) or ends (DECRST 2026) a synchronized update
+//   and thus after RenderSettings::Mode::SynchronizedOutput changed. While an update is in
+//   progress, painting is held off, so that we don't paint half-finished frames.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void Renderer::SynchronizedOutputChanged() noexcept
+{
+    if (_renderSettings.GetRenderMode(RenderSettings::Mode::SynchronizedOutput))
+    {
+        // A repeated DECSET 2026 doesn't extend the timeout of the current update.
+        const auto deadline = std::chrono::steady_clock::now() + synchronizedOutputTimeout;
+        std::chrono::steady_clock::rep expected = 0;
+        _synchronizedOutputDeadline.compare_exchange_strong(expected, deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+    else if (_synchronizedOutputDeadline.exchange(0, std::memory_order_relaxed) != 0)
+    {
+        // Paint everything that has accumulated during the update.
+        NotifyPaintFrame();
+    }
+}
+
 void Renderer::UpdateSoftFont(const std::span<const uint16_t> bitPattern, const til::size cellSize, const size_t centeringHint)
 {
     // We reserve PUA code points U+EF20 to U+EF7F for soft fonts, but the range
@@ -659,6 +808,83 @@ void Renderer::WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs)
     _pThread->WaitForPaintCompletionAndDisable(dwTimeoutMs);
 }
 
+// Routine Description:
+// - Lowers the frame rate of the render thread while the window isn't visible.
+// Arguments:
+// - background - True if the window is hidden or occluded, false otherwise.
+// Return Value:
+// - <none>
+void Renderer::SetBackgroundPainting(const bool background) noexcept
+{
+    // When running the unit tests, we may be using a render without a render thread.
+    if (_pThread)
+    {
+        _pThread->SetBackgroundPainting(background);
+    }
+}
+
+// Routine Description:
+// - Limits how often the render thread paints frames just because an engine requires
+//   continuous redraws, like for animated pixel shaders. Other frames aren't affected.
+// Arguments:
+// - framesPerSecond - The maximum animation frame rate, or 0 (or less) for no limit.
+// Return Value:
+// - <none>
+void Renderer::SetAnimationFrameRate(const int framesPerSecond) noexcept
+{
+    if (_pThread)
+    {
+        const auto interval = framesPerSecond > 0 ? std::chrono::milliseconds{ 1000 / framesPerSecond } : std::chrono::milliseconds::zero();
+        _pThread->SetAnimationFrameInterval(interval);
+    }
+}
+
+// Routine Description:
+// - Stops painting animation frames (see SetAnimationFrameRate), for instance while the control is unfocused.
+// Arguments:
+// - paused - True to stop animating, false to resume.
+// Return Value:
+// - <none>
+void Renderer::SetAnimationsPaused(const bool paused) noexcept
+{
+    if (_pThread)
+    {
+        _pThread->SetAnimationsPaused(paused);
+    }
+}
+
+// Routine Description:
+// - Limits how often the render thread paints frames at all. Invalidations that
+//   happen in between are coalesced into the next frame.
+// Arguments:
+// - framesPerSecond - The maximum frame rate, or 0 (or less) for no limit.
+// Return Value:
+// - <none>
+void Renderer::SetMaxFrameRate(const int framesPerSecond) noexcept
+{
+    if (_pThread)
+    {
+        const auto interval = framesPerSecond > 0 ? std::chrono::milliseconds{ 1000 / framesPerSecond } : std::chrono::milliseconds::zero();
+        _pThread->SetMinimumFrameInterval(interval);
+    }
+}
+
+// Routine Description:
+// - Returns the render thread's frame counters, for diagnosing frame pacing issues.
+RenderThread::FrameStatistics Renderer::GetFrameStatistics() const noexcept
+{
+    return _pThread ? _pThread->GetFrameStatistics() : RenderThread::FrameStatistics{};
+}
+
+// Routine Description:
+// - Returns the per-phase timings of the most recently rendered frames.
+//   Capturing them has to be enabled with FrameTimings::SetCaptureEnabled() first,
+//   unless a trace session is listening to the renderer's tracing provider.
+FrameTimings& Renderer::GetFrameTimings() noexcept
+{
+    return _frameTimings;
+}
+
 // Routine Description:
 // - Paint helper to fill in the background color of the invalid area within the frame.
 // Arguments:
@@ -833,8 +1059,20 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
 
         // Retrieve the first color.
         auto color = it->TextAttr();
-        // Retrieve the first pattern id
-        auto patternIds = _pData->GetPatternId(target);
+        // The pattern matches in this row. Our columns only ever increase, so instead of
+        // searching all matches for every cell, we can walk through them alongside the cells.
+        const auto patternRanges = _getPatternRanges(target.y);
+        auto patternIt = patternRanges.begin();
+        const auto isInPattern = [&](const til::CoordType x) noexcept {
+            while (patternIt != patternRanges.end() && patternIt->end <= x)
+            {
+                ++patternIt;
+            }
+            return patternIt != patternRanges.end() && patternIt->beg <= x;
+        };
+
+        // Retrieve whether the first cell is part of a pattern
+        auto inPattern = isInPattern(target.x);
         // Determine whether we're using a soft font.
         auto usingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
 
@@ -850,9 +1088,6 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             // when we go to draw gridlines for the length of the run.
             const auto currentRunColor = color;
 
-            // Hold onto the current pattern id as well
-            const auto currentPatternId = patternIds;
-
             // Update the drawing brushes with our color and font usage.
             THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, usingSoftFont, false));
 
@@ -881,10 +1116,9 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
             // We also accumulate clusters according to regex patterns
             do
             {
-                til::point thisPoint{ screenPoint.x + cols, screenPoint.y };
-                const auto thisPointPatterns = _pData->GetPatternId(thisPoint);
+                const auto thisInPattern = !patternRanges.empty() && isInPattern(screenPoint.x + cols);
                 const auto thisUsingSoftFont = s_IsSoftFontChar(it->Chars(), _firstSoftFontChar, _lastSoftFontChar);
-                const auto changedPatternOrFont = patternIds != thisPointPatterns || usingSoftFont != thisUsingSoftFont;
+                const auto changedPatternOrFont = inPattern != thisInPattern || usingSoftFont != thisUsingSoftFont;
                 if (color != it->TextAttr() || changedPatternOrFont)
                 {
                     auto newAttr{ it->TextAttr() };
@@ -893,7 +1127,7 @@ void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
                     if (!_IsAllSpaces(it->Chars()) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || changedPatternOrFont)
                     {
                         color = newAttr;
-                        patternIds = thisPointPatterns;
+                        inPattern = thisInPattern;
                         usingSoftFont = thisUsingSoftFont;
                         break; // vend this run
                     }
@@ -1081,7 +1315,74 @@ bool Renderer::_isInHoveredInterval(const til::point coordTarget) const noexcept
 {
     return _hoveredInterval &&
            _hoveredInterval->start <= coordTarget && coordTarget <= _hoveredInterval->stop &&
-           _pData->GetPatternId(coordTarget).size() > 0;
+           _isInPattern(coordTarget);
+}
+
+// Routine Description:
+// - Rebuilds _patternRanges from the pattern matches of IRenderData, if they changed since the last call.
+void Renderer::_updatePatternRanges()
+{
+    const auto generation = _pData->GetPatternGeneration();
+    if (generation == _patternGeneration)
+    {
+        return;
+    }
+
+    _patternGeneration = generation;
+    _patternRanges.clear();
+
+    const auto width = _pData->GetTextBuffer().GetSize().Width();
+    for (const auto& span : _pData->GetPatternSpans())
+    {
+        span.iterate_rows(width, [&](til::CoordType row, til::CoordType min, til::CoordType max) {
+            // Pattern spans are inclusive.
+            _patternRanges.push_back({ row, min, max + 1 });
+        });
+    }
+
+    std::sort(_patternRanges.begin(), _patternRanges.end(), [](const PatternRange& a, const PatternRange& b) noexcept {
+        return a.y < b.y || (a.y == b.y && a.beg < b.beg);
+    });
+
+    // Merging overlapping matches allows _isInPattern() to only look at a single range.
+    size_t count = 0;
+    for (const auto& range : _patternRanges)
+    {
+        if (count && _patternRanges[count - 1].y == range.y && range.beg <= _patternRanges[count - 1].end)
+        {
+            auto& last = _patternRanges[count - 1];
+            last.end = std::max(last.end, range.end);
+        }
+        else
+        {
+            _patternRanges[count++] = range;
+        }
+    }
+    _patternRanges.resize(count);
+}
+
+// Routine Description:
+// - Returns the pattern ranges in the given row, sorted by their column.
+std::span<const Renderer::PatternRange> Renderer::_getPatternRanges(const til::CoordType y) const noexcept
+{
+    const auto beg = std::lower_bound(_patternRanges.begin(), _patternRanges.end(), y, [](const PatternRange& range, const til::CoordType y) noexcept {
+        return range.y < y;
+    });
+    auto end = beg;
+    while (end != _patternRanges.end() && end->y == y)
+    {
+        ++end;
+    }
+    return { beg, end };
+}
+
+bool Renderer::_isInPattern(const til::point coordTarget) const noexcept
+{
+    // Find the first range in this row that ends after coordTarget.
+    const auto it = std::lower_bound(_patternRanges.begin(), _patternRanges.end(), coordTarget, [](const PatternRange& range, const til::point coord) noexcept {
+        return range.y < coord.y || (range.y == coord.y && range.end <= coord.x);
+    });
+    return it != _patternRanges.end() && it->y == coordTarget.y && it->beg <= coordTarget.x;
 }
 
 // Routine Description:
@@ -1168,32 +1469,25 @@ void Renderer::_invalidateCurrentCursor() const
     }
 }
 
-// If we had previously drawn a composition at the previous cursor position
-// we need to invalidate the entire line because who knows what changed.
-// (It's possible to figure that out, but not worth the effort right now.)
+// If we had previously drawn a composition, we need to invalidate the cells it covered,
+// so that the buffer contents underneath it get drawn again.
 void Renderer::_invalidateOldComposition() const
 {
-    if (!_compositionCache || !_currentCursorOptions.inViewport)
+    if (!_compositionCache || !_compositionCache->invalidated)
     {
         return;
     }
 
-    const auto& buffer = _pData->GetTextBuffer();
-    const auto view = buffer.GetSize();
-    const auto coord = _currentCursorOptions.coordCursor;
-
-    til::rect rect{ 0, coord.y, til::CoordTypeMax, coord.y + 1 };
-    if (view.TrimToViewport(&rect))
+    FOREACH_ENGINE(pEngine)
     {
-        FOREACH_ENGINE(pEngine)
-        {
-            LOG_IF_FAILED(pEngine->Invalidate(&rect));
-        }
+        LOG_IF_FAILED(pEngine->Invalidate(&_compositionCache->invalidated));
     }
 }
 
-// Invalidate the line that the active TSF composition is on,
+// Invalidate the cells that the active TSF composition covers,
 // so that _PaintBufferOutput() actually gets a chance to draw it.
+// The composition only overwrites those cells for the duration of the paint,
+// so the rest of the line doesn't need to be redrawn while the user is typing.
 void Renderer::_prepareNewComposition()
 {
     if (_pData->GetActiveComposition().text.empty())
@@ -1209,11 +1503,6 @@ void Renderer::_prepareNewComposition()
     {
         viewport.ConvertToOrigin(&line);
 
-        FOREACH_ENGINE(pEngine)
-        {
-            LOG_IF_FAILED(pEngine->Invalidate(&line));
-        }
-
         auto& buffer = _pData->GetTextBuffer();
         auto& scratch = buffer.GetScratchpadRow();
         const auto& activeComposition = _pData->GetActiveComposition();
@@ -1237,8 +1526,24 @@ void Renderer::_prepareNewComposition()
         const auto remaining = state.columnLimit - state.columnEnd;
         const auto beg = std::clamp(coordCursor.x, 0, remaining);
 
+        // Overwriting half of a wide glyph at either end turns the other half into
+        // a space, which is why the cells next to the composition are included.
+        // Double-width lines have their columns scaled, so they simply get redrawn entirely.
+        auto invalidated = line;
+        if (!buffer.IsDoubleWidthLine(coordCursor.y))
+        {
+            const auto left = beg - viewport.Left();
+            invalidated.left = std::max(line.left, left - 1);
+            invalidated.right = std::min(line.right, left + state.columnEnd + 1);
+        }
+
+        FOREACH_ENGINE(pEngine)
+        {
+            LOG_IF_FAILED(pEngine->Invalidate(&invalidated));
+        }
+
         const auto baseAttribute = buffer.GetRowByOffset(coordCursor.y).GetAttrByColumn(coordCursor.x);
-        _compositionCache.emplace(til::point{ beg, coordCursor.y }, baseAttribute);
+        _compositionCache.emplace(til::point{ beg, coordCursor.y }, baseAttribute, invalidated);
 
         // Fake-move the cursor to where it needs to be in the active composition.
         _currentCursorOptions.coordCursor.x = std::min(beg + cursorOffset, line.right - 1);
@@ -1259,6 +1564,18 @@ void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
     }
 }
 
+// Routine Description:
+// - Retrieves the info that _PrepareRenderInfo() hands to each engine. It's the same
+//   for all of them, so it's only computed once per frame.
+void Renderer::_prepareRenderInfo()
+{
+    // The engines only ever draw the viewport, so there's no point in handing them the offscreen hits.
+    _renderInfo.searchHighlights = til::point_span_subspan_within_rect(_pData->GetSearchHighlights(), til::rect{ _viewport.ToExclusive() });
+    _renderInfo.searchHighlightFocused = _pData->GetSearchHighlightFocused();
+    _renderInfo.selectionSpans = _pData->GetSelectionSpans();
+    _renderInfo.selectionBackground = _renderSettings.GetColorTableEntry(TextColor::SELECTION_BACKGROUND);
+}
+
 // Routine Description:
 // - Retrieves info from the render data to prepare the engine with, before the
 //   frame is drawn. Some renderers might want to use this information to affect
@@ -1272,12 +1589,7 @@ void Renderer::_PaintCursor(_In_ IRenderEngine* const pEngine)
 // - S_OK if the engine prepared successfully, or a relevant error via HRESULT.
 [[nodiscard]] HRESULT Renderer::_PrepareRenderInfo(_In_ IRenderEngine* const pEngine)
 {
-    RenderFrameInfo info;
-    info.searchHighlights = _pData->GetSearchHighlights();
-    info.searchHighlightFocused = _pData->GetSearchHighlightFocused();
-    info.selectionSpans = _pData->GetSelectionSpans();
-    info.selectionBackground = _renderSettings.GetColorTableEntry(TextColor::SELECTION_BACKGROUND);
-    return pEngine->PrepareRenderInfo(std::move(info));
+    return pEngine->PrepareRenderInfo(_renderInfo);
 }
 
 // Routine Description:
@@ -1364,6 +1676,51 @@ void Renderer::_ScrollPreviousSelection(const til::point delta)
     }
 }
 
+// Routine Description:
+// - Computes which of the selection rectangles need to be redrawn when the selection
+//   changes from `oldRects` to `newRects`. Both lists contain at most one rectangle per row
+//   and are sorted by increasing Y, which allows us to compare them row by row.
+// Arguments:
+// - oldRects - The previously selected area, in viewport coordinates.
+// - newRects - The newly selected area, in viewport coordinates.
+// Return Value:
+// - The rectangles of all rows whose selection changed, sorted by increasing Y.
+std::vector<til::rect> Renderer::_GetChangedSelectionRects(const std::vector<til::rect>& oldRects, const std::vector<til::rect>& newRects)
+{
+    std::vector<til::rect> changed;
+    auto oldIt = oldRects.begin();
+    auto newIt = newRects.begin();
+    const auto oldEnd = oldRects.end();
+    const auto newEnd = newRects.end();
+
+    while (oldIt != oldEnd && newIt != newEnd)
+    {
+        if (oldIt->top < newIt->top)
+        {
+            changed.emplace_back(*oldIt++);
+        }
+        else if (newIt->top < oldIt->top)
+        {
+            changed.emplace_back(*newIt++);
+        }
+        else
+        {
+            // The same row was selected before and after. If the selected range within it
+            // changed, we invalidate the union of both, which covers the old and new columns.
+            if (*oldIt != *newIt)
+            {
+                changed.emplace_back(*oldIt | *newIt);
+            }
+            ++oldIt;
+            ++newIt;
+        }
+    }
+
+    changed.insert(changed.end(), oldIt, oldEnd);
+    changed.insert(changed.end(), newIt, newEnd);
+    return changed;
+}
+
 // Method Description:
 // - Adds another Render engine to this renderer. Future rendering calls will
 //      also be sent to the new renderer.
@@ -1382,6 +1739,7 @@ void Renderer::AddRenderEngine(_In_ IRenderEngine* const pEngine)
         if (!p)
         {
             p = pEngine;
+            p->SetFrameTimings(&_frameTimings);
             _forceUpdateViewport = true;
             return;
         }
@@ -1398,6 +1756,7 @@ void Renderer::RemoveRenderEngine(_In_ IRenderEngine* const pEngine)
     {
         if (p == pEngine)
         {
+            p->SetFrameTimings(nullptr);
             p = nullptr;
             return;
         }
@@ -1469,3 +1828,15 @@ void Renderer::WaitUntilCanRender()
         pEngine->WaitUntilCanRender();
     }
 }
+
+// Method Description:
+// - Asks the engines to release the resources they can recreate later on,
+//   because painting has been suspended for a window that isn't visible.
+//   Must be called on the render thread.
+void Renderer::TrimResources() noexcept
+{
+    FOREACH_ENGINE(pEngine)
+    {
+        pEngine->TrimResources();
+    }
+}
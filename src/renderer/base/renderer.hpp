@@ -63,6 +63,7 @@ namespace Microsoft::Console::Render
         void UpdateSoftFont(const std::span<const uint16_t> bitPattern,
                             const til::size cellSize,
                             const size_t centeringHint);
+        void SynchronizedOutputChanged() noexcept;
 
         [[nodiscard]] HRESULT GetProposedFont(const int iDpi,
                                               const FontInfoDesired& FontInfoDesired,
@@ -73,6 +74,13 @@ namespace Microsoft::Console::Render
         void EnablePainting();
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs);
         void WaitUntilCanRender();
+        void TrimResources() noexcept;
+        void SetBackgroundPainting(const bool background) noexcept;
+        void SetAnimationFrameRate(const int framesPerSecond) noexcept;
+        void SetAnimationsPaused(const bool paused) noexcept;
+        void SetMaxFrameRate(const int framesPerSecond) noexcept;
+        RenderThread::FrameStatistics GetFrameStatistics() const noexcept;
+        FrameTimings& GetFrameTimings() noexcept;
 
         void AddRenderEngine(_In_ IRenderEngine* const pEngine);
         void RemoveRenderEngine(_In_ IRenderEngine* const pEngine);
@@ -92,11 +100,14 @@ namespace Microsoft::Console::Render
         {
             til::point absoluteOrigin;
             TextAttribute baseAttribute;
+            // The viewport-relative cells the composition was drawn into, for _invalidateOldComposition().
+            til::rect invalidated;
         };
 
         static GridLineSet s_GetGridlines(const TextAttribute& textAttribute) noexcept;
         static bool s_IsSoftFontChar(const std::wstring_view& v, const size_t firstSoftFontChar, const size_t lastSoftFontChar);
 
+        bool _isSynchronizingOutput() noexcept;
         [[nodiscard]] HRESULT _PaintFrame() noexcept;
         [[nodiscard]] HRESULT _PaintFrameForEngine(_In_ IRenderEngine* const pEngine) noexcept;
         bool _CheckViewportAndScroll();
@@ -106,38 +117,63 @@ namespace Microsoft::Console::Render
         void _PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngine, const TextAttribute textAttribute, const size_t cchLine, const til::point coordTarget);
         bool _isHoveredHyperlink(const TextAttribute& textAttribute) const noexcept;
         void _PaintSelection(_In_ IRenderEngine* const pEngine);
+        // The pattern matches of IRenderData as [beg, end) column ranges, sorted by row and column and without overlaps.
+        // They're only rebuilt if the pattern generation changed, so that a frame doesn't query the matches of each cell.
+        struct PatternRange
+        {
+            til::CoordType y = 0;
+            til::CoordType beg = 0;
+            til::CoordType end = 0;
+        };
+
         void _PaintCursor(_In_ IRenderEngine* const pEngine);
         [[nodiscard]] HRESULT _UpdateDrawingBrushes(_In_ IRenderEngine* const pEngine, const TextAttribute attr, const bool usingSoftFont, const bool isSettingDefaultBrushes);
         [[nodiscard]] HRESULT _PerformScrolling(_In_ IRenderEngine* const pEngine);
         void _ScrollPreviousSelection(const til::point delta);
+        void _updateSelectionRects(std::span<const til::point_span> spans);
+        static std::vector<til::rect> _GetChangedSelectionRects(const std::vector<til::rect>& oldRects, const std::vector<til::rect>& newRects);
         [[nodiscard]] HRESULT _PaintTitle(IRenderEngine* const pEngine);
         bool _isInHoveredInterval(til::point coordTarget) const noexcept;
+        void _updatePatternRanges();
+        bool _isInPattern(til::point coordTarget) const noexcept;
+        std::span<const PatternRange> _getPatternRanges(til::CoordType y) const noexcept;
         void _updateCursorInfo();
         void _invalidateCurrentCursor() const;
         void _invalidateOldComposition() const;
         void _prepareNewComposition();
+        void _prepareRenderInfo();
         [[nodiscard]] HRESULT _PrepareRenderInfo(_In_ IRenderEngine* const pEngine);
 
         const RenderSettings& _renderSettings;
         std::array<IRenderEngine*, 2> _engines{};
         IRenderData* _pData = nullptr; // Non-ownership pointer
         std::unique_ptr<RenderThread> _pThread;
+        FrameTimings _frameTimings;
         static constexpr size_t _firstSoftFontChar = 0xEF20;
         size_t _lastSoftFontChar = 0;
         uint16_t _hyperlinkHoveredId = 0;
         std::optional<interval_tree::IntervalTree<til::point, size_t>::interval> _hoveredInterval;
+        std::vector<PatternRange> _patternRanges;
+        til::generation_t _patternGeneration;
         Microsoft::Console::Types::Viewport _viewport;
         CursorOptions _currentCursorOptions;
         std::optional<CompositionCache> _compositionCache;
+        // The parts of a frame that don't depend on the engine. They're computed once
+        // per frame by _PaintFrame(), so that additional engines only cost their own output.
+        RenderFrameInfo _renderInfo{};
         std::vector<Cluster> _clusterBuffer;
         std::function<void()> _pfnBackgroundColorChanged;
         std::function<void()> _pfnFrameColorChanged;
         std::function<void()> _pfnRendererEnteredErrorState;
         bool _destructing = false;
         bool _forceUpdateViewport = false;
+        // The steady_clock time at which we stop waiting for the application to finish
+        // its synchronized update, or 0 if there is none. See SynchronizedOutputChanged().
+        std::atomic<std::chrono::steady_clock::rep> _synchronizedOutputDeadline{ 0 };
 
         til::point_span _lastSelectionPaintSpan{};
         size_t _lastSelectionPaintSize{};
         std::vector<til::rect> _lastSelectionRectsByViewport{};
+        std::optional<til::point_span> _lastSearchHighlightFocused;
     };
 }
@@ -189,7 +189,7 @@ DWORD WINAPI RenderThread::_ThreadProc()
             if (!_fNextFrameRequested.exchange(false, std::memory_order_acq_rel))
             {
                 // Wait until a next frame is requested.
-                WaitForSingleObject(_hEvent, INFINITE);
+                _WaitForFrameRequest();
             }
 
             // <--
@@ -213,16 +213,192 @@ DWORD WINAPI RenderThread::_ThreadProc()
             ResetEvent(_hEvent);
         }
 
+        if (_fBackground.load(std::memory_order_relaxed))
+        {
+            _WaitForBackgroundFrame();
+        }
+        else
+        {
+            _backgroundSince = {};
+
+            if (const std::chrono::milliseconds interval{ _minimumFrameInterval.load(std::memory_order_relaxed) }; interval > interval.zero())
+            {
+                _WaitUntilFrameDue(interval);
+                // The frame we're about to paint covers all the requests we've received while waiting.
+                _fNextFrameRequested.store(false, std::memory_order_relaxed);
+            }
+        }
+
         ResetEvent(_hPaintCompletedEvent);
+
+        // If the engine still needs to animate, PaintFrame() will ask for another one.
+        _animationFrameRequested = false;
+        _deferredFrameTime = {};
+
+        const auto paintStart = std::chrono::steady_clock::now();
         LOG_IF_FAILED(_pRenderer->PaintFrame());
+        const auto paintEnd = std::chrono::steady_clock::now();
+
+        _lastPaint = paintStart;
+        _frames.fetch_add(1, std::memory_order_relaxed);
+        if (paintEnd - paintStart > _frameBudget)
+        {
+            _missedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+
         SetEvent(_hPaintCompletedEvent);
     }
 
     return S_OK;
 }
 
+// Method Description:
+// - Blocks until NotifyPaint() requests a new frame, or until the next animation
+//   frame is due, if NotifyAnimationFrame() was called during the last one.
+// - While the window is in the background, the wait times out after _suspendTimeout,
+//   at which point painting gets suspended (see _UpdateSuspension()). NotifyPaint() calls
+//   are then ignored until SetBackgroundPainting(false) is called, while the engines keep
+//   accumulating the invalidated regions, which is cheap. The first frame after resuming
+//   repaints everything that changed in the meantime in one go.
+void RenderThread::_WaitForFrameRequest() noexcept
+{
+    for (;;)
+    {
+        const auto background = _fBackground.load(std::memory_order_relaxed);
+        DWORD timeout = INFINITE;
+
+        if (!background)
+        {
+            _backgroundSince = {};
+
+            if (_fSuspended)
+            {
+                _fSuspended = false;
+                return;
+            }
+
+            if (_animationFrameRequested && !_fAnimationsPaused.load(std::memory_order_relaxed))
+            {
+                const std::chrono::milliseconds interval{ _animationFrameInterval.load(std::memory_order_relaxed) };
+                const auto remaining = _lastPaint + interval - std::chrono::steady_clock::now();
+                if (remaining <= std::chrono::steady_clock::duration::zero())
+                {
+                    return;
+                }
+                timeout = gsl::narrow_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count());
+            }
+
+            if (_deferredFrameTime != std::chrono::steady_clock::time_point{})
+            {
+                const auto remaining = _deferredFrameTime - std::chrono::steady_clock::now();
+                if (remaining <= std::chrono::steady_clock::duration::zero())
+                {
+                    return;
+                }
+                timeout = std::min(timeout, gsl::narrow_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count()));
+            }
+        }
+        else if (const auto remaining = _UpdateSuspension(); remaining > std::chrono::steady_clock::duration::zero())
+        {
+            timeout = gsl::narrow_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(remaining).count());
+        }
+
+        if (WaitForSingleObject(_hEvent, timeout) == WAIT_TIMEOUT)
+        {
+            continue;
+        }
+
+        // We're shutting down and need to paint one last time. See ~RenderThread().
+        if (!_fKeepRunning)
+        {
+            return;
+        }
+
+        // Either we're suspended and need to ignore any NotifyPaint(), or SetBackgroundPainting(true)
+        // woke us up to start the suspension timer. In the latter case we might swallow a NotifyPaint()
+        // that happened at the same time. That's fine, because the window isn't visible anyway, and the
+        // invalidation will be painted by the next frame or by the one after SetBackgroundPainting(false).
+        if (_fSuspended || (!background && _fBackground.load(std::memory_order_relaxed)))
+        {
+            continue;
+        }
+
+        return;
+    }
+}
+
+// Method Description:
+// - Hidden or minimized windows don't need to be painted at the display's refresh rate.
+//   This delays the next frame until _backgroundFrameInterval has passed since the last one.
+//   Any NotifyPaint() calls in the meantime are coalesced into that frame, which keeps
+//   heavy output from keeping the render thread busy and contending with it for the lock.
+// - If the window stays in the background for longer than _suspendTimeout, painting gets
+//   suspended and this blocks until the window becomes visible again.
+// - SetBackgroundPainting(false) cuts the wait short.
+void RenderThread::_WaitForBackgroundFrame() noexcept
+{
+    if (_UpdateSuspension() <= std::chrono::steady_clock::duration::zero())
+    {
+        _WaitForFrameRequest();
+    }
+    else
+    {
+        _WaitUntilFrameDue(_backgroundFrameInterval);
+    }
+
+    // The frame we're about to paint covers all the requests we've received while waiting.
+    _fNextFrameRequested.store(false, std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Blocks until `interval` has passed since the last frame, unless _hEvent gets signaled before that.
+//   NotifyPaint() doesn't signal it in the meantime, because we aren't _fWaiting.
+void RenderThread::_WaitUntilFrameDue(const std::chrono::steady_clock::duration interval) noexcept
+{
+    const auto elapsed = std::chrono::steady_clock::now() - _lastPaint;
+    if (elapsed >= interval)
+    {
+        return;
+    }
+
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(interval - elapsed);
+    WaitForSingleObject(_hEvent, gsl::narrow_cast<DWORD>(remaining.count()));
+}
+
+// Method Description:
+// - Tracks how long the window has been in the background and suspends painting once that
+//   exceeds _suspendTimeout. Suspending asks the engines to release their GPU resources,
+//   like the swap chain and glyph atlas, which can be a lot with dozens of open tabs.
+// Return Value:
+// - The time until painting gets suspended, or zero if it already is.
+std::chrono::steady_clock::duration RenderThread::_UpdateSuspension() noexcept
+{
+    if (_fSuspended)
+    {
+        return std::chrono::steady_clock::duration::zero();
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (_backgroundSince == std::chrono::steady_clock::time_point{})
+    {
+        _backgroundSince = now;
+    }
+
+    const auto remaining = _suspendTimeout - (now - _backgroundSince);
+    if (remaining > std::chrono::steady_clock::duration::zero())
+    {
+        return remaining;
+    }
+
+    _pRenderer->TrimResources();
+    _fSuspended = true;
+    return std::chrono::steady_clock::duration::zero();
+}
+
 void RenderThread::NotifyPaint() noexcept
 {
+    _notifications.fetch_add(1, std::memory_order_relaxed);
+
     if (_fWaiting.load(std::memory_order_acquire))
     {
         SetEvent(_hEvent);
@@ -243,6 +419,82 @@ void RenderThread::DisablePainting() noexcept
     ResetEvent(_hPaintEnabledEvent);
 }
 
+// Method Description:
+// - Throttles painting to a low frame rate while the window is hidden or occluded,
+//   and suspends it entirely if it stays that way for longer than _suspendTimeout.
+// Arguments:
+// - background: true if the window isn't visible, false if it is.
+void RenderThread::SetBackgroundPainting(const bool background) noexcept
+{
+    if (_fBackground.exchange(background, std::memory_order_relaxed) != background)
+    {
+        // Wake up the thread, so that it starts the suspension timer in _WaitForFrameRequest(),
+        // or so that a window that just became visible gets painted immediately.
+        SetEvent(_hEvent);
+    }
+}
+
+// Method Description:
+// - Requests another frame, just because the engine is animating (e.g. a pixel shader that
+//   uses the time). Unlike NotifyPaint(), the frame is delayed until the animation frame
+//   interval has passed since the last one, so that an animated shader doesn't force us to
+//   render at the display's refresh rate. Anything that calls NotifyPaint() in the meantime
+//   still gets painted immediately and the animation just continues from there.
+// - Animation frames are skipped entirely while paused or while the window is in the background.
+// - Must only be called by the render thread, during PaintFrame().
+void RenderThread::NotifyAnimationFrame() noexcept
+{
+    _animationFrameRequested = true;
+}
+
+// Method Description:
+// - Requests a frame at the given point in time, unless NotifyPaint() requests one before that.
+//   This is used to hold off painting while an application synchronizes its output (DECSET 2026).
+// - Must only be called by the render thread, during PaintFrame().
+void RenderThread::NotifyPaintAt(const std::chrono::steady_clock::time_point time) noexcept
+{
+    _deferredFrameTime = time;
+}
+
+// Method Description:
+// - Sets the minimum time between two frames requested via NotifyAnimationFrame().
+//   Zero means that they're painted as fast as NotifyPaint() ones.
+void RenderThread::SetAnimationFrameInterval(const std::chrono::milliseconds interval) noexcept
+{
+    _animationFrameInterval.store(interval.count(), std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Pauses animation frames without affecting regular ones, for instance while the pane is unfocused.
+void RenderThread::SetAnimationsPaused(const bool paused) noexcept
+{
+    if (_fAnimationsPaused.exchange(paused, std::memory_order_relaxed) && !paused)
+    {
+        // Resume the animation right away. If we aren't waiting, this is at worst a spurious frame.
+        SetEvent(_hEvent);
+    }
+}
+
+// Method Description:
+// - Sets the minimum time between two frames. Zero means that frames are painted as soon as
+//   they're requested, which is only throttled by the engine's WaitUntilCanRender().
+// - PaintFrame() holds the console lock for as long as the engine takes to draw the frame.
+//   With slow engines (e.g. GDI without a GPU) this puts a cap on the time per second that
+//   the output thread has to wait for the lock. Requests in the meantime are coalesced.
+void RenderThread::SetMinimumFrameInterval(const std::chrono::milliseconds interval) noexcept
+{
+    _minimumFrameInterval.store(interval.count(), std::memory_order_relaxed);
+}
+
+RenderThread::FrameStatistics RenderThread::GetFrameStatistics() const noexcept
+{
+    return {
+        .notifications = _notifications.load(std::memory_order_relaxed),
+        .frames = _frames.load(std::memory_order_relaxed),
+        .missedFrames = _missedFrames.load(std::memory_order_relaxed),
+    };
+}
+
 void RenderThread::WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) noexcept
 {
     // When rendering takes place via DirectX, and a console application
@@ -21,6 +21,13 @@ namespace Microsoft::Console::Render
     class RenderThread
     {
     public:
+        struct FrameStatistics
+        {
+            uint64_t notifications = 0; // NotifyPaint() calls
+            uint64_t frames = 0; // PaintFrame() calls
+            uint64_t missedFrames = 0; // PaintFrame() calls that took longer than a frame at 60 Hz
+        };
+
         RenderThread();
         ~RenderThread();
 
@@ -30,10 +37,25 @@ namespace Microsoft::Console::Render
         void EnablePainting() noexcept;
         void DisablePainting() noexcept;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) noexcept;
+        void SetBackgroundPainting(const bool background) noexcept;
+        void NotifyAnimationFrame() noexcept;
+        void NotifyPaintAt(std::chrono::steady_clock::time_point time) noexcept;
+        void SetAnimationFrameInterval(const std::chrono::milliseconds interval) noexcept;
+        void SetAnimationsPaused(const bool paused) noexcept;
+        void SetMinimumFrameInterval(const std::chrono::milliseconds interval) noexcept;
+        FrameStatistics GetFrameStatistics() const noexcept;
 
     private:
+        static constexpr std::chrono::microseconds _frameBudget{ 16667 };
+        static constexpr std::chrono::milliseconds _backgroundFrameInterval{ 250 };
+        static constexpr std::chrono::seconds _suspendTimeout{ 30 };
+
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
+        void _WaitForFrameRequest() noexcept;
+        void _WaitForBackgroundFrame() noexcept;
+        void _WaitUntilFrameDue(const std::chrono::steady_clock::duration interval) noexcept;
+        std::chrono::steady_clock::duration _UpdateSuspension() noexcept;
 
         HANDLE _hThread;
         HANDLE _hEvent;
@@ -46,5 +68,21 @@ namespace Microsoft::Console::Render
         bool _fKeepRunning;
         std::atomic<bool> _fNextFrameRequested;
         std::atomic<bool> _fWaiting;
+        std::atomic<bool> _fBackground{ false };
+        bool _fSuspended = false;
+        std::chrono::steady_clock::time_point _backgroundSince;
+
+        // Only accessed by the render thread itself. See NotifyAnimationFrame().
+        bool _animationFrameRequested = false;
+        // Only accessed by the render thread itself. See NotifyPaintAt().
+        std::chrono::steady_clock::time_point _deferredFrameTime;
+        std::atomic<bool> _fAnimationsPaused{ false };
+        std::atomic<std::chrono::milliseconds::rep> _animationFrameInterval{ 0 };
+        std::atomic<std::chrono::milliseconds::rep> _minimumFrameInterval{ 0 };
+
+        std::chrono::steady_clock::time_point _lastPaint;
+        std::atomic<uint64_t> _notifications{ 0 };
+        std::atomic<uint64_t> _frames{ 0 };
+        std::atomic<uint64_t> _missedFrames{ 0 };
     };
 }
@@ -97,7 +97,7 @@ namespace Microsoft::Console::Render
 
         bool _fPaintStarted;
 
-        til::rect _invalidCharacters;
+        std::vector<til::rect> _invalidCharacters;
         PAINTSTRUCT _psInvalidData;
         HDC _hdcMemoryContext;
         bool _isTrueTypeFont;
@@ -143,6 +143,11 @@ namespace Microsoft::Console::Render
         til::size _szInvalidScroll;
         til::rect _rcInvalid;
         bool _fInvalidRectUsed;
+        // The invalid area as a list of disjoint, full-width pixel bands sorted from top to bottom. _rcInvalid is their
+        // bounding box. Two small changes far apart (say, the cursor and a status line at the bottom) thus don't
+        // force us to repaint and BitBlt everything in between, which matters a lot over RDP.
+        std::vector<til::rect> _invalidBands;
+        static constexpr size_t s_cMaxInvalidBands = 16;
 
         COLORREF _lastFg;
         COLORREF _lastBg;
@@ -172,6 +177,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _InvalidCombine(const til::rect* const prc) noexcept;
         [[nodiscard]] HRESULT _InvalidOffset(const til::point* const ppt) noexcept;
         [[nodiscard]] HRESULT _InvalidRestrict() noexcept;
+        void _InvalidAddBand(const til::rect& rc);
 
         [[nodiscard]] HRESULT _InvalidateRect(const til::rect* const prc) noexcept;
 
@@ -183,8 +189,6 @@ namespace Microsoft::Console::Render
         static int s_ScaleByDpi(const int iPx, const int iDpi);
         static int s_ShrinkByDpi(const int iPx, const int iDpi);
 
-        til::point _GetInvalidRectPoint() const;
-        til::size _GetInvalidRectSize() const;
         til::size _GetRectSize(const RECT* const pRect) const;
 
         void _OrRect(_In_ til::rect* const pRectExisting, const til::rect* const pRectToOr) const;
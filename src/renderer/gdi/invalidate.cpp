@@ -107,6 +107,7 @@ HRESULT GdiEngine::InvalidateAll() noexcept
 // Return Value:
 // - S_OK, GDI related failure, or safemath failure.
 HRESULT GdiEngine::_InvalidCombine(const til::rect* const prc) noexcept
+try
 {
     if (!_fInvalidRectUsed)
     {
@@ -118,11 +119,14 @@ HRESULT GdiEngine::_InvalidCombine(const til::rect* const prc) noexcept
         _OrRect(&_rcInvalid, prc);
     }
 
+    _InvalidAddBand(*prc);
+
     // Ensure invalid areas remain within bounds of window.
     RETURN_IF_FAILED(_InvalidRestrict());
 
     return S_OK;
 }
+CATCH_RETURN()
 
 // Routine Description:
 // - Helper to adjust the invalid region by the given offset such as when a scroll operation occurs.
@@ -131,6 +135,7 @@ HRESULT GdiEngine::_InvalidCombine(const til::rect* const prc) noexcept
 // Return Value:
 // - S_OK, GDI related failure, or safemath failure.
 HRESULT GdiEngine::_InvalidOffset(const til::point* ppt) noexcept
+try
 {
     if (_fInvalidRectUsed)
     {
@@ -144,12 +149,20 @@ HRESULT GdiEngine::_InvalidOffset(const til::point* ppt) noexcept
         // This is the equivalent of adding in the "update rectangle" that we would get out of ScrollWindowEx/ScrollDC.
         _rcInvalid |= rcInvalidNew;
 
+        // The same applies to each of the bands individually.
+        const auto bands = _invalidBands;
+        for (const auto& band : bands)
+        {
+            _InvalidAddBand(band + til::point{ 0, ppt->y });
+        }
+
         // Ensure invalid areas remain within bounds of window.
         RETURN_IF_FAILED(_InvalidRestrict());
     }
 
     return S_OK;
 }
+CATCH_RETURN()
 
 // Routine Description:
 // - Helper to ensure the invalid region remains within the bounds of the window.
@@ -170,9 +183,64 @@ HRESULT GdiEngine::_InvalidRestrict() noexcept
     _rcInvalid.top = std::clamp(_rcInvalid.top, rcClient.top, rcClient.bottom);
     _rcInvalid.bottom = std::clamp(_rcInvalid.bottom, rcClient.top, rcClient.bottom);
 
+    for (auto& band : _invalidBands)
+    {
+        band.left = rcClient.left;
+        band.right = rcClient.right;
+        band.top = std::clamp(band.top, rcClient.top, rcClient.bottom);
+        band.bottom = std::clamp(band.bottom, rcClient.top, rcClient.bottom);
+    }
+    std::erase_if(_invalidBands, [](const til::rect& band) { return band.top >= band.bottom; });
+
     return S_OK;
 }
 
+// Routine Description:
+// - Helper to add the rows covered by the given rectangle to the list of invalid bands.
+//   Overlapping and adjacent bands are merged. If there are too many of them, the two closest
+//   ones are merged as well, since at some point a single BitBlt is cheaper than many small ones.
+// Arguments:
+// - rc - Pixel region (til::rect) that should be repainted on the next frame
+// Return Value:
+// - <none>
+void GdiEngine::_InvalidAddBand(const til::rect& rc)
+{
+    if (rc.top >= rc.bottom)
+    {
+        return;
+    }
+
+    til::rect band{ _rcInvalid.left, rc.top, _rcInvalid.right, rc.bottom };
+
+    // Find all bands that overlap or touch the new one and replace them with their union.
+    const auto beg = std::lower_bound(_invalidBands.begin(), _invalidBands.end(), band.top, [](const til::rect& r, const til::CoordType top) {
+        return r.bottom < top;
+    });
+    auto end = beg;
+    for (; end != _invalidBands.end() && end->top <= band.bottom; ++end)
+    {
+        band.top = std::min(band.top, end->top);
+        band.bottom = std::max(band.bottom, end->bottom);
+    }
+    const auto it = _invalidBands.erase(beg, end);
+    _invalidBands.insert(it, band);
+
+    if (_invalidBands.size() > s_cMaxInvalidBands)
+    {
+        size_t closest = 0;
+        for (size_t i = 1; i + 1 < _invalidBands.size(); ++i)
+        {
+            if (til::at(_invalidBands, i + 1).top - til::at(_invalidBands, i).bottom < til::at(_invalidBands, closest + 1).top - til::at(_invalidBands, closest).bottom)
+            {
+                closest = i;
+            }
+        }
+
+        til::at(_invalidBands, closest).bottom = til::at(_invalidBands, closest + 1).bottom;
+        _invalidBands.erase(_invalidBands.begin() + closest + 1);
+    }
+}
+
 // Routine Description:
 // - Helper to add a pixel rectangle to the invalid area
 // Arguments:
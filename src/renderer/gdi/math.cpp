@@ -17,13 +17,30 @@ using namespace Microsoft::Console::Render;
 // Return Value:
 // - S_OK or math failure
 [[nodiscard]] HRESULT GdiEngine::GetDirtyArea(std::span<const til::rect>& area) noexcept
+try
 {
-    _invalidCharacters = til::rect{ _psInvalidData.rcPaint }.scale_down(_GetFontSize());
+    const auto fontSize = _GetFontSize();
+    _invalidCharacters.clear();
 
-    area = { &_invalidCharacters, 1 };
+    for (const auto& band : _invalidBands)
+    {
+        // Bands may only be a few pixels apart and thus round to overlapping rows.
+        const auto rect = band.scale_down(fontSize);
+        if (!_invalidCharacters.empty() && _invalidCharacters.back().bottom >= rect.top)
+        {
+            _invalidCharacters.back().bottom = rect.bottom;
+        }
+        else
+        {
+            _invalidCharacters.emplace_back(rect);
+        }
+    }
+
+    area = _invalidCharacters;
 
     return S_OK;
 }
+CATCH_RETURN()
 
 // Routine Description:
 // - Uses the currently selected font to determine how wide the given character will be when rendered.
@@ -94,32 +111,6 @@ int GdiEngine::s_ShrinkByDpi(const int iPx, const int iDpi)
     return MulDiv(iPx, s_iBaseDpi, iDpi);
 }
 
-// Routine Description:
-// - Uses internal invalid structure to determine the top left pixel point of the invalid frame to be painted.
-// Arguments:
-// - <none>
-// Return Value:
-// - Top left corner in pixels of where to start repainting the frame.
-til::point GdiEngine::_GetInvalidRectPoint() const
-{
-    til::point pt;
-    pt.x = _psInvalidData.rcPaint.left;
-    pt.y = _psInvalidData.rcPaint.top;
-
-    return pt;
-}
-
-// Routine Description:
-// - Uses internal invalid structure to determine the size of the invalid area of the frame to be painted.
-// Arguments:
-// - <none>
-// Return Value:
-// - Width and height in pixels of the invalid area of the frame.
-til::size GdiEngine::_GetInvalidRectSize() const
-{
-    return _GetRectSize(&_psInvalidData.rcPaint);
-}
-
 // Routine Description:
 // - Converts a pixel region (til::rect) into its width/height (til::size)
 // Arguments:
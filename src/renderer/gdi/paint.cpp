@@ -224,14 +224,16 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
 
     LOG_IF_FAILED(_FlushBufferLines());
 
-    const auto pt = _GetInvalidRectPoint();
-    const auto sz = _GetInvalidRectSize();
-
-    LOG_HR_IF(E_FAIL, !(BitBlt(_psInvalidData.hdc, pt.x, pt.y, sz.width, sz.height, _hdcMemoryContext, pt.x, pt.y, SRCCOPY)));
+    // Only copy the bands that actually changed, instead of their bounding box _rcInvalid.
+    for (const auto& band : _invalidBands)
+    {
+        LOG_HR_IF(E_FAIL, !(BitBlt(_psInvalidData.hdc, band.left, band.top, band.width(), band.height(), _hdcMemoryContext, band.left, band.top, SRCCOPY)));
+    }
     WHEN_DBG(_DebugBltAll());
 
     _rcInvalid = {};
     _fInvalidRectUsed = false;
+    _invalidBands.clear();
     _szInvalidScroll = {};
 
     LOG_HR_IF(E_FAIL, !(GdiFlush()));
@@ -297,7 +299,11 @@ bool GdiEngine::FontHasWesternScript(HDC hdc)
 
     if (_psInvalidData.fErase)
     {
-        RETURN_IF_FAILED(_PaintBackgroundColor(&_psInvalidData.rcPaint));
+        for (const auto& band : _invalidBands)
+        {
+            const auto rc = band.to_win32_rect();
+            RETURN_IF_FAILED(_PaintBackgroundColor(&rc));
+        }
     }
 
     return S_OK;
@@ -0,0 +1,213 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- FrameTimings.hpp
+
+Abstract:
+- Collects how long the individual phases of each rendered frame took.
+- The Renderer owns an instance and hands it to its engines, which can report
+  their own internal phases. Every finished frame is written to a small history
+  from which percentiles can be computed and, if a trace session is listening,
+  emitted as an ETW event.
+- Capturing is off unless someone asked for it (SetCaptureEnabled) or the
+  tracing provider is enabled, so the render loop doesn't read the clock otherwise.
+  The only exception are a few cumulative counters (GetCounters), which are
+  always collected and only read the clock at the start and end of each frame.
+- It also measures the input latency: The time from a key press to the first
+  frame that was presented after output arrived in response to it. The host marks
+  the key press, the write to the connection and the arrival of output, and the
+  renderer attributes them to the frame that's painted next.
+--*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string_view>
+
+namespace Microsoft::Console::Render
+{
+    enum class FramePhase : uint8_t
+    {
+        // Renderer: Waiting to acquire the console lock.
+        LockWait,
+        // Renderer: Time spent holding the console lock (includes PrepareRenderInfo).
+        LockHeld,
+        // Renderer: _PrepareRenderInfo(), collecting selection and search highlights.
+        PrepareRenderInfo,
+        // Renderer: IRenderEngine::Present() (includes all of the engine phases below).
+        Present,
+        // Engine: Font fallback and text shaping.
+        Shaping,
+        // Engine: Rasterizing glyphs that weren't in the glyph atlas yet.
+        GlyphRasterization,
+        // Engine: Building and submitting the draw calls, minus GlyphRasterization.
+        QuadBuilding,
+        // Engine: Handing the frame to the swap chain.
+        SwapChainPresent,
+        // Renderer: The entire frame from lock acquisition to the end of Present().
+        Total,
+        Count,
+    };
+
+    class FrameTimings
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        static constexpr size_t PhaseCount = static_cast<size_t>(FramePhase::Count);
+        static constexpr size_t HistorySize = 256;
+
+        struct Percentiles
+        {
+            // All values are in microseconds.
+            uint32_t p50 = 0;
+            uint32_t p90 = 0;
+            uint32_t p99 = 0;
+            uint32_t max = 0;
+        };
+
+        struct Statistics
+        {
+            // The number of frames the percentiles were computed from (at most HistorySize).
+            size_t frames = 0;
+            // The number of times the glyph atlas was reset or compacted throughout these frames.
+            size_t atlasResets = 0;
+            std::array<Percentiles, PhaseCount> phases{};
+            // The number of key presses the inputLatency percentiles were computed from (at most HistorySize).
+            size_t inputSamples = 0;
+            Percentiles inputLatency{};
+        };
+
+        // Frames that take longer than this are counted as slow frames.
+        static constexpr clock::duration SlowFrameThreshold = std::chrono::microseconds{ 16667 };
+
+        struct Counters
+        {
+            // The number of frames painted since the renderer was created.
+            uint64_t frames = 0;
+            // The number of those that took longer than SlowFrameThreshold.
+            uint64_t slowFrames = 0;
+            // The size of the glyph atlas texture, if the engine uses one.
+            uint64_t glyphAtlasBytes = 0;
+        };
+
+        // Measures the time from its construction to its destruction and adds it to the given phase.
+        // If capturing is disabled, this doesn't read the clock at all.
+        class Scope
+        {
+        public:
+            Scope(FrameTimings* timings, FramePhase phase) noexcept;
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+            clock::duration Elapsed() const noexcept;
+
+        private:
+            FrameTimings* _timings;
+            FramePhase _phase;
+            clock::time_point _start;
+        };
+
+        static constexpr std::wstring_view PhaseName(FramePhase phase) noexcept
+        {
+            switch (phase)
+            {
+            case FramePhase::LockWait:
+                return L"Lock wait";
+            case FramePhase::LockHeld:
+                return L"Lock held";
+            case FramePhase::PrepareRenderInfo:
+                return L"Prepare info";
+            case FramePhase::Present:
+                return L"Present";
+            case FramePhase::Shaping:
+                return L"Shaping";
+            case FramePhase::GlyphRasterization:
+                return L"Rasterization";
+            case FramePhase::QuadBuilding:
+                return L"Quad building";
+            case FramePhase::SwapChainPresent:
+                return L"Swap chain";
+            case FramePhase::Total:
+                return L"Total";
+            default:
+                return L"?";
+            }
+        }
+
+        void SetCaptureEnabled(bool enabled) noexcept;
+        static void TraceBackendSelection(std::wstring_view backend, clock::duration direct3D11FrameCost, clock::duration direct2DFrameCost) noexcept;
+
+        // These are only to be called by the render thread.
+        void BeginFrame() noexcept;
+        void EndFrame() noexcept;
+        bool IsCapturing() const noexcept;
+        void Add(FramePhase phase, clock::duration duration) noexcept;
+        clock::duration Get(FramePhase phase) const noexcept;
+        void AddAtlasReset() noexcept;
+        void SetGlyphAtlasBytes(uint64_t bytes) noexcept;
+
+        // Can be called from any thread.
+        Statistics GetStatistics() const;
+        Counters GetCounters() const noexcept;
+        void MarkKeyReceived() noexcept;
+        void MarkInputWritten() noexcept;
+        void MarkOutputReceived() noexcept;
+
+        // To be called by the render thread while it holds the console lock.
+        void LatchInput() noexcept;
+
+    private:
+        struct Frame
+        {
+            std::array<uint32_t, PhaseCount> phases{};
+            uint32_t atlasResets = 0;
+        };
+
+        std::atomic<bool> _captureRequested{ false };
+        bool _capturing = false;
+        std::array<clock::duration, PhaseCount> _current{};
+        uint32_t _currentAtlasResets = 0;
+        clock::time_point _frameStart;
+
+        std::atomic<uint64_t> _frameCount{ 0 };
+        std::atomic<uint64_t> _slowFrameCount{ 0 };
+        std::atomic<uint64_t> _glyphAtlasBytes{ 0 };
+
+        struct InputTimestamps
+        {
+            uint32_t sequence = 0;
+            int64_t key = 0;
+            int64_t written = 0;
+            int64_t output = 0;
+        };
+
+        bool _wantsCapture() const noexcept;
+        void _commitInput() noexcept;
+
+        mutable std::mutex _historyMutex;
+        std::array<Frame, HistorySize> _history{};
+        size_t _historyCount = 0;
+        size_t _historyNext = 0;
+        std::array<uint32_t, HistorySize> _inputHistory{};
+        size_t _inputHistoryCount = 0;
+        size_t _inputHistoryNext = 0;
+
+        // The clock ticks at which the oldest key press that hasn't been answered with output yet
+        // went through the phases of the input path. 0 means that the phase hasn't been reached.
+        // _inputSequence counts key presses and serves as the correlation id in the trace events.
+        std::atomic<int64_t> _keyTime{ 0 };
+        std::atomic<int64_t> _writtenTime{ 0 };
+        std::atomic<int64_t> _outputTime{ 0 };
+        std::atomic<uint32_t> _inputSequence{ 0 };
+        // Set by LatchInput() if output arrived before the current frame started painting.
+        InputTimestamps _latchedInput;
+    };
+}
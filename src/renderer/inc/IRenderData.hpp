@@ -18,6 +18,8 @@ Author(s):
 #include "../../renderer/inc/FontInfo.hpp"
 #include "../../types/inc/viewport.hpp"
 
+#include <til/generational.h>
+
 class Cursor;
 class TextBuffer;
 
@@ -64,7 +66,10 @@ namespace Microsoft::Console::Render
         virtual const std::wstring_view GetConsoleTitle() const noexcept = 0;
         virtual const std::wstring GetHyperlinkUri(uint16_t id) const = 0;
         virtual const std::wstring GetHyperlinkCustomId(uint16_t id) const = 0;
-        virtual const std::vector<size_t> GetPatternId(const til::point location) const = 0;
+        // The regex pattern matches in the viewport, in viewport-relative coordinates and sorted by their start.
+        // The generation changes whenever the matches do, so that callers can cache anything they derive from them.
+        virtual std::span<const til::point_span> GetPatternSpans() const noexcept = 0;
+        virtual til::generation_t GetPatternGeneration() const noexcept = 0;
 
         // This block used to be IUiaData.
         virtual std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept = 0;
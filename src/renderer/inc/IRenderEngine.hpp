@@ -19,6 +19,7 @@ Author(s):
 #include "CursorOptions.h"
 #include "Cluster.hpp"
 #include "FontInfoDesired.hpp"
+#include "FrameTimings.hpp"
 #include "IRenderData.hpp"
 #include "RenderSettings.hpp"
 #include "../../buffer/out/LineRendition.hpp"
@@ -63,6 +64,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]] virtual HRESULT EndPaint() noexcept = 0;
         [[nodiscard]] virtual bool RequiresContinuousRedraw() noexcept = 0;
         virtual void WaitUntilCanRender() noexcept = 0;
+        virtual void TrimResources() noexcept = 0;
+        virtual void SetFrameTimings(FrameTimings* timings) noexcept = 0;
         [[nodiscard]] virtual HRESULT Present() noexcept = 0;
         [[nodiscard]] virtual HRESULT ScrollFrame() noexcept = 0;
         [[nodiscard]] virtual HRESULT Invalidate(const til::rect* psrRegion) noexcept = 0;
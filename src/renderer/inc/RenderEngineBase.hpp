@@ -50,6 +50,8 @@ namespace Microsoft::Console::Render
         [[nodiscard]] bool RequiresContinuousRedraw() noexcept override;
 
         void WaitUntilCanRender() noexcept override;
+        void TrimResources() noexcept override;
+        void SetFrameTimings(FrameTimings* timings) noexcept override;
         void UpdateHyperlinkHoveredId(const uint16_t hoveredId) noexcept override;
 
     protected:
@@ -25,7 +25,8 @@ namespace Microsoft::Console::Render
             AlwaysDistinguishableColors,
             IntenseIsBold,
             IntenseIsBright,
-            ScreenReversed
+            ScreenReversed,
+            SynchronizedOutput
         };
 
         RenderSettings() noexcept;
@@ -47,6 +48,8 @@ namespace Microsoft::Console::Render
         void ToggleBlinkRendition(class Renderer* renderer) noexcept;
 
     private:
+        COLORREF _getPerceivableColor(COLORREF fg, COLORREF bg, size_t fgIndex, size_t bgIndex) const noexcept;
+
         til::enumset<Mode> _renderMode{ Mode::BlinkAllowed, Mode::IntenseIsBright };
         std::array<COLORREF, TextColor::TABLE_SIZE> _colorTable;
         std::array<size_t, static_cast<size_t>(ColorAlias::ENUM_COUNT)> _colorAliasIndices;
@@ -55,5 +58,9 @@ namespace Microsoft::Console::Render
         size_t _blinkCycle = 0;
         mutable bool _blinkIsInUse = false;
         bool _blinkShouldBeFaint = false;
+        // The perceivable foreground colors for each pair of color table entries, indexed by
+        // [bgIndex * TABLE_SIZE + fgIndex]. It's built on first use and cleared whenever the
+        // color table changes. It's empty unless the "adjust indistinguishable colors" mode is used.
+        mutable std::vector<COLORREF> _perceivableColors;
     };
 }
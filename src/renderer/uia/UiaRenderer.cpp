@@ -5,6 +5,8 @@
 
 #include "UiaRenderer.hpp"
 
+#include <til/unicode.h>
+
 #pragma hdrstop
 
 using namespace Microsoft::Console::Render;
@@ -156,6 +158,20 @@ try
         _newOutput.append(newText);
         _newOutput.push_back(L'\n');
         _textBufferChanged = true;
+
+        // During heavy output a frame can accumulate megabytes of text, which we'd
+        // then announce in thousands of notifications that no screen reader could
+        // ever catch up with. Only the most recent output is worth announcing,
+        // so we drop the oldest text (in batches, to avoid moving it every time).
+        if (_newOutput.size() > 2 * maxQueuedOutput)
+        {
+            auto trim = _newOutput.size() - maxQueuedOutput;
+            if (til::is_trailing_surrogate(til::at(_newOutput, trim)))
+            {
+                trim++;
+            }
+            _newOutput.erase(0, trim);
+        }
     }
     return S_OK;
 }
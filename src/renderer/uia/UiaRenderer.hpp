@@ -64,6 +64,9 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _DoUpdateTitle(const std::wstring_view newTitle) noexcept override;
 
     private:
+        // The maximum number of characters we announce per frame.
+        static constexpr size_t maxQueuedOutput = 16 * 1024;
+
         bool _isEnabled;
         bool _isPainting;
         bool _selectionChanged;
@@ -6,6 +6,7 @@
 #include "ApiSorter.h"
 
 #include "ApiDispatchers.h"
+#include "ApiStatistics.h"
 
 #include "../host/tracing.hpp"
 
@@ -168,6 +169,9 @@ PCONSOLE_API_MSG ApiSorter::ConsoleDispatchRequest(_Inout_ PCONSOLE_API_MSG Mess
     Message->State.WriteOffset = Message->msgHeader.ApiDescriptorSize;
     Message->State.ReadOffset = Message->msgHeader.ApiDescriptorSize + sizeof(CONSOLE_MSG_HEADER);
 
+    const auto measure = ApiStatistics::IsEnabled();
+    const auto start = measure ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+
     HRESULT hr = S_OK;
     try
     {
@@ -182,6 +186,14 @@ PCONSOLE_API_MSG ApiSorter::ConsoleDispatchRequest(_Inout_ PCONSOLE_API_MSG Mess
         hr = E_UNEXPECTED;
     }
 
+    if (measure)
+    {
+        ApiStatistics::Record(Message->msgHeader.ApiNumber,
+                              Descriptor->TraceName,
+                              Message->Descriptor.InputSize + Message->Descriptor.OutputSize,
+                              std::chrono::steady_clock::now() - start);
+    }
+
     // Unfortunately, we can't be as clear-cut with our error codes as we'd like since we have some callers that take
     // hard dependencies on NTSTATUS codes that aren't readily expressible as an HRESULT. There's currently only one
     // such known code -- STATUS_BUFFER_TOO_SMALL. There's a conlibk dependency on this being returned from the console
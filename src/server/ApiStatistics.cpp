@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "ApiStatistics.h"
+
+#include <bit>
+
+#include <TraceLoggingProvider.h>
+
+#pragma warning(push)
+#pragma warning(disable : 26426) // Global initializer calls a non-constexpr function '...' (i.22).)
+#pragma warning(disable : 26447) // The function is declared 'noexcept' but calls function '...' which may throw exceptions
+#pragma warning(disable : 26477) // Use 'nullptr' rather than 0 or NULL
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26482) // Only index into arrays using constant expressions (bounds.2).
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator (bounds.4).
+
+TRACELOGGING_DEFINE_PROVIDER(g_hConsoleApiStatisticsTraceProvider,
+                             "Microsoft.Windows.Console.Server.ApiStatistics",
+                             // {090f1370-d1a5-574c-72fe-f4d897898508}
+                             (0x090f1370, 0xd1a5, 0x574c, 0x72, 0xfe, 0xf4, 0xd8, 0x97, 0x89, 0x85, 0x08));
+
+namespace
+{
+    // ApiSorter has 3 layers of APIs, none of which has more than 64 entries.
+    constexpr size_t LayerCount = 3;
+    constexpr size_t ApisPerLayer = 64;
+
+    struct Entry
+    {
+        PCSTR name = nullptr;
+        uint64_t calls = 0;
+        uint64_t bytes = 0;
+        uint64_t totalUs = 0;
+        uint32_t histogram[ApiStatistics::BucketCount]{};
+    };
+
+    // This is a bit over 70KB, but it lives in the zero-initialized .bss section,
+    // so it doesn't cost any memory until the provider is enabled for the first time.
+    wil::srwlock s_lock;
+    Entry s_entries[LayerCount][ApisPerLayer];
+    uint64_t s_recorded = 0;
+
+    void reset() noexcept
+    {
+        const auto guard = s_lock.lock_exclusive();
+        for (auto& layer : s_entries)
+        {
+            for (auto& entry : layer)
+            {
+                entry = {};
+            }
+        }
+        s_recorded = 0;
+    }
+
+    void dump() noexcept
+    {
+        // Don't hold the lock while we're calling into ETW.
+        uint64_t lowerBounds[ApiStatistics::BucketCount];
+        for (size_t i = 0; i < ApiStatistics::BucketCount; ++i)
+        {
+            lowerBounds[i] = ApiStatistics::BucketLowerBound(i);
+        }
+
+        for (size_t layer = 0; layer < LayerCount; ++layer)
+        {
+            for (size_t api = 0; api < ApisPerLayer; ++api)
+            {
+                Entry entry;
+                {
+                    const auto guard = s_lock.lock_shared();
+                    entry = s_entries[layer][api];
+                }
+
+                if (!entry.calls)
+                {
+                    continue;
+                }
+
+                TraceLoggingWrite(g_hConsoleApiStatisticsTraceProvider,
+                                  "ApiStatistics",
+                                  TraceLoggingHexUInt32(gsl::narrow_cast<uint32_t>(((layer + 1) << 24) | api), "ApiNumber"),
+                                  TraceLoggingString(entry.name, "ApiName"),
+                                  TraceLoggingUInt64(entry.calls, "Calls"),
+                                  TraceLoggingUInt64(entry.bytes, "Bytes"),
+                                  TraceLoggingUInt64(entry.totalUs, "TotalMicroseconds"),
+                                  TraceLoggingUInt64Array(&lowerBounds[0], gsl::narrow_cast<UINT16>(ApiStatistics::BucketCount), "BucketLowerBoundsMicroseconds"),
+                                  TraceLoggingUInt32Array(&entry.histogram[0], gsl::narrow_cast<UINT16>(ApiStatistics::BucketCount), "Histogram"),
+                                  TraceLoggingLevel(WINEVENT_LEVEL_INFO));
+            }
+        }
+    }
+
+    void NTAPI enableCallback(LPCGUID, ULONG isEnabled, UCHAR, ULONGLONG, ULONGLONG, PEVENT_FILTER_DESCRIPTOR, PVOID) noexcept
+    {
+        switch (isEnabled)
+        {
+        case EVENT_CONTROL_CODE_ENABLE_PROVIDER:
+            reset();
+            break;
+        case EVENT_CONTROL_CODE_CAPTURE_STATE:
+            dump();
+            break;
+        default:
+            break;
+        }
+    }
+
+    const auto cleanup = []() noexcept {
+        TraceLoggingRegisterEx(g_hConsoleApiStatisticsTraceProvider, enableCallback, nullptr);
+        return wil::scope_exit([]() noexcept {
+            TraceLoggingUnregister(g_hConsoleApiStatisticsTraceProvider);
+        });
+    }();
+}
+
+bool ApiStatistics::IsEnabled() noexcept
+{
+    return TraceLoggingProviderEnabled(g_hConsoleApiStatisticsTraceProvider, 0, 0);
+}
+
+// Routine Description:
+// - Adds a console API call to the statistics. Call IsEnabled() first to avoid measuring the call for nothing.
+// Arguments:
+// - apiNumber - The ApiNumber from the message header. It must have been validated by ApiSorter.
+// - apiName - The name of the API. It must be a string literal, as it's retained.
+// - bytes - The size of the input and output buffers of the call.
+// - duration - How long it took to dispatch the call. This doesn't include the time it spent waiting, if it pended.
+void ApiStatistics::Record(ULONG apiNumber, PCSTR apiName, ULONG bytes, std::chrono::steady_clock::duration duration) noexcept
+{
+    const size_t layer = (apiNumber >> 24) - 1;
+    const size_t api = apiNumber & 0xffffff;
+    if (layer >= LayerCount || api >= ApisPerLayer)
+    {
+        return;
+    }
+
+    const auto us = gsl::narrow_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+    uint64_t recorded;
+
+    {
+        const auto guard = s_lock.lock_exclusive();
+        auto& entry = s_entries[layer][api];
+        entry.name = apiName;
+        entry.calls++;
+        entry.bytes += bytes;
+        entry.totalUs += us;
+        entry.histogram[BucketFromMicroseconds(us)]++;
+        recorded = s_recorded++;
+    }
+
+    if (recorded % SampleInterval == 0)
+    {
+        TraceLoggingWrite(g_hConsoleApiStatisticsTraceProvider,
+                          "ApiCall",
+                          TraceLoggingHexUInt32(apiNumber, "ApiNumber"),
+                          TraceLoggingString(apiName, "ApiName"),
+                          TraceLoggingUInt32(bytes, "Bytes"),
+                          TraceLoggingUInt64(us, "Microseconds"),
+                          TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE));
+    }
+}
+
+size_t ApiStatistics::BucketFromMicroseconds(uint64_t us) noexcept
+{
+    if (us < 4)
+    {
+        return gsl::narrow_cast<size_t>(us);
+    }
+
+    // The index of the highest set bit (>= 2), followed by the next two bits below it.
+    const auto exponent = gsl::narrow_cast<size_t>(63 - std::countl_zero(us));
+    const auto fraction = gsl::narrow_cast<size_t>((us >> (exponent - 2)) & 3);
+    return std::min(BucketCount - 1, 4 + (exponent - 2) * 4 + fraction);
+}
+
+uint64_t ApiStatistics::BucketLowerBound(size_t bucket) noexcept
+{
+    if (bucket < 4)
+    {
+        return bucket;
+    }
+
+    const auto exponent = (bucket - 4) / 4 + 2;
+    const auto fraction = (bucket - 4) % 4;
+    return (4 + fraction) << (exponent - 2);
+}
+
+#pragma warning(pop)
@@ -0,0 +1,34 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ApiStatistics.h
+
+Abstract:
+- This file collects the number, size and duration of the console API calls dispatched by ApiSorter.
+- It's opt-in: Nothing is measured unless the "Microsoft.Windows.Console.Server.ApiStatistics" ETW provider
+  {090f1370-d1a5-574c-72fe-f4d897898508} is enabled. While it is, every call is added to a per-API
+  log-linear histogram of its duration and one in every SampleInterval calls is also logged as an "ApiCall" event.
+- The histograms are dumped as "ApiStatistics" events on demand, by requesting a capture state
+  (for instance "xperf -capturestate <session> <provider>"). Enabling the provider resets them.
+--*/
+
+#pragma once
+
+class ApiStatistics
+{
+public:
+    static constexpr size_t SampleInterval = 16;
+
+    // The durations are measured in microseconds. The first 4 buckets hold 0-3us and every power of 2 after that is split
+    // into 4 equally sized buckets, for instance 4us, 5us, 6us, 7us, then 8-9us, 10-11us, and so on. The last bucket
+    // starts at 7*2^22us (~29s) and holds everything longer than that. This keeps the relative error below 25% at any scale.
+    static constexpr size_t BucketCount = 96;
+
+    static bool IsEnabled() noexcept;
+    static void Record(ULONG apiNumber, PCSTR apiName, ULONG bytes, std::chrono::steady_clock::duration duration) noexcept;
+
+    static size_t BucketFromMicroseconds(uint64_t us) noexcept;
+    static uint64_t BucketLowerBound(size_t bucket) noexcept;
+};
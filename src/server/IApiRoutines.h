@@ -54,7 +54,7 @@ public:
     [[nodiscard]] virtual HRESULT SetConsoleOutputModeImpl(IConsoleOutputObject& context,
                                                            const ULONG mode) noexcept = 0;
 
-    [[nodiscard]] virtual HRESULT GetNumberOfConsoleInputEventsImpl(const IConsoleInputObject& context,
+    [[nodiscard]] virtual HRESULT GetNumberOfConsoleInputEventsImpl(IConsoleInputObject& context,
                                                                     ULONG& events) noexcept = 0;
 
     [[nodiscard]] virtual HRESULT GetConsoleInputImpl(IConsoleInputObject& context,
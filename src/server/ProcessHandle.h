@@ -65,5 +65,9 @@ private:
     const ConsoleProcessPolicy _policy;
     const ConsoleShimPolicy _shimPolicy;
 
+    // The neighbors of this process in its ConsoleProcessList, which are ordered from oldest to newest.
+    ConsoleProcessHandle* _prev = nullptr;
+    ConsoleProcessHandle* _next = nullptr;
+
     friend class ConsoleProcessList; // ensure List manages lifetimes and not other classes.
 };
@@ -31,20 +31,29 @@ using namespace Microsoft::Console::Interactivity;
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    if (FindProcessInList(dwProcessId))
-    {
-        return S_FALSE;
-    }
-
     std::unique_ptr<ConsoleProcessHandle> pProcessData;
     try
     {
+        const auto [it, inserted] = _processes.try_emplace(dwProcessId, nullptr);
+        if (!inserted)
+        {
+            return S_FALSE;
+        }
+
+        auto erase = wil::scope_exit([&]() noexcept { _processes.erase(it); });
         pProcessData = std::make_unique<ConsoleProcessHandle>(dwProcessId, dwThreadId, ulProcessGroupId);
-        _processes.emplace_back(pProcessData.get());
+        it->second = pProcessData.get();
+        erase.release();
     }
     CATCH_RETURN();
 
-    wil::assign_to_opt_param(ppProcessData, pProcessData.release());
+    // Append the new process to the end of the list, which keeps it in the order the processes attached in.
+    const auto p = pProcessData.release();
+    p->_prev = _newest;
+    (_newest ? _newest->_next : _oldest) = p;
+    _newest = p;
+
+    wil::assign_to_opt_param(ppProcessData, p);
 
     return S_OK;
 }
@@ -59,10 +68,12 @@ void ConsoleProcessList::FreeProcessData(_In_ ConsoleProcessHandle* const pProce
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    const auto it = std::ranges::find(_processes, pProcessData);
-    if (it != _processes.end())
+    const auto it = _processes.find(pProcessData->dwProcessId);
+    if (it != _processes.end() && it->second == pProcessData)
     {
         _processes.erase(it);
+        (pProcessData->_prev ? pProcessData->_prev->_next : _oldest) = pProcessData->_next;
+        (pProcessData->_next ? pProcessData->_next->_prev : _newest) = pProcessData->_prev;
         delete pProcessData;
     }
     else
@@ -84,15 +95,8 @@ ConsoleProcessHandle* ConsoleProcessList::FindProcessInList(const DWORD dwProces
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    for (const auto& p : _processes)
-    {
-        if (p->dwProcessId == dwProcessId)
-        {
-            return p;
-        }
-    }
-
-    return nullptr;
+    const auto it = _processes.find(dwProcessId);
+    return it != _processes.end() ? it->second : nullptr;
 }
 
 // Routine Description:
@@ -105,7 +109,7 @@ ConsoleProcessHandle* ConsoleProcessList::FindProcessByGroupId(_In_ ULONG ulProc
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    for (const auto& p : _processes)
+    for (auto p = _oldest; p; p = p->_next)
     {
         if (p->_ulProcessGroupId == ulProcessGroupId)
         {
@@ -124,7 +128,7 @@ ConsoleProcessHandle* ConsoleProcessList::GetRootProcess() const
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    for (const auto& p : _processes)
+    for (auto p = _oldest; p; p = p->_next)
     {
         if (p->fRootProcess)
         {
@@ -147,12 +151,7 @@ ConsoleProcessHandle* ConsoleProcessList::GetOldestProcess() const
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    if (!_processes.empty())
-    {
-        return _processes.front();
-    }
-
-    return nullptr;
+    return _oldest;
 }
 
 // Routine Description:
@@ -178,12 +177,9 @@ ConsoleProcessHandle* ConsoleProcessList::GetOldestProcess() const
     // Some applications, when reading the process list through the GetConsoleProcessList API,
     // are expecting the returned list of attached process IDs to be from newest to oldest.
     // As such, we have to put the newest process into the head of the list.
-    auto it = _processes.crbegin();
-    const auto end = _processes.crend();
-
-    for (; it != end; ++it)
+    for (auto p = _newest; p; p = p->_prev)
     {
-        *pProcessList++ = (*it)->dwProcessId;
+        *pProcessList++ = p->dwProcessId;
     }
 
     *pcProcessList = _processes.size();
@@ -213,13 +209,9 @@ ConsoleProcessHandle* ConsoleProcessList::GetOldestProcess() const
 
         // The caller (ProcessCtrlEvents) expects them in newest-to-oldest order,
         // because that's how Windows has historically always dispatched these events.
-        auto it = _processes.crbegin();
-        const auto end = _processes.crend();
-
         // Dig through known processes looking for a match
-        for (; it != end; ++it)
+        for (auto p = _newest; p; p = p->_prev)
         {
-            const auto p = *it;
             // If no limit was specified OR if we have a match, generate a new termination record.
             if (!dwLimitingProcessId ||
                 p->_ulProcessGroupId == dwLimitingProcessId)
@@ -264,7 +256,7 @@ void ConsoleProcessList::ModifyConsoleProcessFocus(const bool fForeground)
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    for (const auto& pProcessHandle : _processes)
+    for (auto pProcessHandle = _oldest; pProcessHandle; pProcessHandle = pProcessHandle->_next)
     {
         if (pProcessHandle->_hProcess)
         {
@@ -58,7 +58,11 @@ public:
     bool IsEmpty() const;
 
 private:
-    std::vector<ConsoleProcessHandle*> _processes;
+    // Build systems can attach thousands of processes to a single console, so they're indexed by their ID.
+    // The order in which they attached is kept by an intrusive list (ConsoleProcessHandle::_prev/_next).
+    std::unordered_map<DWORD, ConsoleProcessHandle*> _processes;
+    ConsoleProcessHandle* _oldest = nullptr;
+    ConsoleProcessHandle* _newest = nullptr;
 
     void _ModifyProcessForegroundRights(const HANDLE hProcess, const bool fForeground) const;
 };
@@ -70,11 +70,19 @@ ConsoleWaitBlock::ConsoleWaitBlock(_In_ ConsoleWaitQueue* const pProcessQueue,
 //   constant time with the iterator acquired on construction.
 ConsoleWaitBlock::~ConsoleWaitBlock()
 {
-    _pProcessQueue->_blocks.erase(_itProcessQueue);
-    _pObjectQueue->_blocks.erase(_itObjectQueue);
+    _pProcessQueue->_unlink(this);
+    _pObjectQueue->_unlink(this);
     delete _pWaiter;
 }
 
+// Routine Description:
+// - Returns the links of this block in the given queue, which must be one of the two queues it's in.
+ConsoleWaitBlock::QueueLinks& ConsoleWaitBlock::_linksFor(const ConsoleWaitQueue* const pQueue) noexcept
+{
+    assert(pQueue == _pProcessQueue || pQueue == _pObjectQueue);
+    return pQueue == _pProcessQueue ? _processQueueLinks : _objectQueueLinks;
+}
+
 // Routine Description:
 // - Creates and enqueues a new wait for later callback when a routine cannot be serviced at this time.
 // - Will extract the process ID and the target object, enqueuing in both to know when to callback
@@ -106,9 +114,6 @@ ConsoleWaitBlock::~ConsoleWaitBlock()
                                           pWaitReplyMessage,
                                           pWaiter);
 
-        // Set the iterators on the wait block so that it can remove itself later.
-        pWaitBlock->_itProcessQueue = pProcessQueue->_blocks.insert(pProcessQueue->_blocks.end(), pWaitBlock);
-        pWaitBlock->_itObjectQueue = pObjectQueue->_blocks.insert(pObjectQueue->_blocks.end(), pWaitBlock);
     }
     catch (...)
     {
@@ -117,6 +122,11 @@ ConsoleWaitBlock::~ConsoleWaitBlock()
         return hr;
     }
 
+    // The block removes itself from both queues when it's deleted. Since the queues
+    // are intrusive lists, neither of these can fail, nor do they allocate.
+    pProcessQueue->_append(pWaitBlock);
+    pObjectQueue->_append(pWaitBlock);
+
     return S_OK;
 }
 
@@ -21,8 +21,6 @@ Revision History:
 #include "IWaitRoutine.h"
 #include "WaitTerminationReason.h"
 
-#include <list>
-
 class ConsoleWaitQueue;
 
 class ConsoleWaitBlock
@@ -41,13 +39,25 @@ private:
                      const CONSOLE_API_MSG* const pWaitReplyMessage,
                      _In_ IWaitRoutine* const pWaiter);
 
+    // A block is linked into two queues at once (see ConsoleWaitQueue::s_CreateWait),
+    // so it holds the links of an intrusive list for each of them.
+    struct QueueLinks
+    {
+        ConsoleWaitBlock* prev = nullptr;
+        ConsoleWaitBlock* next = nullptr;
+    };
+
+    QueueLinks& _linksFor(const ConsoleWaitQueue* const pQueue) noexcept;
+
     ConsoleWaitQueue* const _pProcessQueue;
-    std::_List_const_iterator<std::_List_val<std::_List_simple_types<ConsoleWaitBlock*>>> _itProcessQueue;
+    QueueLinks _processQueueLinks;
 
     ConsoleWaitQueue* const _pObjectQueue;
-    std::_List_const_iterator<std::_List_val<std::_List_simple_types<ConsoleWaitBlock*>>> _itObjectQueue;
+    QueueLinks _objectQueueLinks;
 
     CONSOLE_API_MSG _WaitReplyMessage;
 
     IWaitRoutine* const _pWaiter;
+
+    friend class ConsoleWaitQueue; // The queues walk the blocks through their QueueLinks.
 };
@@ -11,10 +11,7 @@
 
 // Routine Description:
 // - Instantiates a new ConsoleWaitQueue
-ConsoleWaitQueue::ConsoleWaitQueue() :
-    _blocks()
-{
-}
+ConsoleWaitQueue::ConsoleWaitQueue() = default;
 
 // Routine Description:
 // - Destructs a ConsoleWaitQueue
@@ -76,16 +73,9 @@ bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll,
 {
     auto fResult = false;
 
-    auto it = _blocks.cbegin();
-    while (!_blocks.empty() && it != _blocks.cend())
+    for (auto WaitBlock = _head; WaitBlock;)
     {
-        const auto WaitBlock = (*it);
-        if (nullptr == WaitBlock)
-        {
-            break;
-        }
-
-        const auto nextIt = std::next(it); // we have to capture next before it is potentially erased
+        const auto next = WaitBlock->_linksFor(this).next; // we have to capture next before it is potentially deleted
 
         if (_NotifyBlock(WaitBlock, TerminationReason))
         {
@@ -97,12 +87,33 @@ bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll,
             break;
         }
 
-        it = nextIt;
+        WaitBlock = next;
     }
 
     return fResult;
 }
 
+// Routine Description:
+// - Appends the given block to the end of this queue.
+void ConsoleWaitQueue::_append(_In_ ConsoleWaitBlock* const pWaitBlock) noexcept
+{
+    auto& links = pWaitBlock->_linksFor(this);
+    links.prev = _tail;
+    links.next = nullptr;
+    (_tail ? _tail->_linksFor(this).next : _head) = pWaitBlock;
+    _tail = pWaitBlock;
+}
+
+// Routine Description:
+// - Removes the given block from this queue. Called by the block when it's deleted.
+void ConsoleWaitQueue::_unlink(_In_ ConsoleWaitBlock* const pWaitBlock) noexcept
+{
+    auto& links = pWaitBlock->_linksFor(this);
+    (links.prev ? links.prev->_linksFor(this).next : _head) = links.next;
+    (links.next ? links.next->_linksFor(this).prev : _tail) = links.prev;
+    links = {};
+}
+
 // Routine Description:
 // - A helper to delete successfully notified callbacks
 // Arguments:
@@ -17,8 +17,6 @@ Revision History:
 
 #pragma once
 
-#include <list>
-
 #include "../host/conapi.h"
 
 #include "IWaitRoutine.h"
@@ -44,7 +42,13 @@ private:
     bool _NotifyBlock(_In_ ConsoleWaitBlock* pWaitBlock,
                       const WaitTerminationReason TerminationReason);
 
-    std::list<ConsoleWaitBlock*> _blocks;
+    void _append(_In_ ConsoleWaitBlock* const pWaitBlock) noexcept;
+    void _unlink(_In_ ConsoleWaitBlock* const pWaitBlock) noexcept;
+
+    // An intrusive list of blocks in the order they started waiting. See ConsoleWaitBlock::QueueLinks.
+    // A wait happens for every blocking read, so this avoids allocating a list node for each of the two queues.
+    ConsoleWaitBlock* _head = nullptr;
+    ConsoleWaitBlock* _tail = nullptr;
 
     friend class ConsoleWaitBlock; // Blocks live in multiple queues so we let them manage the lifetime.
 };
@@ -0,0 +1,232 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "InlineImage.hpp"
+
+#include <wincodec.h>
+
+#include "../../types/inc/utils.hpp"
+
+using namespace Microsoft::Console::Utils;
+using namespace Microsoft::Console::VirtualTerminal;
+
+// Routine Description:
+// - Decodes the image data of an OSC 1337;File sequence.
+// Arguments:
+// - arguments - The semicolon separated key=value pairs preceding the data.
+//   We support `inline`, `width`, `height` and `preserveAspectRatio`.
+//   Images that aren't marked as `inline=1` are file downloads, which we ignore.
+// - data - The decoded contents of the file.
+// - cellSize - The size of a cell in the ImageSlice pixel space.
+// - availableCells - The maximum number of cells the image may cover.
+// Return Value:
+// - The decoded image, or nullopt if it couldn't be decoded.
+std::optional<InlineImage> InlineImage::Decode(const std::wstring_view arguments, const std::string_view data, const til::size cellSize, const til::size availableCells)
+try
+{
+    std::wstring_view widthArg;
+    std::wstring_view heightArg;
+    auto isInline = false;
+    auto preserveAspectRatio = true;
+
+    for (const auto& part : SplitString(arguments, L';'))
+    {
+        const auto separator = part.find(L'=');
+        if (separator == std::wstring_view::npos)
+        {
+            continue;
+        }
+
+        const auto key = part.substr(0, separator);
+        const auto value = part.substr(separator + 1);
+        if (key == L"inline")
+        {
+            isInline = value == L"1";
+        }
+        else if (key == L"width")
+        {
+            widthArg = value;
+        }
+        else if (key == L"height")
+        {
+            heightArg = value;
+        }
+        else if (key == L"preserveAspectRatio")
+        {
+            preserveAspectRatio = value != L"0";
+        }
+    }
+
+    const auto maxWidth = availableCells.width * cellSize.width;
+    const auto maxHeight = availableCells.height * cellSize.height;
+    if (!isInline || data.empty() || maxWidth <= 0 || maxHeight <= 0)
+    {
+        return std::nullopt;
+    }
+
+    // The output thread may or may not have initialized COM already.
+    // If it has, but with a different apartment type, we can still use it.
+    const auto coInit = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    const auto coUninit = wil::scope_exit([&]() noexcept {
+        if (SUCCEEDED(coInit))
+        {
+            CoUninitialize();
+        }
+    });
+
+    const auto wicFactory = wil::CoCreateInstance<IWICImagingFactory>(CLSID_WICImagingFactory);
+
+    wil::com_ptr<IWICStream> stream;
+    THROW_IF_FAILED(wicFactory->CreateStream(stream.addressof()));
+    THROW_IF_FAILED(stream->InitializeFromMemory(reinterpret_cast<BYTE*>(const_cast<char*>(data.data())), gsl::narrow<DWORD>(data.size())));
+
+    wil::com_ptr<IWICBitmapDecoder> decoder;
+    THROW_IF_FAILED(wicFactory->CreateDecoderFromStream(stream.get(), nullptr, WICDecodeMetadataCacheOnDemand, decoder.addressof()));
+
+    wil::com_ptr<IWICBitmapFrameDecode> frame;
+    THROW_IF_FAILED(decoder->GetFrame(0, frame.addressof()));
+
+    UINT srcWidthU = 0;
+    UINT srcHeightU = 0;
+    THROW_IF_FAILED(frame->GetSize(&srcWidthU, &srcHeightU));
+    const auto srcWidth = gsl::narrow<til::CoordType>(srcWidthU);
+    const auto srcHeight = gsl::narrow<til::CoordType>(srcHeightU);
+    if (srcWidth <= 0 || srcHeight <= 0)
+    {
+        return std::nullopt;
+    }
+
+    // Determine the size of the image. Dimensions that weren't given are
+    // either derived from the other one (to preserve the aspect ratio),
+    // or taken from the image itself. We then scale the result down
+    // if it doesn't fit into the available space.
+    const auto requestedWidth = _parseDimension(widthArg, cellSize.width, maxWidth);
+    const auto requestedHeight = _parseDimension(heightArg, cellSize.height, maxHeight);
+    auto width = requestedWidth.value_or(srcWidth);
+    auto height = requestedHeight.value_or(srcHeight);
+    if (preserveAspectRatio)
+    {
+        if (requestedWidth && !requestedHeight)
+        {
+            height = std::max(1, MulDiv(width, srcHeight, srcWidth));
+        }
+        else if (requestedHeight && !requestedWidth)
+        {
+            width = std::max(1, MulDiv(height, srcWidth, srcHeight));
+        }
+        else if (requestedWidth && requestedHeight)
+        {
+            // If both are given, the image is fit into that box.
+            if (static_cast<int64_t>(width) * srcHeight > static_cast<int64_t>(height) * srcWidth)
+            {
+                width = std::max(1, MulDiv(height, srcWidth, srcHeight));
+            }
+            else
+            {
+                height = std::max(1, MulDiv(width, srcHeight, srcWidth));
+            }
+        }
+    }
+    if (width > maxWidth)
+    {
+        height = preserveAspectRatio ? std::max(1, MulDiv(height, maxWidth, width)) : height;
+        width = maxWidth;
+    }
+    if (height > maxHeight)
+    {
+        width = preserveAspectRatio ? std::max(1, MulDiv(width, maxHeight, height)) : width;
+        height = maxHeight;
+    }
+
+    IWICBitmapSource* source = frame.get();
+    wil::com_ptr<IWICBitmapScaler> scaler;
+    if (width != srcWidth || height != srcHeight)
+    {
+        THROW_IF_FAILED(wicFactory->CreateBitmapScaler(scaler.addressof()));
+        THROW_IF_FAILED(scaler->Initialize(source, gsl::narrow_cast<UINT>(width), gsl::narrow_cast<UINT>(height), WICBitmapInterpolationModeFant));
+        source = scaler.get();
+    }
+
+    // ImageSlice pixels are premultiplied BGRA, the same as sixel output.
+    wil::com_ptr<IWICFormatConverter> converter;
+    THROW_IF_FAILED(wicFactory->CreateFormatConverter(converter.addressof()));
+    THROW_IF_FAILED(converter->Initialize(source, GUID_WICPixelFormat32bppPBGRA, WICBitmapDitherTypeNone, nullptr, 0, WICBitmapPaletteTypeCustom));
+
+    InlineImage image;
+    image._pixelSize = { width, height };
+    image._cellCount = {
+        (width + cellSize.width - 1) / cellSize.width,
+        (height + cellSize.height - 1) / cellSize.height,
+    };
+    image._pixels.resize(gsl::narrow_cast<size_t>(width) * gsl::narrow_cast<size_t>(height));
+
+    const auto stride = gsl::narrow<UINT>(width * sizeof(RGBQUAD));
+    const auto bytes = gsl::narrow<UINT>(image._pixels.size() * sizeof(RGBQUAD));
+    THROW_IF_FAILED(converter->CopyPixels(nullptr, stride, bytes, reinterpret_cast<BYTE*>(image._pixels.data())));
+
+    return image;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return std::nullopt;
+}
+
+til::size InlineImage::PixelSize() const noexcept
+{
+    return _pixelSize;
+}
+
+til::size InlineImage::CellCount() const noexcept
+{
+    return _cellCount;
+}
+
+// Routine Description:
+// - Returns the pixels of the given pixel row.
+const RGBQUAD* InlineImage::Pixels(const til::CoordType y) const noexcept
+{
+    return &til::at(_pixels, gsl::narrow_cast<size_t>(y) * gsl::narrow_cast<size_t>(_pixelSize.width));
+}
+
+// Routine Description:
+// - Parses a width or height argument, which can be given as
+//   a number of cells (N), pixels (Npx), a percentage of the
+//   available space (N%), or `auto` to use the image's own size.
+// Return Value:
+// - The length in pixels, or nullopt for `auto` and invalid values.
+std::optional<til::CoordType> InlineImage::_parseDimension(const std::wstring_view value, const til::CoordType cellLength, const til::CoordType availableLength) noexcept
+{
+    if (value.empty() || value == L"auto")
+    {
+        return std::nullopt;
+    }
+
+    auto digits = value;
+    auto multiplier = cellLength;
+    auto divisor = 1;
+    if (til::ends_with(value, std::wstring_view{ L"px" }))
+    {
+        digits = value.substr(0, value.size() - 2);
+        multiplier = 1;
+    }
+    else if (til::ends_with(value, std::wstring_view{ L"%" }))
+    {
+        digits = value.substr(0, value.size() - 1);
+        multiplier = availableLength;
+        divisor = 100;
+    }
+
+    const auto number = til::parse_unsigned<uint32_t>(digits, 10);
+    if (!number || *number == 0)
+    {
+        return std::nullopt;
+    }
+
+    // Clamp the number before multiplying, so that this can't overflow. The caller
+    // will scale anything larger than the available space down anyway.
+    const auto clamped = gsl::narrow_cast<int64_t>(std::min<uint32_t>(*number, INT16_MAX));
+    const auto length = clamped * multiplier / divisor;
+    return gsl::narrow_cast<til::CoordType>(std::clamp<int64_t>(length, 1, INT32_MAX));
+}
@@ -0,0 +1,37 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- InlineImage.hpp
+
+Abstract:
+- This decodes the images of the iTerm2 inline image protocol (OSC 1337;File).
+- Unlike sixel, the image data is a compressed file (PNG, JPEG, GIF, etc.),
+  which is decoded with WIC and scaled to the requested size, so that the
+  pixels can be copied straight into the ImageSlice of each row.
+--*/
+
+#pragma once
+
+#include "til.h"
+
+namespace Microsoft::Console::VirtualTerminal
+{
+    class InlineImage
+    {
+    public:
+        static std::optional<InlineImage> Decode(const std::wstring_view arguments, const std::string_view data, const til::size cellSize, const til::size availableCells);
+
+        til::size PixelSize() const noexcept;
+        til::size CellCount() const noexcept;
+        const RGBQUAD* Pixels(const til::CoordType y) const noexcept;
+
+    private:
+        static std::optional<til::CoordType> _parseDimension(const std::wstring_view value, const til::CoordType cellLength, const til::CoordType availableLength) noexcept;
+
+        til::size _pixelSize;
+        til::size _cellCount;
+        std::vector<RGBQUAD> _pixels;
+    };
+}
@@ -15,7 +15,6 @@
 #include "InteractDispatch.hpp"
 #include "../../host/conddkrefs.h"
 #include "../../interactivity/inc/ServiceLocator.hpp"
-#include "../../interactivity/inc/EventSynthesis.hpp"
 #include "../../types/inc/Viewport.hpp"
 
 using namespace Microsoft::Console::Interactivity;
@@ -58,19 +57,14 @@ void InteractDispatch::WriteCtrlKey(const INPUT_RECORD& event)
 // Since the hosting terminal for ConPTY may not support win32-input-mode,
 // it may send an "A" key as an "A", for which we need to generate up/down events.
 // Because of this, we cannot simply call InputBuffer::WriteString directly.
+// InputBuffer::WriteKeyText only generates those events once they're actually needed,
+// which makes large pastes significantly faster for applications that read characters.
 void InteractDispatch::WriteString(const std::wstring_view string)
 {
     if (!string.empty())
     {
-        const auto codepage = _api.GetOutputCodePage();
-        InputEventQueue keyEvents;
-
-        for (const auto& wch : string)
-        {
-            CharToKeyEvents(wch, codepage, keyEvents);
-        }
-
-        WriteInput(keyEvents);
+        const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        gci.GetActiveInputBuffer()->WriteKeyText(string, _api.GetOutputCodePage());
     }
 }
 
@@ -53,7 +53,13 @@ void MacroBuffer::InvokeMacro(const size_t macroId, StateMachine& stateMachine)
                     _invokedSequenceLength = 0;
                 }
             });
-            stateMachine.ProcessString(macroSequence);
+            // The first invocation records the actions that the state machine produces,
+            // so that subsequent ones can skip parsing the sequence and replay those.
+            auto& recording = til::at(_recordings, macroId);
+            if (!stateMachine.ReplayActions(recording))
+            {
+                stateMachine.RecordString(macroSequence, recording);
+            }
         }
     }
 }
@@ -70,6 +76,10 @@ void MacroBuffer::ClearMacrosIfInUse()
         {
             std::fill(macro.begin(), macro.end(), AsciiChars::NUL);
         }
+        for (auto& recording : _recordings)
+        {
+            recording.Reset();
+        }
     }
 }
 
@@ -99,12 +109,17 @@ bool MacroBuffer::InitParser(const size_t macroId, const DispatchTypes::MacroDel
         {
         case DispatchTypes::MacroDeleteControl::DeleteId:
             _deleteMacro(_activeMacro());
+            til::at(_recordings, macroId).Reset();
             return true;
         case DispatchTypes::MacroDeleteControl::DeleteAll:
             for (auto& macro : _macros)
             {
                 _deleteMacro(macro);
             }
+            for (auto& recording : _recordings)
+            {
+                recording.Reset();
+            }
             return true;
         default:
             return false;
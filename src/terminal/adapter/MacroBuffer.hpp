@@ -12,6 +12,7 @@ Abstract:
 #pragma once
 
 #include "DispatchTypes.hpp"
+#include "../parser/stateMachine.hpp"
 #include <array>
 #include <bitset>
 #include <string>
@@ -23,8 +24,6 @@ class AdapterTest;
 
 namespace Microsoft::Console::VirtualTerminal
 {
-    class StateMachine;
-
     class MacroBuffer
     {
     public:
@@ -67,6 +66,8 @@ namespace Microsoft::Console::VirtualTerminal
         size_t _repeatCount{ 0 };
         size_t _repeatStart{ 0 };
         std::array<std::wstring, 64> _macros;
+        // The pre-parsed macros. These are reset whenever the macro is redefined.
+        std::array<StateMachine::ActionRecording, 64> _recordings;
         size_t _activeMacroId{ 0 };
         size_t _spaceUsed{ 0 };
         size_t _invokedDepth{ 0 };
@@ -169,15 +169,28 @@ void PageManager::MoveTo(const til::CoordType pageNumber, const bool makeVisible
     // ever has to deal with the main buffer.
     if (makeVisible && _visiblePageNumber != newPageNumber)
     {
-        const auto& newBuffer = _getBuffer(newPageNumber, pageSize);
         auto& saveBuffer = _getBuffer(_visiblePageNumber, pageSize);
         for (auto i = 0; i < pageSize.height; i++)
         {
             visibleBuffer.CopyRow(visibleTop + i, i, saveBuffer);
         }
-        for (auto i = 0; i < pageSize.height; i++)
+        // If the new page has never been accessed, it's still blank, and we
+        // can simply clear the visible rows instead of allocating a buffer
+        // for it only to copy its empty rows.
+        if (til::at(_buffers, newPageNumber - 1))
+        {
+            const auto& newBuffer = _getBuffer(newPageNumber, pageSize);
+            for (auto i = 0; i < pageSize.height; i++)
+            {
+                newBuffer.CopyRow(i, visibleTop + i, visibleBuffer);
+            }
+        }
+        else
         {
-            newBuffer.CopyRow(i, visibleTop + i, visibleBuffer);
+            for (auto i = 0; i < pageSize.height; i++)
+            {
+                visibleBuffer.GetMutableRowByOffset(visibleTop + i).Reset(TextAttribute{});
+            }
         }
         _visiblePageNumber = newPageNumber;
         redrawRequired = true;
@@ -243,8 +256,10 @@ TextBuffer& PageManager::_getBuffer(const til::CoordType pageNumber, const til::
     if (buffer == nullptr)
     {
         // Page buffers are created on demand, and are sized to match the active
-        // page dimensions without any scrollback rows.
-        buffer = std::make_unique<TextBuffer>(pageSize, TextAttribute{}, 0, false, _renderer);
+        // page dimensions without any scrollback rows. They're never rendered
+        // directly (the visible page is always swapped into the main buffer),
+        // so they don't need to be hooked up to the renderer either.
+        buffer = std::make_unique<TextBuffer>(pageSize, TextAttribute{}, 0, false, nullptr);
     }
     else if (buffer->GetSize().Dimensions() != pageSize)
     {
@@ -690,7 +690,9 @@ void SixelParser::_writeToImageBuffer(int sixelValue, int repeatCount)
     const auto targetOffset = _imageCursor.y * _imageMaxWidth + _imageCursor.x;
     auto imageBufferPtr = std::next(_imageBuffer.data(), targetOffset);
     repeatCount = std::min(repeatCount, _imageMaxWidth - _imageCursor.x);
-    for (auto i = 0; i < 6; i++)
+    // Once the remaining bits are all zero there's nothing more to draw, which
+    // skips most of the work for the blank areas that are common in charts.
+    for (; sixelValue; sixelValue >>= 1)
     {
         if (sixelValue & 1)
         {
@@ -705,7 +707,6 @@ void SixelParser::_writeToImageBuffer(int sixelValue, int repeatCount)
         {
             std::advance(imageBufferPtr, _imageMaxWidth * _pixelAspectRatio);
         }
-        sixelValue >>= 1;
     }
     _imageCursor.x += repeatCount;
 }
@@ -783,11 +784,24 @@ void SixelParser::_maybeFlushImageBuffer(const bool endOfSequence)
             const auto columnEnd = _imageOriginCell.x + (_imageWidth + _cellSize.width - 1) / _cellSize.width;
             auto rowOffset = _imageOriginCell.y;
             auto srcIterator = _imageBuffer.begin();
+
+            // The pixels stay indexed until they're flushed, because the color table can
+            // still change, but at this point we can resolve the entire table at once
+            // instead of converting the color of every single pixel.
+            std::array<RGBQUAD, MAX_COLORS> palette;
+            for (size_t i = 0; i < MAX_COLORS; i++)
+            {
+                til::at(palette, i) = _makeRGBQUAD(til::at(_colorTable, i));
+            }
+
             while (srcIterator < _imageBuffer.end() && rowOffset < page.Bottom())
             {
                 if (rowOffset >= 0)
                 {
                     auto& dstRow = page.Buffer().GetMutableRowByOffset(rowOffset);
+                    const auto oldSlice = std::as_const(dstRow).GetImageSlice();
+                    const auto oldRevision = oldSlice ? oldSlice->Revision() : 0;
+                    const auto oldPixels = oldSlice ? oldSlice->Pixels().data() : nullptr;
                     auto dstSlice = dstRow.GetMutableImageSlice();
                     if (!dstSlice)
                     {
@@ -795,6 +809,11 @@ void SixelParser::_maybeFlushImageBuffer(const bool endOfSequence)
                         __assume(dstSlice != nullptr);
                     }
                     auto dstIterator = dstSlice->MutablePixels(columnBegin, columnEnd);
+                    // Applications that redraw the same image over and over (e.g. charts
+                    // in a dashboard) often don't change most of its rows. If the pixels
+                    // weren't reallocated and none of them changed, we keep the previous
+                    // revision, so that the renderer doesn't need to upload them again.
+                    auto changed = oldPixels != dstSlice->Pixels().data();
                     for (auto pixelRow = 0; pixelRow < _cellSize.height; pixelRow++)
                     {
                         for (auto pixelColumn = 0; pixelColumn < _imageWidth; pixelColumn++)
@@ -802,8 +821,13 @@ void SixelParser::_maybeFlushImageBuffer(const bool endOfSequence)
                             const auto srcPixel = til::at(srcIterator, pixelColumn);
                             if (!srcPixel.transparent)
                             {
-                                const auto srcColor = _colorFromIndex(srcPixel.colorIndex);
-                                til::at(dstIterator, pixelColumn) = _makeRGBQUAD(srcColor);
+                                const auto dstPixel = til::at(palette, srcPixel.colorIndex);
+                                auto& dst = til::at(dstIterator, pixelColumn);
+                                if (std::bit_cast<uint32_t>(dst) != std::bit_cast<uint32_t>(dstPixel))
+                                {
+                                    dst = dstPixel;
+                                    changed = true;
+                                }
                             }
                         }
                         std::advance(srcIterator, _imageMaxWidth);
@@ -813,6 +837,10 @@ void SixelParser::_maybeFlushImageBuffer(const bool endOfSequence)
                         }
                         std::advance(dstIterator, dstSlice->PixelWidth());
                     }
+                    if (!changed && oldRevision)
+                    {
+                        dstSlice->RestoreRevision(oldRevision);
+                    }
                 }
                 else
                 {
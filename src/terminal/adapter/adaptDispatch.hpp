@@ -262,6 +262,7 @@ namespace Microsoft::Console::VirtualTerminal
                                              const bool homeCursor = false);
 
         bool _DoLineFeed(const Page& page, const bool withReturn, const bool wrapForced);
+        void _DoITerm2File(const std::wstring_view string);
 
         void _DeviceStatusReport(const wchar_t* parameters) const;
         void _CursorPositionReport(const bool extendedReport);
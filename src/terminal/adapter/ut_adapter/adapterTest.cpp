@@ -2106,7 +2106,7 @@ public:
         // and DECRQM would not then be applicable.
 
         BEGIN_TEST_METHOD_PROPERTIES()
-            TEST_METHOD_PROPERTY(L"Data:modeNumber", L"{1, 3, 5, 6, 7, 8, 12, 25, 40, 66, 67, 69, 117, 1000, 1002, 1003, 1004, 1005, 1006, 1007, 1049, 2004, 9001}")
+            TEST_METHOD_PROPERTY(L"Data:modeNumber", L"{1, 3, 5, 6, 7, 8, 12, 25, 40, 66, 67, 69, 117, 1000, 1002, 1003, 1004, 1005, 1006, 1007, 1049, 2004, 2026, 9001}")
         END_TEST_METHOD_PROPERTIES()
 
         VTInt modeNumber;
@@ -2259,6 +2259,13 @@ public:
             attr.SetIndexedBackground(TextColor::DARK_BLUE);
         });
         verifyChecksumReport(L"FF8B");
+
+        Log::Comment(L"Test 6: Longer runs and wide glyphs");
+        outputText(L"ABCDEFGHIJ"sv);
+        verifyChecksumReport(L"F8E9");
+        // The second column is the trailing half of the wide glyph, so it gets counted twice.
+        outputText(L"\u3042A"sv);
+        verifyChecksumReport(L"9E9C");
     }
 
     TEST_METHOD(ColorTableReportTests)
@@ -3002,6 +3009,41 @@ public:
         VERIFY_ARE_EQUAL(til::point(0, 1), cursor.GetPosition());
     }
 
+    TEST_METHOD(InlineImageTest)
+    {
+        // A 1x1 pixel PNG with a single opaque red pixel.
+        const std::wstring png = L"iVBORw0KGgoAAAANSUhEUgAAAAEAAAABCAYAAAAfFcSJAAAADUlEQVR42mP8z8DwHwAFBQIAX8jx0gAAAABJRU5ErkJggg==";
+
+        _testGetSet->PrepData();
+        auto& textBuffer = *_testGetSet->_textBuffer;
+        auto& cursor = textBuffer.GetCursor();
+        cursor.SetPosition({ 10, 2 });
+
+        Log::Comment(L"Test 1: Files that aren't marked as inline are ignored.");
+        _stateMachine->ProcessString(L"\x1b]1337;File=width=2:" + png + L"\x1b\\");
+        VERIFY_IS_NULL(textBuffer.GetRowByOffset(2).GetImageSlice());
+        VERIFY_ARE_EQUAL(til::point(10, 2), cursor.GetPosition());
+
+        Log::Comment(L"Test 2: Invalid image data is ignored.");
+        _stateMachine->ProcessString(L"\x1b]1337;File=inline=1:AAAA\x1b\\");
+        VERIFY_IS_NULL(textBuffer.GetRowByOffset(2).GetImageSlice());
+        VERIFY_ARE_EQUAL(til::point(10, 2), cursor.GetPosition());
+
+        Log::Comment(L"Test 3: The image is scaled to the requested width, preserving its aspect ratio.");
+        _stateMachine->ProcessString(L"\x1b]1337;File=inline=1;width=2:" + png + L"\x1b\\");
+        const auto slice = textBuffer.GetRowByOffset(2).GetImageSlice();
+        VERIFY_IS_NOT_NULL(slice);
+        VERIFY_ARE_EQUAL(10, slice->ColumnOffset());
+        VERIFY_ARE_EQUAL(2 * slice->CellSize().width, slice->PixelWidth());
+        const auto pixel = *slice->Pixels(11);
+        VERIFY_ARE_EQUAL(255, pixel.rgbRed);
+        VERIFY_ARE_EQUAL(0, pixel.rgbGreen);
+        VERIFY_ARE_EQUAL(0, pixel.rgbBlue);
+        VERIFY_ARE_EQUAL(255, pixel.rgbReserved);
+        VERIFY_IS_NULL(textBuffer.GetRowByOffset(3).GetImageSlice());
+        VERIFY_ARE_EQUAL(til::point(12, 2), cursor.GetPosition());
+    }
+
     TEST_METHOD(SetConsoleTitleTest)
     {
         Log::Comment(L"Starting test...");
@@ -3786,6 +3828,7 @@ public:
 
         const auto setMacroText = [&](const auto id, const auto value) {
             _pDispatch->_macroBuffer->_macros.at(id) = value;
+            _pDispatch->_macroBuffer->_recordings.at(id).Reset();
         };
 
         setMacroText(0, L"Macro 0");
@@ -3831,6 +3874,18 @@ public:
         _stateMachine->ProcessString(L"\033[1*z");
         VERIFY_ARE_EQUAL(L"[]Macro 1", getBufferOutput());
 
+        Log::Comment(L"Repeated invokes replay the recorded actions");
+        setMacroText(3, L"A\033[2CB");
+        _testGetSet->PrepData();
+        _stateMachine->ProcessString(L"\033[3*z\033[3*z\033[3*z");
+        VERIFY_ARE_EQUAL(L"A  BA  BA  B", getBufferOutput());
+
+        Log::Comment(L"Redefining a macro discards its recording");
+        _testGetSet->PrepData();
+        _stateMachine->ProcessString(L"\033P3;0;0!zNew\033\\");
+        _stateMachine->ProcessString(L"\033[3*z");
+        VERIFY_ARE_EQUAL(L"New", getBufferOutput());
+
         Log::Comment(L"Maximum recursive depth is 16");
         setMacroText(0, L"<\033[1*z>");
         setMacroText(1, L"[\033[0*z]");
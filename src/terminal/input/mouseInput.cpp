@@ -500,12 +500,6 @@ bool TerminalInput::ShouldSendAlternateScroll(const unsigned int button, const s
 // - delta: The scroll wheel delta of the input event
 TerminalInput::OutputType TerminalInput::_makeAlternateScrollOutput(const short delta) const
 {
-    if (delta > 0)
-    {
-        return MakeOutput(_keyMap.at(VK_UP));
-    }
-    else
-    {
-        return MakeOutput(_keyMap.at(VK_DOWN));
-    }
+    const auto sequence = _lookupKey(delta > 0 ? VK_UP : VK_DOWN);
+    return sequence ? MakeOutput(*sequence) : MakeUnhandled();
 }
@@ -224,10 +224,9 @@ TerminalInput::OutputType TerminalInput::HandleKey(const INPUT_RECORD& event)
     WI_SetFlagIf(keyCombo, Alt, altIsPressed);
     WI_SetFlagIf(keyCombo, Shift, shiftIsPressed);
     WI_SetFlagIf(keyCombo, Enhanced, enhancedReturnKey);
-    const auto keyMatch = _keyMap.find(keyCombo);
-    if (keyMatch != _keyMap.end())
+    if (const auto keyMatch = _lookupKey(keyCombo))
     {
-        return keyMatch->second;
+        return *keyMatch;
     }
 
     // If it's not in the key map, we'll use the UnicodeChar, if provided,
@@ -329,29 +328,30 @@ try
 {
     auto defineKeyWithUnusedModifiers = [this](const int keyCode, const std::wstring& sequence) {
         for (auto m = 0; m < 8; m++)
-            _keyMap[VTModifier(m) + keyCode] = sequence;
+            _defineKey(VTModifier(m) + keyCode, sequence);
     };
     auto defineKeyWithAltModifier = [this](const int keyCode, const std::wstring& sequence) {
-        _keyMap[keyCode] = sequence;
-        _keyMap[Alt + keyCode] = L"\x1B" + sequence;
+        _defineKey(keyCode, sequence);
+        _defineKey(Alt + keyCode, L"\x1B" + sequence);
     };
     auto defineKeypadKey = [this](const int keyCode, const wchar_t* prefix, const wchar_t finalChar) {
-        _keyMap[keyCode] = fmt::format(FMT_COMPILE(L"{}{}"), prefix, finalChar);
+        _defineKey(keyCode, fmt::format(FMT_COMPILE(L"{}{}"), prefix, finalChar));
         for (auto m = 1; m < 8; m++)
-            _keyMap[VTModifier(m) + keyCode] = fmt::format(FMT_COMPILE(L"{}1;{}{}"), _csi, m + 1, finalChar);
+            _defineKey(VTModifier(m) + keyCode, fmt::format(FMT_COMPILE(L"{}1;{}{}"), _csi, m + 1, finalChar));
     };
     auto defineEditingKey = [this](const int keyCode, const int parm) {
-        _keyMap[keyCode] = fmt::format(FMT_COMPILE(L"{}{}~"), _csi, parm);
+        _defineKey(keyCode, fmt::format(FMT_COMPILE(L"{}{}~"), _csi, parm));
         for (auto m = 1; m < 8; m++)
-            _keyMap[VTModifier(m) + keyCode] = fmt::format(FMT_COMPILE(L"{}{};{}~"), _csi, parm, m + 1);
+            _defineKey(VTModifier(m) + keyCode, fmt::format(FMT_COMPILE(L"{}{};{}~"), _csi, parm, m + 1));
     };
     auto defineNumericKey = [this](const int keyCode, const wchar_t finalChar) {
-        _keyMap[keyCode] = fmt::format(FMT_COMPILE(L"{}{}"), _ss3, finalChar);
+        _defineKey(keyCode, fmt::format(FMT_COMPILE(L"{}{}"), _ss3, finalChar));
         for (auto m = 1; m < 8; m++)
-            _keyMap[VTModifier(m) + keyCode] = fmt::format(FMT_COMPILE(L"{}{}{}"), _ss3, m + 1, finalChar);
+            _defineKey(VTModifier(m) + keyCode, fmt::format(FMT_COMPILE(L"{}{}{}"), _ss3, m + 1, finalChar));
     };
 
-    _keyMap.clear();
+    _keyMap.fill(0);
+    _keySequences.clear();
 
     // The CSI and SS3 introducers are C1 control codes, which can either be
     // sent as a single codepoint, or as a two character escape sequence.
@@ -532,6 +532,43 @@ try
 }
 CATCH_LOG()
 
+// Routine Description:
+// - Assigns the given sequence to a key combination in the key map,
+//   replacing any sequence that was previously assigned to it.
+// Arguments:
+// - keyCombo - the virtual key code combined with the VTModifier bits
+// - sequence - the VT sequence that the key combination should generate
+void TerminalInput::_defineKey(const int keyCombo, std::wstring sequence)
+{
+    auto& slot = til::at(_keyMap, gsl::narrow<size_t>(keyCombo));
+    if (slot)
+    {
+        til::at(_keySequences, slot - 1u) = std::move(sequence);
+    }
+    else
+    {
+        _keySequences.emplace_back(std::move(sequence));
+        slot = gsl::narrow<uint16_t>(_keySequences.size());
+    }
+}
+
+// Routine Description:
+// - Looks up the sequence assigned to a key combination in the key map.
+// Arguments:
+// - keyCombo - the virtual key code combined with the VTModifier bits
+// Return Value:
+// - The assigned sequence, or nullptr if the key combination isn't mapped.
+const std::wstring* TerminalInput::_lookupKey(const int keyCombo) const noexcept
+{
+    const auto index = static_cast<size_t>(keyCombo);
+    if (index >= _keyMap.size())
+    {
+        return nullptr;
+    }
+    const auto slot = til::at(_keyMap, index);
+    return slot ? &til::at(_keySequences, slot - 1u) : nullptr;
+}
+
 DWORD TerminalInput::_trackControlKeyState(const KEY_EVENT_RECORD& key)
 {
     // First record which key state bits were previously off but are now on.
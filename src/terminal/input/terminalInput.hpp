@@ -74,7 +74,14 @@ namespace Microsoft::Console::VirtualTerminal
         DWORD _lastControlKeyState = 0;
         uint64_t _lastLeftCtrlTime = 0;
         uint64_t _lastRightAltTime = 0;
-        std::unordered_map<int, std::wstring> _keyMap;
+        // The key map is a flat table indexed by the virtual key code in the low byte and the
+        // modifier bits in the byte above (see VTModifier in terminalInput.cpp). Each slot holds
+        // an index + 1 into _keySequences, or 0 if the key combination has no predefined mapping.
+        // It's only regenerated when one of the modes that affect the sequences changes,
+        // so a key press costs a single array access instead of a hash lookup.
+        static constexpr size_t KeyMapSize = 16 * 256;
+        std::array<uint16_t, KeyMapSize> _keyMap{};
+        std::vector<std::wstring> _keySequences;
         std::wstring _focusInSequence;
         std::wstring _focusOutSequence;
 
@@ -85,6 +92,8 @@ namespace Microsoft::Console::VirtualTerminal
         const wchar_t* _ss3 = L"\x1BO";
 
         void _initKeyboardMap() noexcept;
+        void _defineKey(const int keyCombo, std::wstring sequence);
+        const std::wstring* _lookupKey(const int keyCombo) const noexcept;
         DWORD _trackControlKeyState(const KEY_EVENT_RECORD& key);
         std::array<byte, 256> _getKeyboardState(const WORD virtualKeyCode, const DWORD controlKeyState) const;
         [[nodiscard]] static wchar_t _makeCtrlChar(const wchar_t ch);
@@ -44,6 +44,10 @@ namespace Microsoft::Console::VirtualTerminal
         virtual bool ActionOscDispatch(const size_t parameter, const std::wstring_view string) = 0;
         virtual bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) = 0;
 
+        // Called in the ground state by input state machines, whenever an ESC is encountered.
+        // Returns the number of characters the engine consumed by itself, if any.
+        virtual size_t DispatchWin32InputModeRun(const std::wstring_view string) = 0;
+
     protected:
         IStateMachineEngine() = default;
     };
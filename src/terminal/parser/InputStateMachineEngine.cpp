@@ -551,6 +551,63 @@ bool InputStateMachineEngine::ActionSs3Dispatch(const wchar_t wch, const VTParam
     return true;
 }
 
+// Method Description:
+// - Decodes a run of consecutive win32-input-mode sequences and writes them to the input buffer at once.
+//   This is equivalent to dispatching them one by one via ActionCsiDispatch, but avoids the
+//   per-character state machine overhead and the per-record InputBuffer::Write() calls, which
+//   dominate pastes, because win32-input-mode encodes every key up and down as its own sequence.
+// Arguments:
+// - string - The remaining input string, starting at an ESC.
+// Return Value:
+// - The number of characters consumed. 0 if the string doesn't start with a complete win32-input-mode
+//   sequence, in which case the state machine parses it as usual.
+size_t InputStateMachineEngine::DispatchWin32InputModeRun(const std::wstring_view string)
+{
+    _win32InputRecords.clear();
+
+    const auto flush = [&]() {
+        if (!_win32InputRecords.empty())
+        {
+            _pDispatch->WriteInput(_win32InputRecords);
+            _win32InputRecords.clear();
+        }
+    };
+
+    size_t consumed = 0;
+    while (consumed < string.size())
+    {
+        INPUT_RECORD record;
+        const auto length = _ParseWin32InputModeSequence(string.substr(consumed), record);
+        if (!length)
+        {
+            break;
+        }
+
+        consumed += length;
+
+        // Key presses with Ctrl or Alt may be Ctrl+C, Ctrl+Break and similar, which WriteCtrlKey
+        // handles specially. They're rare in pastes, so we don't try to batch them.
+        const auto& key = record.Event.KeyEvent;
+        if (key.bKeyDown && WI_IsAnyFlagSet(key.dwControlKeyState, CTRL_PRESSED | ALT_PRESSED))
+        {
+            flush();
+            _pDispatch->WriteCtrlKey(record);
+        }
+        else
+        {
+            _win32InputRecords.emplace_back(record);
+        }
+    }
+
+    flush();
+
+    if (consumed)
+    {
+        _encounteredWin32InputModeSequence = true;
+    }
+    return consumed;
+}
+
 // Method Description:
 // - Triggers the OscDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
@@ -1119,3 +1176,64 @@ INPUT_RECORD InputStateMachineEngine::_GenerateWin32Key(const VTParameters& para
         ::base::saturated_cast<wchar_t>(parameters.at(2).value_or(0)),
         ::base::saturated_cast<uint32_t>(parameters.at(4).value_or(0)));
 }
+
+// Method Description:
+// - Parses a single, complete win32-input-mode sequence the same way the state machine would.
+//   Anything unusual (sub-parameters, too many parameters, intermediates, etc.) is rejected,
+//   so that the state machine can deal with it instead.
+// Arguments:
+// - string - The string that is expected to start with the sequence.
+// - record - Receives the deserialized KeyEvent.
+// Return Value:
+// - The length of the sequence or 0 if the string doesn't start with one.
+size_t InputStateMachineEngine::_ParseWin32InputModeSequence(const std::wstring_view string, INPUT_RECORD& record) noexcept
+{
+    // See _GenerateWin32Key() for the meaning of the parameters.
+    std::array<VTInt, 6> parameters{ -1, -1, -1, -1, -1, -1 };
+    size_t parameterCount = 0;
+
+    if (string.size() < 3 || til::at(string, 0) != L'\x1b' || til::at(string, 1) != L'[')
+    {
+        return 0;
+    }
+
+    for (size_t i = 2; i < string.size(); ++i)
+    {
+        const auto wch = til::at(string, i);
+        if (wch >= L'0' && wch <= L'9')
+        {
+            auto& value = til::at(parameters, parameterCount);
+            value = std::min(std::max(value, 0) * 10 + (wch - L'0'), MAX_PARAMETER_VALUE);
+        }
+        else if (wch == L';')
+        {
+            if (++parameterCount >= parameters.size())
+            {
+                return 0;
+            }
+        }
+        else if (wch == L'_')
+        {
+            const auto param = [&](size_t index, VTInt defaultValue) noexcept {
+                const auto value = til::at(parameters, index);
+                return value < 0 ? defaultValue : value;
+            };
+
+            record = SynthesizeKeyEvent(
+                param(3, 0),
+                gsl::narrow_cast<uint16_t>(param(5, 1)),
+                gsl::narrow_cast<uint16_t>(param(0, 0)),
+                gsl::narrow_cast<uint16_t>(param(1, 0)),
+                gsl::narrow_cast<wchar_t>(param(2, 0)),
+                gsl::narrow_cast<uint32_t>(param(4, 0)));
+            return i + 1;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    // The sequence is incomplete.
+    return 0;
+}
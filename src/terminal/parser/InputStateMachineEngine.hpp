@@ -182,6 +182,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool ActionSs3Dispatch(const wchar_t wch, const VTParameters parameters) override;
 
+        size_t DispatchWin32InputModeRun(const std::wstring_view string) override;
+
     private:
         const std::unique_ptr<IInteractDispatch> _pDispatch;
         std::atomic<uint64_t> _deviceAttributes{ 0 };
@@ -193,6 +195,7 @@ namespace Microsoft::Console::VirtualTerminal
         std::optional<til::point> _lastMouseClickPos{};
         std::optional<std::chrono::steady_clock::time_point> _lastMouseClickTime{};
         std::optional<size_t> _lastMouseClickButton{};
+        std::vector<INPUT_RECORD> _win32InputRecords;
 
         DWORD _GetCursorKeysModifierState(const VTParameters parameters, const VTID id) noexcept;
         DWORD _GetGenericKeysModifierState(const VTParameters parameters) noexcept;
@@ -229,6 +232,7 @@ namespace Microsoft::Console::VirtualTerminal
                                         unsigned int& function) const noexcept;
 
         static INPUT_RECORD _GenerateWin32Key(const VTParameters& parameters);
+        static size_t _ParseWin32InputModeSequence(const std::wstring_view string, INPUT_RECORD& record) noexcept;
 
         bool _DoControlCharacter(const wchar_t wch, const bool writeAlt);
 
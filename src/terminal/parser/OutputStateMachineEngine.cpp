@@ -405,6 +405,16 @@ bool OutputStateMachineEngine::ActionVt52EscDispatch(const VTID id, const VTPara
 // - true iff we successfully dispatched the sequence.
 bool OutputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameters parameters)
 {
+    // SGR is by far the most frequent CSI sequence in colored output, so it gets
+    // dispatched before anything else. It accepts subparameters unconditionally,
+    // which means that the check below wouldn't bail out for it anyway.
+    if (id == CsiActionCodes::SGR_SetGraphicsRendition) [[likely]]
+    {
+        _dispatch->SetGraphicsRendition(parameters);
+        _ClearLastChar();
+        return true;
+    }
+
     // Bail out if we receive subparameters, but we don't accept them in the sequence.
     if (parameters.hasSubParams() && !_CanSeqAcceptSubParam(id, parameters)) [[unlikely]]
     {
@@ -883,6 +893,17 @@ bool OutputStateMachineEngine::ActionSs3Dispatch(const wchar_t /*wch*/, const VT
     return true;
 }
 
+// Routine Description:
+// - The output engine doesn't handle win32-input-mode sequences.
+// Arguments:
+// - string - The remaining string, starting at an ESC.
+// Return Value:
+// - Always 0.
+size_t OutputStateMachineEngine::DispatchWin32InputModeRun(const std::wstring_view /*string*/) noexcept
+{
+    return 0;
+}
+
 // Routine Description:
 // - OSC 4 ; c ; spec ST
 //      c: the index of the ansi color table
@@ -36,6 +36,14 @@ static constexpr uint8_t decodeTable[128] = {
 HRESULT Base64::Decode(const std::wstring_view& src, std::wstring& dst) noexcept
 {
     std::string result;
+    RETURN_IF_FAILED(Decode(src, result));
+    return til::u8u16(result, dst);
+}
+
+// Same as above, but returns the decoded bytes as they are.
+// This is used for binary payloads, like the images of OSC 1337;File.
+HRESULT Base64::Decode(const std::wstring_view& src, std::string& result) noexcept
+{
     result.resize(((src.size() + 3) / 4) * 3);
 
     // in and inEnd may be nullptr if src.empty().
@@ -85,6 +93,68 @@ HRESULT Base64::Decode(const std::wstring_view& src, std::wstring& dst) noexcept
         r = r << 6 | n;
     };
 
+#if defined(TIL_SSE_INTRINSICS)
+    // This loop decodes 16 characters into 12 bytes at a time, which is what makes multi-megabyte OSC 52
+    // payloads bearable. It only needs SSE2, because the characters are classified with range comparisons,
+    // which also makes it simple to support both alphabets. It stops at the first chunk that contains anything
+    // else (a trailing "=" or an invalid character) and leaves the rest to the scalar loops below.
+    {
+        static constexpr auto inRange = [](const __m128i v, const char lo, const char hi) noexcept {
+            return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+        };
+        static constexpr auto isEither = [](const __m128i v, const char a, const char b) noexcept {
+            return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(a)), _mm_cmpeq_epi8(v, _mm_set1_epi8(b)));
+        };
+
+        // If src.empty() then `in == inEnd == nullptr` and this is skipped.
+        while (inEnd - in >= 16)
+        {
+            // _mm_packus_epi16 saturates characters outside of [0, 0xff] to 0 or 0xff,
+            // both of which are invalid, just like the characters they came from.
+            const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8));
+            const auto ch = _mm_packus_epi16(lo, hi);
+
+            // The comparisons are signed, so [0x80, 0xff] matches none of the ranges either.
+            const auto upper = inRange(ch, 'A', 'Z');
+            const auto lower = inRange(ch, 'a', 'z');
+            const auto digit = inRange(ch, '0', '9');
+            const auto n62 = isEither(ch, '+', '-');
+            const auto n63 = isEither(ch, '/', '_');
+            const auto alnum = _mm_or_si128(_mm_or_si128(upper, lower), digit);
+            const auto valid = _mm_or_si128(alnum, _mm_or_si128(n62, n63));
+            if (_mm_movemask_epi8(valid) != 0xffff)
+            {
+                break;
+            }
+
+            // Letters and digits map to their values with a constant offset per range,
+            // while the two remaining values are simply filled in where they occur.
+            auto offset = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+            offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+            offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+            auto n = _mm_and_si128(alnum, _mm_add_epi8(ch, offset));
+            n = _mm_or_si128(n, _mm_and_si128(n62, _mm_set1_epi8(62)));
+            n = _mm_or_si128(n, _mm_and_si128(n63, _mm_set1_epi8(63)));
+
+            // Join each pair of 6-bit values into 12 bits and each pair of those into 24 bits.
+            const auto n12 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0xff)), 6), _mm_srli_epi16(n, 8));
+            const auto n24 = _mm_madd_epi16(n12, _mm_set1_epi32(0x00011000));
+
+            alignas(16) uint32_t words[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(&words[0]), n24);
+            for (const auto w : words)
+            {
+                *out++ = gsl::narrow_cast<char>(w >> 16);
+                *out++ = gsl::narrow_cast<char>(w >> 8);
+                *out++ = gsl::narrow_cast<char>(w >> 0);
+            }
+
+            in += 16;
+        }
+    }
+#endif
+
     // If src.empty() then `in == inEndBatched == nullptr` and this is skipped.
     while (in < inEndBatched)
     {
@@ -154,5 +224,5 @@ HRESULT Base64::Decode(const std::wstring_view& src, std::wstring& dst) noexcept
     }
 
     result.resize(out - outBeg);
-    return til::u8u16(result, dst);
+    return S_OK;
 }
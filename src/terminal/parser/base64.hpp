@@ -17,5 +17,6 @@ namespace Microsoft::Console::VirtualTerminal
     {
     public:
         static HRESULT Decode(const std::wstring_view& src, std::wstring& dst) noexcept;
+        static HRESULT Decode(const std::wstring_view& src, std::string& dst) noexcept;
     };
 }
@@ -383,6 +383,10 @@ static constexpr bool _isApcIndicator(const wchar_t wch) noexcept
 void StateMachine::_ActionExecute(const wchar_t wch)
 {
     _trace.TraceOnExecute(wch);
+    if (_recording)
+    {
+        _recording->_append(ActionRecording::Action::Execute, wch);
+    }
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionExecute(wch);
     }));
@@ -399,6 +403,10 @@ void StateMachine::_ActionExecute(const wchar_t wch)
 void StateMachine::_ActionExecuteFromEscape(const wchar_t wch)
 {
     _trace.TraceOnExecuteFromEscape(wch);
+    if (_recording)
+    {
+        _recording->_append(ActionRecording::Action::ExecuteFromEscape, wch);
+    }
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionExecuteFromEscape(wch);
     }));
@@ -413,6 +421,10 @@ void StateMachine::_ActionExecuteFromEscape(const wchar_t wch)
 void StateMachine::_ActionPrint(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Print");
+    if (_recording)
+    {
+        _recording->_append(ActionRecording::Action::Print, wch);
+    }
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionPrint(wch);
     }));
@@ -426,6 +438,10 @@ void StateMachine::_ActionPrint(const wchar_t wch)
 // - <none>
 void StateMachine::_ActionPrintString(const std::wstring_view string)
 {
+    if (_recording)
+    {
+        _recording->_appendString(_recording->_append(ActionRecording::Action::PrintString), string);
+    }
     _SafeExecute([=]() {
         return _engine->ActionPrintString(string);
     });
@@ -442,8 +458,13 @@ void StateMachine::_ActionPrintString(const std::wstring_view string)
 void StateMachine::_ActionEscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"EscDispatch");
+    const auto id = _identifier.Finalize(wch);
+    if (_recording)
+    {
+        _recording->_append(ActionRecording::Action::EscDispatch, 0, id);
+    }
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
-        return _engine->ActionEscDispatch(_identifier.Finalize(wch));
+        return _engine->ActionEscDispatch(id);
     }));
 }
 
@@ -457,8 +478,13 @@ void StateMachine::_ActionEscDispatch(const wchar_t wch)
 void StateMachine::_ActionVt52EscDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"Vt52EscDispatch");
+    const auto id = _identifier.Finalize(wch);
+    if (_recording)
+    {
+        _recording->_appendParameters(_recording->_append(ActionRecording::Action::Vt52EscDispatch, 0, id), _parameters);
+    }
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
-        return _engine->ActionVt52EscDispatch(_identifier.Finalize(wch), { _parameters.data(), _parameters.size() });
+        return _engine->ActionVt52EscDispatch(id, { _parameters.data(), _parameters.size() });
     }));
 }
 
@@ -472,9 +498,15 @@ void StateMachine::_ActionVt52EscDispatch(const wchar_t wch)
 void StateMachine::_ActionCsiDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"CsiDispatch");
+    const auto id = _identifier.Finalize(wch);
+    if (_recording)
+    {
+        auto& entry = _recording->_append(ActionRecording::Action::CsiDispatch, 0, id);
+        _recording->_appendParameters(entry, _parameters);
+        _recording->_appendSubParameters(entry, _subParameters, _subParameterRanges);
+    }
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
-        return _engine->ActionCsiDispatch(_identifier.Finalize(wch),
-                                          { _parameters, _subParameters, _subParameterRanges });
+        return _engine->ActionCsiDispatch(id, { _parameters, _subParameters, _subParameterRanges });
     }));
 }
 
@@ -686,6 +718,60 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
     _oscString.push_back(wch);
 }
 
+// Routine Description:
+// - Passes on a run of plain characters in an OSC or DCS string in bulk, instead of
+//   sending them through ProcessCharacter() one at a time. Large payloads like OSC 52
+//   clipboard writes or sixel images consist of little else.
+// Arguments:
+// - string - The remaining input, starting with the next character to process.
+// Return Value:
+// - The number of characters consumed. This is 0 if we're not in one of these
+//   string states, or if the next character needs to go through the state machine.
+size_t StateMachine::_ActionStringPutRun(const std::wstring_view string)
+{
+    if (_state != VTStates::OscString && _state != VTStates::DcsPassThrough)
+    {
+        return 0;
+    }
+
+    // C0 and C1 controls and DEL may terminate or otherwise affect the string,
+    // so only what comes before them (= the string payload) is handled here.
+    const auto beg = string.data();
+    const auto end = Microsoft::Console::Utils::FindActionableControlCharacter(beg, string.size());
+    const auto len = gsl::narrow_cast<size_t>(end - beg);
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    if (_state == VTStates::OscString)
+    {
+        _trace.TraceOnAction(L"OscPut");
+        _oscString.append(beg, len);
+    }
+    else
+    {
+        _trace.TraceOnEvent(L"DcsPassThrough");
+        for (size_t i = 0; i < len; ++i)
+        {
+            const auto wch = til::at(string, i);
+            // Characters outside of the ASCII range are ignored in DCS strings.
+            if (_isDcsPassThroughValid(wch))
+            {
+                _processingLastCharacter = i + 1 >= string.size();
+                if (!_dcsStringHandler(wch))
+                {
+                    // The rest of the run would be ignored in this state anyway.
+                    _EnterDcsIgnore();
+                    break;
+                }
+            }
+        }
+    }
+
+    return len;
+}
+
 // Routine Description:
 // - Triggers the OscDispatch action to indicate that the listener should handle a control sequence.
 //   These sequences perform various API-type commands that can include many parameters.
@@ -696,6 +782,10 @@ void StateMachine::_ActionOscPut(const wchar_t wch)
 void StateMachine::_ActionOscDispatch()
 {
     _trace.TraceOnAction(L"OscDispatch");
+    if (_recording)
+    {
+        _recording->_appendString(_recording->_append(ActionRecording::Action::OscDispatch, _oscParameter), _oscString);
+    }
     _trace.DispatchSequenceTrace(_SafeExecute([=]() {
         return _engine->ActionOscDispatch(_oscParameter, _oscString);
     }));
@@ -727,6 +817,12 @@ void StateMachine::_ActionDcsDispatch(const wchar_t wch)
 {
     _trace.TraceOnAction(L"DcsDispatch");
 
+    // The data string is passed straight to the handler and not recorded.
+    if (_recording && _recording->_state == ActionRecording::State::Recording)
+    {
+        _recording->_state = ActionRecording::State::Unusable;
+    }
+
     const auto success = _SafeExecute([=]() {
         _dcsStringHandler = _engine->ActionDcsDispatch(_identifier.Finalize(wch), { _parameters.data(), _parameters.size() });
         return true;
@@ -2016,8 +2112,28 @@ void StateMachine::ProcessString(const std::wstring_view string)
             break;
         }
 
+        // Pastes with win32-input-mode are made of nothing but CSI _ sequences, one per key event.
+        // The input engine can decode runs of them with less overhead than parsing them one character at a time.
+        if (_isEngineForInput && _state == VTStates::Ground && til::at(string, i) == AsciiChars::ESC)
+        {
+            if (const auto consumed = _engine->DispatchWin32InputModeRun(string.substr(i)))
+            {
+                i += consumed;
+                _runOffset = i;
+                _runSize = 0;
+                continue;
+            }
+        }
+
         do
         {
+            if (const auto consumed = _ActionStringPutRun(string.substr(i)))
+            {
+                _runSize += consumed;
+                i += consumed;
+                continue;
+            }
+
             _runSize++;
             _processingLastCharacter = i + 1 >= string.size();
             // If we're processing characters individually, send it to the state machine.
@@ -2108,6 +2224,13 @@ bool StateMachine::IsProcessingLastCharacter() const noexcept
     return _processingLastCharacter;
 }
 
+// Routine Description:
+// - Returns true if we're not in the middle of an escape sequence or control string.
+bool StateMachine::IsInGroundState() const noexcept
+{
+    return _state == VTStates::Ground;
+}
+
 void StateMachine::InjectSequence(const InjectionType type)
 {
     _injections.emplace_back(type, _runOffset + _runSize);
@@ -2130,6 +2253,173 @@ void StateMachine::OnCsiComplete(const std::function<void()> callback)
     _onCsiCompleteCallback = callback;
 }
 
+// Routine Description:
+// - Processes the given string like ProcessString(), while recording the resulting
+//   engine actions, so that they can be dispatched again with ReplayActions().
+// - The string must start in the ground state and end in it as well, otherwise the
+//   actions depend on what came before or after it and the recording is unusable.
+//   It's also not possible to record DCS sequences, since they're passed through.
+// - If the recording isn't empty, the string is only processed.
+// Arguments:
+// - string - Characters to operate upon
+// - recording - The recording to fill
+// Return Value:
+// - <none>
+void StateMachine::RecordString(const std::wstring_view string, ActionRecording& recording)
+{
+    if (recording._state != ActionRecording::State::Empty || recording._replayDepth != 0 || _state != VTStates::Ground)
+    {
+        ProcessString(string);
+        return;
+    }
+
+    recording._state = ActionRecording::State::Recording;
+    recording._parserMode = _parserMode;
+    recording._entries.clear();
+    recording._strings.clear();
+    recording._parameters.clear();
+    recording._subParameterRanges.clear();
+
+    {
+        const auto savedRecording = std::exchange(_recording, &recording);
+        const auto restoreRecording = wil::scope_exit([&]() noexcept {
+            _recording = savedRecording;
+        });
+        ProcessString(string);
+    }
+
+    // The recording may have been Reset() in the meantime, for instance by an RIS.
+    if (recording._state == ActionRecording::State::Recording)
+    {
+        recording._state = _state == VTStates::Ground ? ActionRecording::State::Ready : ActionRecording::State::Unusable;
+    }
+}
+
+// Routine Description:
+// - Dispatches the engine actions of a recording made by RecordString(),
+//   as if the recorded string had been passed to ProcessString() again.
+// Arguments:
+// - recording - The recording to replay
+// Return Value:
+// - False if the recording can't be used in the current state of the
+//   parser, in which case the string needs to be processed instead.
+bool StateMachine::ReplayActions(ActionRecording& recording)
+{
+    if (recording._state != ActionRecording::State::Ready || recording._parserMode.bits() != _parserMode.bits() || _state != VTStates::Ground)
+    {
+        return false;
+    }
+
+    recording._replayDepth++;
+    const auto decrementReplayDepth = wil::scope_exit([&]() noexcept {
+        recording._replayDepth--;
+    });
+
+    // The state is checked on every iteration, because an action may Reset() the recording (e.g. RIS).
+    // That doesn't release its contents, which is why the references below remain valid regardless.
+    for (size_t i = 0; i < recording._entries.size() && recording._state == ActionRecording::State::Ready; ++i)
+    {
+        const auto& entry = til::at(recording._entries, i);
+        const auto ch = gsl::narrow_cast<wchar_t>(entry.value);
+        const auto string = std::wstring_view{ recording._strings }.substr(entry.stringOffset, entry.stringCount);
+
+        switch (entry.action)
+        {
+        case ActionRecording::Action::Execute:
+            _SafeExecute([&]() {
+                return _engine->ActionExecute(ch);
+            });
+            break;
+        case ActionRecording::Action::ExecuteFromEscape:
+            _SafeExecute([&]() {
+                return _engine->ActionExecuteFromEscape(ch);
+            });
+            break;
+        case ActionRecording::Action::Print:
+            _SafeExecute([&]() {
+                return _engine->ActionPrint(ch);
+            });
+            break;
+        case ActionRecording::Action::PrintString:
+            _SafeExecute([&]() {
+                return _engine->ActionPrintString(string);
+            });
+            break;
+        case ActionRecording::Action::EscDispatch:
+            _SafeExecute([&]() {
+                return _engine->ActionEscDispatch(entry.id);
+            });
+            break;
+        case ActionRecording::Action::Vt52EscDispatch:
+            _SafeExecute([&]() {
+                return _engine->ActionVt52EscDispatch(entry.id, recording._parametersOf(entry));
+            });
+            break;
+        case ActionRecording::Action::CsiDispatch:
+            _SafeExecute([&]() {
+                return _engine->ActionCsiDispatch(entry.id, recording._parametersOf(entry));
+            });
+            _ExecuteCsiCompleteCallback();
+            break;
+        case ActionRecording::Action::OscDispatch:
+            _SafeExecute([&]() {
+                return _engine->ActionOscDispatch(entry.value, string);
+            });
+            break;
+        default:
+            break;
+        }
+    }
+
+    return true;
+}
+
+void StateMachine::ActionRecording::Reset() noexcept
+{
+    // This may be called while the recording is being replayed,
+    // so we can't release its contents. See ReplayActions().
+    _state = State::Empty;
+}
+
+StateMachine::ActionRecording::Entry& StateMachine::ActionRecording::_append(const Action action, const VTInt value, const VTID id)
+{
+    return _entries.emplace_back(Entry{ .action = action, .value = value, .id = id });
+}
+
+void StateMachine::ActionRecording::_appendString(Entry& entry, const std::wstring_view string)
+{
+    entry.stringOffset = gsl::narrow_cast<uint32_t>(_strings.size());
+    entry.stringCount = gsl::narrow_cast<uint32_t>(string.size());
+    _strings.append(string);
+}
+
+void StateMachine::ActionRecording::_appendParameters(Entry& entry, const std::span<const VTParameter> parameters)
+{
+    entry.parameterOffset = gsl::narrow_cast<uint32_t>(_parameters.size());
+    entry.parameterCount = gsl::narrow_cast<uint32_t>(parameters.size());
+    _parameters.insert(_parameters.end(), parameters.begin(), parameters.end());
+}
+
+void StateMachine::ActionRecording::_appendSubParameters(Entry& entry, const std::span<const VTParameter> subParameters, const std::span<const std::pair<BYTE, BYTE>> ranges)
+{
+    entry.subParameterOffset = gsl::narrow_cast<uint32_t>(_parameters.size());
+    entry.subParameterCount = gsl::narrow_cast<uint32_t>(subParameters.size());
+    _parameters.insert(_parameters.end(), subParameters.begin(), subParameters.end());
+    entry.subParameterRangeOffset = gsl::narrow_cast<uint32_t>(_subParameterRanges.size());
+    entry.subParameterRangeCount = gsl::narrow_cast<uint32_t>(ranges.size());
+    _subParameterRanges.insert(_subParameterRanges.end(), ranges.begin(), ranges.end());
+}
+
+VTParameters StateMachine::ActionRecording::_parametersOf(const Entry& entry) const noexcept
+{
+    const auto parameters = std::span{ _parameters };
+    return {
+        parameters.subspan(entry.parameterOffset, entry.parameterCount),
+        parameters.subspan(entry.subParameterOffset, entry.subParameterCount),
+        std::span{ _subParameterRanges }.subspan(entry.subParameterRangeOffset, entry.subParameterRangeCount),
+    };
+}
+
 // Routine Description:
 // - Wherever the state machine is, whatever it's going, go back to ground.
 //     This is used by conhost to "jiggle the handle" - when VT support is
@@ -2196,7 +2486,10 @@ void StateMachine::_ExecuteCsiCompleteCallback()
         // We also need to take ownership of the callback function before
         // executing it so there's no risk of it being run more than once.
         const auto callback = std::move(_onCsiCompleteCallback);
+        // The callback may process a string of its own (DECINVM), which isn't part of the current recording.
+        const auto savedRecording = std::exchange(_recording, nullptr);
         callback();
+        _recording = savedRecording;
         // Once the callback has returned, we can restore the original state
         // and continue where we left off.
         _currentString = savedCurrentString;
@@ -76,17 +76,84 @@ namespace Microsoft::Console::VirtualTerminal
             Ansi,
         };
 
+        // The engine actions that ProcessString() produced for a string, so that they can be dispatched
+        // again with ReplayActions() without parsing the string a second time. This is used by DECINVM,
+        // since applications may invoke the same macro many times over. See RecordString().
+        class ActionRecording
+        {
+        public:
+            void Reset() noexcept;
+
+        private:
+            friend class StateMachine;
+
+            enum class State : uint8_t
+            {
+                Empty,
+                Recording,
+                Ready,
+                // The string didn't end in the ground state or contained a DCS sequence.
+                Unusable,
+            };
+
+            enum class Action : uint8_t
+            {
+                Execute,
+                ExecuteFromEscape,
+                Print,
+                PrintString,
+                EscDispatch,
+                Vt52EscDispatch,
+                CsiDispatch,
+                OscDispatch,
+            };
+
+            // Strings and parameters are stored as offset/count pairs into the vectors below.
+            struct Entry
+            {
+                Action action;
+                VTInt value; // The character for Execute/Print, or the OSC parameter.
+                VTID id;
+                uint32_t stringOffset;
+                uint32_t stringCount;
+                uint32_t parameterOffset;
+                uint32_t parameterCount;
+                uint32_t subParameterOffset;
+                uint32_t subParameterCount;
+                uint32_t subParameterRangeOffset;
+                uint32_t subParameterRangeCount;
+            };
+
+            Entry& _append(Action action, VTInt value = 0, VTID id = 0);
+            void _appendString(Entry& entry, std::wstring_view string);
+            void _appendParameters(Entry& entry, std::span<const VTParameter> parameters);
+            void _appendSubParameters(Entry& entry, std::span<const VTParameter> subParameters, std::span<const std::pair<BYTE, BYTE>> ranges);
+            VTParameters _parametersOf(const Entry& entry) const noexcept;
+
+            State _state = State::Empty;
+            til::enumset<Mode> _parserMode;
+            // A recording can't be modified while it's replayed, for instance when a macro invokes itself.
+            size_t _replayDepth = 0;
+            std::vector<Entry> _entries;
+            std::wstring _strings;
+            std::vector<VTParameter> _parameters;
+            std::vector<std::pair<BYTE, BYTE>> _subParameterRanges;
+        };
+
         void SetParserMode(const Mode mode, const bool enabled) noexcept;
         bool GetParserMode(const Mode mode) const noexcept;
 
         void ProcessCharacter(const wchar_t wch);
         void ProcessString(const std::wstring_view string);
         bool IsProcessingLastCharacter() const noexcept;
+        bool IsInGroundState() const noexcept;
 
         void InjectSequence(InjectionType type);
         const til::small_vector<Injection, 8>& GetInjections() const noexcept;
 
         void OnCsiComplete(const std::function<void()> callback);
+        void RecordString(const std::wstring_view string, ActionRecording& recording);
+        bool ReplayActions(ActionRecording& recording);
         void ResetState() noexcept;
         bool FlushToTerminal();
 
@@ -106,6 +173,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _ActionCsiDispatch(const wchar_t wch);
         void _ActionOscParam(const wchar_t wch) noexcept;
         void _ActionOscPut(const wchar_t wch);
+        size_t _ActionStringPutRun(const std::wstring_view string);
         void _ActionOscDispatch();
         void _ActionSs3Dispatch(const wchar_t wch);
         void _ActionDcsDispatch(const wchar_t wch);
@@ -230,5 +298,6 @@ namespace Microsoft::Console::VirtualTerminal
         bool _processingLastCharacter;
 
         std::function<void()> _onCsiCompleteCallback;
+        ActionRecording* _recording = nullptr;
     };
 }
@@ -117,4 +117,33 @@ class Microsoft::Console::VirtualTerminal::Base64Test
         Base64::Decode(L"8J+RjfCfkY3wn4+78J+RjfCfj7zwn5GN8J+PvfCfkY3wn4++8J+RjfCfj78=", result);
         VERIFY_ARE_EQUAL(L"👍👍🏻👍🏼👍🏽👍🏾👍🏿", result);
     }
+
+    TEST_METHOD(DecodeAlphabets)
+    {
+        std::string base64;
+        std::string base64url;
+
+        // These are long enough to go through the vectorized loop and cover the last two values of each alphabet.
+        VERIFY_SUCCEEDED(Base64::Decode(L"+/+/+/+/+/+/+/+/+/+/+/+/", base64));
+        VERIFY_SUCCEEDED(Base64::Decode(L"-_-_-_-_-_-_-_-_-_-_-_-_", base64url));
+        VERIFY_ARE_EQUAL(size_t{ 18 }, base64.size());
+        VERIFY_ARE_EQUAL(base64, base64url);
+        for (size_t i = 0; i < base64.size(); i += 3)
+        {
+            VERIFY_ARE_EQUAL("\xfb\xef\xbf", base64.substr(i, 3));
+        }
+    }
+
+    TEST_METHOD(DecodeInvalid)
+    {
+        std::string result;
+
+        // Invalid characters must be detected regardless of whether they end up in the vectorized loop.
+        VERIFY_FAILED(Base64::Decode(L"QUJDREVGR0hJSktM!U5PUA==", result));
+        VERIFY_FAILED(Base64::Decode(L"QUJDREVGR0hJ\u0141KTE1OT1A=", result));
+        VERIFY_FAILED(Base64::Decode(L"QUJDREVGR0hJSktMTU5PUA\u00e9=", result));
+
+        VERIFY_SUCCEEDED(Base64::Decode(L"QUJDREVGR0hJSktMTU5PUA==", result));
+        VERIFY_ARE_EQUAL("ABCDEFGHIJKLMNOP", result);
+    }
 };
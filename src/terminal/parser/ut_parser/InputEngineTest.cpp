@@ -273,6 +273,7 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
 
     TEST_METHOD(TestWin32InputParsing);
     TEST_METHOD(TestWin32InputOptionals);
+    TEST_METHOD(TestWin32InputRun);
 
     friend class TestInteractDispatch;
 };
@@ -1561,3 +1562,39 @@ void InputEngineTest::TestWin32InputOptionals()
         }
     }
 }
+
+void InputEngineTest::TestWin32InputRun()
+{
+    std::vector<INPUT_RECORD> records;
+    size_t writes = 0;
+    auto pfn = [&](const std::span<const INPUT_RECORD>& inEvents) {
+        records.insert(records.end(), inEvents.begin(), inEvents.end());
+        ++writes;
+    };
+    auto dispatch = std::make_unique<TestInteractDispatch>(pfn, &testState);
+    auto inputEngine = std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+    StateMachine stateMachine{ std::move(inputEngine) };
+
+    Log::Comment(L"A run of complete win32-input-mode sequences is written at once");
+    stateMachine.ProcessString(L"\x1b[65;30;97;1;0;1_\x1b[65;30;97;0;0;1_\x1b[66;48;98;1;16;2_");
+    VERIFY_ARE_EQUAL(1u, writes);
+    VERIFY_ARE_EQUAL(3u, records.size());
+    VERIFY_IS_TRUE(stateMachine.Engine().EncounteredWin32InputModeSequence());
+
+    const auto& key = til::at(records, 2).Event.KeyEvent;
+    VERIFY_ARE_EQUAL(66, key.wVirtualKeyCode);
+    VERIFY_ARE_EQUAL(48, key.wVirtualScanCode);
+    VERIFY_ARE_EQUAL(L'b', key.uChar.UnicodeChar);
+    VERIFY_ARE_EQUAL(TRUE, key.bKeyDown);
+    VERIFY_ARE_EQUAL(static_cast<DWORD>(SHIFT_PRESSED), key.dwControlKeyState);
+    VERIFY_ARE_EQUAL(2, key.wRepeatCount);
+
+    Log::Comment(L"A sequence that's split across writes is still parsed correctly");
+    records.clear();
+    stateMachine.ProcessString(L"\x1b[67;46;99;1;0;1_\x1b[67;46");
+    VERIFY_ARE_EQUAL(1u, records.size());
+    stateMachine.ProcessString(L";99;0;0;1_");
+    VERIFY_ARE_EQUAL(2u, records.size());
+    VERIFY_ARE_EQUAL(L'c', til::at(records, 1).Event.KeyEvent.uChar.UnicodeChar);
+    VERIFY_ARE_EQUAL(FALSE, til::at(records, 1).Event.KeyEvent.bKeyDown);
+}
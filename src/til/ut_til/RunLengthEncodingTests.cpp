@@ -429,6 +429,200 @@ class RunLengthEncodingTests
         }
     }
 
+    TEST_METHOD(ReplaceRanges)
+    {
+        using range = std::pair<size_type, size_type>;
+
+        struct TestCase
+        {
+            std::string_view source;
+            std::vector<range> ranges;
+            std::string_view expected;
+        };
+
+        const std::array<TestCase, 7> test_cases{
+            {
+                // no ranges
+                { "1 1 1|2 2 2", {}, "1 1 1|2 2 2" },
+                // empty ranges
+                { "1 1 1|2 2 2", { { 1, 1 }, { 4, 4 } }, "1 1 1|2 2 2" },
+                // single range, equivalent to replace()
+                { "1 1 1|2 2 2", { { 2, 4 } }, "1 1|9 9|2 2" },
+                // multiple ranges within the same run
+                { "1 1 1 1 1 1", { { 1, 2 }, { 3, 5 } }, "1|9|1|9 9|1" },
+                // adjacent ranges are joined together
+                { "1 1|2 2|3 3", { { 0, 2 }, { 2, 4 } }, "9 9 9 9|3 3" },
+                // ranges that join with existing runs
+                { "1|9|2 2|9|3", { { 0, 1 }, { 2, 4 } }, "9 9 9 9 9|3" },
+                // end indices are clamped
+                { "1 1|2 2", { { 1, 2 }, { 3, 10 } }, "1|9|2|9" },
+            }
+        };
+
+        auto idx = 0;
+
+        for (const auto& test_case : test_cases)
+        {
+            rle_vector rle{ rle_encode(test_case.source) };
+            rle.replace(test_case.ranges, 9);
+
+            VERIFY_ARE_EQUAL(
+                test_case.expected,
+                rle,
+                NoThrowString().Format(
+                    L"test case: %d\nsource:    %hs\nexpected:  %hs\nactual:    %s",
+                    idx,
+                    test_case.source.data(),
+                    test_case.expected.data(),
+                    rle.to_string().c_str()));
+            ++idx;
+        }
+
+        // The ranges must be sorted and must not overlap. On failure the vector remains unchanged.
+        {
+            rle_vector rle{ rle_encode("1 1 1|2 2 2") };
+            const std::array<range, 2> overlapping{ { { 1, 3 }, { 2, 4 } } };
+            VERIFY_THROWS(rle.replace(overlapping, 9), std::out_of_range);
+            const std::array<range, 2> unsorted{ { { 4, 5 }, { 1, 2 } } };
+            VERIFY_THROWS(rle.replace(unsorted, 9), std::out_of_range);
+            VERIFY_ARE_EQUAL("1 1 1|2 2 2"sv, rle);
+        }
+    }
+
+    TEST_METHOD(Transform)
+    {
+        struct TestCase
+        {
+            std::string_view source;
+            size_type start_index;
+            size_type end_index;
+            std::string_view expected;
+        };
+
+        // Every test case increments the values in the range by 1, except for 9s, which turn into 1s.
+        const std::array<TestCase, 8> test_cases{
+            {
+                // empty range
+                { "1 1 1|2 2 2", 2, 2, "1 1 1|2 2 2" },
+                // entire vector
+                { "1 1 1|2 2 2", 0, 6, "2 2 2|3 3 3" },
+                // partial runs at both ends
+                { "1 1 1|2 2 2", 1, 5, "1|2 2|3 3|2" },
+                // within a single run
+                { "1 1 1 1 1 1", 2, 4, "1 1|2 2|1 1" },
+                // results are joined with each other
+                { "9|1|9|1", 0, 4, "1|2|1|2" },
+                { "1|9|3|9", 1, 3, "1 1|4|9" },
+                // results are joined with neighboring runs
+                { "2|1 1|3", 1, 3, "2 2 2|3" },
+                // end_index is clamped
+                { "1 1|2 2", 3, 10, "1 1|2|3" },
+            }
+        };
+
+        const auto func = [](const value_type& v) -> value_type {
+            return v == 9 ? 1 : v + 1;
+        };
+
+        auto idx = 0;
+
+        for (const auto& test_case : test_cases)
+        {
+            rle_vector rle{ rle_encode(test_case.source) };
+            rle.transform(test_case.start_index, test_case.end_index, func);
+
+            VERIFY_ARE_EQUAL(
+                test_case.expected,
+                rle,
+                NoThrowString().Format(
+                    L"test case: %d\nsource:    %hs\nstart_index: %u\nend_index: %u\nexpected:  %hs\nactual:    %s",
+                    idx,
+                    test_case.source.data(),
+                    test_case.start_index,
+                    test_case.end_index,
+                    test_case.expected.data(),
+                    rle.to_string().c_str()));
+            ++idx;
+        }
+
+        {
+            rle_vector rle{ rle_encode("1 1 1") };
+            VERIFY_THROWS(rle.transform(2, 1, func), std::out_of_range);
+        }
+    }
+
+    TEST_METHOD(ExpandAndCompress)
+    {
+        constexpr std::string_view data{ "133211155" };
+        const rle_vector rle{ rle_encode(data) };
+
+        basic_container expanded(data.size(), 0);
+        rle.expand(expanded);
+        VERIFY_IS_TRUE(rle_decode(rle.runs()) == expanded);
+
+        const auto compressed = rle_vector::compress(expanded);
+        VERIFY_ARE_EQUAL(data, compressed);
+        VERIFY_IS_TRUE(rle == compressed);
+
+        VERIFY_IS_TRUE(rle_vector::compress({}).empty());
+
+        basic_container too_small(data.size() - 1, 0);
+        VERIFY_THROWS(rle.expand(too_small), std::out_of_range);
+    }
+
+    TEST_METHOD(CompressWideValues)
+    {
+        // TextAttributeTable's runs store 32-bit ids, which compress() compares 4 at a time.
+        // This places a single differing value at every position of a long run, so that
+        // it's found both within a vectorized block and within the scalar tail.
+        using wide_rle = til::small_rle<uint32_t, uint16_t, 1>;
+        constexpr size_t length = 37;
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            std::vector<uint32_t> values(length, 0x12345678);
+            values[i] = 0x12345679;
+
+            const auto rle = wide_rle::compress(values);
+            const size_t expected_runs = i == 0 || i == length - 1 ? 2 : 3;
+            VERIFY_ARE_EQUAL(expected_runs, rle.runs().size());
+            VERIFY_ARE_EQUAL(length, size_t{ rle.size() });
+
+            std::vector<uint32_t> expanded(length);
+            rle.expand(expanded);
+            VERIFY_IS_TRUE(values == expanded);
+        }
+    }
+
+    TEST_METHOD(TransformLargeArea)
+    {
+        // A row of alternating attributes, similar to colored `ls` output,
+        // which DECCARA used to modify one cell at a time.
+        constexpr size_type width = 1000;
+        rle_vector expected(width, 0);
+        for (size_type i = 0; i < width; i += 2)
+        {
+            expected.replace(i, i + 1, 1);
+        }
+        auto actual = expected;
+
+        const auto func = [](const value_type& v) -> value_type { return v + 2; };
+
+        const auto beg = std::chrono::steady_clock::now();
+        for (size_type i = 0; i < width; ++i)
+        {
+            expected.replace(i, i + 1, func(expected.at(i)));
+        }
+        const auto mid = std::chrono::steady_clock::now();
+        actual.transform(0, width, func);
+        const auto end = std::chrono::steady_clock::now();
+
+        VERIFY_IS_TRUE(expected == actual);
+
+        const auto us = [](auto d) { return std::chrono::duration_cast<std::chrono::microseconds>(d).count(); };
+        Log::Comment(NoThrowString().Format(L"per-cell replace(): %lldus, transform(): %lldus", us(mid - beg), us(end - mid)));
+    }
+
     TEST_METHOD(ResizeTrailingExtent)
     {
         constexpr std::string_view data{ "133211155" };
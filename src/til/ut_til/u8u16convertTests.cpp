@@ -17,6 +17,7 @@ class Utf8Utf16ConvertTests
     TEST_METHOD(TestU8ToU16Partials);
     TEST_METHOD(TestU16ToU8Partials);
     TEST_METHOD(TestU8ToU16OneByOne);
+    TEST_METHOD(TestAsciiRuns);
 };
 
 void Utf8Utf16ConvertTests::TestU8ToU16()
@@ -191,3 +192,65 @@ void Utf8Utf16ConvertTests::TestU8ToU16OneByOne()
     VERIFY_SUCCEEDED(til::u8u16(u8String1_4, u16Out1, state));
     VERIFY_ARE_EQUAL(u16StringComp1, u16Out1);
 }
+
+void Utf8Utf16ConvertTests::TestAsciiRuns()
+{
+    // The ASCII fast path processes whole blocks of characters at a time and hands the parts in
+    // between to the platform functions. This tests that the seams between the two are correct
+    // and that the output is identical to converting the whole string with the platform functions.
+    std::string u8String;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        u8String.append(i % 37, gsl::narrow_cast<char>('a' + i % 26));
+        switch (i % 4)
+        {
+        case 0:
+            u8String.append("\xC3\xB6"); // LATIN SMALL LETTER O WITH DIAERESIS
+            break;
+        case 1:
+            u8String.append("\xE2\x82\xAC"); // EURO SIGN
+            break;
+        case 2:
+            u8String.append("\xF0\x9F\x93\xB7"); // U+1F4F7 CAMERA
+            break;
+        default:
+            u8String.append("\xE2\x82"); // EURO SIGN missing its last byte (invalid)
+            break;
+        }
+    }
+
+    std::wstring u16StringComp(u8String.size(), L'\0');
+    u16StringComp.resize(MultiByteToWideChar(CP_UTF8, 0, u8String.data(), gsl::narrow_cast<int>(u8String.size()), u16StringComp.data(), gsl::narrow_cast<int>(u16StringComp.size())));
+
+    std::string u8StringComp(u16StringComp.size() * 3, '\0');
+    u8StringComp.resize(WideCharToMultiByte(CP_UTF8, 0, u16StringComp.data(), gsl::narrow_cast<int>(u16StringComp.size()), u8StringComp.data(), gsl::narrow_cast<int>(u8StringComp.size()), nullptr, nullptr));
+
+    std::wstring u16Out;
+    VERIFY_SUCCEEDED(til::u8u16(u8String, u16Out));
+    VERIFY_ARE_EQUAL(u16StringComp, u16Out);
+
+    std::string u8Out;
+    VERIFY_SUCCEEDED(til::u16u8(u16StringComp, u8Out));
+    VERIFY_ARE_EQUAL(u8StringComp, u8Out);
+
+    // Splitting the input at arbitrary points must not change the result either.
+    static constexpr size_t chunkSize = 23;
+    til::u8state u8State;
+    til::u16state u16State;
+    std::wstring u16Joined;
+    std::string u8Joined;
+
+    for (size_t i = 0; i < u8String.size(); i += chunkSize)
+    {
+        VERIFY_SUCCEEDED(til::u8u16(til::safe_slice_len(std::string_view{ u8String }, i, chunkSize), u16Out, u8State));
+        u16Joined.append(u16Out);
+    }
+    for (size_t i = 0; i < u16StringComp.size(); i += chunkSize)
+    {
+        VERIFY_SUCCEEDED(til::u16u8(til::safe_slice_len(std::wstring_view{ u16StringComp }, i, chunkSize), u8Out, u16State));
+        u8Joined.append(u8Out);
+    }
+
+    VERIFY_ARE_EQUAL(u16StringComp, u16Joined);
+    VERIFY_ARE_EQUAL(u8StringComp, u8Joined);
+}
@@ -6,6 +6,7 @@
 #include "arena.h"
 #include "conhost.h"
 #include "utils.h"
+#include "vt.h"
 
 #define ENABLE_TEST_OUTPUT_WRITE 1
 #define ENABLE_TEST_OUTPUT_SCROLL 1
@@ -13,6 +14,7 @@
 #define ENABLE_TEST_OUTPUT_READ 1
 #define ENABLE_TEST_INPUT 1
 #define ENABLE_TEST_CLIPBOARD 1
+#define ENABLE_TEST_VT 1
 
 using Measurements = std::span<int32_t>;
 using MeasurementsPerBenchmark = std::span<Measurements>;
@@ -36,8 +38,11 @@ struct BenchmarkContext
     std::span<WORD> attr_4Ki;
     std::span<CHAR_INFO> char_4Ki;
     std::span<INPUT_RECORD> input_4Ki;
+    VtPayloads vt;
 
     Measurements m_measurements;
+    // If non-zero, the number of bytes processed per measurement. Used to report throughput.
+    size_t m_measurement_bytes = 0;
     size_t m_measurements_off = 0;
     int64_t m_time = 0;
     int64_t m_time_limit = 0;
@@ -61,6 +66,24 @@ struct AccumulatedResults
 static constexpr COORD s_buffer_size{ 120, 9001 };
 static constexpr COORD s_viewport_size{ 120, 30 };
 
+#if ENABLE_TEST_VT
+// These benchmarks measure the VT parser and dispatcher (StateMachine, AdaptDispatch) of the given
+// conhost versions, as opposed to the Win32 API surface. The payloads are written as UTF-8 just
+// like most VT applications would. See vt.h for a description of each of them.
+static void write_vt_payload(BenchmarkContext& ctx, std::string_view payload)
+{
+    ctx.m_measurement_bytes = payload.size();
+
+    while (ctx.wants_more())
+    {
+        ctx.mark_beg();
+        const auto res = WriteConsoleA(ctx.output, payload.data(), static_cast<DWORD>(payload.size()), nullptr, nullptr);
+        ctx.mark_end();
+        debugAssert(res == TRUE);
+    }
+}
+#endif
+
 static constexpr Benchmark s_benchmarks[] = {
 #if ENABLE_TEST_OUTPUT_WRITE
     Benchmark{
@@ -438,6 +461,32 @@ static constexpr Benchmark s_benchmarks[] = {
         },
     },
 #endif
+#if ENABLE_TEST_VT
+    Benchmark{
+        .title = "VT SGR 128Ki",
+        .exec = [](BenchmarkContext& ctx) { write_vt_payload(ctx, ctx.vt.sgr); },
+    },
+    Benchmark{
+        .title = "VT ls --color 128Ki",
+        .exec = [](BenchmarkContext& ctx) { write_vt_payload(ctx, ctx.vt.ls_color); },
+    },
+    Benchmark{
+        .title = "VT htop 128Ki",
+        .exec = [](BenchmarkContext& ctx) { write_vt_payload(ctx, ctx.vt.htop); },
+    },
+    Benchmark{
+        .title = "VT sixel 128Ki",
+        .exec = [](BenchmarkContext& ctx) { write_vt_payload(ctx, ctx.vt.sixel); },
+    },
+    Benchmark{
+        .title = "VT OSC 8 hyperlinks 128Ki",
+        .exec = [](BenchmarkContext& ctx) { write_vt_payload(ctx, ctx.vt.hyperlinks); },
+    },
+    Benchmark{
+        .title = "VT CJK and emoji 128Ki",
+        .exec = [](BenchmarkContext& ctx) { write_vt_payload(ctx, ctx.vt.cjk_emoji); },
+    },
+#endif
 };
 
 static constexpr size_t s_benchmarks_count = _countof(s_benchmarks);
@@ -685,6 +734,7 @@ static std::span<Measurements> run_benchmarks_for_path(mem::Arena& arena, const
         .attr_4Ki = mem::repeat(scratch.arena, s_payload_attr, 4 * 1024),
         .char_4Ki = mem::repeat(scratch.arena, s_payload_char, 4 * 1024),
         .input_4Ki = mem::repeat(scratch.arena, s_payload_record, 4 * 1024),
+        .vt = generate_vt_payloads(scratch.arena, 128 * 1024),
 
         .m_measurements = scratch.arena.push_uninitialized_span<int32_t>(4 * 1024 * 1024),
     };
@@ -703,6 +753,7 @@ static std::span<Measurements> run_benchmarks_for_path(mem::Arena& arena, const
         // Warmup for 0.1s max.
         WriteConsoleW(ctx.output, L"\033c", 2, nullptr, nullptr);
         ctx.m_measurements_off = 0;
+        ctx.m_measurement_bytes = 0;
         ctx.m_time_limit = query_perf_counter() + freq / 10;
         bench.exec(ctx);
 
@@ -727,6 +778,16 @@ static std::span<Measurements> run_benchmarks_for_path(mem::Arena& arena, const
         }
         results[bench_idx] = measurements;
 
+        if (ctx.m_measurement_bytes && !measurements.empty())
+        {
+            // The median is less susceptible to the high tail latency of console calls. See generate_html().
+            // Sorting is fine, because generate_html() sorts the measurements anyway.
+            std::sort(measurements.begin(), measurements.end());
+            const auto median = measurements[measurements.size() / 2] / static_cast<double>(freq);
+            const auto bytes = static_cast<double>(ctx.m_measurement_bytes);
+            print_with_parent_connection(", %.1f MB/s, %.2f ns/byte", bytes / median / 1e6, median * 1e9 / bytes);
+        }
+
         print_with_parent_connection(", done\r\n");
     }
 
@@ -0,0 +1,268 @@
+#include "pch.h"
+#include "vt.h"
+
+#include "arena.h"
+#include "utils.h"
+
+namespace
+{
+    struct StringBuilder
+    {
+        StringBuilder(mem::Arena& arena, size_t bytes) :
+            m_target{ bytes },
+            // The generators below append at most a few KiB past m_target.
+            m_buffer{ arena.push_uninitialized_span<char>(bytes + 16 * 1024) }
+        {
+        }
+
+        bool wants_more() const
+        {
+            return m_size < m_target;
+        }
+
+        void write(std::string_view str)
+        {
+            debugAssert(m_size + str.size() <= m_buffer.size());
+            mem::copy(m_buffer.data() + m_size, str.data(), str.size());
+            m_size += str.size();
+        }
+
+        void write_format(_Printf_format_string_ const char* fmt, ...)
+        {
+            char buffer[256];
+            va_list args;
+            va_start(args, fmt);
+            const auto len = _vsnprintf_s(&buffer[0], _countof(buffer), _TRUNCATE, fmt, args);
+            va_end(args);
+            debugAssert(len >= 0);
+            write({ &buffer[0], static_cast<size_t>(len) });
+        }
+
+        std::string_view view() const
+        {
+            return { m_buffer.data(), m_size };
+        }
+
+    private:
+        size_t m_target;
+        std::span<char> m_buffer;
+        size_t m_size = 0;
+    };
+
+    // The payloads must be identical across runs and conhost versions, so we use a fixed seed.
+    struct Rng
+    {
+        uint32_t next()
+        {
+            m_state = m_state * UINT32_C(747796405) + UINT32_C(2891336453);
+            return m_state >> 8;
+        }
+
+        uint32_t next(uint32_t max)
+        {
+            return next() % max;
+        }
+
+        template<typename T, size_t N>
+        const T& pick(const T (&items)[N])
+        {
+            return items[next(static_cast<uint32_t>(N))];
+        }
+
+    private:
+        uint32_t m_state = 0;
+    };
+
+    constexpr int s_columns = 120;
+    constexpr int s_rows = 30;
+}
+
+static std::string_view generate_sgr(mem::Arena& arena, size_t bytes)
+{
+    StringBuilder sb{ arena, bytes };
+    Rng rng;
+
+    while (sb.wants_more())
+    {
+        for (int x = 0; x < s_columns; ++x)
+        {
+            const auto ch = static_cast<char>('!' + rng.next(94));
+            if (rng.next(2))
+            {
+                sb.write_format("\x1b[38;5;%um\x1b[48;5;%um%c", rng.next(256), rng.next(256), ch);
+            }
+            else
+            {
+                const auto fg = rng.next();
+                const auto bg = rng.next();
+                sb.write_format("\x1b[38;2;%u;%u;%u;48;2;%u;%u;%um%c", fg & 0xff, (fg >> 8) & 0xff, fg >> 16, bg & 0xff, (bg >> 8) & 0xff, bg >> 16, ch);
+            }
+        }
+        sb.write("\x1b[m\r\n");
+    }
+
+    return sb.view();
+}
+
+static std::string_view generate_ls_color(mem::Arena& arena, size_t bytes)
+{
+    static constexpr std::string_view colors[]{ "01;34", "01;32", "01;36", "00", "40;33;01", "01;31", "01;35" };
+    static constexpr std::string_view names[]{ "src", "build.sh", "README.md", "node_modules", "libfoo.so.1", "archive.tar.gz", "logo.png", "Makefile", "tests" };
+
+    StringBuilder sb{ arena, bytes };
+    Rng rng;
+
+    while (sb.wants_more())
+    {
+        int column = 0;
+        for (;;)
+        {
+            const auto& color = rng.pick(colors);
+            const auto& name = rng.pick(names);
+            const auto width = static_cast<int>(name.size()) + 2;
+            if (column + width > s_columns)
+            {
+                break;
+            }
+            sb.write_format("\x1b[0m\x1b[%.*sm%.*s\x1b[0m  ", static_cast<int>(color.size()), color.data(), static_cast<int>(name.size()), name.data());
+            column += width;
+        }
+        sb.write("\r\n");
+    }
+
+    return sb.view();
+}
+
+static std::string_view generate_htop(mem::Arena& arena, size_t bytes)
+{
+    StringBuilder sb{ arena, bytes };
+    Rng rng;
+
+    while (sb.wants_more())
+    {
+        // Header with CPU meters.
+        for (int y = 1; y <= 4; ++y)
+        {
+            const auto usage = static_cast<int>(rng.next(50));
+            sb.write_format("\x1b[%d;3H\x1b[36m%2d\x1b[39m\x1b[1m[\x1b[22;32m%.*s\x1b[31m%.*s\x1b[39;1m%*s]\x1b[22m\x1b[K", y, y - 1, usage / 2, "||||||||||||||||||||||||||||||||||||||||||||||||||", usage / 2, "||||||||||||||||||||||||||||||||||||||||||||||||||", 50 - usage, "");
+        }
+
+        // Process list with a highlighted row.
+        const auto selected = static_cast<int>(rng.next(s_rows - 6));
+        for (int y = 6; y <= s_rows; ++y)
+        {
+            const auto highlight = y - 6 == selected;
+            sb.write_format("\x1b[%d;1H%s%7u \x1b[36mroot\x1b[39m     20   0 %7uM %6uK %c %4u.%u %4u.%u %2u:%02u.%02u \x1b[1m/usr/bin/process%u\x1b[22m\x1b[K%s",
+                            y,
+                            highlight ? "\x1b[30;46m" : "",
+                            rng.next(100000),
+                            rng.next(10000),
+                            rng.next(100000),
+                            "RSD"[rng.next(3)],
+                            rng.next(100),
+                            rng.next(10),
+                            rng.next(100),
+                            rng.next(10),
+                            rng.next(60),
+                            rng.next(60),
+                            rng.next(100),
+                            rng.next(100),
+                            highlight ? "\x1b[m" : "");
+        }
+    }
+
+    return sb.view();
+}
+
+static std::string_view generate_sixel(mem::Arena& arena, size_t bytes)
+{
+    StringBuilder sb{ arena, bytes };
+    Rng rng;
+
+    sb.write("\x1bP0;1;0q\"1;1;960;600");
+    for (int i = 0; i < 16; ++i)
+    {
+        sb.write_format("#%d;2;%u;%u;%u", i, rng.next(101), rng.next(101), rng.next(101));
+    }
+
+    // Each band is 6 pixels high. Use runs of random length to get a mix of repeat introducers and plain data.
+    while (sb.wants_more())
+    {
+        for (int color = 0; color < 4; ++color)
+        {
+            sb.write_format("#%u", rng.next(16));
+            for (int x = 0; x < 960;)
+            {
+                const auto sixel = static_cast<char>('?' + rng.next(64));
+                const auto run = static_cast<int>(rng.next(8)) + 1;
+                if (run > 3)
+                {
+                    sb.write_format("!%d%c", run, sixel);
+                }
+                else
+                {
+                    for (int i = 0; i < run; ++i)
+                    {
+                        sb.write({ &sixel, 1 });
+                    }
+                }
+                x += run;
+            }
+            sb.write("$");
+        }
+        sb.write("-");
+    }
+    sb.write("\x1b\\");
+
+    return sb.view();
+}
+
+static std::string_view generate_hyperlinks(mem::Arena& arena, size_t bytes)
+{
+    StringBuilder sb{ arena, bytes };
+    Rng rng;
+
+    while (sb.wants_more())
+    {
+        // 6 links of 20 columns each fill one line.
+        for (int i = 0; i < 6; ++i)
+        {
+            const auto id = rng.next(100000);
+            sb.write_format("\x1b]8;id=%u;https://example.com/issues/%u\x1b\\issue #%-10u\x1b]8;;\x1b\\  ", id, id, id);
+        }
+        sb.write("\r\n");
+    }
+
+    return sb.view();
+}
+
+static std::string_view generate_cjk_emoji(mem::Arena& arena, size_t bytes)
+{
+    // A mix of wide CJK characters, surrogate pairs, emoji with modifiers and ZWJ sequences.
+    static constexpr std::string_view clusters[]{
+        "漢", "字", "か", "な", "カ", "ナ", "한", "글", "𠀋", "🙂", "👍🏽", "👩‍💻", "🇯🇵", "é", "a",
+    };
+
+    StringBuilder sb{ arena, bytes };
+    Rng rng;
+
+    // These lines are intentionally not terminated with a newline and wrap around instead.
+    while (sb.wants_more())
+    {
+        sb.write(rng.pick(clusters));
+    }
+
+    return sb.view();
+}
+
+VtPayloads generate_vt_payloads(mem::Arena& arena, size_t bytes)
+{
+    return {
+        .sgr = generate_sgr(arena, bytes),
+        .ls_color = generate_ls_color(arena, bytes),
+        .htop = generate_htop(arena, bytes),
+        .sixel = generate_sixel(arena, bytes),
+        .hyperlinks = generate_hyperlinks(arena, bytes),
+        .cjk_emoji = generate_cjk_emoji(arena, bytes),
+    };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+namespace mem
+{
+    struct Arena;
+}
+
+// Synthetic VT streams that approximate the output of common applications.
+// Each of them is at least `bytes` large and ends on a sequence boundary.
+struct VtPayloads
+{
+    // Every cell has a different 256-color or RGB foreground and background color.
+    std::string_view sgr;
+    // Resembles `ls --color`: Short colored file names separated by spaces.
+    std::string_view ls_color;
+    // Resembles `htop`: Lots of cursor positioning, short colored fields and EL.
+    std::string_view htop;
+    // A single large sixel image.
+    std::string_view sixel;
+    // Lots of short OSC 8 hyperlinks.
+    std::string_view hyperlinks;
+    // Long lines of CJK characters and emoji, including ZWJ sequences.
+    std::string_view cjk_emoji;
+};
+
+VtPayloads generate_vt_payloads(mem::Arena& arena, size_t bytes);
@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// GraphemeBench measures how fast CodepointWidthDetector segments and measures text, the way TextBuffer does it for
+// everything that's printed. Each corpus is processed until the time limit is reached and the results are written to
+// stdout as one JSON object per line, so that the runs of different builds can be diffed:
+//   {"corpus":"cjk","chars":...,"clusters":...,"columns":...,"samples":...,"median_ns":...,"mb_per_second":...}
+//
+// Usage: GraphemeBench [--time-limit <ms>] [<UTF-8 file>...]
+// Without files, built-in Latin, Cyrillic, CJK, emoji and mixed corpora are used. tools/U8U16Test
+// contains some larger natural language samples (en.txt, fr.txt, ru.txt, zh.txt) that work well.
+
+#include <LibraryIncludes.h>
+
+#include "../../types/inc/CodepointWidthDetector.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using clock_type = std::chrono::steady_clock;
+
+// Each corpus is repeated until it's at least this long, so that a sample isn't dominated by the clock's overhead.
+static constexpr size_t s_corpus_length = 256 * 1024;
+static constexpr size_t s_samples_min = 5;
+
+struct Corpus
+{
+    std::string name;
+    std::wstring text;
+};
+
+struct Result
+{
+    size_t clusters = 0;
+    size_t columns = 0;
+};
+
+static std::wstring repeat(const std::wstring_view& text)
+{
+    std::wstring result;
+    result.reserve(s_corpus_length + text.size());
+    while (result.size() < s_corpus_length)
+    {
+        result.append(text);
+    }
+    return result;
+}
+
+static std::vector<Corpus> builtin_corpora()
+{
+    std::vector<Corpus> corpora;
+    // Accented Latin, which mixes ASCII with precomposed characters.
+    corpora.push_back({ "latin", repeat(L"Falsches \u00DCben von Xylophonmusik qu\u00E4lt jeden gr\u00F6\u00DFeren Zwerg. Voix ambigu\u00EB d'un c\u0153ur qui au z\u00E9phyr pr\u00E9f\u00E8re les jattes de kiwis.\r\n") });
+    // Cyrillic is of ambiguous width.
+    corpora.push_back({ "cyrillic", repeat(L"\u0421\u044A\u0435\u0448\u044C \u0436\u0435 \u0435\u0449\u0451 \u044D\u0442\u0438\u0445 \u043C\u044F\u0433\u043A\u0438\u0445 \u0444\u0440\u0430\u043D\u0446\u0443\u0437\u0441\u043A\u0438\u0445 \u0431\u0443\u043B\u043E\u043A, \u0434\u0430 \u0432\u044B\u043F\u0435\u0439 \u0447\u0430\u044E.\r\n") });
+    // Chinese and Japanese, with ideographs, kana and fullwidth punctuation.
+    corpora.push_back({ "cjk", repeat(L"\u6211\u80FD\u541E\u4E0B\u73BB\u7483\u800C\u4E0D\u4F24\u8EAB\u4F53\u3002\u3044\u308D\u306F\u306B\u307B\u3078\u3068\u3061\u308A\u306C\u308B\u3092\uFF0C\u7D27\u6025\u60C5\u51B5\u4E0B\u8BF7\u6309\u4E0B\u6309\u94AE\uFF01\r\n") });
+    // Emoji with variation selectors, skin tones, ZWJ sequences and flags.
+    corpora.push_back({ "emoji", repeat(L"\U0001F600 \u2764\uFE0F \U0001F44D\U0001F3FD \U0001F468\u200D\U0001F469\u200D\U0001F467 \U0001F1E9\U0001F1EA \U0001F3F3\uFE0F\u200D\U0001F308 \u2705\r\n") });
+    // A build log in a CJK locale, which switches between ASCII and CJK all the time.
+    corpora.push_back({ "mixed", repeat(L"[build] \u6B63\u5728\u7F16\u8BD1 src\\host\\_stream.cpp (42/1337) \u2714 \u5B8C\u6210\uFF1A0 \u4E2A\u9519\u8BEF\r\n") });
+    return corpora;
+}
+
+static Corpus load_corpus(const char* path)
+{
+    std::ostringstream buf;
+    buf << std::ifstream{ path, std::ios::binary }.rdbuf();
+    return { std::filesystem::path{ path }.filename().string(), repeat(til::u8u16(buf.str())) };
+}
+
+static Result measure(CodepointWidthDetector& cwd, const std::wstring_view& text)
+{
+    Result result;
+    GraphemeState state;
+    // This is how TextBuffer and ROW iterate the text they're given.
+    while (cwd.GraphemeNext(state, text))
+    {
+        result.clusters++;
+        result.columns += state.width;
+    }
+    result.clusters++;
+    result.columns += state.width;
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    int64_t time_limit_ms = 500;
+    std::vector<Corpus> corpora;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{ til::at(argv, i) };
+
+        if (arg == "--time-limit" && i + 1 < argc)
+        {
+            const std::string_view value{ til::at(argv, ++i) };
+            std::from_chars(value.data(), value.data() + value.size(), time_limit_ms);
+        }
+        else
+        {
+            corpora.emplace_back(load_corpus(til::at(argv, i)));
+        }
+    }
+
+    if (corpora.empty())
+    {
+        corpora = builtin_corpora();
+    }
+
+    auto& cwd = CodepointWidthDetector::Singleton();
+    cwd.Reset(TextMeasurementMode::Graphemes);
+
+    for (const auto& corpus : corpora)
+    {
+        std::vector<int64_t> measurements;
+        clock_type::duration elapsed{};
+        Result result;
+
+        while (measurements.size() < s_samples_min || elapsed < std::chrono::milliseconds{ time_limit_ms })
+        {
+            const auto beg = clock_type::now();
+            result = measure(cwd, corpus.text);
+            const auto duration = clock_type::now() - beg;
+            measurements.emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+            elapsed += duration;
+        }
+
+        std::sort(measurements.begin(), measurements.end());
+        const auto median = std::max<int64_t>(1, measurements[measurements.size() / 2]);
+        const auto bytes = static_cast<double>(corpus.text.size() * sizeof(wchar_t));
+
+        printf(
+            R"({"corpus":"%s","chars":%zu,"clusters":%zu,"columns":%zu,"samples":%zu,"median_ns":%lld,"mb_per_second":%.1f})"
+            "\n",
+            corpus.name.c_str(),
+            corpus.text.size(),
+            result.clusters,
+            result.columns,
+            measurements.size(),
+            static_cast<long long>(median),
+            bytes / static_cast<double>(median) * 1e9 / 1024 / 1024);
+        fflush(stdout);
+    }
+
+    return 0;
+}
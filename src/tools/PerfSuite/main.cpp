@@ -0,0 +1,780 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// PerfSuite runs a fixed matrix of synthetic scenarios through each layer of the output pipeline, so that
+// there's a single baseline to compare builds against. The layers are:
+//   parser  A StateMachine whose dispatcher discards everything (the input engine for "paste")
+//   buffer  A Terminal, the way Windows Terminal uses it, but without a render engine
+//   atlas   A Terminal that's rendered by an AtlasEngine whose swap chain is never displayed, like ReplayBench
+//   conpty  A child process writes the scenario into a ConPTY, and its output is parsed by a Terminal
+//           (winconpty picks the OpenConsole.exe next to PerfSuite.exe, if there is one)
+// The scenarios are:
+//   ascii      Lines of printable ASCII
+//   sgr        Every cell has a different foreground and background color (see ConsoleBench's vt.h)
+//   cjk_emoji  Long lines of CJK characters and emoji
+//   sixel      A single large sixel image
+//   tui        Resembles `htop`: Lots of cursor positioning, short colored fields and EL
+//   resize     Alternates between two widths with a full history, which reflows the entire buffer
+//   search     Searches 100k lines of history
+//   paste      Pastes 1 MiB of text, which a child process reads through the ConPTY
+// Combinations that make no sense (like searching with just the parser) are skipped. Every combination runs in
+// a separate process, so that its memory usage isn't affected by the others. The results are written to stdout
+// as a single JSON object, one combination per line, so that runs of different builds can be diffed:
+//   {"results":[
+//   {"scenario":"ascii","layer":"parser","bytes":...,"duration_us":...,"bytes_per_second":...,"latency_p50_us":...,...},
+//   ...
+//   ]}
+// The latencies are those of the individual operations: 64 KiB writes, reads from the ConPTY, resizes or searches.
+//
+// Usage: PerfSuite [-s] [<scenario>[/<layer>]...]
+//   -s  use software rendering (WARP) for the atlas layer
+//   Without any filters the entire matrix is run.
+
+#include <LibraryIncludes.h>
+
+#include <psapi.h>
+
+#define CONPTY_IMPEXP
+#include <conpty-static.h>
+
+#include "../ConsoleBench/arena.h"
+#include "../ConsoleBench/vt.h"
+#include "../../buffer/out/search.h"
+#include "../../cascadia/TerminalCore/Terminal.hpp"
+#include "../../renderer/atlas/AtlasEngine.h"
+#include "../../renderer/base/renderer.hpp"
+#include "../../renderer/base/thread.hpp"
+#include "../../terminal/adapter/IInteractDispatch.hpp"
+#include "../../terminal/adapter/termDispatch.hpp"
+#include "../../terminal/parser/InputStateMachineEngine.hpp"
+#include "../../terminal/parser/OutputStateMachineEngine.hpp"
+#include "../../terminal/parser/stateMachine.hpp"
+
+#include <cstdio>
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::VirtualTerminal;
+using namespace Microsoft::Terminal::Core;
+using clock_type = std::chrono::steady_clock;
+
+namespace
+{
+    enum class Layer : uint8_t
+    {
+        Parser,
+        Buffer,
+        Atlas,
+        ConPty,
+    };
+
+    constexpr std::array layerNames{ L"parser", L"buffer", L"atlas", L"conpty" };
+
+    constexpr uint8_t layerBit(Layer layer) noexcept
+    {
+        return static_cast<uint8_t>(1 << static_cast<uint8_t>(layer));
+    }
+
+    constexpr uint8_t allLayers = 0b1111;
+
+    struct Scenario
+    {
+        const wchar_t* name;
+        // The layers that this scenario applies to. See layerBit().
+        uint8_t layers;
+    };
+
+    constexpr std::array scenarios{
+        Scenario{ L"ascii", allLayers },
+        Scenario{ L"sgr", allLayers },
+        Scenario{ L"cjk_emoji", allLayers },
+        Scenario{ L"sixel", allLayers },
+        Scenario{ L"tui", allLayers },
+        Scenario{ L"resize", layerBit(Layer::Buffer) | layerBit(Layer::Atlas) },
+        Scenario{ L"search", layerBit(Layer::Buffer) },
+        Scenario{ L"paste", layerBit(Layer::Parser) | layerBit(Layer::ConPty) },
+    };
+
+    constexpr til::size terminalSize{ 120, 30 };
+    // The size of the output of the streaming scenarios, in bytes of UTF-8.
+    constexpr size_t streamSize = 16 * 1024 * 1024;
+    // The in-process layers are given the output in chunks of this many characters, similar to ConptyConnection.
+    constexpr size_t chunkSize = 64 * 1024;
+    constexpr size_t pasteSize = 1024 * 1024;
+    constexpr til::CoordType resizeHistory = 10000;
+    constexpr int resizeCount = 20;
+    constexpr til::CoordType searchLines = 100000;
+    constexpr int searchCount = 20;
+    // The paste is followed by this character, which tells the child process that it's complete.
+    constexpr char pasteTerminator = '.';
+
+    struct Result
+    {
+        // The number of bytes of UTF-8 (the streaming scenarios and "paste") or characters (resize and search) processed.
+        size_t bytes = 0;
+        clock_type::duration duration{};
+        // The duration of each operation in microseconds.
+        std::vector<uint32_t> latencies;
+        std::optional<size_t> matches;
+        std::optional<FrameTimings::Counters> frameCounters;
+        std::optional<FrameTimings::Statistics> frameStatistics;
+    };
+
+    // Runs func() and records its duration in `result`.
+    template<typename T>
+    void measure(Result& result, T&& func)
+    {
+        const auto beg = clock_type::now();
+        func();
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - beg);
+        result.latencies.push_back(gsl::narrow_cast<uint32_t>(std::min<int64_t>(duration.count(), UINT32_MAX)));
+    }
+
+    FrameTimings::Percentiles percentiles(std::vector<uint32_t> values)
+    {
+        FrameTimings::Percentiles p;
+        if (values.empty())
+        {
+            return p;
+        }
+
+        std::sort(values.begin(), values.end());
+        const auto at = [&](size_t percent) {
+            return values[(values.size() - 1) * percent / 100];
+        };
+        p.p50 = at(50);
+        p.p90 = at(90);
+        p.p99 = at(99);
+        p.max = values.back();
+        return p;
+    }
+
+    void printPercentiles(const char* name, const FrameTimings::Percentiles& p)
+    {
+        printf(R"(,"%s_p50_us":%u,"%s_p90_us":%u,"%s_p99_us":%u,"%s_max_us":%u)", name, p.p50, name, p.p90, name, p.p99, name, p.max);
+    }
+
+    // Lines that are 1 column shorter than the terminal, so that they never wrap.
+    std::string generateLines(size_t bytes, size_t lineCount, char first, char count, std::string_view newline)
+    {
+        const auto width = gsl::narrow_cast<size_t>(terminalSize.width - 1);
+        std::string str;
+        str.reserve(bytes + width + newline.size());
+
+        for (size_t y = 0; str.size() < bytes || y < lineCount; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                str.push_back(static_cast<char>(first + (x + y) % count));
+            }
+            str.append(newline);
+        }
+
+        return str;
+    }
+
+    // Returns the text that the given scenario writes (or pastes), as UTF-8. It's identical across runs.
+    std::string generatePayload(std::wstring_view scenario)
+    {
+        if (scenario == L"ascii")
+        {
+            return generateLines(streamSize, 0, ' ', 95, "\r\n");
+        }
+        if (scenario == L"paste")
+        {
+            // Pasted text separates lines with CR. The letters never contain the pasteTerminator.
+            return generateLines(pasteSize, 0, 'a', 26, "\r");
+        }
+        if (scenario == L"resize")
+        {
+            return generateLines(0, resizeHistory + terminalSize.height, ' ', 95, "\r\n");
+        }
+        if (scenario == L"search")
+        {
+            auto str = generateLines(0, searchLines, 'a', 26, "\r\n");
+            // Every 1000th line contains the needle. generateLines() never produces a "_".
+            const size_t stride = terminalSize.width - 1 + 2;
+            for (size_t y = 0; y < searchLines; y += 1000)
+            {
+                memcpy(str.data() + y * stride, "needle_", 7);
+            }
+            return str;
+        }
+
+        // The generators in ConsoleBench produce all payloads at once.
+        mem::Arena arena{ 512 * 1024 * 1024 };
+        const auto payloads = generate_vt_payloads(arena, streamSize);
+        if (scenario == L"sgr")
+        {
+            return std::string{ payloads.sgr };
+        }
+        if (scenario == L"cjk_emoji")
+        {
+            return std::string{ payloads.cjk_emoji };
+        }
+        if (scenario == L"sixel")
+        {
+            return std::string{ payloads.sixel };
+        }
+        if (scenario == L"tui")
+        {
+            return std::string{ payloads.htop };
+        }
+
+        THROW_HR_MSG(E_INVALIDARG, "unknown scenario");
+    }
+
+    // Calls func() with chunks of at most chunkSize characters, which never split a surrogate pair.
+    template<typename T>
+    void forEachChunk(std::wstring_view text, T&& func)
+    {
+        while (!text.empty())
+        {
+            auto count = std::min(text.size(), chunkSize);
+            if (count < text.size() && til::is_leading_surrogate(text[count - 1]))
+            {
+                count--;
+            }
+            func(text.substr(0, count));
+            text = text.substr(count);
+        }
+    }
+
+    class DiscardingTermDispatch final : public TermDispatch
+    {
+    public:
+        void Print(const wchar_t /*wchPrintable*/) override {}
+        void PrintString(const std::wstring_view /*string*/) override {}
+    };
+
+    class DiscardingInteractDispatch final : public IInteractDispatch
+    {
+    public:
+        bool IsVtInputEnabled() const override { return false; }
+        void WriteInput(const std::span<const INPUT_RECORD>& /*inputEvents*/) override {}
+        void WriteCtrlKey(const INPUT_RECORD& /*event*/) override {}
+        void WriteString(std::wstring_view /*string*/) override {}
+        void WriteStringRaw(std::wstring_view /*string*/) override {}
+        void WindowManipulation(DispatchTypes::WindowManipulationType /*function*/, VTParameter /*parameter1*/, VTParameter /*parameter2*/) override {}
+        void MoveCursor(VTInt /*row*/, VTInt /*col*/) override {}
+        void FocusChanged(bool /*focused*/) override {}
+    };
+
+    // A Terminal, optionally rendered by an AtlasEngine. The members are destroyed in reverse order,
+    // which is important, because the renderer must be destroyed first. That stops its thread, which uses the others.
+    struct Pipeline
+    {
+        Pipeline(til::CoordType history, bool atlas, bool softwareRendering)
+        {
+            auto renderThread = std::make_unique<RenderThread>();
+            const auto renderThreadPointer = renderThread.get();
+            renderer = std::make_unique<Renderer>(terminal.GetRenderSettings(), &terminal, nullptr, 0, std::move(renderThread));
+            THROW_IF_FAILED(renderThreadPointer->Initialize(renderer.get()));
+
+            const auto lock = terminal.LockForWriting();
+
+            if (!atlas)
+            {
+                // Without an engine and without EnablePainting() the renderer never does anything.
+                terminal.Create(terminalSize, history, *renderer);
+                return;
+            }
+
+            engine = std::make_unique<AtlasEngine>();
+            renderer->AddRenderEngine(engine.get());
+            renderer->GetFrameTimings().SetCaptureEnabled(true);
+            engine->SetSoftwareRendering(softwareRendering);
+
+            FontInfoDesired fontDesired{ L"Cascadia Mono", 0, DWRITE_FONT_WEIGHT_NORMAL, 12.0f, CP_UTF8 };
+            FontInfo font{ L"", 0, 0, {}, 0 };
+            THROW_IF_FAILED(engine->UpdateDpi(USER_DEFAULT_SCREEN_DPI));
+            THROW_IF_FAILED(engine->UpdateFont(fontDesired, font));
+            cellSize = font.GetSize();
+            THROW_IF_FAILED(engine->SetWindowSize({ terminalSize.width * cellSize.width, terminalSize.height * cellSize.height }));
+
+            terminal.Create(terminalSize, history, *renderer);
+            terminal.SetFontInfo(font);
+            renderer->EnablePainting();
+        }
+
+        void Write(std::wstring_view text)
+        {
+            const auto lock = terminal.LockForWriting();
+            terminal.Write(text);
+        }
+
+        void Resize(til::size size)
+        {
+            const auto lock = terminal.LockForWriting();
+            if (engine)
+            {
+                THROW_IF_FAILED(engine->SetWindowSize({ size.width * cellSize.width, size.height * cellSize.height }));
+            }
+            THROW_IF_FAILED(terminal.UserResize(size));
+        }
+
+        // Waits until the renderer presented the final state (if there's an engine), and collects its statistics.
+        void Finish(Result& result)
+        {
+            if (!engine)
+            {
+                return;
+            }
+
+            renderer->WaitForPaintCompletionAndDisable(INFINITE);
+            const auto& timings = renderer->GetFrameTimings();
+            result.frameCounters = timings.GetCounters();
+            result.frameStatistics = timings.GetStatistics();
+        }
+
+        Terminal terminal;
+        std::unique_ptr<AtlasEngine> engine;
+        std::unique_ptr<Renderer> renderer;
+        til::size cellSize;
+    };
+
+    Result runParser(std::wstring_view scenario, const std::string& payload)
+    {
+        Result result;
+        const auto text = til::u8u16(payload);
+        result.bytes = payload.size();
+
+        if (scenario == L"paste")
+        {
+            StateMachine machine{ std::make_unique<InputStateMachineEngine>(std::make_unique<DiscardingInteractDispatch>()) };
+            const auto beg = clock_type::now();
+            machine.ProcessString(L"\x1b[200~");
+            forEachChunk(text, [&](std::wstring_view chunk) {
+                measure(result, [&]() { machine.ProcessString(chunk); });
+            });
+            machine.ProcessString(L"\x1b[201~");
+            result.duration = clock_type::now() - beg;
+            return result;
+        }
+
+        StateMachine machine{ std::make_unique<OutputStateMachineEngine>(std::make_unique<DiscardingTermDispatch>()) };
+        const auto beg = clock_type::now();
+        forEachChunk(text, [&](std::wstring_view chunk) {
+            measure(result, [&]() { machine.ProcessString(chunk); });
+        });
+        result.duration = clock_type::now() - beg;
+        return result;
+    }
+
+    Result runTerminal(std::wstring_view scenario, const std::string& payload, bool atlas, bool softwareRendering)
+    {
+        Result result;
+        const auto text = til::u8u16(payload);
+        const auto history = scenario == L"resize" ? resizeHistory : scenario == L"search" ? searchLines : 9001;
+        Pipeline pipeline{ history, atlas, softwareRendering };
+
+        if (scenario == L"resize")
+        {
+            // Filling the history isn't part of the measurement.
+            forEachChunk(text, [&](std::wstring_view chunk) { pipeline.Write(chunk); });
+
+            const auto beg = clock_type::now();
+            for (int i = 0; i < resizeCount; ++i)
+            {
+                const til::size size{ i % 2 ? terminalSize.width : terminalSize.width * 2 / 3, terminalSize.height };
+                measure(result, [&]() { pipeline.Resize(size); });
+            }
+            pipeline.Finish(result);
+            result.duration = clock_type::now() - beg;
+            result.bytes = text.size() * resizeCount;
+            return result;
+        }
+
+        if (scenario == L"search")
+        {
+            forEachChunk(text, [&](std::wstring_view chunk) { pipeline.Write(chunk); });
+
+            const auto lock = pipeline.terminal.LockForWriting();
+            const auto& buffer = pipeline.terminal.GetTextBuffer();
+            const auto beg = clock_type::now();
+            for (int i = 0; i < searchCount; ++i)
+            {
+                measure(result, [&]() {
+                    const auto matches = buffer.SearchText(L"NEEDLE_", SearchFlag::CaseInsensitive);
+                    result.matches = matches ? matches->size() : 0;
+                });
+            }
+            result.duration = clock_type::now() - beg;
+            result.bytes = text.size() * searchCount;
+            return result;
+        }
+
+        const auto beg = clock_type::now();
+        forEachChunk(text, [&](std::wstring_view chunk) {
+            measure(result, [&]() { pipeline.Write(chunk); });
+        });
+        pipeline.Finish(result);
+        result.duration = clock_type::now() - beg;
+        result.bytes = payload.size();
+        return result;
+    }
+
+    wil::unique_event openReadyEvent(DWORD parentPid)
+    {
+        const auto name = fmt::format(FMT_COMPILE(L"PerfSuite-{}-ready"), parentPid);
+        wil::unique_event event{ OpenEventW(EVENT_MODIFY_STATE, FALSE, name.c_str()) };
+        THROW_LAST_ERROR_IF(!event);
+        return event;
+    }
+
+    // Runs inside the ConPTY: Writes the payload of the given scenario to the console.
+    int emit(std::wstring_view scenario, DWORD parentPid)
+    {
+        const auto payload = generatePayload(scenario);
+        const auto output = GetStdHandle(STD_OUTPUT_HANDLE);
+        THROW_IF_WIN32_BOOL_FALSE(SetConsoleOutputCP(CP_UTF8));
+        THROW_IF_WIN32_BOOL_FALSE(SetConsoleMode(output, ENABLE_PROCESSED_OUTPUT | ENABLE_VIRTUAL_TERMINAL_PROCESSING | DISABLE_NEWLINE_AUTO_RETURN));
+
+        // Generating the payload isn't part of the measurement. This tells the parent to start the clock.
+        openReadyEvent(parentPid).SetEvent();
+
+        DWORD written = 0;
+        THROW_IF_WIN32_BOOL_FALSE(WriteFile(output, payload.data(), gsl::narrow<DWORD>(payload.size()), &written, nullptr));
+        return 0;
+    }
+
+    // Runs inside the ConPTY: Reads the console input until the pasteTerminator arrives.
+    int sink(DWORD parentPid)
+    {
+        const auto input = GetStdHandle(STD_INPUT_HANDLE);
+        // No echo and no line input, so that ReadFile() returns whatever arrived.
+        THROW_IF_WIN32_BOOL_FALSE(SetConsoleMode(input, 0));
+
+        openReadyEvent(parentPid).SetEvent();
+
+        char buffer[16 * 1024];
+        for (;;)
+        {
+            DWORD read = 0;
+            THROW_IF_WIN32_BOOL_FALSE(ReadFile(input, &buffer[0], sizeof(buffer), &read, nullptr));
+            if (std::string_view{ &buffer[0], read }.find(pasteTerminator) != std::string_view::npos)
+            {
+                return 0;
+            }
+        }
+    }
+
+    Result runConPty(std::wstring_view scenario, const std::string& payload)
+    {
+        Result result;
+        result.bytes = payload.size();
+
+        wil::unique_hfile inputRead, inputWrite, outputRead, outputWrite;
+        THROW_IF_WIN32_BOOL_FALSE(CreatePipe(inputRead.addressof(), inputWrite.addressof(), nullptr, 128 * 1024));
+        THROW_IF_WIN32_BOOL_FALSE(CreatePipe(outputRead.addressof(), outputWrite.addressof(), nullptr, 128 * 1024));
+
+        HPCON hPC = nullptr;
+        THROW_IF_FAILED(ConptyCreatePseudoConsole({ gsl::narrow_cast<SHORT>(terminalSize.width), gsl::narrow_cast<SHORT>(terminalSize.height) }, inputRead.get(), outputWrite.get(), 0, &hPC));
+        const auto closePseudoConsole = wil::scope_exit([&]() { ConptyClosePseudoConsole(hPC); });
+        inputRead.reset();
+        outputWrite.reset();
+
+        wil::unique_event ready;
+        ready.create(wil::EventOptions::ManualReset, fmt::format(FMT_COMPILE(L"PerfSuite-{}-ready"), GetCurrentProcessId()).c_str());
+
+        const auto paste = scenario == L"paste";
+        auto commandLine = paste ? fmt::format(FMT_COMPILE(LR"("{}" --sink {})"), wil::GetModuleFileNameW<std::wstring>(nullptr), GetCurrentProcessId()) :
+                                   fmt::format(FMT_COMPILE(LR"("{}" --emit {} {})"), wil::GetModuleFileNameW<std::wstring>(nullptr), scenario, GetCurrentProcessId());
+
+        wil::unique_process_information pi;
+        {
+            STARTUPINFOEX siEx{};
+            siEx.StartupInfo.cb = sizeof(STARTUPINFOEX);
+            siEx.StartupInfo.dwFlags = STARTF_USESTDHANDLES;
+
+            char attrList[128];
+            SIZE_T size = sizeof(attrList);
+            siEx.lpAttributeList = reinterpret_cast<PPROC_THREAD_ATTRIBUTE_LIST>(&attrList[0]);
+            THROW_IF_WIN32_BOOL_FALSE(InitializeProcThreadAttributeList(siEx.lpAttributeList, 1, 0, &size));
+            THROW_IF_WIN32_BOOL_FALSE(UpdateProcThreadAttribute(siEx.lpAttributeList, 0, PROC_THREAD_ATTRIBUTE_PSEUDOCONSOLE, hPC, sizeof(HPCON), nullptr, nullptr));
+            THROW_IF_WIN32_BOOL_FALSE(CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, FALSE, EXTENDED_STARTUPINFO_PRESENT, nullptr, nullptr, &siEx.StartupInfo, &pi));
+        }
+
+        // This way the ConPTY exits once the child process does, which closes the output pipe.
+        THROW_IF_FAILED(ConptyReleasePseudoConsole(hPC));
+
+        Pipeline pipeline{ 9001, false, false };
+        // ConPTY may ask for the cursor position or the device attributes at startup.
+        pipeline.terminal.SetWriteInputCallback([&](std::wstring_view response) {
+            const auto str = til::u16u8(response);
+            DWORD written = 0;
+            LOG_IF_WIN32_BOOL_FALSE(WriteFile(inputWrite.get(), str.data(), gsl::narrow<DWORD>(str.size()), &written, nullptr));
+        });
+
+        // The output is read from the start, because ConPTY may wait for the responses to its requests.
+        // For the streaming scenarios, the clock starts with the first read after the child said it's ready.
+        std::optional<clock_type::time_point> beg;
+        clock_type::time_point end;
+        HRESULT readerResult = S_OK;
+        std::thread reader{ [&]() {
+            try
+            {
+                til::u8state state;
+                std::wstring text;
+                const auto buffer = std::make_unique_for_overwrite<char[]>(chunkSize);
+                for (;;)
+                {
+                    DWORD read = 0;
+                    if (!ReadFile(outputRead.get(), buffer.get(), gsl::narrow_cast<DWORD>(chunkSize), &read, nullptr) || !read)
+                    {
+                        const auto error = GetLastError();
+                        THROW_WIN32_IF(error, error != ERROR_BROKEN_PIPE);
+                        break;
+                    }
+
+                    if (!paste && !beg && ready.is_signaled())
+                    {
+                        beg = clock_type::now();
+                    }
+
+                    const auto process = [&]() {
+                        THROW_IF_FAILED(til::u8u16({ buffer.get(), read }, text, state));
+                        pipeline.Write(text);
+                    };
+                    if (!paste && beg)
+                    {
+                        measure(result, process);
+                    }
+                    else
+                    {
+                        process();
+                    }
+                }
+                end = clock_type::now();
+            }
+            catch (...)
+            {
+                readerResult = wil::ResultFromCaughtException();
+                // Otherwise the child would wait for us to drain the pipe forever.
+                TerminateProcess(pi.hProcess, 1);
+            }
+        } };
+        // If anything goes wrong, the child is killed, which makes the ConPTY exit and the reader stop.
+        const auto joinReader = wil::scope_exit([&]() {
+            TerminateProcess(pi.hProcess, 1);
+            reader.join();
+        });
+
+        // Everything the child writes happens after it's ready and doesn't count as startup.
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_TIMEOUT), !ready.wait(60 * 1000));
+
+        if (paste)
+        {
+            beg = clock_type::now();
+            for (std::string_view remaining{ payload }; !remaining.empty();)
+            {
+                const auto chunk = remaining.substr(0, chunkSize);
+                measure(result, [&]() {
+                    DWORD written = 0;
+                    THROW_IF_WIN32_BOOL_FALSE(WriteFile(inputWrite.get(), chunk.data(), gsl::narrow<DWORD>(chunk.size()), &written, nullptr));
+                });
+                remaining = remaining.substr(chunk.size());
+            }
+            DWORD written = 0;
+            THROW_IF_WIN32_BOOL_FALSE(WriteFile(inputWrite.get(), &pasteTerminator, 1, &written, nullptr));
+        }
+
+        THROW_LAST_ERROR_IF(WaitForSingleObject(pi.hProcess, INFINITE) != WAIT_OBJECT_0);
+        const auto exited = clock_type::now();
+        joinReader.reset();
+        THROW_IF_FAILED(readerResult);
+        THROW_HR_IF_MSG(E_UNEXPECTED, !beg, "the child produced no output");
+
+        result.duration = (paste ? exited : end) - *beg;
+        return result;
+    }
+
+    // Runs a single combination and prints its results as a JSON object.
+    int run(std::wstring_view scenario, Layer layer, bool softwareRendering)
+    {
+        const auto payload = generatePayload(scenario);
+
+        // The peak working set includes the payload, so the working set before the measurement is reported as well.
+        PROCESS_MEMORY_COUNTERS before{ .cb = sizeof(before) };
+        THROW_IF_WIN32_BOOL_FALSE(GetProcessMemoryInfo(GetCurrentProcess(), &before, sizeof(before)));
+
+        Result result;
+        switch (layer)
+        {
+        case Layer::Parser:
+            result = runParser(scenario, payload);
+            break;
+        case Layer::Buffer:
+        case Layer::Atlas:
+            result = runTerminal(scenario, payload, layer == Layer::Atlas, softwareRendering);
+            break;
+        case Layer::ConPty:
+            result = runConPty(scenario, payload);
+            break;
+        }
+
+        PROCESS_MEMORY_COUNTERS memory{ .cb = sizeof(memory) };
+        THROW_IF_WIN32_BOOL_FALSE(GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory)));
+
+        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(result.duration);
+        const auto durationUs = std::max<int64_t>(1, duration.count());
+        printf(R"({"scenario":"%ls","layer":"%ls","bytes":%zu,"operations":%zu,"duration_us":%lld,"bytes_per_second":%llu)",
+               std::wstring{ scenario }.c_str(),
+               layerNames[static_cast<size_t>(layer)],
+               result.bytes,
+               result.latencies.size(),
+               duration.count(),
+               static_cast<unsigned long long>(result.bytes * 1'000'000ull / static_cast<uint64_t>(durationUs)));
+        printPercentiles("latency", percentiles(std::move(result.latencies)));
+        if (result.matches)
+        {
+            printf(R"(,"matches":%zu)", *result.matches);
+        }
+        if (result.frameCounters && result.frameStatistics)
+        {
+            printf(R"(,"frames":%llu,"slow_frames":%llu)", result.frameCounters->frames, result.frameCounters->slowFrames);
+            // The percentiles only cover the last FrameTimings::HistorySize frames.
+            printPercentiles("frame", result.frameStatistics->phases[static_cast<size_t>(FramePhase::Total)]);
+        }
+        printf(R"(,"working_set_before_kib":%zu,"peak_working_set_kib":%zu,"peak_commit_kib":%zu})"
+               "\n",
+               before.WorkingSetSize / 1024,
+               memory.PeakWorkingSetSize / 1024,
+               memory.PeakPagefileUsage / 1024);
+        return 0;
+    }
+
+    // Runs the command line and returns what it wrote to stdout.
+    std::string capture(std::wstring commandLine, DWORD& exitCode)
+    {
+        SECURITY_ATTRIBUTES sa{ .nLength = sizeof(sa), .bInheritHandle = TRUE };
+        wil::unique_hfile readPipe, writePipe;
+        THROW_IF_WIN32_BOOL_FALSE(CreatePipe(readPipe.addressof(), writePipe.addressof(), &sa, 0));
+        THROW_IF_WIN32_BOOL_FALSE(SetHandleInformation(readPipe.get(), HANDLE_FLAG_INHERIT, 0));
+
+        STARTUPINFOW si{
+            .cb = sizeof(si),
+            .dwFlags = STARTF_USESTDHANDLES,
+            .hStdInput = GetStdHandle(STD_INPUT_HANDLE),
+            .hStdOutput = writePipe.get(),
+            .hStdError = GetStdHandle(STD_ERROR_HANDLE),
+        };
+        wil::unique_process_information pi;
+        THROW_IF_WIN32_BOOL_FALSE(CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &si, &pi));
+        writePipe.reset();
+
+        std::string output;
+        char buffer[4096];
+        DWORD read = 0;
+        while (ReadFile(readPipe.get(), &buffer[0], sizeof(buffer), &read, nullptr) && read)
+        {
+            output.append(&buffer[0], read);
+        }
+
+        THROW_LAST_ERROR_IF(WaitForSingleObject(pi.hProcess, INFINITE) != WAIT_OBJECT_0);
+        THROW_IF_WIN32_BOOL_FALSE(GetExitCodeProcess(pi.hProcess, &exitCode));
+        return output;
+    }
+
+    bool matchesFilters(const std::vector<std::wstring_view>& filters, std::wstring_view scenario, std::wstring_view layer)
+    {
+        if (filters.empty())
+        {
+            return true;
+        }
+
+        const auto combination = fmt::format(FMT_COMPILE(L"{}/{}"), scenario, layer);
+        return std::ranges::any_of(filters, [&](std::wstring_view filter) {
+            return filter == scenario || filter == combination;
+        });
+    }
+}
+
+int wmain(int argc, const wchar_t* argv[])
+try
+{
+    // These are the modes the suite uses to run itself. See run(), emit() and sink().
+    if (argc >= 4 && std::wstring_view{ argv[1] } == L"--run")
+    {
+        const std::wstring_view layer{ argv[3] };
+        const auto it = std::ranges::find(layerNames, layer);
+        THROW_HR_IF_MSG(E_INVALIDARG, it == layerNames.end(), "unknown layer");
+        const auto softwareRendering = argc >= 5 && std::wstring_view{ argv[4] } == L"-s";
+        return run(argv[2], static_cast<Layer>(it - layerNames.begin()), softwareRendering);
+    }
+    if (argc >= 4 && std::wstring_view{ argv[1] } == L"--emit")
+    {
+        return emit(argv[2], wcstoul(argv[3], nullptr, 10));
+    }
+    if (argc >= 3 && std::wstring_view{ argv[1] } == L"--sink")
+    {
+        return sink(wcstoul(argv[2], nullptr, 10));
+    }
+
+    bool softwareRendering = false;
+    std::vector<std::wstring_view> filters;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::wstring_view arg{ argv[i] };
+        if (arg == L"-s")
+        {
+            softwareRendering = true;
+        }
+        else if (arg.starts_with(L'-'))
+        {
+            fputs("Usage: PerfSuite [-s] [<scenario>[/<layer>]...]\n", stderr);
+            return 1;
+        }
+        else
+        {
+            filters.push_back(arg);
+        }
+    }
+
+    const auto path = wil::GetModuleFileNameW<std::wstring>(nullptr);
+    int exitCode = 0;
+    bool first = true;
+
+    fputs("{\"results\":[\n", stdout);
+
+    for (const auto& scenario : scenarios)
+    {
+        for (size_t i = 0; i < layerNames.size(); ++i)
+        {
+            const auto layer = static_cast<Layer>(i);
+            if (!(scenario.layers & layerBit(layer)) || !matchesFilters(filters, scenario.name, layerNames[i]))
+            {
+                continue;
+            }
+
+            fprintf(stderr, "%ls/%ls\n", scenario.name, layerNames[i]);
+
+            DWORD childExitCode = 0;
+            auto output = capture(fmt::format(FMT_COMPILE(LR"("{}" --run {} {}{})"), path, scenario.name, layerNames[i], softwareRendering ? L" -s" : L""), childExitCode);
+            while (!output.empty() && (output.back() == '\n' || output.back() == '\r'))
+            {
+                output.pop_back();
+            }
+
+            // A failing combination shouldn't prevent the others from being measured.
+            if (childExitCode != 0 || output.empty())
+            {
+                output = fmt::format(FMT_COMPILE(R"({{"scenario":"{}","layer":"{}","error":"0x{:08x}"}})"), til::u16u8(scenario.name), til::u16u8(layerNames[i]), childExitCode);
+                exitCode = 1;
+            }
+
+            printf("%s%s", first ? "" : ",\n", output.c_str());
+            fflush(stdout);
+            first = false;
+        }
+    }
+
+    fputs("\n]}\n", stdout);
+    return exitCode;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    fprintf(stderr, "PerfSuite failed with 0x%08lx\n", static_cast<unsigned long>(wil::ResultFromCaughtException()));
+    return 1;
+}
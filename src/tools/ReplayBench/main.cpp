@@ -0,0 +1,251 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// ReplayBench replays the output of a DebugTap trace (see DebugTapTrace.h) into a Terminal that's rendered
+// by an AtlasEngine, the way Windows Terminal does it, except that the swap chain is never displayed.
+// The results are written to stdout as a single JSON object, so that runs of different builds can be diffed:
+//   {"trace":"...","chars":...,"duration_us":...,"chars_per_second":...,"frames":...,"slow_frames":...,...}
+//
+// Usage: ReplayBench [-r] [-s] [-c <columns>] [-l <lines>] <trace>
+//   -r  replay at the recorded speed instead of as fast as possible
+//   -s  use software rendering (WARP)
+//   -c  the width of the terminal, unless the trace recorded a resize (default 120)
+//   -l  the height of the terminal, unless the trace recorded a resize (default 30)
+
+#include <LibraryIncludes.h>
+
+#include <psapi.h>
+
+#include "../../cascadia/TerminalApp/DebugTapTrace.h"
+#include "../../cascadia/TerminalCore/Terminal.hpp"
+#include "../../renderer/atlas/AtlasEngine.h"
+#include "../../renderer/base/renderer.hpp"
+#include "../../renderer/base/thread.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Terminal::Core;
+using clock_type = std::chrono::steady_clock;
+
+namespace
+{
+    struct Chunk
+    {
+        std::chrono::microseconds timestamp;
+        std::wstring_view text;
+    };
+
+    struct Trace
+    {
+        std::string data;
+        std::vector<Chunk> chunks;
+        std::optional<til::size> size;
+    };
+
+    Trace loadTrace(const wchar_t* path)
+    {
+        Trace trace;
+
+        {
+            wil::unique_hfile file{ CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+            THROW_LAST_ERROR_IF(!file);
+
+            LARGE_INTEGER size;
+            THROW_IF_WIN32_BOOL_FALSE(GetFileSizeEx(file.get(), &size));
+            trace.data.resize(gsl::narrow<size_t>(size.QuadPart));
+
+            DWORD read = 0;
+            THROW_IF_WIN32_BOOL_FALSE(ReadFile(file.get(), trace.data.data(), gsl::narrow<DWORD>(trace.data.size()), &read, nullptr));
+            THROW_HR_IF(E_UNEXPECTED, read != trace.data.size());
+        }
+
+        const std::string_view magic{ &DebugTapTrace::Magic[0], sizeof(DebugTapTrace::Magic) };
+        THROW_HR_IF_MSG(E_INVALIDARG, !trace.data.starts_with(magic), "not a DebugTap trace");
+
+        for (auto p = trace.data.data() + magic.size(), end = trace.data.data() + trace.data.size(); gsl::narrow_cast<size_t>(end - p) >= sizeof(DebugTapTrace::RecordHeader);)
+        {
+            DebugTapTrace::RecordHeader header;
+            memcpy(&header, p, sizeof(header));
+            p += sizeof(header);
+
+            // The recording may have been cut off in the middle of a record.
+            if (header.size > gsl::narrow_cast<size_t>(end - p))
+            {
+                break;
+            }
+
+            switch (header.type)
+            {
+            case DebugTapTrace::RecordType::Output:
+                // The records aren't aligned, but x64 and ARM64 don't mind.
+                trace.chunks.push_back({ std::chrono::microseconds{ header.timestamp }, { reinterpret_cast<const wchar_t*>(p), header.size / sizeof(wchar_t) } });
+                break;
+            case DebugTapTrace::RecordType::Resize:
+                // Only the first size is used. Reflowing in the middle of the
+                // replay would measure the resize more than the output.
+                if (!trace.size && header.size >= 2 * sizeof(uint32_t))
+                {
+                    uint32_t size[2];
+                    memcpy(&size[0], p, sizeof(size));
+                    trace.size = til::size{ gsl::narrow<til::CoordType>(size[1]), gsl::narrow<til::CoordType>(size[0]) };
+                }
+                break;
+            default:
+                break;
+            }
+
+            p += header.size;
+        }
+
+        return trace;
+    }
+
+    void printPercentiles(const char* name, const FrameTimings::Percentiles& p)
+    {
+        printf(R"(,"%s_p50_us":%u,"%s_p90_us":%u,"%s_p99_us":%u,"%s_max_us":%u)", name, p.p50, name, p.p90, name, p.p99, name, p.max);
+    }
+}
+
+int wmain(int argc, const wchar_t* argv[])
+try
+{
+    const wchar_t* path = nullptr;
+    bool realTime = false;
+    bool softwareRendering = false;
+    til::size size{ 120, 30 };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::wstring_view arg{ argv[i] };
+        if (arg == L"-r")
+        {
+            realTime = true;
+        }
+        else if (arg == L"-s")
+        {
+            softwareRendering = true;
+        }
+        else if (arg == L"-c" && i + 1 < argc)
+        {
+            size.width = std::max(1, _wtoi(argv[++i]));
+        }
+        else if (arg == L"-l" && i + 1 < argc)
+        {
+            size.height = std::max(1, _wtoi(argv[++i]));
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (!path)
+    {
+        fputs("Usage: ReplayBench [-r] [-s] [-c <columns>] [-l <lines>] <trace>\n", stderr);
+        return 1;
+    }
+
+    const auto trace = loadTrace(path);
+    size = trace.size.value_or(size);
+
+    // The renderer must be destroyed first, because that stops its thread, which uses the other two.
+    Terminal terminal;
+    AtlasEngine engine;
+    auto renderThread = std::make_unique<RenderThread>();
+    const auto renderThreadPointer = renderThread.get();
+    Renderer renderer{ terminal.GetRenderSettings(), &terminal, nullptr, 0, std::move(renderThread) };
+    THROW_IF_FAILED(renderThreadPointer->Initialize(&renderer));
+    renderer.AddRenderEngine(&engine);
+    renderer.GetFrameTimings().SetCaptureEnabled(true);
+
+    engine.SetSoftwareRendering(softwareRendering);
+
+    {
+        const auto lock = terminal.LockForWriting();
+
+        FontInfoDesired fontDesired{ L"Cascadia Mono", 0, DWRITE_FONT_WEIGHT_NORMAL, 12.0f, CP_UTF8 };
+        FontInfo font{ L"", 0, 0, {}, 0 };
+        THROW_IF_FAILED(engine.UpdateDpi(USER_DEFAULT_SCREEN_DPI));
+        THROW_IF_FAILED(engine.UpdateFont(fontDesired, font));
+
+        const auto cellSize = font.GetSize();
+        THROW_IF_FAILED(engine.SetWindowSize({ size.width * cellSize.width, size.height * cellSize.height }));
+
+        terminal.Create(size, 9001, renderer);
+        terminal.SetFontInfo(font);
+        renderer.EnablePainting();
+    }
+
+    size_t chars = 0;
+    clock_type::duration lockWaitTotal{};
+    clock_type::duration lockWaitMax{};
+
+    const auto beg = clock_type::now();
+    const auto first = trace.chunks.empty() ? std::chrono::microseconds{} : trace.chunks.front().timestamp;
+
+    for (const auto& chunk : trace.chunks)
+    {
+        if (realTime)
+        {
+            std::this_thread::sleep_until(beg + (chunk.timestamp - first));
+        }
+
+        // Time spent waiting for the lock is time the renderer held it. That's the contention we're interested in.
+        const auto lockBeg = clock_type::now();
+        const auto lock = terminal.LockForWriting();
+        const auto lockWait = clock_type::now() - lockBeg;
+        lockWaitTotal += lockWait;
+        lockWaitMax = std::max(lockWaitMax, lockWait);
+
+        terminal.Write(chunk.text);
+        chars += chunk.text.size();
+    }
+
+    // Let the renderer finish the frame it's working on, which presents the final state.
+    renderer.WaitForPaintCompletionAndDisable(INFINITE);
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - beg);
+
+    const auto& timings = renderer.GetFrameTimings();
+    const auto counters = timings.GetCounters();
+    const auto statistics = timings.GetStatistics();
+
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    THROW_IF_WIN32_BOOL_FALSE(GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime));
+    const auto toMicroseconds = [](const FILETIME& ft) {
+        return ((static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) / 10;
+    };
+
+    PROCESS_MEMORY_COUNTERS memory{ .cb = sizeof(memory) };
+    THROW_IF_WIN32_BOOL_FALSE(GetProcessMemoryInfo(GetCurrentProcess(), &memory, sizeof(memory)));
+
+    const auto durationUs = std::max<int64_t>(1, duration.count());
+    printf(R"({"trace":"%ls","real_time":%s,"chars":%zu,"duration_us":%lld,"chars_per_second":%llu)",
+           std::filesystem::path{ path }.filename().c_str(),
+           realTime ? "true" : "false",
+           chars,
+           duration.count(),
+           static_cast<unsigned long long>(chars * 1'000'000 / durationUs));
+    printf(R"(,"frames":%llu,"slow_frames":%llu)", counters.frames, counters.slowFrames);
+    // The percentiles only cover the last FrameTimings::HistorySize frames.
+    printPercentiles("frame", statistics.phases[static_cast<size_t>(FramePhase::Total)]);
+    printPercentiles("render_lock_wait", statistics.phases[static_cast<size_t>(FramePhase::LockWait)]);
+    printf(R"(,"write_lock_wait_us":%lld,"write_lock_wait_max_us":%lld)",
+           std::chrono::duration_cast<std::chrono::microseconds>(lockWaitTotal).count(),
+           std::chrono::duration_cast<std::chrono::microseconds>(lockWaitMax).count());
+    printf(R"(,"cpu_user_us":%llu,"cpu_kernel_us":%llu,"peak_working_set_kib":%zu,"peak_commit_kib":%zu})"
+           "\n",
+           toMicroseconds(userTime),
+           toMicroseconds(kernelTime),
+           memory.PeakWorkingSetSize / 1024,
+           memory.PeakPagefileUsage / 1024);
+    return 0;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    fprintf(stderr, "ReplayBench failed with 0x%08lx\n", static_cast<unsigned long>(wil::ResultFromCaughtException()));
+    return 1;
+}
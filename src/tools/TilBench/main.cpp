@@ -0,0 +1,446 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TilBench measures the til containers with workloads that resemble their use in the text buffer and renderer.
+// Each benchmark is sampled until it ran for at least the given time limit (or s_samples_max times) and the
+// results are written to stdout as one JSON object per line, so that they can be diffed or fed into a script:
+//   {"name":"rle/replace_cell","samples":1234,"ops":120,"min_ns":...,"median_ns":...,"mean_ns":...,"ns_per_op":...}
+//
+// Usage: TilBench [filter] [--time-limit <ms>]
+// Only benchmarks whose name contains the filter are run.
+
+#include <LibraryIncludes.h>
+
+#include <til/flat_set.h>
+#include <til/rle.h>
+#include <til/small_vector.h>
+#include <til/spsc.h>
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+
+using clock_type = std::chrono::steady_clock;
+
+static constexpr size_t s_samples_min = 20;
+static constexpr size_t s_samples_max = 100'000;
+static constexpr uint16_t s_row_width = 120;
+
+// Prevents the compiler from optimizing away the results of a benchmark.
+static volatile size_t s_sink = 0;
+
+struct BenchmarkContext
+{
+    bool wants_more() const noexcept;
+    void mark_beg() noexcept;
+    void mark_end();
+    size_t rand() noexcept;
+
+    // The number of operations per sample. Used to report the time per operation.
+    size_t ops = 1;
+    std::vector<int64_t> measurements;
+    clock_type::time_point beg;
+    clock_type::duration elapsed{};
+    clock_type::duration time_limit{};
+    size_t rng_state = 0;
+};
+
+struct Benchmark
+{
+    const char* name;
+    void (*exec)(BenchmarkContext& ctx);
+};
+
+bool BenchmarkContext::wants_more() const noexcept
+{
+    return measurements.size() < s_samples_min || (measurements.size() < s_samples_max && elapsed < time_limit);
+}
+
+void BenchmarkContext::mark_beg() noexcept
+{
+    beg = clock_type::now();
+}
+
+void BenchmarkContext::mark_end()
+{
+    const auto duration = clock_type::now() - beg;
+    measurements.emplace_back(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    elapsed += duration;
+}
+
+size_t BenchmarkContext::rand() noexcept
+{
+    // These constants are the same as used by the PCG family of random number generators.
+    // The 32-Bit version is described in https://doi.org/10.1090/S0025-5718-99-00996-5, Table 5.
+    // The 64-Bit version is the multiplier as used by Donald Knuth for MMIX and found by C. E. Haynes.
+#ifdef _WIN64
+    rng_state = rng_state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+#else
+    rng_state = rng_state * UINT32_C(747796405) + UINT32_C(2891336453);
+#endif
+    return rng_state;
+}
+
+#pragma region rle
+
+// Same as TextAttributeTable::Runs.
+using AttributeRuns = til::small_rle<uint32_t, uint16_t, 1>;
+
+// A row similar to colored `ls` or `git log` output: Runs of 1-16 columns with one of 8 attributes.
+static AttributeRuns make_colored_row(BenchmarkContext& ctx)
+{
+    AttributeRuns row(s_row_width, 0);
+    for (uint16_t x = 0; x < s_row_width;)
+    {
+        const auto end = std::min<uint16_t>(s_row_width, gsl::narrow_cast<uint16_t>(x + 1 + ctx.rand() % 16));
+        row.replace(x, end, gsl::narrow_cast<uint32_t>(ctx.rand() % 8));
+        x = end;
+    }
+    return row;
+}
+
+// Writing text cell by cell, where each cell gets its own attribute (ROW::ReplaceAttributes).
+static void rle_replace_cell(BenchmarkContext& ctx)
+{
+    ctx.ops = s_row_width;
+
+    while (ctx.wants_more())
+    {
+        AttributeRuns row(s_row_width, 0);
+
+        ctx.mark_beg();
+        for (uint16_t x = 0; x < s_row_width; ++x)
+        {
+            row.replace(x, gsl::narrow_cast<uint16_t>(x + 1), x & 1);
+        }
+        ctx.mark_end();
+
+        s_sink = s_sink + row.runs().size();
+    }
+}
+
+// Writing colored text in chunks and filling the remainder of the row (ROW::SetAttrToEnd).
+static void rle_set_attr_to_end(BenchmarkContext& ctx)
+{
+    ctx.ops = s_row_width / 8;
+
+    while (ctx.wants_more())
+    {
+        auto row = make_colored_row(ctx);
+
+        ctx.mark_beg();
+        for (uint16_t x = 0; x < s_row_width; x += 8)
+        {
+            row.replace(x, row.size(), (x / 8) % 3);
+        }
+        ctx.mark_end();
+
+        s_sink = s_sink + row.runs().size();
+    }
+}
+
+// DECCARA over an entire row (ROW::TransformAttributes).
+static void rle_transform_row(BenchmarkContext& ctx)
+{
+    ctx.ops = 1;
+
+    while (ctx.wants_more())
+    {
+        auto row = make_colored_row(ctx);
+
+        ctx.mark_beg();
+        row.transform(0, s_row_width, [](const uint32_t id) { return id / 2; });
+        ctx.mark_end();
+
+        s_sink = s_sink + row.runs().size();
+    }
+}
+
+// Round-tripping a row through a dense array of attributes.
+static void rle_expand_compress(BenchmarkContext& ctx)
+{
+    ctx.ops = 1;
+    std::array<uint32_t, s_row_width> dense{};
+
+    while (ctx.wants_more())
+    {
+        const auto row = make_colored_row(ctx);
+
+        ctx.mark_beg();
+        row.expand(dense);
+        const auto compressed = AttributeRuns::compress(dense);
+        ctx.mark_end();
+
+        s_sink = s_sink + compressed.runs().size();
+    }
+}
+
+#pragma endregion
+
+#pragma region flat_set
+
+// Modelled after BackendD3D's AtlasGlyphEntry.
+struct GlyphEntry
+{
+    uint16_t glyphIndex = 0;
+    uint8_t occupied = 0;
+    uint32_t data = 0;
+};
+
+struct GlyphEntryHashTrait
+{
+    static constexpr bool occupied(const GlyphEntry& entry) noexcept
+    {
+        return entry.occupied != 0;
+    }
+
+    static constexpr size_t hash(const uint16_t glyphIndex) noexcept
+    {
+        return til::flat_set_hash_integer(glyphIndex);
+    }
+
+    static constexpr size_t hash(const GlyphEntry& entry) noexcept
+    {
+        return til::flat_set_hash_integer(entry.glyphIndex);
+    }
+
+    static constexpr bool equals(const GlyphEntry& entry, uint16_t glyphIndex) noexcept
+    {
+        return entry.glyphIndex == glyphIndex;
+    }
+
+    static constexpr void assign(GlyphEntry& entry, uint16_t glyphIndex) noexcept
+    {
+        entry.glyphIndex = glyphIndex;
+        entry.occupied = 1;
+    }
+};
+
+using GlyphSet = til::linear_flat_set<GlyphEntry, GlyphEntryHashTrait>;
+
+// The glyph indices of a frame: Mostly the ~100 glyphs of ASCII text, with the occasional rare glyph.
+static std::vector<uint16_t> make_glyph_indices(BenchmarkContext& ctx, size_t count)
+{
+    std::vector<uint16_t> indices(count);
+    for (auto& index : indices)
+    {
+        const auto r = ctx.rand();
+        index = gsl::narrow_cast<uint16_t>(r % 16 ? 3 + (r >> 8) % 95 : 3 + (r >> 8) % 4000);
+    }
+    return indices;
+}
+
+// Looking up the glyphs of a 120x30 viewport in an already populated cache.
+static void flat_set_glyph_lookup(BenchmarkContext& ctx)
+{
+    const auto indices = make_glyph_indices(ctx, size_t{ s_row_width } * 30);
+    GlyphSet set;
+    for (uint16_t i = 3; i < 3 + 1000; ++i)
+    {
+        set.insert(i);
+    }
+
+    ctx.ops = indices.size();
+
+    while (ctx.wants_more())
+    {
+        size_t found = 0;
+
+        ctx.mark_beg();
+        for (const auto index : indices)
+        {
+            found += set.lookup(index) != nullptr;
+        }
+        ctx.mark_end();
+
+        s_sink = s_sink + found;
+    }
+}
+
+// Populating an empty cache, like after a font change.
+static void flat_set_glyph_insert(BenchmarkContext& ctx)
+{
+    const auto indices = make_glyph_indices(ctx, size_t{ s_row_width } * 30);
+
+    ctx.ops = indices.size();
+
+    while (ctx.wants_more())
+    {
+        GlyphSet set;
+
+        ctx.mark_beg();
+        for (const auto index : indices)
+        {
+            auto [entry, inserted] = set.insert(index);
+            if (inserted)
+            {
+                entry->data = index;
+            }
+        }
+        ctx.mark_end();
+
+        s_sink = s_sink + set.lookup(indices.front())->data;
+    }
+}
+
+#pragma endregion
+
+#pragma region small_vector
+
+template<size_t N>
+static void small_vector_push_back(BenchmarkContext& ctx)
+{
+    ctx.ops = N;
+
+    while (ctx.wants_more())
+    {
+        ctx.mark_beg();
+        til::small_vector<size_t, 16> vec;
+        for (size_t i = 0; i < N; ++i)
+        {
+            vec.push_back(i);
+        }
+        ctx.mark_end();
+
+        s_sink = s_sink + vec.size();
+    }
+}
+
+#pragma endregion
+
+#pragma region spsc
+
+// Sends count items from a second thread, either one at a time or batch_size items at a time.
+template<size_t BatchSize>
+static void spsc_throughput(BenchmarkContext& ctx)
+{
+    static constexpr size_t count = 1 << 18;
+    ctx.ops = count;
+
+    while (ctx.wants_more())
+    {
+        auto [tx, rx] = til::spsc::channel<size_t>(4096);
+
+        ctx.mark_beg();
+        std::thread producer{ [tx = std::move(tx)]() {
+            if constexpr (BatchSize == 1)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    tx.emplace(i);
+                }
+            }
+            else
+            {
+                std::array<size_t, BatchSize> batch;
+                for (size_t i = 0; i < count; i += BatchSize)
+                {
+                    std::iota(batch.begin(), batch.end(), i);
+                    tx.push(batch.begin(), batch.end());
+                }
+            }
+        } };
+
+        size_t sum = 0;
+        if constexpr (BatchSize == 1)
+        {
+            while (const auto item = rx.pop())
+            {
+                sum += *item;
+            }
+        }
+        else
+        {
+            std::array<size_t, BatchSize> batch;
+            for (;;)
+            {
+                const auto [n, ok] = rx.pop_n(batch.begin(), batch.size());
+                sum = std::accumulate(batch.begin(), batch.begin() + n, sum);
+                if (!ok || n == 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        producer.join();
+        ctx.mark_end();
+
+        s_sink = s_sink + sum;
+    }
+}
+
+#pragma endregion
+
+static constexpr Benchmark s_benchmarks[] = {
+    { "rle/replace_cell", rle_replace_cell },
+    { "rle/set_attr_to_end", rle_set_attr_to_end },
+    { "rle/transform_row", rle_transform_row },
+    { "rle/expand_compress", rle_expand_compress },
+    { "flat_set/glyph_lookup", flat_set_glyph_lookup },
+    { "flat_set/glyph_insert", flat_set_glyph_insert },
+    { "small_vector/push_back_8", small_vector_push_back<8> },
+    { "small_vector/push_back_64", small_vector_push_back<64> },
+    { "spsc/throughput_single", spsc_throughput<1> },
+    { "spsc/throughput_batch_256", spsc_throughput<256> },
+};
+
+static void print_result(const Benchmark& bench, BenchmarkContext& ctx)
+{
+    auto& m = ctx.measurements;
+    std::sort(m.begin(), m.end());
+
+    const auto sum = std::accumulate(m.begin(), m.end(), int64_t{ 0 });
+    const auto mean = static_cast<double>(sum) / static_cast<double>(m.size());
+    const auto median = m[m.size() / 2];
+
+    printf(
+        R"({"name":"%s","samples":%zu,"ops":%zu,"min_ns":%lld,"median_ns":%lld,"mean_ns":%.1f,"ns_per_op":%.3f})"
+        "\n",
+        bench.name,
+        m.size(),
+        ctx.ops,
+        static_cast<long long>(m.front()),
+        static_cast<long long>(median),
+        mean,
+        static_cast<double>(median) / static_cast<double>(ctx.ops));
+    fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    std::string_view filter;
+    int64_t time_limit_ms = 500;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg{ til::at(argv, i) };
+
+        if (arg == "--time-limit" && i + 1 < argc)
+        {
+            const std::string_view value{ til::at(argv, ++i) };
+            std::from_chars(value.data(), value.data() + value.size(), time_limit_ms);
+        }
+        else
+        {
+            filter = arg;
+        }
+    }
+
+    for (const auto& bench : s_benchmarks)
+    {
+        if (std::string_view{ bench.name }.find(filter) == std::string_view::npos)
+        {
+            continue;
+        }
+
+        BenchmarkContext ctx;
+        ctx.time_limit = std::chrono::milliseconds{ time_limit_ms };
+        ctx.rng_state = 0x5eed;
+        ctx.measurements.reserve(s_samples_max);
+        bench.exec(ctx);
+        print_result(bench, ctx);
+    }
+
+    return 0;
+}
@@ -3,6 +3,8 @@
 // NOTE The functions u8u16 and u16u8 contain own algorithms. Tests have shown that they perform
 // worse than the platform API functions.
 // Thus, these functions are *unrelated* to the til::u8u16 and til::u16u8 implementation.
+// The "til vs. platform" tests at the end compare the til implementation (which handles
+// runs of ASCII itself and uses the platform functions for everything else) to the platform functions.
 
 #include <iostream>
 #include <memory>
@@ -13,6 +15,8 @@
 
 #include "U8U16Test.hpp"
 
+#include <LibraryIncludes.h>
+
 typedef NTSTATUS(WINAPI* t_RtlUTF8ToUnicodeN)(PWSTR, ULONG, PULONG, PCCH, ULONG);
 typedef NTSTATUS(WINAPI* t_RtlUnicodeToUTF8N)(PCHAR, ULONG, PULONG, PCWSTR, ULONG);
 NTSTATUS(WINAPI* p_RtlUTF8ToUnicodeN)
@@ -442,6 +446,94 @@ void CompNaturalLang_Chunks(const std::string& fileName)
     std::cout << " u16u8_ptr           length " << lenTotalU16U8 << " elapsed " << durTotalU16U8 << std::endl;
 }
 
+// Converts u8Str in chunks of the size ConptyConnection reads with, once directly with the platform
+// functions and once with til::u8u16 / til::u16u8 including their partials handling.
+void CompTil(const char* const name, const std::string& u8Str)
+{
+    std::string head{ __func__ };
+    head += " - ";
+    head += name;
+    PrintHeader(head.c_str());
+
+    constexpr size_t chunkSize{ 4096u };
+    constexpr int iterations{ 20 };
+    const std::wstring u16Str{ til::u8u16(u8Str) };
+
+    int lenMB2WC{};
+    int lenWC2MB{};
+    size_t lenU8U16{};
+    size_t lenU16U8{};
+    double durMB2WC{};
+    double durWC2MB{};
+    double durU8U16{};
+    double durU16U8{};
+
+    std::unique_ptr<wchar_t[]> u16Buffer{ std::make_unique<wchar_t[]>(chunkSize) };
+    std::unique_ptr<char[]> u8Buffer{ std::make_unique<char[]>(chunkSize * 3) };
+    std::wstring u16StrOut{};
+    std::string u8StrOut{};
+    til::u8state u8State{};
+    til::u16state u16State{};
+
+    for (int iteration{}; iteration < iterations; ++iteration)
+    {
+        for (size_t idx{}; idx < u8Str.length(); idx += chunkSize)
+        {
+            const auto chunk{ til::safe_slice_len(std::string_view{ u8Str }, idx, chunkSize) };
+
+            GetDuration();
+            lenMB2WC += MultiByteToWideChar(CP_UTF8, 0, chunk.data(), static_cast<int>(chunk.length()), u16Buffer.get(), static_cast<int>(chunkSize));
+            durMB2WC += GetDuration();
+
+            GetDuration();
+            std::ignore = til::u8u16(chunk, u16StrOut, u8State);
+            durU8U16 += GetDuration();
+            lenU8U16 += u16StrOut.length();
+        }
+
+        for (size_t idx{}; idx < u16Str.length(); idx += chunkSize)
+        {
+            const auto chunk{ til::safe_slice_len(std::wstring_view{ u16Str }, idx, chunkSize) };
+
+            GetDuration();
+            lenWC2MB += WideCharToMultiByte(CP_UTF8, 0, chunk.data(), static_cast<int>(chunk.length()), u8Buffer.get(), static_cast<int>(chunkSize * 3), nullptr, nullptr);
+            durWC2MB += GetDuration();
+
+            GetDuration();
+            std::ignore = til::u16u8(chunk, u8StrOut, u16State);
+            durU16U8 += GetDuration();
+            lenU16U8 += u8StrOut.length();
+        }
+    }
+
+    std::cout << " MultiByteToWideChar length " << lenMB2WC << " elapsed " << durMB2WC << std::endl;
+    std::cout << " til::u8u16          length " << lenU8U16 << " elapsed " << durU8U16 << std::endl;
+    std::cout << " WideCharToMultiByte length " << lenWC2MB << " elapsed " << durWC2MB << std::endl;
+    std::cout << " til::u16u8          length " << lenU16U8 << " elapsed " << durU16U8 << std::endl;
+}
+
+void CompTil_File(const std::string& fileName)
+{
+    std::ostringstream u8Ss{};
+    std::ostringstream buf{};
+    buf << std::ifstream{ fileName }.rdbuf();
+    std::fill_n(std::ostream_iterator<const char*>{ u8Ss }, 30000u, buf.str().c_str());
+    CompTil(fileName.c_str(), u8Ss.str());
+}
+
+void CompTil_Log()
+{
+    // Mostly-ASCII build log output with the occasional non-ASCII character and VT sequence.
+    std::string u8Str{};
+    for (int i{}; i < 200000; ++i)
+    {
+        u8Str += "\x1b[32m[build]\x1b[m Compiling src\\host\\_stream.cpp (";
+        u8Str += std::to_string(i);
+        u8Str += i % 10 ? "/200000)\r\n" : "/200000) \xE2\x9C\x94\r\n"; // HEAVY CHECK MARK
+    }
+    CompTil("build log", u8Str);
+}
+
 int main()
 {
     // UTF-16 string length
@@ -519,6 +611,14 @@ int main()
     CompNaturalLang_Chunks("ru.txt");
     CompNaturalLang_Chunks("zh.txt");
 
+    std::cout << "\n\n### til vs. platform ###" << std::endl;
+
+    CompTil_Log();
+    CompTil_File("en.txt");
+    CompTil_File("fr.txt");
+    CompTil_File("ru.txt");
+    CompTil_File("zh.txt");
+
     FreeLibrary(ntdll);
     return 0;
 }
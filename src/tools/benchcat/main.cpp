@@ -12,6 +12,7 @@
 #include <cstdint>
 
 #include "crt.cpp"
+#include "../../cascadia/TerminalApp/DebugTapTrace.h"
 
 // This warning is broken on if/else chains with init statements.
 #pragma warning(disable : 4456) // declaration of '...' hides previous local declaration
@@ -325,6 +326,20 @@ enum class VtMode
     Color
 };
 
+enum class TraceMode
+{
+    Off,
+    MaxSpeed,
+    RealTime
+};
+
+// The end offset of the i-th output record of a trace in the converted UTF-8 data, and when it was recorded.
+struct TraceChunk
+{
+    uint64_t timestamp;
+    size_t end;
+};
+
 static HANDLE g_stdout;
 static HANDLE g_stderr;
 static UINT g_console_cp_old;
@@ -408,6 +423,82 @@ static char* allocate(size_t size)
     print_last_error("allocate memory");
 }
 
+// Extracts the output records of a DebugTap trace (see DebugTapTrace.h) and converts them to UTF-8.
+// `dst` must have room for 2 bytes per byte of `data` and `chunks` for one entry per record header.
+// Returns the number of bytes written to `dst`.
+static size_t convert_trace(const char* data, size_t size, char* dst, TraceChunk* chunks, size_t& chunk_count)
+{
+    if (size < sizeof(DebugTapTrace::Magic))
+    {
+        eprintf("not a DebugTap trace\r\n");
+    }
+    for (size_t i = 0; i < sizeof(DebugTapTrace::Magic); ++i)
+    {
+        if (data[i] != DebugTapTrace::Magic[i])
+        {
+            eprintf("not a DebugTap trace\r\n");
+        }
+    }
+
+    size_t written = 0;
+    chunk_count = 0;
+
+    for (auto p = data + sizeof(DebugTapTrace::Magic), end = data + size; static_cast<size_t>(end - p) >= sizeof(DebugTapTrace::RecordHeader);)
+    {
+        DebugTapTrace::RecordHeader header;
+        memcpy(&header, p, sizeof(header));
+        p += sizeof(header);
+
+        // The recording may have been cut off in the middle of a record.
+        if (header.size > static_cast<size_t>(end - p))
+        {
+            break;
+        }
+
+        if (header.type == DebugTapTrace::RecordType::Output && header.size >= sizeof(wchar_t))
+        {
+            // UTF-16 to UTF-8 needs at most 3 bytes per 2 bytes of input, so this can't run out of space.
+            const auto length = WideCharToMultiByte(CP_UTF8, 0, reinterpret_cast<const wchar_t*>(p), static_cast<int>(header.size / sizeof(wchar_t)), dst + written, static_cast<int>(min<size_t>(header.size * 2, INT_MAX)), nullptr, nullptr);
+            written += static_cast<size_t>(length);
+            chunks[chunk_count++] = { header.timestamp, written };
+        }
+
+        p += header.size;
+    }
+
+    return written;
+}
+
+// Writes the converted output of a trace, each chunk not before the time it was originally received.
+static void write_trace_realtime(HANDLE stdout, const char* data, const TraceChunk* chunks, size_t chunk_count, const LARGE_INTEGER& frequency)
+{
+    LARGE_INTEGER beg, now;
+    QueryPerformanceCounter(&beg);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < chunk_count; ++i)
+    {
+        const auto target_us = chunks[i].timestamp - chunks[0].timestamp;
+
+        for (;;)
+        {
+            QueryPerformanceCounter(&now);
+            const auto elapsed_us = static_cast<uint64_t>(((now.QuadPart - beg.QuadPart) * 1'000'000) / frequency.QuadPart);
+            if (elapsed_us >= target_us)
+            {
+                break;
+            }
+            Sleep(static_cast<DWORD>((target_us - elapsed_us) / 1000));
+        }
+
+        if (!WriteFile(stdout, data + offset, static_cast<DWORD>(chunks[i].end - offset), nullptr, nullptr))
+        {
+            print_last_error("write");
+        }
+        offset = chunks[i].end;
+    }
+}
+
 static BOOL WINAPI consoleCtrlHandler(DWORD)
 {
     CancelIoEx(g_stdout, nullptr);
@@ -427,6 +518,7 @@ int __stdcall main() noexcept
     uint32_t chunk_size = 128 * 1024;
     uint32_t repeat = 1;
     VtMode vt = VtMode::Off;
+    TraceMode trace = TraceMode::Off;
     uint64_t seed = 0;
     bool has_seed = false;
 
@@ -461,6 +553,18 @@ int __stdcall main() noexcept
                     break;
                 }
             }
+            else if (const auto suffix = split_prefix(argv[i], L"-t"))
+            {
+                trace = TraceMode::MaxSpeed;
+                if (has_suffix(suffix, L"r"))
+                {
+                    trace = TraceMode::RealTime;
+                }
+                else if (*suffix)
+                {
+                    break;
+                }
+            }
             else if (has_suffix(argv[i], L"-s"))
             {
                 seed = parse_number_with_suffix(suffix);
@@ -484,6 +588,8 @@ int __stdcall main() noexcept
             "  -v        enable VT\r\n"
             "  -vi       print as italic\r\n"
             "  -vc       print colorized\r\n"
+            "  -t        replay the output of a DebugTap trace (implies -v)\r\n"
+            "  -tr       same, but at the original speed\r\n"
             "  -c{d}{u}  chunk size, defaults to 128Ki\r\n"
             "  -r{d}{u}  repeats, defaults to 1\r\n"
             "  -s{d}     RNG seed\r\n"
@@ -557,6 +663,18 @@ int __stdcall main() noexcept
         }
     }
 
+    TraceChunk* trace_chunks = nullptr;
+    size_t trace_chunk_count = 0;
+
+    if (trace != TraceMode::Off)
+    {
+        // A trace is a recording of a VT session, so none of the other VT modes apply.
+        vt = VtMode::On;
+        stdout_data = allocate(file_size * 2 + 1);
+        trace_chunks = reinterpret_cast<TraceChunk*>(allocate((file_size / sizeof(DebugTapTrace::RecordHeader) + 1) * sizeof(TraceChunk)));
+        stdout_size = convert_trace(file_data, file_size, stdout_data, trace_chunks, trace_chunk_count);
+    }
+
     switch (vt)
     {
     case VtMode::Italic:
@@ -637,6 +755,12 @@ int __stdcall main() noexcept
 
     for (size_t iteration = 0; iteration < repeat; ++iteration)
     {
+        if (trace == TraceMode::RealTime)
+        {
+            write_trace_realtime(stdout, stdout_data, trace_chunks, trace_chunk_count, frequency);
+            continue;
+        }
+
         auto write_data = stdout_data;
         DWORD written = 0;
 
@@ -43,7 +43,7 @@
 //   https://www.unicode.org/Public/UCD/latest/ucd/auxiliary/GraphemeBreakTest.html
 
 // Generated by GraphemeTableGen
-// on 2024-08-29T16:50:58Z, from Unicode 15.1.0, 9109 bytes
+// on 2026-10-14T11:44:21Z, from Unicode 15.1.0, 20981 bytes
 // clang-format off
 static constexpr uint16_t s_stage0[] = {
     0x0000, 0x0020, 0x0040, 0x0060, 0x0080, 0x009f, 0x00bf, 0x00ca, 0x00ca, 0x00d3, 0x00ca, 0x00ca, 0x00ca, 0x00ca, 0x00ca, 0x00ca,
@@ -655,14 +655,401 @@ static constexpr uint32_t s_joinRules[2][16] = {
         0b00000000000000000000000000000000,
     },
 };
+static constexpr uint16_t s_bmpStage0[] = {
+    0x0000, 0x0020, 0x0020, 0x0040, 0x0000, 0x0060, 0x0080, 0x00a0, 0x00c0, 0x00e0, 0x0100, 0x0120, 0x0020, 0x0020, 0x0140, 0x0020,
+    0x0020, 0x0020, 0x0160, 0x0180, 0x0020, 0x0020, 0x01a0, 0x0020, 0x01c0, 0x01c0, 0x01c0, 0x01e0, 0x0200, 0x0220, 0x0240, 0x0020,
+    0x0260, 0x0280, 0x02a0, 0x0020, 0x02c0, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x02e0, 0x0300, 0x0320, 0x0020,
+    0x0340, 0x0020, 0x0360, 0x0380, 0x0020, 0x0020, 0x03a0, 0x03c0, 0x03e0, 0x0400, 0x0420, 0x0020, 0x0020, 0x0440, 0x0020, 0x0460,
+    0x0480, 0x04a0, 0x04c0, 0x0020, 0x04e0, 0x0020, 0x0500, 0x0520, 0x0540, 0x0560, 0x0580, 0x05a0, 0x05c0, 0x05e0, 0x0600, 0x0620,
+    0x0640, 0x0660, 0x0680, 0x06a0, 0x06c0, 0x06e0, 0x0700, 0x0720, 0x05c0, 0x0740, 0x0760, 0x0780, 0x07a0, 0x07c0, 0x07e0, 0x0020,
+    0x0800, 0x0820, 0x0840, 0x0860, 0x0880, 0x08a0, 0x08c0, 0x08e0, 0x0900, 0x0920, 0x0940, 0x0860, 0x0880, 0x0020, 0x0960, 0x0980,
+    0x0020, 0x09a0, 0x09c0, 0x0020, 0x0020, 0x09e0, 0x0a00, 0x0020, 0x0a20, 0x0a40, 0x0020, 0x0a60, 0x0a80, 0x0aa0, 0x0ac0, 0x0020,
+    0x0020, 0x0ae0, 0x0b00, 0x0b20, 0x0b40, 0x0020, 0x0020, 0x0020, 0x0b60, 0x0b60, 0x0b60, 0x0b80, 0x0b80, 0x0ba0, 0x0bc0, 0x0bc0,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0be0, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0c00, 0x0c20, 0x0c40, 0x0c40, 0x0020, 0x0c60, 0x0c80, 0x0020,
+    0x0ca0, 0x0020, 0x0020, 0x0020, 0x0cc0, 0x0ce0, 0x0020, 0x0020, 0x0020, 0x0d00, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0d20, 0x0020, 0x0d40, 0x0d60, 0x0020, 0x0400, 0x0d80, 0x0020, 0x0da0, 0x0dc0, 0x0de0, 0x0e00, 0x0e20, 0x0e40, 0x0020, 0x0e60,
+    0x0020, 0x0e80, 0x0020, 0x0020, 0x0020, 0x0020, 0x0ea0, 0x0ec0, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x01c0, 0x01c0,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0ee0, 0x0f00, 0x0f20, 0x0f40, 0x0f60, 0x0f80, 0x0400, 0x0fa0, 0x0fc0, 0x0fe0, 0x1000, 0x1020, 0x1040, 0x1060, 0x1080, 0x10a0,
+    0x10c0, 0x10e0, 0x1100, 0x1120, 0x1140, 0x1160, 0x0020, 0x0020, 0x1180, 0x11a0, 0x0020, 0x0020, 0x11c0, 0x0020, 0x11e0, 0x1200,
+    0x0020, 0x0020, 0x0020, 0x0280, 0x0280, 0x0280, 0x1220, 0x1240, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x1260, 0x1280, 0x12a0,
+    0x12c0, 0x12e0, 0x1300, 0x1320, 0x1340, 0x1360, 0x1380, 0x13a0, 0x13c0, 0x13e0, 0x1400, 0x1420, 0x1440, 0x1460, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x1480, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x14a0, 0x0020, 0x14c0, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x14e0, 0x0020, 0x0020, 0x0020, 0x1500, 0x0020, 0x0020, 0x0020, 0x01c0,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x1520, 0x1540, 0x1540, 0x1560, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1580, 0x15a0,
+    0x1540, 0x15c0, 0x15e0, 0x1540, 0x1600, 0x1540, 0x1540, 0x1540, 0x1620, 0x1640, 0x1540, 0x1540, 0x1660, 0x1540, 0x1540, 0x1680,
+    0x16a0, 0x1540, 0x16c0, 0x1540, 0x16e0, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x0020, 0x0020,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1700, 0x1540, 0x1720, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x1740, 0x1760, 0x0020, 0x0020, 0x1780, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x17a0, 0x17c0, 0x0020, 0x0020, 0x17e0, 0x1800, 0x1820, 0x1840, 0x0020, 0x1860, 0x1880, 0x18a0, 0x18c0, 0x18e0, 0x1900, 0x1920,
+    0x0020, 0x1940, 0x1960, 0x1980, 0x0020, 0x19a0, 0x19c0, 0x19e0, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x1a00,
+    0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40,
+    0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80,
+    0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0,
+    0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20,
+    0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60,
+    0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0,
+    0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0,
+    0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40,
+    0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80,
+    0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0,
+    0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20,
+    0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60,
+    0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0,
+    0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0,
+    0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40,
+    0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80,
+    0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0,
+    0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20,
+    0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60,
+    0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0,
+    0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0,
+    0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1ae0, 0x1a20, 0x1a40, 0x1a60, 0x1a80, 0x1aa0, 0x1ac0, 0x1b00, 0x1b20, 0x1b40,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280,
+    0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x0280, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540,
+    0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1540, 0x1b60, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020, 0x0020,
+    0x1b80, 0x1ba0, 0x1bc0, 0x1be0, 0x0020, 0x0020, 0x0020, 0x1c00, 0x15e0, 0x1540, 0x1540, 0x1c20, 0x07c0, 0x0020, 0x0020, 0x1c40,
+};
+static constexpr uint8_t s_bmpStage1[] = {
+    0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x41,
+    0x40, 0xc0, 0x40, 0x40, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0x4c, 0xc0, 0x40, 0x40, 0x01, 0xcc, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0xc0,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0,
+    0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0x40, 0xc0, 0x40,
+    0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0,
+    0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0x40, 0xc0,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0,
+    0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0,
+    0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0,
+    0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0,
+    0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x02,
+    0x40, 0x02, 0x02, 0x40, 0x02, 0x02, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x01, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x04, 0x40, 0x02,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x02, 0x02, 0x40, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x04, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x04, 0x04, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x04, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b,
+    0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x02, 0x42, 0x02, 0x40, 0x42, 0x42,
+    0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x42, 0x42, 0x42, 0x42, 0x0a, 0x42, 0x42, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b,
+    0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b,
+    0x40, 0x02, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b,
+    0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x4b, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x40, 0x02, 0x40, 0x42, 0x42,
+    0x42, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x42, 0x42, 0x40, 0x40, 0x42, 0x42, 0x0a, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x40, 0x4b,
+    0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40,
+    0x40, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x42, 0x42,
+    0x42, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b,
+    0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x4b, 0x4b, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x40, 0x02, 0x40, 0x42, 0x42,
+    0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x42, 0x40, 0x42, 0x42, 0x0a, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x4b, 0x4b, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x40, 0x02, 0x40, 0x42, 0x02,
+    0x42, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x42, 0x42, 0x40, 0x40, 0x42, 0x42, 0x0a, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x40, 0x4b,
+    0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x42,
+    0x02, 0x42, 0x42, 0x40, 0x40, 0x40, 0x42, 0x42, 0x42, 0x40, 0x42, 0x42, 0x42, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x02, 0x42, 0x42, 0x42, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b,
+    0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x40, 0x40, 0x02, 0x40, 0x02, 0x02,
+    0x02, 0x42, 0x42, 0x42, 0x42, 0x40, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x02, 0x0a, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x40, 0x4b, 0x4b, 0x4b, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x02, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x42, 0x02,
+    0x42, 0x42, 0x42, 0x42, 0x42, 0x40, 0x02, 0x42, 0x42, 0x40, 0x42, 0x42, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x02, 0x02, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b,
+    0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x4b, 0x02, 0x02, 0x40, 0x42, 0x42,
+    0x42, 0x02, 0x02, 0x02, 0x02, 0x40, 0x42, 0x42, 0x42, 0x40, 0x42, 0x42, 0x42, 0x0a, 0x44, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x42, 0x42, 0x42, 0x02, 0x02, 0x02, 0x40, 0x02, 0x40, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x42, 0x42,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x42,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x42, 0x42, 0x02, 0x02, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x42, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02,
+    0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x02, 0x40, 0x42, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40,
+    0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85,
+    0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46,
+    0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47,
+    0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x42, 0x42,
+    0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x02, 0x42, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x01, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x02, 0x02, 0x02, 0x42, 0x42, 0x42, 0x42, 0x02, 0x02, 0x42, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x42, 0x42, 0x02, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x42, 0x42, 0x02, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x02, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40,
+    0x02, 0x40, 0x02, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x02,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x02, 0x02, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x42, 0x02, 0x42, 0x42, 0x42,
+    0x42, 0x42, 0x02, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x42, 0x02, 0x02, 0x02, 0x02, 0x42, 0x42, 0x02, 0x02, 0x42, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x42, 0x02, 0x02, 0x42, 0x42, 0x42, 0x02, 0x42, 0x02, 0x02, 0x02, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x42, 0x42, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+    0x02, 0x42, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x42, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x01, 0x02, 0x0d, 0x01, 0x01, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40,
+    0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x41, 0x41, 0x01, 0x01, 0x01, 0x01, 0x01, 0x40, 0xc0, 0x40, 0xc0, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x4c, 0x40, 0xc0, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x41, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0,
+    0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0xc0, 0xcc, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40,
+    0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0xc0, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0xc0,
+    0xc0, 0x40, 0x40, 0xc0, 0x40, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0xc0, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x8c, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x80, 0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x8c, 0x8c, 0x8c, 0x4c, 0x4c, 0x4c, 0x8c, 0x4c, 0x4c, 0x8c, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x4c, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0xc0, 0xc0, 0xcc, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0,
+    0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0,
+    0xc0, 0xc0, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x4c, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40, 0xcc, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0x40, 0x40,
+    0xcc, 0xc0, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0xc0, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x4c, 0x8c, 0x8c, 0x40,
+    0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0xcc, 0xc0, 0x4c, 0x4c, 0xcc, 0x4c, 0x4c, 0x4c, 0x4c, 0xcc, 0xcc, 0x4c, 0x4c, 0x4c, 0x40, 0x8c, 0x8c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0xcc, 0x4c, 0xcc, 0x4c,
+    0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c,
+    0xcc, 0x4c, 0xcc, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x8c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c,
+    0xcc, 0xcc, 0x4c, 0xcc, 0xcc, 0xcc, 0x4c, 0xcc, 0xcc, 0xcc, 0xcc, 0x4c, 0xcc, 0xcc, 0x4c, 0xcc, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x8c,
+    0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x4c, 0x4c, 0x8c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0xcc, 0xcc,
+    0x4c, 0x8c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x8c, 0x8c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x8c, 0x8c, 0xcc,
+    0x4c, 0x4c, 0x4c, 0x4c, 0x8c, 0x8c, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0x8c, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0x8c, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc,
+    0xcc, 0xcc, 0x4c, 0xcc, 0x4c, 0x4c, 0x4c, 0x4c, 0xcc, 0xcc, 0x8c, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0xcc, 0x8c, 0x8c, 0xcc, 0x8c, 0xcc, 0xcc, 0xcc, 0xcc, 0x8c, 0xcc, 0xcc, 0x8c, 0xcc, 0xcc,
+    0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x8c, 0x40, 0x40, 0x4c, 0x4c, 0x8c, 0x8c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x40, 0x4c, 0x40, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x40, 0x40,
+    0x40, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x4c, 0x40, 0x40, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x40, 0x8c, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x8c, 0x8c, 0x40, 0x8c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x4c, 0x4c, 0x4c, 0x4c, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x8c, 0x8c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x8c,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x4c, 0x4c, 0x4c, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x8c, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x8c, 0x40, 0x40, 0x40, 0x40, 0x8c, 0xc0, 0xc0, 0xc0, 0xc0, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x02, 0x02, 0x02, 0x02, 0x82, 0x82, 0x8c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x8c, 0x80, 0x40,
+    0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x02, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0xc0, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x8c, 0x80, 0x8c, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x42, 0x42, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42,
+    0x42, 0x42, 0x42, 0x42, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x85, 0x40, 0x40, 0x40,
+    0x02, 0x02, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x42, 0x42, 0x02, 0x02, 0x02, 0x02, 0x42, 0x42, 0x02, 0x02, 0x42, 0x42,
+    0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x42, 0x42, 0x02, 0x02, 0x42, 0x42, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40, 0x02, 0x02, 0x02, 0x40, 0x40, 0x02, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x02,
+    0x40, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x02, 0x02, 0x42, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x42, 0x42, 0x02, 0x42, 0x42, 0x02, 0x42, 0x42, 0x40, 0x42, 0x02, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x88, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x88, 0x89, 0x89, 0x89,
+    0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x88, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89,
+    0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x88, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89,
+    0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x88, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89,
+    0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x88, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89,
+    0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x88, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89,
+    0x89, 0x89, 0x89, 0x89, 0x88, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89, 0x89,
+    0x89, 0x89, 0x89, 0x89, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46,
+    0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x46, 0x40, 0x40, 0x40, 0x40, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47,
+    0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x47, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x02, 0x40,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x01,
+    0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x01, 0x01, 0x01, 0x40, 0xc0, 0x40, 0x40,
+};
+static constexpr uint32_t s_bmpUniformWidths[] = {
+    0x45000014, 0x40004505, 0x4055544c, 0x11400504, 0x00000440, 0x40000000, 0x04000000, 0x40104141,
+    0x00005401, 0x55455555, 0x55555555, 0x41005555, 0x55515054, 0x10004104, 0x05550551, 0x55555555,
+    0x00000000, 0x04505000, 0x01550fd5, 0x50000000, 0x55515555, 0x55445555, 0x15151555, 0x0aaa2855,
+    0x28a0a882, 0xaaaaa888, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa,
+    0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0x5aaaaaaa, 0xaaaaaaaa,
+    0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa,
+    0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa,
+    0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa,
+    0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa,
+    0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa, 0xaaaaaaaa,
+    0xaaaaaaaa, 0xaaaaaaaa, 0x555548aa, 0x55551415, 0x00010050, 0x15550101, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+    0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff,
+    0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xaaaaffff, 0x5554aaaa, 0x55555555, 0x14281500,
+};
 constexpr int ucdLookup(const char32_t cp) noexcept
 {
+    if (cp < 0x10000)
+    {
+        return s_bmpStage1[s_bmpStage0[cp >> 5] + (cp & 31)];
+    }
     const auto s0 = s_stage0[cp >> 11];
     const auto s1 = s_stage1[s0 + ((cp >> 6) & 31)];
     const auto s2 = s_stage2[s1 + ((cp >> 3) & 7)];
     const auto s3 = s_stage3[s2 + ((cp >> 0) & 7)];
     return s3;
 }
+// Returns the CharacterWidth that all codepoints in the BMP page of `ch` share, if all of them are of ClusterBreak Other,
+// and 0 otherwise. Such codepoints never join with each other or printable ASCII. 3 means ambiguous, as above.
+constexpr int ucdUniformWidth(const wchar_t ch) noexcept
+{
+    return (s_bmpUniformWidths[ch >> 9] >> ((ch >> 4) & 30)) & 3;
+}
 constexpr int ucdGraphemeJoins(const int state, const int lead, const int trail) noexcept
 {
     const auto l = lead & 15;
@@ -759,6 +1146,20 @@ constexpr const wchar_t* resetIfOutOfRange(const wchar_t* beg, const wchar_t* en
     return ret;
 }
 
+// Returns true for U+0020 to U+007E.
+constexpr bool isPrintableAscii(const wchar_t ch) noexcept
+{
+    return static_cast<wchar_t>(ch - 0x20) < 0x5f;
+}
+
+// Returns the CharacterWidth of `ch` if it's guaranteed to form a cluster of its own, as long as it's followed by
+// another such character. That's the case for printable ASCII and the BMP pages that ucdUniformWidth() knows about
+// (CJK ideographs, fullwidth forms, etc.). Returns 0 otherwise, in which case the regular segmentation must be used.
+constexpr int isolatedWidth(const wchar_t ch) noexcept
+{
+    return isPrintableAscii(ch) ? 1 : ucdUniformWidth(ch);
+}
+
 static CodepointWidthDetector s_codepointWidthDetector;
 
 CodepointWidthDetector& CodepointWidthDetector::Singleton() noexcept
@@ -792,6 +1193,54 @@ bool CodepointWidthDetector::GraphemePrev(GraphemeState& s, const std::wstring_v
     return _graphemePrevConsole(s, str);
 }
 
+// ASCII is always exactly 1 column wide and the only ASCII characters that join with their successor are CR and
+// the C0 controls, so callers can skip the grapheme segmentation for the prefix this function returns.
+// (They still need to back up by 1 character before the first non-ASCII one, in case it's a combining mark.)
+size_t CodepointWidthDetector::AsciiPrefixLength(const std::wstring_view& str) noexcept
+{
+    const auto beg = str.data();
+    const auto len = str.size();
+    auto it = beg;
+
+#if defined(TIL_SSE_INTRINSICS)
+
+    for (const auto end = beg + (len & ~size_t{ 7 }); it < end; it += 8)
+    {
+        const auto wch = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        // (wch & 0xff80) == 0 is true for all ASCII characters.
+        const auto ascii = _mm_cmpeq_epi16(_mm_and_si128(wch, _mm_set1_epi16(static_cast<short>(0xff80))), _mm_setzero_si128());
+        const auto mask = static_cast<unsigned long>(_mm_movemask_epi8(ascii)) ^ 0xffff;
+
+        if (mask)
+        {
+            unsigned long offset;
+            _BitScanForward(&offset, mask);
+            return gsl::narrow_cast<size_t>(it - beg) + offset / 2;
+        }
+    }
+
+#elif defined(TIL_ARM_NEON_INTRINSICS)
+
+    // NEON lacks a movemask, so we only skip over blocks of 8 that are entirely ASCII
+    // and let the scalar loop below find the exact position within the last one.
+    for (const auto end = beg + (len & ~size_t{ 7 }); it < end; it += 8)
+    {
+        if (vmaxvq_u16(vld1q_u16(it)) >= 0x80)
+        {
+            break;
+        }
+    }
+
+#endif
+
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    for (const auto end = beg + len; it < end && *it < 0x80; ++it)
+    {
+    }
+
+    return gsl::narrow_cast<size_t>(it - beg);
+}
+
 // Parses the next grapheme cluster from the given string. The algorithm largely follows "UAX #29: Unicode Text Segmentation",
 // but takes some mild liberties. Returns false if the end of the string was reached. Updates `s` with the cluster.
 bool CodepointWidthDetector::_graphemeNext(GraphemeState& s, const std::wstring_view& str) const noexcept
@@ -808,6 +1257,23 @@ bool CodepointWidthDetector::_graphemeNext(GraphemeState& s, const std::wstring_
 
     auto clusterEnd = clusterBeg;
 
+    // Fast path for characters that are followed by a character that can't join with them, like printable ASCII
+    // followed by more printable ASCII, or a CJK ideograph followed by another one. This skips the UCD lookups
+    // and the segmentation for the most common input by far, as long as we're not continuing a cluster from the
+    // previous string. The width comes from a single load from a table that fits into a couple cache lines.
+    if (state == 0 && end - clusterEnd >= 2)
+    {
+        if (const auto w = isolatedWidth(clusterEnd[0]); w && isolatedWidth(clusterEnd[1]))
+        {
+            s.beg = clusterBeg;
+            s.len = 1;
+            s.width = w == 3 ? _ambiguousWidth : w;
+            s._state = 0;
+            s._last = 0;
+            return true;
+        }
+    }
+
     // Skip if we're already at the end.
     if (clusterEnd < end)
     {
@@ -1206,7 +1672,7 @@ bool CodepointWidthDetector::_graphemePrevConsole(GraphemeState& s, const std::w
 }
 
 // Call the function specified via SetFallbackMethod() to turn ambiguous (width = 3) into narrow/wide.
-// Caches the results in _fallbackCache.
+// Caches the results in _fallbackWidthsBMP and _fallbackCache.
 int CodepointWidthDetector::_checkFallbackViaCache(const char32_t codepoint) noexcept
 try
 {
@@ -1216,11 +1682,38 @@ try
         return 1;
     }
 
+    // Most ambiguous codepoints are in the BMP, which is what PrefillFallbackCache() resolves ahead of time.
+    // This means that the output path should usually find the answer here without calling into the renderer.
+    if (codepoint <= 0xffff)
+    {
+        auto& slot = til::at(_fallbackWidthsBMP, codepoint);
+        auto width = static_cast<int>(slot.load(std::memory_order_relaxed));
+        if (width == 0)
+        {
+            width = _queryFallback(codepoint);
+            slot.store(static_cast<uint8_t>(width), std::memory_order_relaxed);
+        }
+        return width;
+    }
+
     if (const auto it = _fallbackCache.find(codepoint); it != _fallbackCache.end())
     {
         return it->second;
     }
 
+    const auto width = _queryFallback(codepoint);
+    _fallbackCache.insert_or_assign(codepoint, width);
+    return width;
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    return 1;
+}
+
+// Returns 2 if the fallback method considers the codepoint wide and 1 otherwise.
+int CodepointWidthDetector::_queryFallback(const char32_t codepoint)
+{
     wchar_t buf[2];
     size_t len;
     if (codepoint <= 0xffff)
@@ -1235,14 +1728,56 @@ try
         len = 2;
     }
 
-    const int width = _pfnFallbackMethod({ &buf[0], len }) ? 2 : 1;
-    _fallbackCache.insert_or_assign(codepoint, width);
-    return width;
+    return _pfnFallbackMethod({ &buf[0], len }) ? 2 : 1;
+}
+
+// Method Description:
+// - Resolves the width of up to `budget` ambiguous codepoints in the BMP that aren't cached yet.
+//   This is meant to be called repeatedly from a background thread (while holding whatever lock
+//   the fallback method requires), so that the output path finds the answers in the cache and
+//   doesn't have to call into the renderer itself.
+// Arguments:
+// - generation - the value of FallbackCacheGeneration() when the prefill was started.
+//   The prefill is abandoned if Reset() got called since then, because the font may have changed.
+// - budget - the maximum number of calls to the fallback method.
+// Return Value:
+// - true if there's more work to do.
+bool CodepointWidthDetector::PrefillFallbackCache(const uint32_t generation, size_t budget) noexcept
+try
+{
+    if (!_pfnFallbackMethod || _mode != TextMeasurementMode::Console || generation != FallbackCacheGeneration())
+    {
+        return false;
+    }
+
+    for (; _prefillNext <= 0xffff && budget != 0; ++_prefillNext)
+    {
+        const auto cp = static_cast<char32_t>(_prefillNext);
+        if (ucdToCharacterWidth(ucdLookup(cp)) != 3 || (cp & 0xF800) == 0xD800)
+        {
+            continue;
+        }
+
+        auto& slot = til::at(_fallbackWidthsBMP, cp);
+        if (slot.load(std::memory_order_relaxed) == 0)
+        {
+            slot.store(static_cast<uint8_t>(_queryFallback(cp)), std::memory_order_relaxed);
+            --budget;
+        }
+    }
+
+    return _prefillNext <= 0xffff;
 }
 catch (...)
 {
     LOG_CAUGHT_EXCEPTION();
-    return 1;
+    return false;
+}
+
+// Returns a counter that gets incremented every time the fallback cache is invalidated.
+uint32_t CodepointWidthDetector::FallbackCacheGeneration() const noexcept
+{
+    return _fallbackGeneration.load(std::memory_order_relaxed);
 }
 
 TextMeasurementMode CodepointWidthDetector::GetMode() const noexcept
@@ -1269,4 +1804,10 @@ void CodepointWidthDetector::Reset(const TextMeasurementMode mode) noexcept
 {
     _mode = mode;
     _fallbackCache.clear();
+    for (auto& slot : _fallbackWidthsBMP)
+    {
+        slot.store(0, std::memory_order_relaxed);
+    }
+    _prefillNext = 0;
+    _fallbackGeneration.fetch_add(1, std::memory_order_relaxed);
 }
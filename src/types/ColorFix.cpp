@@ -209,6 +209,107 @@ COLORREF ColorFix::GetPerceivableColor(COLORREF color, COLORREF reference, float
     return linearToColorref(oklab::oklab_to_linear_srgb(colorOklab)) | (color & 0xff000000);
 }
 
+#pragma warning(push)
+#pragma warning(disable : 26446) // Prefer to use gsl::at() instead of unchecked subscript operator (bounds.4).
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+#pragma warning(disable : 26482) // Only index into arrays using constant expressions (bounds.2).
+#pragma warning(disable : 26490) // Don't use reinterpret_cast (type.1).
+
+#if defined(TIL_SSE_INTRINSICS)
+
+// The same as cbrtf_est, but for 4 floats at a time.
+__forceinline __m128 cbrtf_est(__m128 a) noexcept
+{
+    // SSE2 has no 32-bit division, so we divide by 3 by multiplying with 0xAAAAAAAB = ceil(2^33 / 3)
+    // into 64-bit intermediates and shifting right by 33. _mm_mul_epu32 only handles the even lanes at a time.
+    const auto magic = _mm_set1_epi32(static_cast<int>(0xAAAAAAAB));
+    const auto u = _mm_castps_si128(a);
+    const auto even = _mm_srli_epi64(_mm_mul_epu32(u, magic), 33);
+    const auto odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(u, 32), magic), 33);
+    const auto div3 = _mm_or_si128(even, _mm_slli_epi64(odd, 32));
+    const auto x = _mm_castsi128_ps(_mm_add_epi32(div3, _mm_set1_epi32(709921077)));
+
+    const auto xx = _mm_mul_ps(x, x);
+    return _mm_mul_ps(_mm_set1_ps(1.0f / 3.0f), _mm_add_ps(_mm_div_ps(a, xx), _mm_add_ps(x, x)));
+}
+
+// Computes the squared ΔEOK distance between 4 colors and the given reference color in Oklab space.
+__forceinline __m128 squaredDistance4(const COLORREF* colors, const oklab::Lab& reference) noexcept
+{
+    const auto lut = [&](int shift) noexcept {
+        return _mm_setr_ps(
+            srgbToRgbLUT[(colors[0] >> shift) & 0xff],
+            srgbToRgbLUT[(colors[1] >> shift) & 0xff],
+            srgbToRgbLUT[(colors[2] >> shift) & 0xff],
+            srgbToRgbLUT[(colors[3] >> shift) & 0xff]);
+    };
+    const auto madd3 = [](__m128 x, float fx, __m128 y, float fy, __m128 z, float fz) noexcept {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(fx)), _mm_mul_ps(y, _mm_set1_ps(fy))), _mm_mul_ps(z, _mm_set1_ps(fz)));
+    };
+
+    const auto r = lut(0);
+    const auto g = lut(8);
+    const auto b = lut(16);
+
+    // See oklab::linear_srgb_to_oklab.
+    const auto l_ = cbrtf_est(madd3(r, 0.4122214708f, g, 0.5363325363f, b, 0.0514459929f));
+    const auto m_ = cbrtf_est(madd3(r, 0.2119034982f, g, 0.6806995451f, b, 0.1073969566f));
+    const auto s_ = cbrtf_est(madd3(r, 0.0883024619f, g, 0.2817188376f, b, 0.6299787005f));
+
+    const auto dl = _mm_sub_ps(_mm_set1_ps(reference.l), madd3(l_, 0.2104542553f, m_, 0.7936177850f, s_, -0.0040720468f));
+    const auto da = _mm_sub_ps(_mm_set1_ps(reference.a), madd3(l_, 1.9779984951f, m_, -2.4285922050f, s_, 0.4505937099f));
+    const auto db = _mm_sub_ps(_mm_set1_ps(reference.b), madd3(l_, 0.0259040371f, m_, 0.7827717662f, s_, -0.8086757660f));
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(dl, dl), _mm_mul_ps(da, da)), _mm_mul_ps(db, db));
+}
+
+#endif
+
+// Applies GetPerceivableColor() to each of the given `colors` and writes the results to `out`,
+// which must be at least as large. Since most colors are already perceivable, the distance
+// check is vectorized and only the colors that need to be nudged take the scalar path.
+void ColorFix::GetPerceivableColors(std::span<const COLORREF> colors, COLORREF reference, float minSquaredDistance, std::span<COLORREF> out) noexcept
+{
+    assert(out.size() >= colors.size());
+
+    const auto beg = colors.data();
+    const auto len = std::min(colors.size(), out.size());
+    const auto dst = out.data();
+    size_t i = 0;
+
+#if defined(TIL_SSE_INTRINSICS)
+    const auto referenceOklab = oklab::linear_srgb_to_oklab(colorrefToLinear(reference));
+    // The vectorized math may round differently than the scalar one. Colors that are anywhere near
+    // the threshold are thus left to GetPerceivableColor, so that the results are always identical.
+    const auto minDistance = _mm_set1_ps(minSquaredDistance * 1.01f);
+
+    for (const auto end = len & ~size_t{ 3 }; i < end; i += 4)
+    {
+        const auto distance = squaredDistance4(beg + i, referenceOklab);
+        const auto mask = _mm_movemask_ps(_mm_cmplt_ps(distance, minDistance));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(beg + i)));
+
+        if (mask)
+        {
+            for (size_t j = 0; j < 4; ++j)
+            {
+                if (mask & (1 << j))
+                {
+                    dst[i + j] = GetPerceivableColor(beg[i + j], reference, minSquaredDistance);
+                }
+            }
+        }
+    }
+#endif
+
+    for (; i < len; ++i)
+    {
+        dst[i] = GetPerceivableColor(beg[i], reference, minSquaredDistance);
+    }
+}
+
+#pragma warning(pop)
+
 float ColorFix::GetLuminosity(COLORREF color) noexcept
 {
     return oklab::linear_srgb_to_oklab(colorrefToLinear(color)).l;
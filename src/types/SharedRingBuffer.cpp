@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inc/SharedRingBuffer.hpp"
+
+using namespace Microsoft::Console::Utils;
+
+// The producer and consumer fields live on separate cache lines,
+// so that the two processes don't keep stealing them from each other.
+struct SharedRingBuffer::Header
+{
+    static constexpr uint32_t Magic = 0x474e5243; // "CRNG"
+
+    uint32_t magic;
+    uint32_t capacity;
+
+    // Written by the producer.
+    alignas(64) std::atomic<uint64_t> write;
+    std::atomic<uint32_t> readerWaiting;
+    std::atomic<uint32_t> producerClosed;
+
+    // Written by the consumer.
+    alignas(64) std::atomic<uint64_t> read;
+    std::atomic<uint32_t> writerWaiting;
+    std::atomic<uint32_t> consumerClosed;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomics in shared memory must be lock-free");
+
+// Creates a new ring as its consumer. The returned handles aren't inheritable.
+SharedRingBuffer SharedRingBuffer::Create(uint32_t capacity)
+{
+    THROW_HR_IF(E_INVALIDARG, !std::has_single_bit(capacity) || capacity > MaxCapacity);
+
+    SharedRingBuffer ring;
+    ring._section.reset(CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(Header) + capacity, nullptr));
+    THROW_LAST_ERROR_IF(!ring._section);
+    ring._dataEvent.create(wil::EventOptions::None);
+    ring._spaceEvent.create(wil::EventOptions::None);
+
+    ring._view.reset(MapViewOfFile(ring._section.get(), FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0));
+    THROW_LAST_ERROR_IF(!ring._view);
+
+    // Pagefile-backed sections are zero-initialized, which is all the atomics need.
+    const auto header = static_cast<Header*>(ring._view.get());
+    header->magic = Header::Magic;
+    header->capacity = capacity;
+
+    ring._map();
+    return ring;
+}
+
+// Opens a ring that was created by the other side as its producer.
+SharedRingBuffer SharedRingBuffer::Open(wil::unique_handle section, wil::unique_event dataEvent, wil::unique_event spaceEvent)
+{
+    SharedRingBuffer ring;
+    ring._section = std::move(section);
+    ring._dataEvent = std::move(dataEvent);
+    ring._spaceEvent = std::move(spaceEvent);
+    ring._producer = true;
+
+    ring._view.reset(MapViewOfFile(ring._section.get(), FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0));
+    THROW_LAST_ERROR_IF(!ring._view);
+
+    ring._map();
+    return ring;
+}
+
+// Validates the header against the size of the mapping, now that it's mapped.
+void SharedRingBuffer::_map()
+{
+    MEMORY_BASIC_INFORMATION info{};
+    THROW_LAST_ERROR_IF(!VirtualQuery(_view.get(), &info, sizeof(info)));
+
+    const auto header = static_cast<Header*>(_view.get());
+    THROW_HR_IF(E_INVALIDARG, info.RegionSize < sizeof(Header));
+
+    const auto capacity = header->capacity;
+    THROW_HR_IF(E_INVALIDARG, header->magic != Header::Magic || !std::has_single_bit(capacity) || capacity > MaxCapacity);
+    THROW_HR_IF(E_INVALIDARG, sizeof(Header) + capacity > info.RegionSize);
+
+    _header = header;
+    _data = reinterpret_cast<char*>(header + 1);
+    _capacity = capacity;
+}
+
+SharedRingBuffer::operator bool() const noexcept
+{
+    return _header != nullptr;
+}
+
+SharedRingBuffer::Handles SharedRingBuffer::GetHandles() const noexcept
+{
+    return { _section.get(), _dataEvent.get(), _spaceEvent.get() };
+}
+
+// Marks our side as gone and wakes up the other side, in case it's waiting for us.
+void SharedRingBuffer::Close() noexcept
+{
+    if (!_header)
+    {
+        return;
+    }
+
+    (_producer ? _header->producerClosed : _header->consumerClosed).store(1, std::memory_order_seq_cst);
+    _dataEvent.SetEvent();
+    _spaceEvent.SetEvent();
+}
+
+bool SharedRingBuffer::IsPeerClosed() const noexcept
+{
+    return (_producer ? _header->consumerClosed : _header->producerClosed).load(std::memory_order_acquire) != 0;
+}
+
+// Copies as much of `data` into the ring as possible, waiting up to `timeout`
+// milliseconds each time the ring is full. Returns the number of bytes written,
+// which is less than data.size() if the wait timed out or the consumer is gone.
+size_t SharedRingBuffer::Write(std::string_view data, DWORD timeout) noexcept
+{
+    size_t written = 0;
+
+    while (written < data.size())
+    {
+        const auto write = _header->write.load(std::memory_order_relaxed);
+        auto read = _header->read.load(std::memory_order_acquire);
+
+        if (write - read >= _capacity)
+        {
+            if (IsPeerClosed())
+            {
+                break;
+            }
+
+            // Announce that we'll wait and check again, in case the consumer
+            // made space before it had a chance to see our announcement.
+            _header->writerWaiting.store(1, std::memory_order_seq_cst);
+            read = _header->read.load(std::memory_order_seq_cst);
+
+            if (write - read >= _capacity && WaitForSingleObject(_spaceEvent.get(), timeout) != WAIT_OBJECT_0)
+            {
+                break;
+            }
+            continue;
+        }
+
+        const auto available = _capacity - gsl::narrow_cast<uint32_t>(write - read);
+        const auto count = std::min<size_t>(available, data.size() - written);
+        const auto offset = gsl::narrow_cast<size_t>(write & (_capacity - 1));
+        const auto first = std::min<size_t>(count, _capacity - offset);
+
+        memcpy(_data + offset, data.data() + written, first);
+        memcpy(_data, data.data() + written + first, count - first);
+
+        _header->write.store(write + count, std::memory_order_seq_cst);
+        if (_header->readerWaiting.exchange(0, std::memory_order_seq_cst))
+        {
+            _dataEvent.SetEvent();
+        }
+
+        written += count;
+    }
+
+    return written;
+}
+
+// Returns the contiguous readable bytes at the read position. If the readable region wraps
+// around the end of the ring, this only returns the part up to the end. Call Consume()
+// and then Peek() again to get the rest.
+std::string_view SharedRingBuffer::Peek() const noexcept
+{
+    const auto read = _header->read.load(std::memory_order_relaxed);
+    const auto write = _header->write.load(std::memory_order_acquire);
+
+    // We don't trust the producer to keep the positions sane.
+    const auto readable = std::min<uint64_t>(write - read, _capacity);
+    const auto offset = gsl::narrow_cast<size_t>(read & (_capacity - 1));
+    const auto count = std::min<size_t>(gsl::narrow_cast<size_t>(readable), _capacity - offset);
+    return { _data + offset, count };
+}
+
+void SharedRingBuffer::Consume(size_t count) noexcept
+{
+    const auto read = _header->read.load(std::memory_order_relaxed);
+    _header->read.store(read + count, std::memory_order_seq_cst);
+
+    if (_header->writerWaiting.exchange(0, std::memory_order_seq_cst))
+    {
+        _spaceEvent.SetEvent();
+    }
+}
+
+// Announces that the consumer is about to wait for the data event. Returns false
+// if data arrived in the meantime, in which case the caller shouldn't wait.
+bool SharedRingBuffer::PrepareWait() noexcept
+{
+    _header->readerWaiting.store(1, std::memory_order_seq_cst);
+
+    if (_header->write.load(std::memory_order_seq_cst) != _header->read.load(std::memory_order_relaxed))
+    {
+        _header->readerWaiting.store(0, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
@@ -785,7 +785,7 @@ try
         // So instead, we'll use GetCurrentAttributes to get an idea of the default
         // text attributes used. And return a result based off of that.
         const auto attr{ IsDegenerate() ? _pData->GetTextBuffer().GetCurrentAttributes() :
-                                          _pData->GetTextBuffer().GetCellDataAt(_start)->TextAttr() };
+                                          _pData->GetTextBuffer().GetRowByOffset(_start.y).GetAttrByColumn(_start.x) };
         if (!_initializeAttrQuery(attributeId, pRetVal, attr))
         {
             // The AttributeID is not supported.
@@ -812,21 +812,24 @@ try
     const auto bufferSize{ buffer.GetSize() };
     const auto inclusiveEnd{ _getInclusiveEnd() };
 
-    // Check if the entire text range has that text attribute
-#pragma warning(suppress : 26496) // TRANSITIONAL: false positive in VS 16.11
-    auto viewportRange{ bufferSize };
+    // Check if the entire text range has that text attribute.
+    // We walk the attribute runs of each row instead of every cell individually,
+    // covering the same cells as before: everything from _start up to (excluding) inclusiveEnd.
+    auto columnLeft{ bufferSize.Left() };
+    auto columnRight{ bufferSize.RightExclusive() };
     if (_blockRange)
     {
-        const auto originX{ std::min(_start.x, inclusiveEnd.x) };
-        const auto originY{ std::min(_start.y, inclusiveEnd.y) };
-        const auto width{ std::abs(inclusiveEnd.x - _start.x + 1) };
-        const auto height{ std::abs(inclusiveEnd.y - _start.y + 1) };
-        viewportRange = Viewport::FromDimensions({ originX, originY }, { width, height });
+        columnLeft = std::min(_start.x, inclusiveEnd.x);
+        columnRight = columnLeft + std::abs(inclusiveEnd.x - _start.x + 1);
     }
-    auto iter{ buffer.GetCellDataAt(_start, viewportRange) };
-    for (; iter && iter.Pos() != inclusiveEnd; ++iter)
+    for (auto y = _start.y; y <= inclusiveEnd.y; ++y)
     {
-        if (!_verifyAttr(attributeId, *pRetVal, iter->TextAttr()).value())
+        const auto columnBegin = y == _start.y ? _start.x : columnLeft;
+        const auto columnEnd = y == inclusiveEnd.y ? inclusiveEnd.x : columnRight;
+        const auto uniform = buffer.GetRowByOffset(y).ForEachAttributeRun(columnBegin, columnEnd, [&](const TextAttribute& attr, auto, auto) {
+            return _verifyAttr(attributeId, *pRetVal, attr).value();
+        });
+        if (!uniform)
         {
             // The value of the specified attribute varies over the text range
             // return UiaGetReservedMixedAttributeValue.
@@ -993,8 +996,10 @@ std::wstring UiaTextRangeBase::_getTextValue(til::CoordType maxLength) const
         auto inclusiveEnd = _end;
         bufferSize.DecrementInBounds(inclusiveEnd, true);
 
+        // Screen readers commonly ask for just the first few characters of large ranges,
+        // so we stop reading the buffer as soon as we have enough.
         const auto req = TextBuffer::CopyRequest{ buffer, _start, inclusiveEnd, _blockRange, true, false, false, true };
-        auto plainText = buffer.GetPlainText(req);
+        auto plainText = buffer.GetPlainText(req, maxLengthAsSize);
 
         if (plainText.size() > maxLengthAsSize)
         {
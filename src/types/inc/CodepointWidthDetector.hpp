@@ -51,6 +51,9 @@ struct CodepointWidthDetector
 {
     static CodepointWidthDetector& Singleton() noexcept;
 
+    // Returns the number of leading characters in `str` that are ASCII (< 0x80).
+    static size_t AsciiPrefixLength(const std::wstring_view& str) noexcept;
+
     // Returns false if the end of the string has been reached.
     bool GraphemeNext(GraphemeState& s, const std::wstring_view& str) noexcept;
     bool GraphemePrev(GraphemeState& s, const std::wstring_view& str) noexcept;
@@ -59,6 +62,9 @@ struct CodepointWidthDetector
     void SetFallbackMethod(std::function<bool(const std::wstring_view&)> pfnFallback) noexcept;
     void Reset(TextMeasurementMode mode) noexcept;
 
+    bool PrefillFallbackCache(uint32_t generation, size_t budget) noexcept;
+    uint32_t FallbackCacheGeneration() const noexcept;
+
 private:
     bool _graphemeNext(GraphemeState& s, const std::wstring_view& str) const noexcept;
     bool _graphemePrev(GraphemeState& s, const std::wstring_view& str) const noexcept;
@@ -67,8 +73,15 @@ private:
     bool _graphemeNextConsole(GraphemeState& s, const std::wstring_view& str) noexcept;
     bool _graphemePrevConsole(GraphemeState& s, const std::wstring_view& str) noexcept;
     __declspec(noinline) int _checkFallbackViaCache(char32_t codepoint) noexcept;
+    int _queryFallback(char32_t codepoint);
 
+    // The fallback widths of BMP codepoints, with 0 meaning "not queried yet". These are atomics so that
+    // PrefillFallbackCache() can fill them in from another thread without the readers taking a lock.
+    std::array<std::atomic<uint8_t>, 0x10000> _fallbackWidthsBMP{};
+    // The fallback widths of all other codepoints, which are rare enough to not be prefilled.
     std::unordered_map<char32_t, int> _fallbackCache;
+    std::atomic<uint32_t> _fallbackGeneration{ 0 };
+    uint32_t _prefillNext = 0;
     std::function<bool(const std::wstring_view&)> _pfnFallbackMethod;
     TextMeasurementMode _mode = TextMeasurementMode::Graphemes;
     int _ambiguousWidth = 1;
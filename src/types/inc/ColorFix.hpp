@@ -10,5 +10,6 @@
 namespace ColorFix
 {
     COLORREF GetPerceivableColor(COLORREF color, COLORREF reference, float minSquaredDistance) noexcept;
+    void GetPerceivableColors(std::span<const COLORREF> colors, COLORREF reference, float minSquaredDistance, std::span<COLORREF> out) noexcept;
     float GetLuminosity(COLORREF color) noexcept;
 }
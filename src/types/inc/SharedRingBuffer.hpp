@@ -0,0 +1,70 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SharedRingBuffer.hpp
+
+Abstract:
+- A single-producer single-consumer byte ring in shared memory. ConPTY can use it as
+  an alternative transport for its VT output, which avoids the two kernel copies and
+  the fixed-size reads that come with the output pipe.
+- The consumer (the terminal) creates the ring and hands its handles to conhost,
+  which opens it as the producer.
+- Just like til::spsc, the read and write positions are monotonic counters and each side
+  only signals the other side's event if it announced that it's about to wait for it.
+  As long as neither side runs dry or full, no system calls are made at all.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Utils
+{
+    class SharedRingBuffer
+    {
+    public:
+        // The capacity must be a power of two.
+        static constexpr uint32_t DefaultCapacity = 4 * 1024 * 1024;
+        static constexpr uint32_t MaxCapacity = 256 * 1024 * 1024;
+
+        struct Handles
+        {
+            HANDLE section = nullptr;
+            // Signaled by the producer when data is available.
+            HANDLE dataEvent = nullptr;
+            // Signaled by the consumer when space is available.
+            HANDLE spaceEvent = nullptr;
+        };
+
+        static SharedRingBuffer Create(uint32_t capacity = DefaultCapacity);
+        static SharedRingBuffer Open(wil::unique_handle section, wil::unique_event dataEvent, wil::unique_event spaceEvent);
+
+        explicit operator bool() const noexcept;
+        Handles GetHandles() const noexcept;
+
+        void Close() noexcept;
+        bool IsPeerClosed() const noexcept;
+
+        // These may only be called by the producer.
+        size_t Write(std::string_view data, DWORD timeout) noexcept;
+
+        // These may only be called by the consumer.
+        std::string_view Peek() const noexcept;
+        void Consume(size_t count) noexcept;
+        bool PrepareWait() noexcept;
+
+    private:
+        struct Header;
+
+        void _map();
+
+        wil::unique_handle _section;
+        wil::unique_event _dataEvent;
+        wil::unique_event _spaceEvent;
+        wil::unique_mapview_ptr<void> _view;
+        Header* _header = nullptr;
+        char* _data = nullptr;
+        uint32_t _capacity = 0;
+        bool _producer = false;
+    };
+}
@@ -1285,6 +1285,52 @@ class CodepointWidthDetectorTests
         }
     }
 
+    TEST_METHOD(AsciiPrefixLength)
+    {
+        // The lengths are chosen to test both the vectorized loop (8 chars at a time) and the scalar remainder.
+        VERIFY_ARE_EQUAL(0u, CodepointWidthDetector::AsciiPrefixLength(L""));
+        VERIFY_ARE_EQUAL(5u, CodepointWidthDetector::AsciiPrefixLength(L"abcde"));
+        VERIFY_ARE_EQUAL(0u, CodepointWidthDetector::AsciiPrefixLength(L"\u00e4bcdefghijklmnop"));
+        VERIFY_ARE_EQUAL(3u, CodepointWidthDetector::AsciiPrefixLength(L"abc\u00e4efghijklmnop"));
+        VERIFY_ARE_EQUAL(11u, CodepointWidthDetector::AsciiPrefixLength(L"abcdefghijk\u0300mnop"));
+        VERIFY_ARE_EQUAL(17u, CodepointWidthDetector::AsciiPrefixLength(L"abc\r\ndefghijklmnop\U0001F600"));
+        VERIFY_ARE_EQUAL(20u, CodepointWidthDetector::AsciiPrefixLength(L"abcdefghijklmnopqrst"));
+    }
+
+    TEST_METHOD(PrefilledFallbackCache)
+    {
+        auto& cwd = CodepointWidthDetector::Singleton();
+        size_t calls = 0;
+
+        const auto cleanup = wil::scope_exit([&] {
+            cwd.SetFallbackMethod(nullptr);
+            cwd.Reset(TextMeasurementMode::Graphemes);
+        });
+
+        // U+2592 MEDIUM SHADE is ambiguous. We'll pretend that the font draws it wide.
+        cwd.SetFallbackMethod([&](const std::wstring_view&) {
+            ++calls;
+            return true;
+        });
+        cwd.Reset(TextMeasurementMode::Console);
+
+        // A prefill from before the last Reset() must not do anything.
+        VERIFY_IS_FALSE(cwd.PrefillFallbackCache(cwd.FallbackCacheGeneration() - 1, 1));
+        VERIFY_ARE_EQUAL(0u, calls);
+
+        const auto generation = cwd.FallbackCacheGeneration();
+        while (cwd.PrefillFallbackCache(generation, 256))
+        {
+        }
+        VERIFY_ARE_NOT_EQUAL(0u, calls);
+
+        const auto prefillCalls = calls;
+        GraphemeState state;
+        cwd.GraphemeNext(state, L"\u2592");
+        VERIFY_ARE_EQUAL(2, state.width);
+        VERIFY_ARE_EQUAL(prefillCalls, calls);
+    }
+
     TEST_METHOD(BasicGraphemes)
     {
         static constexpr std::wstring_view text{ L"a\u0363e\u0364\u0364i\u0365" };
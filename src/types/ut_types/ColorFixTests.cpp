@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../inc/ColorFix.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class ColorFixTests
+{
+    TEST_CLASS(ColorFixTests);
+
+    TEST_METHOD(BatchMatchesScalar)
+    {
+        static constexpr auto minSquaredDistance = 0.5f * 0.5f;
+
+        // A grid of colors that covers dark, light and saturated colors, with a count that isn't a multiple of 4.
+        std::vector<COLORREF> colors;
+        for (auto r = 0; r < 256; r += 51)
+        {
+            for (auto g = 0; g < 256; g += 51)
+            {
+                for (auto b = 0; b < 256; b += 51)
+                {
+                    colors.emplace_back(RGB(r, g, b));
+                }
+            }
+        }
+        colors.emplace_back(RGB(12, 12, 12));
+        colors.emplace_back(RGB(204, 204, 204));
+        colors.emplace_back(0xff000000 | RGB(19, 161, 14));
+
+        std::vector<COLORREF> actual(colors.size());
+
+        for (const auto reference : { RGB(0, 0, 0), RGB(12, 12, 12), RGB(128, 128, 128), RGB(255, 255, 255), RGB(0, 55, 218) })
+        {
+            ColorFix::GetPerceivableColors(colors, reference, minSquaredDistance, actual);
+
+            for (size_t i = 0; i < colors.size(); ++i)
+            {
+                const auto expected = ColorFix::GetPerceivableColor(colors[i], reference, minSquaredDistance);
+                VERIFY_ARE_EQUAL(expected, actual[i]);
+            }
+        }
+    }
+};
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../inc/SharedRingBuffer.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Utils;
+
+class SharedRingBufferTests
+{
+    TEST_CLASS(SharedRingBufferTests);
+
+    static wil::unique_handle duplicate(HANDLE h)
+    {
+        wil::unique_handle out;
+        THROW_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(), h, GetCurrentProcess(), out.addressof(), 0, FALSE, DUPLICATE_SAME_ACCESS));
+        return out;
+    }
+
+    // Opens the producer side of the given ring through its own mapping, like conhost would.
+    static SharedRingBuffer openProducer(const SharedRingBuffer& consumer)
+    {
+        const auto handles = consumer.GetHandles();
+        return SharedRingBuffer::Open(duplicate(handles.section),
+                                      wil::unique_event{ duplicate(handles.dataEvent).release() },
+                                      wil::unique_event{ duplicate(handles.spaceEvent).release() });
+    }
+
+    static std::string readAll(SharedRingBuffer& consumer)
+    {
+        std::string result;
+        for (auto view = consumer.Peek(); !view.empty(); view = consumer.Peek())
+        {
+            result.append(view);
+            consumer.Consume(view.size());
+        }
+        return result;
+    }
+
+    TEST_METHOD(WriteAndRead)
+    {
+        auto consumer = SharedRingBuffer::Create(4096);
+        auto producer = openProducer(consumer);
+
+        VERIFY_ARE_EQUAL(0u, consumer.Peek().size());
+        VERIFY_IS_TRUE(consumer.PrepareWait());
+
+        VERIFY_ARE_EQUAL(5u, producer.Write("hello", 0));
+
+        // The consumer announced that it's waiting, so the producer must've signaled it.
+        VERIFY_ARE_EQUAL(static_cast<DWORD>(WAIT_OBJECT_0), WaitForSingleObject(consumer.GetHandles().dataEvent, 0));
+        VERIFY_IS_FALSE(consumer.PrepareWait());
+        VERIFY_ARE_EQUAL(std::string{ "hello" }, readAll(consumer));
+    }
+
+    TEST_METHOD(WrapAround)
+    {
+        auto consumer = SharedRingBuffer::Create(4096);
+        auto producer = openProducer(consumer);
+
+        const std::string filler(3000, 'a');
+        VERIFY_ARE_EQUAL(filler.size(), producer.Write(filler, 0));
+        VERIFY_ARE_EQUAL(filler, readAll(consumer));
+
+        // This write crosses the end of the ring. Peek() returns it in two parts.
+        std::string data(2000, 'b');
+        data.append(1000, 'c');
+        VERIFY_ARE_EQUAL(data.size(), producer.Write(data, 0));
+        VERIFY_ARE_EQUAL(size_t{ 4096 - 3000 }, consumer.Peek().size());
+        VERIFY_ARE_EQUAL(data, readAll(consumer));
+    }
+
+    TEST_METHOD(FullRing)
+    {
+        auto consumer = SharedRingBuffer::Create(4096);
+        auto producer = openProducer(consumer);
+
+        // Only as much as fits is written if the consumer doesn't make space in time.
+        const std::string data(5000, 'x');
+        VERIFY_ARE_EQUAL(size_t{ 4096 }, producer.Write(data, 0));
+
+        // Closing the consumer makes the producer give up immediately.
+        consumer.Close();
+        VERIFY_IS_TRUE(producer.IsPeerClosed());
+        VERIFY_ARE_EQUAL(0u, producer.Write(data, INFINITE));
+    }
+
+    TEST_METHOD(InvalidCapacity)
+    {
+        VERIFY_THROWS(SharedRingBuffer::Create(1000), wil::ResultException);
+        VERIFY_THROWS(SharedRingBuffer::Create(SharedRingBuffer::MaxCapacity * 2), wil::ResultException);
+    }
+};
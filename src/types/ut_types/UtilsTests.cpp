@@ -35,6 +35,8 @@ class UtilsTests
 
     TEST_METHOD(TestEvaluateStartingDirectory);
 
+    TEST_METHOD(TestFindActionableControlCharacter);
+
     void _VerifyXTermColorResult(const std::wstring_view wstr, DWORD colorValue);
     void _VerifyXTermColorInvalid(const std::wstring_view wstr);
 };
@@ -618,3 +620,35 @@ void UtilsTests::TestEvaluateStartingDirectory()
         test(L"/dev", cwd, L"/dev");
     }
 }
+
+void UtilsTests::TestFindActionableControlCharacter()
+{
+    // The implementation processes 16, 8 and finally 1 char at a time. This tests all
+    // string lengths up to 40 with a control character at every possible position,
+    // as well as each boundary of the C0 and C1 ranges, which are treated as actionable.
+    static constexpr std::array<wchar_t, 6> actionable{ L'\x00', L'\x1b', L'\x1f', L'\x7f', L'\x9b', L'\x9f' };
+    static constexpr std::array<wchar_t, 6> printable{ L'\x20', L'a', L'\x7e', L'\xa0', L'\u4e00', L'\xffff' };
+
+    for (size_t len = 0; len <= 40; ++len)
+    {
+        for (const auto ch : printable)
+        {
+            const std::wstring str(len, ch);
+            const auto it = FindActionableControlCharacter(str.data(), str.size());
+            VERIFY_ARE_EQUAL(len, static_cast<size_t>(it - str.data()));
+        }
+
+        for (size_t pos = 0; pos < len; ++pos)
+        {
+            for (const auto ch : actionable)
+            {
+                std::wstring str(len, L'x');
+                str[pos] = ch;
+                // Another control character after the first one must not affect the result.
+                str.back() = L'\n';
+                const auto it = FindActionableControlCharacter(str.data(), str.size());
+                VERIFY_ARE_EQUAL(pos, static_cast<size_t>(it - str.data()));
+            }
+        }
+    }
+}
@@ -99,6 +99,17 @@ HRESULT _CreatePseudoConsole(HANDLE hToken,
                              const HANDLE hOutput,
                              const DWORD dwFlags,
                              _Inout_ PseudoConsole* pPty)
+{
+    return _CreatePseudoConsoleWithOutputRing(hToken, size, hInput, hOutput, nullptr, dwFlags, pPty);
+}
+
+HRESULT _CreatePseudoConsoleWithOutputRing(HANDLE hToken,
+                                           const COORD size,
+                                           const HANDLE hInput,
+                                           const HANDLE hOutput,
+                                           _In_opt_ const CONPTY_OUTPUT_RING* pOutputRing,
+                                           const DWORD dwFlags,
+                                           _Inout_ PseudoConsole* pPty)
 {
     if (pPty == nullptr)
     {
@@ -157,6 +168,18 @@ HRESULT _CreatePseudoConsole(HANDLE hToken,
         break;
     }
 
+    // The ring's handles are inherited just like the signal pipe, so they have the same values on the other side.
+    wil::unique_process_heap_string outputRing;
+    if (pOutputRing)
+    {
+        RETURN_IF_FAILED(wil::str_printf_nothrow(
+            outputRing,
+            L" --outputRing 0x%tx --outputRingDataEvent 0x%tx --outputRingSpaceEvent 0x%tx",
+            std::bit_cast<uintptr_t>(pOutputRing->hSection),
+            std::bit_cast<uintptr_t>(pOutputRing->hDataEvent),
+            std::bit_cast<uintptr_t>(pOutputRing->hSpaceEvent)));
+    }
+
     const auto conhostPath = _ConsoleHostPath();
 
     // GH4061: Ensure that the path to executable in the format is escaped so C:\Program.exe cannot collide with C:\Program Files
@@ -164,14 +187,15 @@ HRESULT _CreatePseudoConsole(HANDLE hToken,
     wil::unique_process_heap_string cmd;
     RETURN_IF_FAILED(wil::str_printf_nothrow(
         cmd,
-        L"\"%s\" --headless %s%s--width %hd --height %hd --signal 0x%tx --server 0x%tx",
+        L"\"%s\" --headless %s%s--width %hd --height %hd --signal 0x%tx --server 0x%tx%s",
         conhostPath,
         bInheritCursor ? L"--inheritcursor " : L"",
         textMeasurement,
         size.X,
         size.Y,
         std::bit_cast<uintptr_t>(signalPipeConhostSide.get()),
-        std::bit_cast<uintptr_t>(serverHandle.get())));
+        std::bit_cast<uintptr_t>(serverHandle.get()),
+        outputRing ? outputRing.get() : L""));
 
     STARTUPINFOEXW siEx{ 0 };
     siEx.StartupInfo.cb = sizeof(STARTUPINFOEXW);
@@ -181,12 +205,19 @@ HRESULT _CreatePseudoConsole(HANDLE hToken,
     siEx.StartupInfo.dwFlags |= STARTF_USESTDHANDLES;
 
     // Only pass the handles we actually want the conhost to know about to it:
-    const size_t INHERITED_HANDLES_COUNT = 4;
-    HANDLE inheritedHandles[INHERITED_HANDLES_COUNT];
-    inheritedHandles[0] = serverHandle.get();
-    inheritedHandles[1] = hInput;
-    inheritedHandles[2] = hOutput;
-    inheritedHandles[3] = signalPipeConhostSide.get();
+    const size_t INHERITED_HANDLES_MAX = 7;
+    HANDLE inheritedHandles[INHERITED_HANDLES_MAX];
+    size_t inheritedHandlesCount = 0;
+    inheritedHandles[inheritedHandlesCount++] = serverHandle.get();
+    inheritedHandles[inheritedHandlesCount++] = hInput;
+    inheritedHandles[inheritedHandlesCount++] = hOutput;
+    inheritedHandles[inheritedHandlesCount++] = signalPipeConhostSide.get();
+    if (pOutputRing)
+    {
+        inheritedHandles[inheritedHandlesCount++] = pOutputRing->hSection;
+        inheritedHandles[inheritedHandlesCount++] = pOutputRing->hDataEvent;
+        inheritedHandles[inheritedHandlesCount++] = pOutputRing->hSpaceEvent;
+    }
 
     // Get the size of the attribute list. We need one attribute, the handle list.
     SIZE_T listSize = 0;
@@ -209,7 +240,7 @@ HRESULT _CreatePseudoConsole(HANDLE hToken,
                                                          0,
                                                          PROC_THREAD_ATTRIBUTE_HANDLE_LIST,
                                                          inheritedHandles,
-                                                         (INHERITED_HANDLES_COUNT * sizeof(HANDLE)),
+                                                         (inheritedHandlesCount * sizeof(HANDLE)),
                                                          nullptr,
                                                          nullptr));
     wil::unique_process_information pi;
@@ -444,6 +475,22 @@ extern "C" HRESULT WINAPI ConptyCreatePseudoConsoleAsUser(_In_ HANDLE hToken,
                                                           _In_ HANDLE hOutput,
                                                           _In_ DWORD dwFlags,
                                                           _Out_ HPCON* phPC)
+{
+    return ConptyCreatePseudoConsoleWithOutputRing(hToken, size, hInput, hOutput, nullptr, dwFlags, phPC);
+}
+
+// Function Description:
+// Same as ConptyCreatePseudoConsoleAsUser, but conhost writes its output into the
+//      given shared memory ring (see SharedRingBuffer) instead of `hOutput`. `hOutput`
+//      is still required: conhost keeps it open, so that the caller can detect
+//      conhost exiting by the pipe breaking.
+extern "C" HRESULT WINAPI ConptyCreatePseudoConsoleWithOutputRing(_In_ HANDLE hToken,
+                                                                  _In_ COORD size,
+                                                                  _In_ HANDLE hInput,
+                                                                  _In_ HANDLE hOutput,
+                                                                  _In_opt_ const CONPTY_OUTPUT_RING* pOutputRing,
+                                                                  _In_ DWORD dwFlags,
+                                                                  _Out_ HPCON* phPC)
 {
     if (phPC == nullptr)
     {
@@ -466,7 +513,19 @@ extern "C" HRESULT WINAPI ConptyCreatePseudoConsoleAsUser(_In_ HANDLE hToken,
     RETURN_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(), hInput, GetCurrentProcess(), duplicatedInput.addressof(), 0, TRUE, DUPLICATE_SAME_ACCESS));
     RETURN_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(), hOutput, GetCurrentProcess(), duplicatedOutput.addressof(), 0, TRUE, DUPLICATE_SAME_ACCESS));
 
-    RETURN_IF_FAILED(_CreatePseudoConsole(hToken, size, duplicatedInput.get(), duplicatedOutput.get(), dwFlags, pPty));
+    CONPTY_OUTPUT_RING duplicatedRing{};
+    wil::unique_handle duplicatedRingHandles[3];
+    if (pOutputRing)
+    {
+        RETURN_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(), pOutputRing->hSection, GetCurrentProcess(), duplicatedRingHandles[0].addressof(), 0, TRUE, DUPLICATE_SAME_ACCESS));
+        RETURN_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(), pOutputRing->hDataEvent, GetCurrentProcess(), duplicatedRingHandles[1].addressof(), 0, TRUE, DUPLICATE_SAME_ACCESS));
+        RETURN_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(), pOutputRing->hSpaceEvent, GetCurrentProcess(), duplicatedRingHandles[2].addressof(), 0, TRUE, DUPLICATE_SAME_ACCESS));
+        duplicatedRing.hSection = duplicatedRingHandles[0].get();
+        duplicatedRing.hDataEvent = duplicatedRingHandles[1].get();
+        duplicatedRing.hSpaceEvent = duplicatedRingHandles[2].get();
+    }
+
+    RETURN_IF_FAILED(_CreatePseudoConsoleWithOutputRing(hToken, size, duplicatedInput.get(), duplicatedOutput.get(), pOutputRing ? &duplicatedRing : nullptr, dwFlags, pPty));
 
     *phPC = (HPCON)pPty;
     cleanupPty.release();
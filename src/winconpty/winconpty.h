@@ -59,6 +59,18 @@ typedef struct _PseudoConsole
 #define PSEUDOCONSOLE_GLYPH_WIDTH_CONSOLE 0x18
 #endif
 
+#ifndef _CONPTY_OUTPUT_RING_DEFINED
+#define _CONPTY_OUTPUT_RING_DEFINED
+// The handles of a Microsoft::Console::Utils::SharedRingBuffer, created by the caller.
+// If given, conhost writes its output into this ring instead of hOutput.
+typedef struct _CONPTY_OUTPUT_RING
+{
+    HANDLE hSection;
+    HANDLE hDataEvent;
+    HANDLE hSpaceEvent;
+} CONPTY_OUTPUT_RING;
+#endif
+
 // Implementations of the various PseudoConsole functions.
 HRESULT _CreatePseudoConsole(const HANDLE hToken,
                              const COORD size,
@@ -66,6 +78,13 @@ HRESULT _CreatePseudoConsole(const HANDLE hToken,
                              const HANDLE hOutput,
                              const DWORD dwFlags,
                              _Inout_ PseudoConsole* pPty);
+HRESULT _CreatePseudoConsoleWithOutputRing(const HANDLE hToken,
+                                           const COORD size,
+                                           const HANDLE hInput,
+                                           const HANDLE hOutput,
+                                           _In_opt_ const CONPTY_OUTPUT_RING* pOutputRing,
+                                           const DWORD dwFlags,
+                                           _Inout_ PseudoConsole* pPty);
 
 HRESULT _ResizePseudoConsole(_In_ const PseudoConsole* const pPty, _In_ const COORD size);
 HRESULT _ClearPseudoConsole(_In_ const PseudoConsole* const pPty);
@@ -80,6 +99,14 @@ HRESULT WINAPI ConptyCreatePseudoConsoleAsUser(_In_ HANDLE hToken,
                                                _In_ DWORD dwFlags,
                                                _Out_ HPCON* phPC);
 
+HRESULT WINAPI ConptyCreatePseudoConsoleWithOutputRing(_In_ HANDLE hToken,
+                                                       _In_ COORD size,
+                                                       _In_ HANDLE hInput,
+                                                       _In_ HANDLE hOutput,
+                                                       _In_opt_ const CONPTY_OUTPUT_RING* pOutputRing,
+                                                       _In_ DWORD dwFlags,
+                                                       _Out_ HPCON* phPC);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,182 @@
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT license.
+
+################################
+# Measures the keystroke-to-photon latency of the Terminal.
+#
+# It launches the Terminal with an application that echoes its input, sends it
+# synthetic keystrokes and records an ETW trace of the "InputLatency" events of
+# the renderer (see src/renderer/base/FrameTimings.cpp). Each event describes a
+# key press, from the moment the control received it, through the input being
+# written to the connection and the echo arriving, to the frame that presented it.
+# Afterwards it reports the percentiles of each of these phases.
+#
+# Must be run elevated, as it starts an ETW trace session.
+# No other instance of the Terminal may be running, as a new launch would
+# otherwise just hand its commandline to the existing process.
+
+[CmdletBinding()]
+Param(
+    # The Terminal to launch. Use the path to a WindowsTerminal.exe to measure your own build.
+    [string]$Path = "wt.exe",
+
+    # The application that echoes the input. cmd.exe's prompt is echoed by conhost's cooked read.
+    [string]$EchoCommandline = "cmd.exe /k prompt $",
+
+    [int]$Keystrokes = 200,
+
+    # The delay between two keystrokes. Typing faster than the Terminal responds only measures the queueing.
+    [int]$IntervalMilliseconds = 50,
+
+    # How long to wait for the Terminal to start up, before the keystrokes are sent.
+    [int]$WaitSeconds = 5
+)
+
+$ErrorActionPreference = "Stop"
+
+$SessionName = "TerminalInputLatency"
+# Microsoft.Windows.Console.Render with TIL_KEYWORD_TRACE at WINEVENT_LEVEL_VERBOSE
+$Provider = "{41a35baf-cd55-5e23-782b-7323338b5283}"
+$Keyword = "0x100000000"
+$Level = 5
+
+Add-Type -TypeDefinition @"
+using System;
+using System.Runtime.InteropServices;
+
+public static class InputLatencyKeyboard
+{
+    [StructLayout(LayoutKind.Sequential)]
+    struct KEYBDINPUT
+    {
+        public ushort wVk;
+        public ushort wScan;
+        public uint dwFlags;
+        public uint time;
+        public IntPtr dwExtraInfo;
+    }
+
+    [StructLayout(LayoutKind.Sequential)]
+    struct INPUT
+    {
+        public uint type;
+        public KEYBDINPUT ki;
+        // INPUT is a union, of which MOUSEINPUT is the largest member.
+        public ulong padding;
+    }
+
+    [DllImport("user32.dll", SetLastError = true)]
+    static extern uint SendInput(uint nInputs, INPUT[] pInputs, int cbSize);
+
+    [DllImport("user32.dll")]
+    public static extern bool SetForegroundWindow(IntPtr hWnd);
+
+    public static void Press(ushort vk)
+    {
+        var inputs = new INPUT[2];
+        inputs[0].type = 1; // INPUT_KEYBOARD
+        inputs[0].ki.wVk = vk;
+        inputs[1].type = 1;
+        inputs[1].ki.wVk = vk;
+        inputs[1].ki.dwFlags = 2; // KEYEVENTF_KEYUP
+        if (SendInput(2, inputs, Marshal.SizeOf(typeof(INPUT))) != 2)
+        {
+            throw new System.ComponentModel.Win32Exception();
+        }
+    }
+}
+"@
+
+$VK_BACK = 0x08
+$VK_A = 0x41
+
+Function Get-TerminalProcess() {
+    Get-Process -Name WindowsTerminal -ErrorAction SilentlyContinue
+}
+
+Function Start-TraceSession($Etl) {
+    & logman create trace $SessionName -p $Provider $Keyword $Level -o $Etl -ets | Out-Null
+    If ($LASTEXITCODE -Ne 0) {
+        Throw "Failed to start the trace session (logman exited with $LASTEXITCODE). Are you running elevated?"
+    }
+}
+
+Function Stop-TraceSession() {
+    & logman stop $SessionName -ets | Out-Null
+}
+
+Function Read-InputLatencyEvents($Etl) {
+    $xmlPath = [IO.Path]::ChangeExtension($Etl, ".xml")
+    & tracerpt $Etl -o $xmlPath -of XML -y | Out-Null
+    [xml]$xml = Get-Content -Path $xmlPath -Raw
+
+    ForEach ($event in $xml.Events.Event) {
+        $data = @{}
+        ForEach ($d in $event.EventData.Data) {
+            $data[$d.Name] = $d.'#text'
+        }
+        If ($data.Contains("echoUs")) {
+            $data
+        }
+    }
+}
+
+Function Get-Percentile([double[]]$Values, [int]$Percentile) {
+    $sorted = $Values | Sort-Object
+    $sorted[[Math]::Floor(($sorted.Count - 1) * $Percentile / 100)]
+}
+
+If (Get-TerminalProcess) {
+    Throw "Please close all instances of the Terminal first."
+}
+
+$tempDir = Join-Path ([IO.Path]::GetTempPath()) $SessionName
+New-Item -ItemType Directory -Force -Path $tempDir | Out-Null
+$etl = Join-Path $tempDir "latency.etl"
+
+Start-Process -FilePath $Path -ArgumentList "--", $EchoCommandline | Out-Null
+Start-Sleep -Seconds $WaitSeconds
+
+$terminal = Get-TerminalProcess | Where-Object { $_.MainWindowHandle -Ne [IntPtr]::Zero } | Select-Object -First 1
+If (-Not $terminal) {
+    Throw "The Terminal didn't open a window within $WaitSeconds seconds."
+}
+
+Start-TraceSession $etl
+
+Try {
+    [InputLatencyKeyboard]::SetForegroundWindow($terminal.MainWindowHandle) | Out-Null
+    Start-Sleep -Milliseconds 500
+
+    For ($i = 0; $i -Lt $Keystrokes; $i++) {
+        Write-Progress -Activity "Measuring input latency" -Status "Keystroke $i of $Keystrokes" -PercentComplete (100 * $i / $Keystrokes)
+        # Alternate between typing and erasing a character, so that the prompt stays the same.
+        [InputLatencyKeyboard]::Press($(If ($i % 2) { $VK_BACK } Else { $VK_A }))
+        Start-Sleep -Milliseconds $IntervalMilliseconds
+    }
+} Finally {
+    Stop-TraceSession
+    $terminal | Stop-Process -Force
+}
+
+Write-Progress -Activity "Measuring input latency" -Completed
+
+$events = @(Read-InputLatencyEvents $etl)
+Remove-Item -Recurse -Force -Path $tempDir
+
+If ($events.Count -Eq 0) {
+    Throw "No InputLatency events were recorded. Is the Terminal build new enough?"
+}
+
+"translateUs", "echoUs", "presentUs", "totalUs" | ForEach-Object {
+    $phase = $_
+    $values = [double[]]($events | ForEach-Object { [double]$_[$phase] / 1000 })
+    [PSCustomObject]@{
+        Phase = $phase -Replace "Us$", ""
+        Samples = $values.Count
+        "P50 (ms)" = [Math]::Round((Get-Percentile $values 50), 2)
+        "P90 (ms)" = [Math]::Round((Get-Percentile $values 90), 2)
+        "P99 (ms)" = [Math]::Round((Get-Percentile $values 99), 2)
+        "Max (ms)" = [Math]::Round(($values | Measure-Object -Maximum).Maximum, 2)
+    }
+} | Format-Table -AutoSize
@@ -0,0 +1,165 @@
+# Copyright (c) Microsoft Corporation.
+# Licensed under the MIT license.
+
+################################
+# Measures the time the Terminal spends in each stage of its startup.
+#
+# It launches the Terminal a number of times while recording an ETW trace
+# of the "StartupStage" events (see src/cascadia/inc/StartupTracing.h) and
+# the "RenderFrame" events of the renderer. Afterwards it reports the
+# percentiles of the duration of each stage, as well as the time from the
+# launch to the first presented frame.
+#
+# Must be run elevated, as it starts an ETW trace session.
+# No other instance of the Terminal may be running, as a new launch would
+# otherwise just hand its commandline to the existing process.
+
+[CmdletBinding()]
+Param(
+    # The Terminal to launch. Use the path to a WindowsTerminal.exe to measure your own build.
+    [string]$Path = "wt.exe",
+
+    [string[]]$ArgumentList = @(),
+
+    [int]$Iterations = 10,
+
+    # How long to wait for the Terminal to start up, before it's closed again.
+    [int]$WaitSeconds = 5
+)
+
+$ErrorActionPreference = "Stop"
+
+$SessionName = "TerminalStartupPerformance"
+$Providers = @(
+    "{24a1622f-7da7-5c77-3303-d850bd1ab2ed}", # Microsoft.Windows.Terminal.App
+    "{be579944-4d33-5202-e5d6-a7a57f1935cb}", # Microsoft.Windows.Terminal.Setting.Model
+    "{56c06166-2e2e-5f4d-7ff3-74f4b78c87d6}", # Microsoft.Windows.Terminal.Win32Host
+    "{e912fe7b-eeb6-52a5-c628-abe388e5f792}", # Microsoft.Windows.Terminal.Connection
+    "{41a35baf-cd55-5e23-782b-7323338b5283}"  # Microsoft.Windows.Console.Render
+)
+# TIL_KEYWORD_TRACE at WINEVENT_LEVEL_VERBOSE
+$Keyword = "0x100000000"
+$Level = 5
+
+$WINEVENT_OPCODE_START = 1
+$WINEVENT_OPCODE_STOP = 2
+
+Function Get-TerminalProcess() {
+    Get-Process -Name WindowsTerminal -ErrorAction SilentlyContinue
+}
+
+Function Start-TraceSession($Etl) {
+    $providerFile = New-TemporaryFile
+    $Providers | ForEach-Object { "$_ $Keyword $Level" } | Set-Content -Path $providerFile -Encoding Ascii
+    & logman create trace $SessionName -pf $providerFile -o $Etl -ets | Out-Null
+    $exitCode = $LASTEXITCODE
+    Remove-Item $providerFile
+    If ($exitCode -Ne 0) {
+        Throw "Failed to start the trace session (logman exited with $exitCode). Are you running elevated?"
+    }
+}
+
+Function Stop-TraceSession() {
+    & logman stop $SessionName -ets | Out-Null
+}
+
+Function Read-TraceEvents($Etl) {
+    $xmlPath = [IO.Path]::ChangeExtension($Etl, ".xml")
+    & tracerpt $Etl -o $xmlPath -of XML -y | Out-Null
+    [xml]$xml = Get-Content -Path $xmlPath -Raw
+
+    ForEach ($event in $xml.Events.Event) {
+        $data = @{}
+        ForEach ($d in $event.EventData.Data) {
+            $data[$d.Name] = $d.'#text'
+        }
+
+        [PSCustomObject]@{
+            Time = [DateTime]::Parse($event.System.TimeCreated.SystemTime, $null, [Globalization.DateTimeStyles]::RoundtripKind).ToUniversalTime()
+            Opcode = [int]$event.System.Opcode
+            Data = $data
+        }
+    }
+}
+
+# Returns the duration of each stage in milliseconds, based on the first start and stop event of each.
+Function Get-StageDurations($Events, [DateTime]$Launch) {
+    $durations = [ordered]@{}
+    $starts = @{}
+
+    ForEach ($event in $Events | Sort-Object -Property Time) {
+        $stage = $event.Data["stage"]
+        If ($stage) {
+            If ($event.Opcode -Eq $WINEVENT_OPCODE_START -And -Not $starts.Contains($stage)) {
+                $starts[$stage] = $event.Time
+            } ElseIf ($event.Opcode -Eq $WINEVENT_OPCODE_STOP -And $starts.Contains($stage) -And -Not $durations.Contains($stage)) {
+                $durations[$stage] = ($event.Time - $starts[$stage]).TotalMilliseconds
+            }
+        } ElseIf ($event.Data.Contains("totalUs") -And -Not $durations.Contains("FirstFrame")) {
+            # The first RenderFrame event is emitted right after the first frame was presented.
+            $durations["FirstFrame"] = ($event.Time - $Launch).TotalMilliseconds
+        }
+    }
+
+    $durations
+}
+
+Function Get-Percentile([double[]]$Values, [int]$Percentile) {
+    $sorted = $Values | Sort-Object
+    $sorted[[Math]::Floor(($sorted.Count - 1) * $Percentile / 100)]
+}
+
+If (Get-TerminalProcess) {
+    Throw "Please close all instances of the Terminal first."
+}
+
+$tempDir = Join-Path ([IO.Path]::GetTempPath()) $SessionName
+New-Item -ItemType Directory -Force -Path $tempDir | Out-Null
+
+$samples = @{}
+
+For ($i = 1; $i -Le $Iterations; $i++) {
+    Write-Progress -Activity "Measuring startup performance" -Status "Launch $i of $Iterations" -PercentComplete (100 * ($i - 1) / $Iterations)
+
+    $etl = Join-Path $tempDir "startup$i.etl"
+    Start-TraceSession $etl
+
+    Try {
+        $launch = [DateTime]::UtcNow
+        If ($ArgumentList.Count -Gt 0) {
+            Start-Process -FilePath $Path -ArgumentList $ArgumentList | Out-Null
+        } Else {
+            Start-Process -FilePath $Path | Out-Null
+        }
+        Start-Sleep -Seconds $WaitSeconds
+    } Finally {
+        Get-TerminalProcess | Stop-Process -Force
+        Stop-TraceSession
+    }
+
+    $durations = Get-StageDurations (Read-TraceEvents $etl) $launch
+    ForEach ($stage in $durations.Keys) {
+        If (-Not $samples.Contains($stage)) {
+            $samples[$stage] = [Collections.Generic.List[double]]::new()
+        }
+        $samples[$stage].Add($durations[$stage])
+    }
+
+    # Give the system a moment to settle, so that the launches don't influence each other.
+    Start-Sleep -Seconds 1
+}
+
+Write-Progress -Activity "Measuring startup performance" -Completed
+Remove-Item -Recurse -Force -Path $tempDir
+
+$samples.Keys | Sort-Object | ForEach-Object {
+    $values = $samples[$_].ToArray()
+    [PSCustomObject]@{
+        Stage = $_
+        Samples = $values.Count
+        "P50 (ms)" = [Math]::Round((Get-Percentile $values 50), 1)
+        "P90 (ms)" = [Math]::Round((Get-Percentile $values 90), 1)
+        "P99 (ms)" = [Math]::Round((Get-Percentile $values 99), 1)
+        "Max (ms)" = [Math]::Round(($values | Measure-Object -Maximum).Maximum, 1)
+    }
+} | Format-Table -AutoSize